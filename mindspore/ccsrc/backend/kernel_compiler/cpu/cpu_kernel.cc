@@ -20,11 +20,153 @@
 #include <utility>
 #include <cmath>
 
+#include "backend/kernel_compiler/cpu/cpu_parallel_tuning_db.h"
 #include "common/thread_pool.h"
 #include "utils/profile.h"
 
 namespace mindspore {
 namespace kernel {
+namespace {
+// Search for best block_size to get best thread num : 1 2 4 8 16 23(32), and then search for the task split.
+constexpr size_t kMaxSearchPow = 6;
+// Each choice runs 5 times to get an average cpu kernel cost time.
+constexpr size_t kSearchAvgCount = 5;
+// The task split tried with the best block_size, every thread runs several smaller tasks to balance the uneven tasks.
+constexpr size_t kFineTaskSplit = 4;
+constexpr size_t kBlockSizeSearchEndCount = kSearchAvgCount * kMaxSearchPow;
+constexpr size_t kSearchEndCount = kBlockSizeSearchEndCount + kSearchAvgCount;
+
+// Launch the task of count by the block size and the number of tasks per thread.
+using ParallelLaunchFunc = std::function<void(float, size_t)>;
+
+size_t ComputeThreadNum(size_t count, float block_size, size_t max_thread_num) {
+  return count < block_size * max_thread_num ? std::ceil(count / block_size) : max_thread_num;
+}
+
+// The number of elements computed by one task.
+size_t ComputeOnceComputeSize(size_t count, float block_size, size_t max_thread_num, size_t task_split) {
+  size_t split_num = ComputeThreadNum(count, block_size, max_thread_num) * task_split;
+  return (count + split_num - 1) / split_num;
+}
+
+void ParallelForWithTaskSplit(const CTask &task, size_t count, float block_size, size_t task_split) {
+  auto max_thread_num = common::ThreadPool::GetInstance().GetSyncRunThreadNum();
+  std::vector<common::Task> tasks;
+  size_t start = 0;
+  size_t once_compute_size = ComputeOnceComputeSize(count, block_size, max_thread_num, task_split);
+  while (start < count) {
+    size_t end = (start + once_compute_size) > count ? count : (start + once_compute_size);
+    auto block = [&, start, end]() {
+      task(start, end);
+      return common::SUCCESS;
+    };
+    (void)tasks.emplace_back(block);
+    start += once_compute_size;
+  }
+  (void)common::ThreadPool::GetInstance().SyncRun(tasks);
+}
+
+void ParallelLaunchWithTaskSplit(const CTask &task, size_t count, float block_size, size_t task_split,
+                                 Content content) {
+  auto thread_pool = GetActorMgrInnerThreadPool();
+  size_t kernel_thread_num = thread_pool->GetKernelThreadNum();
+  if (kernel_thread_num == 0) {
+    MS_LOG(EXCEPTION) << "Actor inner pool has been init, but kernel thread is 0!";
+  }
+
+  size_t once_compute_size = ComputeOnceComputeSize(count, block_size, kernel_thread_num, task_split);
+  size_t task_num = count / once_compute_size;
+  if (count % once_compute_size != 0) {
+    task_num += 1;
+  }
+  auto func = [&](void *, int task_id, float, float) {
+    size_t start = task_id * once_compute_size;
+    size_t end = (start + once_compute_size) > count ? count : (start + once_compute_size);
+    task(start, end);
+    return common::SUCCESS;
+  };
+  (void)thread_pool->ParallelLaunch(func, content, task_num);
+}
+
+void FetchParallelTuningRecord(size_t count, size_t max_thread_num, ParallelSearchInfo *parallel_search_info) {
+  parallel_search_info->is_db_fetched = true;
+  ParallelTuningRecord record;
+  if (!ParallelTuningDB::GetInstance().Fetch(parallel_search_info->kernel_key, count, max_thread_num, &record)) {
+    return;
+  }
+  parallel_search_info->min_cost_time = record.cost_time;
+  parallel_search_info->best_block_size = static_cast<float>(count) / std::pow(2.0f, record.best_pow);
+  parallel_search_info->best_pow = record.best_pow;
+  parallel_search_info->best_task_split = record.task_split;
+  parallel_search_info->search_count = kSearchEndCount;
+}
+
+void InsertParallelTuningRecord(size_t count, size_t max_thread_num, const ParallelSearchInfo &parallel_search_info) {
+  ParallelTuningRecord record;
+  record.best_pow = parallel_search_info.best_pow;
+  record.task_split = parallel_search_info.best_task_split;
+  record.thread_num = ComputeThreadNum(count, parallel_search_info.best_block_size, max_thread_num);
+  record.cost_time = parallel_search_info.min_cost_time;
+  ParallelTuningDB::GetInstance().Insert(parallel_search_info.kernel_key, count, max_thread_num, record);
+}
+
+// Search for best block_size first, if the speed of block_size[i] is slower than block_size[i-2], than we assume that
+// block_size[i-2] is the best block_size. And then search whether the finer task split of the best block_size is
+// faster.
+// The search result is loaded from and saved to the parallel tuning database if the kernel key is set.
+void ParallelAutoSearch(const ParallelLaunchFunc &launch_func, size_t count, size_t max_thread_num,
+                        ParallelSearchInfo *parallel_search_info) {
+  MS_EXCEPTION_IF_NULL(parallel_search_info);
+  if ((!parallel_search_info->is_db_fetched) && (!parallel_search_info->kernel_key.empty())) {
+    FetchParallelTuningRecord(count, max_thread_num, parallel_search_info);
+  }
+  if (parallel_search_info->search_count >= kSearchEndCount) {
+    launch_func(parallel_search_info->best_block_size, parallel_search_info->best_task_split);
+    return;
+  }
+
+  if (parallel_search_info->search_count % kSearchAvgCount == 0) {
+    parallel_search_info->tmp_sum_cost_time = 0;
+  }
+  size_t current_pow = parallel_search_info->search_count / kSearchAvgCount;
+  bool is_block_size_search = (current_pow < kMaxSearchPow);
+  float block_size = is_block_size_search ? static_cast<float>(count) / std::pow(2.0f, current_pow)
+                                          : parallel_search_info->best_block_size;
+  size_t task_split = is_block_size_search ? 1 : kFineTaskSplit;
+  double start_time = GetTime();
+  launch_func(block_size, task_split);
+  double cost_time = GetTime() - start_time;
+  parallel_search_info->tmp_sum_cost_time += cost_time;
+  parallel_search_info->search_count++;
+  if (parallel_search_info->search_count % kSearchAvgCount != 0) {
+    return;
+  }
+
+  double avg_time = parallel_search_info->tmp_sum_cost_time / kSearchAvgCount;
+  if (parallel_search_info->min_cost_time > avg_time) {
+    parallel_search_info->min_cost_time = avg_time;
+    if (is_block_size_search) {
+      parallel_search_info->best_block_size = block_size;
+      parallel_search_info->best_pow = current_pow;
+    } else {
+      parallel_search_info->best_task_split = task_split;
+    }
+  } else if (is_block_size_search && (current_pow - parallel_search_info->best_pow >= 2) &&
+             (!ParallelTuningDB::GetInstance().is_offline_tuning())) {
+    parallel_search_info->search_count = kBlockSizeSearchEndCount;
+  }
+  // The task split is searched only to be saved in the tuning database, and it makes no sense when the best
+  // block_size runs in one thread.
+  if ((parallel_search_info->search_count == kBlockSizeSearchEndCount) &&
+      (parallel_search_info->kernel_key.empty() ||
+       (ComputeThreadNum(count, parallel_search_info->best_block_size, max_thread_num) <= 1))) {
+    parallel_search_info->search_count = kSearchEndCount;
+  }
+  if ((parallel_search_info->search_count == kSearchEndCount) && (!parallel_search_info->kernel_key.empty())) {
+    InsertParallelTuningRecord(count, max_thread_num, *parallel_search_info);
+  }
+}
+}  // namespace
 
 void CpuDynamicKernel::UpdateArgs() {
   if (!is_input_dynamic_shape_ && is_output_dynamic_shape_ && !have_depends()) {
@@ -69,6 +211,9 @@ void CPUKernel::InitInputOutputSize(const CNodePtr &kernel_node) {
 void CPUKernel::Init(const CNodePtr &kernel_node) {
   InitKernel(kernel_node);
   InitInputOutputSize(kernel_node);
+  // The shapes may be changed by the dynamic shape, then fetch the search result from the tuning database again.
+  parallel_search_info_.kernel_key = ParallelTuningDB::GetInstance().KernelKey(kernel_node);
+  parallel_search_info_.is_db_fetched = false;
 }
 
 void CPUKernelUtils::ExpandDimsTo4(std::vector<size_t> *shape) {
@@ -110,55 +255,15 @@ void CPUKernelUtils::GetElementNumEveryDim(const std::vector<size_t> &shape, std
 }
 
 void CPUKernelUtils::ParallelFor(const CTask &task, size_t count, float block_size) {
-  auto max_thread_num = common::ThreadPool::GetInstance().GetSyncRunThreadNum();
-  size_t thread_num = count < block_size * max_thread_num ? std::ceil(count / block_size) : max_thread_num;
-  std::vector<common::Task> tasks;
-  size_t start = 0;
-  size_t once_compute_size = (count + thread_num - 1) / thread_num;
-  while (start < count) {
-    size_t end = (start + once_compute_size) > count ? count : (start + once_compute_size);
-    auto block = [&, start, end]() {
-      task(start, end);
-      return common::SUCCESS;
-    };
-    (void)tasks.emplace_back(block);
-    start += once_compute_size;
-  }
-  (void)common::ThreadPool::GetInstance().SyncRun(tasks);
+  ParallelForWithTaskSplit(task, count, block_size, 1);
 }
 
-// Search for best block_size to get best thread num : 1 2 4 8 16 23(32)
-// Each block_size runs 5 times to get an average cpu kernel cost time.
-// If the speed of block_size[i] is slower than block_size[i-2], than we
-// assume that  block_size[i-2] is the best block_size.
 void CPUKernelUtils::ParallelForAutoSearch(const CTask &task, size_t count, ParallelSearchInfo *parallel_search_info) {
-  const size_t MAX_POW = 6;
-  const size_t AVG_COUNT = 5;
-  MS_EXCEPTION_IF_NULL(parallel_search_info);
-  size_t current_pow = parallel_search_info->search_count / AVG_COUNT;
-  if (current_pow < MAX_POW) {
-    if (parallel_search_info->search_count % AVG_COUNT == 0) {
-      parallel_search_info->tmp_sum_cost_time = 0;
-    }
-    float block_size = static_cast<float>(count) / std::pow(2.0f, current_pow);
-    double start_time = GetTime();
-    ParallelFor(task, count, block_size);
-    double cost_time = GetTime() - start_time;
-    parallel_search_info->tmp_sum_cost_time += cost_time;
-    parallel_search_info->search_count++;
-    if (parallel_search_info->search_count % AVG_COUNT == 0) {
-      double avg_time = parallel_search_info->tmp_sum_cost_time / AVG_COUNT;
-      if (parallel_search_info->min_cost_time > avg_time) {
-        parallel_search_info->min_cost_time = avg_time;
-        parallel_search_info->best_block_size = block_size;
-        parallel_search_info->best_pow = current_pow;
-      } else if (current_pow - parallel_search_info->best_pow >= 2) {
-        parallel_search_info->search_count = AVG_COUNT * MAX_POW;
-      }
-    }
-  } else {
-    ParallelFor(task, count, parallel_search_info->best_block_size);
-  }
+  auto max_thread_num = common::ThreadPool::GetInstance().GetSyncRunThreadNum();
+  auto launch_func = [&task, count](float block_size, size_t task_split) {
+    ParallelForWithTaskSplit(task, count, block_size, task_split);
+  };
+  ParallelAutoSearch(launch_func, count, max_thread_num, parallel_search_info);
 }
 
 ActorThreadPool *GetActorMgrInnerThreadPool() {
@@ -186,55 +291,16 @@ ActorThreadPool *GetActorMgrInnerThreadPool() {
 
 // Use threadpool of mindrt
 void ParallelLaunch(const CTask &task, size_t count, float block_size, Content content) {
-  auto thread_pool = GetActorMgrInnerThreadPool();
-  size_t kernel_thread_num = thread_pool->GetKernelThreadNum();
-  if (kernel_thread_num == 0) {
-    MS_LOG(EXCEPTION) << "Actor inner pool has been init, but kernel thread is 0!";
-  }
-
-  size_t thread_num = count < block_size * kernel_thread_num ? std::ceil(count / block_size) : kernel_thread_num;
-  size_t once_compute_size = (count + thread_num - 1) / thread_num;
-  size_t task_num = count / once_compute_size;
-  if (count % once_compute_size != 0) {
-    task_num += 1;
-  }
-  auto func = [&](void *, int task_id, float, float) {
-    size_t start = task_id * once_compute_size;
-    size_t end = (start + once_compute_size) > count ? count : (start + once_compute_size);
-    task(start, end);
-    return common::SUCCESS;
-  };
-  (void)thread_pool->ParallelLaunch(func, content, task_num);
+  ParallelLaunchWithTaskSplit(task, count, block_size, 1, content);
 }
 
 void ParallelLaunchAutoSearch(const CTask &task, size_t count, Content content,
                               ParallelSearchInfo *parallel_search_info) {
-  const size_t MAX_POW = 6;
-  const size_t AVG_COUNT = 5;
-  size_t current_pow = parallel_search_info->search_count / AVG_COUNT;
-  if (current_pow < MAX_POW) {
-    if (parallel_search_info->search_count % AVG_COUNT == 0) {
-      parallel_search_info->tmp_sum_cost_time = 0;
-    }
-    float block_size = static_cast<float>(count) / std::pow(2.0f, current_pow);
-    double start_time = GetTime();
-    ParallelLaunch(task, count, block_size, content);
-    double cost_time = GetTime() - start_time;
-    parallel_search_info->tmp_sum_cost_time += cost_time;
-    parallel_search_info->search_count++;
-    if (parallel_search_info->search_count % AVG_COUNT == 0) {
-      double avg_time = parallel_search_info->tmp_sum_cost_time / AVG_COUNT;
-      if (parallel_search_info->min_cost_time > avg_time) {
-        parallel_search_info->min_cost_time = avg_time;
-        parallel_search_info->best_block_size = block_size;
-        parallel_search_info->best_pow = current_pow;
-      } else if (current_pow - parallel_search_info->best_pow >= 2) {
-        parallel_search_info->search_count = AVG_COUNT * MAX_POW;
-      }
-    }
-  } else {
-    ParallelLaunch(task, count, parallel_search_info->best_block_size, content);
-  }
+  auto kernel_thread_num = GetActorMgrInnerThreadPool()->GetKernelThreadNum();
+  auto launch_func = [&task, count, content](float block_size, size_t task_split) {
+    ParallelLaunchWithTaskSplit(task, count, block_size, task_split, content);
+  };
+  ParallelAutoSearch(launch_func, count, kernel_thread_num, parallel_search_info);
 }
 
 std::vector<size_t> CPUKernelUtils::FlatShapeByAxis(const std::vector<size_t> &shape, int axis) {
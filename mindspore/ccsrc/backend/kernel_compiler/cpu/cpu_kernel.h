@@ -107,7 +107,11 @@ struct ParallelSearchInfo {
   double tmp_sum_cost_time{0};
   float best_block_size;
   size_t best_pow{0};
+  size_t best_task_split{1};
   size_t search_count{0};
+  // The key of kernel in the parallel tuning database, which is empty if the database is disabled.
+  std::string kernel_key;
+  bool is_db_fetched{false};
 };
 
 class CpuDynamicKernel : public device::DynamicKernel {
@@ -0,0 +1,219 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "backend/kernel_compiler/cpu/cpu_parallel_tuning_db.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "backend/session/anf_runtime_algorithm.h"
+#include "debug/common.h"
+#include "utils/ms_utils.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+// Bump it when the format of the database file or the parallel launch changes.
+constexpr int kParallelTuningDBVersion = 2;
+constexpr char kParallelTuningDBPathEnv[] = "MS_DEV_CPU_PARALLEL_TUNING_DB_PATH";
+constexpr char kParallelTuningModeEnv[] = "MS_DEV_CPU_PARALLEL_TUNING_MODE";
+constexpr char kOfflineTuningMode[] = "offline";
+constexpr char kVersion[] = "version";
+constexpr char kRecords[] = "records";
+constexpr char kBestPow[] = "best_pow";
+constexpr char kTaskSplit[] = "task_split";
+constexpr char kThreadNum[] = "thread_num";
+constexpr char kCostTime[] = "cost_time";
+
+std::string GetCpuModel() {
+  std::ifstream cpu_info("/proc/cpuinfo");
+  std::string line;
+  const std::string model_name = "model name";
+  while (cpu_info.is_open() && std::getline(cpu_info, line)) {
+    if (line.compare(0, model_name.size(), model_name) != 0) {
+      continue;
+    }
+    auto pos = line.find(':');
+    if (pos != std::string::npos) {
+      auto model = line.substr(pos + 1);
+      model.erase(0, model.find_first_not_of(' '));
+      return model;
+    }
+  }
+  return "unknown";
+}
+
+template <typename T>
+void ShapeToStream(const std::vector<T> &shape, std::ostringstream *ss) {
+  *ss << "[";
+  for (const auto &dim : shape) {
+    *ss << dim << ",";
+  }
+  *ss << "]";
+}
+}  // namespace
+
+ParallelTuningDB &ParallelTuningDB::GetInstance() {
+  static ParallelTuningDB instance(common::GetEnv(kParallelTuningDBPathEnv),
+                                   common::GetEnv(kParallelTuningModeEnv) == kOfflineTuningMode);
+  return instance;
+}
+
+ParallelTuningDB::ParallelTuningDB(const std::string &db_path, bool is_offline_tuning)
+    : db_path_(db_path), is_offline_tuning_(is_offline_tuning) {
+  if (db_path_.empty()) {
+    return;
+  }
+  cpu_model_ = GetCpuModel();
+  Load();
+  MS_LOG(INFO) << "Enable the cpu parallel tuning database " << db_path_ << ", record size: " << records_.size()
+               << ", offline tuning: " << is_offline_tuning_ << ", cpu model: " << cpu_model_;
+}
+
+std::string ParallelTuningDB::KernelKey(const CNodePtr &kernel_node) const {
+  if (!enabled()) {
+    return "";
+  }
+  MS_EXCEPTION_IF_NULL(kernel_node);
+  std::ostringstream ss;
+  auto op_name = AnfAlgo::GetCNodeName(kernel_node);
+  ss << op_name << "{";
+  // The attributes are kept in a hash map, sort them to make the key stable.
+  auto prim = AnfAlgo::GetCNodePrimitive(kernel_node);
+  if (prim != nullptr) {
+    std::vector<std::pair<std::string, std::string>> attrs;
+    for (const auto &attr : prim->attrs()) {
+      (void)attrs.emplace_back(attr.first, attr.second == nullptr ? "" : attr.second->ToString());
+    }
+    std::sort(attrs.begin(), attrs.end());
+    for (const auto &attr : attrs) {
+      ss << attr.first << "=" << attr.second << ";";
+    }
+  }
+  ss << "}(";
+  size_t input_num = AnfAlgo::GetInputTensorNum(kernel_node);
+  for (size_t i = 0; i < input_num; ++i) {
+    ss << AnfAlgo::GetInputDeviceDataType(kernel_node, i);
+    ShapeToStream(AnfAlgo::GetInputDeviceShape(kernel_node, i), &ss);
+    ss << ",";
+  }
+  ss << ")->(";
+  size_t output_num = AnfAlgo::GetOutputTensorNum(kernel_node);
+  for (size_t i = 0; i < output_num; ++i) {
+    ss << AnfAlgo::GetOutputDeviceDataType(kernel_node, i);
+    ShapeToStream(AnfAlgo::GetOutputDeviceShape(kernel_node, i), &ss);
+    ss << ",";
+  }
+  ss << ")";
+  // The whole text is the key rather than a hash of it, so that two kernels never share the record.
+  return ss.str();
+}
+
+std::string ParallelTuningDB::RecordKey(const std::string &kernel_key, size_t count, size_t thread_num) const {
+  return kernel_key + "|" + std::to_string(count) + "|" + std::to_string(thread_num) + "|" + cpu_model_;
+}
+
+bool ParallelTuningDB::Fetch(const std::string &kernel_key, size_t count, size_t thread_num,
+                             ParallelTuningRecord *record) {
+  MS_EXCEPTION_IF_NULL(record);
+  // Search again to overwrite the records in the offline tuning mode.
+  if ((!enabled()) || is_offline_tuning_) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = records_.find(RecordKey(kernel_key, count, thread_num));
+  if (iter == records_.end()) {
+    return false;
+  }
+  *record = iter->second;
+  return true;
+}
+
+void ParallelTuningDB::Insert(const std::string &kernel_key, size_t count, size_t thread_num,
+                              const ParallelTuningRecord &record) {
+  if (!enabled()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  records_[RecordKey(kernel_key, count, thread_num)] = record;
+  is_dirty_ = true;
+  MS_LOG(DEBUG) << "Insert the parallel tuning record of " << kernel_key << ", count: " << count
+                << ", best pow: " << record.best_pow << ", task split: " << record.task_split
+                << ", thread num: " << record.thread_num << ", cost time: " << record.cost_time;
+  // The offline tuning process may be stopped at any time, so save the records in time.
+  if (is_offline_tuning_) {
+    FlushNoLock();
+  }
+}
+
+void ParallelTuningDB::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FlushNoLock();
+}
+
+void ParallelTuningDB::FlushNoLock() {
+  if ((!enabled()) || (!is_dirty_)) {
+    return;
+  }
+  nlohmann::json db_json;
+  db_json[kVersion] = kParallelTuningDBVersion;
+  nlohmann::json records_json;
+  for (const auto &item : records_) {
+    nlohmann::json record_json;
+    record_json[kBestPow] = item.second.best_pow;
+    record_json[kTaskSplit] = item.second.task_split;
+    record_json[kThreadNum] = item.second.thread_num;
+    record_json[kCostTime] = item.second.cost_time;
+    records_json[item.first] = record_json;
+  }
+  db_json[kRecords] = records_json;
+  if (!Common::SaveStringToFile(db_path_, db_json.dump())) {
+    MS_LOG(WARNING) << "Save the cpu parallel tuning database to " << db_path_ << " failed.";
+    return;
+  }
+  is_dirty_ = false;
+}
+
+void ParallelTuningDB::Load() {
+  std::ifstream json_fs(db_path_);
+  if (!json_fs.is_open()) {
+    MS_LOG(INFO) << "Open the cpu parallel tuning database " << db_path_ << " failed, start with an empty database.";
+    return;
+  }
+  try {
+    nlohmann::json db_json;
+    json_fs >> db_json;
+    if (db_json.at(kVersion) != kParallelTuningDBVersion) {
+      MS_LOG(WARNING) << "Mismatch version of the cpu parallel tuning database " << db_path_ << ", ignore it.";
+      return;
+    }
+    for (const auto &item : db_json.at(kRecords).items()) {
+      ParallelTuningRecord record;
+      record.best_pow = item.value().at(kBestPow).get<size_t>();
+      record.task_split = item.value().at(kTaskSplit).get<size_t>();
+      record.thread_num = item.value().at(kThreadNum).get<size_t>();
+      record.cost_time = item.value().at(kCostTime).get<double>();
+      records_[item.key()] = record;
+    }
+  } catch (std::exception &e) {
+    MS_LOG(WARNING) << "Parse the cpu parallel tuning database " << db_path_ << " error, " << e.what();
+    records_.clear();
+  }
+}
+}  // namespace kernel
+}  // namespace mindspore
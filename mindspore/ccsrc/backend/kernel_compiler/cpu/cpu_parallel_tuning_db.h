@@ -0,0 +1,88 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_CPU_PARALLEL_TUNING_DB_H_
+#define MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_CPU_PARALLEL_TUNING_DB_H_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include "ir/anf.h"
+#include "utils/ms_utils.h"
+
+namespace mindspore {
+namespace kernel {
+// The parallel launch choice of a cpu kernel found by the auto search.
+struct ParallelTuningRecord {
+  // The block size is the launch count divided by 2^best_pow.
+  size_t best_pow{0};
+  // The number of tasks which every thread runs, the larger split balances the uneven tasks better.
+  size_t task_split{1};
+  // The number of threads used in the launch.
+  size_t thread_num{1};
+  double cost_time{0};
+};
+
+// The persistent database of the parallel auto search results of cpu kernels. The records are keyed by the kernel type,
+// attributes, shapes and data types, the launch count, the thread number and the cpu model, so a process running the
+// same kernels on the same machine launches them with the best choice directly instead of searching it again.
+// The database is enabled by the env MS_DEV_CPU_PARALLEL_TUNING_DB_PATH which is the path of the database file. If the
+// env MS_DEV_CPU_PARALLEL_TUNING_MODE is set to 'offline', every choice is measured without the early stop of the
+// search and the existing records are overwritten, which is used to populate the database offline.
+class ParallelTuningDB {
+ public:
+  // The instance configured by the envs.
+  static ParallelTuningDB &GetInstance();
+
+  // The database of the file, which is disabled if the path is empty.
+  explicit ParallelTuningDB(const std::string &db_path, bool is_offline_tuning = false);
+  ~ParallelTuningDB() = default;
+
+  bool enabled() const { return !db_path_.empty(); }
+  bool is_offline_tuning() const { return is_offline_tuning_; }
+
+  // Get the key of the kernel by the kernel type, attributes, shapes and data types, which is empty if disabled.
+  std::string KernelKey(const CNodePtr &kernel_node) const;
+
+  // Look up the record of the kernel launch. Return false if missed.
+  bool Fetch(const std::string &kernel_key, size_t count, size_t thread_num, ParallelTuningRecord *record);
+
+  // Record the result of the auto search, the database file is saved at once in the offline tuning mode.
+  void Insert(const std::string &kernel_key, size_t count, size_t thread_num, const ParallelTuningRecord &record);
+
+  // Save the new records to disk, which is not done on destruction, so the owner flushes it explicitly, e.g. the cpu
+  // device context flushes the instance when it is destroyed.
+  void Flush();
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(ParallelTuningDB);
+
+  std::string RecordKey(const std::string &kernel_key, size_t count, size_t thread_num) const;
+  void Load();
+  void FlushNoLock();
+
+  std::string db_path_;
+  bool is_offline_tuning_{false};
+  std::string cpu_model_;
+
+  std::mutex mutex_;
+  std::map<std::string, ParallelTuningRecord> records_;
+  // Whether there are records not saved yet.
+  bool is_dirty_{false};
+};
+}  // namespace kernel
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_CPU_PARALLEL_TUNING_DB_H_
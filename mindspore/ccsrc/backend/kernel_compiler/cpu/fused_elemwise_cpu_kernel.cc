@@ -0,0 +1,244 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "backend/kernel_compiler/cpu/fused_elemwise_cpu_kernel.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <utility>
+#include "base/core_ops.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+// The element number of the block, whose inputs and outputs of all the fused ops are kept in the cache.
+constexpr size_t kFusedBlockSize = 512;
+
+using ElemwiseOpType = FusedElemwiseCPUKernel::ElemwiseOpType;
+const std::map<std::string, std::pair<ElemwiseOpType, size_t>> &ElemwiseOps() {
+  static const std::map<std::string, std::pair<ElemwiseOpType, size_t>> elemwise_ops = {
+    {prim::kPrimAdd->name(), {ElemwiseOpType::kAdd, 2}},
+    {prim::kPrimSub->name(), {ElemwiseOpType::kSub, 2}},
+    {prim::kPrimMul->name(), {ElemwiseOpType::kMul, 2}},
+    {prim::kPrimRealDiv->name(), {ElemwiseOpType::kRealDiv, 2}},
+    {prim::kPrimMaximum->name(), {ElemwiseOpType::kMaximum, 2}},
+    {prim::kPrimMinimum->name(), {ElemwiseOpType::kMinimum, 2}},
+    {prim::kPrimNeg->name(), {ElemwiseOpType::kNeg, 1}},
+    {prim::kPrimExp->name(), {ElemwiseOpType::kExp, 1}},
+    {prim::kPrimLog->name(), {ElemwiseOpType::kLog, 1}},
+    {prim::kPrimSqrt->name(), {ElemwiseOpType::kSqrt, 1}},
+    {prim::kPrimRsqrt->name(), {ElemwiseOpType::kRsqrt, 1}},
+    {prim::kPrimAbs->name(), {ElemwiseOpType::kAbs, 1}},
+    {prim::kPrimReciprocal->name(), {ElemwiseOpType::kReciprocal, 1}},
+    {prim::kPrimSquare->name(), {ElemwiseOpType::kSquare, 1}}};
+  return elemwise_ops;
+}
+
+template <typename Op>
+void UnaryCompute(const float *x, float *out, size_t size, Op op) {
+  for (size_t i = 0; i < size; ++i) {
+    out[i] = op(x[i]);
+  }
+}
+
+template <typename Op>
+void BinaryCompute(const float *x, const float *y, float *out, size_t size, Op op) {
+  for (size_t i = 0; i < size; ++i) {
+    out[i] = op(x[i], y[i]);
+  }
+}
+}  // namespace
+
+bool FusedElemwiseCPUKernel::IsSupportedOp(const std::string &op_name, size_t *input_num) {
+  MS_EXCEPTION_IF_NULL(input_num);
+  const auto &elemwise_ops = ElemwiseOps();
+  auto iter = elemwise_ops.find(op_name);
+  if (iter == elemwise_ops.end()) {
+    return false;
+  }
+  *input_num = iter->second.second;
+  return true;
+}
+
+void FusedElemwiseCPUKernel::InitKernel(const CNodePtr &kernel_node) {
+  MS_EXCEPTION_IF_NULL(kernel_node);
+  auto op_names = AnfAlgo::GetNodeAttr<std::vector<std::string>>(kernel_node, kAttrFusedOps);
+  auto op_input_nums = AnfAlgo::GetNodeAttr<std::vector<int64_t>>(kernel_node, kAttrFusedOpInputNums);
+  auto op_inputs = AnfAlgo::GetNodeAttr<std::vector<int64_t>>(kernel_node, kAttrFusedOpInputs);
+  size_t input_num = AnfAlgo::GetInputTensorNum(kernel_node);
+  if ((op_names.size() != op_input_nums.size()) || (op_names.size() != AnfAlgo::GetOutputTensorNum(kernel_node))) {
+    MS_LOG(EXCEPTION) << "The fused op number " << op_names.size() << " mismatches the input number size "
+                      << op_input_nums.size() << " or the output number of " << kernel_node->fullname_with_scope();
+  }
+
+  fused_ops_.clear();
+  size_t offset = 0;
+  for (size_t i = 0; i < op_names.size(); ++i) {
+    size_t op_input_num = 0;
+    if ((!IsSupportedOp(op_names[i], &op_input_num)) || (LongToSize(op_input_nums[i]) != op_input_num) ||
+        (offset + op_input_num > op_inputs.size())) {
+      MS_LOG(EXCEPTION) << "Invalid fused op " << op_names[i] << " in " << kernel_node->fullname_with_scope();
+    }
+    FusedOp fused_op{ElemwiseOps().at(op_names[i]).first, {}};
+    for (size_t j = 0; j < op_input_num; ++j) {
+      auto input = op_inputs[offset + j];
+      // The op can only use the kernel inputs and the outputs of the former ops.
+      if ((input >= 0 && LongToSize(input) >= input_num) || (input < 0 && LongToSize(-input - 1) >= i)) {
+        MS_LOG(EXCEPTION) << "Invalid input " << input << " of the fused op " << op_names[i] << " in "
+                          << kernel_node->fullname_with_scope();
+      }
+      (void)fused_op.inputs.emplace_back(input);
+    }
+    offset += op_input_num;
+    (void)fused_ops_.emplace_back(std::move(fused_op));
+  }
+
+  output_shape_ = AnfAlgo::GetOutputDeviceShape(kernel_node, 0);
+  output_size_ = std::accumulate(output_shape_.begin(), output_shape_.end(), size_t(1), std::multiplies<size_t>());
+  input_strides_.clear();
+  is_input_broadcast_.clear();
+  for (size_t i = 0; i < input_num; ++i) {
+    auto input_shape = AnfAlgo::GetInputDeviceShape(kernel_node, i);
+    if (input_shape.size() > output_shape_.size()) {
+      MS_LOG(EXCEPTION) << "The input " << i << " of " << kernel_node->fullname_with_scope()
+                        << " can't be broadcast to the output shape.";
+    }
+    // Align the input shape to the output shape from the last dim.
+    std::vector<size_t> strides(output_shape_.size(), 0);
+    size_t stride = 1;
+    size_t dim_offset = output_shape_.size() - input_shape.size();
+    for (size_t j = input_shape.size(); j > 0; --j) {
+      auto dim = input_shape[j - 1];
+      if (dim != 1 && dim != output_shape_[dim_offset + j - 1]) {
+        MS_LOG(EXCEPTION) << "The input " << i << " of " << kernel_node->fullname_with_scope()
+                          << " can't be broadcast to the output shape.";
+      }
+      strides[dim_offset + j - 1] = (dim == 1) ? 0 : stride;
+      stride *= dim;
+    }
+    (void)input_strides_.emplace_back(std::move(strides));
+    (void)is_input_broadcast_.emplace_back(stride != output_size_);
+  }
+}
+
+const float *FusedElemwiseCPUKernel::GetBlockInput(const std::vector<AddressPtr> &inputs, size_t index, size_t start,
+                                                   size_t size, float *buffer) {
+  auto input = GetDeviceAddress<float>(inputs, index);
+  if (!is_input_broadcast_[index]) {
+    return input + start;
+  }
+  const auto &strides = input_strides_[index];
+  for (size_t i = 0; i < size; ++i) {
+    size_t pos = start + i;
+    size_t input_pos = 0;
+    for (size_t j = output_shape_.size(); j > 0; --j) {
+      input_pos += (pos % output_shape_[j - 1]) * strides[j - 1];
+      pos /= output_shape_[j - 1];
+    }
+    buffer[i] = input[input_pos];
+  }
+  return buffer;
+}
+
+void FusedElemwiseCPUKernel::ComputeBlock(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &outputs,
+                                          size_t start, size_t size, float *buffer) {
+  std::vector<const float *> block_inputs(inputs.size(), nullptr);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    block_inputs[i] = GetBlockInput(inputs, i, start, size, buffer + i * kFusedBlockSize);
+  }
+  auto operand = [&block_inputs, &outputs, start, this](int64_t input) -> const float * {
+    if (input >= 0) {
+      return block_inputs[LongToSize(input)];
+    }
+    return GetDeviceAddress<float>(outputs, LongToSize(-input - 1)) + start;
+  };
+
+  for (size_t i = 0; i < fused_ops_.size(); ++i) {
+    const auto &op = fused_ops_[i];
+    auto out = GetDeviceAddress<float>(outputs, i) + start;
+    const float *x = operand(op.inputs[0]);
+    const float *y = op.inputs.size() > 1 ? operand(op.inputs[1]) : nullptr;
+    switch (op.type) {
+      case ElemwiseOpType::kAdd:
+        BinaryCompute(x, y, out, size, [](float a, float b) { return a + b; });
+        break;
+      case ElemwiseOpType::kSub:
+        BinaryCompute(x, y, out, size, [](float a, float b) { return a - b; });
+        break;
+      case ElemwiseOpType::kMul:
+        BinaryCompute(x, y, out, size, [](float a, float b) { return a * b; });
+        break;
+      case ElemwiseOpType::kRealDiv:
+        BinaryCompute(x, y, out, size, [](float a, float b) { return a / b; });
+        break;
+      case ElemwiseOpType::kMaximum:
+        BinaryCompute(x, y, out, size, [](float a, float b) { return std::max(a, b); });
+        break;
+      case ElemwiseOpType::kMinimum:
+        BinaryCompute(x, y, out, size, [](float a, float b) { return std::min(a, b); });
+        break;
+      case ElemwiseOpType::kNeg:
+        UnaryCompute(x, out, size, [](float a) { return -a; });
+        break;
+      case ElemwiseOpType::kExp:
+        UnaryCompute(x, out, size, [](float a) { return std::exp(a); });
+        break;
+      case ElemwiseOpType::kLog:
+        UnaryCompute(x, out, size, [](float a) { return std::log(a); });
+        break;
+      case ElemwiseOpType::kSqrt:
+        UnaryCompute(x, out, size, [](float a) { return std::sqrt(a); });
+        break;
+      case ElemwiseOpType::kRsqrt:
+        UnaryCompute(x, out, size, [](float a) { return 1.0f / std::sqrt(a); });
+        break;
+      case ElemwiseOpType::kAbs:
+        UnaryCompute(x, out, size, [](float a) { return std::abs(a); });
+        break;
+      case ElemwiseOpType::kReciprocal:
+        UnaryCompute(x, out, size, [](float a) { return 1.0f / a; });
+        break;
+      case ElemwiseOpType::kSquare:
+        UnaryCompute(x, out, size, [](float a) { return a * a; });
+        break;
+      default:
+        MS_LOG(EXCEPTION) << "Unsupported fused op type " << static_cast<int>(op.type);
+    }
+  }
+}
+
+bool FusedElemwiseCPUKernel::Launch(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &,
+                                    const std::vector<AddressPtr> &outputs) {
+  if ((inputs.size() != input_strides_.size()) || (outputs.size() != fused_ops_.size())) {
+    MS_LOG(EXCEPTION) << "The input size " << inputs.size() << " or output size " << outputs.size()
+                      << " of FusedElemwise is invalid.";
+  }
+  if (output_size_ == 0) {
+    return true;
+  }
+  auto task = [this, &inputs, &outputs](size_t start, size_t end) {
+    std::vector<float> buffer(inputs.size() * kFusedBlockSize);
+    for (size_t pos = start; pos < end; pos += kFusedBlockSize) {
+      ComputeBlock(inputs, outputs, pos, std::min(kFusedBlockSize, end - pos), buffer.data());
+    }
+  };
+  ParallelLaunchAutoSearch(task, output_size_, this, &parallel_search_info_);
+  return true;
+}
+}  // namespace kernel
+}  // namespace mindspore
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_FUSED_ELEMWISE_CPU_KERNEL_H_
+#define MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_FUSED_ELEMWISE_CPU_KERNEL_H_
+
+#include <string>
+#include <vector>
+
+#include "backend/kernel_compiler/cpu/cpu_kernel.h"
+#include "backend/kernel_compiler/cpu/cpu_kernel_factory.h"
+
+namespace mindspore {
+namespace kernel {
+constexpr char kFusedElemwiseOpName[] = "FusedElemwise";
+// The names of the fused ops.
+constexpr char kAttrFusedOps[] = "fused_ops";
+// The input number of every fused op.
+constexpr char kAttrFusedOpInputNums[] = "fused_op_input_nums";
+// The flatten inputs of the fused ops, the non-negative value r is the input r of the fused kernel, and the negative
+// value r is the output of the fused op (-r - 1).
+constexpr char kAttrFusedOpInputs[] = "fused_op_inputs";
+
+// Run a cluster of float32 elementwise ops in one launch. Every op writes its output which has the same shape, and the
+// inputs of the fused kernel are broadcast to the output shape. The ops are computed block by block, so the outputs of
+// the former ops are still in the cache when the latter ops read them.
+class FusedElemwiseCPUKernel : public CPUKernel {
+ public:
+  FusedElemwiseCPUKernel() = default;
+  ~FusedElemwiseCPUKernel() override = default;
+
+  // Whether the op can be fused, and get the input number of the op.
+  static bool IsSupportedOp(const std::string &op_name, size_t *input_num);
+
+  void InitKernel(const CNodePtr &kernel_node) override;
+
+  bool Launch(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &workspace,
+              const std::vector<AddressPtr> &outputs) override;
+
+  enum class ElemwiseOpType {
+    kAdd,
+    kSub,
+    kMul,
+    kRealDiv,
+    kMaximum,
+    kMinimum,
+    kNeg,
+    kExp,
+    kLog,
+    kSqrt,
+    kRsqrt,
+    kAbs,
+    kReciprocal,
+    kSquare
+  };
+
+ private:
+  struct FusedOp {
+    ElemwiseOpType type;
+    std::vector<int64_t> inputs;
+  };
+
+  // Get the input of the fused kernel in the block [start, start + size).
+  const float *GetBlockInput(const std::vector<AddressPtr> &inputs, size_t index, size_t start, size_t size,
+                             float *buffer);
+  void ComputeBlock(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &outputs, size_t start,
+                    size_t size, float *buffer);
+
+  std::vector<FusedOp> fused_ops_;
+  std::vector<size_t> output_shape_;
+  size_t output_size_{0};
+  // The strides of the inputs in the output dims, the stride of the broadcast dim is zero.
+  std::vector<std::vector<size_t>> input_strides_;
+  std::vector<bool> is_input_broadcast_;
+};
+
+MS_REG_CPU_KERNEL(FusedElemwise,
+                  KernelAttr().SetAllSameAttr(true).AddInputAttr(kNumberTypeFloat32).AddOutputAttr(kNumberTypeFloat32),
+                  FusedElemwiseCPUKernel);
+}  // namespace kernel
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_FUSED_ELEMWISE_CPU_KERNEL_H_
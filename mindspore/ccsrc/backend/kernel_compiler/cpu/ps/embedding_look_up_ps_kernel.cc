@@ -96,6 +96,10 @@ void EmbeddingLookUpPSKernel::UpdateEmbeddings(float *embedding_table, const siz
     if (index < 0 || index >= SizeToInt(first_dim_size_)) {
       MS_LOG(EXCEPTION) << "UpdateEmbeddings index invalid.";
     }
+    std::unique_lock<std::shared_mutex> row_guard;
+    if (row_lock_ != nullptr) {
+      row_guard = std::unique_lock<std::shared_mutex>(row_lock_->GetLock(IntToSize(index)));
+    }
     auto ret = memcpy_s(embedding_table + IntToSize(index) * outer_dim_size_, dest_len,
                         update_vals + i * outer_dim_size_, copy_len);
     if (ret != EOK) {
@@ -104,6 +108,36 @@ void EmbeddingLookUpPSKernel::UpdateEmbeddings(float *embedding_table, const siz
   }
 }
 
+void EmbeddingLookUpPSKernel::LookupEmbeddings(const float *embedding_table, const size_t *lookup_ids,
+                                               size_t ids_size, float *output) const {
+  MS_EXCEPTION_IF_NULL(embedding_table);
+  MS_EXCEPTION_IF_NULL(lookup_ids);
+  MS_EXCEPTION_IF_NULL(output);
+  size_t copy_len = outer_dim_size_ * sizeof(float);
+  // The input shape is sharded, whose first dimension is the row number of this server.
+  int64_t row_num = input_shape_.empty() ? 0 : SizeToLong(input_shape_[kAxis]);
+  for (size_t i = 0; i < ids_size; ++i) {
+    float *dest = output + i * outer_dim_size_;
+    int64_t index = SizeToLong(lookup_ids[i]) - offset_;
+    // The ids out of the range of this server are looked up as zeros.
+    if (index < 0 || index >= row_num) {
+      auto ret = memset_s(dest, copy_len, 0, copy_len);
+      if (ret != EOK) {
+        MS_LOG(EXCEPTION) << "LookupEmbeddings memset failed.";
+      }
+      continue;
+    }
+    std::shared_lock<std::shared_mutex> row_guard;
+    if (row_lock_ != nullptr) {
+      row_guard = std::shared_lock<std::shared_mutex>(row_lock_->GetLock(LongToSize(index)));
+    }
+    auto ret = memcpy_s(dest, copy_len, embedding_table + LongToSize(index) * outer_dim_size_, copy_len);
+    if (ret != EOK) {
+      MS_LOG(EXCEPTION) << "LookupEmbeddings memcpy failed.";
+    }
+  }
+}
+
 const std::vector<size_t> &EmbeddingLookUpPSKernel::input_sizes() const { return input_shape_; }
 
 const std::vector<size_t> &EmbeddingLookUpPSKernel::output_sizes() const { return GetOutputSizeList(); }
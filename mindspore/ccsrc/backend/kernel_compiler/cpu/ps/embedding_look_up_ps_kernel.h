@@ -38,6 +38,9 @@ class EmbeddingLookUpPSKernel : public EmbeddingLookUpCPUKernel, public PServerK
                const std::vector<AddressPtr> &outputs) override;
   void UpdateEmbeddings(float *embedding_table, const size_t *lookup_ids, const float *update_vals,
                         size_t ids_size) override;
+  void LookupEmbeddings(const float *embedding_table, const size_t *lookup_ids, size_t ids_size,
+                        float *output) const override;
+  void SetRowLock(const RowStripedLockPtr &row_lock) override { row_lock_ = row_lock; }
   const std::vector<size_t> &input_sizes() const override;
   const std::vector<size_t> &output_sizes() const override;
   const std::vector<size_t> &workspace_sizes() const override;
@@ -45,6 +48,7 @@ class EmbeddingLookUpPSKernel : public EmbeddingLookUpCPUKernel, public PServerK
 
  private:
   std::vector<size_t> input_shape_;
+  RowStripedLockPtr row_lock_{nullptr};
 };
 }  // namespace ps
 }  // namespace kernel
@@ -19,6 +19,7 @@
 #include <vector>
 #include <memory>
 #include "backend/kernel_compiler/kernel.h"
+#include "backend/kernel_compiler/cpu/row_striped_lock.h"
 #include "ps/util.h"
 
 namespace mindspore {
@@ -40,6 +41,11 @@ class PServerKernel {
                        const std::vector<AddressPtr> &outputs) = 0;
   virtual void UpdateEmbeddings(float *embedding_table, const size_t *lookup_ids, const float *update_vals,
                                 size_t ids_size) {}
+  // Look up the embeddings without changing the kernel, so it can be called concurrently.
+  virtual void LookupEmbeddings(const float *embedding_table, const size_t *lookup_ids, size_t ids_size,
+                                float *output) const {}
+  // Set the row locks of the embedding table, which are shared by its lookup kernel and optimizer kernel.
+  virtual void SetRowLock(const RowStripedLockPtr &) {}
   virtual const std::vector<size_t> &input_sizes() const = 0;
   virtual const std::vector<size_t> &output_sizes() const = 0;
   virtual const std::vector<size_t> &workspace_sizes() const = 0;
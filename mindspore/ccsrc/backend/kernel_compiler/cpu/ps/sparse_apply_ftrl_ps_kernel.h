@@ -36,6 +36,7 @@ class SparseApplyFtrlPSKernel : public SparseApplyFtrlCPUKernel, public PServerK
                   const std::shared_ptr<std::vector<std::shared_ptr<std::vector<size_t>>>> &) override;
   void ReInit(const std::vector<std::vector<size_t>> &) override;
 
+  void SetRowLock(const RowStripedLockPtr &row_lock) override { set_row_lock(row_lock); }
   bool Execute(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &workspace,
                const std::vector<AddressPtr> &outputs) override;
 
@@ -0,0 +1,48 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_ROW_STRIPED_LOCK_H_
+#define MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_ROW_STRIPED_LOCK_H_
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace mindspore {
+namespace kernel {
+constexpr size_t kDefaultRowLockStripeNum = 1024;
+
+// The reader-writer locks of the rows of a table, such as the embedding table of the parameter server. The rows are
+// mapped to the stripes by their indices, so the rows in different stripes are read and updated concurrently.
+class RowStripedLock {
+ public:
+  explicit RowStripedLock(size_t stripe_num = kDefaultRowLockStripeNum) : stripes_(stripe_num == 0 ? 1 : stripe_num) {}
+  ~RowStripedLock() = default;
+
+  std::shared_mutex &GetLock(size_t row) { return stripes_[row % stripes_.size()].mutex; }
+
+ private:
+  // Each stripe occupies its own cache line, so the stripes locked by different threads are not falsely shared.
+  struct alignas(64) Stripe {
+    std::shared_mutex mutex;
+  };
+  std::vector<Stripe> stripes_;
+};
+using RowStripedLockPtr = std::shared_ptr<RowStripedLock>;
+}  // namespace kernel
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_ROW_STRIPED_LOCK_H_
@@ -15,6 +15,7 @@
  */
 
 #include "backend/kernel_compiler/cpu/sparse_apply_adam_cpu_kernel.h"
+#include <algorithm>
 #include "backend/kernel_compiler/common_utils.h"
 #include "runtime/device/cpu/cpu_device_address.h"
 
@@ -77,8 +78,24 @@ void ComputeWeight(MultiThreadComputeParams<T> *input_params, size_t start, size
   const auto *v = input_params->v_;
   const auto lr = input_params->lr_;
   const auto epsilon = input_params->epsilon_;
-  for (size_t i = start; i < end; ++i) {
-    var[i] -= lr * m[i] / (std::sqrt(v[i]) + epsilon);
+  const auto row_lock = input_params->row_lock_;
+  if (row_lock == nullptr) {
+    for (size_t i = start; i < end; ++i) {
+      var[i] -= lr * m[i] / (std::sqrt(v[i]) + epsilon);
+    }
+    return;
+  }
+  // Each row of the range is updated under the lock of its own stripe, so the rows of the other stripes can be read
+  // meanwhile, and no thread holds more than one stripe.
+  const auto var_outer_dim_size = input_params->var_outer_dim_size_;
+  size_t i = start;
+  while (i < end) {
+    size_t row = i / var_outer_dim_size;
+    size_t row_end = std::min(end, (row + 1) * var_outer_dim_size);
+    std::unique_lock<std::shared_mutex> row_guard(row_lock->GetLock(row));
+    for (; i < row_end; ++i) {
+      var[i] -= lr * m[i] / (std::sqrt(v[i]) + epsilon);
+    }
   }
 }
 }  // namespace
@@ -211,6 +228,7 @@ void SparseApplyAdamCPUKernel::LaunchKernel(const std::vector<kernel::AddressPtr
   input_params.var_ = var;
   input_params.lr_ = lr;
   input_params.epsilon_ = epsilon;
+  input_params.row_lock_ = row_lock_.get();
   MultiThreadCompute<T>(ComputeWeight<T>, &input_params, total_dim_size);
 }
 
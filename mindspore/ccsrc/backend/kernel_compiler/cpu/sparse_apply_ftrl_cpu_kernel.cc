@@ -38,12 +38,17 @@ void ComputeFtrl(MultiThreadComputeParams<T> *input_params, size_t start, size_t
   const auto unique_sparse_grad = input_params->sparse_grad_;
   const auto var_first_dim_size = input_params->var_first_dim_size_;
   const auto var_outer_dim_size = input_params->var_outer_dim_size_;
+  const auto row_lock = input_params->row_lock_;
   for (size_t i = start; i < end; ++i) {
     T index = unique_sparse_grad.indices_[i];
     if (index < 0 || LongToSize(index) >= var_first_dim_size) {
       MS_LOG(EXCEPTION) << "For '" << kKernelName << "', each element in 'indices' should be in range [0, "
                         << SizeToLong(var_first_dim_size) << "), but got " << index;
     }
+    std::unique_lock<std::shared_mutex> row_guard;
+    if (row_lock != nullptr) {
+      row_guard = std::unique_lock<std::shared_mutex>(row_lock->GetLock(static_cast<size_t>(index)));
+    }
     size_t start_index = var_outer_dim_size * static_cast<size_t>(index);
     size_t end_index = start_index + var_outer_dim_size;
     for (size_t j = start_index, k = var_outer_dim_size * i; j < end_index; ++j, ++k) {
@@ -191,6 +196,7 @@ void SparseApplyFtrlCPUKernel::LaunchKernel(const std::vector<kernel::AddressPtr
   input_params.sparse_grad_ = unique_sparse_grad;
   input_params.var_first_dim_size_ = var_first_dim_size_;
   input_params.var_outer_dim_size_ = var_outer_dim_size_;
+  input_params.row_lock_ = row_lock_.get();
   MultiThreadCompute<T>(ComputeFtrl<T>, &input_params, unique_sparse_grad.indices_size_);
 }
 
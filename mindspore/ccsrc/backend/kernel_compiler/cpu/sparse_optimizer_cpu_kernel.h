@@ -24,6 +24,7 @@
 #include <utility>
 #include "backend/kernel_compiler/cpu/cpu_kernel.h"
 #include "backend/kernel_compiler/cpu/cpu_kernel_factory.h"
+#include "backend/kernel_compiler/cpu/row_striped_lock.h"
 #include "common/thread_pool.h"
 namespace mindspore {
 namespace kernel {
@@ -63,6 +64,8 @@ struct MultiThreadComputeParams {
   size_t var_first_dim_size_{0};
   size_t var_outer_dim_size_{0};
   bool use_nesterov_;
+  // Each row of var is updated under its lock if it's not nullptr.
+  RowStripedLock *row_lock_{nullptr};
 };
 
 template <typename T>
@@ -92,6 +95,9 @@ class SparseOptimizerCPUKernel : public CPUKernel {
   SparseOptimizerCPUKernel() = default;
   ~SparseOptimizerCPUKernel() override = default;
 
+  // Set the row locks of var, so the rows can be read concurrently with the update, such as the embedding lookups.
+  void set_row_lock(const RowStripedLockPtr &row_lock) { row_lock_ = row_lock; }
+
   template <typename T>
   static void BucketReduceSparseGradient(const ReduceSparseGradientParam<T> &param) {
     MS_LOG(DEBUG) << "Start";
@@ -447,6 +453,7 @@ class SparseOptimizerCPUKernel : public CPUKernel {
   size_t indices_size_{0};
   size_t var_first_dim_size_{0};
   size_t var_outer_dim_size_{1};
+  RowStripedLockPtr row_lock_{nullptr};
 };
 }  // namespace kernel
 }  // namespace mindspore
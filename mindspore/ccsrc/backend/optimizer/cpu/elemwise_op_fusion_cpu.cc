@@ -0,0 +1,185 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "backend/optimizer/cpu/elemwise_op_fusion_cpu.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "backend/optimizer/common/helper.h"
+#include "backend/kernel_compiler/kernel_build_info.h"
+#include "backend/kernel_compiler/cpu/fused_elemwise_cpu_kernel.h"
+#include "backend/session/anf_runtime_algorithm.h"
+#include "backend/session/kernel_graph.h"
+#include "utils/utils.h"
+
+namespace mindspore {
+namespace opt {
+namespace {
+constexpr size_t kMinFusedOpNum = 2;
+
+bool IsBroadcastTo(const std::vector<size_t> &shape, const std::vector<size_t> &output_shape) {
+  if (shape.size() > output_shape.size()) {
+    return false;
+  }
+  size_t dim_offset = output_shape.size() - shape.size();
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if (shape[i] != 1 && shape[i] != output_shape[dim_offset + i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsFusibleKernel(const CNodePtr &kernel) {
+  MS_EXCEPTION_IF_NULL(kernel);
+  size_t input_num = 0;
+  if ((!kernel::FusedElemwiseCPUKernel::IsSupportedOp(AnfAlgo::GetCNodeName(kernel), &input_num)) ||
+      (AnfAlgo::GetInputTensorNum(kernel) != input_num) || (AnfAlgo::GetOutputTensorNum(kernel) != 1) ||
+      AnfAlgo::IsDynamicShape(kernel)) {
+    return false;
+  }
+  if ((AnfAlgo::GetOutputDeviceDataType(kernel, 0) != kNumberTypeFloat32) ||
+      (AnfAlgo::GetOutputFormat(kernel, 0) != kOpFormat_DEFAULT)) {
+    return false;
+  }
+  const auto &output_shape = AnfAlgo::GetOutputDeviceShape(kernel, 0);
+  for (size_t i = 0; i < input_num; ++i) {
+    if ((AnfAlgo::GetInputDeviceDataType(kernel, i) != kNumberTypeFloat32) ||
+        (AnfAlgo::GetInputFormat(kernel, i) != kOpFormat_DEFAULT) ||
+        (!IsBroadcastTo(AnfAlgo::GetInputDeviceShape(kernel, i), output_shape))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+CNodePtr CreateFusedNode(const KernelGraphPtr &graph, const std::vector<CNodePtr> &cluster) {
+  MS_EXCEPTION_IF_NULL(graph);
+  std::map<AnfNodePtr, size_t> cluster_index;
+  for (size_t i = 0; i < cluster.size(); ++i) {
+    cluster_index[cluster[i]] = i;
+  }
+
+  std::vector<AnfNodePtr> inputs = {NewValueNode(std::make_shared<Primitive>(kernel::kFusedElemwiseOpName))};
+  std::map<AnfNodePtr, int64_t> input_index;
+  std::vector<std::string> op_names;
+  std::vector<int64_t> op_input_nums;
+  std::vector<int64_t> op_inputs;
+  AbstractBasePtrList abstracts;
+  for (const auto &kernel : cluster) {
+    size_t input_num = AnfAlgo::GetInputTensorNum(kernel);
+    for (size_t i = 0; i < input_num; ++i) {
+      auto input = AnfAlgo::GetInputNode(kernel, i);
+      auto iter = cluster_index.find(input);
+      if (iter != cluster_index.end()) {
+        (void)op_inputs.emplace_back(-SizeToLong(iter->second) - 1);
+        continue;
+      }
+      auto input_iter = input_index.find(input);
+      if (input_iter == input_index.end()) {
+        input_iter = input_index.emplace(input, SizeToLong(inputs.size() - 1)).first;
+        (void)inputs.emplace_back(input);
+      }
+      (void)op_inputs.emplace_back(input_iter->second);
+    }
+    (void)op_names.emplace_back(AnfAlgo::GetCNodeName(kernel));
+    (void)op_input_nums.emplace_back(SizeToLong(input_num));
+    (void)abstracts.emplace_back(kernel->abstract());
+  }
+
+  auto fused_node = graph->NewCNode(inputs);
+  MS_EXCEPTION_IF_NULL(fused_node);
+  fused_node->set_abstract(std::make_shared<abstract::AbstractTuple>(abstracts));
+  fused_node->set_scope(cluster.front()->scope());
+  AnfAlgo::SetNodeAttr(kernel::kAttrFusedOps, MakeValue(op_names), fused_node);
+  AnfAlgo::SetNodeAttr(kernel::kAttrFusedOpInputNums, MakeValue(op_input_nums), fused_node);
+  AnfAlgo::SetNodeAttr(kernel::kAttrFusedOpInputs, MakeValue(op_inputs), fused_node);
+
+  kernel::KernelBuildInfo::KernelBuildInfoBuilder builder;
+  builder.SetInputsFormat(std::vector<std::string>(inputs.size() - 1, kOpFormat_DEFAULT));
+  builder.SetInputsDeviceType(std::vector<TypeId>(inputs.size() - 1, kNumberTypeFloat32));
+  builder.SetOutputsFormat(std::vector<std::string>(cluster.size(), kOpFormat_DEFAULT));
+  builder.SetOutputsDeviceType(std::vector<TypeId>(cluster.size(), kNumberTypeFloat32));
+  builder.SetKernelType(KernelType::CPU_KERNEL);
+  builder.SetProcessor(kernel::Processor::CPU);
+  AnfAlgo::SetSelectKernelBuildInfo(builder.Build(), fused_node.get());
+  return fused_node;
+}
+
+void FuseCluster(const KernelGraphPtr &graph, const std::vector<CNodePtr> &cluster) {
+  MS_EXCEPTION_IF_NULL(graph);
+  auto manager = graph->manager();
+  MS_EXCEPTION_IF_NULL(manager);
+  auto fused_node = CreateFusedNode(graph, cluster);
+  for (size_t i = 0; i < cluster.size(); ++i) {
+    (void)manager->Replace(cluster[i], CreatTupleGetItemNode(graph, fused_node, i));
+  }
+  MS_LOG(DEBUG) << "Fuse " << cluster.size() << " elementwise ops into " << fused_node->fullname_with_scope();
+}
+}  // namespace
+
+bool ElemwiseOpFusionCPU::Run(const FuncGraphPtr &func_graph) {
+  MS_EXCEPTION_IF_NULL(func_graph);
+  auto graph = func_graph->cast<KernelGraphPtr>();
+  MS_EXCEPTION_IF_NULL(graph);
+  // The outputs of the kernels in the other graphs are mapped to the front nodes, which the fused kernel would break.
+  if (!graph->has_flag(kAttrOpSequenceGraph)) {
+    return false;
+  }
+  if (graph->manager() == nullptr) {
+    auto manager = Manage(graph, true);
+    graph->set_manager(manager);
+  }
+
+  // The clusters are the consecutive kernels in the execution order, so the fused kernel keeps the order of the others.
+  std::vector<std::vector<CNodePtr>> clusters;
+  std::vector<CNodePtr> cluster;
+  std::vector<size_t> cluster_shape;
+  for (const auto &kernel : graph->execution_order()) {
+    if (!IsFusibleKernel(kernel)) {
+      if (cluster.size() >= kMinFusedOpNum) {
+        (void)clusters.emplace_back(std::move(cluster));
+      }
+      cluster.clear();
+      continue;
+    }
+    auto output_shape = AnfAlgo::GetOutputDeviceShape(kernel, 0);
+    if ((!cluster.empty()) && (output_shape != cluster_shape)) {
+      if (cluster.size() >= kMinFusedOpNum) {
+        (void)clusters.emplace_back(std::move(cluster));
+      }
+      cluster.clear();
+    }
+    cluster_shape = output_shape;
+    (void)cluster.emplace_back(kernel);
+  }
+  if (cluster.size() >= kMinFusedOpNum) {
+    (void)clusters.emplace_back(std::move(cluster));
+  }
+  if (clusters.empty()) {
+    return false;
+  }
+
+  for (const auto &item : clusters) {
+    FuseCluster(graph, item);
+  }
+  graph->SetExecOrderByDefault();
+  return true;
+}
+}  // namespace opt
+}  // namespace mindspore
@@ -0,0 +1,37 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_BACKEND_OPTIMIZER_CPU_ELEMWISE_OP_FUSION_CPU_H
+#define MINDSPORE_CCSRC_BACKEND_OPTIMIZER_CPU_ELEMWISE_OP_FUSION_CPU_H
+
+#include <string>
+#include "backend/optimizer/common/optimizer.h"
+#include "ir/anf.h"
+
+namespace mindspore {
+namespace opt {
+// Fuse the consecutive float32 elementwise kernels with the same output shape into one FusedElemwise kernel, which
+// runs the ops in one launch. Every output of the fused ops is kept, so it only runs on the graph of op sequence whose
+// op outputs are all returned, and skips the other graphs in the CPU passes.
+class ElemwiseOpFusionCPU : public Pass {
+ public:
+  explicit ElemwiseOpFusionCPU(const std::string &name) : Pass("elemwise_op_fusion_cpu") {}
+  ~ElemwiseOpFusionCPU() override = default;
+  bool Run(const FuncGraphPtr &graph) override;
+};
+}  // namespace opt
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_BACKEND_OPTIMIZER_CPU_ELEMWISE_OP_FUSION_CPU_H
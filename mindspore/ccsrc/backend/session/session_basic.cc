@@ -2303,6 +2303,111 @@ std::shared_ptr<KernelGraph> SessionBasic::ConstructSingleOpGraph(const OpRunInf
   return graph;
 }
 
+std::shared_ptr<KernelGraph> SessionBasic::ConstructOpSequenceGraph(
+  const std::vector<OpRunInfo> &op_run_infos, const std::vector<std::vector<OpSequenceInput>> &op_inputs) {
+  if (op_run_infos.size() != op_inputs.size()) {
+    MS_LOG(EXCEPTION) << "Op run infos size " << op_run_infos.size() << " should be equal to op inputs size "
+                      << op_inputs.size();
+  }
+  auto graph = std::make_shared<KernelGraph>();
+  graph->set_graph_id(graph_sum_);
+  graph_sum_++;
+  std::vector<CNodePtr> exe_order;
+  // The outputs of every op, the output is the tuple getitem node when the op has multiple outputs.
+  std::vector<std::vector<AnfNodePtr>> op_outputs;
+  std::vector<ParameterPtr> parameters;
+  std::vector<AnfNodePtr> make_tuple_inputs = {NewValueNode(prim::kPrimMakeTuple)};
+  for (size_t i = 0; i < op_run_infos.size(); ++i) {
+    const auto &op_run_info = op_run_infos[i];
+    const auto &input_tensors = op_run_info.input_tensors;
+    const auto &tensors_mask = op_run_info.tensor_mask;
+    if ((input_tensors.size() != tensors_mask.size()) || (input_tensors.size() != op_inputs[i].size())) {
+      MS_LOG(EXCEPTION) << "Input tensors size " << input_tensors.size() << " should be equal to tensors mask size "
+                        << tensors_mask.size() << " and op inputs size " << op_inputs[i].size();
+    }
+    auto op_prim = op_run_info.primitive;
+    MS_EXCEPTION_IF_NULL(op_prim);
+    std::vector<AnfNodePtr> inputs = {std::make_shared<ValueNode>(std::make_shared<Primitive>(*op_prim))};
+    for (size_t j = 0; j < input_tensors.size(); ++j) {
+      if (tensors_mask[j] == kValueNodeTensorMask) {
+        inputs.push_back(graph->NewValueNode(input_tensors[j]));
+        continue;
+      }
+      const auto &op_input = op_inputs[i][j];
+      if (op_input.op_index != kOpSequenceExternalInput) {
+        if ((op_input.op_index >= i) || (op_input.index >= op_outputs[op_input.op_index].size())) {
+          MS_LOG(EXCEPTION) << "The input " << j << " of op " << op_run_info.op_name << " is from the invalid op "
+                            << op_input.op_index << " output " << op_input.index;
+        }
+        inputs.push_back(op_outputs[op_input.op_index][op_input.index]);
+        continue;
+      }
+      // The same tensor used by multiple ops is the same parameter of graph.
+      if (op_input.index >= parameters.size()) {
+        parameters.resize(op_input.index + 1);
+      }
+      if (parameters[op_input.index] == nullptr) {
+        parameters[op_input.index] = ConstructRunOpParameter(graph, input_tensors[j], op_run_info, tensors_mask[j]);
+      }
+      inputs.push_back(parameters[op_input.index]);
+    }
+    auto cnode = graph->NewCNode(inputs);
+    MS_EXCEPTION_IF_NULL(cnode);
+    cnode->set_abstract(op_run_info.abstract);
+    AnfAlgo::SetNodeAttr(kAttrOutputIsDynamicShape, MakeValue(op_run_info.is_dynamic_shape), cnode);
+    if (op_run_info.is_auto_mixed_precision) {
+      AnfAlgo::SetNodeAttr(kAttrPynativeNextOpName, MakeValue(op_run_info.next_op_name), cnode);
+      AnfAlgo::SetNodeAttr(kAttrPynativeNextIndex, MakeValue(op_run_info.next_input_index), cnode);
+    }
+    exe_order.push_back(cnode);
+
+    auto &outputs = op_outputs.emplace_back();
+    size_t output_num = AnfRuntimeAlgorithm::GetOutputTensorNum(cnode);
+    if (output_num > 1) {
+      for (size_t output_index = 0; output_index < output_num; ++output_index) {
+        auto idx = NewValueNode(SizeToLong(output_index));
+        MS_EXCEPTION_IF_NULL(idx);
+        auto imm = std::make_shared<Int64Imm>(output_index);
+        idx->set_abstract(std::make_shared<abstract::AbstractScalar>(imm));
+        auto getitem = graph->NewCNode({NewValueNode(prim::kPrimTupleGetItem), cnode, idx});
+        std::vector<TypeId> types = {AnfAlgo::GetOutputInferDataType(cnode, output_index)};
+        std::vector<std::vector<size_t>> shapes = {AnfAlgo::GetOutputInferShape(cnode, output_index)};
+        AnfAlgo::SetOutputInferTypeAndShape(types, shapes, getitem.get());
+        outputs.push_back(getitem);
+      }
+    } else {
+      outputs.push_back(cnode);
+    }
+    (void)std::copy(outputs.begin(), outputs.end(), std::back_inserter(make_tuple_inputs));
+  }
+
+  // The parameters are created in the order of the external input index.
+  auto mutable_inputs = graph->MutableInputs();
+  MS_EXCEPTION_IF_NULL(mutable_inputs);
+  for (const auto &parameter : parameters) {
+    if (parameter == nullptr) {
+      MS_LOG(EXCEPTION) << "The external inputs of op sequence are not continuous.";
+    }
+    mutable_inputs->push_back(parameter);
+  }
+  graph->set_execution_order(exe_order);
+  graph->set_output(graph->NewCNode(make_tuple_inputs));
+  graph->set_flag(kAttrOpSequenceGraph, true);
+  graph->SetInputNodes();
+  auto manager = MakeManager({graph});
+  if (manager != nullptr) {
+    manager->AddFuncGraph(graph);
+    graph->set_manager(manager);
+  }
+  auto ms_context = MsContext::GetInstance();
+  MS_EXCEPTION_IF_NULL(ms_context);
+  if (ms_context->get_param<bool>(MS_CTX_ENABLE_PYNATIVE_INFER)) {
+    UnifyMindIR(graph);
+  }
+  graph->UpdateGraphDynamicAttr();
+  return graph;
+}
+
 KernelGraphPtr SessionBasic::NewKernelGraph() {
   auto graph = std::make_shared<KernelGraph>();
   graph->set_graph_id(graph_sum_);
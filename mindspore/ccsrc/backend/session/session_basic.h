@@ -76,6 +76,15 @@ struct OpRunInfo {
   std::string device_target = "Unknown";
 };
 
+// The input of op in the op sequence graph. The op index is the index of the former op in the sequence whose output
+// is the input, and the index is the output index of the former op. If the input is from outside of the sequence, the
+// op index is kOpSequenceExternalInput and the index is the index of the distinct external input tensors.
+constexpr size_t kOpSequenceExternalInput = SIZE_MAX;
+struct OpSequenceInput {
+  size_t op_index;
+  size_t index;
+};
+
 struct InputTensorInfo {
   std::vector<tensor::TensorPtr> input_tensors;
   std::vector<int64_t> input_tensors_mask;
@@ -157,6 +166,9 @@ class SessionBasic : public std::enable_shared_from_this<SessionBasic> {
   std::shared_ptr<KernelGraph> ConstructSingleOpGraph(const OpRunInfo &op_run_info,
                                                       const std::vector<tensor::TensorPtr> &input_tensors,
                                                       const std::vector<int64_t> &tensors_mask, bool is_ascend = false);
+  // create the graph of an op sequence in PyNative mode, every output of the ops is the output of graph
+  std::shared_ptr<KernelGraph> ConstructOpSequenceGraph(const std::vector<OpRunInfo> &op_run_infos,
+                                                        const std::vector<std::vector<OpSequenceInput>> &op_inputs);
   void EraseValueNodeTensor(const std::vector<int64_t> &tensors_mask,
                             std::vector<tensor::TensorPtr> *input_tensors) const;
   void RunOpRemoveNopNode(const KernelGraphPtr &kernel_graph) const;
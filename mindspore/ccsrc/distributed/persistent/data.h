@@ -17,14 +17,17 @@
 #ifndef MIINDSPORE_CCSRC_DISTRIBUTED_PERSISTENT_DATA_H_
 #define MIINDSPORE_CCSRC_DISTRIBUTED_PERSISTENT_DATA_H_
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <thread>
 #include <utility>
 
 #include "distributed/persistent/storage/local_file.h"
+#include "utils/convert_utils_base.h"
 #include "utils/log_adapter.h"
 
 namespace mindspore {
@@ -77,10 +80,19 @@ class PersistentData : public Data<T> {
   void Initialize(const std::map<std::string, std::string> &storage_config);
 
   // In disaster recovery mode, memory of tensor need to be saved into disk file periodically.
-  void Persist(const storage::DirtyInfo &dirty_info) const;
+  void Persist(const storage::DirtyInfo &dirty_info);
 
   // In disaster recovery mode, server node or worker node need to restore persistent data when restart.
-  void Restore() const;
+  void Restore();
+
+  // The following two methods are used to persist the data asynchronously without blocking its modification:
+  // 1. Copy the rows in the dirty info as a snapshot, which should be called when the data is not being modified.
+  // 2. Write the snapshot to storage, the dirty rows are written as the delta of the data persisted last time.
+  // If the data has not been persisted, nothing is copied by Snapshot, and the whole data is written block by block by
+  // PersistSnapshot. Each block is copied under the data_mutex which guards the modification, so the whole data is
+  // never copied at once. The rows modified during the writing are in the dirty info of the next snapshot.
+  void Snapshot(const storage::DirtyInfo &dirty_info);
+  void PersistSnapshot(std::mutex *data_mutex = nullptr);
 
  private:
   // The following variables are used in disaster recovery mode:
@@ -89,6 +101,14 @@ class PersistentData : public Data<T> {
 
   // The file storage handle used to persist data.
   std::shared_ptr<storage::StorageBase> storage_;
+
+  // Whether the whole data has been persisted or restored, after which only the dirty rows need to be persisted.
+  bool persisted_{false};
+
+  // The copy of the dirty rows and the sorted rows in it, or whether the whole data should be written.
+  std::vector<T> snapshot_;
+  storage::DirtyInfo snapshot_dirty_info_;
+  bool snapshot_is_full_{false};
 };
 
 template <typename T>
@@ -97,17 +117,75 @@ void PersistentData<T>::Initialize(const std::map<std::string, std::string> &sto
 }
 
 template <typename T>
-void PersistentData<T>::Persist(const storage::DirtyInfo &dirty_info) const {
+void PersistentData<T>::Persist(const storage::DirtyInfo &dirty_info) {
   MS_EXCEPTION_IF_NULL(storage_);
   storage::InputData input = std::make_tuple(*Data<T>::shape_, Data<T>::data(), Data<T>::size() * sizeof(T));
   storage_->Write(input, dirty_info);
+  persisted_ = true;
 }
 
 template <typename T>
-void PersistentData<T>::Restore() const {
+void PersistentData<T>::Restore() {
   storage::OutputData output = std::make_pair(Data<T>::data(), Data<T>::size() * sizeof(T));
   MS_EXCEPTION_IF_NULL(storage_);
   storage_->Read(output);
+  persisted_ = true;
+}
+
+template <typename T>
+void PersistentData<T>::Snapshot(const storage::DirtyInfo &dirty_info) {
+  snapshot_dirty_info_.clear();
+  snapshot_.clear();
+  snapshot_is_full_ = !persisted_;
+  if (snapshot_is_full_ || dirty_info.empty()) {
+    return;
+  }
+  MS_EXCEPTION_IF_NULL(Data<T>::shape_);
+  if (Data<T>::shape_->empty() || Data<T>::shape_->front() <= 0) {
+    MS_LOG(EXCEPTION) << "The first dimension of the shape should be positive to persist the dirty rows.";
+  }
+  int row_num = Data<T>::shape_->front();
+  size_t row_size = Data<T>::size() / IntToSize(row_num);
+
+  // The dirty info is appended by every update, so it may contain the duplicated rows.
+  snapshot_dirty_info_ = dirty_info;
+  std::sort(snapshot_dirty_info_.begin(), snapshot_dirty_info_.end());
+  snapshot_dirty_info_.erase(std::unique(snapshot_dirty_info_.begin(), snapshot_dirty_info_.end()),
+                             snapshot_dirty_info_.end());
+  snapshot_dirty_info_.erase(std::remove_if(snapshot_dirty_info_.begin(), snapshot_dirty_info_.end(),
+                                            [row_num](int row) { return row < 0 || row >= row_num; }),
+                             snapshot_dirty_info_.end());
+
+  snapshot_.resize(snapshot_dirty_info_.size() * row_size);
+  for (size_t i = 0; i < snapshot_dirty_info_.size(); ++i) {
+    const T *row = Data<T>::data() + IntToSize(snapshot_dirty_info_[i]) * row_size;
+    std::copy(row, row + row_size, snapshot_.begin() + i * row_size);
+  }
+}
+
+template <typename T>
+void PersistentData<T>::PersistSnapshot(std::mutex *data_mutex) {
+  MS_EXCEPTION_IF_NULL(storage_);
+  MS_EXCEPTION_IF_NULL(Data<T>::shape_);
+  if (snapshot_is_full_) {
+    auto reader = [this, data_mutex](size_t offset, size_t length, void *buffer) {
+      std::unique_lock<std::mutex> locker;
+      if (data_mutex != nullptr) {
+        locker = std::unique_lock<std::mutex>(*data_mutex);
+      }
+      const char *src = reinterpret_cast<const char *>(Data<T>::data()) + offset;
+      std::copy(src, src + length, static_cast<char *>(buffer));
+    };
+    storage_->WriteByParts(*Data<T>::shape_, Data<T>::size() * sizeof(T), reader);
+    persisted_ = true;
+  } else if (!snapshot_dirty_info_.empty()) {
+    storage::InputData input = std::make_tuple(*Data<T>::shape_, snapshot_.data(), snapshot_.size() * sizeof(T));
+    storage_->WriteDelta(input, snapshot_dirty_info_);
+  }
+
+  // Release the memory of the snapshot until the next persistence.
+  std::vector<T>().swap(snapshot_);
+  storage::DirtyInfo().swap(snapshot_dirty_info_);
 }
 }  // namespace persistent
 }  // namespace distributed
@@ -27,15 +27,20 @@ constexpr char kShardShape[] = "shard_shape";
 constexpr char kShardRangeLowerBound[] = "shard_range_lower_bound";
 constexpr char kShardRangeUpperBound[] = "shard_range_upper_bound";
 constexpr char kHashSeq[] = "hash_seq";
+constexpr char kGeneration[] = "generation";
 
 constexpr char kBlockFilePrefix[] = "block_";
 constexpr char kBlockMetaFilePrefix[] = "block_meta_";
 constexpr char kJsonSuffix[] = ".json";
 constexpr size_t JSON_SUFFIX_LENS = 5;
 
+// Delta log related.
+constexpr char kDeltaLogFileName[] = "delta_log";
+
 // Storage config related.
 constexpr char kFileStoragePath[] = "file_storage_path";
 constexpr char kMaxBlockLength[] = "max_block_length";
+constexpr char kMaxDeltaLogLength[] = "max_delta_log_length";
 }  // namespace storage
 }  // namespace distributed
 }  // namespace mindspore
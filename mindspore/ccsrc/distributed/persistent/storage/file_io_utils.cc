@@ -47,16 +47,16 @@ bool CheckFStreamLength(const std::string &file_name, std::fstream &fs, size_t s
 
   return true;
 }
-}  // namespace
 
-bool FileIOUtils::Write(const std::string &file_name, const std::vector<std::pair<const void *, size_t>> &inputs) {
+bool WriteFile(const std::string &file_name, const std::vector<std::pair<const void *, size_t>> &inputs,
+               std::ios::openmode mode) {
   if (file_name.empty()) {
     MS_LOG(ERROR) << "The file name is empty";
     return false;
   }
 
   std::fstream fs;
-  fs.open(file_name, std::ios::out | std::ios::binary);
+  fs.open(file_name, mode);
   if (!fs.is_open() || !fs.good()) {
     MS_LOG(ERROR) << "Open file failed, file name: " << file_name;
     return false;
@@ -83,6 +83,15 @@ bool FileIOUtils::Write(const std::string &file_name, const std::vector<std::pai
   fs.close();
   return true;
 }
+}  // namespace
+
+bool FileIOUtils::Write(const std::string &file_name, const std::vector<std::pair<const void *, size_t>> &inputs) {
+  return WriteFile(file_name, inputs, std::ios::out | std::ios::binary);
+}
+
+bool FileIOUtils::Append(const std::string &file_name, const std::vector<std::pair<const void *, size_t>> &inputs) {
+  return WriteFile(file_name, inputs, std::ios::out | std::ios::app | std::ios::binary);
+}
 
 bool FileIOUtils::Read(const std::string &file_name, const std::vector<std::pair<void *, size_t>> &outputs) {
   if (file_name.empty()) {
@@ -31,6 +31,9 @@ class FileIOUtils {
   // Write memory buffer to the file on overwriting mode, create a new file if the file is not exist.
   static bool Write(const std::string &file_name, const std::vector<std::pair<const void *, size_t>> &inputs);
 
+  // Append memory buffer to the end of the file, create a new file if the file is not exist.
+  static bool Append(const std::string &file_name, const std::vector<std::pair<const void *, size_t>> &inputs);
+
   // Read file and load the context into memory buffer, return false if the file is not exist.
   static bool Read(const std::string &file_name, const std::vector<std::pair<void *, size_t>> &outputs);
 
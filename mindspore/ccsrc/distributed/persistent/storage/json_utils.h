@@ -40,6 +40,9 @@ class JsonUtils {
   template <typename T>
   T Get(const std::string &key) const;
 
+  // Judge whether the key exists in json.
+  bool Exist(const std::string &key) const { return js_.contains(key); }
+
   // Insert a key-value pair into json or change the value corresponding to the key in json.
   template <typename T>
   void Insert(const std::string &key, const T &value);
@@ -17,21 +17,48 @@
 #include "distributed/persistent/storage/local_file.h"
 
 #include <dirent.h>
+#include <unistd.h>
 #include <cmath>
+#include <cstdio>
 #include <algorithm>
+#include <fstream>
 #include <numeric>
 #include <tuple>
 #include <utility>
 
+#include "securec/include/securec.h"
 #include "utils/convert_utils_base.h"
 #include "utils/file_utils.h"
 #include "utils/log_adapter.h"
 #include "utils/utils.h"
+#include "utils/system/crc32c.h"
 #include "distributed/persistent/storage/constants.h"
 
 namespace mindspore {
 namespace distributed {
 namespace storage {
+namespace {
+// A record of the delta log loaded into memory.
+struct DeltaRecord {
+  DeltaRecordHeader header;
+  std::vector<uint64_t> offsets;
+  std::vector<char> rows;
+};
+
+void RemoveFile(const std::string &file_name) {
+  if (FileIOUtils::IsFileOrDirExist(file_name) && std::remove(file_name.c_str()) != 0) {
+    MS_LOG(EXCEPTION) << "Failed to remove file " << file_name << ". Errno = " << errno;
+  }
+}
+
+void CopyRow(void *dst, size_t dst_max, const void *src, size_t size) {
+  auto ret = memcpy_s(dst, dst_max, src, size);
+  if (ret != EOK) {
+    MS_LOG(EXCEPTION) << "Memcpy of the row failed, errorno(" << ret << ")";
+  }
+}
+}  // namespace
+
 void LocalFile::Write(const InputData &input, const DirtyInfo &dirty_info) {
   std::vector<InputData> inputs = {input};
   Write(inputs, dirty_info);
@@ -46,7 +73,12 @@ void LocalFile::Write(const std::vector<InputData> &inputs, const DirtyInfo &dir
   if (finish_create_block_files_) {
     std::vector<int> block_indices;
     TransformDirtyInfoToBlockIndices(dirty_info, &block_indices);
+    if (block_indices.empty()) {
+      return;
+    }
 
+    // The rewritten blocks contain the latest rows, so the records in the delta log are not replayed on them.
+    ++generation_;
     for (const auto &block_index : block_indices) {
       WriteOneBlockFile(block_index, inputs);
     }
@@ -100,7 +132,32 @@ void LocalFile::WriteBlockFiles(const std::vector<InputData> &inputs) {
     MS_LOG(EXCEPTION) << "The inputs is empty";
   }
 
-  const std::vector<int> &shape = std::get<0>(inputs.front());
+  CreateBlocks(std::get<0>(inputs.front()), std::get<2>(inputs.front()), inputs.size());
+
+  // Write inputs_data to block files and Gen Sha256 seq.
+  for (size_t block_index = 0; block_index < block_list_.size(); ++block_index) {
+    WriteOneBlockFile(block_index, inputs);
+  }
+}
+
+void LocalFile::WriteByParts(const std::vector<int> &shape, size_t size, const DataReader &reader) {
+  MS_EXCEPTION_IF_NULL(reader);
+  CreateBlocks(shape, size, 1);
+
+  // Only the data of one block is in memory at a time.
+  std::vector<char> block_buffer;
+  for (size_t block_index = 0; block_index < block_list_.size(); ++block_index) {
+    const auto &block_meta_ptr = block_meta_list_.at(block_index);
+    MS_EXCEPTION_IF_NULL(block_meta_ptr);
+    size_t field_size = block_meta_ptr->Get<size_t>(kFieldsLength);
+    size_t offset = block_meta_ptr->Get<size_t>(kOffset);
+    block_buffer.resize(field_size);
+    reader(offset, field_size, block_buffer.data());
+    WriteBlockData(block_index, {{block_buffer.data(), field_size}});
+  }
+}
+
+void LocalFile::CreateBlocks(const std::vector<int> &shape, size_t size, size_t tensor_num) {
   size_t first_dim = 0;
   if (shape.size() > 0) {
     first_dim = IntToSize(shape[0]);
@@ -109,12 +166,11 @@ void LocalFile::WriteBlockFiles(const std::vector<InputData> &inputs) {
     MS_LOG(EXCEPTION) << "The dimension of input shape contain zero.";
   }
 
-  size_t non_first_dims_size = std::get<2>(inputs.front()) / first_dim;
+  size_t non_first_dims_size = size / first_dim;
   if (non_first_dims_size == 0) {
     MS_LOG(EXCEPTION) << "The size of input tensor is zero.";
   }
 
-  size_t tensor_num = inputs.size();
   size_t slice_size = static_cast<size_t>(
     std::floor(static_cast<float>(static_cast<float>(max_block_length_) / tensor_num) / non_first_dims_size));
   if (slice_size == 0) {
@@ -123,6 +179,12 @@ void LocalFile::WriteBlockFiles(const std::vector<InputData> &inputs) {
 
   size_t block_num = static_cast<size_t>(std::ceil(static_cast<float>(first_dim) / slice_size));
 
+  // All the data is rewritten, so the blocks loaded before and the delta log are dropped.
+  block_list_.clear();
+  block_meta_list_.clear();
+  RemoveFile(delta_log_file_name_);
+  delta_log_length_ = 0;
+
   size_t offset = 0;
   for (size_t block_index = 0; block_index < block_num; ++block_index) {
     // Create block meta.
@@ -148,11 +210,7 @@ void LocalFile::WriteBlockFiles(const std::vector<InputData> &inputs) {
   }
 
   finish_create_block_files_ = true;
-
-  // Write inputs_data to block files and Gen Sha256 seq.
-  for (size_t block_index = 0; block_index < block_num; ++block_index) {
-    WriteOneBlockFile(block_index, inputs);
-  }
+  InitBlockOffsets();
 }
 
 void LocalFile::WriteOneBlockFile(size_t block_index, const std::vector<InputData> &inputs) const {
@@ -168,19 +226,303 @@ void LocalFile::WriteOneBlockFile(size_t block_index, const std::vector<InputDat
     block_inputs_data.emplace_back(data_ptr, data_size);
   }
 
+  WriteBlockData(block_index, block_inputs_data);
+}
+
+void LocalFile::WriteBlockData(size_t block_index,
+                               const std::vector<std::pair<const void *, size_t>> &block_data) const {
   const auto &block_ptr = block_list_.at(block_index);
   MS_EXCEPTION_IF_NULL(block_ptr);
   // Rewrite the current block file.
-  if (!FileIOUtils::Write(block_ptr->block_file_name(), block_inputs_data)) {
+  if (!FileIOUtils::Write(block_ptr->block_file_name(), block_data)) {
     MS_LOG(EXCEPTION) << "Write to block file[" << block_ptr->block_file_name() << "] failed.";
   }
 
   ChangeFileMode(block_ptr->block_file_name(), S_IRWXU | S_IRWXG | S_IRWXO);
 
+  const auto &block_meta_ptr = block_meta_list_.at(block_index);
+  MS_EXCEPTION_IF_NULL(block_meta_ptr);
+  block_meta_ptr->Insert(kGeneration, generation_);
+
   // Generate sha256 hash sequence.
   block_ptr->GenSha256Seq();
 }
 
+void LocalFile::WriteDelta(const InputData &input, const DirtyInfo &dirty_info) {
+  std::vector<InputData> inputs = {input};
+  WriteDelta(inputs, dirty_info);
+}
+
+void LocalFile::WriteDelta(const std::vector<InputData> &inputs, const DirtyInfo &dirty_info) {
+  if (inputs.empty()) {
+    MS_LOG(EXCEPTION) << "The inputs is empty";
+  }
+  if (!finish_create_block_files_) {
+    MS_LOG(EXCEPTION) << "The block files should be created before writing the delta.";
+  }
+  if (dirty_info.empty()) {
+    return;
+  }
+
+  size_t row_num = dirty_info.size();
+  size_t rows_size = std::get<2>(inputs.front());
+  size_t row_length = rows_size / row_num;
+  if (row_length == 0 || row_length * row_num != rows_size) {
+    MS_LOG(EXCEPTION) << "The size of the dirty rows " << rows_size << " is not a multiple of the row number "
+                      << row_num;
+  }
+
+  std::vector<uint64_t> offsets(row_num);
+  for (size_t i = 0; i < row_num; ++i) {
+    if (dirty_info[i] < 0 || IntToSize(dirty_info[i]) * row_length + row_length > tensor_length_) {
+      MS_LOG(EXCEPTION) << "The dirty row " << dirty_info[i] << " is out of the range of the tensor.";
+    }
+    offsets[i] = IntToSize(dirty_info[i]) * row_length;
+  }
+
+  // The checksum covers the header whose checksum is zero, so the corrupted generation or lengths are detected.
+  DeltaRecordHeader header = {generation_, inputs.size(), row_num, row_length, 0};
+  std::vector<std::pair<const void *, size_t>> record_data = {{&header, sizeof(DeltaRecordHeader)},
+                                                              {offsets.data(), row_num * sizeof(uint64_t)}};
+  uint32_t checksum = system::Crc32c::MakeCrc32c(0, reinterpret_cast<const char *>(&header), sizeof(header));
+  checksum = system::Crc32c::MakeCrc32c(checksum, reinterpret_cast<const char *>(offsets.data()),
+                                        row_num * sizeof(uint64_t));
+  for (const auto &input : inputs) {
+    const char *rows = reinterpret_cast<const char *>(std::get<1>(input));
+    MS_EXCEPTION_IF_NULL(rows);
+    if (std::get<2>(input) != rows_size) {
+      MS_LOG(EXCEPTION) << "The sizes of the dirty rows of the inputs are different.";
+    }
+    checksum = system::Crc32c::MakeCrc32c(checksum, rows, rows_size);
+    record_data.emplace_back(rows, rows_size);
+  }
+  header.checksum = checksum;
+
+  bool create_delta_log = !FileIOUtils::IsFileOrDirExist(delta_log_file_name_);
+  if (!FileIOUtils::Append(delta_log_file_name_, record_data)) {
+    MS_LOG(EXCEPTION) << "Append to delta log file[" << delta_log_file_name_ << "] failed.";
+  }
+  if (create_delta_log) {
+    ChangeFileMode(delta_log_file_name_, S_IRWXU | S_IRWXG | S_IRWXO);
+  }
+  for (const auto &item : record_data) {
+    delta_log_length_ += item.second;
+  }
+
+  // The delta log is compacted before it gets longer than the block files, so the recovery reads at most twice the
+  // data of the block files.
+  if (delta_log_length_ >= std::min(max_delta_log_length_, tensor_length_ * inputs.size())) {
+    CompactDeltaLog(inputs.size());
+  }
+}
+
+void LocalFile::CompactDeltaLog(size_t input_num) {
+  std::vector<size_t> block_generations(block_list_.size());
+  for (size_t block_index = 0; block_index < block_list_.size(); ++block_index) {
+    block_generations[block_index] = GetBlockGeneration(block_index);
+  }
+
+  // Load the records, and group the rows which need to be replayed by the blocks in the order of the records.
+  std::vector<DeltaRecord> records;
+  std::map<size_t, std::vector<std::pair<size_t, size_t>>> block_rows;
+  auto load_record = [&](const DeltaRecordHeader &header, const uint64_t *offsets, const char *rows) {
+    if (header.input_num != input_num) {
+      MS_LOG(EXCEPTION) << "The input number of the delta record " << header.input_num
+                        << " is not equal to the input number " << input_num;
+    }
+    size_t record_index = records.size();
+    for (size_t i = 0; i < header.row_num; ++i) {
+      size_t block_index = GetBlockIndex(offsets[i]);
+      if (header.generation >= block_generations[block_index]) {
+        block_rows[block_index].emplace_back(record_index, i);
+      }
+    }
+    size_t rows_size = header.input_num * header.row_num * header.row_length;
+    records.push_back({header, std::vector<uint64_t>(offsets, offsets + header.row_num),
+                       std::vector<char>(rows, rows + rows_size)});
+  };
+  size_t valid_length = 0;
+  if (!ReadDeltaLog(load_record, &valid_length)) {
+    MS_LOG(EXCEPTION) << "Read delta log file[" << delta_log_file_name_ << "] failed.";
+  }
+
+  // The compacted blocks are newer than all the records in the delta log.
+  ++generation_;
+  for (const auto &block_rows_pair : block_rows) {
+    size_t block_index = block_rows_pair.first;
+    const auto &block_meta_ptr = block_meta_list_.at(block_index);
+    MS_EXCEPTION_IF_NULL(block_meta_ptr);
+    size_t field_size = block_meta_ptr->Get<size_t>(kFieldsLength);
+    size_t block_offset = block_meta_ptr->Get<size_t>(kOffset);
+
+    std::vector<std::vector<char>> block_buffers(input_num, std::vector<char>(field_size));
+    std::vector<std::pair<void *, size_t>> block_output_data;
+    for (auto &buffer : block_buffers) {
+      block_output_data.emplace_back(buffer.data(), field_size);
+    }
+    const auto &block_ptr = block_list_.at(block_index);
+    MS_EXCEPTION_IF_NULL(block_ptr);
+    if (!block_ptr->CheckSha256Seq()) {
+      MS_LOG(EXCEPTION) << "CheckSha256 failed, file name [" << block_ptr->block_file_name() << "]";
+    }
+    if (!FileIOUtils::Read(block_ptr->block_file_name(), block_output_data)) {
+      MS_LOG(EXCEPTION) << "Read block file[" << block_ptr->block_file_name() << "] failed.";
+    }
+
+    for (const auto &row : block_rows_pair.second) {
+      const DeltaRecord &record = records[row.first];
+      size_t row_length = record.header.row_length;
+      size_t offset_in_block = record.offsets[row.second] - block_offset;
+      for (size_t input_index = 0; input_index < input_num; ++input_index) {
+        const char *src = record.rows.data() + (input_index * record.header.row_num + row.second) * row_length;
+        CopyRow(block_buffers[input_index].data() + offset_in_block, field_size - offset_in_block, src, row_length);
+      }
+    }
+
+    std::vector<std::pair<const void *, size_t>> block_input_data;
+    for (const auto &buffer : block_buffers) {
+      block_input_data.emplace_back(buffer.data(), field_size);
+    }
+    WriteBlockData(block_index, block_input_data);
+  }
+
+  RemoveFile(delta_log_file_name_);
+  delta_log_length_ = 0;
+  MS_LOG(INFO) << "Compact " << records.size() << " delta records into " << block_rows.size()
+               << " block files, generation: " << generation_;
+}
+
+bool LocalFile::ReadDeltaLog(const DeltaRecordHandler &handler, size_t *valid_length) const {
+  MS_ERROR_IF_NULL(valid_length);
+  *valid_length = 0;
+  if (!FileIOUtils::IsFileOrDirExist(delta_log_file_name_)) {
+    return true;
+  }
+
+  std::ifstream fs(delta_log_file_name_, std::ios::in | std::ios::binary);
+  if (!fs.is_open() || !fs.good()) {
+    MS_LOG(ERROR) << "Open file failed, file name: " << delta_log_file_name_;
+    return false;
+  }
+  (void)fs.seekg(0, std::ios::end);
+  size_t file_length = static_cast<size_t>(fs.tellg());
+  (void)fs.seekg(0, std::ios::beg);
+
+  DeltaRecordHeader header;
+  std::vector<char> body;
+  while (*valid_length + sizeof(DeltaRecordHeader) <= file_length) {
+    (void)fs.read(reinterpret_cast<char *>(&header), sizeof(DeltaRecordHeader));
+    // The lengths are checked by divisions, so the garbage header of a torn record does not overflow them.
+    size_t remain_length = file_length - *valid_length - sizeof(DeltaRecordHeader);
+    if (!fs.good() || header.input_num == 0 || header.row_num == 0 || header.row_length == 0 ||
+        header.row_num > remain_length / sizeof(uint64_t)) {
+      break;
+    }
+    size_t offsets_length = header.row_num * sizeof(uint64_t);
+    size_t max_rows_length = remain_length - offsets_length;
+    if (header.input_num > max_rows_length || header.row_num > max_rows_length / header.input_num ||
+        header.row_length > max_rows_length / header.input_num / header.row_num) {
+      break;
+    }
+    size_t body_length = offsets_length + header.input_num * header.row_num * header.row_length;
+    body.resize(body_length);
+    (void)fs.read(body.data(), body_length);
+    if (!fs.good()) {
+      break;
+    }
+    DeltaRecordHeader unchecked_header = header;
+    unchecked_header.checksum = 0;
+    uint32_t checksum =
+      system::Crc32c::MakeCrc32c(0, reinterpret_cast<const char *>(&unchecked_header), sizeof(unchecked_header));
+    if (system::Crc32c::MakeCrc32c(checksum, body.data(), body_length) != header.checksum) {
+      break;
+    }
+    handler(header, reinterpret_cast<const uint64_t *>(body.data()), body.data() + offsets_length);
+    *valid_length += sizeof(DeltaRecordHeader) + body_length;
+  }
+  fs.close();
+
+  if (*valid_length < file_length) {
+    MS_LOG(WARNING) << "The incomplete record at the end of delta log file[" << delta_log_file_name_
+                    << "] is dropped, valid length: " << *valid_length << ", file length: " << file_length;
+  }
+  return true;
+}
+
+void LocalFile::ReplayDeltaLog(const std::vector<OutputData> &outputs) {
+  std::vector<size_t> block_generations(block_list_.size());
+  for (size_t block_index = 0; block_index < block_list_.size(); ++block_index) {
+    block_generations[block_index] = GetBlockGeneration(block_index);
+    generation_ = std::max(generation_, block_generations[block_index]);
+  }
+
+  auto replay_record = [&](const DeltaRecordHeader &header, const uint64_t *offsets, const char *rows) {
+    if (header.input_num != outputs.size()) {
+      MS_LOG(EXCEPTION) << "The input number of the delta record " << header.input_num
+                        << " is not equal to the output number " << outputs.size();
+    }
+    for (size_t i = 0; i < header.row_num; ++i) {
+      if (offsets[i] + header.row_length > tensor_length_) {
+        MS_LOG(EXCEPTION) << "The row offset " << offsets[i]
+                          << " of the delta record is out of the range of the tensor.";
+      }
+      if (header.generation < block_generations[GetBlockIndex(offsets[i])]) {
+        continue;
+      }
+      for (size_t output_index = 0; output_index < outputs.size(); ++output_index) {
+        size_t output_size = outputs[output_index].second;
+        if (offsets[i] + header.row_length > output_size) {
+          MS_LOG(EXCEPTION) << "The row offset " << offsets[i] << " of the delta record is out of the output size "
+                            << output_size;
+        }
+        void *dst = reinterpret_cast<char *>(outputs[output_index].first) + offsets[i];
+        const char *src = rows + (output_index * header.row_num + i) * header.row_length;
+        CopyRow(dst, output_size - offsets[i], src, header.row_length);
+      }
+    }
+    generation_ = std::max<size_t>(generation_, header.generation);
+  };
+
+  size_t valid_length = 0;
+  if (!ReadDeltaLog(replay_record, &valid_length)) {
+    MS_LOG(EXCEPTION) << "Read delta log file[" << delta_log_file_name_ << "] failed.";
+  }
+  // Drop the torn record at the end, so that the records appended later can be read.
+  if (FileIOUtils::IsFileOrDirExist(delta_log_file_name_) &&
+      truncate(delta_log_file_name_.c_str(), static_cast<off_t>(valid_length)) != 0) {
+    MS_LOG(EXCEPTION) << "Failed to truncate delta log file[" << delta_log_file_name_ << "]. Errno = " << errno;
+  }
+  delta_log_length_ = valid_length;
+}
+
+size_t LocalFile::GetBlockIndex(size_t offset) const {
+  if (block_offsets_.empty()) {
+    MS_LOG(EXCEPTION) << "The block offsets is empty";
+  }
+  auto iter = std::upper_bound(block_offsets_.begin(), block_offsets_.end(), offset);
+  return static_cast<size_t>(std::distance(block_offsets_.begin(), iter)) - 1;
+}
+
+size_t LocalFile::GetBlockGeneration(size_t block_index) const {
+  const auto &block_meta_ptr = block_meta_list_.at(block_index);
+  MS_EXCEPTION_IF_NULL(block_meta_ptr);
+  return block_meta_ptr->Exist(kGeneration) ? block_meta_ptr->Get<size_t>(kGeneration) : 0;
+}
+
+void LocalFile::InitBlockOffsets() {
+  block_offsets_.clear();
+  tensor_length_ = 0;
+  for (const auto &block_meta_ptr : block_meta_list_) {
+    MS_EXCEPTION_IF_NULL(block_meta_ptr);
+    size_t offset = block_meta_ptr->Get<size_t>(kOffset);
+    if (!block_offsets_.empty() && offset < block_offsets_.back()) {
+      MS_LOG(EXCEPTION) << "The offsets of the blocks are not in ascending order.";
+    }
+    block_offsets_.push_back(offset);
+    tensor_length_ = std::max(tensor_length_, offset + block_meta_ptr->Get<size_t>(kFieldsLength));
+  }
+}
+
 void LocalFile::Read(const OutputData &output) {
   std::vector<OutputData> outputs = {output};
   Read(outputs);
@@ -192,6 +534,7 @@ void LocalFile::Read(const std::vector<OutputData> &outputs) {
     if (!LoadBlocksInfo()) {
       MS_LOG(EXCEPTION) << "LoadBlocksInfo failed";
     }
+    InitBlockOffsets();
   }
 
   // Read all block files.
@@ -215,6 +558,10 @@ void LocalFile::Read(const std::vector<OutputData> &outputs) {
     }
     FileIOUtils::Read(block_ptr->block_file_name(), block_output_data);
   }
+
+  ReplayDeltaLog(outputs);
+  // The block files are ready, so the dirty rows persisted after the recovery can be written as the delta.
+  finish_create_block_files_ = true;
 }
 
 bool LocalFile::LoadBlocksInfo() {
@@ -238,7 +585,7 @@ bool LocalFile::LoadBlocksInfo() {
     auto suffix = file_name.substr(file_name.length() - JSON_SUFFIX_LENS);
     if (suffix == kJsonSuffix) {
       block_meta_file_name_list.push_back(real_storage_file_path);
-    } else {
+    } else if (file_name.find(kBlockFilePrefix) == 0) {
       block_file_name_list.push_back(real_storage_file_path);
     }
   }
@@ -261,6 +608,21 @@ bool LocalFile::LoadBlocksInfo() {
     block_ptr->set_block_meta(block_meta_ptr);
     block_list_.push_back(block_ptr);
   }
+
+  // The blocks are sorted by their offsets rather than the file names, in which 'block_10' is ahead of 'block_2'.
+  std::vector<size_t> block_order(block_list_.size());
+  std::iota(block_order.begin(), block_order.end(), 0);
+  std::sort(block_order.begin(), block_order.end(), [this](size_t lhs, size_t rhs) {
+    return block_meta_list_[lhs]->Get<size_t>(kOffset) < block_meta_list_[rhs]->Get<size_t>(kOffset);
+  });
+  std::vector<std::shared_ptr<Block>> sorted_block_list;
+  std::vector<std::shared_ptr<BlockMeta>> sorted_block_meta_list;
+  for (size_t block_index : block_order) {
+    sorted_block_list.push_back(block_list_[block_index]);
+    sorted_block_meta_list.push_back(block_meta_list_[block_index]);
+  }
+  block_list_.swap(sorted_block_list);
+  block_meta_list_.swap(sorted_block_meta_list);
   return true;
 }
 }  // namespace storage
@@ -17,9 +17,12 @@
 #ifndef MINDSPORE_CCSRC_DISTRIBUTED_PERSISTENT_STORAGE_LOCAL_FILE_H_
 #define MINDSPORE_CCSRC_DISTRIBUTED_PERSISTENT_STORAGE_LOCAL_FILE_H_
 
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "distributed/persistent/storage/storage.h"
@@ -31,6 +34,27 @@ namespace distributed {
 namespace storage {
 // The default maximum block length : 128MB.
 constexpr size_t DEFAULT_MAX_BLOCK_LENGTH = 128 << 20;
+// The default maximum delta log length : 512MB, the delta log is compacted into the block files when it gets longer
+// than this or the block files.
+constexpr size_t DEFAULT_MAX_DELTA_LOG_LENGTH = 512 << 20;
+
+// The header of a record in the delta log, every write of the dirty rows appends one record. The header is followed by
+// the byte offsets of the rows in the tensor, then the rows of every tensor in the order of the offsets.
+struct DeltaRecordHeader {
+  // The generation of the block files when the record is appended. The record is only replayed on the blocks whose
+  // generation is not newer, because the newer blocks are rewritten from the data containing the rows already.
+  uint64_t generation;
+  uint64_t input_num;
+  uint64_t row_num;
+  // The byte length of one row of one tensor.
+  uint64_t row_length;
+  // The crc32c of the header with this field zeroed, the offsets and the rows, which detects the record torn by a
+  // crash.
+  uint64_t checksum;
+};
+
+// The handler of a record in the delta log, the parameters are the header, the offsets and the rows of the record.
+using DeltaRecordHandler = std::function<void(const DeltaRecordHeader &, const uint64_t *, const char *)>;
 
 // File type persistence storage implementation class.
 class LocalFile : public StorageBase {
@@ -47,6 +71,14 @@ class LocalFile : public StorageBase {
     } else {
       max_block_length_ = DEFAULT_MAX_BLOCK_LENGTH;
     }
+
+    auto delta_log_length_iter = storage_config.find(kMaxDeltaLogLength);
+    if (delta_log_length_iter != storage_config.end() && !(delta_log_length_iter->second).empty()) {
+      max_delta_log_length_ = std::stoul(delta_log_length_iter->second);
+    } else {
+      max_delta_log_length_ = DEFAULT_MAX_DELTA_LOG_LENGTH;
+    }
+    delta_log_file_name_ = file_path_ + "/" + kDeltaLogFileName;
   }
 
   ~LocalFile() override = default;
@@ -59,9 +91,20 @@ class LocalFile : public StorageBase {
   // Write the entire blob data composed of multiple tensors to the block files on disk:
   void Write(const std::vector<InputData> &inputs, const DirtyInfo &dirty_info = {}) override;
 
+  // Create the block files of the tensor, and write every block file by the data the reader copies for it.
+  void WriteByParts(const std::vector<int> &shape, size_t size, const DataReader &reader) override;
+
+  // The following two methods are override version function for WriteDelta:
+  // 1. Append the dirty rows to the delta log as one record, so only the dirty rows are written.
+  // 2. Compact the delta log into the block files when the delta log is too long.
+  // The block files must have been created by Write or loaded by Read.
+  void WriteDelta(const InputData &input, const DirtyInfo &dirty_info) override;
+  void WriteDelta(const std::vector<InputData> &inputs, const DirtyInfo &dirty_info) override;
+
   // The following two methods are override version function for Read:
   // 1.Tamper proof check.
   // 2.Read all block files and merge them into contiguous memory.
+  // 3.Replay the delta log on the data of the block files.
   // Read data from all block files in file_path_(dir):
   void Read(const OutputData &output) override;
   // Read data from all block files in file_path_(dir) for multiple tensors.
@@ -71,9 +114,34 @@ class LocalFile : public StorageBase {
   // Create blocks and block metas and write input data to block files.
   void WriteBlockFiles(const std::vector<InputData> &inputs);
 
+  // Create blocks and block metas for the tensors of the shape and the byte size, and drop the delta log.
+  void CreateBlocks(const std::vector<int> &shape, size_t size, size_t tensor_num);
+
   // Write shardding data to one specific block file by block index and generate sha256.
   void WriteOneBlockFile(size_t block_index, const std::vector<InputData> &inputs) const;
 
+  // Rewrite one specific block file by the data of every tensor in the block, and stamp it with current generation.
+  void WriteBlockData(size_t block_index, const std::vector<std::pair<const void *, size_t>> &block_data) const;
+
+  // Merge the records of the delta log into the block files they update, and remove the delta log.
+  void CompactDeltaLog(size_t input_num);
+
+  // Replay the records of the delta log on the data read from the block files.
+  void ReplayDeltaLog(const std::vector<OutputData> &outputs);
+
+  // Read the records of the delta log one by one. The reading stops at the first incomplete or corrupted record, and
+  // the length of the complete records is returned by 'valid_length'.
+  bool ReadDeltaLog(const DeltaRecordHandler &handler, size_t *valid_length) const;
+
+  // Get the index of the block containing the byte offset of the tensor.
+  size_t GetBlockIndex(size_t offset) const;
+
+  // Get the generation of the block, the block files written without the generation are generation 0.
+  size_t GetBlockGeneration(size_t block_index) const;
+
+  // Record the byte offsets of the blocks in ascending order and the byte length of the tensor.
+  void InitBlockOffsets();
+
   // Obtain the corresponding file block index according to dirty info, only need to rewrite these file blocks, and
   // dirty info needs to be sorted in ascending order.
   void TransformDirtyInfoToBlockIndices(const DirtyInfo &dirty_info, std::vector<int> *block_indices) const;
@@ -96,6 +164,24 @@ class LocalFile : public StorageBase {
 
   // Indicates whether block files has been created.
   bool finish_create_block_files_{false};
+
+  // The start byte offsets of the blocks in 'block_list_' in the tensor, which are in ascending order.
+  std::vector<size_t> block_offsets_;
+
+  // The byte length of one tensor stored in the block files.
+  size_t tensor_length_{0};
+
+  // The file path of the delta log, which appends the dirty rows written after the block files.
+  std::string delta_log_file_name_;
+
+  // Maximum size of the delta log before it is compacted into the block files.
+  size_t max_delta_log_length_;
+
+  // Current size of the delta log.
+  size_t delta_log_length_{0};
+
+  // The generation of the block files, which increases every time the blocks are rewritten after they are created.
+  size_t generation_{0};
 };
 }  // namespace storage
 }  // namespace distributed
@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_CCSRC_DISTRIBUTED_PERSISTENT_STORAGE_STORAGE_H_
 #define MINDSPORE_CCSRC_DISTRIBUTED_PERSISTENT_STORAGE_STORAGE_H_
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -35,6 +36,8 @@ using InputData = std::tuple<std::vector<int>, const void *, size_t>;
 using OutputData = std::pair<void *, size_t>;
 // DirtyInfo is used to indicate the part of the Tensor that needs to be rewritten to storage,
 using DirtyInfo = std::vector<int>;
+// DataReader copies the bytes of the Tensor in the range [offset, offset + length) to the buffer.
+using DataReader = std::function<void(size_t offset, size_t length, void *buffer)>;
 
 // This Class provides upper-layer interfaces for persistent storage.
 class StorageBase {
@@ -53,6 +56,18 @@ class StorageBase {
   // The parameter dirty_info is optional, indicating that the part of the Tensor that needs to be rewritten to storage.
   virtual void Write(const std::vector<InputData> &input, const DirtyInfo &dirty_info = {}) {}
 
+  // Write the whole tensor of the shape and the byte size to storage part by part, the data of each part is copied by
+  // the reader right before it is written, so the whole tensor is never copied at once.
+  virtual void WriteByParts(const std::vector<int> &shape, size_t size, const DataReader &reader) {}
+
+  // Write the dirty rows of the tensor to storage as an increment on the data written before, instead of rewriting the
+  // whole tensor. The shape of the input is the shape of the whole tensor, and the buffer of the input only contains
+  // the rows in the dirty info, which are stored contiguously in the order of the dirty info.
+  virtual void WriteDelta(const InputData &input, const DirtyInfo &dirty_info) {}
+
+  // Write the dirty rows of multiple tensors with same shape and data type and using same dirty info.
+  virtual void WriteDelta(const std::vector<InputData> &inputs, const DirtyInfo &dirty_info) {}
+
   // Read data from the storage medium or memory buffer and merge them into contiguous memory.
   virtual void Read(const OutputData &output) {}
 
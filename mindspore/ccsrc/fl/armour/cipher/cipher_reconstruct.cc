@@ -17,6 +17,7 @@
 #include "fl/armour/cipher/cipher_reconstruct.h"
 #include "fl/server/common.h"
 #include "fl/armour/secure_protocol/masking.h"
+#include "nnacl/fp32/add_fp32.h"
 #include "fl/armour/secure_protocol/key_agreement.h"
 #include "fl/armour/cipher/cipher_meta_storage.h"
 
@@ -38,6 +39,17 @@ bool CipherReconStruct::CombineMask(std::vector<Share *> *shares_tmp,
     MS_LOG(ERROR) << "shares_tmp or client_noise is nullptr.";
     return false;
   }
+  BIGNUM *prime = BN_new();
+  if (prime == nullptr) {
+    return false;
+  }
+  auto publicparam_ = CipherInit::GetInstance().GetPublicParams();
+  (void)BN_bin2bn(publicparam_->prime, PRIME_MAX_LEN, prime);
+  SecretSharing combine(prime);
+  BN_clear_free(prime);
+  // The secrets are usually combined from the shares of the same clients, so the lagrange coefficients of the same
+  // share indices are computed only once.
+  std::map<std::vector<unsigned int>, std::vector<BIGNUM *>> lagrange_coefficients;
   for (auto iter = reconstruct_secret_list.begin(); iter != reconstruct_secret_list.end(); ++iter) {
     // define flag_share: judge we need b or s
     bool flag_share = true;
@@ -47,84 +59,83 @@ bool CipherReconStruct::CombineMask(std::vector<Share *> *shares_tmp,
       flag_share = false;
     }
     MS_LOG(INFO) << "fl_id_src : " << fl_id;
-    BIGNUM *prime = BN_new();
-    if (prime == nullptr) {
-      return false;
+    if (iter->second.size() < cipher_init_->secrets_minnums_) {
+      MS_LOG(ERROR) << "reconstruct secret failed: the number of secret shares for fl_id: " << fl_id
+                    << " is not enough";
+      MS_LOG(ERROR) << "get " << iter->second.size()
+                    << "shares, however the secrets_minnums_ required is: " << cipher_init_->secrets_minnums_;
+      retcode = false;
+      break;
     }
-    auto publicparam_ = CipherInit::GetInstance().GetPublicParams();
-    (void)BN_bin2bn(publicparam_->prime, PRIME_MAX_LEN, prime);
-    if (iter->second.size() >= cipher_init_->secrets_minnums_) {  // combine private key seed.
-      MS_LOG(INFO) << "start assign secrets shares to public shares ";
-      for (int i = 0; i < static_cast<int>(cipher_init_->secrets_minnums_); ++i) {
-        shares_tmp->at(i)->index = (iter->second)[i].index;
-        shares_tmp->at(i)->len = (iter->second)[i].share.size();
-        if (memcpy_s(shares_tmp->at(i)->data, IntToSize(SHARE_MAX_SIZE), (iter->second)[i].share.data(),
-                     shares_tmp->at(i)->len) != 0) {
-          MS_LOG(ERROR) << "shares_tmp copy failed";
-          retcode = false;
-        }
+    // combine private key seed.
+    MS_LOG(INFO) << "start assign secrets shares to public shares ";
+    std::vector<unsigned int> indices;
+    for (int i = 0; i < static_cast<int>(cipher_init_->secrets_minnums_); ++i) {
+      shares_tmp->at(i)->index = (iter->second)[i].index;
+      shares_tmp->at(i)->len = (iter->second)[i].share.size();
+      indices.push_back(shares_tmp->at(i)->index);
+      if (memcpy_s(shares_tmp->at(i)->data, IntToSize(SHARE_MAX_SIZE), (iter->second)[i].share.data(),
+                   shares_tmp->at(i)->len) != 0) {
+        MS_LOG(ERROR) << "shares_tmp copy failed";
+        retcode = false;
       }
-      MS_LOG(INFO) << "end assign secrets shares to public shares ";
-
-      size_t length;
-      uint8_t secret[SECRET_MAX_LEN] = {0};
-      SecretSharing combine(prime);
-      if (combine.Combine(cipher_init_->secrets_minnums_, *shares_tmp, secret, &length) < 0) retcode = false;
-      length = SECRET_MAX_LEN;
-      MS_LOG(INFO) << "combine secrets shares Success.";
+    }
+    MS_LOG(INFO) << "end assign secrets shares to public shares ";
 
-      if (flag_share) {
-        // reconstruct pairwise noise
-        MS_LOG(INFO) << "start reconstruct pairwise noise.";
-        std::vector<float> noise(cipher_init_->featuremap_, 0.0);
-        if (GetSuvNoise(clients_share_list, record_public_keys, client_ivs, fl_id, &noise, secret, length) == false) {
-          MS_LOG(ERROR) << "GetSuvNoise failed";
-          BN_clear_free(prime);
-          if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
-            MS_LOG(EXCEPTION) << "Memset failed.";
-          }
-          return false;
-        }
-        (void)client_noise->emplace(std::pair<std::string, std::vector<float>>(fl_id, noise));
-      } else {
-        // reconstruct individual noise
-        MS_LOG(INFO) << "start reconstruct individual noise.";
-        std::vector<float> noise;
-        auto it = client_ivs.find(fl_id);
-        if (it == client_ivs.end()) {
-          MS_LOG(ERROR) << "cannot get ivs for client: " << fl_id;
-          return false;
-        }
-        if (it->second.size() != IV_NUM) {
-          MS_LOG(ERROR) << "get " << it->second.size() << " ivs, the iv num required is: " << IV_NUM;
-          return false;
-        }
-        std::vector<uint8_t> ind_iv = it->second[0];
-        if (Masking::GetMasking(&noise, SizeToInt(cipher_init_->featuremap_), (const uint8_t *)secret, SECRET_MAX_LEN,
-                                ind_iv.data(), SizeToInt(ind_iv.size())) < 0) {
-          MS_LOG(ERROR) << "Get Masking failed";
-          if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
-            MS_LOG(EXCEPTION) << "Memset failed.";
-          }
-          BN_clear_free(prime);
-          return false;
-        }
-        for (size_t index_noise = 0; index_noise < cipher_init_->featuremap_; index_noise++) {
-          noise[index_noise] *= -1;
-        }
-        (void)client_noise->emplace(std::pair<std::string, std::vector<float>>(fl_id, noise));
+    auto coefficients_iter = lagrange_coefficients.find(indices);
+    if (coefficients_iter == lagrange_coefficients.end()) {
+      std::vector<BIGNUM *> coefficients;
+      if (combine.GetLagrangeCoefficients(indices, &coefficients) < 0) {
+        MS_LOG(ERROR) << "Get lagrange coefficients of the shares for fl_id: " << fl_id << " failed.";
+        retcode = false;
+        break;
       }
-      BN_clear_free(prime);
-      if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
-        MS_LOG(EXCEPTION) << "Memset failed.";
+      coefficients_iter = lagrange_coefficients.emplace(indices, coefficients).first;
+    }
+    size_t length;
+    uint8_t secret[SECRET_MAX_LEN] = {0};
+    if (combine.Combine(cipher_init_->secrets_minnums_, *shares_tmp, coefficients_iter->second, secret, &length) < 0) {
+      retcode = false;
+    }
+    length = SECRET_MAX_LEN;
+    MS_LOG(INFO) << "combine secrets shares Success.";
+
+    bool noise_ret = true;
+    std::vector<float> noise(cipher_init_->featuremap_, 0.0);
+    if (flag_share) {
+      // reconstruct pairwise noise
+      MS_LOG(INFO) << "start reconstruct pairwise noise.";
+      noise_ret = GetSuvNoise(clients_share_list, record_public_keys, client_ivs, fl_id, &noise, secret, length);
+      if (!noise_ret) {
+        MS_LOG(ERROR) << "GetSuvNoise failed";
       }
     } else {
-      MS_LOG(ERROR) << "reconstruct secret failed: the number of secret shares for fl_id: " << fl_id
-                    << " is not enough";
-      MS_LOG(ERROR) << "get " << iter->second.size()
-                    << "shares, however the secrets_minnums_ required is: " << cipher_init_->secrets_minnums_;
-      return false;
+      // reconstruct individual noise
+      MS_LOG(INFO) << "start reconstruct individual noise.";
+      auto it = client_ivs.find(fl_id);
+      if (it == client_ivs.end()) {
+        MS_LOG(ERROR) << "cannot get ivs for client: " << fl_id;
+        noise_ret = false;
+      } else if (it->second.size() != IV_NUM) {
+        MS_LOG(ERROR) << "get " << it->second.size() << " ivs, the iv num required is: " << IV_NUM;
+        noise_ret = false;
+      } else if (Masking::AccumulateMasking(noise.data(), noise.size(), true, (const uint8_t *)secret, SECRET_MAX_LEN,
+                                            it->second[0].data(), SizeToInt(it->second[0].size())) < 0) {
+        MS_LOG(ERROR) << "Get Masking failed";
+        noise_ret = false;
+      }
     }
+    if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
+      MS_LOG(EXCEPTION) << "Memset failed.";
+    }
+    if (!noise_ret) {
+      retcode = false;
+      break;
+    }
+    (void)client_noise->emplace(fl_id, std::move(noise));
+  }
+  for (auto &coefficients : lagrange_coefficients) {
+    combine.FreeBNVector(coefficients.second);
   }
 #endif
   return retcode;
@@ -326,17 +337,17 @@ bool CipherReconStruct::ReconstructSecrets(const int cur_iterator, const std::st
 
 bool CipherReconStruct::GetNoiseMasksSum(std::vector<float> *result,
                                          const std::map<std::string, std::vector<float>> &client_noise) {
-  std::vector<float> sum(cipher_init_->featuremap_, 0.0);
+  if (result == nullptr) {
+    return false;
+  }
+  size_t offset = result->size();
+  result->resize(offset + cipher_init_->featuremap_, 0.0);
+  float *sum = result->data() + offset;
   for (auto iter = client_noise.begin(); iter != client_noise.end(); iter++) {
     if (iter->second.size() != cipher_init_->featuremap_) {
       return false;
     }
-    for (size_t i = 0; i < cipher_init_->featuremap_; i++) {
-      sum[i] += iter->second[i];
-    }
-  }
-  for (size_t i = 0; i < cipher_init_->featuremap_; i++) {
-    result->push_back(sum[i]);
+    (void)ElementAdd(sum, iter->second.data(), sum, SizeToInt(cipher_init_->featuremap_));
   }
   return true;
 }
@@ -411,25 +422,13 @@ bool CipherReconStruct::GetSuvNoise(const std::vector<std::string> &clients_shar
         return false;
       }
 
-      std::vector<float> noise_tmp;
-      if (Masking::GetMasking(&noise_tmp, SizeToInt(cipher_init_->featuremap_), (const uint8_t *)secret1,
-                              SECRET_MAX_LEN, pw_iv.data(), pw_iv.size()) < 0) {
+      // The pairwise mask is expanded and added to the noise block by block.
+      bool symbol_noise = GetSymbol(fl_id, *p_key);
+      if (Masking::AccumulateMasking(noise->data(), noise->size(), !symbol_noise, (const uint8_t *)secret1,
+                                     SECRET_MAX_LEN, pw_iv.data(), SizeToInt(pw_iv.size())) < 0) {
         MS_LOG(ERROR) << "Get Masking failed\n";
         return false;
       }
-      bool symbol_noise = GetSymbol(fl_id, *p_key);
-      size_t index = 0;
-      size_t size_noise = noise_tmp.size();
-      if (symbol_noise == false) {
-        for (; index < size_noise; ++index) {
-          noise_tmp[index] = noise_tmp[index] * -1;
-          noise->at(index) += noise_tmp[index];
-        }
-      } else {
-        for (; index < size_noise; ++index) {
-          noise->at(index) += noise_tmp[index];
-        }
-      }
     }
   }
   return true;
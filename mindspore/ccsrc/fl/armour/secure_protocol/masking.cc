@@ -15,6 +15,7 @@
  */
 
 #include "fl/armour/secure_protocol/masking.h"
+#include "utils/convert_utils_base.h"
 
 namespace mindspore {
 namespace armour {
@@ -25,14 +26,31 @@ int Masking::GetMasking(std::vector<float> *noise, int noise_len, const uint8_t
   return -1;
 }
 
+int Masking::AccumulateMasking(float *sum, size_t noise_len, bool negative, const uint8_t *secret, int secret_len,
+                               const uint8_t *ivec, int ivec_size) {
+  MS_LOG(ERROR) << "Unsupported feature in Windows platform.";
+  return -1;
+}
+
 #else
 int Masking::GetMasking(std::vector<float> *noise, int noise_len, const uint8_t *secret, int secret_len,
                         const uint8_t *ivec, int ivec_size) {
+  if (noise == NULL || noise_len <= 0) {
+    MS_LOG(ERROR) << "noise is invalid!";
+    return -1;
+  }
+  size_t offset = noise->size();
+  noise->resize(offset + IntToSize(noise_len), 0);
+  return AccumulateMasking(noise->data() + offset, IntToSize(noise_len), false, secret, secret_len, ivec, ivec_size);
+}
+
+int Masking::AccumulateMasking(float *sum, size_t noise_len, bool negative, const uint8_t *secret, int secret_len,
+                               const uint8_t *ivec, int ivec_size) {
   if ((secret_len != KEY_LENGTH_16 && secret_len != KEY_LENGTH_32) || secret == NULL) {
     MS_LOG(ERROR) << "secret is invalid!";
     return -1;
   }
-  if (noise == NULL || noise_len <= 0) {
+  if (sum == NULL || noise_len == 0) {
     MS_LOG(ERROR) << "noise is invalid!";
     return -1;
   }
@@ -40,20 +58,41 @@ int Masking::GetMasking(std::vector<float> *noise, int noise_len, const uint8_t
     MS_LOG(ERROR) << "ivec is invalid!";
     return -1;
   }
-  int size = noise_len * sizeof(int);
-  std::vector<uint8_t> data(size, 0);
-  std::vector<uint8_t> encrypt_data(size, 0);
-  int encrypt_len = 0;
-  AESEncrypt encrypt(secret, secret_len, ivec, AES_IV_SIZE, AES_CTR);
-  if (encrypt.EncryptData(data.data(), size, encrypt_data.data(), &encrypt_len) != 0) {
+  EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+  if (ctx == NULL) {
+    MS_LOG(ERROR) << "new cipher ctx failed!";
+    return -1;
+  }
+  const EVP_CIPHER *cipher = secret_len == KEY_LENGTH_16 ? EVP_aes_128_ctr() : EVP_aes_256_ctr();
+  if (EVP_EncryptInit_ex(ctx, cipher, NULL, secret, ivec) != 1) {
     MS_LOG(ERROR) << "call AES-CTR failed!";
+    EVP_CIPHER_CTX_free(ctx);
     return -1;
   }
-
-  for (int i = 0; i < noise_len; i++) {
-    auto value = *(reinterpret_cast<int32_t *>(encrypt_data.data()) + i);
-    noise->emplace_back(static_cast<float>(value) / INT32_MAX);
+  // The mask is the key stream of AES-CTR, which is the same as encrypting the zeros of the whole mask at one time,
+  // because the counter goes on between the updates of the same context.
+  const std::vector<uint8_t> zeros(kMaskingBlockNum * sizeof(int32_t), 0);
+  std::vector<int32_t> values(kMaskingBlockNum, 0);
+  // Dividing by INT32_MAX as float is multiplying by 2^-31, which is exact, so the sign is folded into the scale.
+  const float scale = (negative ? -1.0f : 1.0f) / static_cast<float>(INT32_MAX);
+  for (size_t start = 0; start < noise_len; start += kMaskingBlockNum) {
+    size_t block_num = std::min(kMaskingBlockNum, noise_len - start);
+    int encrypt_len = 0;
+    if (EVP_EncryptUpdate(ctx, reinterpret_cast<uint8_t *>(values.data()), &encrypt_len, zeros.data(),
+                          SizeToInt(block_num * sizeof(int32_t))) != 1 ||
+        IntToSize(encrypt_len) != block_num * sizeof(int32_t)) {
+      MS_LOG(ERROR) << "call AES-CTR failed!";
+      EVP_CIPHER_CTX_free(ctx);
+      return -1;
+    }
+    // The plain loop of the conversion and the addition is vectorized by the compiler.
+    float *block_sum = sum + start;
+    const int32_t *block_values = values.data();
+    for (size_t i = 0; i < block_num; i++) {
+      block_sum[i] += static_cast<float>(block_values[i]) * scale;
+    }
   }
+  EVP_CIPHER_CTX_free(ctx);
   return 0;
 }
 #endif
@@ -17,17 +17,26 @@
 #ifndef MINDSPORE_ARMOUR_RANDOM_H
 #define MINDSPORE_ARMOUR_RANDOM_H
 
+#include <algorithm>
+#include <cstdint>
 #include <random>
 #include <vector>
 #include "fl/armour/secure_protocol/encrypt.h"
 
 namespace mindspore {
 namespace armour {
+// The number of the mask values expanded by AES-CTR at one time, so the key stream stays in the L1 cache.
+constexpr size_t kMaskingBlockNum = 4096;
 
 class Masking {
  public:
+  // Append the mask expanded from the secret to the noise.
   static int GetMasking(std::vector<float> *noise, int noise_len, const uint8_t *secret, int secret_len,
                         const uint8_t *ivec, int ivec_size);
+  // Add the mask expanded from the secret to the sum, or subtract it if negative is true. The mask is expanded and
+  // accumulated block by block, so the whole mask vector is not materialized for every pair of the clients.
+  static int AccumulateMasking(float *sum, size_t noise_len, bool negative, const uint8_t *secret, int secret_len,
+                               const uint8_t *ivec, int ivec_size);
 };
 }  // namespace armour
 }  // namespace mindspore
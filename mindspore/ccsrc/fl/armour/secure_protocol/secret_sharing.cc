@@ -247,6 +247,96 @@ int SecretSharing::Combine(size_t k, const std::vector<Share *> &shares, uint8_t
   FreeBNVector(nums);
   return ret;
 }
+
+int SecretSharing::GetLagrangeCoefficients(const std::vector<unsigned int> &indices,
+                                           std::vector<BIGNUM *> *coefficients) {
+  if (coefficients == nullptr || indices.empty() || this->bn_prim_ == nullptr) {
+    return -1;
+  }
+  BN_CTX *ctx = BN_CTX_new();
+  if (ctx == nullptr) {
+    MS_LOG(ERROR) << "new bn ctx failed";
+    return -1;
+  }
+  size_t k = indices.size();
+  std::vector<BIGNUM *> x(k, nullptr);
+  BIGNUM *dense = BN_new();
+  BIGNUM *num = BN_new();
+  BIGNUM *tmp = BN_new();
+  int ret = (dense == nullptr || num == nullptr || tmp == nullptr) ? -1 : 0;
+  for (size_t i = 0; i < k && ret != -1; i++) {
+    x[i] = BN_new();
+    if (x[i] == nullptr || BN_set_word(x[i], indices[i]) != 1) {
+      ret = -1;
+    }
+  }
+  // The coefficient of the share j is the product of x_m / (x_m - x_j) for all m != j.
+  for (size_t j = 0; j < k && ret != -1; j++) {
+    if (BN_one(dense) != 1 || BN_one(num) != 1) {
+      ret = -1;
+      break;
+    }
+    for (size_t m = 0; m < k && ret != -1; m++) {
+      if (m != j) {
+        ret = LagrangeCal(num, x[m], x[j], dense, tmp, ctx);
+      }
+    }
+    if (ret == -1) {
+      break;
+    }
+    BIGNUM *coefficient = BN_new();
+    if (coefficient == nullptr || BN_mod_inverse(coefficient, dense, this->bn_prim_, ctx) == nullptr ||
+        !field_mult(coefficient, coefficient, num, ctx)) {
+      ReleaseNum(coefficient);
+      ret = -1;
+      break;
+    }
+    coefficients->push_back(coefficient);
+  }
+  if (ret == -1) {
+    FreeBNVector(*coefficients);
+    coefficients->clear();
+  }
+  BN_CTX_free(ctx);
+  ReleaseNum(dense);
+  ReleaseNum(num);
+  ReleaseNum(tmp);
+  FreeBNVector(x);
+  return ret;
+}
+
+int SecretSharing::Combine(size_t k, const std::vector<Share *> &shares, const std::vector<BIGNUM *> &coefficients,
+                           uint8_t *secret, size_t *length) {
+  if (InputCheck(k, shares, secret, length) == -1 || coefficients.size() != k) {
+    return -1;
+  }
+  BN_CTX *ctx = BN_CTX_new();
+  if (ctx == nullptr) {
+    MS_LOG(ERROR) << "new bn ctx failed";
+    return -1;
+  }
+  BIGNUM *x = BN_new();
+  BIGNUM *y = BN_new();
+  BIGNUM *tmp = BN_new();
+  BIGNUM *sum = BN_new();
+  int ret = (x == nullptr || y == nullptr || tmp == nullptr) ? -1 : CheckSum(sum);
+  // The secret is the sum of y_j * coefficient_j, which needs no inversion for every secret.
+  for (size_t j = 0; j < k && ret != -1; j++) {
+    if (coefficients[j] == nullptr || !GetShare(x, y, shares[j]) || !field_mult(tmp, y, coefficients[j], ctx) ||
+        !field_add(sum, sum, tmp, ctx)) {
+      ret = -1;
+    }
+  }
+  if (ret != -1) {
+    *length = BN_bn2bin(sum, secret);
+  }
+  BN_CTX_free(ctx);
+  ReleaseNum(x);
+  ReleaseNum(y);
+  ReleaseNum(tmp);
+  ReleaseNum(sum);
+  return ret;
+}
 #endif
 }  // namespace armour
 }  // namespace mindspore
@@ -48,11 +48,18 @@ class SecretSharing {
   int Split(int n, const int k, const char *secret, size_t length, const std::vector<Share *> &shares);
   // reconstruct the secret from multiple shares
   int Combine(size_t k, const std::vector<Share *> &shares, uint8_t *secret, size_t *length);
+  // compute the lagrange coefficients at zero for the indices of the shares, which are the same for all the secrets
+  // combined from the shares of the same clients
+  int GetLagrangeCoefficients(const std::vector<unsigned int> &indices, std::vector<BIGNUM *> *coefficients);
+  // reconstruct the secret from multiple shares with the precomputed lagrange coefficients of their indices
+  int Combine(size_t k, const std::vector<Share *> &shares, const std::vector<BIGNUM *> &coefficients,
+              uint8_t *secret, size_t *length);
   int CheckShares(Share *share_i, BIGNUM *x_i, BIGNUM *y_i, BIGNUM *denses_i, BIGNUM *nums_i);
   int CheckSum(BIGNUM *sum);
   int LagrangeCal(BIGNUM *nums_j, BIGNUM *x_m, BIGNUM *x_j, BIGNUM *denses_j, BIGNUM *tmp, BN_CTX *ctx);
   int InputCheck(size_t k, const std::vector<Share *> &shares, uint8_t *secret, size_t *length);
   void ReleaseNum(BIGNUM *bigNum);
+  void FreeBNVector(std::vector<BIGNUM *> bns);
 
  private:
   BIGNUM *bn_prim_;
@@ -64,7 +71,6 @@ class SecretSharing {
   bool field_sub(BIGNUM *z, const BIGNUM *x, const BIGNUM *y, BN_CTX *ctx);
   // convert secret sharing from Share type to BIGNUM type
   bool GetShare(BIGNUM *x, BIGNUM *share, Share *s_share);
-  void FreeBNVector(std::vector<BIGNUM *> bns);
 };
 #endif
 
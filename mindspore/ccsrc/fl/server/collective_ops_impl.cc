@@ -15,6 +15,8 @@
  */
 
 #include "fl/server/collective_ops_impl.h"
+#include <unistd.h>
+#include <algorithm>
 
 namespace mindspore {
 namespace fl {
@@ -327,6 +329,211 @@ bool CollectiveOpsImpl::Broadcast(const void *sendbuff, void *recvbuff, size_t c
   return true;
 }
 
+template <typename T>
+bool CollectiveOpsImpl::PipelinedRingAllReduce(T *buff, size_t count, const std::vector<uint32_t> &ring_ranks) {
+  MS_ERROR_IF_NULL_W_RET_VAL(node_, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(buff, false);
+  auto iter = std::find(ring_ranks.begin(), ring_ranks.end(), rank_id_);
+  if (iter == ring_ranks.end()) {
+    MS_LOG(ERROR) << "The rank " << rank_id_ << " is not in the ring " << ring_ranks;
+    return false;
+  }
+  size_t ring_size = ring_ranks.size();
+  size_t ring_index = static_cast<size_t>(iter - ring_ranks.begin());
+  uint32_t send_to_rank = ring_ranks[(ring_index + 1) % ring_size];
+  uint32_t recv_from_rank = ring_ranks[(ring_index + ring_size - 1) % ring_size];
+  // The offsets of the parts, the rest of the data is assigned to the first parts.
+  std::vector<size_t> part_offsets(ring_size + 1, 0);
+  for (size_t i = 0; i < ring_size; i++) {
+    part_offsets[i + 1] = part_offsets[i] + count / ring_size + (i < count % ring_size ? 1 : 0);
+  }
+  size_t pipeline_count = std::max<size_t>(1, kCollectivePipelineBytes / sizeof(T));
+  MS_LOG(DEBUG) << "Pipelined Ring AllReduce count:" << count << ", ring_size:" << ring_size
+                << ", ring_index:" << ring_index << ", send_to_rank:" << send_to_rank
+                << ", recv_from_rank:" << recv_from_rank;
+
+  std::vector<uint64_t> send_req_ids;
+  for (size_t start = part_offsets[ring_index]; start < part_offsets[ring_index + 1]; start += pipeline_count) {
+    size_t size = std::min(pipeline_count, part_offsets[ring_index + 1] - start);
+    send_req_ids.push_back(node_->CollectiveSendAsync(node_role_, send_to_rank, buff + start, size * sizeof(T)));
+  }
+  // The first ring_size - 1 steps are ReduceScatter and the others are AllGather. Both receive the part after the one
+  // received in the last step, and the fully reduced part of the last ReduceScatter step is the first one to gather.
+  size_t step_num = 2 * (ring_size - 1);
+  for (size_t step = 0; step < step_num; step++) {
+    bool reduce = step < ring_size - 1;
+    size_t part = (ring_index + step_num + 1 - step) % ring_size;
+    for (size_t start = part_offsets[part]; start < part_offsets[part + 1]; start += pipeline_count) {
+      size_t size = std::min(pipeline_count, part_offsets[part + 1] - start);
+      std::shared_ptr<std::vector<unsigned char>> recv_str;
+      auto recv_req_id = node_->CollectiveReceiveAsync(node_role_, recv_from_rank, &recv_str);
+      if (!node_->CollectiveWait(recv_req_id, kCollectiveCommTimeout)) {
+        MS_LOG(ERROR) << "CollectiveWait " << recv_req_id << " failed.";
+        return false;
+      }
+      if (recv_str == nullptr || recv_str->size() != size * sizeof(T)) {
+        MS_LOG(ERROR) << "The received size of the rank " << recv_from_rank << " should be " << size * sizeof(T);
+        return false;
+      }
+      const T *recv_data = reinterpret_cast<const T *>(recv_str->data());
+      if (reduce) {
+        for (size_t j = 0; j < size; j++) {
+          buff[start + j] += recv_data[j];
+        }
+      } else {
+        int ret = memcpy_s(buff + start, (count - start) * sizeof(T), recv_data, recv_str->size());
+        if (ret != 0) {
+          MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+          return false;
+        }
+      }
+      // The chunk received in the last step is needed by no other ranks.
+      if (step + 1 < step_num) {
+        send_req_ids.push_back(node_->CollectiveSendAsync(node_role_, send_to_rank, buff + start, size * sizeof(T)));
+      }
+    }
+  }
+  for (auto send_req_id : send_req_ids) {
+    if (!node_->Wait(send_req_id, kCollectiveCommTimeout)) {
+      MS_LOG(ERROR) << "CollectiveWait " << send_req_id << " failed.";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CollectiveOpsImpl::SendToRank(uint32_t rank_id, const void *data, size_t size) {
+  auto send_req_id = node_->CollectiveSendAsync(node_role_, rank_id, data, size);
+  if (!node_->Wait(send_req_id, kCollectiveCommTimeout)) {
+    MS_LOG(ERROR) << "CollectiveWait " << send_req_id << " failed.";
+    return false;
+  }
+  return true;
+}
+
+bool CollectiveOpsImpl::ReceiveFromRank(uint32_t rank_id, void *data, size_t size) {
+  std::shared_ptr<std::vector<unsigned char>> recv_str;
+  auto recv_req_id = node_->CollectiveReceiveAsync(node_role_, rank_id, &recv_str);
+  if (!node_->CollectiveWait(recv_req_id, kCollectiveCommTimeout)) {
+    MS_LOG(ERROR) << "CollectiveWait " << recv_req_id << " failed.";
+    return false;
+  }
+  if (recv_str == nullptr || recv_str->size() != size) {
+    MS_LOG(ERROR) << "The received size of the rank " << rank_id << " should be " << size;
+    return false;
+  }
+  int ret = memcpy_s(data, size, recv_str->data(), recv_str->size());
+  if (ret != 0) {
+    MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+    return false;
+  }
+  return true;
+}
+
+bool CollectiveOpsImpl::InitSharedMemoryGroup(HierarchicalGroup *group) {
+  MS_ERROR_IF_NULL_W_RET_VAL(group, false);
+  auto local_iter = std::find(group->local_ranks.begin(), group->local_ranks.end(), rank_id_);
+  if (local_iter == group->local_ranks.end()) {
+    MS_LOG(ERROR) << "The rank " << rank_id_ << " is not in the local ranks " << group->local_ranks;
+    return false;
+  }
+  uint32_t local_rank = static_cast<uint32_t>(local_iter - group->local_ranks.begin());
+  uint32_t local_size = SizeToUint(group->local_ranks.size());
+  uint32_t leader_rank = group->local_ranks.front();
+  auto shm_group = std::make_unique<SharedMemoryGroup>(local_rank, local_size);
+
+  // The leader sends the shared memory id and its process id, then tells whether all the local ranks attached it, so
+  // that all of them succeed or fail together.
+  int32_t succeeded = 0;
+  if (local_rank == 0) {
+    bool created = shm_group->Create();
+    int32_t shm_info[] = {created ? shm_group->shm_id() : -1, static_cast<int32_t>(getpid())};
+    succeeded = created ? 1 : 0;
+    for (uint32_t i = 1; i < local_size; i++) {
+      if (!SendToRank(group->local_ranks[i], shm_info, sizeof(shm_info))) {
+        succeeded = 0;
+      }
+    }
+    for (uint32_t i = 1; i < local_size; i++) {
+      int32_t attached = 0;
+      if (!ReceiveFromRank(group->local_ranks[i], &attached, sizeof(attached)) || attached == 0) {
+        succeeded = 0;
+      }
+    }
+    for (uint32_t i = 1; i < local_size; i++) {
+      (void)SendToRank(group->local_ranks[i], &succeeded, sizeof(succeeded));
+    }
+    // The shared memory is removed after all the processes detach it.
+    shm_group->Destroy();
+  } else {
+    int32_t shm_info[] = {-1, -1};
+    int32_t attached = 0;
+    if (ReceiveFromRank(leader_rank, shm_info, sizeof(shm_info)) && shm_info[0] != -1 &&
+        shm_group->Attach(shm_info[0], shm_info[1])) {
+      attached = 1;
+    }
+    if (!SendToRank(leader_rank, &attached, sizeof(attached)) ||
+        !ReceiveFromRank(leader_rank, &succeeded, sizeof(succeeded))) {
+      succeeded = 0;
+    }
+  }
+  if (succeeded == 0) {
+    MS_LOG(ERROR) << "Initialize the shared memory of the local ranks " << group->local_ranks << " failed.";
+    return false;
+  }
+  group->shm_group = std::move(shm_group);
+  return true;
+}
+
+std::shared_ptr<HierarchicalGroup> CollectiveOpsImpl::GetHierarchicalGroup(const std::string &group_name,
+                                                                           const CommunicationGroupInfo &group_info) {
+  auto iter = hierarchical_groups_.find(group_name);
+  if (iter != hierarchical_groups_.end()) {
+    // The failure is seen by all the local ranks in the shared memory, so all of them create a new one together.
+    const auto &shm_group = iter->second->shm_group;
+    if (shm_group == nullptr || !shm_group->failed()) {
+      return iter->second;
+    }
+    MS_LOG(WARNING) << "The shared memory " << shm_group->shm_id() << " of the group " << group_name
+                    << " failed, create a new one.";
+    (void)hierarchical_groups_.erase(iter);
+  }
+
+  // Divide the ranks by the ips of the nodes in the order of the group ranks, so all the processes get the same hosts.
+  // The node whose ip is unknown is regarded as the only one on its host.
+  std::vector<std::pair<std::string, std::vector<uint32_t>>> hosts;
+  for (uint32_t global_rank : group_info.group_ranks) {
+    std::string ip = node_->GetNodeIp(node_role_, global_rank);
+    auto host_iter = std::find_if(hosts.begin(), hosts.end(), [&ip](const auto &host) { return host.first == ip; });
+    if (ip.empty() || host_iter == hosts.end()) {
+      (void)hosts.emplace_back(ip, std::vector<uint32_t>{global_rank});
+    } else {
+      host_iter->second.push_back(global_rank);
+    }
+  }
+  auto group = std::make_shared<HierarchicalGroup>();
+  for (const auto &host : hosts) {
+    group->leader_ranks.push_back(host.second.front());
+    if (std::find(host.second.begin(), host.second.end(), rank_id_) != host.second.end()) {
+      group->local_ranks = host.second;
+    }
+  }
+  if (group->local_ranks.empty()) {
+    MS_LOG(ERROR) << "The rank " << rank_id_ << " is not in the group " << group_name;
+    return nullptr;
+  }
+  // The local ranks succeed or fail together, and the messages between the leaders are the same without the shared
+  // memory, so the hosts need not agree on it.
+  if (group->local_ranks.size() > 1 && !InitSharedMemoryGroup(group.get())) {
+    MS_LOG(WARNING) << "The local ranks " << group->local_ranks << " of the group " << group_name
+                    << " fall back to the tcp ring.";
+  }
+  MS_LOG(INFO) << "The group " << group_name << " has " << group->leader_ranks.size() << " hosts, and the local ranks "
+               << "on this host are " << group->local_ranks;
+  hierarchical_groups_[group_name] = group;
+  return group;
+}
+
 template <typename T>
 bool CollectiveOpsImpl::AllReduce(const void *sendbuff, void *recvbuff, size_t count) {
   // The collective communication API does not support calling Send and Recv concurrently with multiple threads;
@@ -412,6 +619,102 @@ bool CollectiveOpsImpl::Broadcast(const void *sendbuff, void *const recvbuff, si
   return Broadcast<T>(sendbuff, recvbuff, count, root, group_info);
 }
 
+template <typename T>
+bool CollectiveOpsImpl::AllReduce(const std::string &group_name, const void *sendbuff, void *recvbuff, size_t count,
+                                  const std::shared_ptr<ps::core::AbstractNode> &node,
+                                  const CommunicationGroupInfo &group_info) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  MS_ERROR_IF_NULL_W_RET_VAL(node, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(recvbuff, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(sendbuff, false);
+
+  // Initialize collective communication parameters.
+  node_ = node;
+  node_role_ = node_->role();
+  rank_id_ = node_->rank_id();
+  rank_size_ = group_info.size;
+  if (rank_size_ == 0) {
+    MS_LOG(ERROR) << "Rank size should not be 0.";
+    return false;
+  }
+  if (sendbuff != recvbuff) {
+    int ret = memcpy_s(recvbuff, count * sizeof(T), sendbuff, count * sizeof(T));
+    if (ret != 0) {
+      MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+      return false;
+    }
+  }
+  if (rank_size_ == 1) {
+    MS_LOG(DEBUG) << "Rank size is 1. Do nothing.";
+    return true;
+  }
+
+  auto group = GetHierarchicalGroup(group_name, group_info);
+  if (group == nullptr) {
+    MS_LOG(ERROR) << "Get the hierarchical group of " << group_name << " failed.";
+    return false;
+  }
+  T *output_buff = reinterpret_cast<T *>(recvbuff);
+  InterHostAllReduce<T> inter_host_allreduce = nullptr;
+  if (group->leader_ranks.size() > 1) {
+    inter_host_allreduce = [this, &group](T *buff, size_t size) {
+      return PipelinedRingAllReduce<T>(buff, size, group->leader_ranks);
+    };
+  }
+  if (group->shm_group == nullptr) {
+    return TcpHierarchicalAllReduce<T>(output_buff, count, *group, inter_host_allreduce);
+  }
+  // The data is copied to the receive buffer already, which is used as the send buffer of the local ranks. The failed
+  // shared memory is replaced in the next AllReduce of the group.
+  if (!group->shm_group->AllReduce<T>(output_buff, output_buff, count, inter_host_allreduce)) {
+    MS_LOG(ERROR) << "AllReduce by the shared memory " << group->shm_group->shm_id() << " of the group " << group_name
+                  << " failed.";
+    return false;
+  }
+  return true;
+}
+
+template <typename T>
+bool CollectiveOpsImpl::TcpHierarchicalAllReduce(T *buff, size_t count, const HierarchicalGroup &group,
+                                                 const InterHostAllReduce<T> &inter_host_allreduce) {
+  if (group.local_ranks.size() > 1 && !PipelinedRingAllReduce<T>(buff, count, group.local_ranks)) {
+    MS_LOG(ERROR) << "AllReduce of the local ranks " << group.local_ranks << " by the tcp ring failed.";
+    return false;
+  }
+  if (inter_host_allreduce == nullptr) {
+    return true;
+  }
+
+  uint32_t leader_rank = group.local_ranks.front();
+  if (rank_id_ != leader_rank) {
+    return ReceiveFromRank(leader_rank, buff, count * sizeof(T));
+  }
+  // The data is split by the same chunks as the shared memory of the other hosts, so the messages between the leaders
+  // match.
+  size_t chunk_count = kSharedMemoryChunkBytes / sizeof(T);
+  for (size_t start = 0; start < count; start += chunk_count) {
+    if (!inter_host_allreduce(buff + start, std::min(chunk_count, count - start))) {
+      return false;
+    }
+  }
+  for (size_t i = 1; i < group.local_ranks.size(); i++) {
+    if (!SendToRank(group.local_ranks[i], buff, count * sizeof(T))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void CollectiveOpsImpl::ReleaseHierarchicalGroup(const std::string &group_name) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  (void)hierarchical_groups_.erase(group_name);
+}
+
+void CollectiveOpsImpl::ReleaseHierarchicalGroups() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  hierarchical_groups_.clear();
+}
+
 bool CollectiveOpsImpl::ReInitForScaling() {
   // If CollectiveOpsImpl is not initialized yet but the scaling event is triggered, do not throw exception.
   if (server_node_ == nullptr) {
@@ -438,6 +741,24 @@ template bool CollectiveOpsImpl::AllReduce<float>(const void *sendbuff, void *re
 template bool CollectiveOpsImpl::AllReduce<size_t>(const void *sendbuff, void *recvbuff, size_t count);
 template bool CollectiveOpsImpl::AllReduce<int>(const void *sendbuff, void *recvbuff, size_t count);
 
+template bool CollectiveOpsImpl::AllReduce<float>(const std::string &group_name, const void *sendbuff, void *recvbuff,
+                                                  size_t count, const std::shared_ptr<ps::core::AbstractNode> &node,
+                                                  const CommunicationGroupInfo &group_info);
+template bool CollectiveOpsImpl::AllReduce<uint64_t>(const std::string &group_name, const void *sendbuff,
+                                                     void *recvbuff, size_t count,
+                                                     const std::shared_ptr<ps::core::AbstractNode> &node,
+                                                     const CommunicationGroupInfo &group_info);
+template bool CollectiveOpsImpl::AllReduce<int>(const std::string &group_name, const void *sendbuff, void *recvbuff,
+                                                size_t count, const std::shared_ptr<ps::core::AbstractNode> &node,
+                                                const CommunicationGroupInfo &group_info);
+
+template bool CollectiveOpsImpl::PipelinedRingAllReduce<float>(float *buff, size_t count,
+                                                               const std::vector<uint32_t> &ring_ranks);
+template bool CollectiveOpsImpl::PipelinedRingAllReduce<uint64_t>(uint64_t *buff, size_t count,
+                                                                  const std::vector<uint32_t> &ring_ranks);
+template bool CollectiveOpsImpl::PipelinedRingAllReduce<int>(int *buff, size_t count,
+                                                             const std::vector<uint32_t> &ring_ranks);
+
 template bool CollectiveOpsImpl::AllGather<float>(const void *sendbuff, void *recvbuff, size_t send_count,
                                                   const std::shared_ptr<ps::core::AbstractNode> &node);
 template bool CollectiveOpsImpl::AllGather<uint64_t>(const void *sendbuff, void *recvbuff, size_t send_count,
@@ -26,12 +26,16 @@
 #include "ps/ps_context.h"
 #include "ps/core/server_node.h"
 #include "fl/server/common.h"
+#include "fl/server/shared_memory_group.h"
 
 namespace mindspore {
 namespace fl {
 namespace server {
 // The timeout for server collective communication in case of network jitter.
 constexpr uint32_t kCollectiveCommTimeout = 30;
+// The data between the hosts is sent by the chunks of this size, so the reduction of a chunk is overlapped with the
+// transfer of the next one.
+constexpr size_t kCollectivePipelineBytes = 256 * 1024;
 
 // The collective communication groups which are composed of multiple processes. Refer to MPI_Group.
 struct CommunicationGroupInfo {
@@ -49,9 +53,25 @@ struct CommunicationGroupInfo {
   std::map<uint32_t, uint32_t> group_to_global_ranks;
 };
 
+// The processes of a communication group are divided by the hosts for the hierarchical AllReduce.
+struct HierarchicalGroup {
+  // The global ranks of the leaders, which are the first processes of the group on the hosts.
+  std::vector<uint32_t> leader_ranks;
+
+  // The global ranks of the processes on this host, the first of which is the leader.
+  std::vector<uint32_t> local_ranks;
+
+  // The shared memory of the processes on this host, which is nullptr if this process is the only one, or if the shared
+  // memory can't be set up, for example the processes are in different ipc namespaces. In the latter case the processes
+  // on this host reduce the data by the tcp ring.
+  std::unique_ptr<SharedMemoryGroup> shm_group;
+};
+
 // CollectiveOpsImpl is the collective communication API of the server.
 // For now, it implements two AllReduce algorithms: RingAllReduce and BroadcastAllReduce. Elastic AllReduce is also
-// supported for the elastic scaling feature of the server.
+// supported for the elastic scaling feature of the server. The AllReduce within a group is hierarchical: the processes
+// on the same host reduce the data by the shared memory, and only the leaders of the hosts communicate by the
+// pipelined RingAllReduce.
 class CollectiveOpsImpl {
  public:
   static CollectiveOpsImpl &GetInstance() {
@@ -74,6 +94,18 @@ class CollectiveOpsImpl {
   bool Broadcast(const void *sendbuff, void *recvbuff, size_t count, uint32_t root,
                  const std::shared_ptr<ps::core::AbstractNode> &node, const CommunicationGroupInfo &group_info);
 
+  // Collective sum within the specified group. The group name identifies the shared memory of the processes on the
+  // same host, which is created in the first AllReduce of the group, and created again after it failed.
+  template <typename T>
+  bool AllReduce(const std::string &group_name, const void *sendbuff, void *recvbuff, size_t count,
+                 const std::shared_ptr<ps::core::AbstractNode> &node, const CommunicationGroupInfo &group_info);
+
+  // Release the shared memory of the group, which is called when the group is destroyed.
+  void ReleaseHierarchicalGroup(const std::string &group_name);
+
+  // Release the shared memory of all the groups, which is called when the collective communication is finalized.
+  void ReleaseHierarchicalGroups();
+
   // Reinitialize the ring for collective communication after scaling operations are done.
   bool ReInitForScaling();
 
@@ -106,6 +138,31 @@ class CollectiveOpsImpl {
   bool Broadcast(const void *sendbuff, void *recvbuff, size_t count, uint32_t root,
                  const CommunicationGroupInfo &group_info);
 
+  // Get the hierarchical group of the communication group, which is created for the first time. All the processes of
+  // the group should call it at the same time.
+  std::shared_ptr<HierarchicalGroup> GetHierarchicalGroup(const std::string &group_name,
+                                                          const CommunicationGroupInfo &group_info);
+
+  // Create the shared memory by the leader and attach it by the other processes on this host.
+  bool InitSharedMemoryGroup(HierarchicalGroup *group);
+
+  // Implementation of the RingAllReduce between the leaders, which is done in place. Each part of the ring is sent by
+  // the pipeline chunks, and each chunk is forwarded as soon as it is received and reduced.
+  template <typename T>
+  bool PipelinedRingAllReduce(T *buff, size_t count, const std::vector<uint32_t> &ring_ranks);
+
+  // The hierarchical AllReduce of the processes on this host without the shared memory, which is done in place. The
+  // processes reduce the data by the pipelined RingAllReduce, then the leader broadcasts the result of the hosts.
+  template <typename T>
+  bool TcpHierarchicalAllReduce(T *buff, size_t count, const HierarchicalGroup &group,
+                                const InterHostAllReduce<T> &inter_host_allreduce);
+
+  // Send the data to the rank and wait until it's done.
+  bool SendToRank(uint32_t rank_id, const void *data, size_t size);
+
+  // Receive the data of the size from the rank.
+  bool ReceiveFromRank(uint32_t rank_id, void *data, size_t size);
+
   std::shared_ptr<ps::core::ServerNode> server_node_;
   uint32_t rank_id_;
   uint32_t server_num_;
@@ -118,6 +175,9 @@ class CollectiveOpsImpl {
   std::shared_ptr<ps::core::AbstractNode> node_;
   ps::core::NodeRole node_role_;
   uint32_t rank_size_;
+
+  // The hierarchical groups of the communication groups with the group names.
+  std::map<std::string, std::shared_ptr<HierarchicalGroup>> hierarchical_groups_;
 };
 }  // namespace server
 }  // namespace fl
@@ -74,10 +74,22 @@ bool Executor::HandleModelUpdate(const std::string &param_name, const UploadData
     return true;
   }
 
-  std::mutex &mtx = parameter_mutex_[param_name];
-  std::unique_lock<std::mutex> lock(mtx);
   auto &param_aggr = param_aggrs_[param_name];
   MS_ERROR_IF_NULL_W_RET_VAL(param_aggr, false);
+  // The aggregators like FedAvg accumulate the uploaded data concurrently, so parameter_mutex_ is not locked here. The
+  // lock only serializes the copies of the uploaded data to the registered inputs, which are skipped since the data are
+  // passed as the inputs directly, and the kernel guards its own sum by the shard locks. The weight is only written by
+  // the kernel in the handler of the last count of the round.
+  if (param_aggr->SupportConcurrentLaunch()) {
+    if (!param_aggr->LaunchAggregators(upload_data)) {
+      MS_LOG(ERROR) << "Launching aggregators for parameter " << param_name << " failed.";
+      return false;
+    }
+    return true;
+  }
+
+  std::mutex &mtx = parameter_mutex_[param_name];
+  std::unique_lock<std::mutex> lock(mtx);
   if (!param_aggr->UpdateData(upload_data)) {
     MS_LOG(ERROR) << "Updating data for parameter " << param_name << " failed.";
     return false;
@@ -69,6 +69,10 @@ class AggregationKernel : public CPUKernel {
 
   virtual bool ReInitForUpdatingHyperParams(size_t) { return true; }
 
+  // Whether Launch could be called concurrently with the uploaded data of different clients as the inputs, so the data
+  // doesn't need to be copied to the registered inputs one client after another.
+  virtual bool SupportConcurrentLaunch() const { return false; }
+
   // Setter and getter of kernels parameters information.
   void set_params_info(const ParamsInfo &params_info) { params_info_ = params_info; }
   const std::vector<std::string> &input_names() { return params_info_.inputs_names(); }
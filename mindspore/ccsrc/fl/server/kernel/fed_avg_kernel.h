@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_CCSRC_FL_SERVER_KERNEL_FED_AVG_KERNEL_H_
 #define MINDSPORE_CCSRC_FL_SERVER_KERNEL_FED_AVG_KERNEL_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
@@ -29,6 +30,7 @@
 #include "fl/server/local_meta_store.h"
 #include "fl/server/kernel/aggregation_kernel.h"
 #include "fl/server/kernel/aggregation_kernel_factory.h"
+#include "fl/server/kernel/sharded_accumulator.h"
 
 namespace mindspore {
 namespace fl {
@@ -40,6 +42,9 @@ constexpr size_t kFedAvgInputsNum = 4;
 
 // Pay attention that this kernel is the distributed version of federated average, which means each server node in the
 // cluster in invalved in the aggragation process. So the DistributedCountService and CollectiveOpsImpl are called.
+
+// The weights uploaded by the clients are accumulated concurrently into the shards of ShardedAccumulator, whose sum is
+// moved to the weight before AllReduce when the count of this round is enough.
 template <typename T, typename S>
 class FedAvgKernel : public AggregationKernel {
  public:
@@ -49,7 +54,7 @@ class FedAvgKernel : public AggregationKernel {
         data_size_addr_(nullptr),
         new_weight_addr_(nullptr),
         new_data_size_addr_(nullptr),
-        participated_(false) {}
+        launch_count_(0) {}
   ~FedAvgKernel() override = default;
 
   void InitKernel(const CNodePtr &kernel_node) override {
@@ -75,12 +80,11 @@ class FedAvgKernel : public AggregationKernel {
       AnfAlgo::VisitKernelWithReturnType(AnfAlgo::GetInputNode(kernel_node, cnode_weight_idx_), 0).first;
     MS_EXCEPTION_IF_NULL(weight_node);
     name_ = cnode_name + "." + weight_node->fullname_with_scope();
-    first_cnt_handler_ = [&](std::shared_ptr<ps::core::MessageHandler>) {
-      std::unique_lock<std::mutex> lock(weight_mutex_);
-      if (!participated_) {
-        ClearWeightAndDataSize();
-      }
-    };
+    accumulator_ = std::make_unique<ShardedAccumulator<T, S>>(weight_size / sizeof(T),
+                                                             ShardedAccumulator<T, S>::DefaultShardNum());
+    // The weight and the data size are overwritten by the sums in last_cnt_handler_, even if no client uploads
+    // to this server, so nothing needs to be cleared when the first count arrives.
+    first_cnt_handler_ = [](std::shared_ptr<ps::core::MessageHandler>) {};
     last_cnt_handler_ = [&](std::shared_ptr<ps::core::MessageHandler>) {
       MS_ERROR_IF_NULL_WO_RET_VAL(weight_addr_);
       MS_ERROR_IF_NULL_WO_RET_VAL(data_size_addr_);
@@ -89,6 +93,7 @@ class FedAvgKernel : public AggregationKernel {
       T *weight_addr = reinterpret_cast<T *>(weight_addr_->addr);
       size_t weight_size = weight_addr_->size;
       S *data_size_addr = reinterpret_cast<S *>(data_size_addr_->addr);
+      data_size_addr[0] = accumulator_->Reduce(weight_addr);
       if (!CollectiveOpsImpl::GetInstance().AllReduce<T>(weight_addr, weight_addr, weight_size / sizeof(T))) {
         MS_LOG(ERROR) << "Federated average allreduce failed.";
         return;
@@ -120,45 +125,42 @@ class FedAvgKernel : public AggregationKernel {
       return false;
     }
     for (size_t i = 0; i < inputs.size(); i++) {
+      MS_ERROR_IF_NULL_W_RET_VAL(inputs[i], false);
       MS_ERROR_IF_NULL_W_RET_VAL(inputs[i]->addr, false);
     }
+    MS_ERROR_IF_NULL_W_RET_VAL(accumulator_, false);
 
-    std::unique_lock<std::mutex> lock(weight_mutex_);
-    // The weight and new_weight values should be multiplied by clients already, so we don't need to do multiplication
-    // again.
-    T *weight_addr = reinterpret_cast<T *>(inputs[0]->addr);
-    S *data_size_addr = reinterpret_cast<S *>(inputs[1]->addr);
+    // The new_weight values should be multiplied by clients already, so we don't need to do multiplication again.
     T *new_weight_addr = reinterpret_cast<T *>(inputs[2]->addr);
     S *new_data_size_addr = reinterpret_cast<S *>(inputs[3]->addr);
-    if (accum_count_ == 0) {
-      ClearWeightAndDataSize();
-    }
-
     MS_LOG(INFO) << "Iteration: " << LocalMetaStore::GetInstance().curr_iter_num() << " launching FedAvgKernel for "
-                 << name_ << " new data size is " << new_data_size_addr[0] << ", current total data size is "
-                 << data_size_addr[0];
-    for (size_t i = 0; i < inputs[2]->size / sizeof(T); i++) {
-      weight_addr[i] += new_weight_addr[i];
+                 << name_ << " new data size is " << new_data_size_addr[0];
+    if (!accumulator_->Accumulate(new_weight_addr, inputs[2]->size / sizeof(T), new_data_size_addr[0])) {
+      MS_LOG(ERROR) << "Accumulating the new weight for " << name_ << " failed.";
+      return false;
     }
-    data_size_addr[0] += new_data_size_addr[0];
-    lock.unlock();
 
-    accum_count_++;
-    participated_ = true;
+    size_t launch_count = ++launch_count_;
     return DistributedCountService::GetInstance().Count(
-      name_, std::to_string(DistributedCountService::GetInstance().local_rank()) + "_" + std::to_string(accum_count_));
+      name_, std::to_string(DistributedCountService::GetInstance().local_rank()) + "_" + std::to_string(launch_count));
   }
 
   void Reset() override {
     accum_count_ = 0;
+    launch_count_ = 0;
     done_ = false;
-    participated_ = false;
+    // Drop the sum of the round which is not done.
+    if (accumulator_ != nullptr) {
+      accumulator_->Clear();
+    }
     DistributedCountService::GetInstance().ResetCounter(name_);
     return;
   }
 
   bool IsAggregationDone() override { return done_; }
 
+  bool SupportConcurrentLaunch() const override { return true; }
+
   void SetParameterAddress(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &workspace,
                            const std::vector<AddressPtr> &outputs) {
     weight_addr_ = inputs[0];
@@ -190,25 +192,6 @@ class FedAvgKernel : public AggregationKernel {
     return;
   }
 
-  // In some cases, the Launch method is not called and the weights involved in AllReduce should be set to 0.
-  void ClearWeightAndDataSize() {
-    MS_ERROR_IF_NULL_WO_RET_VAL(weight_addr_);
-    MS_ERROR_IF_NULL_WO_RET_VAL(data_size_addr_);
-    MS_ERROR_IF_NULL_WO_RET_VAL(weight_addr_->addr);
-    MS_ERROR_IF_NULL_WO_RET_VAL(data_size_addr_->addr);
-    int ret = memset_s(weight_addr_->addr, weight_addr_->size, 0x00, weight_addr_->size);
-    if (ret != 0) {
-      MS_LOG(ERROR) << "memset_s error, errorno(" << ret << ")";
-      return;
-    }
-    ret = memset_s(data_size_addr_->addr, data_size_addr_->size, 0x00, data_size_addr_->size);
-    if (ret != 0) {
-      MS_LOG(ERROR) << "memset_s error, errorno(" << ret << ")";
-      return;
-    }
-    return;
-  }
-
   MessageCallback first_cnt_handler_;
   MessageCallback last_cnt_handler_;
 
@@ -221,11 +204,11 @@ class FedAvgKernel : public AggregationKernel {
   AddressPtr new_weight_addr_;
   AddressPtr new_data_size_addr_;
 
-  // Whether the kernel's Launch method is called.
-  bool participated_;
+  // The number of the launches in this round, which makes the ids of the counts unique.
+  std::atomic<size_t> launch_count_;
 
-  // The kernel could be called concurrently so we need lock to ensure threadsafe.
-  std::mutex weight_mutex_;
+  // The kernel could be called concurrently, so the new weights are accumulated into the sum by the shards.
+  std::unique_ptr<ShardedAccumulator<T, S>> accumulator_;
 };
 }  // namespace kernel
 }  // namespace server
@@ -0,0 +1,160 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_FL_SERVER_KERNEL_SHARDED_ACCUMULATOR_H_
+#define MINDSPORE_CCSRC_FL_SERVER_KERNEL_SHARDED_ACCUMULATOR_H_
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "nnacl/fp32/add_fp32.h"
+#include "utils/convert_utils_base.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace kernel {
+constexpr size_t kAccumAlignBytes = 64;
+// The data is accumulated chunk by chunk, and each chunk fits in the L1 cache.
+constexpr size_t kAccumChunkBytes = 16 * 1024;
+// The shards are a few times more than the threads, so the threads rarely wait for each other.
+constexpr size_t kAccumShardsPerThread = 4;
+constexpr size_t kMaxAccumShardNum = 256;
+
+// The accumulator of the uploaded data of the clients. The sum is split into the shards of the element ranges instead
+// of one buffer guarded by one mutex, so the uploads are accumulated concurrently into the only copy of the sum. Each
+// thread starts from a different shard, adds its data to the shards which are not locked by the other threads, then
+// waits for the rest. The sum is moved to the output when the round is done.
+template <typename T, typename S>
+class ShardedAccumulator {
+ public:
+  ShardedAccumulator(size_t element_num, size_t shard_num) : element_num_(element_num) {
+    // Every shard starts at the chunk boundary, so all the chunks are aligned to the cache line.
+    size_t chunk_element_num = kAccumChunkBytes / sizeof(T);
+    size_t chunk_num = std::max<size_t>(1, (element_num_ + chunk_element_num - 1) / chunk_element_num);
+    shard_num_ = std::max<size_t>(1, std::min({shard_num, kMaxAccumShardNum, chunk_num}));
+    shard_element_num_ = (chunk_num + shard_num_ - 1) / shard_num_ * chunk_element_num;
+    shard_num_ = std::max<size_t>(1, (element_num_ + shard_element_num_ - 1) / shard_element_num_);
+    buffer_.resize(element_num_ + kAccumAlignBytes / sizeof(T), 0);
+    void *base = buffer_.data();
+    size_t space = buffer_.size() * sizeof(T);
+    sum_ = reinterpret_cast<T *>(std::align(kAccumAlignBytes, element_num_ * sizeof(T), base, space));
+    shards_ = std::make_unique<Shard[]>(shard_num_);
+  }
+  ~ShardedAccumulator() = default;
+
+  // The default shard number, with which all the cores accumulate the data at the same time.
+  static size_t DefaultShardNum() {
+    return kAccumShardsPerThread * std::max<unsigned int>(1, std::thread::hardware_concurrency());
+  }
+
+  // Add the data of one client and its data size to the sum.
+  bool Accumulate(const T *data, size_t element_num, S data_size) {
+    if (data == nullptr || element_num != element_num_) {
+      MS_LOG(ERROR) << "The element number of the accumulated data should be " << element_num_ << ", but got "
+                    << element_num;
+      return false;
+    }
+    // The whole data of the client is added before the sum is reduced or cleared.
+    std::shared_lock<std::shared_mutex> round_lock(round_mutex_);
+    size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % shard_num_;
+    std::vector<size_t> locked_shards;
+    for (size_t i = 0; i < shard_num_; ++i) {
+      size_t index = (start + i) % shard_num_;
+      std::unique_lock<std::mutex> shard_lock(shards_[index].mutex, std::try_to_lock);
+      if (!shard_lock.owns_lock()) {
+        locked_shards.push_back(index);
+        continue;
+      }
+      AddShard(index, data);
+    }
+    for (size_t index : locked_shards) {
+      std::unique_lock<std::mutex> shard_lock(shards_[index].mutex);
+      AddShard(index, data);
+    }
+    std::unique_lock<std::mutex> data_size_lock(data_size_mutex_);
+    data_size_ += data_size;
+    return true;
+  }
+
+  // Move the sum to the output, and return the total data size. The sum is cleared for the next round.
+  S Reduce(T *output) {
+    MS_EXCEPTION_IF_NULL(output);
+    std::unique_lock<std::shared_mutex> round_lock(round_mutex_);
+    std::copy(sum_, sum_ + element_num_, output);
+    std::fill(sum_, sum_ + element_num_, T(0));
+    S data_size = data_size_;
+    data_size_ = 0;
+    return data_size;
+  }
+
+  // Drop the sum, for example, the one of the round which is not done.
+  void Clear() {
+    std::unique_lock<std::shared_mutex> round_lock(round_mutex_);
+    std::fill(sum_, sum_ + element_num_, T(0));
+    data_size_ = 0;
+  }
+
+  size_t shard_num() const { return shard_num_; }
+
+ private:
+  // Each shard mutex occupies its own cache line, so the ones locked by different threads are not falsely shared.
+  struct alignas(kAccumAlignBytes) Shard {
+    std::mutex mutex;
+  };
+
+  void AddShard(size_t index, const T *data) {
+    size_t start = index * shard_element_num_;
+    size_t end = std::min(element_num_, start + shard_element_num_);
+    size_t chunk_element_num = kAccumChunkBytes / sizeof(T);
+    for (size_t offset = start; offset < end; offset += chunk_element_num) {
+      Add(sum_ + offset, data + offset, std::min(chunk_element_num, end - offset));
+    }
+  }
+
+  static void Add(T *sum, const T *data, size_t size) {
+    if constexpr (std::is_same<T, float>::value) {
+      (void)ElementAdd(sum, data, sum, SizeToInt(size));
+    } else {
+      for (size_t i = 0; i < size; ++i) {
+        sum[i] += data[i];
+      }
+    }
+  }
+
+  size_t element_num_;
+  // The element number of each shard, which is a multiple of the chunk.
+  size_t shard_element_num_;
+  size_t shard_num_;
+  std::vector<T> buffer_;
+  T *sum_{nullptr};
+  std::unique_ptr<Shard[]> shards_;
+  // The accumulations share the lock, while the reduction and the clearing own it.
+  std::shared_mutex round_mutex_;
+  std::mutex data_size_mutex_;
+  S data_size_{0};
+};
+}  // namespace kernel
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_FL_SERVER_KERNEL_SHARDED_ACCUMULATOR_H_
@@ -111,6 +111,45 @@ bool ParameterAggregator::LaunchAggregators() {
   return true;
 }
 
+bool ParameterAggregator::LaunchAggregators(const std::map<std::string, Address> &new_data) {
+  for (auto &aggregator_with_params : aggregation_kernel_parameters_) {
+    KernelParams &params = aggregator_with_params.second;
+    std::shared_ptr<kernel::AggregationKernel> aggr_kernel = aggregator_with_params.first;
+    MS_ERROR_IF_NULL_W_RET_VAL(aggr_kernel, false);
+    std::vector<AddressPtr> inputs = params.inputs;
+    const std::vector<std::string> &input_names = aggr_kernel->input_names();
+    for (size_t i = 0; i < input_names.size() && i < inputs.size(); i++) {
+      auto iter = new_data.find(input_names[i]);
+      if (iter == new_data.end()) {
+        continue;
+      }
+      MS_ERROR_IF_NULL_W_RET_VAL(inputs[i], false);
+      MS_ERROR_IF_NULL_W_RET_VAL(iter->second.addr, false);
+      if (iter->second.size != inputs[i]->size) {
+        MS_LOG(ERROR) << "The size of " << input_names[i] << " should be " << inputs[i]->size << ", but got "
+                      << iter->second.size;
+        return false;
+      }
+      inputs[i] = std::make_shared<Address>(iter->second);
+    }
+    bool ret = aggr_kernel->Launch(inputs, params.workspace, params.outputs);
+    if (!ret) {
+      MS_LOG(ERROR) << "Launching aggregation kernel " << typeid(aggr_kernel.get()).name() << " failed.";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ParameterAggregator::SupportConcurrentLaunch() const {
+  return !aggregation_kernel_parameters_.empty() &&
+         std::all_of(aggregation_kernel_parameters_.begin(), aggregation_kernel_parameters_.end(),
+                     [](const auto &aggregator_with_params) {
+                       return aggregator_with_params.first != nullptr &&
+                              aggregator_with_params.first->SupportConcurrentLaunch();
+                     });
+}
+
 AddressPtr ParameterAggregator::GetWeight() {
   if (memory_register_ == nullptr) {
     MS_LOG(ERROR)
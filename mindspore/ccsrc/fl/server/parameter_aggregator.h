@@ -78,6 +78,13 @@ class ParameterAggregator {
   // Launch aggregators/optimizers of this ParameterAggregator in order.
   bool LaunchAggregators();
 
+  // Launch aggregators with the new data as their inputs instead of the registered ones. It's called without the lock
+  // of the parameter if all the aggregators support concurrent launch. Unlike UpdateData, which copies the smaller data
+  // to the front of the input and keeps the rest, the new data whose size differs from the input's is rejected, since
+  // the kernel would read the data by the size of the input.
+  bool LaunchAggregators(const std::map<std::string, Address> &new_data);
+  bool SupportConcurrentLaunch() const;
+
   // Different from the method Pull, this method simply returns the weight of this ParameterAggregator without causing
   // any change of status.
   AddressPtr GetWeight();
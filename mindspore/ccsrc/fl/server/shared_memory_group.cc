@@ -0,0 +1,135 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fl/server/shared_memory_group.h"
+#include <sys/shm.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <new>
+#include <thread>
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace {
+// The number of the polls before yielding the cpu, the waits on this host are usually short.
+constexpr size_t kSpinCount = 1024;
+}  // namespace
+
+SharedMemoryGroup::~SharedMemoryGroup() {
+  if (base_ != nullptr && shmdt(base_) == -1) {
+    MS_LOG(ERROR) << "Detach the shared memory " << shm_id_ << " failed. Errno " << errno;
+  }
+  base_ = nullptr;
+  header_ = nullptr;
+}
+
+bool SharedMemoryGroup::Create() {
+  if (local_size_ == 0 || local_rank_ >= local_size_ || chunk_bytes_ == 0) {
+    MS_LOG(ERROR) << "The local rank " << local_rank_ << " or local size " << local_size_ << " is invalid.";
+    return false;
+  }
+  auto access_mode = S_IRUSR | S_IWUSR;
+  shm_id_ = shmget(IPC_PRIVATE, MemorySize(), IPC_CREAT | IPC_EXCL | access_mode);
+  if (shm_id_ == -1) {
+    MS_LOG(ERROR) << "Create the shared memory of size " << MemorySize() << " failed. Errno " << errno;
+    return false;
+  }
+  void *addr = shmat(shm_id_, nullptr, 0);
+  if (addr == reinterpret_cast<void *>(-1)) {
+    MS_LOG(ERROR) << "Attach the shared memory " << shm_id_ << " failed. Errno " << errno;
+    Destroy();
+    return false;
+  }
+  base_ = reinterpret_cast<uint8_t *>(addr);
+  header_ = new (base_) SharedMemoryHeader();
+  return true;
+}
+
+bool SharedMemoryGroup::Attach(int shm_id, int creator_pid) {
+  if (local_size_ == 0 || local_rank_ >= local_size_ || chunk_bytes_ == 0) {
+    MS_LOG(ERROR) << "The local rank " << local_rank_ << " or local size " << local_size_ << " is invalid.";
+    return false;
+  }
+  struct shmid_ds shm_info = {};
+  if (shmctl(shm_id, IPC_STAT, &shm_info) == -1) {
+    MS_LOG(ERROR) << "Get the status of the shared memory " << shm_id << " failed. Errno " << errno;
+    return false;
+  }
+  // The segment created by another process or for another group is not attached.
+  if (shm_info.shm_cpid != creator_pid || shm_info.shm_segsz != MemorySize()) {
+    MS_LOG(ERROR) << "The shared memory " << shm_id << " of size " << shm_info.shm_segsz << " is created by process "
+                  << shm_info.shm_cpid << ", but expect size " << MemorySize() << " and process " << creator_pid;
+    return false;
+  }
+  void *addr = shmat(shm_id, nullptr, 0);
+  if (addr == reinterpret_cast<void *>(-1)) {
+    MS_LOG(ERROR) << "Attach the shared memory " << shm_id << " failed. Errno " << errno;
+    return false;
+  }
+  shm_id_ = shm_id;
+  base_ = reinterpret_cast<uint8_t *>(addr);
+  header_ = reinterpret_cast<SharedMemoryHeader *>(base_);
+  return true;
+}
+
+void SharedMemoryGroup::Destroy() const {
+  if (shm_id_ != -1 && shmctl(shm_id_, IPC_RMID, nullptr) == -1) {
+    MS_LOG(ERROR) << "Remove the shared memory " << shm_id_ << " failed. Errno " << errno
+                  << ". Please remove it manually using ipcrm -m command.";
+  }
+}
+
+bool SharedMemoryGroup::Barrier() {
+  uint32_t generation = header_->barrier_generation.load(std::memory_order_acquire);
+  if (header_->barrier_count.fetch_add(1, std::memory_order_acq_rel) + 1 == local_size_) {
+    header_->barrier_count.store(0, std::memory_order_relaxed);
+    (void)header_->barrier_generation.fetch_add(1, std::memory_order_release);
+    return true;
+  }
+  return WaitUntil(
+    [this, generation]() { return header_->barrier_generation.load(std::memory_order_acquire) != generation; });
+}
+
+bool SharedMemoryGroup::WaitUntil(const std::function<bool()> &condition) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(kSharedMemoryTimeout);
+  size_t count = 0;
+  while (!condition()) {
+    if (header_->failed.load(std::memory_order_acquire) != 0) {
+      MS_LOG(ERROR) << "The other process of the shared memory " << shm_id_ << " failed.";
+      return false;
+    }
+    if (++count < kSpinCount) {
+      continue;
+    }
+    if (std::chrono::steady_clock::now() > deadline) {
+      MS_LOG(ERROR) << "Waiting for the other processes of the shared memory " << shm_id_ << " timeout.";
+      Fail();
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+void SharedMemoryGroup::Fail() const {
+  if (header_ != nullptr) {
+    header_->failed.store(1, std::memory_order_release);
+  }
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,203 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_FL_SERVER_SHARED_MEMORY_GROUP_H_
+#define MINDSPORE_CCSRC_FL_SERVER_SHARED_MEMORY_GROUP_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include "securec/include/securec.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+// The data is reduced in the shared memory chunk by chunk. The chunks are double buffered, so the reduction of a chunk
+// on this host is overlapped with the transfer of the previous chunk between the hosts.
+constexpr size_t kSharedMemoryChunkBytes = 2 * 1024 * 1024;
+constexpr size_t kSharedMemoryBufferNum = 2;
+constexpr size_t kSharedMemoryHeaderBytes = 64;
+// The timeout in seconds of waiting for the other processes on this host.
+constexpr uint32_t kSharedMemoryTimeout = 30;
+
+// The allreduce between the hosts on the partial sum of a chunk, which is done in place.
+template <typename T>
+using InterHostAllReduce = std::function<bool(T *, size_t)>;
+
+// The control block at the beginning of the shared memory.
+struct alignas(kSharedMemoryHeaderBytes) SharedMemoryHeader {
+  std::atomic<uint32_t> barrier_count{0};
+  std::atomic<uint32_t> barrier_generation{0};
+  // The number of the chunks whose results are ready to be copied out, which increases through all the allreduces.
+  std::atomic<uint64_t> done_chunk_num{0};
+  // Set by any process failed, so that the others stop waiting for it.
+  std::atomic<uint32_t> failed{0};
+};
+
+// SharedMemoryGroup is the communication group of the processes on the same host, which exchange the data by the
+// shared memory instead of the tcp connections. The shared memory is created by the leader, which is local rank 0, and
+// attached by the other local ranks with the id sent by the leader.
+class SharedMemoryGroup {
+ public:
+  SharedMemoryGroup(uint32_t local_rank, uint32_t local_size, size_t chunk_bytes = kSharedMemoryChunkBytes)
+      : local_rank_(local_rank), local_size_(local_size), chunk_bytes_(chunk_bytes) {}
+  ~SharedMemoryGroup();
+
+  // Create and attach the shared memory, which is called by the leader.
+  bool Create();
+
+  // Attach the shared memory created by the leader, whose process id is checked in case that the id is of another host.
+  bool Attach(int shm_id, int creator_pid);
+
+  // Mark the shared memory to be removed after all the processes detach it, which is called by the leader after all
+  // the local ranks attached it, so the shared memory is not leaked even if the processes crash.
+  void Destroy() const;
+
+  // AllReduce the data of the local ranks. The local ranks copy the chunk to their slots, then each of them sums a part
+  // of the slots to the result. The leader allreduces the result with the other hosts by 'inter_host_allreduce', which
+  // should be given by all the local ranks if there are other hosts, and nullptr otherwise.
+  template <typename T>
+  bool AllReduce(const T *sendbuff, T *recvbuff, size_t count, const InterHostAllReduce<T> &inter_host_allreduce);
+
+  // Whether any local rank failed. The failed shared memory can't be used anymore, because the local ranks may stop at
+  // different chunks, so a new one should be created.
+  bool failed() const { return header_ != nullptr && header_->failed.load(std::memory_order_acquire) != 0; }
+
+  int shm_id() const { return shm_id_; }
+  uint32_t local_rank() const { return local_rank_; }
+  uint32_t local_size() const { return local_size_; }
+
+ private:
+  size_t MemorySize() const {
+    return kSharedMemoryHeaderBytes + kSharedMemoryBufferNum * (local_size_ + 1) * chunk_bytes_;
+  }
+
+  // The slot of the local rank in the buffer, the slot after the ones of the local ranks stores the result.
+  void *Slot(size_t buffer_index, uint32_t local_rank) const {
+    return base_ + kSharedMemoryHeaderBytes + (buffer_index * (local_size_ + 1) + local_rank) * chunk_bytes_;
+  }
+
+  // Wait until all the local ranks arrive.
+  bool Barrier();
+
+  // Wait until the condition is satisfied, return false if it is timeout or any local rank failed.
+  bool WaitUntil(const std::function<bool()> &condition);
+
+  // Notify the other local ranks that this process failed.
+  void Fail() const;
+
+  uint32_t local_rank_;
+  uint32_t local_size_;
+  size_t chunk_bytes_;
+  int shm_id_{-1};
+  uint8_t *base_{nullptr};
+  SharedMemoryHeader *header_{nullptr};
+  // The number of the chunks reduced by this group, which is the same in all the local ranks.
+  uint64_t chunk_seq_{0};
+};
+
+template <typename T>
+bool SharedMemoryGroup::AllReduce(const T *sendbuff, T *recvbuff, size_t count,
+                                  const InterHostAllReduce<T> &inter_host_allreduce) {
+  MS_ERROR_IF_NULL_W_RET_VAL(header_, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(sendbuff, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(recvbuff, false);
+  size_t chunk_count = chunk_bytes_ / sizeof(T);
+  size_t chunk_num = (count + chunk_count - 1) / chunk_count;
+  bool is_leader = local_rank_ == 0;
+  std::future<bool> transfer;
+
+  // The chunk i is reduced in the shared memory at the iteration i, and copied out at the iteration i + 1 after the
+  // leader finishes transferring it, meanwhile the chunk i + 1 is being reduced in the other buffer.
+  for (size_t i = 0; i <= chunk_num; ++i) {
+    size_t buffer_index = (chunk_seq_ + i) % kSharedMemoryBufferNum;
+    size_t offset = i * chunk_count;
+    if (i < chunk_num) {
+      size_t size = std::min(chunk_count, count - offset);
+      int ret = memcpy_s(Slot(buffer_index, local_rank_), chunk_bytes_, sendbuff + offset, size * sizeof(T));
+      if (ret != 0) {
+        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+        Fail();
+        return false;
+      }
+      if (!Barrier()) {
+        return false;
+      }
+
+      size_t part_start = size * local_rank_ / local_size_;
+      size_t part_end = size * (local_rank_ + 1) / local_size_;
+      T *result = reinterpret_cast<T *>(Slot(buffer_index, local_size_));
+      const T *first = reinterpret_cast<const T *>(Slot(buffer_index, 0));
+      std::copy(first + part_start, first + part_end, result + part_start);
+      for (uint32_t rank = 1; rank < local_size_; ++rank) {
+        const T *slot = reinterpret_cast<const T *>(Slot(buffer_index, rank));
+        for (size_t j = part_start; j < part_end; ++j) {
+          result[j] += slot[j];
+        }
+      }
+      if (!Barrier()) {
+        return false;
+      }
+    }
+
+    if (is_leader) {
+      // The chunks are transferred one by one, so the messages between the leaders are in order.
+      if (inter_host_allreduce != nullptr && i > 0 && !transfer.get()) {
+        MS_LOG(ERROR) << "AllReduce the chunk between the hosts failed.";
+        Fail();
+        return false;
+      }
+      if (i > 0) {
+        header_->done_chunk_num.store(chunk_seq_ + i, std::memory_order_release);
+      }
+      if (inter_host_allreduce != nullptr && i < chunk_num) {
+        T *result = reinterpret_cast<T *>(Slot(buffer_index, local_size_));
+        size_t size = std::min(chunk_count, count - offset);
+        transfer = std::async(std::launch::async, [&inter_host_allreduce, result, size]() {
+          return inter_host_allreduce(result, size);
+        });
+      }
+    }
+
+    if (i > 0) {
+      uint64_t done_chunk_num = chunk_seq_ + i;
+      if (!WaitUntil([this, done_chunk_num]() {
+            return header_->done_chunk_num.load(std::memory_order_acquire) >= done_chunk_num;
+          })) {
+        return false;
+      }
+      size_t last_buffer_index = (chunk_seq_ + i - 1) % kSharedMemoryBufferNum;
+      size_t last_offset = offset - chunk_count;
+      size_t last_size = std::min(chunk_count, count - last_offset);
+      int ret = memcpy_s(recvbuff + last_offset, (count - last_offset) * sizeof(T),
+                         Slot(last_buffer_index, local_size_), last_size * sizeof(T));
+      if (ret != 0) {
+        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+        Fail();
+        return false;
+      }
+    }
+  }
+  chunk_seq_ += chunk_num;
+  return true;
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_FL_SERVER_SHARED_MEMORY_GROUP_H_
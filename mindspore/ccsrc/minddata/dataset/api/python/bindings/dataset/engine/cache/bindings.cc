@@ -25,7 +25,8 @@ PYBIND_REGISTER(CacheClient, 0, ([](const py::module *m) {
                   (void)py::class_<CacheClient, std::shared_ptr<CacheClient>>(*m, "CacheClient")
                     .def(py::init([](session_id_type id, uint64_t mem_sz, bool spill,
                                      std::optional<std::string> hostname, std::optional<int32_t> port,
-                                     std::optional<int32_t> num_connections, std::optional<int32_t> prefetch_sz) {
+                                     std::optional<int32_t> num_connections, std::optional<int32_t> prefetch_sz,
+                                     std::optional<int32_t> tier_policy, std::optional<int32_t> compression) {
                       std::shared_ptr<CacheClient> cc;
                       CacheClient::Builder builder;
                       builder.SetSessionId(id).SetCacheMemSz(mem_sz).SetSpill(spill);
@@ -33,6 +34,8 @@ PYBIND_REGISTER(CacheClient, 0, ([](const py::module *m) {
                       if (port) builder.SetPort(port.value());
                       if (num_connections) builder.SetNumConnections(num_connections.value());
                       if (prefetch_sz) builder.SetPrefetchSize(prefetch_sz.value());
+                      if (tier_policy) builder.SetTierPolicy(static_cast<CacheTierPolicyType>(tier_policy.value()));
+                      if (compression) builder.SetCompression(static_cast<CacheCompressionType>(compression.value()));
                       THROW_IF_ERROR(builder.Build(&cc));
                       return cc;
                     }))
@@ -45,7 +48,16 @@ PYBIND_REGISTER(CacheClient, 0, ([](const py::module *m) {
                     .def(py::init<>())
                     .def_readwrite("avg_cache_sz", &CacheServiceStat::avg_cache_sz)
                     .def_readwrite("num_mem_cached", &CacheServiceStat::num_mem_cached)
-                    .def_readwrite("num_disk_cached", &CacheServiceStat::num_disk_cached);
+                    .def_readwrite("num_disk_cached", &CacheServiceStat::num_disk_cached)
+                    .def_readwrite("num_mem_hit", &CacheServiceStat::num_mem_hit)
+                    .def_readwrite("num_disk_hit", &CacheServiceStat::num_disk_hit)
+                    .def_readwrite("num_miss", &CacheServiceStat::num_miss)
+                    .def_readwrite("num_promoted", &CacheServiceStat::num_promoted)
+                    .def_readwrite("num_evicted", &CacheServiceStat::num_evicted)
+                    .def_readwrite("num_raw_bytes", &CacheServiceStat::num_raw_bytes)
+                    .def_readwrite("num_stored_bytes", &CacheServiceStat::num_stored_bytes)
+                    .def_readwrite("compress_time_us", &CacheServiceStat::compress_time_us)
+                    .def_readwrite("decompress_time_us", &CacheServiceStat::decompress_time_us);
                 }));
 
 }  // namespace dataset
@@ -162,6 +162,31 @@ Status Tensor::CreateFromMemory(const TensorShape &shape, const DataType &type,
   return Status::OK();
 }
 
+Status Tensor::CreateFromMemoryPool(const TensorShape &shape, const DataType &type, uchar *src, const dsize_t &length,
+                                    const std::shared_ptr<MemoryPool> &pool, TensorPtr *out) {
+  RETURN_UNEXPECTED_IF_NULL(src);
+  RETURN_UNEXPECTED_IF_NULL(pool);
+  RETURN_UNEXPECTED_IF_NULL(out);
+  const TensorAlloc *alloc = GlobalContext::Instance()->tensor_allocator();
+  *out = std::allocate_shared<Tensor>(*alloc, shape, type);
+  CHECK_FAIL_RETURN_UNEXPECTED(*out != nullptr, "Allocate memory failed.");
+  if (type.IsNumeric()) {
+    dsize_t calculated_length = (*out)->SizeInBytes();
+    CHECK_FAIL_RETURN_UNEXPECTED(calculated_length == length, "Length of source data does not match the shape.");
+  } else {
+    dsize_t min_length = (shape.NumOfElements() + 1) * kOffsetSize + shape.NumOfElements();
+    CHECK_FAIL_RETURN_UNEXPECTED(min_length <= length, "Length of source data does not match the shape.");
+  }
+  if (length == 0) {
+    return Status::OK();
+  }
+  // Take over the memory from the pool rather than allocating from the global one.
+  (*out)->data_allocator_ = std::make_unique<Allocator<unsigned char>>(pool);
+  (*out)->data_ = src;
+  (*out)->data_end_ = src + length;
+  return Status::OK();
+}
+
 #ifdef ENABLE_PYTHON
 Status Tensor::CreateFromNpString(py::array arr, std::shared_ptr<Tensor> *out) {
   RETURN_UNEXPECTED_IF_NULL(out);
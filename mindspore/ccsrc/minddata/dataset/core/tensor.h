@@ -109,6 +109,18 @@ class Tensor {
   static Status CreateFromMemory(const TensorShape &shape, const DataType &type, const uchar *src,
                                  const dsize_t &length, TensorPtr *out);
 
+  /// Create a tensor which refers to the memory of a pool instead of copying it. The memory is given back to the pool
+  /// when the tensor is destroyed.
+  /// \param[in] shape shape of the output tensor
+  /// \param[in] type type of the output tensor
+  /// \param[in] src pointer to the source data, which is owned by the pool
+  /// \param[in] length length of the src data
+  /// \param[in] pool memory pool that owns the src data
+  /// \param[out] out Generated tensor
+  /// \return Status code
+  static Status CreateFromMemoryPool(const TensorShape &shape, const DataType &type, uchar *src, const dsize_t &length,
+                                     const std::shared_ptr<MemoryPool> &pool, TensorPtr *out);
+
   /// Create a copy of the input tensor
   /// \param[in] in original tensor to be copied
   /// \param[out] out output tensor to be generated
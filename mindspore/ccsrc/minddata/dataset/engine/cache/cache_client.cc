@@ -23,8 +23,65 @@
 
 namespace mindspore {
 namespace dataset {
+namespace {
+/// A BatchFetch reply in the shared memory of the client, which the restored tensors refer to.
+class SharedReplyBlock : public MemoryPool {
+ public:
+  SharedReplyBlock(std::shared_ptr<CacheClientGreeter> comm, connection_id_type connection_id, int32_t client_id,
+                   int64_t addr)
+      : comm_(std::move(comm)), connection_id_(connection_id), client_id_(client_id), addr_(addr) {}
+
+  ~SharedReplyBlock() override {
+    // We hold the comm layer so the shared memory is still attached. But the request can't be sent once the
+    // CacheClient has stopped the comm layer, and the block then stays with the server until it shuts down.
+    if (comm_->ServiceState() != Service::STATE::kRunning) {
+      MS_LOG(INFO) << "Comm layer is stopped. Shared memory block " << addr_ << " is not freed.";
+      return;
+    }
+    try {
+      auto rq = std::make_shared<FreeSharedBlockRequest>(connection_id_, client_id_, addr_);
+      // We won't wait for the result for the sake of performance.
+      Status rc = comm_->HandleRequest(rq);
+      if (rc.IsError()) {
+        MS_LOG(WARNING) << "Failed to free shared memory block " << addr_ << ". " << rc;
+      }
+    } catch (const std::exception &e) {
+      // Can't do anything in destructor. So just log the error.
+      MS_LOG(ERROR) << e.what();
+    }
+  }
+
+  Status Allocate(size_t, void **) override { RETURN_STATUS_UNEXPECTED("Can't allocate from a shared reply block"); }
+
+  Status Reallocate(void **, size_t, size_t) override {
+    RETURN_STATUS_UNEXPECTED("Can't reallocate from a shared reply block");
+  }
+
+  // The tensors give back their memory one by one, but the block is freed as a whole when the pool is destroyed.
+  void Deallocate(void *) override {}
+
+  uint64_t get_max_size() const override { return 0; }
+
+  int PercentFree() const override { return 0; }
+
+ private:
+  std::shared_ptr<CacheClientGreeter> comm_;
+  connection_id_type connection_id_;
+  int32_t client_id_;
+  int64_t addr_;
+};
+}  // namespace
+
 CacheClient::Builder::Builder()
-    : session_id_(0), cache_mem_sz_(0), spill_(false), hostname_(""), port_(0), num_connections_(0), prefetch_size_(0) {
+    : session_id_(0),
+      cache_mem_sz_(0),
+      spill_(false),
+      tier_policy_(CacheTierPolicyType::kNone),
+      compression_(CacheCompressionType::kNone),
+      hostname_(""),
+      port_(0),
+      num_connections_(0),
+      prefetch_size_(0) {
   std::shared_ptr<ConfigManager> cfg = GlobalContext::config_manager();
   hostname_ = cfg->cache_host();
   port_ = cfg->cache_port();
@@ -36,7 +93,7 @@ Status CacheClient::Builder::Build(std::shared_ptr<CacheClient> *out) {
   RETURN_UNEXPECTED_IF_NULL(out);
   RETURN_IF_NOT_OK(SanityCheck());
   *out = std::make_shared<CacheClient>(session_id_, cache_mem_sz_, spill_, hostname_, port_, num_connections_,
-                                       prefetch_size_);
+                                       prefetch_size_, tier_policy_, compression_);
   return Status::OK();
 }
 
@@ -50,14 +107,24 @@ Status CacheClient::Builder::SanityCheck() {
   CHECK_FAIL_RETURN_SYNTAX_ERROR(port_ <= kMaxLegalPort, "Port must be in range (1025..65535).");
   CHECK_FAIL_RETURN_SYNTAX_ERROR(hostname_ == "127.0.0.1",
                                  "now cache client has to be on the same host with cache server.");
+  CHECK_FAIL_RETURN_SYNTAX_ERROR(
+    tier_policy_ >= CacheTierPolicyType::kNone && tier_policy_ <= CacheTierPolicyType::kTinyLfu,
+    "tier policy must be one of none, lru, lfu and tinylfu.");
+  CHECK_FAIL_RETURN_SYNTAX_ERROR(
+    compression_ == CacheCompressionType::kNone || compression_ == CacheCompressionType::kDeflate,
+    "compression must be one of none and deflate.");
   return Status::OK();
 }
 
 // Constructor
 CacheClient::CacheClient(session_id_type session_id, uint64_t cache_mem_sz, bool spill, std::string hostname,
-                         int32_t port, int32_t num_connections, int32_t prefetch_size)
+                         int32_t port, int32_t num_connections, int32_t prefetch_size,
+                         CacheTierPolicyType tier_policy, CacheCompressionType compression)
     : cache_mem_sz_(cache_mem_sz),
       spill_(spill),
+      tier_policy_(tier_policy),
+      compression_(compression),
+      decompress_time_us_(0),
       server_connection_id_(0),
       client_id_(-1),
       local_bypass_(false),
@@ -75,6 +142,10 @@ CacheClient::~CacheClient() {
     Status rc = async_buffer_stream_->ReleaseBuffer();
     if (rc.IsError()) MS_LOG(ERROR) << rc;
   }
+  // The server gives back the memory of the ring once it sees the ring is closed.
+  if (fetch_ring_) {
+    fetch_ring_->Close();
+  }
   if (client_id_ != -1) {
     try {
       // Send a message to the server, saying I am done.
@@ -127,21 +198,51 @@ Status CacheClient::AsyncWriteRow(const TensorRow &row) {
 
 Status CacheClient::GetRows(const std::vector<row_id_type> &row_id, TensorTable *out) const {
   RETURN_UNEXPECTED_IF_NULL(out);
+  // A local client posts the rows to the fetch ring first. Anything the ring can't serve goes through gRPC, which
+  // also reports the error if there is any.
+  int32_t slot = -1;
+  if (fetch_ring_ && fetch_ring_->Submit(row_id, &slot)) {
+    int64_t addr = -1;
+    uint32_t flag = 0;
+    Status rc = fetch_ring_->Wait(slot, &addr, &flag);
+    if (rc.IsOk()) {
+      auto block = CreateSharedReplyBlock(addr);
+      auto ptr = reinterpret_cast<const char *>(reinterpret_cast<int64_t>(SharedMemoryBaseAddr()) + addr);
+      return BatchFetchRequest::RestoreRows(this, row_id, ptr, BitTest(flag, kDataIsCompressed), block, out);
+    }
+    MS_LOG(DEBUG) << "Fetch the rows through gRPC instead. " << rc;
+  }
   auto rq = std::make_shared<BatchFetchRequest>(this, row_id);
   RETURN_IF_NOT_OK(PushRequest(rq));
   RETURN_IF_NOT_OK(rq->Wait());
-  int64_t mem_addr;
-  Status rc = rq->RestoreRows(out, comm_->SharedMemoryBaseAddr(), &mem_addr);
-  // Free the memory by sending a request back to the server.
-  if (mem_addr != -1) {
-    auto mfree_req = std::make_shared<FreeSharedBlockRequest>(server_connection_id_, client_id_, mem_addr);
-    Status rc2 = PushRequest(mfree_req);
-    // But we won't wait for the result for the sake of performance.
-    if (rc.IsOk() && rc2.IsError()) {
-      rc = rc2;
-    }
+  return rq->RestoreRows(out);
+}
+
+std::shared_ptr<MemoryPool> CacheClient::CreateSharedReplyBlock(int64_t addr) const {
+  return std::make_shared<SharedReplyBlock>(comm_, server_connection_id_, client_id_, addr);
+}
+
+Status CacheClient::InitFetchRing() {
+  auto mem_rq =
+    std::make_shared<AllocateSharedBlockRequest>(server_connection_id_, client_id_, CacheFetchRing::MemorySize());
+  RETURN_IF_NOT_OK(PushRequest(mem_rq));
+  RETURN_IF_NOT_OK(mem_rq->Wait());
+  auto addr = mem_rq->GetAddr();
+  auto *base = reinterpret_cast<void *>(reinterpret_cast<int64_t>(SharedMemoryBaseAddr()) + addr);
+  auto ring = std::make_unique<CacheFetchRing>(base);
+  ring->Init();
+  auto rq = std::make_shared<RegisterFetchRingRequest>(server_connection_id_, client_id_, addr);
+  Status rc = PushRequest(rq);
+  if (rc.IsOk()) {
+    rc = rq->Wait();
+  }
+  if (rc.IsError()) {
+    auto mfree_req = std::make_shared<FreeSharedBlockRequest>(server_connection_id_, client_id_, addr);
+    (void)PushRequest(mfree_req);
+    return rc;
   }
-  return rc;
+  fetch_ring_ = std::move(ring);
+  return Status::OK();
 }
 
 Status CacheClient::CreateCache(uint32_t tree_crc, bool generate_id) {
@@ -199,7 +300,8 @@ Status CacheClient::CreateCache(uint32_t tree_crc, bool generate_id) {
     // Start the comm layer to receive reply
     RETURN_IF_NOT_OK(comm_->ServiceStart());
     // Initiate connection
-    auto rq = std::make_shared<CreateCacheRequest>(this, cinfo_, cache_mem_sz_, createFlag);
+    auto rq = std::make_shared<CreateCacheRequest>(this, cinfo_, cache_mem_sz_, createFlag, tier_policy_,
+                                                   compression_);
     RETURN_IF_NOT_OK(PushRequest(rq));
     Status rc = rq->Wait();
     bool success = (rc.IsOk() || rc.StatusCode() == StatusCode::kMDDuplicateKey);
@@ -214,6 +316,11 @@ Status CacheClient::CreateCache(uint32_t tree_crc, bool generate_id) {
       if (local_bypass_) {
         async_buffer_stream_ = std::make_shared<AsyncBufferStream>();
         RETURN_IF_NOT_OK(async_buffer_stream_->Init(this));
+        // The fetch ring only saves the gRPC round trips, so carry on without it if the server can't take it.
+        Status ring_rc = InitFetchRing();
+        if (ring_rc.IsError()) {
+          MS_LOG(WARNING) << "Fetch ring is not available. Rows are fetched through gRPC. " << ring_rc;
+        }
       }
     }
     // We are not resetting the Duplicate key return code. We are passing it back to the CacheOp. This will tell the
@@ -241,6 +348,7 @@ Status CacheClient::GetStat(CacheServiceStat *stat) {
   RETURN_IF_NOT_OK(PushRequest(rq));
   RETURN_IF_NOT_OK(rq->Wait());
   rq->GetStat(stat);
+  stat->decompress_time_us = decompress_time_us_;
   return Status::OK();
 }
 
@@ -274,6 +382,19 @@ Status CacheClient::FetchSchema(std::unordered_map<std::string, int32_t> *map) {
   return Status::OK();
 }
 
+Status CacheClient::GetCompressionDict(std::string *out) const {
+  RETURN_UNEXPECTED_IF_NULL(out);
+  std::unique_lock<std::mutex> lck(dict_mux_);
+  if (compression_dict_.empty()) {
+    auto rq = std::make_shared<FetchCompressionDictRequest>(server_connection_id_);
+    RETURN_IF_NOT_OK(PushRequest(rq));
+    RETURN_IF_NOT_OK(rq->Wait());
+    compression_dict_ = rq->GetDictionary();
+  }
+  *out = compression_dict_;
+  return Status::OK();
+}
+
 Status CacheClient::BuildPhaseDone() const {
   SharedLock lck(&mux_);
   auto rq = std::make_shared<BuildPhaseDoneRequest>(server_connection_id_, cookie());
@@ -29,6 +29,7 @@
 #include <vector>
 
 #include "minddata/dataset/core/config_manager.h"
+#include "minddata/dataset/engine/cache/cache_fetch_ring.h"
 #ifdef ENABLE_CACHE
 #include "minddata/dataset/engine/cache/cache_grpc_client.h"
 #else
@@ -85,6 +86,22 @@ class CacheClient {
       return *this;
     }
 
+    /// Setter function to set the promotion/eviction policy between memory and disk
+    /// \param tier_policy
+    /// \return Builder object itself
+    Builder &SetTierPolicy(CacheTierPolicyType tier_policy) {
+      tier_policy_ = tier_policy;
+      return *this;
+    }
+
+    /// Setter function to set the compression of the cached rows
+    /// \param compression
+    /// \return Builder object itself
+    Builder &SetCompression(CacheCompressionType compression) {
+      compression_ = compression;
+      return *this;
+    }
+
     /// Setter function to set rpc hostname
     /// \param host
     /// \return Builder object itself
@@ -121,6 +138,8 @@ class CacheClient {
     session_id_type GetSessionId() const { return session_id_; }
     uint64_t GetCacheMemSz() const { return cache_mem_sz_; }
     bool isSpill() const { return spill_; }
+    CacheTierPolicyType GetTierPolicy() const { return tier_policy_; }
+    CacheCompressionType GetCompression() const { return compression_; }
     const std::string &GetHostname() const { return hostname_; }
     int32_t GetPort() const { return port_; }
     int32_t GetNumConnections() const { return num_connections_; }
@@ -134,6 +153,8 @@ class CacheClient {
     session_id_type session_id_;
     uint64_t cache_mem_sz_;
     bool spill_;
+    CacheTierPolicyType tier_policy_;
+    CacheCompressionType compression_;
     std::string hostname_;
     int32_t port_;
     int32_t num_connections_;
@@ -144,8 +165,12 @@ class CacheClient {
   /// \param session_id A user assigned session id for the current pipeline
   /// \param cache_mem_sz Size of the memory set aside for the row caching. 0 for unlimited
   /// \param spill Spill to disk if out of memory
+  /// \param tier_policy Promotion/eviction policy between memory and disk if spill is on
+  /// \param compression Compression of the cached rows. Rows are compressed by the server and decompressed by us.
   CacheClient(session_id_type session_id, uint64_t cache_mem_sz, bool spill, std::string hostname, int32_t port,
-              int32_t num_connections, int32_t prefetch_size);
+              int32_t num_connections, int32_t prefetch_size,
+              CacheTierPolicyType tier_policy = CacheTierPolicyType::kNone,
+              CacheCompressionType compression = CacheCompressionType::kNone);
 
   /// \brief Destructor
   ~CacheClient();
@@ -193,6 +218,11 @@ class CacheClient {
   /// \return Status object.
   Status FetchSchema(std::unordered_map<std::string, int32_t> *map);
 
+  /// \brief Fetch the dictionary the cached rows are compressed with. It is fetched from the server only once.
+  /// \param out Pointer to a string to hold the dictionary
+  /// \return Status object.
+  Status GetCompressionDict(std::string *out) const;
+
   /// \brief Change the state from build phase to read phase. Applicable to non-mappable dataset only. Only the cache
   /// client that holds cookie can be allowed to make this request
   /// \return Status object
@@ -273,6 +303,11 @@ class CacheClient {
   mutable RWLock mux_;
   uint64_t cache_mem_sz_;
   bool spill_;
+  CacheTierPolicyType tier_policy_;
+  CacheCompressionType compression_;
+  mutable std::mutex dict_mux_;
+  mutable std::string compression_dict_;
+  mutable std::atomic<int64_t> decompress_time_us_;
   // The session_id_ and cache_crc_ work together to uniquely identify this particular cache and allow
   // sharing of the cache.
   CacheClientInfo cinfo_;
@@ -354,6 +389,16 @@ class CacheClient {
     int32_t cur_;
   };
   std::shared_ptr<AsyncBufferStream> async_buffer_stream_;
+  /// The ring in the shared memory to send BatchFetch requests to the server without gRPC. Local client only.
+  std::unique_ptr<CacheFetchRing> fetch_ring_;
+
+  /// \brief Allocate a fetch ring in the shared memory and register it at the server.
+  Status InitFetchRing();
+
+  /// \brief Create a pool owning a BatchFetch reply in the shared memory. The tensors restored from the reply refer
+  /// to the memory through the pool, and the block is freed at the server after the pool is destroyed.
+  /// \param addr relative address of the block
+  std::shared_ptr<MemoryPool> CreateSharedReplyBlock(int64_t addr) const;
 };
 }  // namespace dataset
 }  // namespace mindspore
@@ -38,6 +38,9 @@ namespace dataset {
 /// For too small amount, we won't get any benefit using shared memory method because we need
 /// two rpc requests to use shared memory method.
 constexpr static int32_t kLocalByPassThreshold = 64 * 1024;
+/// \brief A BatchFetch request whose total amount of bytes is below the following number is served by the
+/// rpc thread itself. Dispatching the rows to the server workers costs more than the copy in that case.
+constexpr static int32_t kInlineFetchThreshold = 64 * 1024;
 /// \brief Default size (in GB) of shared memory we are going to create
 constexpr static int32_t kDefaultSharedMemorySize = 4;
 /// \brief Memory Cap ratio used by the server
@@ -53,6 +56,9 @@ constexpr static uint32_t kLocalClientSupport = 1;
 /// \brief A flag used by CacheRow request (client side) and BatchFetch (server side) reply to indicate if the data is
 /// inline in the protobuf. This also implies kLocalClientSupport is also true.
 constexpr static uint32_t kDataIsInSharedMemory = 2;
+/// \brief A flag used by BatchFetch (server side) reply to indicate the rows are compressed and the client must
+/// decompress them.
+constexpr static uint32_t kDataIsCompressed = 4;
 /// \brief Size of each message used in message queue.
 constexpr static int32_t kSharedMessageSize = 2048;
 /// \brief The default common path for all users
@@ -106,6 +112,15 @@ inline int64_t round_up_4K(int64_t sz) {
   return static_cast<uint64_t>(sz + 4095) & ~static_cast<uint64_t>(4095);
 }
 
+/// \brief Alignment of each row in a BatchFetch reply. Rows of a batch are copied concurrently by different
+/// server workers, and keeping each row on its own cache lines is enough to avoid false sharing.
+constexpr static int64_t kFetchRowAlignment = 64;
+
+/// \brief Round up the size of a row in a BatchFetch reply to kFetchRowAlignment
+inline int64_t round_up_fetch_row(int64_t sz) {
+  return static_cast<uint64_t>(sz + kFetchRowAlignment - 1) & ~static_cast<uint64_t>(kFetchRowAlignment - 1);
+}
+
 /// Memory policy
 enum CachePoolPolicy : int8_t { kOnNode, kPreferred, kLocal, kInterleave, kNone };
 
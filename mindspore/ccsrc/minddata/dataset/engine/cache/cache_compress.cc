@@ -0,0 +1,180 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "minddata/dataset/engine/cache/cache_compress.h"
+#ifdef ENABLE_CACHE
+#include <zlib.h>
+#endif
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace mindspore {
+namespace dataset {
+RowCompressor::RowCompressor(CacheCompressionType type) : type_(type), trained_(false), num_samples_(0) {}
+
+void RowCompressor::Train(const std::vector<ReadableSlice> &buf) {
+  std::unique_lock<std::mutex> lck(mux_);
+  if (trained_) {
+    return;
+  }
+  size_t sz = 0;
+  for (auto &v : buf) {
+    if (sz >= kSampleSize) {
+      break;
+    }
+    auto n = std::min(kSampleSize - sz, v.GetSize());
+    samples_.append(reinterpret_cast<const char *>(v.GetPointer()), n);
+    sz += n;
+  }
+  if (++num_samples_ >= kNumTrainingRows) {
+    // Deflate matches against the tail of the dictionary first. The samples are all alike so the order doesn't
+    // really matter.
+    dict_ = samples_.size() > kMaxDictSize ? samples_.substr(samples_.size() - kMaxDictSize) : samples_;
+    samples_.clear();
+    samples_.shrink_to_fit();
+    trained_ = true;
+  }
+}
+
+Status RowCompressor::Compress(const std::vector<ReadableSlice> &buf, std::string *out) {
+  RETURN_UNEXPECTED_IF_NULL(out);
+  CHECK_FAIL_RETURN_UNEXPECTED(type_ == CacheCompressionType::kDeflate, "Unsupported compression type");
+  size_t raw_sz = 0;
+  for (auto &v : buf) {
+    raw_sz += v.GetSize();
+  }
+#ifdef ENABLE_CACHE
+  CHECK_FAIL_RETURN_UNEXPECTED(raw_sz <= std::numeric_limits<uInt>::max(), "Row is too big to compress");
+  // The dictionary is immutable once trained_ is set, so we can read it without the lock.
+  bool use_dict = trained_;
+  if (!use_dict) {
+    Train(buf);
+  }
+  CompressedRowHeader hdr{kMagic, CompressedRowHeader::kDeflate, static_cast<int16_t>(use_dict ? kDictId : 0),
+                          static_cast<int64_t>(raw_sz)};
+  z_stream zs;
+  (void)memset(&zs, 0, sizeof(zs));
+  // Favour speed. We are on the path of every row being cached.
+  if (deflateInit(&zs, Z_BEST_SPEED) != Z_OK) {
+    RETURN_STATUS_UNEXPECTED("Fail to initialize deflate");
+  }
+  if (use_dict) {
+    (void)deflateSetDictionary(&zs, reinterpret_cast<const Bytef *>(dict_.data()), dict_.size());
+  }
+  try {
+    out->resize(sizeof(hdr) + deflateBound(&zs, raw_sz));
+  } catch (const std::bad_alloc &e) {
+    (void)deflateEnd(&zs);
+    return Status(StatusCode::kMDOutOfMemory, __LINE__, __FILE__);
+  }
+  zs.next_out = reinterpret_cast<Bytef *>(&(*out)[sizeof(hdr)]);
+  zs.avail_out = out->size() - sizeof(hdr);
+  int err = Z_OK;
+  for (size_t i = 0; i < buf.size() && err == Z_OK; ++i) {
+    bool last = (i + 1 == buf.size());
+    // Deflate complains about no progress if given nothing to do without flushing.
+    if (buf[i].GetSize() == 0 && !last) {
+      continue;
+    }
+    zs.next_in = reinterpret_cast<Bytef *>(const_cast<void *>(buf[i].GetPointer()));
+    zs.avail_in = buf[i].GetSize();
+    err = deflate(&zs, last ? Z_FINISH : Z_NO_FLUSH);
+  }
+  auto compressed_sz = zs.total_out;
+  (void)deflateEnd(&zs);
+  if (err != Z_STREAM_END || compressed_sz >= raw_sz) {
+    // Doesn't compress. Keep it as is.
+    hdr.codec = CompressedRowHeader::kStored;
+    hdr.dict_id = 0;
+    out->resize(sizeof(hdr));
+    for (auto &v : buf) {
+      out->append(reinterpret_cast<const char *>(v.GetPointer()), v.GetSize());
+    }
+  } else {
+    out->resize(sizeof(hdr) + compressed_sz);
+  }
+  (void)memcpy(&(*out)[0], &hdr, sizeof(hdr));
+  return Status::OK();
+#else
+  RETURN_STATUS_UNEXPECTED("Row compression is not supported on this platform");
+#endif
+}
+
+Status RowCompressor::GetDictionary(std::string *out) const {
+  RETURN_UNEXPECTED_IF_NULL(out);
+  if (!trained_) {
+    return Status(StatusCode::kMDFileNotExist, __LINE__, __FILE__, "Compression dictionary is not ready");
+  }
+  *out = dict_;
+  return Status::OK();
+}
+
+Status RowCompressor::GetHeader(const ReadableSlice &src, CompressedRowHeader *hdr) {
+  RETURN_UNEXPECTED_IF_NULL(hdr);
+  CHECK_FAIL_RETURN_UNEXPECTED(src.GetSize() >= sizeof(CompressedRowHeader), "Compressed row is truncated");
+  (void)memcpy(hdr, src.GetPointer(), sizeof(CompressedRowHeader));
+  CHECK_FAIL_RETURN_UNEXPECTED(hdr->magic == kMagic, "Data corruption detected. Not a compressed row.");
+  return Status::OK();
+}
+
+Status RowCompressor::Decompress(const ReadableSlice &src, const std::string &dict, std::string *out) {
+  RETURN_UNEXPECTED_IF_NULL(out);
+  CompressedRowHeader hdr{};
+  RETURN_IF_NOT_OK(GetHeader(src, &hdr));
+  ReadableSlice payload(src, sizeof(hdr), src.GetSize() - sizeof(hdr));
+  try {
+    out->resize(hdr.raw_sz);
+  } catch (const std::bad_alloc &e) {
+    return Status(StatusCode::kMDOutOfMemory, __LINE__, __FILE__);
+  }
+  if (hdr.codec == CompressedRowHeader::kStored) {
+    // The source can be padded at the end.
+    CHECK_FAIL_RETURN_UNEXPECTED(payload.GetSize() >= static_cast<size_t>(hdr.raw_sz), "Length mismatch");
+    (void)memcpy(&(*out)[0], payload.GetPointer(), hdr.raw_sz);
+    return Status::OK();
+  }
+  CHECK_FAIL_RETURN_UNEXPECTED(hdr.codec == CompressedRowHeader::kDeflate,
+                               "Unknown codec " + std::to_string(hdr.codec));
+  CHECK_FAIL_RETURN_UNEXPECTED(hdr.dict_id == 0 || !dict.empty(), "Missing compression dictionary");
+#ifdef ENABLE_CACHE
+  z_stream zs;
+  (void)memset(&zs, 0, sizeof(zs));
+  if (inflateInit(&zs) != Z_OK) {
+    RETURN_STATUS_UNEXPECTED("Fail to initialize inflate");
+  }
+  zs.next_in = reinterpret_cast<Bytef *>(const_cast<void *>(payload.GetPointer()));
+  zs.avail_in = payload.GetSize();
+  zs.next_out = reinterpret_cast<Bytef *>(&(*out)[0]);
+  zs.avail_out = out->size();
+  int err = inflate(&zs, Z_FINISH);
+  if (err == Z_NEED_DICT) {
+    err = inflateSetDictionary(&zs, reinterpret_cast<const Bytef *>(dict.data()), dict.size());
+    if (err == Z_OK) {
+      err = inflate(&zs, Z_FINISH);
+    }
+  }
+  auto total_out = zs.total_out;
+  (void)inflateEnd(&zs);
+  if (err != Z_STREAM_END || total_out != static_cast<uLong>(hdr.raw_sz)) {
+    RETURN_STATUS_UNEXPECTED("Fail to decompress a cached row. zlib error: " + std::to_string(err));
+  }
+  return Status::OK();
+#else
+  RETURN_STATUS_UNEXPECTED("Row compression is not supported on this platform");
+#endif
+}
+}  // namespace dataset
+}  // namespace mindspore
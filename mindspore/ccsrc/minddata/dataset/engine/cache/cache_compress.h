@@ -0,0 +1,93 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_COMPRESS_H_
+#define MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_COMPRESS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "minddata/dataset/util/slice.h"
+#include "minddata/dataset/util/status.h"
+
+namespace mindspore {
+namespace dataset {
+/// \brief Compression applied by a CachePool to the rows it stores.
+enum class CacheCompressionType : int8_t {
+  kNone = 0,     // Rows are stored as is.
+  kDeflate = 1,  // Rows are deflated with a preset dictionary trained from the first rows of the cache.
+};
+
+/// \brief Every row of a cache with compression on starts with this header. The row is stored as is
+/// if it does not compress.
+struct CompressedRowHeader {
+  enum Codec : int16_t { kStored = 0, kDeflate = 1 };
+  uint32_t magic;
+  int16_t codec;
+  int16_t dict_id;  // 0 means no dictionary
+  int64_t raw_sz;
+};
+
+/// \brief Compress the rows of a cache on the server and restore them on the client.
+/// The first kNumTrainingRows rows are compressed without a dictionary and sampled. After that, a dictionary is built
+/// from the samples and used for all the rows that follow. There is only one dictionary per cache.
+class RowCompressor {
+ public:
+  static constexpr uint32_t kMagic = 0x4d44435a;
+  static constexpr int16_t kDictId = 1;
+
+  explicit RowCompressor(CacheCompressionType type);
+  ~RowCompressor() = default;
+
+  /// \brief Compress a row that is given as a sequence of slices into one contiguous buffer.
+  /// \param[in] buf The row
+  /// \param[out] out The CompressedRowHeader followed by the compressed data
+  /// \return Status object
+  Status Compress(const std::vector<ReadableSlice> &buf, std::string *out);
+
+  /// \brief Return the dictionary once it is trained.
+  Status GetDictionary(std::string *out) const;
+
+  /// \brief Look at the header of a compressed row.
+  static Status GetHeader(const ReadableSlice &src, CompressedRowHeader *hdr);
+
+  /// \brief Restore a row produced by Compress.
+  /// \param[in] src The compressed row
+  /// \param[in] dict The dictionary if the header refers to one, otherwise ignored
+  /// \param[out] out The original row
+  /// \return Status object
+  static Status Decompress(const ReadableSlice &src, const std::string &dict, std::string *out);
+
+ private:
+  static constexpr int32_t kNumTrainingRows = 64;
+  // Deflate can't look back further than 32K, so a longer dictionary is no use.
+  static constexpr size_t kMaxDictSize = 32768;
+  static constexpr size_t kSampleSize = kMaxDictSize / kNumTrainingRows;
+
+  /// \brief Take a sample from a row and build the dictionary when we have enough of them.
+  void Train(const std::vector<ReadableSlice> &buf);
+
+  CacheCompressionType type_;
+  mutable std::mutex mux_;
+  std::atomic<bool> trained_;
+  int32_t num_samples_;
+  std::string samples_;
+  std::string dict_;
+};
+}  // namespace dataset
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_COMPRESS_H_
@@ -39,8 +39,11 @@ Status SerializeTensorRowHeader(const TensorRow &row, std::shared_ptr<flatbuffer
 /// \param col_ts A serialized version of Tensor meta data
 /// \param data Tensor data wrapped in a slice
 /// \param out Tensor
+/// \param pool If not null, the data is owned by the pool and the tensor refers to it instead of copying it, provided
+/// the data is aligned for its type
 /// \return Status object
-Status RestoreOneTensor(const TensorMetaMsg *col_ts, const ReadableSlice &data, std::shared_ptr<Tensor> *out);
+Status RestoreOneTensor(const TensorMetaMsg *col_ts, const ReadableSlice &data, std::shared_ptr<Tensor> *out,
+                        const std::shared_ptr<MemoryPool> &pool = nullptr);
 }  // namespace dataset
 }  // namespace mindspore
 #endif  // MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_FBB_H_
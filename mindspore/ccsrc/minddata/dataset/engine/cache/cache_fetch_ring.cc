@@ -0,0 +1,154 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "minddata/dataset/engine/cache/cache_fetch_ring.h"
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <string>
+#include <thread>
+
+namespace mindspore {
+namespace dataset {
+CacheFetchRing::CacheFetchRing(void *base)
+    : header_(reinterpret_cast<Header *>(base)),
+      slots_(reinterpret_cast<Slot *>(reinterpret_cast<char *>(base) + sizeof(Header))) {}
+
+int64_t CacheFetchRing::MemorySize() { return sizeof(Header) + sizeof(Slot) * kNumSlots; }
+
+void CacheFetchRing::Init() {
+  // The atomics must be lock free to work across the processes.
+  static_assert(std::atomic<uint32_t>::is_always_lock_free, "The fetch ring needs lock free atomics");
+  (void)new (header_) Header();
+  header_->closed.store(0, std::memory_order_relaxed);
+  header_->next_slot.store(0, std::memory_order_relaxed);
+  for (int32_t i = 0; i < kNumSlots; ++i) {
+    auto *slot = new (GetSlot(i)) Slot();
+    slot->num_rows = 0;
+    slot->flag = 0;
+    slot->rc = 0;
+    slot->addr = -1;
+    slot->state.store(kFree, std::memory_order_release);
+  }
+}
+
+bool CacheFetchRing::Submit(const std::vector<row_id_type> &row_id, int32_t *slot) {
+  if (row_id.empty() || row_id.size() > kMaxRows || slot == nullptr) {
+    return false;
+  }
+  // Start from a different slot each time so that the concurrent clients don't fight for the same one.
+  auto start = header_->next_slot.fetch_add(1, std::memory_order_relaxed);
+  for (int32_t k = 0; k < kNumSlots; ++k) {
+    auto i = static_cast<int32_t>((start + k) % kNumSlots);
+    auto *s = GetSlot(i);
+    uint32_t expected = kFree;
+    if (s->state.compare_exchange_strong(expected, kClaimed, std::memory_order_acquire)) {
+      std::copy(row_id.begin(), row_id.end(), s->row_id);
+      s->num_rows = static_cast<int32_t>(row_id.size());
+      s->addr = -1;
+      s->flag = 0;
+      s->rc = 0;
+      s->state.store(kPosted, std::memory_order_release);
+      *slot = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+Status CacheFetchRing::Wait(int32_t slot, int64_t *addr, uint32_t *flag, std::chrono::milliseconds timeout) {
+  RETURN_UNEXPECTED_IF_NULL(addr);
+  RETURN_UNEXPECTED_IF_NULL(flag);
+  CHECK_FAIL_RETURN_UNEXPECTED(slot >= 0 && slot < kNumSlots, "Invalid slot " + std::to_string(slot));
+  auto *s = GetSlot(slot);
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  int32_t count = 0;
+  int32_t sleep_us = 1;
+  while (s->state.load(std::memory_order_acquire) != kDone) {
+    if (++count < kSpinCount) {
+      continue;
+    }
+    if (std::chrono::steady_clock::now() > deadline) {
+      // Take the slot back if the server hasn't picked it up. Otherwise leave it to the server, which frees the slot
+      // and the reply block when it completes the slot.
+      uint32_t expected = kPosted;
+      if (s->state.compare_exchange_strong(expected, kFree, std::memory_order_acq_rel)) {
+        RETURN_STATUS_UNEXPECTED("Timeout waiting for the cache server to serve the fetch ring");
+      }
+      expected = kServing;
+      if (s->state.compare_exchange_strong(expected, kAbandoned, std::memory_order_acq_rel)) {
+        RETURN_STATUS_UNEXPECTED("Timeout waiting for the cache server to finish the fetch ring slot " +
+                                 std::to_string(slot));
+      }
+      // The server has just completed it.
+      continue;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+    sleep_us = std::min(sleep_us * 2, kMaxSleepUs);
+  }
+  auto rc = s->rc;
+  *addr = s->addr;
+  *flag = s->flag;
+  s->state.store(kFree, std::memory_order_release);
+  if (rc != static_cast<int32_t>(StatusCode::kSuccess)) {
+    RETURN_STATUS_UNEXPECTED("Cache server failed to serve the fetch ring. Error code " + std::to_string(rc));
+  }
+  return Status::OK();
+}
+
+void CacheFetchRing::Close() { header_->closed.store(1, std::memory_order_release); }
+
+bool CacheFetchRing::IsClosed() const { return header_->closed.load(std::memory_order_acquire) != 0; }
+
+bool CacheFetchRing::IsServing() const {
+  for (int32_t i = 0; i < kNumSlots; ++i) {
+    auto state = GetSlot(i)->state.load(std::memory_order_acquire);
+    if (state == kServing || state == kAbandoned) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CacheFetchRing::Claim(int32_t slot, std::vector<row_id_type> *row_id) {
+  if (slot < 0 || slot >= kNumSlots || row_id == nullptr) {
+    return false;
+  }
+  auto *s = GetSlot(slot);
+  uint32_t expected = kPosted;
+  if (!s->state.compare_exchange_strong(expected, kServing, std::memory_order_acquire)) {
+    return false;
+  }
+  // The slot is written by the client, so don't trust the number of rows.
+  auto num_rows = std::min(std::max(s->num_rows, 0), kMaxRows);
+  row_id->assign(s->row_id, s->row_id + num_rows);
+  return true;
+}
+
+bool CacheFetchRing::Complete(int32_t slot, const Status &rc, int64_t addr, uint32_t flag) {
+  auto *s = GetSlot(slot);
+  s->addr = addr;
+  s->flag = flag;
+  s->rc = static_cast<int32_t>(rc.StatusCode());
+  uint32_t expected = kServing;
+  if (s->state.compare_exchange_strong(expected, kDone, std::memory_order_acq_rel)) {
+    return true;
+  }
+  // The client has given up the slot, so no one else will release it.
+  s->state.store(kFree, std::memory_order_release);
+  return false;
+}
+}  // namespace dataset
+}  // namespace mindspore
@@ -0,0 +1,123 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_FETCH_RING_H_
+#define MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_FETCH_RING_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "minddata/dataset/include/dataset/constants.h"
+#include "minddata/dataset/util/status.h"
+
+namespace mindspore {
+namespace dataset {
+/// \brief A ring of BatchFetch requests in the shared memory between a local client and the cache server.
+/// A local client posts the row ids into a slot instead of sending a gRPC request, the server polls the ring and
+/// replies with the relative address of a shared memory block holding the rows, in the same layout as the reply
+/// of a BatchFetch request.
+/// \note The ring is only an accelerator. The client goes through gRPC whenever the ring is full, the request has
+/// too many rows, or the server fails to serve the slot. The error is then reported by the gRPC path.
+/// A slot is served in two steps, so the server can claim the slots of all the rings and fetch their rows in parallel.
+/// A client which gives up waiting marks its slot abandoned, and the server frees the slot and the reply block
+/// when it completes the slot.
+class CacheFetchRing {
+ public:
+  /// \brief Number of slots of a ring, which is also the number of BatchFetch requests in flight through the ring.
+  constexpr static int32_t kNumSlots = 16;
+  /// \brief Maximum number of rows of a request which goes through the ring.
+  constexpr static int32_t kMaxRows = 256;
+  /// \brief Number of polls before a waiting client starts to sleep.
+  constexpr static int32_t kSpinCount = 1024;
+  /// \brief Longest sleep in microseconds of a waiting client or an idle server.
+  constexpr static int32_t kMaxSleepUs = 100;
+  /// \brief A client gives up the wait after this many seconds, the same as the deadline of a gRPC request.
+  constexpr static int32_t kWaitTimeoutInSec = 60;
+
+  /// \brief Wrap a ring at the given shared memory. The memory must be at least MemorySize() bytes.
+  explicit CacheFetchRing(void *base);
+  ~CacheFetchRing() = default;
+
+  /// \return Number of bytes of the shared memory of a ring
+  static int64_t MemorySize();
+
+  /// \brief Format the ring. Called by the client before the ring is registered at the server.
+  void Init();
+
+  /// \brief Client side. Post the rows into a free slot.
+  /// \param[in] row_id the rows to fetch
+  /// \param[out] slot the slot to wait for
+  /// \return False if the rows can't go through the ring
+  bool Submit(const std::vector<row_id_type> &row_id, int32_t *slot);
+
+  /// \brief Client side. Wait for the server to serve the slot and release it.
+  /// \param[in] slot the slot returned by Submit
+  /// \param[out] addr relative address of the shared memory block holding the rows
+  /// \param[out] flag reply flag of the rows
+  /// \param[in] timeout how long to wait for the server
+  /// \return Status object. An error means the rows must be fetched again through gRPC.
+  Status Wait(int32_t slot, int64_t *addr, uint32_t *flag,
+              std::chrono::milliseconds timeout = std::chrono::seconds(kWaitTimeoutInSec));
+
+  /// \brief Client side. Tell the server to stop polling the ring and give back its memory.
+  void Close();
+
+  /// \brief Server side. Claim a posted slot so that no one else serves it.
+  /// \param[in] slot the slot to claim
+  /// \param[out] row_id the rows to fetch
+  /// \return False if the slot is not posted
+  bool Claim(int32_t slot, std::vector<row_id_type> *row_id);
+
+  /// \brief Server side. Reply to a claimed slot.
+  /// \param[in] slot the slot claimed
+  /// \param[in] rc result of the fetch
+  /// \param[in] addr relative address of the shared memory block holding the rows
+  /// \param[in] flag reply flag of the rows
+  /// \return False if the client has abandoned the slot. The slot is then free again, and the caller must free the
+  /// shared memory block of the reply if there is one.
+  bool Complete(int32_t slot, const Status &rc, int64_t addr, uint32_t flag);
+
+  /// \return True if the client has closed the ring
+  bool IsClosed() const;
+
+  /// \return True if a slot is claimed by the server but not completed yet. The ring can't be freed until then.
+  bool IsServing() const;
+
+ private:
+  enum SlotState : uint32_t { kFree = 0, kClaimed = 1, kPosted = 2, kServing = 3, kDone = 4, kAbandoned = 5 };
+
+  struct alignas(64) Header {
+    std::atomic<uint32_t> closed;
+    std::atomic<uint32_t> next_slot;
+  };
+
+  struct alignas(64) Slot {
+    std::atomic<uint32_t> state;
+    int32_t num_rows;
+    uint32_t flag;
+    int32_t rc;
+    int64_t addr;
+    row_id_type row_id[kMaxRows];
+  };
+
+  Slot *GetSlot(int32_t i) const { return &slots_[i]; }
+
+  Header *header_;
+  Slot *slots_;
+};
+}  // namespace dataset
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_FETCH_RING_H_
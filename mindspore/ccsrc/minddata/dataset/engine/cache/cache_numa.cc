@@ -14,11 +14,12 @@
  * limitations under the License.
 */
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <limits>
+#include <thread>
 #include "minddata/dataset/engine/cache/cache_hw.h"
 #include "minddata/dataset/engine/cache/cache_numa.h"
-#include "minddata/dataset/util/random.h"
 namespace mindspore {
 namespace dataset {
 NumaMemoryPool::NumaMemoryPool(std::shared_ptr<CacheServerHW> hw, float memory_cap_ratio)
@@ -110,7 +111,8 @@ NumaMemoryPool::~NumaMemoryPool() {
 
 Status NumaMemoryPool::Allocate(size_t n, void **p) {
   RETURN_UNEXPECTED_IF_NULL(p);
-  auto mt = GetRandomDevice();
+  // Each thread starts its search from its own arena, so the server workers don't contend on the same arena lock.
+  auto home = std::hash<std::thread::id>{}(std::this_thread::get_id());
   Status rc;
   void *ptr = nullptr;
   size_t num_segments = memory_segments_.size();
@@ -125,8 +127,7 @@ Status NumaMemoryPool::Allocate(size_t n, void **p) {
       if (it != numa_map_.end()) {
         auto &slots = it->second;
         size_t num_slots = slots.size();
-        std::uniform_int_distribution<size_t> distribution(0, num_slots - 1);
-        size_t start_slot = distribution(mt);
+        size_t start_slot = home % num_slots;
         size_t inx = start_slot;
         do {
           size_t k = slots.at(inx);
@@ -151,9 +152,8 @@ Status NumaMemoryPool::Allocate(size_t n, void **p) {
       }
     } while (node_id != start);
   } else {
-    // If not numa aware, just randomly pick a slot.
-    std::uniform_int_distribution<size_t> distribution(0, num_segments - 1);
-    size_t start_slot = distribution(mt);
+    // If not numa aware, just start from the home slot of this thread.
+    size_t start_slot = home % num_segments;
     size_t slot = start_slot;
     do {
       std::unique_lock lock_x(mux_[slot]);
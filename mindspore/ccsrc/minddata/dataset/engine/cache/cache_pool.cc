@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 #include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
 #include "utils/ms_utils.h"
 #include "minddata/dataset/engine/cache/cache_pool.h"
 #include "minddata/dataset/engine/cache/cache_server.h"
@@ -21,8 +24,34 @@
 
 namespace mindspore {
 namespace dataset {
-CachePool::CachePool(std::shared_ptr<NumaMemoryPool> mp, const std::string &root)
-    : mp_(std::move(mp)), root_(root), subfolder_(Services::GetUniqueID()), sm_(nullptr), tree_(nullptr) {
+CachePool::CachePool(std::shared_ptr<NumaMemoryPool> mp, const std::string &root, CacheTierPolicyType tier_policy,
+                     CacheCompressionType compression)
+    : mp_(std::move(mp)),
+      root_(root),
+      subfolder_(Services::GetUniqueID()),
+      sm_(nullptr),
+      tier_rw_lock_(CacheServer::GetInstance().GetNumWorkers()),
+      num_mem_hit_(0),
+      num_disk_hit_(0),
+      num_miss_(0),
+      num_promoted_(0),
+      num_evicted_(0),
+      num_raw_bytes_(0),
+      num_stored_bytes_(0),
+      compress_time_us_(0),
+      min_key_(std::numeric_limits<key_type>::max()),
+      max_key_(std::numeric_limits<key_type>::min()),
+      num_mem_cached_(0),
+      num_disk_cached_(0),
+      num_numa_hit_(0),
+      total_sz_(0) {
+  if (compression != CacheCompressionType::kNone) {
+    compressor_ = std::make_unique<RowCompressor>(compression);
+  }
+  // Tiering only makes sense if there is a disk tier to move rows to.
+  if (!root.empty()) {
+    tier_policy_ = CacheTierPolicy::Create(tier_policy);
+  }
   // Initialize soft memory cap to the current available memory on the machine.
   soft_mem_limit_ = CacheServerHW::GetAvailableMemory();
   temp_mem_usage_ = 0;
@@ -30,15 +59,25 @@ CachePool::CachePool(std::shared_ptr<NumaMemoryPool> mp, const std::string &root
 }
 
 Status CachePool::DoServiceStart() {
-  tree_ = std::make_shared<data_index>();
+  auto &cs = CacheServer::GetInstance();
+  auto num_shards = std::max(cs.GetNumWorkers(), 1);
+  trees_.reserve(num_shards);
+  for (auto i = 0; i < num_shards; ++i) {
+    trees_.push_back(std::make_unique<data_index>());
+  }
   // If we are given a disk path, set up the StorageManager
   if (!root_.ToString().empty()) {
     Path spill = GetSpillPath();
     RETURN_IF_NOT_OK(spill.CreateDirectories());
-    auto &cs = CacheServer::GetInstance();
     sm_ = std::make_shared<StorageManager>(spill, cs.GetNumWorkers());
     RETURN_IF_NOT_OK(sm_->ServiceStart());
     MS_LOG(INFO) << "CachePool will use disk folder: " << spill.ToString();
+    if (TieringEnabled()) {
+      RETURN_IF_NOT_OK(vg_.ServiceStart());
+      promote_q_ = std::make_unique<Queue<key_type>>(kPromoteQueueCapacity);
+      RETURN_IF_NOT_OK(promote_q_->Register(&vg_));
+      RETURN_IF_NOT_OK(vg_.CreateAsyncTask("Cache row promotion", std::bind(&CachePool::PromoteWorker, this)));
+    }
   }
   return Status::OK();
 }
@@ -46,6 +85,13 @@ Status CachePool::DoServiceStart() {
 Status CachePool::DoServiceStop() {
   Status rc;
   Status rc2;
+  // Stop the promotion task first. It is the only one moving rows between tiers.
+  if (TieringEnabled()) {
+    rc = vg_.ServiceStop();
+    if (rc.IsError()) {
+      rc2 = rc;
+    }
+  }
   if (sm_ != nullptr) {
     rc = sm_->ServiceStop();
     if (rc.IsError()) {
@@ -59,7 +105,7 @@ Status CachePool::DoServiceStop() {
   // skip this and release the whole NumaMemoryPool instead. Otherwise
   // release each buffer in the DataLocator one by one.
 
-  tree_.reset();
+  trees_.clear();
   if (!root_.ToString().empty()) {
     Path spill = GetSpillPath();
     auto it = Path::DirIterator::OpenDirectory(&spill);
@@ -80,6 +126,33 @@ Status CachePool::DoServiceStop() {
 CachePool::~CachePool() noexcept { (void)ServiceStop(); }
 
 Status CachePool::Insert(CachePool::key_type key, const std::vector<ReadableSlice> &buf) {
+  if (!CompressionEnabled()) {
+    return InsertNoCompress(key, buf);
+  }
+  std::string compressed;
+  auto start = std::chrono::steady_clock::now();
+  RETURN_IF_NOT_OK(compressor_->Compress(buf, &compressed));
+  auto end = std::chrono::steady_clock::now();
+  Status rc = InsertNoCompress(key, {ReadableSlice(compressed.data(), compressed.size())});
+  if (rc.IsOk()) {
+    int64_t raw_sz = 0;
+    for (auto &v : buf) {
+      raw_sz += v.GetSize();
+    }
+    num_raw_bytes_ += raw_sz;
+    num_stored_bytes_ += compressed.size();
+    compress_time_us_ += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  }
+  return rc;
+}
+
+Status CachePool::GetCompressionDict(std::string *out) const {
+  RETURN_UNEXPECTED_IF_NULL(out);
+  CHECK_FAIL_RETURN_UNEXPECTED(CompressionEnabled(), "Compression is not enabled");
+  return compressor_->GetDictionary(out);
+}
+
+Status CachePool::InsertNoCompress(CachePool::key_type key, const std::vector<ReadableSlice> &buf) {
   DataLocator bl;
   Status rc;
   size_t sz = 0;
@@ -139,12 +212,13 @@ Status CachePool::Insert(CachePool::key_type key, const std::vector<ReadableSlic
       // instead.
       return Status(StatusCode::kMDOutOfMemory, __LINE__, __FILE__, "No enough storage for cache server to cache data");
     }
+    bl.on_disk = true;
   } else {
     return rc;
   }
   // Insert into the B+ tree. We may still get out of memory error. So need to catch it.
   try {
-    rc = tree_->DoInsert(key, bl);
+    rc = GetTree(key)->DoInsert(key, bl);
   } catch (const std::bad_alloc &e) {
     rc = Status(StatusCode::kMDOutOfMemory, __LINE__, __FILE__);
   }
@@ -154,12 +228,46 @@ Status CachePool::Insert(CachePool::key_type key, const std::vector<ReadableSlic
     bl.ptr = nullptr;
     return rc;
   }
+  if (rc.IsOk()) {
+    RecordInsert(key, bl);
+  }
+  if (rc.IsOk() && TieringEnabled() && bl.ptr != nullptr) {
+    std::unique_lock<std::mutex> lck(tier_mux_);
+    tier_policy_->OnInsert(key);
+  }
   return rc;
 }
 
+void CachePool::RecordInsert(key_type key, const DataLocator &bl) {
+  auto min_key = min_key_.load();
+  while (key < min_key && !min_key_.compare_exchange_weak(min_key, key)) {
+  }
+  auto max_key = max_key_.load();
+  while (key > max_key && !max_key_.compare_exchange_weak(max_key, key)) {
+  }
+  if (bl.ptr != nullptr) {
+    ++num_mem_cached_;
+  } else {
+    ++num_disk_cached_;
+  }
+  if (bl.node_hit) {
+    ++num_numa_hit_;
+  }
+  total_sz_ += static_cast<int64_t>(bl.sz);
+}
+
 Status CachePool::Read(CachePool::key_type key, WritableSlice *dest, size_t *bytesRead) const {
+  if (TieringEnabled()) {
+    // The promotion task swaps locators under the exclusive lock, so the row can't move while we copy it.
+    ShardedSharedLock lck(&tier_rw_lock_);
+    return ReadNoLock(key, dest, bytesRead);
+  }
+  return ReadNoLock(key, dest, bytesRead);
+}
+
+Status CachePool::ReadNoLock(CachePool::key_type key, WritableSlice *dest, size_t *bytesRead) const {
   RETURN_UNEXPECTED_IF_NULL(dest);
-  auto r = tree_->Search(key);
+  auto r = GetTree(key)->Search(key);
   if (r.second) {
     auto &it = r.first;
     if (it->ptr != nullptr) {
@@ -189,63 +297,237 @@ Path CachePool::GetSpillPath() const {
 }
 
 CachePool::CacheStat CachePool::GetStat(bool GetMissingKeys) const {
-  tree_->LockShared();  // Prevent any node split while we search.
   CacheStat cs{-1, -1, 0, 0, 0, 0};
-  int64_t total_sz = 0;
-  if (tree_->begin() != tree_->end()) {
-    cs.min_key = tree_->begin().key();
-    cs.max_key = cs.min_key;  // will adjust later.
-    for (auto it = tree_->begin(); it != tree_->end(); ++it) {
-      it.LockShared();
-      total_sz += it.value().sz;
-      if (it.value().ptr != nullptr) {
-        ++cs.num_mem_cached;
-      } else {
-        ++cs.num_disk_cached;
-      }
-      if (it.value().node_hit) {
-        ++cs.num_numa_hit;
-      }
-      auto cur_key = it.key();
-      if (GetMissingKeys) {
-        for (auto i = cs.max_key + 1; i < cur_key; ++i) {
-          cs.gap.push_back((i));
+  cs.num_mem_cached = num_mem_cached_;
+  cs.num_disk_cached = num_disk_cached_;
+  cs.num_numa_hit = num_numa_hit_;
+  cs.num_mem_hit = num_mem_hit_;
+  cs.num_disk_hit = num_disk_hit_;
+  cs.num_miss = num_miss_;
+  cs.num_promoted = num_promoted_;
+  cs.num_evicted = num_evicted_;
+  cs.num_raw_bytes = num_raw_bytes_;
+  cs.num_stored_bytes = num_stored_bytes_;
+  cs.compress_time_us = compress_time_us_;
+  auto num_cached = cs.num_mem_cached + cs.num_disk_cached;
+  if (num_cached == 0) {
+    return cs;
+  }
+  cs.min_key = min_key_;
+  cs.max_key = max_key_;
+  // integer arithmetic. NO need to cast to float or double.
+  cs.average_cache_sz = std::max<int64_t>(total_sz_ / num_cached, 1);
+  if (GetMissingKeys && cs.max_key > cs.min_key) {
+    // Keys are spread over the shards. Mark the ones present between min and max so the gaps come out in key order.
+    std::vector<bool> present(static_cast<size_t>(cs.max_key - cs.min_key + 1), false);
+    for (auto &tree : trees_) {
+      // Prevent any node split while we walk.
+      tree->LockShared();
+      for (auto it = tree->begin(); it != tree->end(); ++it) {
+        auto cur_key = it.key();
+        if (cur_key >= cs.min_key && cur_key <= cs.max_key) {
+          present[static_cast<size_t>(cur_key - cs.min_key)] = true;
         }
       }
-      cs.max_key = cur_key;
-      it.Unlock();
+      tree->Unlock();
     }
-  }
-  if (total_sz > 0) {
-    // integer arithmetic. NO need to cast to float or double.
-    cs.average_cache_sz = total_sz / (cs.num_disk_cached + cs.num_mem_cached);
-    if (cs.average_cache_sz == 0) {
-      cs.average_cache_sz = 1;
+    for (size_t i = 0; i < present.size(); ++i) {
+      if (!present[i]) {
+        cs.gap.push_back(cs.min_key + static_cast<key_type>(i));
+      }
     }
   }
-  tree_->Unlock();
   return cs;
 }
 
 Status CachePool::GetDataLocator(key_type key, const std::shared_ptr<flatbuffers::FlatBufferBuilder> &fbb,
                                  flatbuffers::Offset<DataLocatorMsg> *out) const {
   RETURN_UNEXPECTED_IF_NULL(out);
-  auto r = tree_->Search(key);
+  std::unique_ptr<ShardedSharedLock> tier_lck;
+  if (TieringEnabled()) {
+    tier_lck = std::make_unique<ShardedSharedLock>(&tier_rw_lock_);
+  }
+  auto r = GetTree(key)->Search(key);
   if (r.second) {
     auto &it = r.first;
+    RecordAccess(key, &(*it));
     DataLocatorMsgBuilder bld(*fbb);
     bld.add_key(key);
     bld.add_size(it->sz);
     bld.add_node_id(it->node_id);
-    bld.add_addr(reinterpret_cast<int64_t>(it->ptr));
+    // With tiering on, a memory row can be evicted before the fetch is served. Don't hand out the address
+    // and let the fetch go through Read which looks up the row again under the tier lock.
+    bld.add_addr(TieringEnabled() ? 0 : reinterpret_cast<int64_t>(it->ptr));
     auto offset = bld.Finish();
     *out = offset;
   } else {
+    RecordAccess(key, nullptr);
     // Key not in the cache.
     auto offset = CreateDataLocatorMsg(*fbb, key, 0, 0, 0);
     *out = offset;
   }
   return Status::OK();
 }
+
+void CachePool::RecordAccess(key_type key, const DataLocator *bl) const {
+  if (bl == nullptr) {
+    ++num_miss_;
+    return;
+  }
+  bool in_memory = (bl->ptr != nullptr);
+  if (in_memory) {
+    ++num_mem_hit_;
+  } else {
+    ++num_disk_hit_;
+  }
+  if (!TieringEnabled()) {
+    return;
+  }
+  // Bookkeeping is best effort. Rather than having all the fetching threads queue up behind the
+  // policy, we drop the access if someone else is updating it.
+  std::unique_lock<std::mutex> lck(tier_mux_, std::try_to_lock);
+  if (!lck.owns_lock()) {
+    return;
+  }
+  tier_policy_->OnAccess(key);
+  if (!in_memory && promote_pending_.size() < static_cast<size_t>(kPromoteQueueCapacity) &&
+      promote_pending_.insert(key).second) {
+    // There is room in the queue since the pending set is bounded by its capacity, so Add won't block.
+    Status rc = promote_q_->Add(key);
+    if (rc.IsError()) {
+      promote_pending_.erase(key);
+    }
+  }
+}
+
+Status CachePool::PromoteWorker() {
+  TaskManager::FindMe()->Post();
+  while (true) {
+    key_type key;
+    RETURN_IF_NOT_OK(promote_q_->PopFront(&key));
+    Status rc = Promote(key);
+    {
+      std::unique_lock<std::mutex> lck(tier_mux_);
+      promote_pending_.erase(key);
+    }
+    // Running out of memory or the policy refusing admission is expected. Nothing else should happen.
+    if (rc.IsError() && rc != StatusCode::kMDOutOfMemory) {
+      MS_LOG(WARNING) << "Fail to promote row " << key << " to memory. " << rc.ToString();
+    }
+  }
+}
+
+Status CachePool::Promote(key_type key) {
+  // We are the only task moving rows between tiers, so the locator can't change under us
+  // until we take the exclusive lock below to update it.
+  DataLocator bl;
+  {
+    ShardedSharedLock lck(&tier_rw_lock_);
+    auto r = GetTree(key)->Search(key);
+    if (!r.second || r.first->ptr != nullptr) {
+      return Status::OK();
+    }
+    bl = *(r.first);
+  }
+  // Make room for the row. Each victim must be colder than the candidate according to the policy.
+  pointer p = nullptr;
+  Status rc;
+  for (int32_t i = 0; i <= kMaxEvictionPerPromotion; ++i) {
+    // The usage may be over the soft limit already, so compare the sums instead of subtracting from the limit.
+    if (soft_mem_limit_ >= temp_mem_usage_ + static_cast<uint64_t>(bl.sz) + min_avail_mem_) {
+      rc = mp_->Allocate(bl.sz, reinterpret_cast<void **>(&p));
+      if (rc.IsOk()) {
+        break;
+      }
+      if (rc != StatusCode::kMDOutOfMemory) {
+        return rc;
+      }
+    } else {
+      rc = Status(StatusCode::kMDOutOfMemory, __LINE__, __FILE__);
+    }
+    key_type victim;
+    bool admit = false;
+    {
+      std::unique_lock<std::mutex> lck(tier_mux_);
+      admit = tier_policy_->PickVictim(&victim) && tier_policy_->Admit(key, victim);
+    }
+    if (!admit) {
+      return Status(StatusCode::kMDOutOfMemory, __LINE__, __FILE__, "Row is not admitted to memory");
+    }
+    RETURN_IF_NOT_OK(Demote(victim));
+  }
+  RETURN_IF_NOT_OK(rc);
+  temp_mem_usage_ += bl.sz;
+  // Disk copy is immutable. No lock is needed to read it.
+  WritableSlice dest(p, bl.sz);
+  size_t bytes_read = 0;
+  rc = sm_->Read(bl.storage_key, &dest, &bytes_read);
+  if (rc.IsOk() && bytes_read != bl.sz) {
+    rc = Status(StatusCode::kMDUnexpectedError, __LINE__, __FILE__, "Length mismatch when promoting a row.");
+  }
+  if (rc.IsError()) {
+    mp_->Deallocate(p);
+    return rc;
+  }
+  {
+    ShardedUniqueLock lck(&tier_rw_lock_);
+    auto r = GetTree(key)->Search(key);
+    if (!r.second) {
+      mp_->Deallocate(p);
+      return Status::OK();
+    }
+    r.first->ptr = p;
+    if (CacheServerHW::numa_enabled()) {
+      r.first->node_id = mp_->FindNode(p);
+    }
+  }
+  {
+    std::unique_lock<std::mutex> lck(tier_mux_);
+    tier_policy_->OnInsert(key);
+  }
+  ++num_promoted_;
+  ++num_mem_cached_;
+  --num_disk_cached_;
+  return Status::OK();
+}
+
+Status CachePool::Demote(key_type key) {
+  DataLocator bl;
+  {
+    ShardedSharedLock lck(&tier_rw_lock_);
+    auto r = GetTree(key)->Search(key);
+    if (r.second) {
+      bl = *(r.first);
+    }
+  }
+  if (bl.ptr == nullptr) {
+    // Not in memory any more. Just forget about it.
+    std::unique_lock<std::mutex> lck(tier_mux_);
+    tier_policy_->OnErase(key);
+    return Status::OK();
+  }
+  // A row that was promoted still has its disk copy. Otherwise write it out first.
+  if (!bl.on_disk) {
+    RETURN_IF_NOT_OK(sm_->Write(&bl.storage_key, {ReadableSlice(bl.ptr, bl.sz)}));
+  }
+  {
+    ShardedUniqueLock lck(&tier_rw_lock_);
+    auto r = GetTree(key)->Search(key);
+    CHECK_FAIL_RETURN_UNEXPECTED(r.second, "Row " + std::to_string(key) + " disappeared during eviction.");
+    r.first->ptr = nullptr;
+    r.first->on_disk = true;
+    r.first->storage_key = bl.storage_key;
+  }
+  mp_->Deallocate(bl.ptr);
+  temp_mem_usage_ = temp_mem_usage_ > bl.sz ? temp_mem_usage_ - bl.sz : 0;
+  {
+    std::unique_lock<std::mutex> lck(tier_mux_);
+    tier_policy_->OnErase(key);
+  }
+  ++num_evicted_;
+  --num_mem_cached_;
+  ++num_disk_cached_;
+  return Status::OK();
+}
 }  // namespace dataset
 }  // namespace mindspore
@@ -16,15 +16,21 @@
 #ifndef MINDSPORE_CCSRC_MINDDATA_DATASET_UTIL_CACHE_POOL_H_
 #define MINDSPORE_CCSRC_MINDDATA_DATASET_UTIL_CACHE_POOL_H_
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include "minddata/dataset/engine/cache/cache_common.h"
+#include "minddata/dataset/engine/cache/cache_compress.h"
 #include "minddata/dataset/engine/cache/cache_numa.h"
+#include "minddata/dataset/engine/cache/cache_tier_policy.h"
 #include "minddata/dataset/engine/cache/storage_manager.h"
 #include "minddata/dataset/util/allocator.h"
+#include "minddata/dataset/util/queue.h"
+#include "minddata/dataset/util/task_manager.h"
 #include "minddata/dataset/util/service.h"
 #include "minddata/dataset/util/slice.h"
 #include "minddata/dataset/util/auto_index.h"
@@ -35,6 +41,11 @@ namespace dataset {
 /// \brief A CachePool provides service for backup/restore a buffer. A buffer can be represented in a form of vector of
 /// ReadableSlice where all memory blocks will be copied to one contiguous block which can be in memory or spilled to
 /// disk (if a disk directory is provided). User must provide a key to insert the buffer.
+/// If a tier policy is given together with a disk directory, rows on disk that are fetched are promoted back to memory
+/// asynchronously, evicting (demoting) memory resident rows chosen by the policy.
+/// The index from key to locator is split into one shard per server worker, so concurrent inserts of different keys
+/// rarely touch the same B+ tree.
+/// If compression is on, each buffer is compressed before it is stored and it is up to the reader to decompress it.
 /// \see ReadableSlice
 class CachePool : public Service {
  public:
@@ -48,7 +59,7 @@ class CachePool : public Service {
   // An internal class to locate the whereabouts of a backed up buffer which can be either in
   class DataLocator {
    public:
-    DataLocator() : ptr(nullptr), sz(0), node_id(0), node_hit(false), storage_key(0) {}
+    DataLocator() : ptr(nullptr), sz(0), node_id(0), node_hit(false), on_disk(false), storage_key(0) {}
     ~DataLocator() = default;
     DataLocator(const DataLocator &other) = default;
     DataLocator &operator=(const DataLocator &other) = default;
@@ -57,9 +68,11 @@ class CachePool : public Service {
       sz = other.sz;
       node_id = other.node_id;
       node_hit = other.node_hit;
+      on_disk = other.on_disk;
       storage_key = other.storage_key;
       other.ptr = nullptr;
       other.sz = 0;
+      other.on_disk = false;
       other.storage_key = 0;
     }
     DataLocator &operator=(DataLocator &&other) noexcept {
@@ -68,9 +81,11 @@ class CachePool : public Service {
         sz = other.sz;
         node_id = other.node_id;
         node_hit = other.node_hit;
+        on_disk = other.on_disk;
         storage_key = other.storage_key;
         other.ptr = nullptr;
         other.sz = 0;
+        other.on_disk = false;
         other.storage_key = 0;
       }
       return *this;
@@ -79,6 +94,7 @@ class CachePool : public Service {
     size_t sz;
     numa_id_t node_id;  // where the numa node the memory is allocated to
     bool node_hit;      // we can allocate to the preferred node
+    bool on_disk;       // storage_key is valid. A promoted row keeps its disk copy so it can be evicted for free.
     StorageManager::key_type storage_key;
   };
 
@@ -95,13 +111,25 @@ class CachePool : public Service {
     int64_t num_disk_cached;
     int64_t average_cache_sz;
     int64_t num_numa_hit;
+    int64_t num_mem_hit;   // fetches served from memory
+    int64_t num_disk_hit;  // fetches served from disk
+    int64_t num_miss;      // fetches of a key not in the cache
+    int64_t num_promoted;  // rows moved from disk to memory
+    int64_t num_evicted;   // rows moved from memory to disk
+    int64_t num_raw_bytes;     // bytes given to Insert before compression
+    int64_t num_stored_bytes;  // bytes stored after compression
+    int64_t compress_time_us;  // cpu time spent on compression
     std::vector<key_type> gap;
   };
 
   /// \brief Constructor
   /// \param alloc Allocator to allocate memory from
   /// \param root Optional disk folder to spill
-  explicit CachePool(std::shared_ptr<NumaMemoryPool> mp, const std::string &root = "");
+  /// \param tier_policy Optional promotion/eviction policy between memory and disk. Only used if root is given.
+  /// \param compression Optional compression of the buffers
+  explicit CachePool(std::shared_ptr<NumaMemoryPool> mp, const std::string &root = "",
+                     CacheTierPolicyType tier_policy = CacheTierPolicyType::kNone,
+                     CacheCompressionType compression = CacheCompressionType::kNone);
 
   CachePool(const CachePool &) = delete;
   CachePool(CachePool &&) = delete;
@@ -133,7 +161,7 @@ class CachePool : public Service {
   Status GetDataLocator(key_type, const std::shared_ptr<flatbuffers::FlatBufferBuilder> &,
                         flatbuffers::Offset<DataLocatorMsg> *) const;
 
-  /// \brief Get statistics.
+  /// \brief Get statistics. Only the missing keys need a walk of the index.
   /// \return CacheStat object
   CacheStat GetStat(bool GetMissingKeys = false) const;
 
@@ -141,19 +169,83 @@ class CachePool : public Service {
 
   /// \brief Toggle locking
   /// \note Once locking is off. It is user's responsibility to ensure concurrency
-  void SetLocking(bool on_off) { tree_->SetLocking(on_off); }
+  void SetLocking(bool on_off) {
+    for (auto &tree : trees_) {
+      tree->SetLocking(on_off);
+    }
+  }
+
+  /// \brief Check if promotion and eviction between memory and disk is on
+  bool TieringEnabled() const { return tier_policy_ != nullptr; }
+
+  /// \brief Check if the buffers are compressed
+  bool CompressionEnabled() const { return compressor_ != nullptr; }
+
+  /// \brief Get the dictionary the buffers are compressed with
+  Status GetCompressionDict(std::string *out) const;
 
  private:
+  /// \brief Return the index shard of a key
+  data_index *GetTree(key_type key) const { return trees_[static_cast<uint64_t>(key) % trees_.size()].get(); }
+
+  /// \brief Store a buffer as is
+  Status InsertNoCompress(key_type key, const std::vector<ReadableSlice> &buf);
+
+  /// \brief Read a row, the caller must hold tier_rw_lock_ in shared mode if tiering is on.
+  Status ReadNoLock(key_type key, WritableSlice *dest, size_t *bytesRead) const;
+
+  /// \brief Count a new key in the statistics.
+  void RecordInsert(key_type key, const DataLocator &bl);
+
+  /// \brief Record a fetch of the key for the statistics and the tier policy.
+  /// \param[in] key The key fetched
+  /// \param[in] bl The locator of the key or null if the key is not cached
+  void RecordAccess(key_type key, const DataLocator *bl) const;
+
+  /// \brief Background task that promotes rows from disk to memory.
+  Status PromoteWorker();
+
+  /// \brief Move a row from disk to memory, evicting other rows if the policy admits it.
+  Status Promote(key_type key);
+
+  /// \brief Move a memory resident row to disk and release its memory.
+  Status Demote(key_type key);
+
+  std::unique_ptr<CacheTierPolicy> tier_policy_;
+  mutable std::mutex tier_mux_;  // protects tier_policy_ and promote_pending_
+  mutable ShardedRWLock tier_rw_lock_;  // exclusive when a locator is moved between tiers
+  std::unique_ptr<Queue<key_type>> promote_q_;
+  mutable std::unordered_set<key_type> promote_pending_;
+  TaskGroup vg_;
+  mutable std::atomic<int64_t> num_mem_hit_;
+  mutable std::atomic<int64_t> num_disk_hit_;
+  mutable std::atomic<int64_t> num_miss_;
+  std::atomic<int64_t> num_promoted_;
+  std::atomic<int64_t> num_evicted_;
+  std::unique_ptr<RowCompressor> compressor_;
+  std::atomic<int64_t> num_raw_bytes_;
+  std::atomic<int64_t> num_stored_bytes_;
+  std::atomic<int64_t> compress_time_us_;
+  // Kept up to date by Insert, Promote and Demote, so GetStat doesn't have to walk the index.
+  std::atomic<key_type> min_key_;
+  std::atomic<key_type> max_key_;
+  std::atomic<int64_t> num_mem_cached_;
+  std::atomic<int64_t> num_disk_cached_;
+  std::atomic<int64_t> num_numa_hit_;
+  std::atomic<int64_t> total_sz_;
+
   std::shared_ptr<NumaMemoryPool> mp_;
   Path root_;
   const std::string subfolder_;
   std::shared_ptr<StorageManager> sm_;
-  std::shared_ptr<data_index> tree_;
+  std::vector<std::unique_ptr<data_index>> trees_;
   std::atomic<uint64_t> soft_mem_limit_;  // the available memory in the machine
   std::atomic<uint64_t> temp_mem_usage_;  // temporary count on the amount of memory usage by cache every 100Mb (because
                                           // we will adjust soft_mem_limit_ every 100Mb based on this parameter)
   uint64_t min_avail_mem_;                // lower bound of the available memory
   const int kMemoryCapAdjustInterval = 104857600;
+  const int32_t kPromoteQueueCapacity = 1024;
+  const int32_t kMaxEvictionPerPromotion = 16;
 };
 }  // namespace dataset
 }  // namespace mindspore
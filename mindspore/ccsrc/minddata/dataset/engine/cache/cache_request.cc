@@ -19,6 +19,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 #endif
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <thread>
@@ -138,7 +139,7 @@ CacheRowRequest::CacheRowRequest(const CacheClient *cc)
 }
 
 BatchFetchRequest::BatchFetchRequest(const CacheClient *cc, const std::vector<row_id_type> &row_id)
-    : BaseRequest(RequestType::kBatchFetchRows), support_local_bypass_(cc->local_bypass_), row_id_(row_id) {
+    : BaseRequest(RequestType::kBatchFetchRows), cc_(cc), support_local_bypass_(cc->local_bypass_), row_id_(row_id) {
   rq_.set_connection_id(cc->server_connection_id_);
   rq_.set_client_id(cc->client_id_);
   rq_.set_flag(support_local_bypass_ ? kLocalClientSupport : 0);
@@ -152,36 +153,67 @@ BatchFetchRequest::BatchFetchRequest(const CacheClient *cc, const std::vector<ro
   rq_.add_buf_data(fbb.GetBufferPointer(), fbb.GetSize());
 }
 
-Status BatchFetchRequest::RestoreRows(TensorTable *out, const void *baseAddr, int64_t *out_addr) {
+Status BatchFetchRequest::RestoreRows(TensorTable *out) {
   RETURN_UNEXPECTED_IF_NULL(out);
-  auto num_elements = row_id_.size();
-  const char *ptr = nullptr;
-  int64_t sz = 0;
   // Tap into the reply flag to see where we can find the data. Server may decide the amount is
   // so small that it doesn't use shared memory method.
   auto flag = reply_.flag();
   bool dataOnSharedMemory = support_local_bypass_ ? (BitTest(flag, kDataIsInSharedMemory)) : false;
+  bool dataIsCompressed = BitTest(flag, kDataIsCompressed);
   if (dataOnSharedMemory) {
     auto addr = strtoll(reply_.result().data(), nullptr, kDecimal);
-    ptr = reinterpret_cast<const char *>(reinterpret_cast<int64_t>(baseAddr) + addr);
-    RETURN_UNEXPECTED_IF_NULL(out);
-    *out_addr = addr;
-  } else {
-    ptr = reply_.result().data();
-    *out_addr = -1;
+    // The block is given back to the server when the last tensor referring to it goes away, or right after the
+    // restore if no tensor refers to it.
+    std::shared_ptr<MemoryPool> block = cc_->CreateSharedReplyBlock(addr);
+    auto ptr = reinterpret_cast<const char *>(reinterpret_cast<int64_t>(cc_->SharedMemoryBaseAddr()) + addr);
+    return RestoreRows(cc_, row_id_, ptr, dataIsCompressed, block, out);
   }
+  auto num_elements = row_id_.size();
+  auto *offset_array = reinterpret_cast<const int64_t *>(reply_.result().data());
+  CHECK_FAIL_RETURN_UNEXPECTED(reply_.result().length() >= (num_elements + 1) * sizeof(int64_t) &&
+                                 offset_array[num_elements] == reply_.result().length(),
+                               "Length mismatch");
+  return RestoreRows(cc_, row_id_, reply_.result().data(), dataIsCompressed, nullptr, out);
+}
+
+Status BatchFetchRequest::RestoreRows(const CacheClient *cc, const std::vector<row_id_type> &row_id, const char *ptr,
+                                      bool compressed, const std::shared_ptr<MemoryPool> &block, TensorTable *out) {
+  RETURN_UNEXPECTED_IF_NULL(cc);
+  RETURN_UNEXPECTED_IF_NULL(ptr);
+  RETURN_UNEXPECTED_IF_NULL(out);
+  auto num_elements = row_id.size();
+  std::string dict;
   auto *offset_array = reinterpret_cast<const int64_t *>(ptr);
-  sz = offset_array[num_elements];
-  CHECK_FAIL_RETURN_UNEXPECTED(support_local_bypass_ || sz == reply_.result().length(), "Length mismatch");
+  int64_t sz = offset_array[num_elements];
+  // The rows follow the offsets back to back. Validate the offsets before any row is read, whether the reply is
+  // inline or in the shared memory.
+  CHECK_FAIL_RETURN_UNEXPECTED(offset_array[0] == static_cast<int64_t>((num_elements + 1) * sizeof(int64_t)),
+                               "Length mismatch");
+  for (size_t i = 0; i < num_elements; ++i) {
+    CHECK_FAIL_RETURN_UNEXPECTED(offset_array[i] <= offset_array[i + 1], "Length mismatch");
+  }
   TensorTable tbl;
   tbl.reserve(num_elements);
   ReadableSlice all(ptr, sz);
   for (auto i = 0; i < num_elements; ++i) {
     auto len = offset_array[i + 1] - offset_array[i];
     TensorRow row;
-    row.setId(row_id_.at(i));
+    row.setId(row_id.at(i));
     if (len > 0) {
-      ReadableSlice row_data(all, offset_array[i], len);
+      ReadableSlice stored(all, offset_array[i], len);
+      std::string raw;
+      if (compressed) {
+        CompressedRowHeader hdr{};
+        RETURN_IF_NOT_OK(RowCompressor::GetHeader(stored, &hdr));
+        if (hdr.dict_id != 0 && dict.empty()) {
+          RETURN_IF_NOT_OK(cc->GetCompressionDict(&dict));
+        }
+        auto start = std::chrono::steady_clock::now();
+        RETURN_IF_NOT_OK(RowCompressor::Decompress(stored, dict, &raw));
+        auto end = std::chrono::steady_clock::now();
+        cc->decompress_time_us_ += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+      }
+      ReadableSlice row_data = compressed ? ReadableSlice(raw.data(), raw.size()) : stored;
       // Next we de-serialize flat buffer to get back each column
       auto msg = GetTensorRowHeaderMsg(row_data.GetPointer());
       auto msg_sz = msg->size_of_this();
@@ -192,7 +224,8 @@ Status BatchFetchRequest::RestoreRows(TensorTable *out, const void *baseAddr, in
         auto col_ts = msg->column()->Get(k);
         std::shared_ptr<Tensor> ts;
         ReadableSlice data(row_data, ts_offset, msg->data_sz()->Get(k));
-        RETURN_IF_NOT_OK(mindspore::dataset::RestoreOneTensor(col_ts, data, &ts));
+        // The decompressed rows are in a temporary buffer, which can't be referred to.
+        RETURN_IF_NOT_OK(mindspore::dataset::RestoreOneTensor(col_ts, data, &ts, compressed ? nullptr : block));
         row.push_back(ts);
         ts_offset += data.GetSize();
       }
@@ -206,8 +239,14 @@ Status BatchFetchRequest::RestoreRows(TensorTable *out, const void *baseAddr, in
 }
 
 CreateCacheRequest::CreateCacheRequest(CacheClient *cc, const CacheClientInfo &cinfo, uint64_t cache_mem_sz,
-                                       CreateCacheRequest::CreateCacheFlag flag)
-    : BaseRequest(RequestType::kCreateCache), cache_mem_sz_(cache_mem_sz), flag_(flag), cc_(cc) {
+                                       CreateCacheRequest::CreateCacheFlag flag, CacheTierPolicyType tier_policy,
+                                       CacheCompressionType compression)
+    : BaseRequest(RequestType::kCreateCache),
+      cache_mem_sz_(cache_mem_sz),
+      flag_(flag),
+      tier_policy_(tier_policy),
+      compression_(compression),
+      cc_(cc) {
   // Type has been set already in the base constructor. So we need to fill in the connection info.
   // On successful return, we will get the connection id
   rq_.mutable_connection_info()->operator=(cinfo);
@@ -219,6 +258,8 @@ Status CreateCacheRequest::Prepare() {
     CreateCacheRequestMsgBuilder bld(fbb);
     bld.add_cache_mem_sz(cache_mem_sz_);
     bld.add_flag(static_cast<uint32_t>(flag_));
+    bld.add_tier_policy(static_cast<int8_t>(tier_policy_));
+    bld.add_compression(static_cast<int8_t>(compression_));
     auto off = bld.Finish();
     fbb.Finish(off);
     rq_.add_buf_data(fbb.GetBufferPointer(), fbb.GetSize());
@@ -303,6 +344,14 @@ Status GetStatRequest::PostReply() {
   stat_.max_row_id = msg->max_row_id();
   stat_.min_row_id = msg->min_row_id();
   stat_.cache_service_state = msg->state();
+  stat_.num_mem_hit = msg->num_mem_hit();
+  stat_.num_disk_hit = msg->num_disk_hit();
+  stat_.num_miss = msg->num_miss();
+  stat_.num_promoted = msg->num_promoted();
+  stat_.num_evicted = msg->num_evicted();
+  stat_.num_raw_bytes = msg->num_raw_bytes();
+  stat_.num_stored_bytes = msg->num_stored_bytes();
+  stat_.compress_time_us = msg->compress_time_us();
   return Status::OK();
 }
 
@@ -331,6 +380,14 @@ Status ListSessionsRequest::PostReply() {
     stats.min_row_id = current_session_info->stats()->min_row_id();
     stats.max_row_id = current_session_info->stats()->max_row_id();
     stats.cache_service_state = current_session_info->stats()->state();
+    stats.num_mem_hit = current_session_info->stats()->num_mem_hit();
+    stats.num_disk_hit = current_session_info->stats()->num_disk_hit();
+    stats.num_miss = current_session_info->stats()->num_miss();
+    stats.num_promoted = current_session_info->stats()->num_promoted();
+    stats.num_evicted = current_session_info->stats()->num_evicted();
+    stats.num_raw_bytes = current_session_info->stats()->num_raw_bytes();
+    stats.num_stored_bytes = current_session_info->stats()->num_stored_bytes();
+    stats.compress_time_us = current_session_info->stats()->compress_time_us();
     current_info.stats = stats;  // fixed length struct.  = operator is safe
     session_info_list_.push_back(current_info);
   }
@@ -29,7 +29,10 @@
 #endif
 #include "proto/cache_grpc.pb.h"
 #include "minddata/dataset/core/tensor_row.h"
+#include "minddata/dataset/engine/cache/cache_compress.h"
+#include "minddata/dataset/engine/cache/cache_tier_policy.h"
 #include "minddata/dataset/engine/cache/de_tensor_generated.h"
+#include "minddata/dataset/util/memory_pool.h"
 #include "minddata/dataset/util/slice.h"
 #include "minddata/dataset/util/wait_post.h"
 
@@ -45,6 +48,15 @@ struct CacheServiceStat {
   row_id_type min_row_id;
   row_id_type max_row_id;
   int8_t cache_service_state;
+  int64_t num_mem_hit;
+  int64_t num_disk_hit;
+  int64_t num_miss;
+  int64_t num_promoted;
+  int64_t num_evicted;
+  int64_t num_raw_bytes;
+  int64_t num_stored_bytes;
+  int64_t compress_time_us;
+  int64_t decompress_time_us;  // filled in by the client
 };
 
 struct CacheServerCfgInfo {
@@ -87,6 +99,8 @@ class BaseRequest {
     kBatchCacheRows = 19,
     kInternalCacheRow = 20,
     kGetCacheState = 21,
+    kFetchCompressionDict = 22,
+    kRegisterFetchRing = 23,
     // Add new request before it.
     kRequestUnknown = 32767
   };
@@ -148,7 +162,8 @@ class BaseRequest {
            type_ == RequestType::kCacheSchema || type_ == RequestType::kFetchSchema ||
            type_ == RequestType::kBuildPhaseDone || type_ == RequestType::kToggleWriteMode ||
            type_ == RequestType::kConnectReset || type_ == RequestType::kStopService ||
-           type_ == RequestType::kHeartBeat || type_ == RequestType::kGetCacheMissKeys;
+           type_ == RequestType::kHeartBeat || type_ == RequestType::kGetCacheMissKeys ||
+           type_ == RequestType::kFetchCompressionDict || type_ == RequestType::kRegisterFetchRing;
   }
 
   /// \brief Return if the request is of session request type
@@ -233,9 +248,28 @@ class BatchFetchRequest : public BaseRequest {
   friend class CacheService;
   BatchFetchRequest(const CacheClient *cc, const std::vector<row_id_type> &row_id);
   ~BatchFetchRequest() override = default;
-  Status RestoreRows(TensorTable *out, const void *baseAddr, int64_t *out_addr);
+
+  /// \brief Restore the rows from the reply. A reply in the shared memory is given back to the server after all the
+  /// tensors referring to it are destroyed.
+  /// \param out The restored rows
+  /// \return Status object
+  Status RestoreRows(TensorTable *out);
+
+  /// \brief Restore the rows from the memory in the layout of a BatchFetch reply, i.e. an array of offsets followed
+  /// by the rows.
+  /// \param cc The CacheClient which fetches the rows
+  /// \param row_id The ids of the rows
+  /// \param ptr Start of the reply
+  /// \param compressed If the rows are compressed
+  /// \param block If not null, the memory is a shared memory block owned by it, and the uncompressed tensors refer to
+  /// the block instead of copying it
+  /// \param out The restored rows
+  /// \return Status object
+  static Status RestoreRows(const CacheClient *cc, const std::vector<row_id_type> &row_id, const char *ptr,
+                            bool compressed, const std::shared_ptr<MemoryPool> &block, TensorTable *out);
 
  private:
+  const CacheClient *cc_;
   bool support_local_bypass_;
   std::vector<row_id_type> row_id_;
 };
@@ -250,8 +284,12 @@ class CreateCacheRequest : public BaseRequest {
   /// \param connection_id
   /// \param cache_mem_sz Maximum memory assigned for this connection. 0 means unlimited
   /// \param flag Attributes of the cache.
+  /// \param tier_policy Promotion/eviction policy between memory and disk. Only used with kSpillToDisk.
+  /// \param compression Compression of the cached rows
   explicit CreateCacheRequest(CacheClient *cc, const CacheClientInfo &cinfo, uint64_t cache_mem_sz,
-                              CreateCacheFlag flag = CreateCacheFlag::kNone);
+                              CreateCacheFlag flag = CreateCacheFlag::kNone,
+                              CacheTierPolicyType tier_policy = CacheTierPolicyType::kNone,
+                              CacheCompressionType compression = CacheCompressionType::kNone);
   ~CreateCacheRequest() override = default;
 
   /// Overload the base class Prepare/PostReply
@@ -261,6 +299,8 @@ class CreateCacheRequest : public BaseRequest {
  private:
   uint64_t cache_mem_sz_;
   CreateCacheFlag flag_;
+  CacheTierPolicyType tier_policy_;
+  CacheCompressionType compression_;
   CacheClient *cc_;
 };
 
@@ -356,6 +396,19 @@ class FetchSchemaRequest : public BaseRequest {
   std::unordered_map<std::string, int32_t> column_name_id_map_;
 };
 
+/// \brief Request to fetch the dictionary the rows of a cache are compressed with
+class FetchCompressionDictRequest : public BaseRequest {
+ public:
+  friend class CacheServer;
+  explicit FetchCompressionDictRequest(connection_id_type connection_id)
+      : BaseRequest(RequestType::kFetchCompressionDict) {
+    rq_.set_connection_id(connection_id);
+  }
+  ~FetchCompressionDictRequest() override = default;
+
+  const std::string &GetDictionary() const { return reply_.result(); }
+};
+
 /// \brief Request to change a cache from build phase to read phase. Applies to non-mappable cache only.
 class BuildPhaseDoneRequest : public BaseRequest {
  public:
@@ -451,6 +504,20 @@ class AllocateSharedBlockRequest : public BaseRequest {
   }
 };
 
+/// \brief Request to register a fetch ring in the shared memory, which the server then polls for BatchFetch requests.
+/// \see CacheFetchRing
+class RegisterFetchRingRequest : public BaseRequest {
+ public:
+  friend class CacheServer;
+  explicit RegisterFetchRingRequest(connection_id_type connection_id, int32_t client_id, int64_t addr)
+      : BaseRequest(RequestType::kRegisterFetchRing) {
+    rq_.set_connection_id(connection_id);
+    rq_.add_buf_data(std::to_string(addr));
+    rq_.set_client_id(client_id);
+  }
+  ~RegisterFetchRingRequest() override = default;
+};
+
 class ToggleWriteModeRequest : public BaseRequest {
  public:
   friend class CacheServer;
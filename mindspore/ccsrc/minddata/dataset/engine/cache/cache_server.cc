@@ -17,8 +17,10 @@
 #include <algorithm>
 #include <functional>
 #include <limits>
+#include <map>
 #include <vector>
 #include "minddata/dataset/include/dataset/constants.h"
+#include "minddata/dataset/engine/cache/cache_fetch_ring.h"
 #include "minddata/dataset/engine/cache/cache_ipc.h"
 #include "minddata/dataset/engine/cache/cache_service.h"
 #include "minddata/dataset/engine/cache/cache_request.h"
@@ -80,6 +82,13 @@ Status CacheServer::DoServiceStart() {
   // after we have created the unix socket.
   auto inotify_f = std::bind(&CacheServerGreeterImpl::MonitorUnixSocket, comm_layer_.get());
   RETURN_IF_NOT_OK(vg_.CreateAsyncTask("Monitor unix socket", inotify_f));
+  // The local clients post the BatchFetch requests to the rings in the shared memory instead of using gRPC.
+  fetch_ring_q_ = std::make_unique<Queue<FetchRingTask>>(kQueCapacity);
+  RETURN_IF_NOT_OK(fetch_ring_q_->Register(&vg_));
+  RETURN_IF_NOT_OK(vg_.CreateAsyncTask("Fetch ring poller", std::bind(&CacheServer::FetchRingPoller, this)));
+  for (auto i = 0; i < kNumFetchRingWorkers; ++i) {
+    RETURN_IF_NOT_OK(vg_.CreateAsyncTask("Fetch ring worker", std::bind(&CacheServer::FetchRingWorker, this)));
+  }
 #endif
   // Spawn a few threads to serve the real request.
   auto f = std::bind(&CacheServer::ServerRequest, this, std::placeholders::_1);
@@ -204,6 +213,8 @@ Status CacheServer::CreateService(CacheRequest *rq, CacheReply *reply) {
   auto p = flatbuffers::GetRoot<CreateCacheRequestMsg>(create_cache_buf.data());
   auto flag = static_cast<CreateCacheRequest::CreateCacheFlag>(p->flag());
   auto cache_mem_sz = p->cache_mem_sz();
+  auto tier_policy = static_cast<CacheTierPolicyType>(p->tier_policy());
+  auto compression = static_cast<CacheCompressionType>(p->compression());
   // We can't do spilling unless this server is setup with a spill path in the first place
   bool spill =
     (flag & CreateCacheRequest::CreateCacheFlag::kSpillToDisk) == CreateCacheRequest::CreateCacheFlag::kSpillToDisk;
@@ -233,7 +244,7 @@ Status CacheServer::CreateService(CacheRequest *rq, CacheReply *reply) {
     RETURN_IF_NOT_OK(GlobalMemoryCheck(cache_mem_sz));
     std::unique_ptr<CacheService> cs;
     try {
-      cs = std::make_unique<CacheService>(cache_mem_sz, spill ? top_ : "", generate_id);
+      cs = std::make_unique<CacheService>(cache_mem_sz, spill ? top_ : "", generate_id, tier_policy, compression);
       RETURN_IF_NOT_OK(cs->ServiceStart());
       cookie = cs->cookie();
       client_id = cs->num_clients_.fetch_add(1);
@@ -410,9 +421,10 @@ Status CacheServer::InternalFetchRow(CacheRequest *rq) {
     std::string errMsg = "Connection " + std::to_string(connection_id) + " not found";
     return Status(StatusCode::kMDUnexpectedError, __LINE__, __FILE__, errMsg);
   }
-  // First piece is a flatbuffer containing row fetch information, second piece is the address of the BatchWait ptr
+  // First piece is a flatbuffer containing the fetch information of a group of rows, second piece is the address of
+  // the BatchWait ptr
   enum BufDataIndex : uint8_t { kFetchRowMsg = 0, kBatchWait = 1 };
-  rc = cs->InternalFetchRow(flatbuffers::GetRoot<FetchRowMsg>(rq->buf_data(BufDataIndex::kFetchRowMsg).data()));
+  rc = cs->InternalFetchRow(flatbuffers::GetRoot<BatchFetchRowMsg>(rq->buf_data(BufDataIndex::kFetchRowMsg).data()));
   // This is an internal request and is not tied to rpc. But need to post because there
   // is a thread waiting on the completion of this request.
   try {
@@ -434,48 +446,77 @@ Status CacheServer::BatchFetch(const std::shared_ptr<flatbuffers::FlatBufferBuil
   auto p = flatbuffers::GetRoot<BatchDataLocatorMsg>(fbb->GetBufferPointer());
   const auto num_elements = p->rows()->size();
   auto connection_id = p->connection_id();
-  auto batch_wait = std::make_shared<BatchWait>(num_elements);
   int64_t data_offset = (num_elements + 1) * sizeof(int64_t);
   auto *offset_array = reinterpret_cast<int64_t *>(out->GetMutablePointer());
   offset_array[0] = data_offset;
+  // Lay out the rows and gather them by the worker (at some numa node) that is going to fetch them. Each worker
+  // gets one internal request for all of its rows rather than one request per row.
+  std::map<worker_id_t, std::vector<uint32_t>> rows_by_worker;
   for (uint32_t i = 0; i < num_elements; ++i) {
     auto data_locator = p->rows()->Get(i);
-    auto node_id = data_locator->node_id();
     size_t sz = data_locator->size();
-    void *source_addr = reinterpret_cast<void *>(data_locator->addr());
-    auto key = data_locator->key();
     // Please read the comment in CacheServer::BatchFetchRows where we allocate
     // the buffer big enough so each thread (which we are going to dispatch) will
-    // not run into false sharing problem. We are going to round up sz to 4k.
-    auto sz_4k = round_up_4K(sz);
-    offset_array[i + 1] = offset_array[i] + sz_4k;
+    // not run into false sharing problem.
+    offset_array[i + 1] = offset_array[i] + round_up_fetch_row(sz);
     if (sz > 0) {
+      worker_id_t worker_id = IsNumaAffinityOn() ? GetWorkerByNumaId(data_locator->node_id()) : GetRandomWorker();
+      rows_by_worker[worker_id].push_back(i);
+    }
+  }
+  auto build_msg = [&p, &out, &offset_array](const std::vector<uint32_t> &rows, flatbuffers::FlatBufferBuilder *fb2) {
+    std::vector<flatbuffers::Offset<FetchRowMsg>> row_v;
+    row_v.reserve(rows.size());
+    for (auto i : rows) {
+      auto data_locator = p->rows()->Get(i);
+      size_t sz = data_locator->size();
       WritableSlice row_data(*out, offset_array[i], sz);
-      // Get a request and send to the proper worker (at some numa node) to do the fetch.
-      worker_id_t worker_id = IsNumaAffinityOn() ? GetWorkerByNumaId(node_id) : GetRandomWorker();
-      CacheServerRequest *cache_rq;
-      RETURN_IF_NOT_OK(GetFreeRequestTag(&cache_rq));
-      // Set up all the necessarily field.
-      cache_rq->type_ = BaseRequest::RequestType::kInternalFetchRow;
-      cache_rq->st_ = CacheServerRequest::STATE::PROCESS;
-      cache_rq->rq_.set_connection_id(connection_id);
-      cache_rq->rq_.set_type(static_cast<int16_t>(cache_rq->type_));
-      auto dest_addr = row_data.GetMutablePointer();
-      flatbuffers::FlatBufferBuilder fb2;
-      FetchRowMsgBuilder bld(fb2);
-      bld.add_key(key);
+      FetchRowMsgBuilder bld(*fb2);
+      bld.add_key(data_locator->key());
       bld.add_size(sz);
-      bld.add_source_addr(reinterpret_cast<int64_t>(source_addr));
-      bld.add_dest_addr(reinterpret_cast<int64_t>(dest_addr));
-      auto offset = bld.Finish();
-      fb2.Finish(offset);
-      cache_rq->rq_.add_buf_data(fb2.GetBufferPointer(), fb2.GetSize());
-      cache_rq->rq_.add_buf_data(std::to_string(reinterpret_cast<int64_t>(batch_wait.get())));
-      RETURN_IF_NOT_OK(PushRequest(worker_id, cache_rq));
-    } else {
-      // Nothing to fetch but we still need to post something back into the wait area.
-      RETURN_IF_NOT_OK(batch_wait->Set(Status::OK()));
+      bld.add_source_addr(data_locator->addr());
+      bld.add_dest_addr(reinterpret_cast<int64_t>(row_data.GetMutablePointer()));
+      row_v.push_back(bld.Finish());
+    }
+    auto rows_offset = fb2->CreateVector(row_v);
+    BatchFetchRowMsgBuilder bld(*fb2);
+    bld.add_rows(rows_offset);
+    fb2->Finish(bld.Finish());
+  };
+  if (rows_by_worker.empty()) {
+    return Status::OK();
+  }
+  // For a small batch, copy everything ourselves. A round trip to the workers costs more than the copy.
+  if (offset_array[num_elements] - data_offset < kInlineFetchThreshold) {
+    std::vector<uint32_t> all_rows;
+    all_rows.reserve(num_elements);
+    for (auto &group : rows_by_worker) {
+      all_rows.insert(all_rows.end(), group.second.begin(), group.second.end());
+    }
+    flatbuffers::FlatBufferBuilder fb2;
+    build_msg(all_rows, &fb2);
+    SharedLock lck(&rwLock_);
+    CacheService *cs = GetService(connection_id);
+    if (cs == nullptr) {
+      std::string errMsg = "Connection " + std::to_string(connection_id) + " not found";
+      return Status(StatusCode::kMDUnexpectedError, __LINE__, __FILE__, errMsg);
     }
+    return cs->InternalFetchRow(flatbuffers::GetRoot<BatchFetchRowMsg>(fb2.GetBufferPointer()));
+  }
+  auto batch_wait = std::make_shared<BatchWait>(rows_by_worker.size());
+  for (auto &group : rows_by_worker) {
+    CacheServerRequest *cache_rq;
+    RETURN_IF_NOT_OK(GetFreeRequestTag(&cache_rq));
+    // Set up all the necessarily field.
+    cache_rq->type_ = BaseRequest::RequestType::kInternalFetchRow;
+    cache_rq->st_ = CacheServerRequest::STATE::PROCESS;
+    cache_rq->rq_.set_connection_id(connection_id);
+    cache_rq->rq_.set_type(static_cast<int16_t>(cache_rq->type_));
+    flatbuffers::FlatBufferBuilder fb2;
+    build_msg(group.second, &fb2);
+    cache_rq->rq_.add_buf_data(fb2.GetBufferPointer(), fb2.GetSize());
+    cache_rq->rq_.add_buf_data(std::to_string(reinterpret_cast<int64_t>(batch_wait.get())));
+    RETURN_IF_NOT_OK(PushRequest(group.first, cache_rq));
   }
   // Now wait for all of them to come back.
   RETURN_IF_NOT_OK(batch_wait->Wait());
@@ -484,76 +525,98 @@ Status CacheServer::BatchFetch(const std::shared_ptr<flatbuffers::FlatBufferBuil
 }
 
 Status CacheServer::BatchFetchRows(CacheRequest *rq, CacheReply *reply) {
-  auto connection_id = rq->connection_id();
-  auto client_id = rq->client_id();
+  CHECK_FAIL_RETURN_UNEXPECTED(!rq->buf_data().empty(), "Missing row id");
+  auto &row_id_buf = rq->buf_data(0);
+  auto p = flatbuffers::GetRoot<TensorRowIds>(row_id_buf.data());
+  std::vector<row_id_type> row_id;
+  auto sz = p->row_id()->size();
+  row_id.reserve(sz);
+  for (uint32_t i = 0; i < sz; ++i) {
+    row_id.push_back(p->row_id()->Get(i));
+  }
+  // For large amount data to be sent back, we will use shared memory provided it is a local
+  // client that has local bypass support
+  bool local_client = BitTest(rq->flag(), kLocalClientSupport);
+  return FetchRows(rq->connection_id(), local_client ? rq->client_id() : -1, row_id, kLocalByPassThreshold, reply);
+}
+
+Status CacheServer::FetchRows(connection_id_type connection_id, int32_t client_id,
+                              const std::vector<row_id_type> &row_id, int64_t shm_threshold, CacheReply *reply) {
+  RETURN_UNEXPECTED_IF_NULL(reply);
   // Hold the shared lock to prevent the cache from being dropped.
   SharedLock lck(&rwLock_);
   CacheService *cs = GetService(connection_id);
   if (cs == nullptr) {
     std::string errMsg = "Cache id " + std::to_string(connection_id) + " not found";
     return Status(StatusCode::kMDUnexpectedError, __LINE__, __FILE__, errMsg);
-  } else {
-    CHECK_FAIL_RETURN_UNEXPECTED(!rq->buf_data().empty(), "Missing row id");
-    auto &row_id_buf = rq->buf_data(0);
-    auto p = flatbuffers::GetRoot<TensorRowIds>(row_id_buf.data());
-    std::vector<row_id_type> row_id;
-    auto sz = p->row_id()->size();
-    row_id.reserve(sz);
-    for (uint32_t i = 0; i < sz; ++i) {
-      row_id.push_back(p->row_id()->Get(i));
+  }
+  auto sz = row_id.size();
+  std::shared_ptr<flatbuffers::FlatBufferBuilder> fbb = std::make_shared<flatbuffers::FlatBufferBuilder>();
+  RETURN_IF_NOT_OK(cs->PreBatchFetch(connection_id, row_id, fbb));
+  bool compressed = cs->cp_->CompressionEnabled();
+  // Let go of the shared lock. We don't need to interact with the CacheService anymore.
+  // We shouldn't be holding any lock while we can wait for a long time for the rows to come back.
+  lck.Unlock();
+  auto locator = flatbuffers::GetRoot<BatchDataLocatorMsg>(fbb->GetBufferPointer());
+  int64_t mem_sz = sizeof(int64_t) * (sz + 1);
+  for (auto i = 0; i < sz; ++i) {
+    auto row_sz = locator->rows()->Get(i)->size();
+    // row_sz is the size of the cached data. Later we will spawn multiple threads
+    // each of which will copy the data into either shared memory or protobuf concurrently but
+    // to different region.
+    // To avoid false sharing, we will bump up row_sz to be a multiple of kFetchRowAlignment
+    row_sz = round_up_fetch_row(row_sz);
+    mem_sz += row_sz;
+  }
+  bool local_bypass = client_id != -1 && mem_sz >= shm_threshold;
+  void *q = nullptr;
+  if (local_bypass) {
+    Status rc = AllocateSharedMemory(client_id, mem_sz, &q);
+    // The tensors of a client refer to its earlier replies until they are destroyed. Rather than failing the
+    // fetch when the shared memory runs out, we send the rows inline.
+    if (rc == StatusCode::kMDOutOfMemory) {
+      MS_LOG(INFO) << "Out of shared memory for client " << client_id << ". Reply " << mem_sz << " bytes inline.";
+      local_bypass = false;
+    } else if (rc.IsError()) {
+      return rc;
     }
-    std::shared_ptr<flatbuffers::FlatBufferBuilder> fbb = std::make_shared<flatbuffers::FlatBufferBuilder>();
-    RETURN_IF_NOT_OK(cs->PreBatchFetch(connection_id, row_id, fbb));
-    // Let go of the shared lock. We don't need to interact with the CacheService anymore.
-    // We shouldn't be holding any lock while we can wait for a long time for the rows to come back.
-    lck.Unlock();
-    auto locator = flatbuffers::GetRoot<BatchDataLocatorMsg>(fbb->GetBufferPointer());
-    int64_t mem_sz = sizeof(int64_t) * (sz + 1);
-    for (auto i = 0; i < sz; ++i) {
-      auto row_sz = locator->rows()->Get(i)->size();
-      // row_sz is the size of the cached data. Later we will spawn multiple threads
-      // each of which will copy the data into either shared memory or protobuf concurrently but
-      // to different region.
-      // To avoid false sharing, we will bump up row_sz to be a multiple of 4k, i.e. 4096 bytes
-      row_sz = round_up_4K(row_sz);
-      mem_sz += row_sz;
+  }
+  uint32_t reply_flag = 0;
+  if (local_bypass) {
+    BitSet(&reply_flag, kDataIsInSharedMemory);
+  }
+  // The rows are sent as they are stored. It is up to the client to decompress them.
+  if (compressed) {
+    BitSet(&reply_flag, kDataIsCompressed);
+  }
+  reply->set_flag(reply_flag);
+  if (local_bypass) {
+    // We will use shared memory
+    auto *base = SharedMemoryBaseAddr();
+    WritableSlice dest(q, mem_sz);
+    Status rc = BatchFetch(fbb, &dest);
+    if (rc.IsError()) {
+      DeallocateSharedMemory(client_id, q);
+      return rc;
     }
-    auto client_flag = rq->flag();
-    bool local_client = BitTest(client_flag, kLocalClientSupport);
-    // For large amount data to be sent back, we will use shared memory provided it is a local
-    // client that has local bypass support
-    bool local_bypass = local_client ? (mem_sz >= kLocalByPassThreshold) : false;
-    reply->set_flag(local_bypass ? kDataIsInSharedMemory : 0);
-    if (local_bypass) {
-      // We will use shared memory
-      auto *base = SharedMemoryBaseAddr();
-      void *q = nullptr;
-      RETURN_IF_NOT_OK(AllocateSharedMemory(client_id, mem_sz, &q));
-      WritableSlice dest(q, mem_sz);
-      Status rc = BatchFetch(fbb, &dest);
-      if (rc.IsError()) {
-        DeallocateSharedMemory(client_id, q);
-        return rc;
-      }
-      // We can't return the absolute address which makes no sense to the client.
-      // Instead we return the difference.
-      auto difference = reinterpret_cast<int64_t>(q) - reinterpret_cast<int64_t>(base);
-      reply->set_result(std::to_string(difference));
-    } else {
-      // We are going to use std::string to allocate and hold the result which will be eventually
-      // 'moved' to the protobuf message (which underneath is also a std::string) for the purpose
-      // to minimize memory copy.
-      std::string mem;
-      try {
-        mem.resize(mem_sz);
-        CHECK_FAIL_RETURN_UNEXPECTED(mem.capacity() >= mem_sz, "Programming error");
-      } catch (const std::bad_alloc &e) {
-        return Status(StatusCode::kMDOutOfMemory);
-      }
-      WritableSlice dest(mem.data(), mem_sz);
-      RETURN_IF_NOT_OK(BatchFetch(fbb, &dest));
-      reply->set_result(std::move(mem));
+    // We can't return the absolute address which makes no sense to the client.
+    // Instead we return the difference.
+    auto difference = reinterpret_cast<int64_t>(q) - reinterpret_cast<int64_t>(base);
+    reply->set_result(std::to_string(difference));
+  } else {
+    // We are going to use std::string to allocate and hold the result which will be eventually
+    // 'moved' to the protobuf message (which underneath is also a std::string) for the purpose
+    // to minimize memory copy.
+    std::string mem;
+    try {
+      mem.resize(mem_sz);
+      CHECK_FAIL_RETURN_UNEXPECTED(mem.capacity() >= mem_sz, "Programming error");
+    } catch (const std::bad_alloc &e) {
+      return Status(StatusCode::kMDOutOfMemory);
     }
+    WritableSlice dest(mem.data(), mem_sz);
+    RETURN_IF_NOT_OK(BatchFetch(fbb, &dest));
+    reply->set_result(std::move(mem));
   }
   return Status::OK();
 }
@@ -578,6 +641,14 @@ Status CacheServer::GetStat(CacheRequest *rq, CacheReply *reply) {
     bld.add_max_row_id(svc_stat.stat_.max_key);
     bld.add_min_row_id(svc_stat.stat_.min_key);
     bld.add_state(svc_stat.state_);
+    bld.add_num_mem_hit(svc_stat.stat_.num_mem_hit);
+    bld.add_num_disk_hit(svc_stat.stat_.num_disk_hit);
+    bld.add_num_miss(svc_stat.stat_.num_miss);
+    bld.add_num_promoted(svc_stat.stat_.num_promoted);
+    bld.add_num_evicted(svc_stat.stat_.num_evicted);
+    bld.add_num_raw_bytes(svc_stat.stat_.num_raw_bytes);
+    bld.add_num_stored_bytes(svc_stat.stat_.num_stored_bytes);
+    bld.add_compress_time_us(svc_stat.stat_.compress_time_us);
     auto offset = bld.Finish();
     fbb.Finish(offset);
     reply->set_result(fbb.GetBufferPointer(), fbb.GetSize());
@@ -620,6 +691,21 @@ Status CacheServer::FetchSchema(CacheRequest *rq, CacheReply *reply) {
   return Status::OK();
 }
 
+Status CacheServer::FetchCompressionDict(CacheRequest *rq, CacheReply *reply) {
+  auto connection_id = rq->connection_id();
+  // Hold the shared lock to prevent the cache from being dropped.
+  SharedLock lck(&rwLock_);
+  CacheService *cs = GetService(connection_id);
+  if (cs == nullptr) {
+    std::string errMsg = "Connection " + std::to_string(connection_id) + " not found";
+    return Status(StatusCode::kMDUnexpectedError, __LINE__, __FILE__, errMsg);
+  }
+  std::string mem;
+  RETURN_IF_NOT_OK(cs->FetchCompressionDict(&mem));
+  reply->set_result(std::move(mem));
+  return Status::OK();
+}
+
 Status CacheServer::BuildPhaseDone(CacheRequest *rq) {
   auto connection_id = rq->connection_id();
   // Hold the shared lock to prevent the cache from being dropped.
@@ -711,7 +797,11 @@ Status CacheServer::ListSessions(CacheReply *reply) {
         RETURN_IF_NOT_OK(cs->GetStat(&svc_stat));
         auto current_stats = CreateServiceStatMsg(fbb, svc_stat.stat_.num_mem_cached, svc_stat.stat_.num_disk_cached,
                                                   svc_stat.stat_.average_cache_sz, svc_stat.stat_.num_numa_hit,
-                                                  svc_stat.stat_.min_key, svc_stat.stat_.max_key, svc_stat.state_);
+                                                  svc_stat.stat_.min_key, svc_stat.stat_.max_key, svc_stat.state_,
+                                                  svc_stat.stat_.num_mem_hit, svc_stat.stat_.num_disk_hit,
+                                                  svc_stat.stat_.num_miss, svc_stat.stat_.num_promoted,
+                                                  svc_stat.stat_.num_evicted, svc_stat.stat_.num_raw_bytes,
+                                                  svc_stat.stat_.num_stored_bytes, svc_stat.stat_.compress_time_us);
         auto current_session_info = CreateListSessionMsg(fbb, current_session_id, current_conn_id, current_stats);
         session_msgs_vector.push_back(current_session_info);
       }
@@ -893,6 +983,10 @@ Status CacheServer::ProcessAdminRequest(CacheServerRequest *cache_req) {
       cache_req->rc_ = FetchSchema(&rq, &reply);
       break;
     }
+    case BaseRequest::RequestType::kFetchCompressionDict: {
+      cache_req->rc_ = FetchCompressionDict(&rq, &reply);
+      break;
+    }
     case BaseRequest::RequestType::kBuildPhaseDone: {
       cache_req->rc_ = BuildPhaseDone(&rq);
       break;
@@ -905,6 +999,10 @@ Status CacheServer::ProcessAdminRequest(CacheServerRequest *cache_req) {
       cache_req->rc_ = FreeSharedMemory(&rq);
       break;
     }
+    case BaseRequest::RequestType::kRegisterFetchRing: {
+      cache_req->rc_ = RegisterFetchRing(&rq);
+      break;
+    }
     case BaseRequest::RequestType::kStopService: {
       // This command shutdowns everything.
       // But we first reply back to the client that we receive the request.
@@ -1143,6 +1241,100 @@ Status CacheServer::FreeSharedMemory(CacheRequest *rq) {
   return Status::OK();
 }
 
+Status CacheServer::RegisterFetchRing(CacheRequest *rq) {
+  auto client_id = rq->client_id();
+  CHECK_FAIL_RETURN_UNEXPECTED(client_id != -1, "Client ID not set");
+  CHECK_FAIL_RETURN_UNEXPECTED(!rq->buf_data().empty(), "Missing fetch ring address");
+  CHECK_FAIL_RETURN_UNEXPECTED(shm_ != nullptr, "Shared memory is not available");
+  auto *base = SharedMemoryBaseAddr();
+  try {
+    auto addr = strtoll(rq->buf_data(0).data(), nullptr, kDecimal);
+    auto p = reinterpret_cast<void *>(reinterpret_cast<int64_t>(base) + addr);
+    std::unique_lock<std::mutex> lck(fetch_ring_mux_);
+    fetch_rings_.push_back({rq->connection_id(), client_id, p});
+  } catch (const std::exception &e) {
+    RETURN_STATUS_UNEXPECTED(e.what());
+  }
+  MS_LOG(INFO) << "Client id " << client_id << " registers a fetch ring";
+  return Status::OK();
+}
+
+Status CacheServer::FetchRingPoller() {
+  TaskManager::FindMe()->Post();
+  int32_t sleep_us = 1;
+  std::vector<FetchRingInfo> rings;
+  std::vector<row_id_type> row_id;
+  while (!global_shutdown_) {
+    RETURN_IF_INTERRUPTED();
+    {
+      std::unique_lock<std::mutex> lck(fetch_ring_mux_);
+      // A closed ring is given back to the arena. So is the ring of a destroyed cache, whose client may be gone
+      // without closing it. But not until the fetch workers are done with its slots.
+      auto it = std::remove_if(fetch_rings_.begin(), fetch_rings_.end(), [this](const FetchRingInfo &info) {
+        SharedLock cache_lck(&rwLock_);
+        CacheFetchRing ring(info.addr);
+        if ((ring.IsClosed() || GetService(info.connection_id) == nullptr) && !ring.IsServing()) {
+          DeallocateSharedMemory(info.client_id, info.addr);
+          return true;
+        }
+        return false;
+      });
+      (void)fetch_rings_.erase(it, fetch_rings_.end());
+      rings = fetch_rings_;
+    }
+    // Claim the slots of the rings in turn, so the clients are served in the order they post.
+    int32_t num_claimed = 0;
+    for (int32_t slot = 0; slot < CacheFetchRing::kNumSlots; ++slot) {
+      for (auto &info : rings) {
+        CacheFetchRing ring(info.addr);
+        if (ring.IsClosed() || !ring.Claim(slot, &row_id)) {
+          continue;
+        }
+        RETURN_IF_NOT_OK(fetch_ring_q_->EmplaceBack(FetchRingTask{info, slot, std::move(row_id)}));
+        row_id.clear();
+        ++num_claimed;
+      }
+    }
+    // Back off while the rings are idle, but pick up a busy ring again right away.
+    if (num_claimed > 0) {
+      sleep_us = 1;
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+      sleep_us = std::min(sleep_us * 2, CacheFetchRing::kMaxSleepUs);
+    }
+  }
+  return Status::OK();
+}
+
+Status CacheServer::FetchRingWorker() {
+  TaskManager::FindMe()->Post();
+  auto *base = SharedMemoryBaseAddr();
+  while (!global_shutdown_) {
+    FetchRingTask task;
+    RETURN_IF_NOT_OK(fetch_ring_q_->PopFront(&task));
+    CacheReply reply;
+    int64_t addr = -1;
+    uint32_t flag = 0;
+    Status rc = FetchRows(task.ring.connection_id, task.ring.client_id, task.row_id, 0, &reply);
+    // Without shared memory the client has to fetch the rows again through gRPC.
+    if (rc.IsOk() && !BitTest(reply.flag(), kDataIsInSharedMemory)) {
+      rc = Status(StatusCode::kMDOutOfMemory, __LINE__, __FILE__, "Out of shared memory");
+    }
+    if (rc.IsOk()) {
+      addr = strtoll(reply.result().data(), nullptr, kDecimal);
+      flag = reply.flag();
+    } else {
+      MS_LOG(INFO) << "Fetch ring slot " << task.slot << " is sent back to gRPC. " << rc;
+    }
+    CacheFetchRing ring(task.ring.addr);
+    // The client has timed out, and the block is freed here since no one else knows it.
+    if (!ring.Complete(task.slot, rc, addr, flag) && addr != -1) {
+      DeallocateSharedMemory(task.ring.client_id, reinterpret_cast<void *>(reinterpret_cast<int64_t>(base) + addr));
+    }
+  }
+  return Status::OK();
+}
+
 Status CacheServer::GetCacheState(CacheRequest *rq, CacheReply *reply) {
   auto connection_id = rq->connection_id();
   SharedLock lck(&rwLock_);
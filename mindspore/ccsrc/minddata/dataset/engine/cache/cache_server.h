@@ -298,6 +298,23 @@ class CacheServer : public Service {
   bool numa_affinity_;
   std::vector<int32_t> shutdown_qIDs_;
   std::unique_ptr<CachedSharedMemory> shm_;
+  /// The fetch rings registered by the local clients, which are polled by a dedicated thread. The thread only claims
+  /// the posted slots, and a few fetch workers fetch their rows, so a slow fetch of one client doesn't hold up the
+  /// slots of the others.
+  struct FetchRingInfo {
+    connection_id_type connection_id;
+    int32_t client_id;
+    void *addr;
+  };
+  struct FetchRingTask {
+    FetchRingInfo ring;
+    int32_t slot;
+    std::vector<row_id_type> row_id;
+  };
+  static constexpr int32_t kNumFetchRingWorkers = 4;
+  std::mutex fetch_ring_mux_;
+  std::vector<FetchRingInfo> fetch_rings_;
+  std::unique_ptr<Queue<FetchRingTask>> fetch_ring_q_;
 
   /// \brief Constructor
   /// \param spill_path Top directory for spilling buffers to.
@@ -361,6 +378,19 @@ class CacheServer : public Service {
   /// \return Status object
   Status FreeSharedMemory(CacheRequest *rq);
 
+  /// \brief Handle kRegisterFetchRing request
+  /// \param rq
+  /// \return Status object
+  Status RegisterFetchRing(CacheRequest *rq);
+
+  /// \brief Loop of the thread which claims the posted slots of the fetch rings of the local clients
+  /// \return Status object
+  Status FetchRingPoller();
+
+  /// \brief Loop of the threads which fetch the rows of the claimed slots of the fetch rings
+  /// \return Status object
+  Status FetchRingWorker();
+
   /// \brief Handle CacheRow request
   /// \note There are two different implementation depends if shared memory is used for transportation.
   /// \return Status object
@@ -390,6 +420,12 @@ class CacheServer : public Service {
   /// \return Status object
   Status FetchSchema(CacheRequest *rq, CacheReply *reply);
 
+  /// \brief Fetch the dictionary the rows of a cache are compressed with
+  /// \param rq
+  /// \param reply
+  /// \return Status object
+  Status FetchCompressionDict(CacheRequest *rq, CacheReply *reply);
+
   /// \brief Mark Build phase done (for non-mappable case)
   /// \param rq
   /// \return Status object
@@ -469,6 +505,17 @@ class CacheServer : public Service {
   /// \return Status object
   Status BatchFetchRows(CacheRequest *rq, CacheReply *reply);
 
+  /// \brief Fetch rows in batch into the reply. The rows are put in the shared memory of the client instead if it
+  /// is a local client and the amount of bytes reaches the threshold, and the relative address is set as the result.
+  /// \param[in] connection_id Connection id of the cache
+  /// \param[in] client_id Client id, or -1 if it is not a local client
+  /// \param[in] row_id A vector of row id
+  /// \param[in] shm_threshold Minimum amount of bytes to use the shared memory
+  /// \param[out] reply Reply
+  /// \return Status object
+  Status FetchRows(connection_id_type connection_id, int32_t client_id, const std::vector<row_id_type> &row_id,
+                   int64_t shm_threshold, CacheReply *reply);
+
   /// \brief Main function to fetch rows in batch. The output is a contiguous memory which will be decoded
   /// by the CacheClient. Cache miss is not an error, and will be coded in the output to mark an empty row.
   /// \param[in] v A vector of row id.
@@ -22,12 +22,16 @@
 
 namespace mindspore {
 namespace dataset {
-CacheService::CacheService(uint64_t mem_sz, const std::string &root, bool generate_id)
-    : root_(root),
+CacheService::CacheService(uint64_t mem_sz, const std::string &root, bool generate_id,
+                           CacheTierPolicyType tier_policy, CacheCompressionType compression)
+    : rw_lock_(CacheServer::GetInstance().GetNumWorkers()),
+      root_(root),
       cache_mem_sz_(mem_sz * 1048576L),  // mem_sz is in MB unit
       cp_(nullptr),
       next_id_(0),
       generate_id_(generate_id),
+      tier_policy_(tier_policy),
+      compression_(compression),
       num_clients_(0),
       st_(generate_id ? CacheServiceState::kBuildPhase : CacheServiceState::kNone) {}
 
@@ -53,7 +57,7 @@ Status CacheService::DoServiceStart() {
     RETURN_STATUS_UNEXPECTED("Unable to bring up numa memory pool");
   }
   // Put together a CachePool for backing up the Tensor.
-  cp_ = std::make_shared<CachePool>(numa_pool_, root_);
+  cp_ = std::make_shared<CachePool>(numa_pool_, root_, tier_policy_, compression_);
   RETURN_IF_NOT_OK(cp_->ServiceStart());
   // Assign a name to this cache. Used for exclusive connection. But we can just use CachePool's name.
   cookie_ = cp_->MyName();
@@ -68,7 +72,7 @@ Status CacheService::DoServiceStop() {
 }
 
 Status CacheService::CacheRow(const std::vector<const void *> &buf, row_id_type *row_id_generated) {
-  SharedLock rw(&rw_lock_);
+  ShardedSharedLock rw(&rw_lock_);
   RETURN_UNEXPECTED_IF_NULL(row_id_generated);
   if (HasBuildPhase() && st_ != CacheServiceState::kBuildPhase) {
     // For this kind of cache service, once we are done with the build phase into fetch phase, we can't
@@ -142,7 +146,7 @@ Status CacheService::CacheRow(const std::vector<const void *> &buf, row_id_type
 }
 
 Status CacheService::FastCacheRow(const ReadableSlice &src, row_id_type *row_id_generated) {
-  SharedLock rw(&rw_lock_);
+  ShardedSharedLock rw(&rw_lock_);
   RETURN_UNEXPECTED_IF_NULL(row_id_generated);
   if (HasBuildPhase() && st_ != CacheServiceState::kBuildPhase) {
     // For this kind of cache service, once we are done with the build phase into fetch phase, we can't
@@ -225,7 +229,7 @@ Status CacheService::FindKeysMiss(std::vector<row_id_type> *out) {
 }
 
 Status CacheService::GetStat(CacheService::ServiceStat *out) {
-  SharedLock rw(&rw_lock_);
+  ShardedSharedLock rw(&rw_lock_);
   RETURN_UNEXPECTED_IF_NULL(out);
   out->stat_ = cp_->GetStat();
   out->state_ = static_cast<ServiceStat::state_type>(st_.load());
@@ -234,7 +238,7 @@ Status CacheService::GetStat(CacheService::ServiceStat *out) {
 
 Status CacheService::PreBatchFetch(connection_id_type connection_id, const std::vector<row_id_type> &v,
                                    const std::shared_ptr<flatbuffers::FlatBufferBuilder> &fbb) {
-  SharedLock rw(&rw_lock_);
+  ShardedSharedLock rw(&rw_lock_);
   if (HasBuildPhase() && st_ != CacheServiceState::kFetchPhase) {
     // For this kind of cache service, we can't fetch yet until we are done with caching all the rows.
     RETURN_STATUS_UNEXPECTED("Can't accept fetch request in non-fetch phase. Current phase: " +
@@ -256,9 +260,19 @@ Status CacheService::PreBatchFetch(connection_id_type connection_id, const std::
   return Status::OK();
 }
 
-Status CacheService::InternalFetchRow(const FetchRowMsg *p) {
+Status CacheService::InternalFetchRow(const BatchFetchRowMsg *p) {
+  RETURN_UNEXPECTED_IF_NULL(p);
+  RETURN_UNEXPECTED_IF_NULL(p->rows());
+  ShardedSharedLock rw(&rw_lock_);
+  const auto num_rows = p->rows()->size();
+  for (uint32_t i = 0; i < num_rows; ++i) {
+    RETURN_IF_NOT_OK(FetchOneRow(p->rows()->Get(i)));
+  }
+  return Status::OK();
+}
+
+Status CacheService::FetchOneRow(const FetchRowMsg *p) {
   RETURN_UNEXPECTED_IF_NULL(p);
-  SharedLock rw(&rw_lock_);
   size_t bytesRead = 0;
   int64_t key = p->key();
   size_t sz = p->size();
@@ -283,7 +297,7 @@ Status CacheService::InternalFetchRow(const FetchRowMsg *p) {
 }
 
 Status CacheService::CacheSchema(const void *buf, int64_t len) {
-  UniqueLock rw(&rw_lock_);
+  ShardedUniqueLock rw(&rw_lock_);
   // In case we are calling the same function from multiple threads, only
   // the first one is considered. Rest is ignored.
   if (schema_.empty()) {
@@ -294,8 +308,14 @@ Status CacheService::CacheSchema(const void *buf, int64_t len) {
   return Status::OK();
 }
 
+Status CacheService::FetchCompressionDict(std::string *out) const {
+  ShardedSharedLock rw(&rw_lock_);
+  RETURN_UNEXPECTED_IF_NULL(out);
+  return cp_->GetCompressionDict(out);
+}
+
 Status CacheService::FetchSchema(std::string *out) const {
-  SharedLock rw(&rw_lock_);
+  ShardedSharedLock rw(&rw_lock_);
   if (st_ == CacheServiceState::kBuildPhase) {
     // For this kind of cache service, we can't fetch yet until we are done with caching all the rows.
     RETURN_STATUS_UNEXPECTED("Can't accept fetch request in non-fetch phase. Current phase: " +
@@ -317,7 +337,7 @@ Status CacheService::FetchSchema(std::string *out) const {
 Status CacheService::BuildPhaseDone() {
   if (HasBuildPhase()) {
     // Exclusive lock to switch phase
-    UniqueLock rw(&rw_lock_);
+    ShardedUniqueLock rw(&rw_lock_);
     st_ = CacheServiceState::kFetchPhase;
     cp_->SetLocking(false);
     MS_LOG(WARNING) << "Locking mode is switched off.";
@@ -328,7 +348,7 @@ Status CacheService::BuildPhaseDone() {
 }
 
 Status CacheService::ToggleWriteMode(bool on_off) {
-  UniqueLock rw(&rw_lock_);
+  ShardedUniqueLock rw(&rw_lock_);
   if (HasBuildPhase()) {
     RETURN_STATUS_UNEXPECTED("Not applicable to non-mappable dataset");
   } else {
@@ -49,7 +49,11 @@ class CacheService : public Service {
   /// \param root Spill path. Empty string means no spilling
   /// \param generate_id If the cache service should generate row id for buffer that is cached.
   /// For non-mappable dataset, this should be set to true.
-  CacheService(uint64_t mem_sz, const std::string &root, bool generate_id);
+  /// \param tier_policy Promotion/eviction policy between memory and disk. Ignored if there is no spill path.
+  /// \param compression Compression of the cached rows
+  CacheService(uint64_t mem_sz, const std::string &root, bool generate_id,
+               CacheTierPolicyType tier_policy = CacheTierPolicyType::kNone,
+               CacheCompressionType compression = CacheCompressionType::kNone);
   ~CacheService() override;
 
   Status DoServiceStart() override;
@@ -102,6 +106,10 @@ class CacheService : public Service {
   /// \param out A contiguous memory that contains the serialized form of schema.
   /// \return Status object
   Status FetchSchema(std::string *out) const;
+  /// \brief Fetch the dictionary the rows are compressed with
+  /// \param out A contiguous memory that contains the dictionary
+  /// \return Status object
+  Status FetchCompressionDict(std::string *out) const;
   /// \brief Return a set of keys that are definitely cache miss
   /// \return Status object
   Status FindKeysMiss(std::vector<row_id_type> *out);
@@ -125,12 +133,14 @@ class CacheService : public Service {
   Status ToggleWriteMode(bool on_off);
 
  private:
-  mutable RWLock rw_lock_;
+  mutable ShardedRWLock rw_lock_;
   std::string root_;
   uint64_t cache_mem_sz_;
   std::shared_ptr<CachePool> cp_;
   std::atomic<row_id_type> next_id_;
   bool generate_id_;
+  CacheTierPolicyType tier_policy_;
+  CacheCompressionType compression_;
   std::string cookie_;
   std::atomic<int32_t> num_clients_;
   std::atomic<CacheServiceState> st_;
@@ -144,7 +154,10 @@ class CacheService : public Service {
   /// \return Row id assigned.
   row_id_type GetNextRowId() { return next_id_.fetch_add(1); }
 
-  Status InternalFetchRow(const FetchRowMsg *p);
+  /// \brief Copy a group of rows of a BatchFetch request to their destinations
+  Status InternalFetchRow(const BatchFetchRowMsg *p);
+  /// \brief Copy one row. Caller must hold rw_lock_ in shared mode.
+  Status FetchOneRow(const FetchRowMsg *p);
 };
 }  // namespace dataset
 }  // namespace mindspore
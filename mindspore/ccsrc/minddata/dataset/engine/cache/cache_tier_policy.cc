@@ -0,0 +1,137 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include "minddata/dataset/engine/cache/cache_tier_policy.h"
+
+namespace mindspore {
+namespace dataset {
+std::unique_ptr<CacheTierPolicy> CacheTierPolicy::Create(CacheTierPolicyType type) {
+  switch (type) {
+    case CacheTierPolicyType::kLru:
+      return std::make_unique<LruTierPolicy>();
+    case CacheTierPolicyType::kLfu:
+      return std::make_unique<LfuTierPolicy>();
+    case CacheTierPolicyType::kTinyLfu:
+      return std::make_unique<TinyLfuTierPolicy>();
+    default:
+      return nullptr;
+  }
+}
+
+void LruTierPolicy::OnAccess(key_type key) {
+  auto it = pos_.find(key);
+  if (it != pos_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+  }
+}
+
+void LruTierPolicy::OnInsert(key_type key) {
+  auto it = pos_.find(key);
+  if (it != pos_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+  lru_.push_front(key);
+  pos_.emplace(key, lru_.begin());
+}
+
+void LruTierPolicy::OnErase(key_type key) {
+  auto it = pos_.find(key);
+  if (it != pos_.end()) {
+    lru_.erase(it->second);
+    pos_.erase(it);
+  }
+}
+
+bool LruTierPolicy::PickVictim(key_type *key) {
+  if (lru_.empty()) {
+    return false;
+  }
+  *key = lru_.back();
+  return true;
+}
+
+LfuTierPolicy::LfuTierPolicy(uint64_t sketch_width) : history_(sketch_width) {}
+
+void LfuTierPolicy::OnAccess(key_type key) {
+  history_.Increment(static_cast<uint64_t>(key));
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return;
+  }
+  auto &entry = it->second;
+  auto bucket = buckets_.find(entry.freq);
+  bucket->second.erase(entry.it);
+  if (bucket->second.empty()) {
+    buckets_.erase(bucket);
+  }
+  ++entry.freq;
+  auto &next = buckets_[entry.freq];
+  next.push_front(key);
+  entry.it = next.begin();
+}
+
+void LfuTierPolicy::OnInsert(key_type key) {
+  if (entries_.find(key) != entries_.end()) {
+    OnAccess(key);
+    return;
+  }
+  uint64_t freq = 1 + history_.Estimate(static_cast<uint64_t>(key));
+  auto &bucket = buckets_[freq];
+  bucket.push_front(key);
+  entries_.emplace(key, Entry{freq, bucket.begin()});
+}
+
+void LfuTierPolicy::OnErase(key_type key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return;
+  }
+  auto bucket = buckets_.find(it->second.freq);
+  bucket->second.erase(it->second.it);
+  if (bucket->second.empty()) {
+    buckets_.erase(bucket);
+  }
+  // The sketch remembers how hot it was in case it comes back.
+  entries_.erase(it);
+}
+
+bool LfuTierPolicy::PickVictim(key_type *key) {
+  if (buckets_.empty()) {
+    return false;
+  }
+  *key = buckets_.begin()->second.back();
+  return true;
+}
+
+TinyLfuTierPolicy::TinyLfuTierPolicy() : sketch_(kSketchWidth) {}
+
+void TinyLfuTierPolicy::OnAccess(key_type key) {
+  sketch_.Increment(static_cast<uint64_t>(key));
+  lru_.OnAccess(key);
+}
+
+void TinyLfuTierPolicy::OnInsert(key_type key) { lru_.OnInsert(key); }
+
+void TinyLfuTierPolicy::OnErase(key_type key) { lru_.OnErase(key); }
+
+bool TinyLfuTierPolicy::PickVictim(key_type *key) { return lru_.PickVictim(key); }
+
+bool TinyLfuTierPolicy::Admit(key_type candidate, key_type victim) {
+  return sketch_.Estimate(static_cast<uint64_t>(candidate)) > sketch_.Estimate(static_cast<uint64_t>(victim));
+}
+}  // namespace dataset
+}  // namespace mindspore
@@ -0,0 +1,126 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_TIER_POLICY_H_
+#define MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_TIER_POLICY_H_
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/frequency_sketch.h"
+
+namespace mindspore {
+namespace dataset {
+/// \brief Policy used by a CachePool to decide which rows stay in the memory tier when spilling is enabled.
+enum class CacheTierPolicyType : int8_t {
+  kNone = 0,     // No promotion nor eviction. Rows stay in the tier they are first written to.
+  kLru = 1,      // Evict the least recently used row, always admit.
+  kLfu = 2,      // Evict the least frequently used row, always admit.
+  kTinyLfu = 3,  // Evict in LRU order but only admit a row if a frequency sketch says it is hotter than the victim.
+};
+
+/// \brief Base class of the admission and eviction policy of the memory tier of a CachePool.
+/// It only tracks the keys that are resident in memory, plus whatever access history the policy needs.
+/// \note Not thread safe. The CachePool serializes all the calls.
+class CacheTierPolicy {
+ public:
+  using key_type = int64_t;
+  // Width of the frequency sketch which keeps the access history of a policy. Its memory is fixed no matter how many
+  // keys are on disk, and the old history is aged out.
+  static constexpr uint64_t kSketchWidth = 1u << 20;
+
+  virtual ~CacheTierPolicy() = default;
+
+  /// \brief Factory function
+  /// \param[in] type The policy type. kNone returns a nullptr
+  /// \return A policy object
+  static std::unique_ptr<CacheTierPolicy> Create(CacheTierPolicyType type);
+
+  /// \brief A key has been accessed, regardless of which tier it is in.
+  virtual void OnAccess(key_type key) = 0;
+
+  /// \brief A key becomes resident in memory.
+  virtual void OnInsert(key_type key) = 0;
+
+  /// \brief A key is no longer resident in memory.
+  virtual void OnErase(key_type key) = 0;
+
+  /// \brief Pick the next memory resident key to be evicted. The key is not removed from the policy.
+  /// \param[out] key The victim
+  /// \return False if there is nothing to evict
+  virtual bool PickVictim(key_type *key) = 0;
+
+  /// \brief Decide if a candidate on disk is worth promoting at the expense of the victim.
+  virtual bool Admit(key_type candidate, key_type victim) { return true; }
+};
+
+/// \brief Least recently used.
+class LruTierPolicy : public CacheTierPolicy {
+ public:
+  void OnAccess(key_type key) override;
+  void OnInsert(key_type key) override;
+  void OnErase(key_type key) override;
+  bool PickVictim(key_type *key) override;
+
+ private:
+  // Most recently used key is at the front.
+  std::list<key_type> lru_;
+  std::unordered_map<key_type, std::list<key_type>::iterator> pos_;
+};
+
+/// \brief Least frequently used with LRU order among keys of the same frequency.
+class LfuTierPolicy : public CacheTierPolicy {
+ public:
+  explicit LfuTierPolicy(uint64_t sketch_width = kSketchWidth);
+
+  void OnAccess(key_type key) override;
+  void OnInsert(key_type key) override;
+  void OnErase(key_type key) override;
+  bool PickVictim(key_type *key) override;
+
+ private:
+  struct Entry {
+    uint64_t freq;
+    std::list<key_type>::iterator it;
+  };
+  // Frequency buckets. Within a bucket the most recently touched key is at the front.
+  std::map<uint64_t, std::list<key_type>> buckets_;
+  std::unordered_map<key_type, Entry> entries_;
+  // Frequency of all the accessed keys, so a promoted key does not start from scratch.
+  FrequencySketch history_;
+};
+
+/// \brief LRU eviction with TinyLFU admission.
+class TinyLfuTierPolicy : public CacheTierPolicy {
+ public:
+  TinyLfuTierPolicy();
+
+  void OnAccess(key_type key) override;
+  void OnInsert(key_type key) override;
+  void OnErase(key_type key) override;
+  bool PickVictim(key_type *key) override;
+  bool Admit(key_type candidate, key_type victim) override;
+
+ private:
+  FrequencySketch sketch_;
+  LruTierPolicy lru_;
+};
+}  // namespace dataset
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_TIER_POLICY_H_
@@ -24,6 +24,7 @@
 #include "minddata/dataset/core/tensor_shape.h"
 #include "minddata/dataset/engine/gnn/graph_loader.h"
 #include "minddata/dataset/util/random.h"
+#include "minddata/dataset/util/task_manager.h"
 namespace mindspore {
 namespace dataset {
 namespace gnn {
@@ -366,7 +367,8 @@ Status GraphDataImpl::RandomWalk(const std::vector<NodeIdType> &node_list, const
                                  float step_home_param, float step_away_param, NodeIdType default_node,
                                  std::shared_ptr<Tensor> *out) {
   RETURN_UNEXPECTED_IF_NULL(out);
-  RETURN_IF_NOT_OK(random_walk_.Build(node_list, meta_path, step_home_param, step_away_param, default_node));
+  RETURN_IF_NOT_OK(random_walk_.Build(node_list, meta_path, step_home_param, step_away_param, default_node, 1,
+                                      num_workers_));
   std::vector<std::vector<NodeIdType>> walks;
   RETURN_IF_NOT_OK(random_walk_.SimulateWalk(&walks));
   RETURN_IF_NOT_OK(CreateTensorByVector<NodeIdType>({walks}, DataType(DataType::DE_INT32), out));
@@ -702,7 +704,9 @@ Status GraphDataImpl::RandomWalkBase::Build(const std::vector<NodeIdType> &node_
   return Status::OK();
 }
 
-Status GraphDataImpl::RandomWalkBase::Node2vecWalk(const NodeIdType &start_node, std::vector<NodeIdType> *walk_path) {
+Status GraphDataImpl::RandomWalkBase::Node2vecWalk(const NodeIdType &start_node, std::mt19937 *rnd,
+                                                   std::vector<NodeIdType> *walk_path) {
+  RETURN_UNEXPECTED_IF_NULL(rnd);
   RETURN_UNEXPECTED_IF_NULL(walk_path);
   // Simulate a random walk starting from start node.
   auto walk = std::vector<NodeIdType>(1, start_node);  // walk is an vector
@@ -724,15 +728,18 @@ Status GraphDataImpl::RandomWalkBase::Node2vecWalk(const NodeIdType &start_node,
     }
 
     // walk by the fist node, then by the previous 2 nodes
-    std::shared_ptr<StochasticIndex> stochastic_index;
+    uint32_t next_index = 0;
     if (walk.size() == 1) {
-      RETURN_IF_NOT_OK(GetNodeProbability(cur_node_id, meta_path_[0], &stochastic_index));
+      // All neighbors of the first node are equally likely, no alias table is needed
+      std::uniform_int_distribution<uint32_t> distribution(0, cur_neighbors.size() - 1);
+      next_index = distribution(*rnd);
     } else {
       NodeIdType prev_node_id = walk[walk.size() - 2];
-      RETURN_IF_NOT_OK(GetEdgeProbability(prev_node_id, cur_node_id, walk.size() - 2, &stochastic_index));
+      StochasticIndex stochastic_index;
+      RETURN_IF_NOT_OK(GetEdgeProbability(prev_node_id, cur_neighbors, walk.size() - 2, rnd, &stochastic_index));
+      next_index = WalkToNextNode(stochastic_index, rnd);
     }
-    NodeIdType next_node_id = cur_neighbors[WalkToNextNode(*stochastic_index)];
-    walk.push_back(next_node_id);
+    walk.push_back(cur_neighbors[next_index]);
   }
 
   while (walk.size() - 1 < meta_path_.size()) {
@@ -743,59 +750,67 @@ Status GraphDataImpl::RandomWalkBase::Node2vecWalk(const NodeIdType &start_node,
   return Status::OK();
 }
 
-Status GraphDataImpl::RandomWalkBase::SimulateWalk(std::vector<std::vector<NodeIdType>> *walks) {
-  RETURN_UNEXPECTED_IF_NULL(walks);
-  for (int32_t i = 0; i < num_walks_; ++i) {
-    for (const auto &node : node_list_) {
-      std::vector<NodeIdType> walk;
-      RETURN_IF_NOT_OK(Node2vecWalk(node, &walk));
-      walks->push_back(walk);
-    }
+Status GraphDataImpl::RandomWalkBase::SimulateWalkWorker(int32_t worker_id, int32_t num_workers, uint32_t seed,
+                                                         std::vector<std::vector<NodeIdType>> *walks) {
+  TaskManager::FindMe()->Post();
+  std::mt19937 rnd(seed + static_cast<uint32_t>(worker_id));
+  const size_t total_walks = walks->size();
+  for (size_t i = worker_id; i < total_walks; i += num_workers) {
+    RETURN_IF_INTERRUPTED();
+    RETURN_IF_NOT_OK(Node2vecWalk(node_list_[i % node_list_.size()], &rnd, &(*walks)[i]));
   }
   return Status::OK();
 }
 
-Status GraphDataImpl::RandomWalkBase::GetNodeProbability(const NodeIdType &node_id, const NodeType &node_type,
-                                                         std::shared_ptr<StochasticIndex> *node_probability) {
-  RETURN_UNEXPECTED_IF_NULL(node_probability);
-  // Generate alias nodes
-  std::shared_ptr<Node> node;
-  RETURN_IF_NOT_OK(graph_->GetNodeByNodeId(node_id, &node));
-  std::vector<NodeIdType> neighbors;
-  RETURN_IF_NOT_OK(node->GetAllNeighbors(node_type, &neighbors, true));
-  std::sort(neighbors.begin(), neighbors.end());
-  auto non_normalized_probability = std::vector<float>(neighbors.size(), 1.0);
-  *node_probability =
-    std::make_shared<StochasticIndex>(GenerateProbability(Normalize<float>(non_normalized_probability)));
+Status GraphDataImpl::RandomWalkBase::SimulateWalk(std::vector<std::vector<NodeIdType>> *walks) {
+  RETURN_UNEXPECTED_IF_NULL(walks);
+  // Walks are laid out as num_walks_ rounds over node_list_, the same order as the sequential version
+  const size_t offset = walks->size();
+  const size_t total_walks = static_cast<size_t>(num_walks_) * node_list_.size();
+  std::vector<std::vector<NodeIdType>> results(total_walks);
+  int32_t num_workers = static_cast<int32_t>(std::min(static_cast<size_t>(num_workers_), total_walks));
+  uint32_t seed = GetSeed();
+  if (num_workers <= 1) {
+    std::mt19937 rnd(seed);
+    for (size_t i = 0; i < total_walks; ++i) {
+      RETURN_IF_NOT_OK(Node2vecWalk(node_list_[i % node_list_.size()], &rnd, &results[i]));
+    }
+  } else {
+    TaskGroup vg;
+    for (int32_t wkr_id = 0; wkr_id < num_workers; ++wkr_id) {
+      RETURN_IF_NOT_OK(vg.CreateAsyncTask(
+        "RandomWalk", std::bind(&RandomWalkBase::SimulateWalkWorker, this, wkr_id, num_workers, seed, &results)));
+    }
+    RETURN_IF_NOT_OK(vg.join_all(Task::WaitFlag::kBlocking));
+    RETURN_IF_NOT_OK(vg.GetTaskErrorIfAny());
+  }
+  walks->resize(offset + total_walks);
+  std::move(results.begin(), results.end(), walks->begin() + offset);
   return Status::OK();
 }
 
-Status GraphDataImpl::RandomWalkBase::GetEdgeProbability(const NodeIdType &src, const NodeIdType &dst,
-                                                         uint32_t meta_path_index,
-                                                         std::shared_ptr<StochasticIndex> *edge_probability) {
+Status GraphDataImpl::RandomWalkBase::GetEdgeProbability(const NodeIdType &src,
+                                                         const std::vector<NodeIdType> &dst_neighbors,
+                                                         uint32_t meta_path_index, std::mt19937 *rnd,
+                                                         StochasticIndex *edge_probability) {
   RETURN_UNEXPECTED_IF_NULL(edge_probability);
-  // Get the alias edge setup lists for a given edge.
+  // Get the alias edge setup lists for a given edge, dst_neighbors must be sorted.
   std::shared_ptr<Node> src_node;
   RETURN_IF_NOT_OK(graph_->GetNodeByNodeId(src, &src_node));
   std::vector<NodeIdType> src_neighbors;
   RETURN_IF_NOT_OK(src_node->GetAllNeighbors(meta_path_[meta_path_index], &src_neighbors, true));
-
-  std::shared_ptr<Node> dst_node;
-  RETURN_IF_NOT_OK(graph_->GetNodeByNodeId(dst, &dst_node));
-  std::vector<NodeIdType> dst_neighbors;
-  RETURN_IF_NOT_OK(dst_node->GetAllNeighbors(meta_path_[meta_path_index + 1], &dst_neighbors, true));
+  std::sort(src_neighbors.begin(), src_neighbors.end());
 
   CHECK_FAIL_RETURN_UNEXPECTED(step_home_param_ != 0, "Invalid data, step home parameter can't be zero.");
   CHECK_FAIL_RETURN_UNEXPECTED(step_away_param_ != 0, "Invalid data, step away parameter can't be zero.");
-  std::sort(dst_neighbors.begin(), dst_neighbors.end());
   std::vector<float> non_normalized_probability;
+  non_normalized_probability.reserve(dst_neighbors.size());
   for (const auto &dst_nbr : dst_neighbors) {
     if (dst_nbr == src) {
       non_normalized_probability.push_back(1.0 / step_home_param_);  // replace 1.0 with G[dst][dst_nbr]['weight']
       continue;
     }
-    auto it = std::find(src_neighbors.begin(), src_neighbors.end(), dst_nbr);
-    if (it != src_neighbors.end()) {
+    if (std::binary_search(src_neighbors.begin(), src_neighbors.end(), dst_nbr)) {
       // stay close, this node connect both src and dst
       non_normalized_probability.push_back(1.0);  // replace 1.0 with G[dst][dst_nbr]['weight']
     } else {
@@ -804,22 +819,21 @@ Status GraphDataImpl::RandomWalkBase::GetEdgeProbability(const NodeIdType &src,
     }
   }
 
-  *edge_probability =
-    std::make_shared<StochasticIndex>(GenerateProbability(Normalize<float>(non_normalized_probability)));
+  *edge_probability = GenerateProbability(Normalize<float>(non_normalized_probability), rnd);
   return Status::OK();
 }
 
-StochasticIndex GraphDataImpl::RandomWalkBase::GenerateProbability(const std::vector<float> &probability) {
+StochasticIndex GraphDataImpl::RandomWalkBase::GenerateProbability(const std::vector<float> &probability,
+                                                                   std::mt19937 *rnd) {
   uint32_t K = probability.size();
   std::vector<int32_t> switch_to_large_index(K, 0);
   std::vector<float> weight(K, .0);
   std::vector<int32_t> smaller;
   std::vector<int32_t> larger;
-  auto random_device = GetRandomDevice();
   std::uniform_real_distribution<> distribution(-kGnnEpsilon, kGnnEpsilon);
   float accumulate_threshold = 0.0;
   for (uint32_t i = 0; i < K; i++) {
-    float threshold_one = distribution(random_device);
+    float threshold_one = distribution(*rnd);
     accumulate_threshold += threshold_one;
     weight[i] = i < K - 1 ? probability[i] * K + threshold_one : probability[i] * K - accumulate_threshold;
     weight[i] < 1.0 ? smaller.push_back(i) : larger.push_back(i);
@@ -837,18 +851,18 @@ StochasticIndex GraphDataImpl::RandomWalkBase::GenerateProbability(const std::ve
   return StochasticIndex(switch_to_large_index, weight);
 }
 
-uint32_t GraphDataImpl::RandomWalkBase::WalkToNextNode(const StochasticIndex &stochastic_index) {
-  auto switch_to_large_index = stochastic_index.first;
-  auto weight = stochastic_index.second;
+uint32_t GraphDataImpl::RandomWalkBase::WalkToNextNode(const StochasticIndex &stochastic_index, std::mt19937 *rnd) {
+  const auto &switch_to_large_index = stochastic_index.first;
+  const auto &weight = stochastic_index.second;
   const uint32_t size_of_index = switch_to_large_index.size();
 
-  auto random_device = GetRandomDevice();
   std::uniform_real_distribution<> distribution(0.0, 1.0);
 
   // Generate random integer between [0, K)
-  uint32_t random_idx = std::floor(distribution(random_device) * size_of_index);
+  uint32_t random_idx = std::min(static_cast<uint32_t>(std::floor(distribution(*rnd) * size_of_index)),
+                                 size_of_index - 1);
 
-  if (distribution(random_device) < weight[random_idx]) {
+  if (distribution(*rnd) < weight[random_idx]) {
     return random_idx;
   }
   return switch_to_large_index[random_idx];
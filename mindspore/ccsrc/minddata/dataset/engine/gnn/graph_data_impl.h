@@ -185,17 +185,18 @@ class GraphDataImpl : public GraphData {
     Status SimulateWalk(std::vector<std::vector<NodeIdType>> *walks);
 
    private:
-    Status Node2vecWalk(const NodeIdType &start_node, std::vector<NodeIdType> *walk_path);
+    // Worker entry of SimulateWalk, each worker owns its random engine and walks with stride num_workers
+    Status SimulateWalkWorker(int32_t worker_id, int32_t num_workers, uint32_t seed,
+                              std::vector<std::vector<NodeIdType>> *walks);
 
-    Status GetNodeProbability(const NodeIdType &node_id, const NodeType &node_type,
-                              std::shared_ptr<StochasticIndex> *node_probability);
+    Status Node2vecWalk(const NodeIdType &start_node, std::mt19937 *rnd, std::vector<NodeIdType> *walk_path);
 
-    Status GetEdgeProbability(const NodeIdType &src, const NodeIdType &dst, uint32_t meta_path_index,
-                              std::shared_ptr<StochasticIndex> *edge_probability);
+    Status GetEdgeProbability(const NodeIdType &src, const std::vector<NodeIdType> &dst_neighbors,
+                              uint32_t meta_path_index, std::mt19937 *rnd, StochasticIndex *edge_probability);
 
-    static StochasticIndex GenerateProbability(const std::vector<float> &probability);
+    static StochasticIndex GenerateProbability(const std::vector<float> &probability, std::mt19937 *rnd);
 
-    static uint32_t WalkToNextNode(const StochasticIndex &stochastic_index);
+    static uint32_t WalkToNextNode(const StochasticIndex &stochastic_index, std::mt19937 *rnd);
 
     template <typename T>
     std::vector<float> Normalize(const std::vector<T> &non_normalized_probability);
@@ -75,6 +75,11 @@ Status GraphLoader::GetNodesAndEdges() {
     }
   }
 
+  // Precompute alias tables once all edges are attached, so weighted sampling is O(1) per draw
+  for (auto &itr : *n_id_map) {
+    RETURN_IF_NOT_OK(itr.second->BuildAliasTables());
+  }
+
   for (auto &itr : graph_impl_->node_type_map_) itr.second.shrink_to_fit();
   for (auto &itr : graph_impl_->edge_type_map_) itr.second.shrink_to_fit();
 
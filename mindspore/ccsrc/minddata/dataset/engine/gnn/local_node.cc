@@ -16,6 +16,7 @@
 #include "minddata/dataset/engine/gnn/local_node.h"
 
 #include <algorithm>
+#include <numeric>
 #include <random>
 #include <string>
 #include <utility>
@@ -84,14 +85,79 @@ Status LocalNode::GetWeightSampledNeighbors(const std::vector<std::shared_ptr<No
                                             std::vector<NodeIdType> *out) {
   CHECK_FAIL_RETURN_UNEXPECTED(neighbors.size() == weights.size(),
                                "The number of neighbors does not match the weight.");
-  std::discrete_distribution<NodeIdType> discrete_dist(weights.begin(), weights.end());
+  CHECK_FAIL_RETURN_UNEXPECTED(!neighbors.empty(), "The neighbors of node " + std::to_string(id_) + " is empty.");
+  auto itr = alias_tables_.find(neighbors[0]->type());
+  if (itr == alias_tables_.end() || itr->second.first.size() != neighbors.size()) {
+    // Alias table is not built yet or out of date, fall back to the O(n) distribution
+    std::discrete_distribution<NodeIdType> discrete_dist(weights.begin(), weights.end());
+    for (int32_t i = 0; i < samples_num; ++i) {
+      NodeIdType index = discrete_dist(rnd_);
+      out->emplace_back(neighbors[index]->id());
+    }
+    return Status::OK();
+  }
+  const auto &alias = itr->second.first;
+  const auto &prob = itr->second.second;
+  std::uniform_int_distribution<int32_t> slot_dist(0, static_cast<int32_t>(alias.size()) - 1);
+  std::uniform_real_distribution<float> accept_dist(0.0, 1.0);
   for (int32_t i = 0; i < samples_num; ++i) {
-    NodeIdType index = discrete_dist(rnd_);
+    int32_t slot = slot_dist(rnd_);
+    int32_t index = accept_dist(rnd_) < prob[slot] ? slot : alias[slot];
     out->emplace_back(neighbors[index]->id());
   }
   return Status::OK();
 }
 
+Status LocalNode::BuildAliasTable(const std::vector<WeightType> &weights, AliasTable *table) const {
+  RETURN_UNEXPECTED_IF_NULL(table);
+  const size_t num = weights.size();
+  std::vector<int32_t> alias(num);
+  std::vector<float> prob(num, 1.0);
+  std::iota(alias.begin(), alias.end(), 0);
+  double sum = 0.0;
+  for (const auto &weight : weights) {
+    CHECK_FAIL_RETURN_UNEXPECTED(weight >= 0, "Invalid edge weight of node " + std::to_string(id_) +
+                                                ", weight must be non-negative, got " + std::to_string(weight));
+    sum += weight;
+  }
+  if (num == 0 || sum <= 0) {
+    *table = std::make_pair(std::move(alias), std::move(prob));
+    return Status::OK();
+  }
+
+  // Vose's alias method, scale weights so that the average slot probability is 1
+  std::vector<double> scaled(num);
+  std::vector<int32_t> smaller;
+  std::vector<int32_t> larger;
+  for (size_t i = 0; i < num; ++i) {
+    scaled[i] = weights[i] * num / sum;
+    scaled[i] < 1.0 ? smaller.push_back(i) : larger.push_back(i);
+  }
+  while (!smaller.empty() && !larger.empty()) {
+    int32_t small = smaller.back();
+    smaller.pop_back();
+    int32_t large = larger.back();
+    larger.pop_back();
+    prob[small] = static_cast<float>(scaled[small]);
+    alias[small] = large;
+    scaled[large] = scaled[large] + scaled[small] - 1.0;
+    scaled[large] < 1.0 ? smaller.push_back(large) : larger.push_back(large);
+  }
+  // Remaining slots are full up to rounding error
+  for (const auto &i : larger) prob[i] = 1.0;
+  for (const auto &i : smaller) prob[i] = 1.0;
+  *table = std::make_pair(std::move(alias), std::move(prob));
+  return Status::OK();
+}
+
+Status LocalNode::BuildAliasTables() {
+  alias_tables_.clear();
+  for (const auto &itr : neighbor_nodes_) {
+    RETURN_IF_NOT_OK(BuildAliasTable(itr.second.second, &alias_tables_[itr.first]));
+  }
+  return Status::OK();
+}
+
 Status LocalNode::GetSampledNeighbors(NodeType neighbor_type, int32_t samples_num, SamplingStrategy strategy,
                                       std::vector<NodeIdType> *out_neighbors) {
   std::vector<NodeIdType> neighbors;
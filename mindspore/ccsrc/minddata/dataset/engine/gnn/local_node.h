@@ -29,6 +29,9 @@ namespace mindspore {
 namespace dataset {
 namespace gnn {
 
+// Walker alias table, the first element is the alias index and the second is the acceptance probability of each slot
+using AliasTable = std::pair<std::vector<int32_t>, std::vector<float>>;
+
 class LocalNode : public Node {
  public:
   // Constructor
@@ -65,6 +68,10 @@ class LocalNode : public Node {
   // @return Status The status code returned
   Status AddNeighbor(const std::shared_ptr<Node> &node, const WeightType &) override;
 
+  // Precompute a Walker alias table per neighbor type from the edge weights
+  // @return Status The status code returned
+  Status BuildAliasTables() override;
+
   // Add adjacent node and relative edge for source node
   // @param std::shared_ptr<Node> node - the node to be inserted into adjacent table
   // @param std::shared_ptr<Edge> edge - the edge related to the adjacent node of source node
@@ -90,10 +97,17 @@ class LocalNode : public Node {
                                    const std::vector<WeightType> &weights, int32_t samples_num,
                                    std::vector<NodeIdType> *out);
 
+  // Build an alias table from non-normalized weights, falls back to uniform if all weights are zero
+  // @param std::vector<WeightType> &weights - edge weights of the neighbors
+  // @param AliasTable *table - Returned alias table
+  // @return Status The status code returned
+  Status BuildAliasTable(const std::vector<WeightType> &weights, AliasTable *table) const;
+
   std::mt19937 rnd_;
   std::unordered_map<FeatureType, std::shared_ptr<Feature>> features_;
   std::unordered_map<NodeType, std::pair<std::vector<std::shared_ptr<Node>>, std::vector<WeightType>>> neighbor_nodes_;
   std::unordered_map<NodeIdType, EdgeIdType> adjacent_nodes_;
+  std::unordered_map<NodeType, AliasTable> alias_tables_;
 };
 }  // namespace gnn
 }  // namespace dataset
@@ -81,6 +81,10 @@ class Node {
   // @return Status The status code returned
   virtual Status AddNeighbor(const std::shared_ptr<Node> &node, const WeightType &weight) = 0;
 
+  // Precompute the alias tables used by weighted neighbor sampling, called once all neighbors are added
+  // @return Status The status code returned
+  virtual Status BuildAliasTables() = 0;
+
   // Add adjacent node and relative edge for source node
   // @param std::shared_ptr<Node> node - the node to be inserted into adjacent table
   // @param std::shared_ptr<Edge> edge - the edge related to the adjacent node of source node
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "minddata/dataset/util/lock.h"
+#include <functional>
+#include <thread>
 #include "minddata/dataset/util/log_adapter.h"
 
 namespace mindspore {
@@ -95,6 +97,66 @@ void RWLock::Downgrade() {
   }
 }
 
+ShardedRWLock::ShardedRWLock(int32_t num_shards)
+    : num_shards_(num_shards > 0 ? num_shards : 1), shards_(std::make_unique<Shard[]>(num_shards_)), writer_(false) {}
+
+ShardedRWLock::Shard *ShardedRWLock::MyShard() {
+  auto h = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  return &shards_[h % static_cast<size_t>(num_shards_)];
+}
+
+void ShardedRWLock::LockShared() {
+  auto *shard = MyShard();
+  while (true) {
+    // The counter is raised before the flag is checked, and the writer does the opposite, so either the reader sees
+    // the flag or the writer sees the counter.
+    (void)shard->readers.fetch_add(1, std::memory_order_seq_cst);
+    if (!writer_.load(std::memory_order_seq_cst)) {
+      return;
+    }
+    // Back off so the writer can go ahead, and wait for it to finish.
+    LeaveShard(shard);
+    std::unique_lock<std::mutex> lck(mtx_);
+    cv_.wait(lck, [this]() { return !writer_.load(std::memory_order_seq_cst); });
+  }
+}
+
+void ShardedRWLock::UnlockShared() noexcept { LeaveShard(MyShard()); }
+
+void ShardedRWLock::LeaveShard(Shard *shard) noexcept {
+  if (shard->readers.fetch_sub(1, std::memory_order_seq_cst) == 1 && writer_.load(std::memory_order_seq_cst)) {
+    // Wake up the writer waiting for the readers. Go through the mutex so the wakeup can't slip in between its check
+    // and its wait.
+    { std::unique_lock<std::mutex> lck(mtx_); }
+    cv_.notify_all();
+  }
+}
+
+bool ShardedRWLock::HasReaders() const {
+  for (int32_t i = 0; i < num_shards_; ++i) {
+    if (shards_[i].readers.load(std::memory_order_seq_cst) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ShardedRWLock::LockExclusive() {
+  std::unique_lock<std::mutex> lck(mtx_);
+  cv_.wait(lck, [this]() { return !writer_.load(std::memory_order_seq_cst); });
+  writer_.store(true, std::memory_order_seq_cst);
+  // No new reader gets in from now on. Wait for the ones already in.
+  cv_.wait(lck, [this]() { return !HasReaders(); });
+}
+
+void ShardedRWLock::Unlock() noexcept {
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    writer_.store(false, std::memory_order_seq_cst);
+  }
+  cv_.notify_all();
+}
+
 SharedLock::SharedLock(RWLock *rw) : rw_(rw), ownlock_(false) {
   rw_->LockShared();
   ownlock_ = true;
@@ -145,6 +207,52 @@ void UniqueLock::Lock() {
   ownlock_ = true;
 }
 
+ShardedSharedLock::ShardedSharedLock(ShardedRWLock *rw) : rw_(rw), ownlock_(false) {
+  rw_->LockShared();
+  ownlock_ = true;
+}
+
+ShardedSharedLock::~ShardedSharedLock() {
+  if (ownlock_) {
+    rw_->UnlockShared();
+    ownlock_ = false;
+  }
+  rw_ = nullptr;
+}
+
+void ShardedSharedLock::Unlock() {
+  rw_->UnlockShared();
+  ownlock_ = false;
+}
+
+void ShardedSharedLock::Lock() {
+  rw_->LockShared();
+  ownlock_ = true;
+}
+
+ShardedUniqueLock::ShardedUniqueLock(ShardedRWLock *rw) : rw_(rw), ownlock_(false) {
+  rw_->LockExclusive();
+  ownlock_ = true;
+}
+
+ShardedUniqueLock::~ShardedUniqueLock() {
+  if (ownlock_) {
+    rw_->Unlock();
+    ownlock_ = false;
+  }
+  rw_ = nullptr;
+}
+
+void ShardedUniqueLock::Unlock() {
+  rw_->Unlock();
+  ownlock_ = false;
+}
+
+void ShardedUniqueLock::Lock() {
+  rw_->LockExclusive();
+  ownlock_ = true;
+}
+
 LockGuard::LockGuard(SpinLock *lock) : lck_(lock), own_lock_(false) {
   lck_->Lock();
   own_lock_ = true;
@@ -18,6 +18,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 
 namespace mindspore {
@@ -94,6 +95,56 @@ class RWLock {
   std::condition_variable write_cv_;
 };
 
+// A reader-writer lock split into shards for the case where readers are many and hot and writers are rare. A reader
+// only bumps the counter of the shard its thread maps to and checks the writer flag, so it takes no mutex and doesn't
+// wait unless a writer holds or waits for the lock. A writer raises the flag and sleeps until the counters of all the
+// shards drain, so it favors writer like RWLock.
+class ShardedRWLock {
+ public:
+  explicit ShardedRWLock(int32_t num_shards);
+
+  ShardedRWLock(const ShardedRWLock &) = delete;
+
+  ShardedRWLock(ShardedRWLock &&) = delete;
+
+  ~ShardedRWLock() = default;
+
+  ShardedRWLock &operator=(const ShardedRWLock &) = delete;
+
+  ShardedRWLock &operator=(ShardedRWLock &&) = delete;
+
+  void LockShared();
+
+  // Release the shared lock. It must be called by the thread which locks it.
+  void UnlockShared() noexcept;
+
+  void LockExclusive();
+
+  // Release the exclusive lock
+  void Unlock() noexcept;
+
+ private:
+  // Keep each shard on its own cache line.
+  struct alignas(64) Shard {
+    std::atomic<int32_t> readers{0};
+  };
+
+  // The shard of the calling thread. A thread always gets the same shard.
+  Shard *MyShard();
+
+  // Drop the count of a reader, and wake up the writer if it is the last reader it waits for.
+  void LeaveShard(Shard *shard) noexcept;
+
+  bool HasReaders() const;
+
+  int32_t num_shards_;
+  std::unique_ptr<Shard[]> shards_;
+  std::atomic<bool> writer_;
+  // Serializes the writers, and parks the readers while a writer is in.
+  std::mutex mtx_;
+  std::condition_variable cv_;
+};
+
 // A Wrapper for RWLock. The destructor will release the lock if we own it.
 class SharedLock {
  public:
@@ -145,6 +196,52 @@ class UniqueLock {
   bool ownlock_;
 };
 
+class ShardedSharedLock {
+ public:
+  explicit ShardedSharedLock(ShardedRWLock *rw);
+
+  ~ShardedSharedLock();
+
+  ShardedSharedLock(const ShardedSharedLock &) = delete;
+
+  ShardedSharedLock(ShardedSharedLock &&) = delete;
+
+  ShardedSharedLock &operator=(const ShardedSharedLock &) = delete;
+
+  ShardedSharedLock &operator=(ShardedSharedLock &&) = delete;
+
+  void Unlock();
+
+  void Lock();
+
+ private:
+  ShardedRWLock *rw_;
+  bool ownlock_;
+};
+
+class ShardedUniqueLock {
+ public:
+  explicit ShardedUniqueLock(ShardedRWLock *rw);
+
+  ~ShardedUniqueLock();
+
+  ShardedUniqueLock(const ShardedUniqueLock &) = delete;
+
+  ShardedUniqueLock(ShardedUniqueLock &&) = delete;
+
+  ShardedUniqueLock &operator=(const ShardedUniqueLock &) = delete;
+
+  ShardedUniqueLock &operator=(ShardedUniqueLock &&) = delete;
+
+  void Unlock();
+
+  void Lock();
+
+ private:
+  ShardedRWLock *rw_;
+  bool ownlock_;
+};
+
 class LockGuard {
  public:
   explicit LockGuard(SpinLock *lock);
@@ -58,6 +58,7 @@
 #include "backend/session/executor_manager.h"
 #include "runtime/hardware/device_context_manager.h"
 #include "runtime/device/kernel_runtime_manager.h"
+#include "runtime/device/kernel_select_cache.h"
 #include "utils/system/sha256.h"
 
 #ifndef ENABLE_SECURITY
@@ -998,6 +999,8 @@ bool GraphExecutorPy::CompileInner(const py::object &source_obj, const py::tuple
     resource->set_enable_compile_cache(true);
     resource->set_compile_cache_id(GetCompileCacheGraphId());
     resource->set_compile_cache_dep_files_hash(GetCompileDepFilesHash(compile_cache_dep_files_));
+    // The backend caches the kernel selection results next to the front-end graphs.
+    device::KernelSelectCache::GetInstance().Enable(GetCompileCacheDir());
     resource->set_func_graph(GetCachedFuncGraph(resource, weights_, queue_name_));
 #ifdef ENABLE_PROFILE
     double t2 = GetTime();
@@ -39,6 +39,8 @@ constexpr char kEnvSchedulerHost[] = "MS_SCHED_HOST";
 constexpr char kEnvSchedulerPort[] = "MS_SCHED_PORT";
 constexpr char kEnvSchedulerManagePort[] = "MS_SCHED_MANAGE_PORT";
 constexpr char kEnvNodeId[] = "MS_NODE_ID";
+constexpr char kEnvGradCompress[] = "MS_DEV_PS_GRAD_COMPRESS";
+constexpr char kEnvCacheEvictionPolicy[] = "MS_DEV_PS_CACHE_EVICTION_POLICY";
 
 constexpr char kCommTypeOfIBVerbs[] = "ibverbs";
 constexpr char kRoleOfPServer[] = "server";
@@ -163,6 +165,11 @@ constexpr char kCertExpireWarningTime[] = "cert_expire_warning_time_in_day";
 constexpr int64_t kCertExpireWarningTimeInDay = 90;
 constexpr char kConnectionNum[] = "connection_num";
 constexpr int64_t kConnectionNumDefault = 10000;
+// The number of event loops of the tcp client and tcp server, the connections are assigned to the event loops in turn.
+// It is 1 by default since the message handlers of the nodes run on the event loops and are not all thread safe, so
+// more reactors must only be configured for the handlers which are.
+constexpr char kReactorNum[] = "reactor_num";
+constexpr int64_t kReactorNumDefault = 1;
 constexpr char kLocalIp[] = "127.0.0.1";
 
 constexpr int64_t kJanuary = 1;
@@ -203,6 +210,24 @@ using Key = size_t;
 using Keys = std::vector<Key>;
 using Values = std::vector<float>;
 using ValuesPtr = std::shared_ptr<Values>;
+// The read only view of the values, which refers to the values in the received message without copy.
+class ValuesView {
+ public:
+  ValuesView(const float *data, size_t size) : data_(data), size_(size) {}
+  ValuesView(const Values &values) : data_(values.data()), size_(values.size()) {}  // NOLINT(runtime/explicit)
+  ~ValuesView() = default;
+
+  const float *data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const float &operator[](size_t index) const { return data_[index]; }
+  const float *begin() const { return data_; }
+  const float *end() const { return data_ + size_; }
+
+ private:
+  const float *data_;
+  size_t size_;
+};
 using Weight = distributed::persistent::Data<float>;
 using PersistentWeight = distributed::persistent::PersistentData<float>;
 using Grad = std::vector<float>;
@@ -15,6 +15,7 @@
  */
 
 #include "ps/core/abstract_node.h"
+#include <algorithm>
 #include "ps/core/node_recovery.h"
 #include "ps/core/communicator/tcp_communicator.h"
 #include "ps/core/communicator/http_communicator.h"
@@ -216,7 +217,7 @@ bool AbstractNode::Send(const NodeRole &node_role, const uint32_t &rank_id, cons
   message_meta->set_user_cmd(command);
 
   auto client = GetOrCreateTcpClient(rank_id);
-  return SendMessageSync(client, message_meta, Protos::RAW, data.get(), len, timeout);
+  return SendMessageSync(client, message_meta, Protos::RAW, {{data.get(), len, data}}, timeout);
 }
 
 bool AbstractNode::Send(const NodeRole &node_role, const std::vector<uint32_t> &rank_ids,
@@ -245,7 +246,7 @@ bool AbstractNode::Send(const NodeRole &node_role, const std::vector<uint32_t> &
     auto len = lens.at(it);
     auto client = GetOrCreateTcpClient(rank_ids.at(it));
     MS_EXCEPTION_IF_NULL(client);
-    if (!client->SendMessage(message_meta, Protos::RAW, send.get(), len)) {
+    if (!client->SendMessage(message_meta, Protos::RAW, {{send.get(), len, send}})) {
       MS_LOG(WARNING) << "Client send message failed.";
     }
   }
@@ -282,7 +283,7 @@ bool AbstractNode::Send(const NodeRole &node_role, const uint32_t &rank_id, cons
 
   auto client = GetOrCreateTcpClient(rank_id);
   MS_EXCEPTION_IF_NULL(client);
-  if (!client->SendMessage(message_meta, Protos::RAW, message.get(), len)) {
+  if (!client->SendMessage(message_meta, Protos::RAW, {{message.get(), len, message}})) {
     MS_LOG(WARNING) << "Client send message failed.";
   }
   MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
@@ -331,7 +332,7 @@ bool AbstractNode::Send(const NodeRole &node_role, const std::vector<uint32_t> &
 
     auto client = GetOrCreateTcpClient(rank_ids.at(it));
     MS_EXCEPTION_IF_NULL(client);
-    if (!client->SendMessage(message_meta, Protos::RAW, send.get(), len)) {
+    if (!client->SendMessage(message_meta, Protos::RAW, {{send.get(), len, send}})) {
       MS_LOG(WARNING) << "Client send message failed.";
     }
   }
@@ -455,6 +456,15 @@ uint16_t AbstractNode::scheduler_port() const { return scheduler_port_; }
 
 void AbstractNode::set_scheduler_port(const uint16_t &scheduler_port) { scheduler_port_ = scheduler_port; }
 
+std::string AbstractNode::GetNodeIp(const NodeRole &node_role, const uint32_t &rank_id) {
+  std::lock_guard<std::mutex> lock(client_mutex_);
+  auto iter = nodes_address_.find(std::make_pair(node_role, rank_id));
+  if (iter == nodes_address_.end()) {
+    return "";
+  }
+  return iter->second.first;
+}
+
 ClusterState AbstractNode::cluster_state() const { return current_cluster_state_; }
 
 void AbstractNode::set_handler(const RequestHandler &handler) { request_handler_ = handler; }
@@ -474,6 +484,21 @@ void AbstractNode::Response(const std::shared_ptr<TcpConnection> &conn, const st
   }
 }
 
+void AbstractNode::Response(const std::shared_ptr<TcpConnection> &conn, const std::shared_ptr<MessageMeta> &meta,
+                            const VectorPtr &data) {
+  MS_EXCEPTION_IF_NULL(conn);
+  MS_EXCEPTION_IF_NULL(meta);
+  MS_EXCEPTION_IF_NULL(data);
+  MS_EXCEPTION_IF_NULL(server_);
+  meta->set_role(node_info_.node_role_);
+  meta->set_rank_id(node_info_.rank_id_);
+  MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
+                << ", the node id is:" << node_info_.node_id_ << " send the request id is:" << meta->request_id();
+  if (!server_->SendMessage(conn, meta, Protos::RAW, {{data->data(), data->size(), data}})) {
+    MS_LOG(WARNING) << "Server response message failed.";
+  }
+}
+
 std::shared_ptr<CommunicatorBase> AbstractNode::GetOrCreateHttpComm(
   const std::string &ip, uint16_t port, const std::shared_ptr<TaskExecutor> &task_executor) {
   MS_EXCEPTION_IF_NULL(task_executor);
@@ -1000,6 +1025,9 @@ const std::shared_ptr<TcpClient> &AbstractNode::GetOrCreateTcpClient(const uint3
       }
       NotifyMessageArrival(meta);
     });
+    client->SetBufferAllocator([&](const std::shared_ptr<MessageMeta> &meta, size_t size) {
+      return RegisterResponseBuffer(meta, size);
+    });
     client->Init();
     connected_nodes_[key] = client;
     return connected_nodes_[key];
@@ -1044,6 +1072,19 @@ bool AbstractNode::SendMessageSync(const std::shared_ptr<TcpClient> &client, con
   return Wait(request_id, timeout);
 }
 
+bool AbstractNode::SendMessageSync(const std::shared_ptr<TcpClient> &client, const std::shared_ptr<MessageMeta> &meta,
+                                   const Protos &protos, const std::vector<MessageSegment> &segments,
+                                   const uint32_t &timeout) {
+  MS_EXCEPTION_IF_NULL(client);
+  MS_EXCEPTION_IF_NULL(meta);
+  uint64_t request_id = AddMessageTrack(1);
+  meta->set_request_id(request_id);
+  client->SendMessage(meta, protos, segments);
+  MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
+                << ", the node id is:" << node_info_.node_id_ << " send the request id is:" << request_id;
+  return Wait(request_id, timeout);
+}
+
 void AbstractNode::ProcessCollectiveSendData(const std::shared_ptr<TcpConnection> &conn,
                                              const std::shared_ptr<MessageMeta> &meta, const void *data, size_t size) {
   MS_EXCEPTION_IF_NULL(conn);
@@ -1059,20 +1100,21 @@ void AbstractNode::ProcessSendData(const std::shared_ptr<TcpConnection> &conn, c
   MS_EXCEPTION_IF_NULL(conn);
   MS_EXCEPTION_IF_NULL(meta);
   MS_EXCEPTION_IF_NULL(data);
+  // The data received into the request buffer is handled directly, otherwise it's copied.
+  DataPtr res = TakeRequestBuffer(data);
+  if (res == nullptr) {
 #ifdef __APPLE__
-  std::shared_ptr<unsigned char> res(new unsigned char[size], std::default_delete<unsigned char[]>());
+    res = std::shared_ptr<unsigned char>(new unsigned char[size], std::default_delete<unsigned char[]>());
 #else
-  if (size < 0) {
-    MS_LOG(EXCEPTION) << "size < 0";
-  }
-  std::shared_ptr<unsigned char[]> res(new unsigned char[size]);
+    res = std::shared_ptr<unsigned char[]>(new unsigned char[size]);
 #endif
-  if (size > 0) {
-    size_t dest_size = size;
-    size_t src_size = size;
-    auto ret = memcpy_s(res.get(), dest_size, data, src_size);
-    if (ret != EOK) {
-      MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+    if (size > 0) {
+      size_t dest_size = size;
+      size_t src_size = size;
+      auto ret = memcpy_s(res.get(), dest_size, data, src_size);
+      if (ret != EOK) {
+        MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+      }
     }
   }
   MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
@@ -1084,6 +1126,44 @@ void AbstractNode::ProcessSendData(const std::shared_ptr<TcpConnection> &conn, c
   request_handler_(conn, meta, res, size);
 }
 
+std::shared_ptr<void> AbstractNode::AllocateRequestBuffer(const std::shared_ptr<MessageMeta> &meta, size_t size) {
+  MS_EXCEPTION_IF_NULL(meta);
+  if (meta->cmd() != NodeCommand::SEND_DATA || size == 0) {
+    return nullptr;
+  }
+#ifdef __APPLE__
+  DataPtr buffer(new unsigned char[size], std::default_delete<unsigned char[]>());
+#else
+  DataPtr buffer(new unsigned char[size]);
+#endif
+  std::lock_guard<std::mutex> lock(request_buffers_mutex_);
+  // The buffer of the message dropped by the broken connection is released by the connection, and its expired entry is
+  // pruned once the entries double, so the pruning is amortized over the requests.
+  if (request_buffers_.size() >= request_buffers_prune_size_) {
+    for (auto iter = request_buffers_.begin(); iter != request_buffers_.end();) {
+      if (iter->second.expired()) {
+        iter = request_buffers_.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+    request_buffers_prune_size_ = std::max(kMinRequestBuffersPruneSize, request_buffers_.size() * 2);
+  }
+  request_buffers_[buffer.get()] = buffer;
+  return buffer;
+}
+
+AbstractNode::DataPtr AbstractNode::TakeRequestBuffer(const void *data) {
+  std::lock_guard<std::mutex> lock(request_buffers_mutex_);
+  auto iter = request_buffers_.find(data);
+  if (iter == request_buffers_.end()) {
+    return nullptr;
+  }
+  DataPtr buffer = iter->second.lock();
+  (void)request_buffers_.erase(iter);
+  return buffer;
+}
+
 void AbstractNode::NotifyMessageArrival(const std::shared_ptr<MessageMeta> &meta) {
   MS_EXCEPTION_IF_NULL(meta);
   std::lock_guard<std::mutex> lock(message_tracker_mutex_);
@@ -1262,7 +1342,15 @@ void AbstractNode::CreateTcpServer() {
   std::string interface;
   std::string server_ip;
   CommUtil::GetAvailableInterfaceAndIP(&interface, &server_ip);
-  server_ = std::make_shared<TcpServer>(server_ip, 0, config_.get());
+  // The data messages from the connections are received by the reactors concurrently.
+  int64_t reactor_num = kReactorNumDefault;
+  if (config_->Exists(kReactorNum)) {
+    reactor_num = config_->GetInt(kReactorNum, kReactorNumDefault);
+  }
+  if (reactor_num <= 0) {
+    MS_LOG(EXCEPTION) << "The reactor num " << reactor_num << " of tcp server should be positive.";
+  }
+  server_ = std::make_shared<TcpServer>(server_ip, 0, config_.get(), LongToSize(reactor_num));
   MS_EXCEPTION_IF_NULL(server_);
   server_->SetMessageCallback([&](const std::shared_ptr<TcpConnection> &conn, const std::shared_ptr<MessageMeta> &meta,
                                   const Protos &protos, const void *data, size_t size) {
@@ -1283,6 +1371,9 @@ void AbstractNode::CreateTcpServer() {
       (this->*handler_ptr)(conn, meta, protos, data, size);
     }
   });
+  server_->SetBufferAllocator([&](const std::shared_ptr<MessageMeta> &meta, size_t size) {
+    return AllocateRequestBuffer(meta, size);
+  });
   server_->Init();
   server_thread_ = std::make_unique<std::thread>([this]() {
     MS_LOG(INFO) << "The server node start a tcp server!";
@@ -37,6 +37,7 @@
 namespace mindspore {
 namespace ps {
 namespace core {
+constexpr size_t kMinRequestBuffersPruneSize = 64;
 class FollowerScaler;
 class AbstractNode : public Node {
  public:
@@ -106,7 +107,10 @@ class AbstractNode : public Node {
             const std::vector<size_t> &data_lens, int command, std::vector<VectorPtr> *output,
             const uint32_t &timeout = kCommTimeoutInSeconds);
 
-  uint64_t CollectiveSendAsync(const NodeRole &node_role, const uint32_t &rank_id, const void *data, size_t size);
+  // The collective sends and the node ips are virtual, so the collective operations could run on the nodes without the
+  // network in the tests.
+  virtual uint64_t CollectiveSendAsync(const NodeRole &node_role, const uint32_t &rank_id, const void *data,
+                                       size_t size);
   std::pair<uint32_t, uint64_t> CollectiveReceiveAsync(const NodeRole &node_role, const uint32_t &rank_id,
                                                        VectorPtr *output);
   bool CollectiveWait(const std::pair<uint32_t, uint64_t> &request_id, const uint32_t &timeout = kCommTimeoutInSeconds);
@@ -137,11 +141,17 @@ class AbstractNode : public Node {
   uint16_t scheduler_port() const;
   void set_scheduler_port(const uint16_t &scheduler_port);
 
+  // Get the ip of the node with the role and rank id, which is empty if the node is unknown.
+  virtual std::string GetNodeIp(const NodeRole &node_role, const uint32_t &rank_id);
+
   ClusterState cluster_state() const;
 
   void set_handler(const RequestHandler &handler);
   void Response(const std::shared_ptr<TcpConnection> &conn, const std::shared_ptr<MessageMeta> &meta, const void *data,
                 size_t size);
+  // Response the data without copy, the data is released after it's written to the connection.
+  void Response(const std::shared_ptr<TcpConnection> &conn, const std::shared_ptr<MessageMeta> &meta,
+                const VectorPtr &data);
 
   std::shared_ptr<CommunicatorBase> GetOrCreateHttpComm(const std::string &ip, uint16_t port,
                                                         const std::shared_ptr<TaskExecutor> &task_executor);
@@ -197,12 +207,19 @@ class AbstractNode : public Node {
                        const uint32_t &timeout = kCommTimeoutInSeconds);
   bool SendMessageSync(const std::shared_ptr<TcpClient> &client, const std::shared_ptr<MessageMeta> &meta,
                        const Protos &, const void *, size_t size, const uint32_t &timeout = kCommTimeoutInSeconds);
+  bool SendMessageSync(const std::shared_ptr<TcpClient> &client, const std::shared_ptr<MessageMeta> &meta,
+                       const Protos &protos, const std::vector<MessageSegment> &segments,
+                       const uint32_t &timeout = kCommTimeoutInSeconds);
   uint64_t SendMessageAsync(const std::shared_ptr<TcpClient> &client, const std::shared_ptr<MessageMeta> &meta,
                             const Protos &protos, const void *data, size_t size);
   void ProcessCollectiveSendData(const std::shared_ptr<TcpConnection> &conn, const std::shared_ptr<MessageMeta> &meta,
                                  const void *data, size_t size);
   void ProcessSendData(const std::shared_ptr<TcpConnection> &conn, const std::shared_ptr<MessageMeta> &meta,
                        const Protos &protos, const void *data, size_t size);
+  // Allocate the buffer receiving the data of the SEND_DATA request, which is handed to the request handler directly.
+  std::shared_ptr<void> AllocateRequestBuffer(const std::shared_ptr<MessageMeta> &meta, size_t size);
+  // Take the request buffer of the received data, return nullptr if the data is not received into the request buffer.
+  DataPtr TakeRequestBuffer(const void *data);
   void NotifyMessageArrival(const std::shared_ptr<MessageMeta> &meta);
   void RunReceiveCallback(const std::shared_ptr<MessageMeta> &meta, const Protos &protos, const void *data,
                           size_t size);
@@ -299,6 +316,12 @@ class AbstractNode : public Node {
   std::unordered_map<std::string, NodeInfo> all_nodes_info_;
   RequestHandler request_handler_;
 
+  // The buffers receiving the data of requests, the key is the address of the buffer.
+  std::unordered_map<const void *, DataPtr::weak_type> request_buffers_;
+  // The number of the entries at which the expired entries of the dropped messages are pruned.
+  size_t request_buffers_prune_size_{kMinRequestBuffersPruneSize};
+  std::mutex request_buffers_mutex_;
+
   std::unordered_map<std::string, std::shared_ptr<CommunicatorBase>> communicators_;
   std::mutex communicator_mutex_;
   std::mutex cluster_state_mutex_;
@@ -33,12 +33,16 @@
 namespace mindspore {
 namespace ps {
 namespace core {
-event_base *TcpClient::event_base_ = nullptr;
+std::vector<event_base *> TcpClient::event_bases_;
+std::vector<std::thread> TcpClient::reactor_threads_;
+size_t TcpClient::next_reactor_ = 0;
+size_t TcpClient::client_num_ = 0;
 std::mutex TcpClient::event_base_mutex_;
 bool TcpClient::is_started_ = false;
 
 TcpClient::TcpClient(const std::string &address, std::uint16_t port, Configuration *const config)
-    : event_timeout_(nullptr),
+    : event_base_(nullptr),
+      event_timeout_(nullptr),
       buffer_event_(nullptr),
       server_address_(std::move(address)),
       server_port_(port),
@@ -62,6 +66,10 @@ TcpClient::~TcpClient() {
     event_free(event_timeout_);
     event_timeout_ = nullptr;
   }
+  if (event_base_ != nullptr) {
+    ReleaseEventBase();
+    event_base_ = nullptr;
+  }
 }
 
 std::string TcpClient::GetServerAddress() const { return server_address_; }
@@ -92,7 +100,7 @@ void TcpClient::Init() {
     MS_LOG(EXCEPTION) << "Use event pthread failed!";
   }
   if (event_base_ == nullptr) {
-    event_base_ = event_base_new();
+    event_base_ = AssignEventBase(GetReactorNum());
     MS_EXCEPTION_IF_NULL(event_base_);
   }
 
@@ -133,8 +141,10 @@ void TcpClient::StartWithDelay(int seconds) {
     return;
   }
 
-  event_base_ = event_base_new();
-  MS_EXCEPTION_IF_NULL(event_base_);
+  if (event_base_ == nullptr) {
+    event_base_ = AssignEventBase(GetReactorNum());
+    MS_EXCEPTION_IF_NULL(event_base_);
+  }
 
   timeval timeout_value{};
   timeout_value.tv_sec = seconds;
@@ -149,12 +159,17 @@ void TcpClient::StartWithDelay(int seconds) {
 
 void TcpClient::Stop() {
   MS_EXCEPTION_IF_NULL(event_base_);
-  std::lock_guard<std::mutex> lock(connection_mutex_);
-  MS_LOG(INFO) << "Stop tcp client!";
-  int ret = event_base_loopbreak(event_base_);
-  if (ret != 0) {
-    MS_LOG(ERROR) << "Event base loop break failed!";
+  {
+    std::lock_guard<std::mutex> lock(connection_mutex_);
+    MS_LOG(INFO) << "Stop tcp client!";
+    int ret = event_base_loopbreak(event_base_);
+    if (ret != 0) {
+      MS_LOG(ERROR) << "Event base loop break failed!";
+    }
   }
+  // The reactors are shared by all the clients, so they are stopped together like the single event loop before. The
+  // connection lock is released before joining the reactors, whose callbacks may take it.
+  StopReactors();
 }
 
 void TcpClient::SetTcpNoDelay(const evutil_socket_t &fd) {
@@ -176,6 +191,11 @@ void TcpClient::ReadCallback(struct bufferevent *bev, void *ctx) {
   MS_EXCEPTION_IF_NULL(ctx);
   auto tcp_client = reinterpret_cast<TcpClient *>(ctx);
 
+  if (!tcp_client->read_callback_) {
+    // The message is removed from the event buffer into its own buffer directly, without the intermediate chunk.
+    tcp_client->message_handler_.ReceiveMessage(bufferevent_get_input(bev));
+    return;
+  }
   char read_buffer[kMessageChunkLength];
   int read = 0;
 
@@ -250,10 +270,16 @@ void TcpClient::Start() {
     event_base_mutex_.unlock();
     return;
   }
+  if (event_bases_.empty()) {
+    event_base_mutex_.unlock();
+    MS_LOG(EXCEPTION) << "The tcp client should be initialized before start.";
+  }
   is_started_ = true;
+  auto main_event_base = event_bases_[0];
   event_base_mutex_.unlock();
-  MS_EXCEPTION_IF_NULL(event_base_);
-  int ret = event_base_dispatch(event_base_);
+  StartReactors();
+  MS_EXCEPTION_IF_NULL(main_event_base);
+  int ret = event_base_dispatch(main_event_base);
   // is_started_ should be false when finish dispatch
   is_started_ = false;
   MSLOG_IF(INFO, ret == 0, NoExceptionType) << "Event base dispatch success!";
@@ -276,6 +302,10 @@ void TcpClient::StartWithNoBlock() {
 
 void TcpClient::SetMessageCallback(const OnMessage &cb) { message_callback_ = cb; }
 
+void TcpClient::SetBufferAllocator(const ReceiveBufferAllocator &allocator) {
+  message_handler_.SetBufferAllocator(allocator);
+}
+
 bool TcpClient::SendMessage(const CommMessage &message) const {
   MS_EXCEPTION_IF_NULL(buffer_event_);
   bufferevent_lock(buffer_event_);
@@ -304,29 +334,16 @@ bool TcpClient::SendMessage(const CommMessage &message) const {
 
 bool TcpClient::SendMessage(const std::shared_ptr<MessageMeta> &meta, const Protos &protos, const void *data,
                             size_t size) {
+  MS_EXCEPTION_IF_NULL(data);
+  return SendMessage(meta, protos, {{data, size, nullptr}});
+}
+
+bool TcpClient::SendMessage(const std::shared_ptr<MessageMeta> &meta, const Protos &protos,
+                            const std::vector<MessageSegment> &segments) {
   MS_EXCEPTION_IF_NULL(buffer_event_);
   MS_EXCEPTION_IF_NULL(meta);
-  MS_EXCEPTION_IF_NULL(data);
   bufferevent_lock(buffer_event_);
-  bool res = true;
-
-  MessageHeader header;
-  header.message_proto_ = protos;
-  header.message_meta_length_ = SizeToUint(meta->ByteSizeLong());
-  header.message_length_ = size + header.message_meta_length_;
-
-  if (bufferevent_write(buffer_event_, &header, sizeof(header)) == -1) {
-    MS_LOG(ERROR) << "Event buffer add header failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, meta->SerializeAsString().data(), meta->ByteSizeLong()) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, data, size) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
+  bool res = WriteMessage(buffer_event_, meta, protos, segments);
   int result = bufferevent_flush(buffer_event_, EV_READ | EV_WRITE, BEV_FLUSH);
   if (result < 0) {
     MS_LOG(ERROR) << "Bufferevent flush failed!";
@@ -338,6 +355,93 @@ bool TcpClient::SendMessage(const std::shared_ptr<MessageMeta> &meta, const Prot
 
 void TcpClient::set_timer_callback(const OnTimer &timer) { on_timer_callback_ = timer; }
 
+size_t TcpClient::GetReactorNum() const {
+  int64_t reactor_num = kReactorNumDefault;
+  if (config_ != nullptr && config_->Exists(kReactorNum)) {
+    reactor_num = config_->GetInt(kReactorNum, kReactorNumDefault);
+  }
+  if (reactor_num <= 0) {
+    MS_LOG(EXCEPTION) << "The reactor num " << reactor_num << " of tcp client should be positive.";
+  }
+  return LongToSize(reactor_num);
+}
+
+event_base *TcpClient::AssignEventBase(size_t reactor_num) {
+  std::lock_guard<std::mutex> lock(event_base_mutex_);
+  if (event_bases_.empty()) {
+    for (size_t i = 0; i < reactor_num; ++i) {
+      auto base = event_base_new();
+      MS_EXCEPTION_IF_NULL(base);
+      (void)event_bases_.emplace_back(base);
+    }
+    MS_LOG(INFO) << "The tcp client creates " << reactor_num << " reactors.";
+  }
+  auto base = event_bases_[next_reactor_ % event_bases_.size()];
+  ++next_reactor_;
+  ++client_num_;
+  return base;
+}
+
+void TcpClient::ReleaseEventBase() {
+  {
+    std::lock_guard<std::mutex> lock(event_base_mutex_);
+    if (client_num_ == 0 || --client_num_ > 0) {
+      return;
+    }
+  }
+  StopReactors();
+  std::lock_guard<std::mutex> lock(event_base_mutex_);
+  // The first event loop may still be dispatched by Start, then it's left to the process exit.
+  if (is_started_) {
+    MS_LOG(WARNING) << "The event loop of tcp client is still running, the event bases are not freed.";
+    return;
+  }
+  for (auto base : event_bases_) {
+    event_base_free(base);
+  }
+  event_bases_.clear();
+  next_reactor_ = 0;
+  MS_LOG(INFO) << "The reactors of tcp client are freed.";
+}
+
+void TcpClient::StartReactors() {
+  std::lock_guard<std::mutex> lock(event_base_mutex_);
+  if (!reactor_threads_.empty()) {
+    return;
+  }
+  for (size_t i = 1; i < event_bases_.size(); ++i) {
+    auto base = event_bases_[i];
+    (void)reactor_threads_.emplace_back([i, base]() {
+      MS_LOG(INFO) << "The tcp client reactor " << i << " starts.";
+      // The reactor keeps running when there are no connections assigned to it yet.
+      int ret = event_base_loop(base, EVLOOP_NO_EXIT_ON_EMPTY);
+      MSLOG_IF(mindspore::ERROR, ret == -1, NoExceptionType) << "Event base loop of reactor " << i << " failed!";
+    });
+  }
+}
+
+void TcpClient::StopReactors() {
+  std::vector<std::thread> reactor_threads;
+  {
+    std::lock_guard<std::mutex> lock(event_base_mutex_);
+    for (auto base : event_bases_) {
+      if (event_base_loopbreak(base) != 0) {
+        MS_LOG(ERROR) << "Event base loop break failed!";
+      }
+    }
+    reactor_threads.swap(reactor_threads_);
+  }
+  // The reactor threads are joined out of the lock, and the client may be stopped in the callback of a reactor, which
+  // can't join itself.
+  for (auto &reactor_thread : reactor_threads) {
+    if (reactor_thread.get_id() == std::this_thread::get_id()) {
+      reactor_thread.detach();
+    } else if (reactor_thread.joinable()) {
+      reactor_thread.join();
+    }
+  }
+}
+
 const event_base &TcpClient::eventbase() const { return *event_base_; }
 }  // namespace core
 }  // namespace ps
@@ -68,8 +68,13 @@ class TcpClient {
   void Start();
   void StartWithNoBlock();
   void SetMessageCallback(const OnMessage &cb);
+  // Set the allocator of the buffers receiving the message data, such as the buffers registered by the request id.
+  void SetBufferAllocator(const ReceiveBufferAllocator &allocator);
   bool SendMessage(const CommMessage &message) const;
   bool SendMessage(const std::shared_ptr<MessageMeta> &meta, const Protos &protos, const void *data, size_t size);
+  // Send the message data as the segments, the segments with owner are referenced without copy.
+  bool SendMessage(const std::shared_ptr<MessageMeta> &meta, const Protos &protos,
+                   const std::vector<MessageSegment> &segments);
   void set_timer_callback(const OnTimer &timer);
   const event_base &eventbase() const;
 
@@ -82,6 +87,15 @@ class TcpClient {
   static void TimerCallback(evutil_socket_t fd, int16_t event, void *arg);
   void NotifyConnected();
   bool EstablishSSL();
+  size_t GetReactorNum() const;
+
+  // The event loops of reactors are shared by all the clients and created at the first call, the clients are assigned
+  // to them in turn. The first reactor is run by Start, and the others are run in their own threads which are joined
+  // by Stop. The event loops are freed with the last client.
+  static event_base *AssignEventBase(size_t reactor_num);
+  static void ReleaseEventBase();
+  static void StartReactors();
+  static void StopReactors();
 
  private:
   OnMessage message_callback_;
@@ -93,10 +107,15 @@ class TcpClient {
   OnTimeout timeout_callback_;
   OnTimer on_timer_callback_;
 
-  static event_base *event_base_;
+  static std::vector<event_base *> event_bases_;
+  static std::vector<std::thread> reactor_threads_;
+  static size_t next_reactor_;
+  static size_t client_num_;
   static std::mutex event_base_mutex_;
   static bool is_started_;
 
+  event_base *event_base_;
+
   std::mutex connection_mutex_;
   std::condition_variable connection_cond_;
   event *event_timeout_;
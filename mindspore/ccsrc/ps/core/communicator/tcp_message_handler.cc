@@ -17,6 +17,8 @@
 #include "ps/core/communicator/tcp_message_handler.h"
 
 #include <arpa/inet.h>
+#include <algorithm>
+#include <climits>
 #include <iostream>
 #include <utility>
 #include <memory>
@@ -24,72 +26,174 @@
 namespace mindspore {
 namespace ps {
 namespace core {
+namespace {
+void FreeSegmentOwner(const void *, size_t, void *owner) { delete static_cast<std::shared_ptr<void> *>(owner); }
+}  // namespace
+
+bool WriteMessage(struct bufferevent *bev, const std::shared_ptr<MessageMeta> &meta, const Protos &protos,
+                  const std::vector<MessageSegment> &segments) {
+  MS_EXCEPTION_IF_NULL(bev);
+  MS_EXCEPTION_IF_NULL(meta);
+  size_t data_size = 0;
+  for (const auto &segment : segments) {
+    data_size += segment.size;
+  }
+  MessageHeader header;
+  header.message_proto_ = protos;
+  header.message_meta_length_ = SizeToUint(meta->ByteSizeLong());
+  header.message_length_ = data_size + header.message_meta_length_;
+
+  if (bufferevent_write(bev, &header, sizeof(header)) == -1) {
+    MS_LOG(ERROR) << "Event buffer add header failed!";
+    return false;
+  }
+  if (bufferevent_write(bev, meta->SerializeAsString().data(), meta->ByteSizeLong()) == -1) {
+    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
+    return false;
+  }
+  struct evbuffer *output = bufferevent_get_output(bev);
+  MS_EXCEPTION_IF_NULL(output);
+  for (const auto &segment : segments) {
+    if (segment.size == 0) {
+      continue;
+    }
+    MS_EXCEPTION_IF_NULL(segment.data);
+    if (segment.owner == nullptr || segment.size < kMessageReferenceMinSize) {
+      if (evbuffer_add(output, segment.data, segment.size) == -1) {
+        MS_LOG(ERROR) << "Event buffer add data segment failed!";
+        return false;
+      }
+      continue;
+    }
+    // The segment is written by writev from the memory of owner, which is released after the segment is drained.
+    auto owner = new std::shared_ptr<void>(segment.owner);
+    if (evbuffer_add_reference(output, segment.data, segment.size, FreeSegmentOwner, owner) == -1) {
+      delete owner;
+      MS_LOG(ERROR) << "Event buffer add data segment reference failed!";
+      return false;
+    }
+  }
+  return true;
+}
+
 void TcpMessageHandler::SetCallback(const messageReceive &message_receive) { message_callback_ = message_receive; }
 
+void TcpMessageHandler::SetBufferAllocator(const ReceiveBufferAllocator &allocator) { buffer_allocator_ = allocator; }
+
 void TcpMessageHandler::ReceiveMessage(const void *buffer, size_t num) {
   MS_EXCEPTION_IF_NULL(buffer);
   auto buffer_data = reinterpret_cast<const unsigned char *>(buffer);
-
-  while (num > 0) {
-    if (remaining_length_ == 0) {
-      for (int i = 0; i < kHeaderLen && num > 0; ++i) {
-        header_[++header_index_] = *(buffer_data + i);
-        --num;
-        if (header_index_ == kHeaderLen - 1) {
-          message_header_.message_proto_ = *reinterpret_cast<const Protos *>(header_);
-          if (message_header_.message_proto_ != Protos::RAW && message_header_.message_proto_ != Protos::FLATBUFFERS &&
-              message_header_.message_proto_ != Protos::PROTOBUF) {
-            MS_LOG(WARNING) << "The proto:" << message_header_.message_proto_ << " is illegal!";
-            return;
-          }
-          message_header_.message_meta_length_ =
-            *reinterpret_cast<const uint32_t *>(header_ + sizeof(message_header_.message_proto_));
-          message_header_.message_length_ = *reinterpret_cast<const size_t *>(
-            header_ + sizeof(message_header_.message_proto_) + sizeof(message_header_.message_meta_length_));
-          if (message_header_.message_length_ >= UINT32_MAX) {
-            MS_LOG(WARNING) << "The message len:" << message_header_.message_length_ << " is too long.";
-            return;
-          }
-          remaining_length_ = message_header_.message_length_;
-          message_buffer_ = std::make_unique<unsigned char[]>(remaining_length_);
-          MS_EXCEPTION_IF_NULL(message_buffer_);
-          buffer_data += (i + 1);
-          break;
-        }
-      }
+  (void)Receive(num, [&buffer_data](void *dest, size_t len) {
+    auto ret = memcpy_s(dest, len, buffer_data, len);
+    if (ret != EOK) {
+      MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
     }
+    buffer_data += len;
+    return len;
+  });
+}
 
-    if (remaining_length_ > 0 && num > 0) {
-      size_t copy_len = remaining_length_ <= num ? remaining_length_ : num;
-      remaining_length_ -= copy_len;
-      num -= copy_len;
+void TcpMessageHandler::ReceiveMessage(struct evbuffer *buffer) {
+  MS_EXCEPTION_IF_NULL(buffer);
+  bool res = Receive(evbuffer_get_length(buffer), [buffer](void *dest, size_t len) {
+    int read = evbuffer_remove(buffer, dest, std::min(len, static_cast<size_t>(INT_MAX)));
+    if (read == -1) {
+      MS_LOG(EXCEPTION) << "Can not drain data from the event buffer!";
+    }
+    return IntToSize(read);
+  });
+  if (!res && evbuffer_drain(buffer, evbuffer_get_length(buffer)) == -1) {
+    MS_LOG(ERROR) << "Drain the illegal message from the event buffer failed!";
+  }
+}
 
-      size_t dest_size = copy_len;
-      size_t src_size = copy_len;
-      auto ret = memcpy_s(message_buffer_.get() + last_copy_len_, dest_size, buffer_data, src_size);
-      last_copy_len_ += copy_len;
-      buffer_data += copy_len;
-      if (ret != EOK) {
-        MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+bool TcpMessageHandler::Receive(size_t num, const Reader &reader) {
+  const size_t header_len = IntToSize(kHeaderLen);
+  while (num > 0) {
+    size_t read_len = 0;
+    if (header_len_ < header_len) {
+      read_len = reader(header_ + header_len_, std::min(num, header_len - header_len_));
+      header_len_ += read_len;
+      if (header_len_ == header_len && !ParseHeader()) {
+        Reset();
+        return false;
       }
+    } else if (meta_len_ < meta_buffer_.size()) {
+      read_len = reader(meta_buffer_.data() + meta_len_, std::min(num, meta_buffer_.size() - meta_len_));
+      meta_len_ += read_len;
+      if (meta_len_ == meta_buffer_.size()) {
+        ParseMeta();
+      }
+    } else {
+      read_len = reader(static_cast<unsigned char *>(data_buffer_.get()) + data_len_,
+                        std::min(num, data_size_ - data_len_));
+      data_len_ += read_len;
+    }
+    if (read_len == 0) {
+      break;
+    }
+    num -= read_len;
 
-      if (remaining_length_ == 0) {
-        if (message_callback_) {
-          std::shared_ptr<MessageMeta> pb_message = std::make_shared<MessageMeta>();
-          MS_EXCEPTION_IF_NULL(pb_message);
-          CHECK_RETURN_TYPE(
-            pb_message->ParseFromArray(message_buffer_.get(), UintToInt(message_header_.message_meta_length_)));
-          message_callback_(pb_message, message_header_.message_proto_,
-                            message_buffer_.get() + message_header_.message_meta_length_,
-                            message_header_.message_length_ - message_header_.message_meta_length_);
-        }
-        message_buffer_.reset();
-        message_buffer_ = nullptr;
-        header_index_ = -1;
-        last_copy_len_ = 0;
+    if (meta_ != nullptr && data_len_ == data_size_) {
+      if (message_callback_) {
+        message_callback_(meta_, message_header_.message_proto_, data_buffer_.get(), data_size_);
       }
+      Reset();
     }
   }
+  return true;
+}
+
+bool TcpMessageHandler::ParseHeader() {
+  message_header_.message_proto_ = *reinterpret_cast<const Protos *>(header_);
+  if (message_header_.message_proto_ != Protos::RAW && message_header_.message_proto_ != Protos::FLATBUFFERS &&
+      message_header_.message_proto_ != Protos::PROTOBUF) {
+    MS_LOG(WARNING) << "The proto:" << message_header_.message_proto_ << " is illegal!";
+    return false;
+  }
+  message_header_.message_meta_length_ =
+    *reinterpret_cast<const uint32_t *>(header_ + sizeof(message_header_.message_proto_));
+  message_header_.message_length_ = *reinterpret_cast<const size_t *>(
+    header_ + sizeof(message_header_.message_proto_) + sizeof(message_header_.message_meta_length_));
+  if (message_header_.message_length_ >= UINT32_MAX) {
+    MS_LOG(WARNING) << "The message len:" << message_header_.message_length_ << " is too long.";
+    return false;
+  }
+  if (message_header_.message_length_ < message_header_.message_meta_length_) {
+    MS_LOG(WARNING) << "The message len:" << message_header_.message_length_
+                    << " is less than the meta len:" << message_header_.message_meta_length_;
+    return false;
+  }
+  meta_buffer_.resize(message_header_.message_meta_length_);
+  data_size_ = message_header_.message_length_ - message_header_.message_meta_length_;
+  if (meta_buffer_.empty()) {
+    ParseMeta();
+  }
+  return true;
+}
+
+void TcpMessageHandler::ParseMeta() {
+  meta_ = std::make_shared<MessageMeta>();
+  MS_EXCEPTION_IF_NULL(meta_);
+  CHECK_RETURN_TYPE(meta_->ParseFromArray(meta_buffer_.data(), SizeToInt(meta_buffer_.size())));
+  // The data is received into the registered buffer directly if any, so it's not copied again by the receiver.
+  if (buffer_allocator_) {
+    data_buffer_ = buffer_allocator_(meta_, data_size_);
+  }
+  if (data_buffer_ == nullptr) {
+    data_buffer_ = std::shared_ptr<unsigned char>(new unsigned char[data_size_], std::default_delete<unsigned char[]>());
+  }
+  MS_EXCEPTION_IF_NULL(data_buffer_);
+}
+
+void TcpMessageHandler::Reset() {
+  header_len_ = 0;
+  meta_buffer_.clear();
+  meta_len_ = 0;
+  meta_ = nullptr;
+  data_buffer_ = nullptr;
+  data_size_ = 0;
+  data_len_ = 0;
 }
 }  // namespace core
 }  // namespace ps
@@ -17,6 +17,9 @@
 #ifndef MINDSPORE_CCSRC_PS_CORE_COMMUNICATOR_TCP_MESSAGE_HANDLER_H_
 #define MINDSPORE_CCSRC_PS_CORE_COMMUNICATOR_TCP_MESSAGE_HANDLER_H_
 
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+
 #include <functional>
 #include <iostream>
 #include <string>
@@ -35,27 +38,57 @@ namespace ps {
 namespace core {
 using messageReceive =
   std::function<void(const std::shared_ptr<MessageMeta> &, const Protos &, const void *, size_t size)>;
+// Return the buffer to receive the data of the message, the message is received into the default buffer if nullptr
+// is returned. The returned shared pointer owns the buffer until the message is received and handled.
+using ReceiveBufferAllocator = std::function<std::shared_ptr<void>(const std::shared_ptr<MessageMeta> &, size_t size)>;
 constexpr int kHeaderLen = 16;
+// The data segment smaller than this is copied into the event buffer, since referencing it costs more than copying.
+constexpr size_t kMessageReferenceMinSize = 16384;
+
+// One data segment of the message, the message data is the concatenation of the segments. The segment is referenced by
+// the event buffer without copy if the owner is set, the owner keeps the memory alive until the segment is written.
+struct MessageSegment {
+  const void *data;
+  size_t size;
+  std::shared_ptr<void> owner;
+};
+
+// Write the message to the buffer event, the header and the meta are copied and the data segments are referenced.
+bool WriteMessage(struct bufferevent *bev, const std::shared_ptr<MessageMeta> &meta, const Protos &protos,
+                  const std::vector<MessageSegment> &segments);
 
 class TcpMessageHandler {
  public:
-  TcpMessageHandler()
-      : is_parsed_(false), message_buffer_(nullptr), remaining_length_(0), header_index_(-1), last_copy_len_(0) {}
+  TcpMessageHandler() = default;
   virtual ~TcpMessageHandler() = default;
 
   void SetCallback(const messageReceive &cb);
+  void SetBufferAllocator(const ReceiveBufferAllocator &allocator);
   void ReceiveMessage(const void *buffer, size_t num);
+  // Receive the message from the event buffer, the data is removed into the message buffer directly.
+  void ReceiveMessage(struct evbuffer *buffer);
 
  private:
+  // Copy the data into the destination and return the copied size.
+  using Reader = std::function<size_t(void *dest, size_t len)>;
+  // Receive num bytes by the reader, return false if the message is illegal.
+  bool Receive(size_t num, const Reader &reader);
+  bool ParseHeader();
+  void ParseMeta();
+  void Reset();
+
   messageReceive message_callback_;
-  bool is_parsed_;
-  std::unique_ptr<unsigned char[]> message_buffer_;
-  size_t remaining_length_;
-  unsigned char header_[16]{0};
-  int header_index_;
-  size_t last_copy_len_;
+  ReceiveBufferAllocator buffer_allocator_;
+  unsigned char header_[kHeaderLen]{0};
+  size_t header_len_{0};
   MessageHeader message_header_;
-  std::string mBuffer;
+  std::vector<unsigned char> meta_buffer_;
+  size_t meta_len_{0};
+  std::shared_ptr<MessageMeta> meta_{nullptr};
+  // The data of the message is received into the buffer separately from the meta.
+  std::shared_ptr<void> data_buffer_{nullptr};
+  size_t data_size_{0};
+  size_t data_len_{0};
 };
 }  // namespace core
 }  // namespace ps
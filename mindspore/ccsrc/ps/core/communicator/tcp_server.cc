@@ -35,11 +35,20 @@ namespace core {
 TcpConnection::~TcpConnection() { bufferevent_free(buffer_event_); }
 void TcpConnection::InitConnection(const messageReceive &callback) { tcp_message_handler_.SetCallback(callback); }
 
+void TcpConnection::SetBufferAllocator(const ReceiveBufferAllocator &allocator) {
+  tcp_message_handler_.SetBufferAllocator(allocator);
+}
+
 void TcpConnection::OnReadHandler(const void *buffer, size_t num) {
   MS_EXCEPTION_IF_NULL(buffer);
   tcp_message_handler_.ReceiveMessage(buffer, num);
 }
 
+void TcpConnection::OnReadHandler(struct evbuffer *buffer) {
+  MS_EXCEPTION_IF_NULL(buffer);
+  tcp_message_handler_.ReceiveMessage(buffer);
+}
+
 void TcpConnection::SendMessage(const void *buffer, size_t num) const {
   MS_EXCEPTION_IF_NULL(buffer);
   MS_EXCEPTION_IF_NULL(buffer_event_);
@@ -76,28 +85,16 @@ bool TcpConnection::SendMessage(const std::shared_ptr<CommMessage> &message) con
 
 bool TcpConnection::SendMessage(const std::shared_ptr<MessageMeta> &meta, const Protos &protos, const void *data,
                                 size_t size) const {
+  MS_EXCEPTION_IF_NULL(data);
+  return SendMessage(meta, protos, {{data, size, nullptr}});
+}
+
+bool TcpConnection::SendMessage(const std::shared_ptr<MessageMeta> &meta, const Protos &protos,
+                                const std::vector<MessageSegment> &segments) const {
   MS_EXCEPTION_IF_NULL(buffer_event_);
   MS_EXCEPTION_IF_NULL(meta);
-  MS_EXCEPTION_IF_NULL(data);
   bufferevent_lock(buffer_event_);
-  bool res = true;
-  MessageHeader header;
-  header.message_proto_ = protos;
-  header.message_meta_length_ = SizeToUint(meta->ByteSizeLong());
-  header.message_length_ = size + header.message_meta_length_;
-
-  if (bufferevent_write(buffer_event_, &header, sizeof(header)) == -1) {
-    MS_LOG(ERROR) << "Event buffer add header failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, meta->SerializeAsString().data(), meta->ByteSizeLong()) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, data, size) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
+  bool res = WriteMessage(buffer_event_, meta, protos, segments);
   int result = bufferevent_flush(buffer_event_, EV_READ | EV_WRITE, BEV_FLUSH);
   if (result < 0) {
     bufferevent_unlock(buffer_event_);
@@ -107,7 +104,8 @@ bool TcpConnection::SendMessage(const std::shared_ptr<MessageMeta> &meta, const
   return res;
 }
 
-TcpServer::TcpServer(const std::string &address, std::uint16_t port, Configuration *const config)
+TcpServer::TcpServer(const std::string &address, std::uint16_t port, Configuration *const config,
+                     size_t reactor_num)
     : base_(nullptr),
       signal_event_(nullptr),
       listener_(nullptr),
@@ -115,9 +113,18 @@ TcpServer::TcpServer(const std::string &address, std::uint16_t port, Configurati
       server_port_(port),
       is_stop_(true),
       config_(config),
-      max_connection_(0) {}
+      max_connection_(0),
+      reactor_num_(reactor_num),
+      next_reactor_(0) {}
 
 TcpServer::~TcpServer() {
+  StopReactors();
+  for (auto &reactor_thread : reactor_threads_) {
+    if (reactor_thread.joinable()) {
+      reactor_thread.join();
+    }
+  }
+
   if (signal_event_ != nullptr) {
     event_free(signal_event_);
     signal_event_ = nullptr;
@@ -132,6 +139,11 @@ TcpServer::~TcpServer() {
     event_base_free(base_);
     base_ = nullptr;
   }
+
+  for (auto reactor_base : reactor_bases_) {
+    event_base_free(reactor_base);
+  }
+  reactor_bases_.clear();
 }
 
 void TcpServer::SetServerCallback(const OnConnected &client_conn, const OnDisconnected &client_disconn,
@@ -163,6 +175,11 @@ void TcpServer::Init() {
     max_connection_ = config_->GetInt(kConnectionNum, 0);
   }
   MS_LOG(INFO) << "The max connection is:" << max_connection_;
+  for (size_t i = 1; i < reactor_num_; ++i) {
+    auto reactor_base = event_base_new();
+    MS_EXCEPTION_IF_NULL(reactor_base);
+    (void)reactor_bases_.emplace_back(reactor_base);
+  }
 
   struct sockaddr_in sin {};
   if (memset_s(&sin, sizeof(sin), 0, sizeof(sin)) != EOK) {
@@ -201,6 +218,18 @@ void TcpServer::Init() {
 void TcpServer::Start() {
   MS_LOG(INFO) << "Start tcp server!";
   MS_EXCEPTION_IF_NULL(base_);
+  if (reactor_threads_.empty()) {
+    for (size_t i = 0; i < reactor_bases_.size(); ++i) {
+      auto reactor_base = reactor_bases_[i];
+      (void)reactor_threads_.emplace_back([i, reactor_base]() {
+        MS_LOG(INFO) << "The tcp server reactor " << (i + 1) << " starts.";
+        // The reactor keeps running when there are no connections assigned to it yet.
+        int ret = event_base_loop(reactor_base, EVLOOP_NO_EXIT_ON_EMPTY);
+        MSLOG_IF(mindspore::ERROR, ret == -1, NoExceptionType)
+          << "Event base loop of reactor " << (i + 1) << " failed!";
+      });
+    }
+  }
   int ret = event_base_dispatch(base_);
   MSLOG_IF(INFO, ret == 0, NoExceptionType) << "Event base dispatch success!";
   MSLOG_IF(mindspore::ERROR, ret == 1, NoExceptionType)
@@ -224,6 +253,7 @@ void TcpServer::Stop() {
   MS_EXCEPTION_IF_NULL(base_);
   std::lock_guard<std::mutex> lock(connection_mutex_);
   MS_LOG(INFO) << "Stop tcp server!";
+  StopReactors();
   if (event_base_got_break(base_)) {
     MS_LOG(DEBUG) << "The event base has stopped!";
     is_stop_ = true;
@@ -238,6 +268,21 @@ void TcpServer::Stop() {
   }
 }
 
+void TcpServer::StopReactors() {
+  for (auto reactor_base : reactor_bases_) {
+    if (event_base_loopbreak(reactor_base) != 0) {
+      MS_LOG(ERROR) << "Event base loop break of reactor failed!";
+    }
+  }
+}
+
+struct event_base *TcpServer::NextReactorBase() {
+  // The listener callback is only called by the event loop of base_, so it's not required to lock.
+  size_t index = next_reactor_ % (reactor_bases_.size() + 1);
+  ++next_reactor_;
+  return index == 0 ? base_ : reactor_bases_[index - 1];
+}
+
 void TcpServer::SendToAllClients(const char *data, size_t len) {
   MS_EXCEPTION_IF_NULL(data);
   std::lock_guard<std::mutex> lock(connection_mutex_);
@@ -263,8 +308,7 @@ void TcpServer::ListenerCallback(struct evconnlistener *, evutil_socket_t fd, st
                                  void *data) {
   auto server = reinterpret_cast<class TcpServer *>(data);
   MS_EXCEPTION_IF_NULL(server);
-  auto base = reinterpret_cast<struct event_base *>(server->base_);
-  MS_EXCEPTION_IF_NULL(base);
+  MS_EXCEPTION_IF_NULL(server->base_);
   MS_EXCEPTION_IF_NULL(sockaddr);
 
   if (server->ConnectionNum() >= server->max_connection_) {
@@ -273,6 +317,9 @@ void TcpServer::ListenerCallback(struct evconnlistener *, evutil_socket_t fd, st
     return;
   }
 
+  // Assign the connection to the reactors in turn.
+  auto base = server->NextReactorBase();
+  MS_EXCEPTION_IF_NULL(base);
   struct bufferevent *bev = nullptr;
 
   if (!PSContext::instance()->enable_ssl()) {
@@ -287,7 +334,7 @@ void TcpServer::ListenerCallback(struct evconnlistener *, evutil_socket_t fd, st
   }
   if (bev == nullptr) {
     MS_LOG(ERROR) << "Error constructing buffer event!";
-    int ret = event_base_loopbreak(base);
+    int ret = event_base_loopbreak(server->base_);
     if (ret != 0) {
       MS_LOG(EXCEPTION) << "event base loop break failed!";
     }
@@ -305,6 +352,9 @@ void TcpServer::ListenerCallback(struct evconnlistener *, evutil_socket_t fd, st
         on_server_receive(conn, meta, protos, data, size);
       }
     });
+  if (server->buffer_allocator_) {
+    conn->SetBufferAllocator(server->buffer_allocator_);
+  }
   bufferevent_setcb(bev, TcpServer::ReadCallback, nullptr, TcpServer::EventCallback,
                     reinterpret_cast<void *>(conn.get()));
   MS_LOG(INFO) << "A client is connected, fd is " << fd;
@@ -346,14 +396,8 @@ void TcpServer::ReadCallback(struct bufferevent *bev, void *connection) {
   auto conn = static_cast<class TcpConnection *>(connection);
   struct evbuffer *buf = bufferevent_get_input(bev);
   MS_EXCEPTION_IF_NULL(buf);
-  char read_buffer[kMessageChunkLength];
-  while (EVBUFFER_LENGTH(buf) > 0) {
-    int read = evbuffer_remove(buf, &read_buffer, sizeof(read_buffer));
-    if (read == -1) {
-      MS_LOG(EXCEPTION) << "Can not drain data from the event buffer!";
-    }
-    conn->OnReadHandler(read_buffer, IntToSize(read));
-  }
+  // The message is removed from the event buffer into its own buffer directly, without the intermediate chunk.
+  conn->OnReadHandler(buf);
 }
 
 void TcpServer::EventCallback(struct bufferevent *bev, std::int16_t events, void *data) {
@@ -433,6 +477,13 @@ bool TcpServer::SendMessage(const std::shared_ptr<TcpConnection> &conn, const st
   return conn->SendMessage(meta, protos, data, size);
 }
 
+bool TcpServer::SendMessage(const std::shared_ptr<TcpConnection> &conn, const std::shared_ptr<MessageMeta> &meta,
+                            const Protos &protos, const std::vector<MessageSegment> &segments) {
+  MS_EXCEPTION_IF_NULL(conn);
+  MS_EXCEPTION_IF_NULL(meta);
+  return conn->SendMessage(meta, protos, segments);
+}
+
 void TcpServer::SendMessage(const std::shared_ptr<CommMessage> &message) {
   MS_EXCEPTION_IF_NULL(message);
   std::lock_guard<std::mutex> lock(connection_mutex_);
@@ -451,6 +502,8 @@ int TcpServer::ConnectionNum() const { return SizeToInt(connections_.size()); }
 const std::map<evutil_socket_t, std::shared_ptr<TcpConnection>> &TcpServer::Connections() const { return connections_; }
 
 void TcpServer::SetMessageCallback(const OnServerReceiveMessage &cb) { message_callback_ = cb; }
+
+void TcpServer::SetBufferAllocator(const ReceiveBufferAllocator &allocator) { buffer_allocator_ = allocator; }
 }  // namespace core
 }  // namespace ps
 }  // namespace mindspore
@@ -58,10 +58,14 @@ class TcpConnection {
   using Callback = std::function<void(const std::shared_ptr<CommMessage>)>;
 
   void InitConnection(const messageReceive &callback);
+  void SetBufferAllocator(const ReceiveBufferAllocator &allocator);
   void SendMessage(const void *buffer, size_t num) const;
   bool SendMessage(const std::shared_ptr<CommMessage> &message) const;
   bool SendMessage(const std::shared_ptr<MessageMeta> &meta, const Protos &protos, const void *data, size_t size) const;
+  bool SendMessage(const std::shared_ptr<MessageMeta> &meta, const Protos &protos,
+                   const std::vector<MessageSegment> &segments) const;
   void OnReadHandler(const void *buffer, size_t numBytes);
+  void OnReadHandler(struct evbuffer *buffer);
   const TcpServer *GetServer() const;
   const evutil_socket_t &GetFd() const;
   void set_callback(const Callback &callback);
@@ -86,7 +90,9 @@ class TcpServer {
   using OnTimerOnce = std::function<void(const TcpServer &)>;
   using OnTimer = std::function<void()>;
 
-  TcpServer(const std::string &address, std::uint16_t port, Configuration *const config);
+  // The accepted connections are assigned to the reactor_num event loops in turn, and the message callback may be
+  // called by the event loops concurrently if the reactor_num is greater than 1.
+  TcpServer(const std::string &address, std::uint16_t port, Configuration *const config, size_t reactor_num = 1);
   TcpServer(const TcpServer &server);
   virtual ~TcpServer();
 
@@ -104,9 +110,14 @@ class TcpServer {
   std::shared_ptr<TcpConnection> GetConnectionByFd(const evutil_socket_t &fd);
   OnServerReceiveMessage GetServerReceive() const;
   void SetMessageCallback(const OnServerReceiveMessage &cb);
+  // Set the allocator of the buffers receiving the message data, which is applied to the connections accepted later.
+  void SetBufferAllocator(const ReceiveBufferAllocator &allocator);
   bool SendMessage(const std::shared_ptr<TcpConnection> &conn, const std::shared_ptr<CommMessage> &message);
   bool SendMessage(const std::shared_ptr<TcpConnection> &conn, const std::shared_ptr<MessageMeta> &meta,
                    const Protos &protos, const void *data, size_t sizee);
+  // Send the message data as the segments, the segments with owner are referenced without copy.
+  bool SendMessage(const std::shared_ptr<TcpConnection> &conn, const std::shared_ptr<MessageMeta> &meta,
+                   const Protos &protos, const std::vector<MessageSegment> &segments);
   void SendMessage(const std::shared_ptr<CommMessage> &message);
   uint16_t BoundPort() const;
   std::string BoundIp() const;
@@ -123,6 +134,8 @@ class TcpServer {
   static void TimerOnceCallback(evutil_socket_t fd, int16_t event, void *arg);
   static void SetTcpNoDelay(const evutil_socket_t &fd);
   std::shared_ptr<TcpConnection> onCreateConnection(struct bufferevent *bev, const evutil_socket_t &fd);
+  struct event_base *NextReactorBase();
+  void StopReactors();
 
   struct event_base *base_;
   struct event *signal_event_;
@@ -137,11 +150,17 @@ class TcpServer {
   OnAccepted client_accept_;
   std::mutex connection_mutex_;
   OnServerReceiveMessage message_callback_;
+  ReceiveBufferAllocator buffer_allocator_;
   OnTimerOnce on_timer_once_callback_;
   OnTimer on_timer_callback_;
   // The Configuration file
   Configuration *config_;
   int64_t max_connection_;
+  // The event loops of reactors besides the base_, each of them is run in its own thread.
+  size_t reactor_num_;
+  size_t next_reactor_;
+  std::vector<struct event_base *> reactor_bases_;
+  std::vector<std::thread> reactor_threads_;
 };
 }  // namespace core
 }  // namespace ps
@@ -147,48 +147,49 @@ void Node::ProcessSendDataResp(const std::shared_ptr<MessageMeta> &meta, const P
                                size_t size) {
   MS_EXCEPTION_IF_NULL(meta);
   MS_EXCEPTION_IF_NULL(data);
-  std::lock_guard<std::mutex> lock(receive_messages_mutex_);
   const uint32_t &rank_id = meta->rank_id();
   const uint64_t request_id = meta->request_id();
   MS_LOG(DEBUG) << "The node role is:" << CommUtil::NodeRoleToString(node_info_.node_role_)
                 << ", the node id is:" << node_info_.node_id_ << " send the request id is:" << request_id;
-  if (meta->role() == NodeRole::SERVER) {
-    auto it = receive_messages_.find(request_id);
-    VectorPtr received_data = std::make_shared<std::vector<unsigned char>>(size, 0);
-    if (size > 0) {
-      size_t dest_size = size;
-      size_t src_size = size;
-      auto ret = memcpy_s(received_data.get()->data(), dest_size, data, src_size);
-      if (ret != EOK) {
-        MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
-      }
-    }
-    if (it != receive_messages_.end()) {
-      it->second[rank_id] = received_data;
-    } else {
-      std::unordered_map<uint32_t, VectorPtr> res;
-      (void)res.insert(std::make_pair(rank_id, received_data));
-      receive_messages_[request_id] = res;
-    }
-  } else {
-    auto it = workder_receive_messages_.find(request_id);
-    VectorPtr received_data = std::make_shared<std::vector<unsigned char>>(size, 0);
-    if (size > 0) {
-      size_t dest_size = size;
-      size_t src_size = size;
-      auto ret = memcpy_s(received_data.get()->data(), dest_size, data, src_size);
-      if (ret != EOK) {
-        MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+  auto &receive_messages = meta->role() == NodeRole::SERVER ? receive_messages_ : workder_receive_messages_;
+  {
+    std::lock_guard<std::mutex> lock(receive_messages_mutex_);
+    auto it = receive_messages.find(request_id);
+    if (it != receive_messages.end()) {
+      auto iter = it->second.find(rank_id);
+      // The response has been received into the registered buffer.
+      if (iter != it->second.end() && iter->second != nullptr && iter->second->data() == data) {
+        return;
       }
     }
-    if (it != workder_receive_messages_.end()) {
-      it->second[rank_id] = received_data;
-    } else {
-      std::unordered_map<uint32_t, VectorPtr> res;
-      (void)res.insert(std::make_pair(rank_id, received_data));
-      workder_receive_messages_[request_id] = res;
+  }
+
+  // The responses are received by the reactors of clients concurrently, so the data is copied out of the lock.
+  VectorPtr received_data = std::make_shared<std::vector<unsigned char>>(size, 0);
+  if (size > 0) {
+    size_t dest_size = size;
+    size_t src_size = size;
+    auto ret = memcpy_s(received_data.get()->data(), dest_size, data, src_size);
+    if (ret != EOK) {
+      MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
     }
   }
+
+  std::lock_guard<std::mutex> lock(receive_messages_mutex_);
+  receive_messages[request_id][rank_id] = received_data;
+}
+
+std::shared_ptr<void> Node::RegisterResponseBuffer(const std::shared_ptr<MessageMeta> &meta, size_t size) {
+  MS_EXCEPTION_IF_NULL(meta);
+  if (meta->cmd() != NodeCommand::SEND_DATA || size == 0) {
+    return nullptr;
+  }
+  VectorPtr buffer = std::make_shared<std::vector<unsigned char>>(size);
+  std::lock_guard<std::mutex> lock(receive_messages_mutex_);
+  auto &receive_messages = meta->role() == NodeRole::SERVER ? receive_messages_ : workder_receive_messages_;
+  receive_messages[meta->request_id()][meta->rank_id()] = buffer;
+  // The buffer is owned by the received messages as well, which is released once the response is taken.
+  return std::shared_ptr<void>(buffer, buffer->data());
 }
 
 void Node::RunMessageCallback(const uint64_t &request_id) {
@@ -93,6 +93,8 @@ class Node {
   void set_message_callback(const uint64_t &request_id, const MessageCallback &callback);
   void ProcessSendDataResp(const std::shared_ptr<MessageMeta> &meta, const Protos &protos, const void *data,
                            size_t size);
+  // Register the buffer of the response in the received messages, so the response is received into it without copy.
+  std::shared_ptr<void> RegisterResponseBuffer(const std::shared_ptr<MessageMeta> &meta, size_t size);
   void RunMessageCallback(const uint64_t &request_id);
 
   NodeInfo node_info_;
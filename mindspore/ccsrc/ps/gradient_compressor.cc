@@ -0,0 +1,374 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/gradient_compressor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include "base/float16.h"
+#include "securec/include/securec.h"
+#include "utils/convert_utils_base.h"
+#include "utils/log_adapter.h"
+#include "utils/ms_utils.h"
+
+namespace mindspore {
+namespace ps {
+namespace {
+constexpr char kCompressTypeNone[] = "none";
+constexpr char kCompressTypeTopK[] = "topk";
+constexpr char kCompressTypeFp16[] = "fp16";
+constexpr char kCompressTypeInt8[] = "int8";
+constexpr char kCompressTypeOneBit[] = "onebit";
+constexpr char kConfigSeparator = ';';
+constexpr char kConfigAssign = '=';
+constexpr char kRatioSeparator = ':';
+
+// The float32 has 13 more mantissa bits than the float16, which are rounded stochastically.
+constexpr uint32_t kFp16DroppedMantissaMask = (1U << 13) - 1;
+constexpr float kFp16Max = 65504.0;
+// The float16 below the min normal 2^-14 is subnormal, which is spaced evenly by 2^-24.
+constexpr float kFp16MinNormal = 6.103515625e-05;
+constexpr float kFp16SubnormalStep = 5.9604644775390625e-08;
+// The random number is scaled to a fraction in [0, 1) by its high 24 bits, which the float holds exactly.
+constexpr uint32_t kRandomFractionShift = 8;
+constexpr float kRandomFractionScale = 5.9604644775390625e-08;
+constexpr float kInt8Max = 127.0;
+constexpr size_t kBitsPerByte = 8;
+
+union Float32Bits {
+  uint32_t u;
+  float f;
+};
+
+bool ParseCompressConfig(const std::string &value, GradCompressConfig *config) {
+  MS_EXCEPTION_IF_NULL(config);
+  auto pos = value.find(kRatioSeparator);
+  std::string type = value.substr(0, pos);
+  if (type == kCompressTypeTopK) {
+    config->type = GradCompressType::kTopK;
+    config->topk_ratio = kDefaultTopKRatio;
+    if (pos != std::string::npos) {
+      char *end = nullptr;
+      float ratio = std::strtof(value.c_str() + pos + 1, &end);
+      if (end == value.c_str() + pos + 1 || *end != '\0' || ratio <= 0 || ratio > 1) {
+        MS_LOG(WARNING) << "The ratio of the top-k compression should be in (0, 1], but got: " << value;
+        return false;
+      }
+      config->topk_ratio = ratio;
+    }
+    return true;
+  }
+  if (pos != std::string::npos) {
+    MS_LOG(WARNING) << "Only the top-k compression has the ratio, but got: " << value;
+    return false;
+  }
+  static const std::map<std::string, GradCompressType> kCompressTypes = {
+    {kCompressTypeNone, GradCompressType::kNone},
+    {kCompressTypeFp16, GradCompressType::kFp16},
+    {kCompressTypeInt8, GradCompressType::kInt8},
+    {kCompressTypeOneBit, GradCompressType::kOneBit}};
+  auto iter = kCompressTypes.find(type);
+  if (iter == kCompressTypes.end()) {
+    MS_LOG(WARNING) << "The gradient compression type " << type << " is not supported.";
+    return false;
+  }
+  config->type = iter->second;
+  return true;
+}
+
+uint16_t StochasticRoundFp16(float value, uint32_t random) {
+  Float32Bits bits;
+  bits.f = std::max(-kFp16Max, std::min(kFp16Max, value));
+  if (std::fabs(bits.f) < kFp16MinNormal) {
+    // The subnormal spacing doesn't line up with the dropped mantissa bits, and the conversion would round the
+    // magnitude to the nearest, so the magnitude is rounded up on the subnormal grid with the probability of its
+    // fraction.
+    float steps = std::fabs(bits.f) / kFp16SubnormalStep;
+    float lower = std::floor(steps);
+    float fraction = static_cast<float>(random >> kRandomFractionShift) * kRandomFractionScale;
+    bits.f = std::copysign((fraction < steps - lower ? lower + 1 : lower) * kFp16SubnormalStep, bits.f);
+  } else {
+    // Adding the random number to the dropped bits of the magnitude and truncating them rounds the magnitude up with
+    // the probability of the dropped fraction, so the rounding is unbiased.
+    bits.u = (bits.u + (random & kFp16DroppedMantissaMask)) & ~kFp16DroppedMantissaMask;
+  }
+  float16 half = static_cast<float16>(std::max(-kFp16Max, std::min(kFp16Max, bits.f)));
+  uint16_t raw = 0;
+  (void)memcpy_s(&raw, sizeof(raw), &half, sizeof(half));
+  return raw;
+}
+
+float Fp16ToFloat(uint16_t raw) {
+  float16 half;
+  (void)memcpy_s(&half, sizeof(half), &raw, sizeof(raw));
+  return static_cast<float>(half);
+}
+}  // namespace
+
+GradCompressConfig GetGradCompressConfig(const std::string &param_name) {
+  GradCompressConfig default_config;
+  std::istringstream env(common::GetEnv(kEnvGradCompress));
+  std::string item;
+  while (std::getline(env, item, kConfigSeparator)) {
+    if (item.empty()) {
+      continue;
+    }
+    auto pos = item.find(kConfigAssign);
+    if (pos == std::string::npos) {
+      (void)ParseCompressConfig(item, &default_config);
+    } else if (item.substr(0, pos) == param_name) {
+      GradCompressConfig config;
+      if (ParseCompressConfig(item.substr(pos + 1), &config)) {
+        return config;
+      }
+    }
+  }
+  return default_config;
+}
+
+bool GradientCompressor::CompressMessage(size_t grad_index, bool error_feedback, KVMessage *message) {
+  MS_EXCEPTION_IF_NULL(message);
+  if (config_.type == GradCompressType::kNone || grad_index >= IntToSize(message->len_size())) {
+    return false;
+  }
+  size_t offset = std::accumulate(message->len().begin(), message->len().begin() + grad_index, size_t(0));
+  size_t size = message->len(SizeToInt(grad_index));
+  auto values = message->mutable_values();
+  if (size == 0 || offset + size > IntToSize(values->size())) {
+    return false;
+  }
+
+  auto compressed_grad = message->mutable_compressed_grad();
+  Compress(values->data() + offset, size, error_feedback, compressed_grad);
+  compressed_grad->set_index(grad_index);
+  (void)std::copy(values->begin() + offset + size, values->end(), values->begin() + offset);
+  values->Truncate(values->size() - SizeToInt(size));
+  return true;
+}
+
+bool GradientCompressor::DecompressMessage(const KVMessage &message, Values *values) {
+  MS_EXCEPTION_IF_NULL(values);
+  values->assign(message.values().begin(), message.values().end());
+  if (!message.has_compressed_grad()) {
+    return true;
+  }
+  const auto &compressed_grad = message.compressed_grad();
+  if (compressed_grad.index() >= IntToSize(message.len_size())) {
+    MS_LOG(ERROR) << "The index of the compressed gradient " << compressed_grad.index() << " is out of range.";
+    return false;
+  }
+  size_t offset =
+    std::accumulate(message.len().begin(), message.len().begin() + compressed_grad.index(), size_t(0));
+  size_t size = message.len(SizeToInt(compressed_grad.index()));
+  if (size != compressed_grad.size() || offset > values->size()) {
+    MS_LOG(ERROR) << "The size of the compressed gradient " << compressed_grad.size() << " mismatches the length "
+                  << size << " of the message.";
+    return false;
+  }
+  Values grad(size, 0);
+  if (!Decompress(compressed_grad, grad.data(), size)) {
+    return false;
+  }
+  (void)values->insert(values->begin() + offset, grad.begin(), grad.end());
+  return true;
+}
+
+void GradientCompressor::Compress(const float *grad, size_t size, bool error_feedback, CompressedGrad *output) {
+  MS_EXCEPTION_IF_NULL(grad);
+  MS_EXCEPTION_IF_NULL(output);
+  output->Clear();
+  output->set_type(static_cast<int32_t>(config_.type));
+  output->set_size(size);
+
+  // Only the biased compressions need the error feedback.
+  bool use_residual =
+    error_feedback && (config_.type == GradCompressType::kTopK || config_.type == GradCompressType::kOneBit);
+  std::vector<float> corrected_grad;
+  if (use_residual) {
+    if (residual_.size() != size) {
+      residual_.assign(size, 0);
+    }
+    corrected_grad.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      corrected_grad[i] = grad[i] + residual_[i];
+    }
+    grad = corrected_grad.data();
+  }
+
+  switch (config_.type) {
+    case GradCompressType::kTopK:
+      CompressTopK(grad, size, output);
+      break;
+    case GradCompressType::kFp16:
+      CompressFp16(grad, size, output);
+      break;
+    case GradCompressType::kInt8:
+      CompressInt8(grad, size, output);
+      break;
+    case GradCompressType::kOneBit:
+      CompressOneBit(grad, size, output);
+      break;
+    default:
+      MS_LOG(EXCEPTION) << "The gradient compression type " << static_cast<int32_t>(config_.type)
+                        << " is not supported.";
+  }
+
+  if (use_residual) {
+    if (!Decompress(*output, residual_.data(), size)) {
+      MS_LOG(EXCEPTION) << "Decompress the gradient for the error feedback failed.";
+    }
+    for (size_t i = 0; i < size; ++i) {
+      residual_[i] = grad[i] - residual_[i];
+    }
+  }
+  raw_bytes_ += size * sizeof(float);
+  compressed_bytes_ += output->ByteSizeLong();
+}
+
+bool GradientCompressor::Decompress(const CompressedGrad &input, float *output, size_t output_size) {
+  MS_EXCEPTION_IF_NULL(output);
+  size_t size = input.size();
+  const auto &data = input.data();
+  if (size != output_size) {
+    MS_LOG(ERROR) << "The size of the compressed gradient " << size << " mismatches the output size " << output_size;
+    return false;
+  }
+  switch (static_cast<GradCompressType>(input.type())) {
+    case GradCompressType::kTopK: {
+      size_t k = IntToSize(input.indices_size());
+      if (data.size() != k * sizeof(float)) {
+        break;
+      }
+      std::vector<float> values(k);
+      if (k > 0 && memcpy_s(values.data(), k * sizeof(float), data.data(), data.size()) != EOK) {
+        break;
+      }
+      std::fill(output, output + size, 0.0f);
+      size_t index = 0;
+      for (size_t i = 0; i < k; ++i) {
+        index += input.indices(SizeToInt(i));
+        if (index >= size) {
+          MS_LOG(ERROR) << "The index " << index << " of the top-k gradient is out of range " << size;
+          return false;
+        }
+        output[index] = values[i];
+      }
+      return true;
+    }
+    case GradCompressType::kFp16: {
+      if (data.size() != size * sizeof(uint16_t)) {
+        break;
+      }
+      for (size_t i = 0; i < size; ++i) {
+        uint16_t raw = 0;
+        (void)memcpy_s(&raw, sizeof(raw), data.data() + i * sizeof(uint16_t), sizeof(uint16_t));
+        output[i] = Fp16ToFloat(raw);
+      }
+      return true;
+    }
+    case GradCompressType::kInt8: {
+      if (data.size() != size) {
+        break;
+      }
+      for (size_t i = 0; i < size; ++i) {
+        output[i] = static_cast<int8_t>(data[i]) * input.scale();
+      }
+      return true;
+    }
+    case GradCompressType::kOneBit: {
+      if (data.size() != (size + kBitsPerByte - 1) / kBitsPerByte) {
+        break;
+      }
+      for (size_t i = 0; i < size; ++i) {
+        bool positive = (static_cast<uint8_t>(data[i / kBitsPerByte]) >> (i % kBitsPerByte)) & 1;
+        output[i] = positive ? input.scale() : -input.scale();
+      }
+      return true;
+    }
+    default:
+      MS_LOG(ERROR) << "The gradient compression type " << input.type() << " is not supported.";
+      return false;
+  }
+  MS_LOG(ERROR) << "The data size " << data.size() << " of the compressed gradient is invalid, the compression type: "
+                << input.type() << ", the gradient size: " << size;
+  return false;
+}
+
+void GradientCompressor::CompressTopK(const float *grad, size_t size, CompressedGrad *output) const {
+  size_t k = std::min(size, std::max(size_t(1), static_cast<size_t>(std::ceil(size * config_.topk_ratio))));
+  std::vector<uint32_t> indices(size);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::nth_element(indices.begin(), indices.begin() + (k - 1), indices.end(),
+                   [grad](uint32_t a, uint32_t b) { return std::fabs(grad[a]) > std::fabs(grad[b]); });
+  indices.resize(k);
+  // The ascending indices are encoded as the deltas, which are shorter varints.
+  std::sort(indices.begin(), indices.end());
+  std::vector<float> values(k);
+  uint32_t last_index = 0;
+  for (size_t i = 0; i < k; ++i) {
+    values[i] = grad[indices[i]];
+    output->add_indices(indices[i] - last_index);
+    last_index = indices[i];
+  }
+  output->set_data(reinterpret_cast<const char *>(values.data()), k * sizeof(float));
+}
+
+void GradientCompressor::CompressFp16(const float *grad, size_t size, CompressedGrad *output) {
+  std::vector<uint16_t> halves(size);
+  for (size_t i = 0; i < size; ++i) {
+    halves[i] = StochasticRoundFp16(grad[i], generator_());
+  }
+  output->set_data(reinterpret_cast<const char *>(halves.data()), size * sizeof(uint16_t));
+}
+
+void GradientCompressor::CompressInt8(const float *grad, size_t size, CompressedGrad *output) {
+  float max_abs = 0;
+  for (size_t i = 0; i < size; ++i) {
+    max_abs = std::max(max_abs, std::fabs(grad[i]));
+  }
+  float scale = max_abs / kInt8Max;
+  output->set_scale(scale);
+  std::string data(size, 0);
+  if (scale > 0) {
+    std::uniform_real_distribution<float> distribution(0, 1);
+    for (size_t i = 0; i < size; ++i) {
+      float quantized = std::floor(grad[i] / scale + distribution(generator_));
+      data[i] = static_cast<char>(static_cast<int8_t>(std::max(-kInt8Max, std::min(kInt8Max, quantized))));
+    }
+  }
+  output->set_data(std::move(data));
+}
+
+void GradientCompressor::CompressOneBit(const float *grad, size_t size, CompressedGrad *output) const {
+  // The magnitude is the mean of the absolute values, which keeps the l1 norm of the gradient.
+  float sum_abs = 0;
+  std::string data((size + kBitsPerByte - 1) / kBitsPerByte, 0);
+  for (size_t i = 0; i < size; ++i) {
+    sum_abs += std::fabs(grad[i]);
+    if (grad[i] >= 0) {
+      auto &byte = data[i / kBitsPerByte];
+      byte = static_cast<char>(static_cast<uint8_t>(byte) | (1U << (i % kBitsPerByte)));
+    }
+  }
+  output->set_scale(size == 0 ? 0 : sum_abs / size);
+  output->set_data(std::move(data));
+}
+}  // namespace ps
+}  // namespace mindspore
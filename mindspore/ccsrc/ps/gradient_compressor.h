@@ -0,0 +1,81 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PS_GRADIENT_COMPRESSOR_H_
+#define MINDSPORE_CCSRC_PS_GRADIENT_COMPRESSOR_H_
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ps/constants.h"
+#include "proto/ps.pb.h"
+
+namespace mindspore {
+namespace ps {
+enum class GradCompressType : int32_t { kNone = 0, kTopK, kFp16, kInt8, kOneBit };
+
+constexpr float kDefaultTopKRatio = 0.01;
+
+struct GradCompressConfig {
+  GradCompressType type{GradCompressType::kNone};
+  // The ratio of the elements kept by the top-k compression.
+  float topk_ratio{kDefaultTopKRatio};
+};
+
+// Get the compression config of the parameter from the env MS_DEV_PS_GRAD_COMPRESS, whose format is
+// "<default type>;<parameter name>=<type>;...". The type is one of none, fp16, int8, onebit and topk[:ratio], for
+// example: "int8;fc1.weight=topk:0.01;embedding=none".
+GradCompressConfig GetGradCompressConfig(const std::string &param_name);
+
+// The compressor of the gradients pushed by one parameter. The fp16 and int8 quantizations round the values
+// stochastically, so they are unbiased. The top-k and one-bit compressions are biased, so the compression error is
+// kept as the residual and added to the next gradient (error feedback) if it's enabled.
+class GradientCompressor {
+ public:
+  explicit GradientCompressor(const GradCompressConfig &config, uint32_t seed = std::random_device()())
+      : config_(config), generator_(seed) {}
+  ~GradientCompressor() = default;
+
+  // Compress the gradient segment at the grad_index of the message into its compressed_grad, and remove the segment
+  // from the values. Return false if the message is not compressed.
+  bool CompressMessage(size_t grad_index, bool error_feedback, KVMessage *message);
+  // Get the values of the message with the compressed gradient decompressed and inserted back.
+  static bool DecompressMessage(const KVMessage &message, Values *values);
+
+  void Compress(const float *grad, size_t size, bool error_feedback, CompressedGrad *output);
+  static bool Decompress(const CompressedGrad &input, float *output, size_t output_size);
+
+  // The bytes of the gradients before and after compressed, which are accumulated by every compression.
+  size_t raw_bytes() const { return raw_bytes_; }
+  size_t compressed_bytes() const { return compressed_bytes_; }
+
+ private:
+  void CompressTopK(const float *grad, size_t size, CompressedGrad *output) const;
+  void CompressFp16(const float *grad, size_t size, CompressedGrad *output);
+  void CompressInt8(const float *grad, size_t size, CompressedGrad *output);
+  void CompressOneBit(const float *grad, size_t size, CompressedGrad *output) const;
+
+  GradCompressConfig config_;
+  std::mt19937 generator_;
+  // The error of the last compression, which has the same size as the gradient.
+  std::vector<float> residual_;
+  size_t raw_bytes_{0};
+  size_t compressed_bytes_{0};
+};
+}  // namespace ps
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PS_GRADIENT_COMPRESSOR_H_
@@ -79,7 +79,7 @@ void OptimizerInfo::UpdateOptimInputValue(const std::string &optim_type, const s
   return;
 }
 
-void DenseOptimInfo::Accumulate(const Values &values, const Lengths &lengths) {
+void DenseOptimInfo::Accumulate(const ValuesView &values, const Lengths &lengths) {
   MS_EXCEPTION_IF_NULL(gradient()->addr);
   float *accum_grad_data = reinterpret_cast<float *>(gradient()->addr);
   size_t size = gradient()->size / sizeof(float);
@@ -118,7 +118,7 @@ void DenseOptimInfo::Reset() {
   }
 }
 
-void SparseOptimInfo::Accumulate(const Values &values, const Lengths &lengths) {
+void SparseOptimInfo::Accumulate(const ValuesView &values, const Lengths &lengths) {
   // Append grad data to the end
   MS_EXCEPTION_IF_NULL(gradient()->addr);
   float *accum_grad_data = reinterpret_cast<float *>(gradient()->addr);
@@ -277,7 +277,7 @@ MomentumOptimInfo::MomentumOptimInfo(const AddressPtr &weight, const AddressPtr
   inputs_.push_back(momentum);
 }
 
-void MomentumOptimInfo::Update(const Values &values, const Lengths &lens) {
+void MomentumOptimInfo::Update(const ValuesView &values, const Lengths &lens) {
   UpdateOptimInputValue<float>(kApplyMomentum, "lr", const_cast<float *>(values.data()), lens);
 }
 
@@ -334,7 +334,7 @@ SparseAdamOptimInfo::SparseAdamOptimInfo(const AddressPtr &weight, const Address
   sharded_ = sharded;
 }
 
-void SparseAdamOptimInfo::Update(const Values &values, const Lengths &lens) {
+void SparseAdamOptimInfo::Update(const ValuesView &values, const Lengths &lens) {
   UpdateOptimInputValue<float>(kSparseAdam, "beta1_power", const_cast<float *>(values.data()), lens);
   UpdateOptimInputValue<float>(kSparseAdam, "beta2_power", const_cast<float *>(values.data()), lens);
   UpdateOptimInputValue<float>(kSparseAdam, "lr", const_cast<float *>(values.data()), lens);
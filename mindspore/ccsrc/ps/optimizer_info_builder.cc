@@ -24,7 +24,7 @@ namespace mindspore {
 namespace ps {
 using mindspore::kernel::ps::SparseApplyFtrlPSKernel;
 OptimizerInfo *OptimizerInfoBuilder::Build(const std::shared_ptr<PServerKernel> &pserver_kernel,
-                                           const WeightPtr &weight, const Keys &keys, const Values &values,
+                                           const WeightPtr &weight, const Keys &keys, const ValuesView &values,
                                            const Lengths &lens, const InputsShapePtr &inputs_shape, size_t worker_num,
                                            bool sharded) {
   MS_EXCEPTION_IF_NULL(pserver_kernel);
@@ -111,7 +111,7 @@ AddressPtr OptimizerInfoBuilder::GenInputAddrPtr(const std::string &optim_type,
   return addr_ptr;
 }
 
-OptimizerInfo *MomentumOptimInfoBuilder::BuildInputs(const WeightPtr &weight, const Keys &, const Values &values,
+OptimizerInfo *MomentumOptimInfoBuilder::BuildInputs(const WeightPtr &weight, const Keys &, const ValuesView &values,
                                                      const Lengths &lens, const InputsShapePtr &, size_t,
                                                      const std::shared_ptr<PServerKernel> &, bool) {
   MS_EXCEPTION_IF_NULL(weight);
@@ -143,7 +143,7 @@ OptimizerInfo *MomentumOptimInfoBuilder::BuildInputs(const WeightPtr &weight, co
   return new MomentumOptimInfo(weight_addr, accumulate, learning_rate, gradient, momentum);
 }
 
-OptimizerInfo *SparseAdamOptimInfoBuilder::BuildInputs(const WeightPtr &weight, const Keys &, const Values &values,
+OptimizerInfo *SparseAdamOptimInfoBuilder::BuildInputs(const WeightPtr &weight, const Keys &, const ValuesView &values,
                                                        const Lengths &lens, const InputsShapePtr &inputs_shape, size_t,
                                                        const std::shared_ptr<PServerKernel> &, bool sharded) {
   AddressPtr weight_addr = std::make_shared<kernel::Address>();
@@ -202,7 +202,7 @@ OptimizerInfo *SparseAdamOptimInfoBuilder::BuildInputs(const WeightPtr &weight,
                                  grad, indices, sharded);
 }
 
-OptimizerInfo *SparseFtrlOptimInfoBuilder::BuildInputs(const WeightPtr &weight, const Keys &, const Values &values,
+OptimizerInfo *SparseFtrlOptimInfoBuilder::BuildInputs(const WeightPtr &weight, const Keys &, const ValuesView &values,
                                                        const Lengths &lens, const InputsShapePtr &inputs_shape, size_t,
                                                        const std::shared_ptr<PServerKernel> &pserver_kernel,
                                                        bool sharded) {
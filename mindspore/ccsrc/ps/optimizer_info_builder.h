@@ -34,10 +34,10 @@ class OptimizerInfoBuilder {
   virtual ~OptimizerInfoBuilder() = default;
 
   OptimizerInfo *Build(const std::shared_ptr<PServerKernel> &pserver_kernel, const WeightPtr &weight, const Keys &keys,
-                       const Values &values, const Lengths &lens, const InputsShapePtr &inputs_shape, size_t worker_num,
-                       bool sharded);
+                       const ValuesView &values, const Lengths &lens, const InputsShapePtr &inputs_shape,
+                       size_t worker_num, bool sharded);
 
-  virtual OptimizerInfo *BuildInputs(const WeightPtr &weight, const Keys &keys, const Values &values,
+  virtual OptimizerInfo *BuildInputs(const WeightPtr &weight, const Keys &keys, const ValuesView &values,
                                      const Lengths &lens, const InputsShapePtr &inputs_shape, size_t worker_num,
                                      const std::shared_ptr<PServerKernel> &pserver_kernel, bool sharded) = 0;
 
@@ -56,7 +56,7 @@ class MomentumOptimInfoBuilder : public OptimizerInfoBuilder {
  public:
   explicit MomentumOptimInfoBuilder(size_t worker_num) : OptimizerInfoBuilder(worker_num) {}
   ~MomentumOptimInfoBuilder() = default;
-  OptimizerInfo *BuildInputs(const WeightPtr &weight, const Keys &keys, const Values &values, const Lengths &lens,
+  OptimizerInfo *BuildInputs(const WeightPtr &weight, const Keys &keys, const ValuesView &values, const Lengths &lens,
                              const InputsShapePtr &inputs_shape, size_t worker_num,
                              const std::shared_ptr<PServerKernel> &pserver_kernel, bool sharded) override;
 };
@@ -65,7 +65,7 @@ class SparseAdamOptimInfoBuilder : public OptimizerInfoBuilder {
  public:
   explicit SparseAdamOptimInfoBuilder(size_t worker_num) : OptimizerInfoBuilder(worker_num) {}
   ~SparseAdamOptimInfoBuilder() = default;
-  OptimizerInfo *BuildInputs(const WeightPtr &weight, const Keys &keys, const Values &values, const Lengths &lens,
+  OptimizerInfo *BuildInputs(const WeightPtr &weight, const Keys &keys, const ValuesView &values, const Lengths &lens,
                              const InputsShapePtr &inputs_shape, size_t worker_num,
                              const std::shared_ptr<PServerKernel> &pserver_kernel, bool sharded) override;
 };
@@ -74,7 +74,7 @@ class SparseFtrlOptimInfoBuilder : public OptimizerInfoBuilder {
  public:
   explicit SparseFtrlOptimInfoBuilder(size_t worker_num) : OptimizerInfoBuilder(worker_num) {}
   ~SparseFtrlOptimInfoBuilder() = default;
-  OptimizerInfo *BuildInputs(const WeightPtr &weight, const Keys &keys, const Values &values, const Lengths &lens,
+  OptimizerInfo *BuildInputs(const WeightPtr &weight, const Keys &keys, const ValuesView &values, const Lengths &lens,
                              const InputsShapePtr &inputs_shape, size_t worker_num,
                              const std::shared_ptr<PServerKernel> &pserver_kernel, bool sharded) override;
 };
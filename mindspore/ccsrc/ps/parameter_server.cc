@@ -20,6 +20,7 @@
 #include <set>
 
 #include "utils/file_utils.h"
+#include "ps/raw_kv_message.h"
 
 namespace mindspore {
 namespace ps {
@@ -155,6 +156,10 @@ void ParameterServer::InitOptimInputsShape(const Keys &keys, const Values &value
         optimizer->InitKernel(cnode, optim_inputs_shape_[key]);
         optimizers_[key] = optimizer;
       }
+      // The sparse optimizers update the rows of the embedding table under the row locks.
+      if (optimizers_.count(key) > 0 && optim_name != kApplyMomentum) {
+        optimizers_[key]->SetRowLock(GetRowLock(key));
+      }
     }
   }
 }
@@ -330,6 +335,7 @@ void ParameterServer::InitEmbeddingTable(
     std::shared_ptr<PServerKernel> lookup =
       std::make_shared<kernel::ps::EmbeddingLookUpPSKernel>(server_node_->rank_id(), pserver_num_, worker_num_);
     lookup->InitKernel(shapes);
+    lookup->SetRowLock(GetRowLock(key));
     embedding_lookup_ops_[key] = lookup;
 
     PersistKernels(key, shapes, param_init_info);
@@ -397,45 +403,26 @@ void ParameterServer::Finalize() {
 void ParameterServer::UpdateWeights() {
   while (true) {
     MS_LOG(INFO) << "The running is:" << running_ << " the ready is:" << this->ReadyForUpdateWeights();
-    std::unique_lock<std::mutex> lock(mutex_);
-    apply_grads_cv_.wait(lock, [this] { return this->ReadyForUpdateWeights() || !running_; });
-    if (!running_) {
-      break;
+    std::vector<Key> keys;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      apply_grads_cv_.wait(lock, [this] { return this->ReadyForUpdateWeights() || !running_; });
+      if (!running_) {
+        break;
+      }
+      (void)std::transform(weights_.begin(), weights_.end(), std::back_inserter(keys),
+                           [](const auto &item) { return item.first; });
     }
 
-    for (auto iter = weights_.begin(); iter != weights_.end(); iter++) {
-      Key key = iter->first;
-      WeightPtr weight_ptr = iter->second;
+    // The weights are updated out of the mutex_, so the embedding lookups are not blocked by the update. The workers
+    // don't push until the accumulation count is reset, and the rows of the embedding tables are updated under the
+    // row locks.
+    for (const auto &key : keys) {
+      UpdateWeight(key);
+    }
 
-      std::shared_ptr<PServerKernel> optimizer = nullptr;
-      if (weight_key_to_optims_.count(key) > 0) {
-        optimizer = optimizers_[key];
-      }
-      MS_EXCEPTION_IF_NULL(optimizer);
-
-      std::shared_ptr<OptimizerInfo> optim_info = optim_infos_[key];
-      if (optim_info != nullptr) {
-        const std::vector<kernel::AddressPtr> &inputs = optim_info->inputs();
-        const std::vector<kernel::AddressPtr> &workspaces = optim_info->workspaces();
-        const std::vector<kernel::AddressPtr> &outputs = optim_info->outputs();
-
-        std::vector<std::vector<size_t>> shapes = {};
-        std::vector<size_t> indices_shape = {};
-        indices_shape.emplace_back(optim_info->indice_size());
-        shapes.push_back(indices_shape);
-
-        if (original_optim_inputs_shape_.count(key) != 0) {
-          std::transform((*(original_optim_inputs_shape_[key])).begin(), (*(original_optim_inputs_shape_[key])).end(),
-                         std::back_inserter(shapes),
-                         [](const std::shared_ptr<std::vector<size_t>> &input_shapes) -> std::vector<size_t> {
-                           return *input_shapes;
-                         });
-        }
-        optimizer->ReInit(shapes);
-        optim_info->ComputeMean(shapes, worker_num_, pserver_num_, server_node_->rank_id());
-        optimizer->Execute(inputs, workspaces, outputs);
-        optim_info->Reset();
-      }
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (const auto &key : keys) {
       if (!is_embedding_[key]) {
         tokens_[key] = worker_num_;
       }
@@ -444,24 +431,82 @@ void ParameterServer::UpdateWeights() {
   }
 }
 
-void ParameterServer::AccumGrad(const Keys &keys, const Values &values, const Lengths &lengths) {
-  std::unique_lock<std::mutex> lock(mutex_);
+void ParameterServer::UpdateWeight(const Key &key) {
+  std::shared_ptr<PServerKernel> optimizer = nullptr;
+  std::shared_ptr<OptimizerInfo> optim_info = nullptr;
+  InputsShapePtr original_inputs_shape = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (weight_key_to_optims_.count(key) > 0) {
+      optimizer = optimizers_[key];
+    }
+    optim_info = optim_infos_[key];
+    if (original_optim_inputs_shape_.count(key) != 0) {
+      original_inputs_shape = original_optim_inputs_shape_[key];
+    }
+  }
+  MS_EXCEPTION_IF_NULL(optimizer);
+  if (optim_info == nullptr) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> key_lock(key_mutex(key));
+  const std::vector<kernel::AddressPtr> &inputs = optim_info->inputs();
+  const std::vector<kernel::AddressPtr> &workspaces = optim_info->workspaces();
+  const std::vector<kernel::AddressPtr> &outputs = optim_info->outputs();
+
+  std::vector<std::vector<size_t>> shapes = {};
+  std::vector<size_t> indices_shape = {};
+  indices_shape.emplace_back(optim_info->indice_size());
+  shapes.push_back(indices_shape);
+
+  if (original_inputs_shape != nullptr) {
+    std::transform((*original_inputs_shape).begin(), (*original_inputs_shape).end(), std::back_inserter(shapes),
+                   [](const std::shared_ptr<std::vector<size_t>> &input_shapes) -> std::vector<size_t> {
+                     return *input_shapes;
+                   });
+  }
+  optimizer->ReInit(shapes);
+  optim_info->ComputeMean(shapes, worker_num_, pserver_num_, server_node_->rank_id());
+  optimizer->Execute(inputs, workspaces, outputs);
+  optim_info->Reset();
+}
+
+void ParameterServer::AccumGrad(const Keys &keys, const ValuesView &values, const Lengths &lengths) {
   const Key &key = keys[0];
   bool no_sparse_grad = values.size() == 1 && values[0] == kGradValue;
   if (!no_sparse_grad) {
-    std::shared_ptr<OptimizerInfo> optim_info = optim_infos_[key];
+    // The gradients of the different keys are accumulated concurrently, only the pushes of the same key are serialized.
+    std::unique_lock<std::mutex> key_lock(key_mutex(key));
+    std::shared_ptr<OptimizerInfo> optim_info = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      optim_info = optim_infos_[key];
+    }
 
     // Create or update the optimizer info
     if (optim_info == nullptr) {
-      const std::shared_ptr<OptimizerInfoBuilder> &builder = optim_info_builders_[weight_key_to_optims_[key]];
-      std::shared_ptr<kernel::ps::PServerKernel> pserver_kernel = optimizers_[key];
+      std::shared_ptr<OptimizerInfoBuilder> builder = nullptr;
+      std::shared_ptr<kernel::ps::PServerKernel> pserver_kernel = nullptr;
+      WeightPtr weight = nullptr;
+      InputsShapePtr inputs_shape = nullptr;
+      bool is_embedding = false;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        builder = optim_info_builders_[weight_key_to_optims_[key]];
+        pserver_kernel = optimizers_[key];
+        weight = weights_[key];
+        inputs_shape = optim_inputs_shape_[key];
+        is_embedding = is_embedding_[key];
+      }
       if (pserver_kernel == nullptr) {
-        MS_LOG(EXCEPTION) << "no optimizer found for key " << key << " optim name " << weight_key_to_optims_[key];
+        MS_LOG(EXCEPTION) << "no optimizer found for key " << key;
       }
-      MS_EXCEPTION_IF_NULL(pserver_kernel);
-      OptimizerInfo *optim = builder->Build(pserver_kernel, weights_[key], keys, values, lengths,
-                                            optim_inputs_shape_[key], worker_num_, is_embedding_[key]);
+      MS_EXCEPTION_IF_NULL(builder);
+      OptimizerInfo *optim =
+        builder->Build(pserver_kernel, weight, keys, values, lengths, inputs_shape, worker_num_, is_embedding);
       optim_info.reset(optim);
+      std::unique_lock<std::mutex> lock(mutex_);
       optim_infos_[key] = optim_info;
     } else {
       optim_info->Update(values, lengths);
@@ -469,6 +514,7 @@ void ParameterServer::AccumGrad(const Keys &keys, const Values &values, const Le
     }
   }
 
+  std::unique_lock<std::mutex> lock(mutex_);
   grads_accum_counter_[key] += 1;
   if (grads_accum_counter_[key] == worker_num_) {
     grad_accum_count_++;
@@ -496,60 +542,33 @@ void ParameterServer::DoEmbeddingLookup(Key key, const LookupIds &lookup_ids, KV
     }
   }
 
-  std::unique_lock<std::mutex> lock(mutex_);
   MS_EXCEPTION_IF_NULL(res);
-  if (weights_.count(key) == 0) {
-    MS_LOG(ERROR) << "Invalid embedding table key " << key;
-    return;
-  }
-  if (embedding_lookup_ops_.count(key) == 0) {
-    MS_LOG(ERROR) << "Invalid embedding lookup op key " << key;
-    return;
+  WeightPtr table_ptr = nullptr;
+  std::shared_ptr<PServerKernel> table_lookup_op = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (weights_.count(key) == 0) {
+      MS_LOG(ERROR) << "Invalid embedding table key " << key;
+      return;
+    }
+    if (embedding_lookup_ops_.count(key) == 0) {
+      MS_LOG(ERROR) << "Invalid embedding lookup op key " << key;
+      return;
+    }
+    table_ptr = weights_[key];
+    table_lookup_op = embedding_lookup_ops_[key];
   }
-  WeightPtr table_ptr = weights_[key];
   MS_EXCEPTION_IF_NULL(table_ptr);
-  std::shared_ptr<PServerKernel> table_lookup_op = embedding_lookup_ops_[key];
   MS_EXCEPTION_IF_NULL(table_lookup_op);
 
-  // Update shapes of lookup operator
-  std::vector<std::vector<size_t>> shapes = {};
-  std::vector<size_t> indices_shape = {};
-  indices_shape.emplace_back(lookup_ids.size());
-  shapes.push_back(indices_shape);
-  table_lookup_op->ReInit(shapes);
-
-  const std::vector<size_t> output_shapes = table_lookup_op->output_sizes();
-  std::vector<kernel::AddressPtr> inputs;
-  AddressPtr embedding_table = std::make_shared<kernel::Address>();
-  MS_EXCEPTION_IF_NULL(embedding_table);
-  AddressPtr indices = std::make_shared<kernel::Address>();
-  MS_EXCEPTION_IF_NULL(indices);
-  inputs.push_back(embedding_table);
-  inputs.push_back(indices);
-  embedding_table->addr = table_ptr->data();
-  embedding_table->size = table_ptr->size() * sizeof(float);
-
-  std::unique_ptr<int[]> tmp_ids = std::make_unique<int[]>(lookup_ids.size());
-  MS_EXCEPTION_IF_NULL(tmp_ids);
-  for (size_t i = 0; i < lookup_ids.size(); i++) {
-    tmp_ids[i] = static_cast<int>(lookup_ids[i]);
-  }
-  indices->addr = tmp_ids.get();
-  indices->size = lookup_ids.size() * sizeof(int);
-
-  std::vector<kernel::AddressPtr> workspaces;
-  std::vector<kernel::AddressPtr> outputs;
-  AddressPtr output = std::make_shared<kernel::Address>();
-  MS_EXCEPTION_IF_NULL(output);
-  std::shared_ptr<Values> addr = std::make_shared<Values>(output_shapes[0] / sizeof(float), 0);
-  MS_EXCEPTION_IF_NULL(addr);
-
-  output->addr = addr->data();
-  output->size = output_shapes[0];
-  outputs.push_back(output);
-
-  table_lookup_op->Execute(inputs, workspaces, outputs);
-  *res->mutable_values() = {addr->begin(), addr->end()};
+  // The lookups run concurrently with each other and with the update of the table, since the rows are read under
+  // the row locks and the lookup operator is not changed.
+  const std::vector<size_t> &input_shapes = table_lookup_op->input_sizes();
+  size_t outer_dim_size =
+    std::accumulate(input_shapes.begin() + 1, input_shapes.end(), IntToSize(1), std::multiplies<size_t>());
+  Values output(lookup_ids.size() * outer_dim_size, 0);
+  table_lookup_op->LookupEmbeddings(table_ptr->data(), lookup_ids.data(), lookup_ids.size(), output.data());
+  *res->mutable_values() = {output.begin(), output.end()};
   res->add_len(res->values_size());
 }
 
@@ -560,20 +579,26 @@ void ParameterServer::UpdateEmbeddings(const Key &key, const LookupIds &lookup_i
     }
   }
 
-  std::unique_lock<std::mutex> locker(access_weight_mutex_);
-
-  if (weights_.count(key) == 0) {
-    MS_LOG(ERROR) << "Invalid embedding table key " << key;
-    return;
-  }
-  if (embedding_lookup_ops_.count(key) == 0) {
-    MS_LOG(ERROR) << "Invalid embedding lookup op key " << key;
-    return;
+  WeightPtr table_ptr = nullptr;
+  std::shared_ptr<PServerKernel> lookup_op = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (weights_.count(key) == 0) {
+      MS_LOG(ERROR) << "Invalid embedding table key " << key;
+      return;
+    }
+    if (embedding_lookup_ops_.count(key) == 0) {
+      MS_LOG(ERROR) << "Invalid embedding lookup op key " << key;
+      return;
+    }
+    table_ptr = weights_[key];
+    lookup_op = embedding_lookup_ops_[key];
   }
-  WeightPtr table_ptr = weights_[key];
   MS_EXCEPTION_IF_NULL(table_ptr);
-  std::shared_ptr<PServerKernel> lookup_op = embedding_lookup_ops_[key];
   MS_EXCEPTION_IF_NULL(lookup_op);
+
+  // The rows are updated under the row locks, so the lookups of the other rows are not blocked.
+  std::unique_lock<std::mutex> locker(access_weight_mutex_);
   lookup_op->UpdateEmbeddings(table_ptr->data(), lookup_ids.data(), vals.data(), lookup_ids.size());
 
   UpdateDirtyInfo(key, lookup_ids, lookup_op->offset());
@@ -639,6 +664,17 @@ const CNodePtr ParameterServer::GetCNode(const std::string &name) const {
 
 inline std::mutex &ParameterServer::mutex() { return mutex_; }
 
+std::mutex &ParameterServer::key_mutex(const Key &key) { return key_mutexes_[key % kKeyMutexNum]; }
+
+kernel::RowStripedLockPtr ParameterServer::GetRowLock(const Key &key) {
+  std::unique_lock<std::mutex> lock(row_locks_mutex_);
+  auto &row_lock = row_locks_[key];
+  if (row_lock == nullptr) {
+    row_lock = std::make_shared<kernel::RowStripedLock>();
+  }
+  return row_lock;
+}
+
 void ParameterServer::GetEmbeddingTableParamPtr() {
   if (ps::PsDataPrefetch::GetInstance().cache_enable()) {
     return;
@@ -716,6 +752,7 @@ void ParameterServer::RecoverKernels(const std::vector<Key> &keys,
       std::shared_ptr<PServerKernel> lookup =
         std::make_shared<kernel::ps::EmbeddingLookUpPSKernel>(server_node_->rank_id(), pserver_num_, worker_num_);
       lookup->InitKernel(shapes_ptr);
+      lookup->SetRowLock(GetRowLock(key));
       embedding_lookup_ops_[key] = lookup;
 
       // Recover embedding table parameter node address in graph.
@@ -808,25 +845,35 @@ void ParameterServer::PersistParameters() {
   }
 
   auto do_persist_task = [this]() {
-    std::unique_lock<std::mutex> locker(access_weight_mutex_);
-
     set_persistent_state(core::PersistentState::PERSISTING);
 
-    for (const auto &weight_key_pair : weights_) {
-      const WeightPtr &weight = weight_key_pair.second;
-      auto persistent_weight = std::dynamic_pointer_cast<PersistentWeight>(weight);
-      MS_EXCEPTION_IF_NULL(persistent_weight);
+    // Only the dirty rows are copied under the lock, and they are written to the storage after the lock is released,
+    // so the updates of the weights are not blocked by the disk io. The weights persisted the first time are copied
+    // and written block by block, and the lock is only held while each block is copied.
+    std::vector<PersistentWeightPtr> persistent_weights;
+    {
+      std::unique_lock<std::mutex> locker(access_weight_mutex_);
+      for (const auto &weight_key_pair : weights_) {
+        const WeightPtr &weight = weight_key_pair.second;
+        auto persistent_weight = std::dynamic_pointer_cast<PersistentWeight>(weight);
+        MS_EXCEPTION_IF_NULL(persistent_weight);
+
+        Key key = weight_key_pair.first;
+        auto iter = weights_dirty_info_.find(key);
+        if (iter == weights_dirty_info_.end()) {
+          MS_LOG(EXCEPTION) << "Cannot find dirty info for weight, key: " << key;
+        }
 
-      Key key = weight_key_pair.first;
-      auto iter = weights_dirty_info_.find(key);
-      if (iter == weights_dirty_info_.end()) {
-        MS_LOG(EXCEPTION) << "Cannot find dirty info for weight, key: " << key;
-      }
+        distributed::storage::DirtyInfo &dirty_info = iter->second;
+        persistent_weight->Snapshot(dirty_info);
+        persistent_weights.push_back(persistent_weight);
 
-      distributed::storage::DirtyInfo &dirty_info = iter->second;
-      persistent_weight->Persist(dirty_info);
+        dirty_info.clear();
+      }
+    }
 
-      dirty_info.clear();
+    for (const auto &persistent_weight : persistent_weights) {
+      persistent_weight->PersistSnapshot(&access_weight_mutex_);
     }
 
     set_persistent_state(core::PersistentState::FINISH_PERSIST);
@@ -906,7 +953,8 @@ void ParameterServer::ServerHandler::operator()(const std::shared_ptr<core::TcpC
   MS_LOG(DEBUG) << "The output size is:" << output->size();
 
   if (output->size() > 0) {
-    ps_->server_node_->Response(conn, meta, output->data(), output->size());
+    // The output is referenced by the connection until it's written, so it's not copied.
+    ps_->server_node_->Response(conn, meta, output);
   } else {
     // If the size of the output is 0, then constructed an empty string, Because the Response function is a synchronous,
     // the res variable  will be automatically recycled after calling the Response function
@@ -921,10 +969,22 @@ void ParameterServer::ServerHandler::operator()(const std::shared_ptr<core::TcpC
 
 void ParameterServer::ServerHandler::HandlePushReq(const DataPtr &data, size_t size, const VectorPtr &res) {
   MS_EXCEPTION_IF_NULL(res);
+  // The gradients of the raw message are accumulated in the request buffer without copy.
+  RawKVMessage raw_input;
+  if (ParseRawKV(data.get(), size, &raw_input)) {
+    Keys keys(raw_input.keys, raw_input.keys + raw_input.key_num);
+    Lengths lens(raw_input.lens, raw_input.lens + raw_input.len_num);
+    ps_->AccumGrad(keys, ValuesView(raw_input.values, raw_input.value_num), lens);
+    return;
+  }
   KVMessage input;
   CHECK_RETURN_TYPE(input.ParseFromArray(data.get(), SizeToInt(size)));
   Keys keys = {input.keys().begin(), input.keys().end()};
-  Values values = {input.values().begin(), input.values().end()};
+  Values values;
+  if (!GradientCompressor::DecompressMessage(input, &values)) {
+    MS_LOG(ERROR) << "Decompress the gradient of the push request failed.";
+    return;
+  }
   Lengths lens = {input.len().begin(), input.len().end()};
   MS_LOG(DEBUG) << "The keys:" << keys << " the values:" << values << " the len:" << lens;
   ps_->AccumGrad(keys, values, lens);
@@ -932,21 +992,31 @@ void ParameterServer::ServerHandler::HandlePushReq(const DataPtr &data, size_t s
 
 void ParameterServer::ServerHandler::HandlePullReq(const DataPtr &data, size_t size, const VectorPtr &res) {
   MS_EXCEPTION_IF_NULL(res);
-  KVMessage input;
-  CHECK_RETURN_TYPE(input.ParseFromArray(data.get(), SizeToInt(size)));
-  KVMessage res_data;
-  *res_data.mutable_keys() = input.keys();
-  Key key = input.keys()[0];
-  auto weight = ps_->weight(key);
+  Keys keys;
+  RawKVMessage raw_input;
+  if (ParseRawKV(data.get(), size, &raw_input)) {
+    keys.assign(raw_input.keys, raw_input.keys + raw_input.key_num);
+  } else {
+    KVMessage input;
+    CHECK_RETURN_TYPE(input.ParseFromArray(data.get(), SizeToInt(size)));
+    keys.assign(input.keys().begin(), input.keys().end());
+  }
+  if (keys.empty()) {
+    MS_LOG(ERROR) << "The pull request has no key.";
+    return;
+  }
+  auto weight = ps_->weight(keys[0]);
   auto weight_data = weight->MutableData();
   MS_EXCEPTION_IF_NULL(weight_data);
-  *res_data.mutable_values() = {weight_data->begin(), weight_data->end()};
-  res->resize(res_data.ByteSizeLong());
-  size_t dest_size = res_data.ByteSizeLong();
-  size_t src_size = res_data.ByteSizeLong();
-  int ret = memcpy_s(res->data(), dest_size, res_data.SerializeAsString().data(), src_size);
-  if (ret != 0) {
-    MS_LOG(EXCEPTION) << "The memcpy_s error, errorno(" << ret << ")";
+  // The weight is copied into the response in the raw layout once, which is sent without copy.
+  RawKVMessage res_data;
+  res_data.keys = keys.data();
+  res_data.key_num = keys.size();
+  res_data.values = weight_data->data();
+  res_data.value_num = weight_data->size();
+  res->resize(RawKVSize(res_data.key_num, res_data.len_num, res_data.value_num));
+  if (!SerializeRawKV(res_data, res->data(), res->size())) {
+    MS_LOG(EXCEPTION) << "Serialize the pull response of key " << keys[0] << " failed.";
   }
 }
 
@@ -1107,7 +1177,6 @@ void ParameterServer::ServerHandler::HandleEmbeddingLookup(const DataPtr &data,
 }
 
 void ParameterServer::ServerHandler::HandleUpdateEmbeddings(const DataPtr &data, size_t size, const VectorPtr &res) {
-  std::unique_lock<std::mutex> lock(ps_->mutex());
   MS_EXCEPTION_IF_NULL(res);
   KVMessage input;
   CHECK_RETURN_TYPE(input.ParseFromArray(data.get(), SizeToInt(size)));
@@ -18,6 +18,7 @@
 #define MINDSPORE_CCSRC_PS_PARAMETER_SERVER_H_
 
 #include <unistd.h>
+#include <array>
 #include <string>
 #include <iostream>
 #include <memory>
@@ -58,6 +59,7 @@
 #include "ps/constants.h"
 #include "ps/util.h"
 #include "ps/embedding_table_shard_metadata.h"
+#include "ps/gradient_compressor.h"
 #include "utils/log_adapter.h"
 #include "proto/comm.pb.h"
 #include "proto/ps.pb.h"
@@ -66,6 +68,9 @@
 
 namespace mindspore {
 namespace ps {
+// The number of the mutexes which the keys are mapped to.
+constexpr size_t kKeyMutexNum = 64;
+
 class ParameterServer {
  public:
   static ParameterServer &GetInstance() {
@@ -157,7 +162,8 @@ class ParameterServer {
   bool HasWeight(const Key &key);
   void Finalize();
   void UpdateWeights();
-  void AccumGrad(const Keys &key, const Values &values, const Lengths &lengths);
+  void UpdateWeight(const Key &key);
+  void AccumGrad(const Keys &key, const ValuesView &values, const Lengths &lengths);
   WeightPtr weight(const Key &key);
   void DoEmbeddingLookup(Key key, const LookupIds &lookup_ids, KVMessage *res);
   void UpdateEmbeddings(const Key &key, const LookupIds &lookup_ids, const Values &vals);
@@ -167,6 +173,10 @@ class ParameterServer {
   inline void ResetGradAccumCount();
   const CNodePtr GetCNode(const std::string &name) const;
   inline std::mutex &mutex();
+  // The mutex serializing the accumulation and update of the optimizer info of the key.
+  std::mutex &key_mutex(const Key &key);
+  // Get or create the row locks of the embedding table, which are shared by its lookup kernel and optimizer kernel.
+  kernel::RowStripedLockPtr GetRowLock(const Key &key);
   void GetEmbeddingTableParamPtr();
   void SyncEmbeddingTables();
   // Cache embedding table parameter by map, key: parameter name, value: parameter node pointer
@@ -232,8 +242,12 @@ class ParameterServer {
   mindspore::HashMap<Key, std::shared_ptr<PServerKernel>> embedding_lookup_ops_;
   mindspore::HashMap<Key, uint64_t> tokens_;
 
+  // The mutex_ protects the maps and the states of the keys, the data of the keys are accessed out of it.
   std::mutex mutex_;
   std::condition_variable apply_grads_cv_;
+  std::array<std::mutex, kKeyMutexNum> key_mutexes_;
+  mindspore::HashMap<Key, kernel::RowStripedLockPtr> row_locks_;
+  std::mutex row_locks_mutex_;
 
   std::mutex access_weight_mutex_;
   std::unique_ptr<std::thread> thread_;
@@ -53,26 +53,34 @@ int EmbeddingHashMap::FindInsertionPos(const size_t, const size_t graph_running_
   MS_EXCEPTION_IF_NULL(need_swap);
   MS_EXCEPTION_IF_NULL(need_wait_graph);
   int hash_index = INVALID_INDEX_VALUE;
-  while (!expired_element_full_) {
-    if (hash_map_elements_[current_pos_].IsEmpty()) {
-      hash_index = current_pos_;
-      hash_count_++;
-    } else if (hash_map_elements_[current_pos_].IsExpired(graph_running_step)) {
-      hash_index = current_pos_;
-      *need_swap = true;
-    } else if (hash_map_elements_[current_pos_].IsStep(graph_running_step)) {
-      graph_running_index_[graph_running_index_num_++] = current_pos_;
+  size_t sample_num = frequency_sketch_ == nullptr ? 1 : kEvictionSampleNum;
+  do {
+    while (!expired_element_full_ && eviction_candidates_.size() < sample_num) {
+      if (hash_map_elements_[current_pos_].IsEmpty()) {
+        hash_index = current_pos_;
+        hash_count_++;
+      } else if (hash_map_elements_[current_pos_].IsExpired(graph_running_step)) {
+        eviction_candidates_.push_back(current_pos_);
+      } else if (hash_map_elements_[current_pos_].IsStep(graph_running_step)) {
+        graph_running_index_[graph_running_index_num_++] = current_pos_;
+      }
+      current_pos_ = (current_pos_ + 1) % hash_capacity_;
+      if (hash_index != INVALID_INDEX_VALUE) {
+        return hash_index;
+      }
+      if (current_pos_ == current_batch_start_pos_) {
+        expired_element_full_ = true;
+        MS_LOG(INFO) << "Running step:" << graph_running_step << "(num:" << graph_running_index_num_
+                     << ") will be used, index swap will wait until the graph completed.";
+      }
     }
-    current_pos_ = (current_pos_ + 1) % hash_capacity_;
+
+    hash_index = PopEvictionCandidate(graph_running_step);
     if (hash_index != INVALID_INDEX_VALUE) {
+      *need_swap = true;
       return hash_index;
     }
-    if (current_pos_ == current_batch_start_pos_) {
-      expired_element_full_ = true;
-      MS_LOG(INFO) << "Running step:" << graph_running_step << "(num:" << graph_running_index_num_
-                   << ") will be used, index swap will wait until the graph completed.";
-    }
-  }
+  } while (!expired_element_full_);
 
   if (graph_running_index_pos_ != graph_running_index_num_) {
     *need_swap = true;
@@ -82,6 +90,41 @@ int EmbeddingHashMap::FindInsertionPos(const size_t, const size_t graph_running_
   return INVALID_INDEX_VALUE;
 }
 
+int EmbeddingHashMap::PopEvictionCandidate(const size_t graph_running_step) {
+  int hash_index = INVALID_INDEX_VALUE;
+  size_t candidate_pos = 0;
+  uint8_t min_frequency = 0;
+  size_t i = 0;
+  while (i < eviction_candidates_.size()) {
+    const auto &element = hash_map_elements_[eviction_candidates_[i]];
+    if (element.IsEmpty() || !element.IsExpired(graph_running_step)) {
+      // The element is used by the batch after it's scanned, so it's dropped from the candidates. The candidates
+      // behind the chosen one are moved, so the chosen position is kept.
+      eviction_candidates_[i] = eviction_candidates_.back();
+      eviction_candidates_.pop_back();
+      continue;
+    }
+    if (frequency_sketch_ == nullptr) {
+      hash_index = eviction_candidates_[i];
+      candidate_pos = i;
+      break;
+    }
+    uint8_t frequency = frequency_sketch_->Estimate(static_cast<uint64_t>(element.id_));
+    if (hash_index == INVALID_INDEX_VALUE || frequency < min_frequency) {
+      hash_index = eviction_candidates_[i];
+      candidate_pos = i;
+      min_frequency = frequency;
+    }
+    ++i;
+  }
+  if (hash_index == INVALID_INDEX_VALUE) {
+    return hash_index;
+  }
+  eviction_candidates_[candidate_pos] = eviction_candidates_.back();
+  eviction_candidates_.pop_back();
+  return hash_index;
+}
+
 void EmbeddingHashMap::DumpHashMap() {
   MS_LOG(INFO) << "Dump hash map info begin, hash_capacity: " << hash_capacity_ << " hash_count: " << hash_count_;
   MS_LOG(INFO) << "Dump hash_id_to_index: ";
@@ -103,6 +146,7 @@ void EmbeddingHashMap::Reset() {
   graph_running_index_num_ = 0;
   graph_running_index_pos_ = 0;
   expired_element_full_ = false;
+  eviction_candidates_.clear();
 }
 }  // namespace ps
 }  // namespace mindspore
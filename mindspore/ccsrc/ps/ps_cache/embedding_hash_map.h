@@ -23,11 +23,14 @@
 #include <vector>
 #include "utils/hash_map.h"
 #include "utils/convert_utils_base.h"
+#include "utils/frequency_sketch.h"
 
 namespace mindspore {
 namespace ps {
 static const size_t INVALID_STEP_VALUE = 0;
 static const int INVALID_INDEX_VALUE = -1;
+// The number of the expired elements sampled to choose the least frequently used one to be swapped out.
+static const size_t kEvictionSampleNum = 16;
 
 struct HashMapElement {
   int id_{INVALID_INDEX_VALUE};
@@ -65,12 +68,19 @@ class EmbeddingHashMap {
   void set_hash_step(const int hash_index, const size_t step) { hash_map_elements_[hash_index].set_step(step); }
   const mindspore::HashMap<int, int> &hash_id_to_index() const { return hash_id_to_index_; }
   size_t hash_capacity() const { return hash_capacity_; }
+  // Swap out the least frequently used one of the sampled expired elements instead of the first expired one, the
+  // frequency of the ids is estimated by the sketch.
+  void set_frequency_sketch(const std::shared_ptr<FrequencySketch> &frequency_sketch) {
+    frequency_sketch_ = frequency_sketch;
+    eviction_candidates_.clear();
+  }
   void DumpHashMap();
   void Reset();
 
  private:
   int FindInsertionPos(const size_t data_step, const size_t graph_running_step, bool *const need_swap,
                        bool *const need_wait_graph);
+  int PopEvictionCandidate(const size_t graph_running_step);
   size_t hash_count_;
   size_t hash_capacity_;
   std::vector<HashMapElement> hash_map_elements_;
@@ -81,6 +91,9 @@ class EmbeddingHashMap {
   size_t graph_running_index_pos_;
   std::unique_ptr<int[]> graph_running_index_;
   bool expired_element_full_;
+  std::shared_ptr<FrequencySketch> frequency_sketch_{nullptr};
+  // The expired elements which are scanned but not swapped out yet in the current batch.
+  std::vector<int> eviction_candidates_;
 };
 }  // namespace ps
 }  // namespace mindspore
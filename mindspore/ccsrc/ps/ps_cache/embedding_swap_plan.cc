@@ -0,0 +1,139 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/ps_cache/embedding_swap_plan.h"
+#include <algorithm>
+#include "utils/hash_set.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace ps {
+EmbeddingSwapPlanQueue::EmbeddingSwapPlanQueue(size_t plan_num, size_t batch_elements) {
+  for (size_t i = 0; i < plan_num; ++i) {
+    free_plans_.push_back(std::make_shared<EmbeddingSwapPlan>(batch_elements));
+  }
+}
+
+EmbeddingSwapPlanPtr EmbeddingSwapPlanQueue::Acquire() {
+  std::unique_lock<std::mutex> locker(mutex_);
+  cv_.wait(locker, [this] { return !free_plans_.empty() || stopped_; });
+  if (stopped_) {
+    return nullptr;
+  }
+  auto swap_plan = free_plans_.front();
+  free_plans_.pop_front();
+  swap_plan->Reset();
+  return swap_plan;
+}
+
+void EmbeddingSwapPlanQueue::Submit(const EmbeddingSwapPlanPtr &swap_plan) {
+  MS_EXCEPTION_IF_NULL(swap_plan);
+  std::unique_lock<std::mutex> locker(mutex_);
+  pending_plans_.push_back(swap_plan);
+  cv_.notify_all();
+}
+
+EmbeddingSwapPlanPtr EmbeddingSwapPlanQueue::Front() {
+  std::unique_lock<std::mutex> locker(mutex_);
+  cv_.wait(locker, [this] { return !pending_plans_.empty() || stopped_; });
+  if (stopped_) {
+    return nullptr;
+  }
+  return pending_plans_.front();
+}
+
+void EmbeddingSwapPlanQueue::Finish() {
+  std::unique_lock<std::mutex> locker(mutex_);
+  if (pending_plans_.empty()) {
+    MS_LOG(ERROR) << "There is no pending swap plan to finish.";
+    return;
+  }
+  auto swap_plan = pending_plans_.front();
+  pending_plans_.pop_front();
+  swapped_step_ = swap_plan->data_step_;
+  free_plans_.push_back(swap_plan);
+  cv_.notify_all();
+}
+
+bool EmbeddingSwapPlanQueue::WaitSwapped(size_t data_step) {
+  std::unique_lock<std::mutex> locker(mutex_);
+  cv_.wait(locker, [this, data_step] { return swapped_step_ >= data_step || stopped_; });
+  return swapped_step_ >= data_step;
+}
+
+void EmbeddingSwapPlanQueue::WaitEmpty() {
+  std::unique_lock<std::mutex> locker(mutex_);
+  cv_.wait(locker, [this] { return pending_plans_.empty() || stopped_; });
+}
+
+void EmbeddingSwapPlanQueue::Stop() {
+  std::unique_lock<std::mutex> locker(mutex_);
+  stopped_ = true;
+  cv_.notify_all();
+}
+
+bool EmbeddingSwapPlanQueue::stopped() {
+  std::unique_lock<std::mutex> locker(mutex_);
+  return stopped_;
+}
+
+size_t EmbeddingSwapPlanQueue::swapped_step() {
+  std::unique_lock<std::mutex> locker(mutex_);
+  return swapped_step_;
+}
+
+std::vector<EmbeddingSwapPlanPtr> EmbeddingSwapPlanQueue::SelectPrefetchPlans(const EmbeddingSwapPlan &swap_plan) {
+  std::vector<EmbeddingSwapPlanPtr> pending_plans;
+  {
+    std::unique_lock<std::mutex> locker(mutex_);
+    if (pending_plans_.empty() || pending_plans_.front().get() != &swap_plan) {
+      MS_LOG(ERROR) << "The swap plan of data step " << swap_plan.data_step_ << " is not the first pending one.";
+      return {};
+    }
+    pending_plans.assign(pending_plans_.begin() + 1, pending_plans_.end());
+  }
+  // The embeddings on the server are only changed by the host_to_server swaps, so the server_to_host ids of a next
+  // batch can be looked up in advance if they are not swapped to the server by this batch or the batches before it.
+  // The batches after the first one which can't be prefetched are swapped later, so they are not prefetched now.
+  std::vector<EmbeddingSwapPlanPtr> prefetch_plans;
+  mindspore::HashSet<int> swap_out_ids;
+  const int *host_to_server_ids = swap_plan.host_.host_to_server_ids.get();
+  swap_out_ids.insert(host_to_server_ids, host_to_server_ids + swap_plan.statistics_info_.host_to_server_size_);
+  bool stop_prefetch = false;
+  for (const auto &pending_plan : pending_plans) {
+    host_to_server_ids = pending_plan->host_.host_to_server_ids.get();
+    swap_out_ids.insert(host_to_server_ids, host_to_server_ids + pending_plan->statistics_info_.host_to_server_size_);
+    const int *server_to_host_ids = pending_plan->host_.server_to_host_ids.get();
+    size_t server_to_host_size = pending_plan->statistics_info_.server_to_host_size_;
+    bool stale = std::any_of(server_to_host_ids, server_to_host_ids + server_to_host_size,
+                             [&swap_out_ids](int id) { return swap_out_ids.count(id) != 0; });
+    if (stale) {
+      // The prefetched embeddings would miss the rows swapped out by the in-flight batches.
+      if (pending_plan->prefetched_) {
+        MS_LOG(INFO) << "Invalidate the prefetched embeddings of data step " << pending_plan->data_step_;
+        pending_plan->InvalidatePrefetch();
+      }
+      stop_prefetch = true;
+      continue;
+    }
+    if (!stop_prefetch && !pending_plan->prefetched_ && server_to_host_size != 0) {
+      prefetch_plans.push_back(pending_plan);
+    }
+  }
+  return prefetch_plans;
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,143 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PS_PS_CACHE_EMBEDDING_SWAP_PLAN_H_
+#define MINDSPORE_CCSRC_PS_PS_CACHE_EMBEDDING_SWAP_PLAN_H_
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mindspore {
+namespace ps {
+struct PsCacheStatisticsInfo {
+  size_t batch_id_count_{0};
+  size_t batch_id_unique_count_{0};
+  size_t device_to_host_size_{0};
+  size_t host_to_device_size_{0};
+  size_t host_to_server_size_{0};
+  size_t server_to_host_size_{0};
+  size_t hash_hit_count_{0};
+  size_t mem_cache_swap_out_size_{0};
+  size_t mem_cache_swap_in_size_{0};
+  size_t mem_cache_hit_count_{0};
+  float device_hit_rate_{0};
+  float host_hit_rate_{0};
+};
+
+// The swap indices and ids of the device cache for one batch.
+struct DeviceSwapBuffer {
+  explicit DeviceSwapBuffer(size_t batch_elements) {
+    device_to_host_index = std::make_unique<int[]>(batch_elements);
+    device_to_host_ids = std::make_unique<int[]>(batch_elements);
+    host_to_device_index = std::make_unique<int[]>(batch_elements);
+    host_to_device_ids = std::make_unique<int[]>(batch_elements);
+  }
+  std::unique_ptr<int[]> device_to_host_index;
+  std::unique_ptr<int[]> device_to_host_ids;
+  std::unique_ptr<int[]> host_to_device_index;
+  std::unique_ptr<int[]> host_to_device_ids;
+};
+
+// The swap indices and ids of the host cache for one batch.
+struct HostSwapBuffer {
+  explicit HostSwapBuffer(size_t batch_elements) {
+    host_to_server_index = std::make_unique<int[]>(batch_elements);
+    host_to_server_ids = std::make_unique<int[]>(batch_elements);
+    server_to_host_index = std::make_unique<int[]>(batch_elements);
+    server_to_host_ids = std::make_unique<int[]>(batch_elements);
+    host_to_device_index = std::make_unique<int[]>(batch_elements);
+    device_to_host_index = std::make_unique<int[]>(batch_elements);
+  }
+  std::unique_ptr<int[]> host_to_server_index;
+  std::unique_ptr<int[]> host_to_server_ids;
+  std::unique_ptr<int[]> server_to_host_index;
+  std::unique_ptr<int[]> server_to_host_ids;
+  std::unique_ptr<int[]> host_to_device_index;
+  std::unique_ptr<int[]> device_to_host_index;
+};
+
+// The swaps of one batch, which are planned by the parse data thread when the ids of the batch are replaced by the hash
+// indices, and executed by the process data thread before the graph runs the step of the batch.
+struct EmbeddingSwapPlan {
+  explicit EmbeddingSwapPlan(size_t batch_elements) : device_(batch_elements), host_(batch_elements) {}
+  void Reset() {
+    data_step_ = 0;
+    need_wait_graph_ = false;
+    wait_graph_step_ = 0;
+    InvalidatePrefetch();
+  }
+  // The prefetched embeddings are dropped and looked up again when the batch is swapped.
+  void InvalidatePrefetch() {
+    prefetched_ = false;
+    prefetched_embeddings_.clear();
+  }
+  size_t data_step_{0};
+  // The ids used by the graph step wait_graph_step_ are swapped out, so the swap waits until the graph step is over.
+  bool need_wait_graph_{false};
+  size_t wait_graph_step_{0};
+  // The swap sizes of the batch.
+  PsCacheStatisticsInfo statistics_info_;
+  DeviceSwapBuffer device_;
+  HostSwapBuffer host_;
+  // The embeddings of the server_to_host ids, which are looked up together with the ones of an earlier batch.
+  bool prefetched_{false};
+  std::map<size_t, std::vector<float>> prefetched_embeddings_;
+};
+using EmbeddingSwapPlanPtr = std::shared_ptr<EmbeddingSwapPlan>;
+
+// The swap plans which are free and the ones which are parsed but not swapped, in the order of the data steps. The
+// plans are acquired and submitted by the parse data thread, and swapped in order by the process data thread. All the
+// waits return once the queue is stopped.
+class EmbeddingSwapPlanQueue {
+ public:
+  EmbeddingSwapPlanQueue(size_t plan_num, size_t batch_elements);
+  ~EmbeddingSwapPlanQueue() = default;
+
+  // Wait for a free plan, which is reset. Return nullptr if the queue is stopped.
+  EmbeddingSwapPlanPtr Acquire();
+  void Submit(const EmbeddingSwapPlanPtr &swap_plan);
+  // Wait for the first pending plan, which stays pending until it is finished. Return nullptr if the queue is stopped.
+  EmbeddingSwapPlanPtr Front();
+  // Free the first pending plan, whose data step is then swapped.
+  void Finish();
+  // Wait until the data step is swapped. Return false if the queue is stopped.
+  bool WaitSwapped(size_t data_step);
+  // Wait until all the pending plans are swapped or the queue is stopped.
+  void WaitEmpty();
+  void Stop();
+  bool stopped();
+  size_t swapped_step();
+
+  // Select the next pending plans of the swap_plan, whose server_to_host ids can be looked up from the server together
+  // with the ones of the swap_plan. The prefetched plans whose ids are swapped to the server by an earlier plan are
+  // invalidated, so their embeddings are looked up again when they are swapped.
+  std::vector<EmbeddingSwapPlanPtr> SelectPrefetchPlans(const EmbeddingSwapPlan &swap_plan);
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<EmbeddingSwapPlanPtr> free_plans_;
+  std::deque<EmbeddingSwapPlanPtr> pending_plans_;
+  size_t swapped_step_{0};
+  bool stopped_{false};
+};
+}  // namespace ps
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PS_PS_CACHE_EMBEDDING_SWAP_PLAN_H_
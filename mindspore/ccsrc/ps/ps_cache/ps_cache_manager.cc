@@ -149,10 +149,17 @@ void PsCacheManager::Initialize() {
   if (!Worker::GetInstance().running()) {
     Worker::GetInstance().Run();
   }
-  embedding_device_cache_ = std::make_shared<EmbeddingDeviceCache>(batch_elements_, vocab_cache_size_);
+  embedding_device_cache_ = std::make_shared<EmbeddingDeviceCache>(vocab_cache_size_);
   MS_ERROR_IF_NULL_WO_RET_VAL(embedding_device_cache_);
-  embedding_host_cache_ = std::make_shared<EmbeddingHostCache>(batch_elements_, host_vocab_cache_size_);
+  embedding_host_cache_ = std::make_shared<EmbeddingHostCache>(host_vocab_cache_size_);
   MS_ERROR_IF_NULL_WO_RET_VAL(embedding_host_cache_);
+  swap_plans_ = std::make_unique<EmbeddingSwapPlanQueue>(kMaxSwapPlanNum, batch_elements_);
+  if (common::GetEnv(kEnvCacheEvictionPolicy) != kCacheEvictionPolicyStep) {
+    frequency_sketch_ = std::make_shared<FrequencySketch>(host_vocab_cache_size_);
+    embedding_device_cache_->device_hash_map_->set_frequency_sketch(frequency_sketch_);
+    embedding_host_cache_->host_hash_map_->set_frequency_sketch(frequency_sketch_);
+    MS_LOG(INFO) << "PS cache uses the TinyLFU eviction policy, sketch width:" << frequency_sketch_->width();
+  }
   AddEmbeddingTable();
   AllocMemForHashTable();
   SetLocalIdRank();
@@ -323,7 +330,15 @@ void PsCacheManager::IncreaseGraphStep(const std::string &channel_name) {
   if (!PsDataPrefetch::GetInstance().TryWakeChannel(channel_name)) {
     MS_LOG(EXCEPTION) << "TryWakeChannel failed, channel name: " << channel_name;
   }
-  data_prase_.notify_one();
+  data_prase_.notify_all();
+
+  // The hash indices of the batch are returned before its embeddings are swapped in, so the graph step waits until
+  // the swap of the batch is finished. The swap is not waited for any more once the cache is stopped, e.g. finalized.
+  MS_EXCEPTION_IF_NULL(swap_plans_);
+  if (!swap_plans_->WaitSwapped(graph_step_)) {
+    MS_LOG(WARNING) << "PS embedding cache is stopped before the swap of graph step " << graph_step_
+                    << " is finished, swapped step: " << swap_plans_->swapped_step();
+  }
 }
 
 void PsCacheManager::DoProcessData(uint32_t device_id, const void *context) {
@@ -346,31 +361,58 @@ void PsCacheManager::ProcessDataTask(uint32_t device_id, const void *context) {
   if (!(embedding_device_cache_->cache_->MallocConstantMemory(vocab_cache_size_))) {
     MS_LOG(ERROR) << "MallocConstantMemory failed.";
     running_ = false;
+    swap_plans_->Stop();
     return;
   }
 
   if (!InitParameterServer()) {
     MS_LOG(ERROR) << "InitParameterServer failed.";
     running_ = false;
+    swap_plans_->Stop();
     return;
   }
 
   InitDataChannel();
+  // The batches are parsed in the parse data thread, and their embeddings are swapped in this thread, which owns the
+  // device context.
+  parse_data_thread_ = std::thread(&PsCacheManager::ParseDataTask, this);
   while (running_) {
-    if (!ProcessData()) {
+    if (!SwapData()) {
       running_ = false;
     }
   }
+  swap_plans_->Stop();
+  data_prase_.notify_all();
+  if (parse_data_thread_.joinable()) {
+    parse_data_thread_.join();
+  }
   MS_LOG(INFO) << "PS embedding cache process data task end.";
 }
 
+void PsCacheManager::ParseDataTask() {
+  MS_LOG(INFO) << "PS embedding cache parse data task begin.";
+  while (running_) {
+    if (!ProcessData()) {
+      running_ = false;
+    }
+  }
+  swap_plans_->Stop();
+  MS_LOG(INFO) << "PS embedding cache parse data task end.";
+}
+
 void PsCacheManager::Finalize() {
+  if (swap_plans_ != nullptr) {
+    swap_plans_->WaitEmpty();
+  }
   SyncEmbeddingTable();
 
   running_ = false;
   PsDataPrefetch::GetInstance().NotifyFinalize();
   insert_init_info_.notify_all();
   data_prase_.notify_all();
+  if (swap_plans_ != nullptr) {
+    swap_plans_->Stop();
+  }
   if (process_data_thread_.joinable()) {
     process_data_thread_.join();
   }
@@ -405,28 +447,27 @@ bool PsCacheManager::ProcessData() {
     MS_LOG(ERROR) << "Process data memset failed.";
     return false;
   }
+  swap_plan_ = swap_plans_->Acquire();
+  if (swap_plan_ == nullptr) {
+    return true;
+  }
   // Get hash swap in/out index and ids.
   RETURN_IF_FALSE_WITH_LOG(ParseData(batch_ids, batch_ids_len, hash_index.get()), "Parse data failed.");
+  UpdateStatisticsInfo();
   DumpStatisticsInfo();
-  if ((device_need_wait_graph_ || host_need_wait_graph_) && (!WaitGraphRun())) {
-    MS_LOG(ERROR) << "Ps cache wait graph finish failed.";
-    return false;
-  }
-  for (const auto &item : hash_tables_) {
-    auto key = Worker::GetInstance().GetParamKey(item.first);
-    auto hash_info = item.second;
-    RETURN_IF_FALSE_WITH_LOG(HashSwapHostToServer(key, hash_info), "HashSwapHostToServer failed.");
-    RETURN_IF_FALSE_WITH_LOG(HashSwapDeviceToHost(hash_info), "HashSwapDeviceToHost failed.");
-    RETURN_IF_FALSE_WITH_LOG(HashSwapServerToHost(key, hash_info), "HashSwapServerToHost failed.");
-    RETURN_IF_FALSE_WITH_LOG(HashSwapHostToDevice(hash_info), "HashSwapHostToDevice failed.");
-  }
+  swap_plan_->data_step_ = data_step_;
+  swap_plan_->need_wait_graph_ = device_need_wait_graph_ || host_need_wait_graph_;
+  swap_plan_->wait_graph_step_ = graph_running_step_;
+  swap_plan_->statistics_info_ = statistics_info_;
   size_t dest_len = data_size;
   // Replace the batch_ids by hash index for getNext-op getting hash index as input.
   if (memcpy_s(data, dest_len, hash_index.get(), data_size) != EOK) {
     MS_LOG(ERROR) << "Process data memcpy failed.";
     return false;
   }
-  RETURN_IF_FALSE_WITH_LOG(embedding_device_cache_->cache_->SynchronizeStream(), "SynchronizeStream failed.");
+  // The swaps are executed by the process data thread, while the next batch is parsed.
+  swap_plans_->Submit(swap_plan_);
+  swap_plan_ = nullptr;
   (void)gettimeofday(&end_time, nullptr);
   // Finish the data process and notify data prefetch.
   RETURN_IF_FALSE_WITH_LOG(PsDataPrefetch::GetInstance().FinalizeData(channel_name_), "Finalize data failed.");
@@ -539,6 +580,13 @@ bool PsCacheManager::ParseData(const int *batch_ids, const size_t batch_ids_len,
   }
   RETURN_IF_FALSE(CheckCacheHitOrOutRange(batch_ids, batch_ids_len, hash_index, in_device.get(), out_range.get()));
   RETURN_IF_FALSE(ResetEmbeddingHashMap());
+  if (frequency_sketch_ != nullptr) {
+    for (size_t i = 0; i < batch_ids_len; i++) {
+      if (!out_range[i]) {
+        frequency_sketch_->Increment(static_cast<uint64_t>(batch_ids[i]));
+      }
+    }
+  }
   for (size_t i = 0; i < batch_ids_len; i++) {
     if (in_device[i] || out_range[i]) {
       continue;
@@ -560,15 +608,52 @@ bool PsCacheManager::ParseData(const int *batch_ids, const size_t batch_ids_len,
 
 bool PsCacheManager::WaitGraphRun() {
   MS_LOG(INFO) << "Hash table has no space to insert new data and retries within 2 minutes.";
+  RETURN_IF_FALSE(WaitGraphStep(graph_running_step_));
+  set_current_graph_step();
+  return true;
+}
+
+bool PsCacheManager::WaitGraphStep(size_t graph_step) {
   std::unique_lock<std::mutex> locker(data_mutex_);
   const int64_t longest_time_to_wait = 120;
   if (!data_prase_.wait_for(locker, std::chrono::seconds(longest_time_to_wait),
-                            [this] { return graph_step_ > graph_running_step_; })) {
+                            [this, graph_step] { return graph_step_ > graph_step || !running_; })) {
     MS_LOG(ERROR) << "Ps cache data parse timeout, suggest to enlarge the cache size(graph step:" << graph_step_
-                  << ", graph running step:" << graph_running_step_ << ").";
+                  << ", graph running step:" << graph_step << ").";
     return false;
   }
-  set_current_graph_step();
+  return running_;
+}
+
+bool PsCacheManager::SwapData() {
+  MS_ERROR_IF_NULL(swap_plans_);
+  auto swap_plan = swap_plans_->Front();
+  if (swap_plan == nullptr) {
+    return true;
+  }
+  MS_ERROR_IF_NULL(embedding_device_cache_);
+  MS_ERROR_IF_NULL(embedding_device_cache_->cache_);
+  if (swap_plan->need_wait_graph_ && !WaitGraphStep(swap_plan->wait_graph_step_)) {
+    MS_LOG(ERROR) << "Ps cache wait graph finish failed.";
+    return false;
+  }
+
+  // Look up the embeddings swapped from the server of the next batches together with this batch.
+  auto prefetch_plans = swap_plans_->SelectPrefetchPlans(*swap_plan);
+  for (const auto &item : hash_tables_) {
+    auto key = Worker::GetInstance().GetParamKey(item.first);
+    auto hash_info = item.second;
+    RETURN_IF_FALSE_WITH_LOG(HashSwapHostToServer(key, hash_info, *swap_plan), "HashSwapHostToServer failed.");
+    RETURN_IF_FALSE_WITH_LOG(HashSwapDeviceToHost(hash_info, *swap_plan), "HashSwapDeviceToHost failed.");
+    RETURN_IF_FALSE_WITH_LOG(HashSwapServerToHost(key, hash_info, swap_plan.get(), prefetch_plans),
+                             "HashSwapServerToHost failed.");
+    RETURN_IF_FALSE_WITH_LOG(HashSwapHostToDevice(hash_info, *swap_plan), "HashSwapHostToDevice failed.");
+  }
+  for (const auto &prefetch_plan : prefetch_plans) {
+    prefetch_plan->prefetched_ = true;
+  }
+  RETURN_IF_FALSE_WITH_LOG(embedding_device_cache_->cache_->SynchronizeStream(), "SynchronizeStream failed.");
+  swap_plans_->Finish();
   return true;
 }
 
@@ -593,10 +678,11 @@ bool PsCacheManager::ParseDeviceData(size_t id, bool *need_swap_device_to_host,
       device_hash_map->set_hash_step(index, data_step_);
     }
   } else {
-    int *device_to_host_index = embedding_device_cache_->device_to_host_index.get();
-    int *device_to_host_ids = embedding_device_cache_->device_to_host_ids.get();
-    int *host_to_device_index = embedding_device_cache_->host_to_device_index.get();
-    int *host_to_device_ids = embedding_device_cache_->host_to_device_ids.get();
+    MS_ERROR_IF_NULL(swap_plan_);
+    int *device_to_host_index = swap_plan_->device_.device_to_host_index.get();
+    int *device_to_host_ids = swap_plan_->device_.device_to_host_ids.get();
+    int *host_to_device_index = swap_plan_->device_.host_to_device_index.get();
+    int *host_to_device_ids = swap_plan_->device_.host_to_device_ids.get();
     MS_ERROR_IF_NULL(host_to_device_index);
     MS_ERROR_IF_NULL(host_to_device_ids);
     auto tmp_device_to_host_size = statistics_info_.device_to_host_size_;
@@ -622,7 +708,8 @@ bool PsCacheManager::ParseDeviceData(size_t id, bool *need_swap_device_to_host,
 
 bool PsCacheManager::ParseHostDataHostToDevice(size_t id) {
   MS_ERROR_IF_NULL(embedding_host_cache_);
-  int *host_to_device_index = embedding_host_cache_->host_to_device_index.get();
+  MS_ERROR_IF_NULL(swap_plan_);
+  int *host_to_device_index = swap_plan_->host_.host_to_device_index.get();
   MS_ERROR_IF_NULL(host_to_device_index);
   auto &host_hash_map = embedding_host_cache_->host_hash_map_;
   MS_ERROR_IF_NULL(host_hash_map);
@@ -636,10 +723,10 @@ bool PsCacheManager::ParseHostDataHostToDevice(size_t id) {
     }
     host_to_device_index[statistics_info_.host_to_device_size_ - 1] = index;
   } else {
-    int *host_to_server_index = embedding_host_cache_->host_to_server_index.get();
-    int *host_to_server_ids = embedding_host_cache_->host_to_server_ids.get();
-    int *server_to_host_index = embedding_host_cache_->server_to_host_index.get();
-    int *server_to_host_ids = embedding_host_cache_->server_to_host_ids.get();
+    int *host_to_server_index = swap_plan_->host_.host_to_server_index.get();
+    int *host_to_server_ids = swap_plan_->host_.host_to_server_ids.get();
+    int *server_to_host_index = swap_plan_->host_.server_to_host_index.get();
+    int *server_to_host_ids = swap_plan_->host_.server_to_host_ids.get();
     MS_ERROR_IF_NULL(server_to_host_index);
     MS_ERROR_IF_NULL(server_to_host_ids);
     while (true) {
@@ -660,10 +747,10 @@ bool PsCacheManager::ParseHostDataHostToDevice(size_t id) {
 }
 
 bool PsCacheManager::ParseHostDataDeviceToHost() {
-  MS_ERROR_IF_NULL(embedding_device_cache_);
   MS_ERROR_IF_NULL(embedding_host_cache_);
-  int *device_to_host_ids = embedding_device_cache_->device_to_host_ids.get();
-  int *device_to_host_index = embedding_host_cache_->device_to_host_index.get();
+  MS_ERROR_IF_NULL(swap_plan_);
+  int *device_to_host_ids = swap_plan_->device_.device_to_host_ids.get();
+  int *device_to_host_index = swap_plan_->host_.device_to_host_index.get();
   MS_ERROR_IF_NULL(device_to_host_ids);
   MS_ERROR_IF_NULL(device_to_host_index);
 
@@ -679,8 +766,8 @@ bool PsCacheManager::ParseHostDataDeviceToHost() {
     }
     device_to_host_index[statistics_info_.device_to_host_size_ - 1] = index;
   } else {
-    int *host_to_server_index = embedding_host_cache_->host_to_server_index.get();
-    int *host_to_server_ids = embedding_host_cache_->host_to_server_ids.get();
+    int *host_to_server_index = swap_plan_->host_.host_to_server_index.get();
+    int *host_to_server_ids = swap_plan_->host_.host_to_server_ids.get();
     while (true) {
       auto index =
         host_hash_map->ParseData(swap_device_to_host_id, host_to_server_index, host_to_server_ids, data_step_,
@@ -809,13 +896,12 @@ bool PsCacheManager::InsertHostHashTable(size_t embedding_size, size_t insert_in
   return running_;
 }
 
-bool PsCacheManager::HashSwapHostToDevice(const HashTableInfo &hash_info) {
+bool PsCacheManager::HashSwapHostToDevice(const HashTableInfo &hash_info, const EmbeddingSwapPlan &swap_plan) {
   MS_ERROR_IF_NULL(embedding_device_cache_);
   MS_ERROR_IF_NULL(embedding_device_cache_->cache_);
-  MS_ERROR_IF_NULL(embedding_host_cache_);
-  auto host_cache_host_to_device_index = embedding_host_cache_->host_to_device_index.get();
-  auto device_cache_host_to_device_index = embedding_device_cache_->host_to_device_index.get();
-  auto swap_indices_size = statistics_info_.host_to_device_size_;
+  auto host_cache_host_to_device_index = swap_plan.host_.host_to_device_index.get();
+  auto device_cache_host_to_device_index = swap_plan.device_.host_to_device_index.get();
+  auto swap_indices_size = swap_plan.statistics_info_.host_to_device_size_;
   if (swap_indices_size == 0) {
     return true;
   }
@@ -841,13 +927,12 @@ bool PsCacheManager::HashSwapHostToDevice(const HashTableInfo &hash_info) {
   return true;
 }
 
-bool PsCacheManager::HashSwapDeviceToHost(const HashTableInfo &hash_info) {
+bool PsCacheManager::HashSwapDeviceToHost(const HashTableInfo &hash_info, const EmbeddingSwapPlan &swap_plan) {
   MS_ERROR_IF_NULL(embedding_device_cache_);
   MS_ERROR_IF_NULL(embedding_device_cache_->cache_);
-  MS_ERROR_IF_NULL(embedding_host_cache_);
-  auto swap_indices_size = statistics_info_.device_to_host_size_;
-  auto device_cache_device_to_host_index = embedding_device_cache_->device_to_host_index.get();
-  auto host_cache_device_to_host_index = embedding_host_cache_->device_to_host_index.get();
+  auto swap_indices_size = swap_plan.statistics_info_.device_to_host_size_;
+  auto device_cache_device_to_host_index = swap_plan.device_.device_to_host_index.get();
+  auto host_cache_device_to_host_index = swap_plan.host_.device_to_host_index.get();
   if (swap_indices_size == 0) {
     return true;
   }
@@ -871,13 +956,13 @@ bool PsCacheManager::HashSwapDeviceToHost(const HashTableInfo &hash_info) {
   return true;
 }
 
-bool PsCacheManager::HashSwapHostToServer(size_t key, const HashTableInfo &hash_info) {
-  MS_ERROR_IF_NULL(embedding_host_cache_);
-  auto host_to_server_ids = embedding_host_cache_->host_to_server_ids.get();
+bool PsCacheManager::HashSwapHostToServer(size_t key, const HashTableInfo &hash_info,
+                                          const EmbeddingSwapPlan &swap_plan) {
+  auto host_to_server_ids = swap_plan.host_.host_to_server_ids.get();
   MS_ERROR_IF_NULL_W_RET_VAL(host_to_server_ids, false);
-  auto host_to_server_index = embedding_host_cache_->host_to_server_index.get();
+  auto host_to_server_index = swap_plan.host_.host_to_server_index.get();
   MS_ERROR_IF_NULL_W_RET_VAL(host_to_server_index, false);
-  auto swap_indices_size = statistics_info_.host_to_server_size_;
+  auto swap_indices_size = swap_plan.statistics_info_.host_to_server_size_;
   if (swap_indices_size == 0) {
     return true;
   }
@@ -901,33 +986,61 @@ bool PsCacheManager::HashSwapHostToServer(size_t key, const HashTableInfo &hash_
   return true;
 }
 
-bool PsCacheManager::HashSwapServerToHost(size_t key, const HashTableInfo &hash_info) {
-  MS_ERROR_IF_NULL(embedding_host_cache_);
-  auto swap_indices_size = statistics_info_.server_to_host_size_;
-  auto server_to_host_ids = embedding_host_cache_->server_to_host_ids.get();
+bool PsCacheManager::HashSwapServerToHost(size_t key, const HashTableInfo &hash_info,
+                                          EmbeddingSwapPlan *const swap_plan,
+                                          const std::vector<EmbeddingSwapPlanPtr> &prefetch_plans) {
+  MS_ERROR_IF_NULL(swap_plan);
+  auto swap_indices_size = swap_plan->statistics_info_.server_to_host_size_;
+  auto server_to_host_ids = swap_plan->host_.server_to_host_ids.get();
   MS_ERROR_IF_NULL_W_RET_VAL(server_to_host_ids, false);
-  auto server_to_host_index = embedding_host_cache_->server_to_host_index.get();
+  auto server_to_host_index = swap_plan->host_.server_to_host_index.get();
   MS_ERROR_IF_NULL_W_RET_VAL(server_to_host_index, false);
-  if (swap_indices_size == 0) {
-    return true;
-  }
   auto host_hash_table_addr = reinterpret_cast<float *>(hash_info.host_address.get());
   MS_ERROR_IF_NULL_W_RET_VAL(host_hash_table_addr, false);
   auto embedding_size = hash_info.embedding_size;
-  std::vector<float> lookup_result(swap_indices_size * embedding_size, 0);
-  std::vector<int> lookup_ids(swap_indices_size, 0);
-  size_t copy_len = swap_indices_size * sizeof(int);
-  size_t dest_len = copy_len;
-  auto ret = memcpy_s(lookup_ids.data(), dest_len, server_to_host_ids, copy_len);
-  if (ret != EOK) {
-    MS_LOG(ERROR) << "Lookup id memcpy failed.";
-    return false;
+
+  // Look up the ids of this batch and the ids of the prefetched batches from the server at once.
+  std::vector<int> lookup_ids;
+  if (!swap_plan->prefetched_) {
+    lookup_ids.assign(server_to_host_ids, server_to_host_ids + swap_indices_size);
+  }
+  size_t swap_plan_ids_size = lookup_ids.size();
+  for (const auto &prefetch_plan : prefetch_plans) {
+    const int *prefetch_ids = prefetch_plan->host_.server_to_host_ids.get();
+    size_t prefetch_size = prefetch_plan->statistics_info_.server_to_host_size_;
+    lookup_ids.insert(lookup_ids.end(), prefetch_ids, prefetch_ids + prefetch_size);
+  }
+  if (lookup_ids.empty() && !swap_plan->prefetched_) {
+    return true;
+  }
+  std::vector<float> lookup_result(lookup_ids.size() * embedding_size, 0);
+  if (!lookup_ids.empty()) {
+    RETURN_IF_FALSE_WITH_LOG(
+      Worker::GetInstance().DoPSEmbeddingLookup(key, lookup_ids, &lookup_result, mindspore::ps::kEmbeddingLookupCmd),
+      "Embedding lookup from parameter server executed failed.");
+  }
+  auto offset = lookup_result.begin() + SizeToLong(swap_plan_ids_size * embedding_size);
+  for (const auto &prefetch_plan : prefetch_plans) {
+    auto prefetch_len = SizeToLong(prefetch_plan->statistics_info_.server_to_host_size_ * embedding_size);
+    prefetch_plan->prefetched_embeddings_[key].assign(offset, offset + prefetch_len);
+    offset += prefetch_len;
+  }
+
+  if (swap_indices_size == 0) {
+    return true;
+  }
+  const float *swap_in_data = lookup_result.data();
+  if (swap_plan->prefetched_) {
+    const auto &prefetched_embeddings = swap_plan->prefetched_embeddings_[key];
+    if (prefetched_embeddings.size() != swap_indices_size * embedding_size) {
+      MS_LOG(ERROR) << "The size of the prefetched embeddings " << prefetched_embeddings.size()
+                    << " is not equal to the swap size " << (swap_indices_size * embedding_size);
+      return false;
+    }
+    swap_in_data = prefetched_embeddings.data();
   }
-  RETURN_IF_FALSE_WITH_LOG(
-    Worker::GetInstance().DoPSEmbeddingLookup(key, lookup_ids, &lookup_result, mindspore::ps::kEmbeddingLookupCmd),
-    "Embedding lookup from parameter server executed failed.");
   RETURN_IF_FALSE(InsertHostHashTable(embedding_size, IntToSize(swap_indices_size), server_to_host_index,
-                                      lookup_result.data(), host_hash_table_addr));
+                                      swap_in_data, host_hash_table_addr));
   return true;
 }
 
@@ -1083,16 +1196,57 @@ void PsCacheManager::DumpHashTables(bool dump_device_tables) const {
   }
 }
 
+PsCacheStatisticsInfo PsCacheManager::statistics_info() {
+  std::unique_lock<std::mutex> locker(statistics_mutex_);
+  return last_statistics_info_;
+}
+
+PsCacheStatisticsInfo PsCacheManager::total_statistics_info() {
+  std::unique_lock<std::mutex> locker(statistics_mutex_);
+  return total_statistics_info_;
+}
+
+void PsCacheManager::UpdateStatisticsInfo() {
+  statistics_info_.batch_id_unique_count_ = statistics_info_.hash_hit_count_ + statistics_info_.host_to_device_size_;
+  if (statistics_info_.batch_id_unique_count_ != 0) {
+    statistics_info_.device_hit_rate_ =
+      SizeToFloat(statistics_info_.hash_hit_count_) / statistics_info_.batch_id_unique_count_;
+    statistics_info_.host_hit_rate_ =
+      SizeToFloat(statistics_info_.batch_id_unique_count_ - statistics_info_.server_to_host_size_) /
+      statistics_info_.batch_id_unique_count_;
+  }
+
+  std::unique_lock<std::mutex> locker(statistics_mutex_);
+  last_statistics_info_ = statistics_info_;
+  total_statistics_info_.batch_id_count_ += statistics_info_.batch_id_count_;
+  total_statistics_info_.batch_id_unique_count_ += statistics_info_.batch_id_unique_count_;
+  total_statistics_info_.device_to_host_size_ += statistics_info_.device_to_host_size_;
+  total_statistics_info_.host_to_device_size_ += statistics_info_.host_to_device_size_;
+  total_statistics_info_.host_to_server_size_ += statistics_info_.host_to_server_size_;
+  total_statistics_info_.server_to_host_size_ += statistics_info_.server_to_host_size_;
+  total_statistics_info_.hash_hit_count_ += statistics_info_.hash_hit_count_;
+  if (total_statistics_info_.batch_id_unique_count_ != 0) {
+    total_statistics_info_.device_hit_rate_ =
+      SizeToFloat(total_statistics_info_.hash_hit_count_) / total_statistics_info_.batch_id_unique_count_;
+    total_statistics_info_.host_hit_rate_ =
+      SizeToFloat(total_statistics_info_.batch_id_unique_count_ - total_statistics_info_.server_to_host_size_) /
+      total_statistics_info_.batch_id_unique_count_;
+  }
+}
+
 void PsCacheManager::DumpStatisticsInfo(size_t each_print_step) {
-  // Default each 1000 step prints ps cache hit rate.
   const size_t kFloatToPercentSign = 100;
+  MS_LOG(DEBUG) << "PS embedding cache step " << data_step_
+                << " statistics info(host swap to device num:" << statistics_info_.host_to_device_size_
+                << ", device swap to host num:" << statistics_info_.device_to_host_size_
+                << ", host swap to server num:" << statistics_info_.host_to_server_size_
+                << ", server swap to host num:" << statistics_info_.server_to_host_size_
+                << ", device cache hit rate:" << (statistics_info_.device_hit_rate_ * kFloatToPercentSign)
+                << "%, host cache hit rate:" << (statistics_info_.host_hit_rate_ * kFloatToPercentSign) << "%).";
+  // Default each 1000 step prints ps cache hit rate.
   if (data_step_ % each_print_step == 0) {
-    statistics_info_.batch_id_unique_count_ = statistics_info_.hash_hit_count_ + statistics_info_.host_to_device_size_;
     auto repeat_rate = SizeToFloat(statistics_info_.batch_id_count_ - statistics_info_.batch_id_unique_count_) /
                        statistics_info_.batch_id_count_;
-    auto device_hit_rate = SizeToFloat(statistics_info_.hash_hit_count_) / statistics_info_.batch_id_unique_count_;
-    auto host_hit_rate = SizeToFloat(statistics_info_.batch_id_unique_count_ - statistics_info_.server_to_host_size_) /
-                         statistics_info_.batch_id_unique_count_;
     MS_LOG(INFO) << "PS embedding cache data statistics info(total id num:" << statistics_info_.batch_id_count_
                  << ", unique id num:" << statistics_info_.batch_id_unique_count_
                  << ", host swap to device num:" << statistics_info_.host_to_device_size_
@@ -1100,8 +1254,11 @@ void PsCacheManager::DumpStatisticsInfo(size_t each_print_step) {
                  << ", host swap to server num:" << statistics_info_.host_to_server_size_
                  << ", server swap to host num:" << statistics_info_.server_to_host_size_
                  << ", data repeat rate:" << (repeat_rate * kFloatToPercentSign)
-                 << "%, device cache hit rate:" << (device_hit_rate * kFloatToPercentSign)
-                 << "%, host cache hit rate:" << (host_hit_rate * kFloatToPercentSign) << ").";
+                 << "%, device cache hit rate:" << (statistics_info_.device_hit_rate_ * kFloatToPercentSign)
+                 << "%, host cache hit rate:" << (statistics_info_.host_hit_rate_ * kFloatToPercentSign)
+                 << "%, total device cache hit rate:" << (total_statistics_info_.device_hit_rate_ * kFloatToPercentSign)
+                 << "%, total host cache hit rate:" << (total_statistics_info_.host_hit_rate_ * kFloatToPercentSign)
+                 << "%).";
   }
 }
 }  // namespace ps
@@ -34,6 +34,8 @@
 #include "ps/ps_context.h"
 #include "ps/ps_cache/ps_data/ps_data_prefetch.h"
 #include "ps/ps_cache/embedding_hash_map.h"
+#include "ps/ps_cache/embedding_swap_plan.h"
+#include "utils/frequency_sketch.h"
 #include "ps/ps_cache/ps_cache_factory.h"
 
 namespace mindspore {
@@ -41,6 +43,11 @@ namespace ps {
 constexpr size_t kHostCacheScaleFactor = 10;
 constexpr size_t kMaxThreadNum = 16;
 constexpr size_t kMaxIdsPerThread = 10000;
+// The max number of the batches which are parsed but not swapped yet, the parsing runs ahead of the swapping by them.
+constexpr size_t kMaxSwapPlanNum = 4;
+// The eviction policy of the embedding cache which swaps out the first expired id, the TinyLFU policy is used if the
+// env MS_DEV_PS_CACHE_EVICTION_POLICY is not set to it.
+constexpr char kCacheEvictionPolicyStep[] = "step";
 using mindspore::kernel::Address;
 
 struct HashTableInfo {
@@ -58,22 +65,14 @@ struct HashTableInfo {
 };
 
 struct EmbeddingDeviceCache {
-  EmbeddingDeviceCache(size_t batch_elements, size_t cache_vocab_size)
+  explicit EmbeddingDeviceCache(size_t cache_vocab_size)
       : hash_swap_index_addr_(nullptr), hash_swap_value_addr_(nullptr) {
-    device_to_host_index = std::make_unique<int[]>(batch_elements);
-    device_to_host_ids = std::make_unique<int[]>(batch_elements);
-    host_to_device_index = std::make_unique<int[]>(batch_elements);
-    host_to_device_ids = std::make_unique<int[]>(batch_elements);
     device_hash_map_ = std::make_shared<EmbeddingHashMap>(0, cache_vocab_size);
     auto context_ptr = MsContext::GetInstance();
     MS_EXCEPTION_IF_NULL(context_ptr);
     auto devcie_target = context_ptr->get_param<std::string>(MS_CTX_DEVICE_TARGET);
     cache_ = PsCacheFactory::Get().ps_cache(devcie_target);
   }
-  std::unique_ptr<int[]> device_to_host_index;
-  std::unique_ptr<int[]> device_to_host_ids;
-  std::unique_ptr<int[]> host_to_device_index;
-  std::unique_ptr<int[]> host_to_device_ids;
   int *hash_swap_index_addr_;
   float *hash_swap_value_addr_;
   std::shared_ptr<EmbeddingHashMap> device_hash_map_;
@@ -81,37 +80,12 @@ struct EmbeddingDeviceCache {
 };
 
 struct EmbeddingHostCache {
-  EmbeddingHostCache(size_t batch_elements, size_t host_cache_vocab_size) {
-    host_to_server_index = std::make_unique<int[]>(batch_elements);
-    host_to_server_ids = std::make_unique<int[]>(batch_elements);
-    server_to_host_index = std::make_unique<int[]>(batch_elements);
-    server_to_host_ids = std::make_unique<int[]>(batch_elements);
-    host_to_device_index = std::make_unique<int[]>(batch_elements);
-    device_to_host_index = std::make_unique<int[]>(batch_elements);
+  explicit EmbeddingHostCache(size_t host_cache_vocab_size) {
     host_hash_map_ = std::make_shared<EmbeddingHashMap>(0, host_cache_vocab_size);
   }
-  std::unique_ptr<int[]> host_to_server_index;
-  std::unique_ptr<int[]> host_to_server_ids;
-  std::unique_ptr<int[]> server_to_host_index;
-  std::unique_ptr<int[]> server_to_host_ids;
-  std::unique_ptr<int[]> host_to_device_index;
-  std::unique_ptr<int[]> device_to_host_index;
   std::shared_ptr<EmbeddingHashMap> host_hash_map_;
 };
 
-struct PsCacheStatisticsInfo {
-  size_t batch_id_count_{0};
-  size_t batch_id_unique_count_{0};
-  size_t device_to_host_size_{0};
-  size_t host_to_device_size_{0};
-  size_t host_to_server_size_{0};
-  size_t server_to_host_size_{0};
-  size_t hash_hit_count_{0};
-  size_t mem_cache_swap_out_size_{0};
-  size_t mem_cache_swap_in_size_{0};
-  size_t mem_cache_hit_count_{0};
-};
-
 class PsCacheManager {
  public:
   static PsCacheManager &GetInstance() {
@@ -139,6 +113,10 @@ class PsCacheManager {
   void SyncEmbeddingTable();
   void Finalize();
   void DumpHashTables(bool dump_device_tables = false) const;
+  // The statistics info of the last processed step, such as the swap in/out sizes and the cache hit rates.
+  PsCacheStatisticsInfo statistics_info();
+  // The statistics info accumulated by all the processed steps.
+  PsCacheStatisticsInfo total_statistics_info();
 
  private:
   PsCacheManager() = default;
@@ -154,18 +132,22 @@ class PsCacheManager {
   void AllocMemForHashTable();
   void SetLocalIdRank();
   void ProcessDataTask(uint32_t device_id, const void *context);
+  void ParseDataTask();
   bool ProcessData();
   bool ParseData(const int *batch_ids, const size_t batch_ids_len, int *hash_index);
   bool WaitGraphRun();
+  bool WaitGraphStep(size_t graph_step);
+  bool SwapData();
   bool ParseDeviceData(size_t id, bool *need_swap_device_to_host, bool *need_swap_host_to_device, int *hash_index);
   bool ParseHostDataHostToDevice(size_t id);
   bool ParseHostDataDeviceToHost();
   bool HashSwapDeviceOut(int *swap_out_index, std::vector<float> *swap_out_data, const HashTableInfo &hash_info);
   bool HashSwapDeviceIn(const int *swap_in_ids, const int *swap_in_index, const HashTableInfo &hash_info, size_t key);
-  bool HashSwapHostToDevice(const HashTableInfo &hash_info);
-  bool HashSwapDeviceToHost(const HashTableInfo &hash_info);
-  bool HashSwapHostToServer(size_t key, const HashTableInfo &hash_info);
-  bool HashSwapServerToHost(size_t key, const HashTableInfo &hash_info);
+  bool HashSwapHostToDevice(const HashTableInfo &hash_info, const EmbeddingSwapPlan &swap_plan);
+  bool HashSwapDeviceToHost(const HashTableInfo &hash_info, const EmbeddingSwapPlan &swap_plan);
+  bool HashSwapHostToServer(size_t key, const HashTableInfo &hash_info, const EmbeddingSwapPlan &swap_plan);
+  bool HashSwapServerToHost(size_t key, const HashTableInfo &hash_info, EmbeddingSwapPlan *const swap_plan,
+                            const std::vector<EmbeddingSwapPlanPtr> &prefetch_plans);
   bool InsertHostHashTable(size_t embedding_size, size_t insert_indices_size, const int *insert_indices,
                            const float *insert_data, float *hash_table_addr);
   bool LookUpHostHashTable(size_t embedding_size, size_t indices_lens, const float *hash_table_addr,
@@ -175,6 +157,7 @@ class PsCacheManager {
                        const int *indices_addr, float *output_addr);
   bool CheckFinishInsertInitInfo() const;
   void AddEmbeddingTable() const;
+  void UpdateStatisticsInfo();
   void DumpStatisticsInfo(size_t each_print_step = 1000);
   bool SyncHostEmbeddingTable();
   bool SyncDeviceEmbeddingTable();
@@ -194,6 +177,12 @@ class PsCacheManager {
   std::condition_variable data_prase_;
   std::condition_variable insert_init_info_;
   std::thread process_data_thread_;
+  std::thread parse_data_thread_;
+
+  // The swap plans which are free and the ones which are parsed but not swapped.
+  std::unique_ptr<EmbeddingSwapPlanQueue> swap_plans_{nullptr};
+  // The swap plan of the batch being parsed.
+  EmbeddingSwapPlanPtr swap_plan_{nullptr};
 
   std::map<std::string, HashTableInfo> hash_tables_;
   std::shared_ptr<EmbeddingDeviceCache> embedding_device_cache_;
@@ -204,6 +193,12 @@ class PsCacheManager {
   size_t host_vocab_cache_size_{0};
   size_t batch_elements_{0};
   PsCacheStatisticsInfo statistics_info_;
+  // The statistics info exported to the other threads, which is updated when the step is processed.
+  PsCacheStatisticsInfo last_statistics_info_;
+  PsCacheStatisticsInfo total_statistics_info_;
+  std::mutex statistics_mutex_;
+  // The access frequency of the ids, which is shared by the device and host hash maps to choose the ids swapped out.
+  std::shared_ptr<FrequencySketch> frequency_sketch_{nullptr};
   std::pair<int, int> emb_table_slice_bounds_;
   std::pair<int, int> cache_indices_bounds_;
   int vocab_cache_size_diff_{0};
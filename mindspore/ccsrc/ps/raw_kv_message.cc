@@ -0,0 +1,134 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/raw_kv_message.h"
+#include <algorithm>
+#include "securec/include/securec.h"
+#include "utils/convert_utils_base.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace ps {
+namespace {
+bool CopyBytes(uint8_t *dst, const void *src, size_t size) {
+  // The memcpy_s copies SECUREC_MEM_MAX_LEN bytes at most once.
+  size_t offset = 0;
+  while (offset < size) {
+    size_t copy_size = std::min(size - offset, static_cast<size_t>(SECUREC_MEM_MAX_LEN));
+    auto ret = memcpy_s(dst + offset, copy_size, static_cast<const uint8_t *>(src) + offset, copy_size);
+    if (ret != EOK) {
+      MS_LOG(ERROR) << "The memcpy_s error, errorno(" << ret << ")";
+      return false;
+    }
+    offset += copy_size;
+  }
+  return true;
+}
+
+bool WriteHeader(size_t key_num, size_t len_num, size_t value_num, void *data, size_t size) {
+  if (data == nullptr || size != RawKVSize(key_num, len_num, value_num)) {
+    MS_LOG(ERROR) << "The size " << size << " of the raw kv message is wrong.";
+    return false;
+  }
+  if (key_num > UINT32_MAX || len_num > UINT32_MAX || value_num > UINT32_MAX) {
+    MS_LOG(ERROR) << "The raw kv message is too large, value num: " << value_num;
+    return false;
+  }
+  auto header = static_cast<RawKVHeader *>(data);
+  header->magic = kRawKVMagic;
+  header->key_num = static_cast<uint32_t>(key_num);
+  header->len_num = static_cast<uint32_t>(len_num);
+  header->value_num = static_cast<uint32_t>(value_num);
+  return true;
+}
+}  // namespace
+
+size_t RawKVSize(size_t key_num, size_t len_num, size_t value_num) {
+  return sizeof(RawKVHeader) + key_num * sizeof(uint64_t) + len_num * sizeof(int32_t) + value_num * sizeof(float);
+}
+
+bool SerializeRawKV(const RawKVMessage &message, void *data, size_t size) {
+  if (!WriteHeader(message.key_num, message.len_num, message.value_num, data, size)) {
+    return false;
+  }
+  auto dst = static_cast<uint8_t *>(data) + sizeof(RawKVHeader);
+  if (message.key_num > 0 && !CopyBytes(dst, message.keys, message.key_num * sizeof(uint64_t))) {
+    return false;
+  }
+  dst += message.key_num * sizeof(uint64_t);
+  if (message.len_num > 0 && !CopyBytes(dst, message.lens, message.len_num * sizeof(int32_t))) {
+    return false;
+  }
+  dst += message.len_num * sizeof(int32_t);
+  return message.value_num == 0 || CopyBytes(dst, message.values, message.value_num * sizeof(float));
+}
+
+bool SerializeRawKV(const KVMessage &message, void *data, size_t size) {
+  if (!WriteHeader(IntToSize(message.keys_size()), IntToSize(message.len_size()), IntToSize(message.values_size()),
+                   data, size)) {
+    return false;
+  }
+  auto dst = static_cast<uint8_t *>(data) + sizeof(RawKVHeader);
+  size_t keys_size = IntToSize(message.keys_size()) * sizeof(uint64_t);
+  if (keys_size > 0 && !CopyBytes(dst, message.keys().data(), keys_size)) {
+    return false;
+  }
+  dst += keys_size;
+  // The lengths are few, and they are narrowed to the Lengths of the server.
+  auto lens = reinterpret_cast<int32_t *>(dst);
+  for (int i = 0; i < message.len_size(); ++i) {
+    lens[i] = static_cast<int32_t>(message.len(i));
+  }
+  dst += IntToSize(message.len_size()) * sizeof(int32_t);
+  size_t values_size = IntToSize(message.values_size()) * sizeof(float);
+  return values_size == 0 || CopyBytes(dst, message.values().data(), values_size);
+}
+
+bool IsRawKV(const void *data, size_t size) {
+  if (data == nullptr || size < sizeof(RawKVHeader)) {
+    return false;
+  }
+  return static_cast<const RawKVHeader *>(data)->magic == kRawKVMagic;
+}
+
+bool ParseRawKV(const void *data, size_t size, RawKVMessage *message) {
+  MS_EXCEPTION_IF_NULL(message);
+  if (!IsRawKV(data, size)) {
+    return false;
+  }
+  // The keys are read in place, so the buffer should be aligned as the buffers of new are.
+  if (reinterpret_cast<uintptr_t>(data) % alignof(uint64_t) != 0) {
+    MS_LOG(ERROR) << "The buffer of the raw kv message is not aligned.";
+    return false;
+  }
+  auto header = static_cast<const RawKVHeader *>(data);
+  if (size != RawKVSize(header->key_num, header->len_num, header->value_num)) {
+    MS_LOG(ERROR) << "The size " << size << " of the raw kv message doesn't match its header.";
+    return false;
+  }
+  auto src = static_cast<const uint8_t *>(data) + sizeof(RawKVHeader);
+  message->key_num = header->key_num;
+  message->keys = reinterpret_cast<const uint64_t *>(src);
+  src += message->key_num * sizeof(uint64_t);
+  message->len_num = header->len_num;
+  message->lens = reinterpret_cast<const int32_t *>(src);
+  src += message->len_num * sizeof(int32_t);
+  message->value_num = header->value_num;
+  message->values = reinterpret_cast<const float *>(src);
+  return true;
+}
+}  // namespace ps
+}  // namespace mindspore
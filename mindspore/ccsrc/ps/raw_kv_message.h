@@ -0,0 +1,62 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PS_RAW_KV_MESSAGE_H_
+#define MINDSPORE_CCSRC_PS_RAW_KV_MESSAGE_H_
+
+#include <cstdint>
+
+#include "ps/constants.h"
+#include "proto/ps.pb.h"
+
+namespace mindspore {
+namespace ps {
+// The flat layout of the KVMessage of the push and pull, in which the values are read in the message buffer without
+// parsing or copy:
+//   RawKVHeader | keys (uint64) | lens (int32) | values (float)
+// The message with the compressed gradient is still encoded by protobuf, whose first byte never equals the magic's.
+constexpr uint32_t kRawKVMagic = 0x564B5352;
+
+struct RawKVHeader {
+  uint32_t magic;
+  uint32_t key_num;
+  uint32_t len_num;
+  uint32_t value_num;
+};
+
+// The message referring to the buffer of the layout.
+struct RawKVMessage {
+  const uint64_t *keys{nullptr};
+  size_t key_num{0};
+  const int32_t *lens{nullptr};
+  size_t len_num{0};
+  const float *values{nullptr};
+  size_t value_num{0};
+};
+
+size_t RawKVSize(size_t key_num, size_t len_num, size_t value_num);
+
+// Write the layout to the data, whose size should be the RawKVSize of the message.
+bool SerializeRawKV(const RawKVMessage &message, void *data, size_t size);
+bool SerializeRawKV(const KVMessage &message, void *data, size_t size);
+
+bool IsRawKV(const void *data, size_t size);
+
+// Parse the layout of the data, the message refers to the data which should be kept until the message is used.
+bool ParseRawKV(const void *data, size_t size, RawKVMessage *message);
+}  // namespace ps
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PS_RAW_KV_MESSAGE_H_
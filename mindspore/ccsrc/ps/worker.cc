@@ -15,6 +15,7 @@
  */
 
 #include "ps/worker.h"
+#include "ps/raw_kv_message.h"
 #include "pipeline/jit/pipeline.h"
 
 namespace mindspore {
@@ -307,20 +308,19 @@ bool Worker::DoPSEmbeddingLookup(const Key &key, const std::vector<int> &lookup_
   for (size_t i = 0; i < messages.size(); i++) {
     if (messages.at(i).first) {
       rank_ids.push_back(i);
-      std::string kv_data = messages.at(i).second.SerializeAsString();
+      // Serialize the message into the buffer sent without copy.
+      size_t kv_size = messages.at(i).second.ByteSizeLong();
 #ifdef __APPLE__
-      std::shared_ptr<unsigned char> res(new unsigned char[kv_data.length()], std::default_delete<unsigned char[]>());
+      std::shared_ptr<unsigned char> res(new unsigned char[kv_size], std::default_delete<unsigned char[]>());
 #else
-      std::shared_ptr<unsigned char[]> res(new unsigned char[kv_data.length()]);
+      std::shared_ptr<unsigned char[]> res(new unsigned char[kv_size]);
 #endif
-      size_t dest_size = kv_data.length();
-      int ret = memcpy_s(res.get(), dest_size, kv_data.data(), kv_data.length());
-      if (ret != 0) {
-        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+      if (!messages.at(i).second.SerializeToArray(res.get(), SizeToInt(kv_size))) {
+        MS_LOG(ERROR) << "Serialize the kv message failed.";
         return false;
       }
       data.push_back(res);
-      sizes.push_back(kv_data.length());
+      sizes.push_back(kv_size);
     }
   }
 
@@ -403,21 +403,19 @@ bool Worker::UpdateEmbeddingTable(const std::vector<Key> &keys, const std::vecto
   for (size_t i = 0; i < messages.size(); i++) {
     if (messages.at(i).first) {
       rank_ids.push_back(i);
-      std::string kv_data = messages.at(i).second.SerializeAsString();
-
+      // Serialize the message into the buffer sent without copy.
+      size_t kv_size = messages.at(i).second.ByteSizeLong();
 #ifdef __APPLE__
-      std::shared_ptr<unsigned char> res(new unsigned char[kv_data.length()], std::default_delete<unsigned char[]>());
+      std::shared_ptr<unsigned char> res(new unsigned char[kv_size], std::default_delete<unsigned char[]>());
 #else
-      std::shared_ptr<unsigned char[]> res(new unsigned char[kv_data.length()]);
+      std::shared_ptr<unsigned char[]> res(new unsigned char[kv_size]);
 #endif
-      size_t dest_size = kv_data.length();
-      int ret = memcpy_s(res.get(), dest_size, kv_data.data(), kv_data.length());
-      if (ret != 0) {
-        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+      if (!messages.at(i).second.SerializeToArray(res.get(), SizeToInt(kv_size))) {
+        MS_LOG(ERROR) << "Serialize the kv message failed.";
         return false;
       }
       data.push_back(res);
-      sizes.push_back(kv_data.length());
+      sizes.push_back(kv_size);
     }
   }
 
@@ -993,26 +991,95 @@ void Worker::SendForPush(int cmd, const KVMessage &send, const KVPartitioner &pa
   for (size_t i = 0; i < messages.size(); i++) {
     if (messages.at(i).first) {
       rank_ids.push_back(i);
-      std::string kv_data = messages.at(i).second.SerializeAsString();
-
-#ifdef __APPLE__
-      std::shared_ptr<unsigned char> res(new unsigned char[kv_data.length()], std::default_delete<unsigned char[]>());
-#else
-      std::shared_ptr<unsigned char[]> res(new unsigned char[kv_data.length()]);
-#endif
-      size_t dest_size = kv_data.length();
-      int ret = memcpy_s(res.get(), dest_size, kv_data.data(), kv_data.length());
-      if (ret != 0) {
-        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+      if (cmd == kPushCmd) {
+        CompressGrad(&messages.at(i).second);
+      }
+      // The compressed gradients are decoded by the server from the protobuf message.
+      bool is_raw = cmd == kPushCmd && !messages.at(i).second.has_compressed_grad();
+      size_t kv_size = 0;
+      auto res = SerializeKVMessage(messages.at(i).second, is_raw, &kv_size);
+      if (res == nullptr) {
         return;
       }
       data.push_back(res);
-      sizes.push_back(kv_data.length());
+      sizes.push_back(kv_size);
     }
   }
   worker_node_.Send(core::NodeRole::SERVER, rank_ids, data, sizes, cmd);
 }
 
+void Worker::CompressGrad(KVMessage *message) {
+  MS_EXCEPTION_IF_NULL(message);
+  // The sparse message without the gradient of the server has no lengths.
+  if (message->keys_size() == 0 || message->len_size() == 0 || key_to_optimId_.count(message->keys(0)) == 0) {
+    return;
+  }
+  Key key = message->keys(0);
+  std::string optim_name = Util::optimizer_name(key_to_optimId_[key]);
+  if (kOptimToPSSendIdx.count(optim_name) == 0) {
+    return;
+  }
+  const OptimPSSendIdx &send_index = kOptimToPSSendIdx.at(optim_name);
+  bool is_sparse = send_index.count("indices") > 0;
+  auto compressor = GetGradCompressor(key, is_sparse);
+  if (compressor == nullptr) {
+    return;
+  }
+  // The rows of the sparse gradient change every push, so the error can't be fed back to them.
+  if (compressor->CompressMessage(send_index.at("grad"), !is_sparse, message)) {
+    MS_LOG(DEBUG) << "The gradients of key " << key << " are compressed from " << compressor->raw_bytes() << " to "
+                  << compressor->compressed_bytes() << " bytes in total.";
+  }
+}
+
+std::shared_ptr<GradientCompressor> Worker::GetGradCompressor(const Key &key, bool is_sparse) {
+  std::lock_guard<std::mutex> lock(grad_compressors_mutex_);
+  auto iter = grad_compressors_.find(key);
+  if (iter != grad_compressors_.end()) {
+    return iter->second;
+  }
+  std::string param_name;
+  for (const auto &item : param_to_key_) {
+    if (item.second == key) {
+      param_name = item.first;
+      break;
+    }
+  }
+  GradCompressConfig config = GetGradCompressConfig(param_name);
+  if (is_sparse && (config.type == GradCompressType::kTopK || config.type == GradCompressType::kOneBit)) {
+    MS_LOG(WARNING) << "The biased compression " << static_cast<int32_t>(config.type) << " of the sparse parameter "
+                    << param_name << " is not supported without the error feedback, the gradient is not compressed.";
+    config.type = GradCompressType::kNone;
+  }
+  std::shared_ptr<GradientCompressor> compressor = nullptr;
+  if (config.type != GradCompressType::kNone) {
+    MS_LOG(INFO) << "The gradient of parameter " << param_name << " is compressed by type "
+                 << static_cast<int32_t>(config.type);
+    compressor = std::make_shared<GradientCompressor>(config);
+  }
+  grad_compressors_[key] = compressor;
+  return compressor;
+}
+
+DataPtr Worker::SerializeKVMessage(const KVMessage &message, bool is_raw, size_t *size) {
+  MS_EXCEPTION_IF_NULL(size);
+  // Serialize the message into the buffer sent without copy.
+  *size = is_raw ? RawKVSize(IntToSize(message.keys_size()), IntToSize(message.len_size()),
+                             IntToSize(message.values_size()))
+                 : message.ByteSizeLong();
+#ifdef __APPLE__
+  std::shared_ptr<unsigned char> res(new unsigned char[*size], std::default_delete<unsigned char[]>());
+#else
+  std::shared_ptr<unsigned char[]> res(new unsigned char[*size]);
+#endif
+  bool ret = is_raw ? SerializeRawKV(message, res.get(), *size) : message.SerializeToArray(res.get(), SizeToInt(*size));
+  if (!ret) {
+    MS_LOG(ERROR) << "Serialize the kv message failed.";
+    return nullptr;
+  }
+  return res;
+}
+
 void Worker::SendForPull(int cmd, const KVMessage &send, const KVPartitioner &partitioner,
                          const std::map<int64_t, int64_t> &, std::vector<float> *vals, std::vector<int> *lens) {
   MS_EXCEPTION_IF_NULL(vals);
@@ -1024,27 +1091,32 @@ void Worker::SendForPull(int cmd, const KVMessage &send, const KVPartitioner &pa
   for (size_t i = 0; i < messages.size(); i++) {
     if (messages.at(i).first) {
       rank_ids.push_back(i);
-      std::string kv_data = messages.at(i).second.SerializeAsString();
-
-#ifdef __APPLE__
-      std::shared_ptr<unsigned char> res(new unsigned char[kv_data.length()], std::default_delete<unsigned char[]>());
-#else
-      std::shared_ptr<unsigned char[]> res(new unsigned char[kv_data.length()]);
-#endif
-      size_t dest_size = kv_data.length();
-      int ret = memcpy_s(res.get(), dest_size, kv_data.data(), kv_data.length());
-      if (ret != 0) {
-        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+      size_t kv_size = 0;
+      auto res = SerializeKVMessage(messages.at(i).second, cmd == kPullCmd, &kv_size);
+      if (res == nullptr) {
         return;
       }
       data.push_back(res);
-      sizes.push_back(kv_data.length());
+      sizes.push_back(kv_size);
     }
   }
   std::vector<VectorPtr> resp;
   worker_node_.Send(core::NodeRole::SERVER, rank_ids, data, sizes, cmd, &resp);
   vals->clear();
   for (size_t i = 0; i < resp.size(); ++i) {
+    MS_EXCEPTION_IF_NULL(resp.at(i));
+    // The values of the raw response are appended from the response buffer without parsing.
+    RawKVMessage raw_message;
+    if (IsRawKV(resp.at(i)->data(), resp.at(i)->size())) {
+      if (!ParseRawKV(resp.at(i)->data(), resp.at(i)->size(), &raw_message)) {
+        MS_LOG(EXCEPTION) << "Parse the raw kv message of command " << cmd << " failed.";
+      }
+      (void)vals->insert(vals->end(), raw_message.values, raw_message.values + raw_message.value_num);
+      if (lens) {
+        lens->assign(raw_message.lens, raw_message.lens + raw_message.len_num);
+      }
+      continue;
+    }
     KVMessage message;
     CHECK_RETURN_TYPE(message.ParseFromArray(resp.at(i)->data(), SizeToInt(resp.at(i)->size())));
     std::copy(message.values().begin(), message.values().end(), std::back_inserter(*vals));
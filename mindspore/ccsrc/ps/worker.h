@@ -37,6 +37,7 @@
 #include "ps/ps_cache/ps_data/ps_data_prefetch.h"
 #include "ps/core/worker_node.h"
 #include "ps/embedding_table_shard_metadata.h"
+#include "ps/gradient_compressor.h"
 #include "proto/comm.pb.h"
 #include "proto/ps.pb.h"
 #include "ps/ps_context.h"
@@ -123,6 +124,11 @@ class Worker {
                             const std::map<int64_t, int64_t> &attrs);
   void SendForPush(int cmd, const KVMessage &send, const KVPartitioner &partitioner,
                    const std::map<int64_t, int64_t> &attrs);
+  // Compress the gradient of the pushed message with the compressor configured for its parameter.
+  void CompressGrad(KVMessage *message);
+  std::shared_ptr<GradientCompressor> GetGradCompressor(const Key &key, bool is_sparse);
+  // Serialize the message in the raw kv layout, whose values the server reads in place, or by protobuf.
+  DataPtr SerializeKVMessage(const KVMessage &message, bool is_raw, size_t *size);
   void SendForPull(int cmd, const KVMessage &send, const KVPartitioner &partitioner,
                    const std::map<int64_t, int64_t> &attrs, std::vector<float> *vals, std::vector<int> *lens);
 
@@ -147,6 +153,10 @@ class Worker {
   mindspore::HashMap<Key, size_t> embedding_row_cnt_;
 
   mindspore::HashMap<Key, std::shared_ptr<std::vector<EmbeddingTableShardMetadata>>> embedding_table_ranges_;
+
+  // The gradient compressors of the keys, whose value is nullptr if the gradient is not compressed.
+  std::map<Key, std::shared_ptr<GradientCompressor>> grad_compressors_;
+  std::mutex grad_compressors_mutex_;
 };
 }  // namespace ps
 }  // namespace mindspore
@@ -0,0 +1,264 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/device/cpu/cpu_mem_handler.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include "securec/include/securec.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+namespace {
+// The size of every mapped host segment, the larger memory is mapped as one segment.
+constexpr size_t kHostSegmentSize = 1UL << 30;
+constexpr char kOffloadFileTemplate[] = "/ms_mem_offload_XXXXXX";
+
+size_t GetPageSize() {
+  static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return page_size;
+}
+
+size_t AlignPageSize(size_t size) {
+  const size_t page_size = GetPageSize();
+  return (size + page_size - 1) / page_size * page_size;
+}
+
+void CopyMemory(void *dst, const void *src, size_t size) {
+  MS_EXCEPTION_IF_NULL(dst);
+  MS_EXCEPTION_IF_NULL(src);
+  // The memcpy_s copies SECUREC_MEM_MAX_LEN bytes at most once.
+  size_t offset = 0;
+  while (offset < size) {
+    size_t copy_size = std::min(size - offset, static_cast<size_t>(SECUREC_MEM_MAX_LEN));
+    auto ret = memcpy_s(static_cast<uint8_t *>(dst) + offset, copy_size, static_cast<const uint8_t *>(src) + offset,
+                        copy_size);
+    if (ret != EOK) {
+      MS_LOG(EXCEPTION) << "Copy memory failed, size: " << copy_size << ", error no: " << ret;
+    }
+    offset += copy_size;
+  }
+}
+}  // namespace
+
+CPUMemHandler::CPUMemHandler(const std::shared_ptr<MemoryManager> &mem_manager, const std::string &offload_path,
+                             size_t mem_size)
+    : mem_manager_(mem_manager), offload_path_(offload_path), mem_size_(mem_size) {
+  MS_LOG(INFO) << "The host memory of offload is mapped in the path: "
+               << (offload_path_.empty() ? "anonymous" : offload_path_) << ", memory budget: " << mem_size_;
+}
+
+CPUMemHandler::~CPUMemHandler() { UnmapSegments(); }
+
+size_t CPUMemHandler::GetAvailableMemSize() {
+  if (mem_size_ != 0) {
+    return mem_size_;
+  }
+  auto available_pages = sysconf(_SC_AVPHYS_PAGES);
+  if (available_pages <= 0) {
+    MS_LOG(WARNING) << "Get the available physical memory failed.";
+    return 0;
+  }
+  return static_cast<size_t>(available_pages) * GetPageSize();
+}
+
+void *CPUMemHandler::MallocDevice(size_t mem_size) {
+  MS_EXCEPTION_IF_NULL(mem_manager_);
+  // The memory pool grows beyond the budget, so the budget is checked here to make the MemScheduler swap.
+  if (mem_size_ != 0 && device_mem_used_ + mem_size > mem_size_) {
+    return nullptr;
+  }
+  auto ptr = mem_manager_->MallocMemFromMemPool(mem_size, false);
+  if (ptr != nullptr) {
+    device_mem_size_[ptr] = mem_size;
+    device_mem_used_ += mem_size;
+  }
+  return ptr;
+}
+
+void CPUMemHandler::FreeDevice(void *ptr) {
+  MS_EXCEPTION_IF_NULL(mem_manager_);
+  MS_EXCEPTION_IF_NULL(ptr);
+  const auto &iter = device_mem_size_.find(ptr);
+  if (iter != device_mem_size_.end()) {
+    device_mem_used_ -= iter->second;
+    (void)device_mem_size_.erase(iter);
+  }
+  mem_manager_->FreeMemFromMemPool(ptr);
+}
+
+void *CPUMemHandler::MallocHost(size_t mem_size) {
+  const size_t align_size = AlignPageSize(std::max(mem_size, static_cast<size_t>(1)));
+  auto size_iter = free_block_sizes_.lower_bound(std::make_pair(align_size, static_cast<uint8_t *>(nullptr)));
+  if (size_iter == free_block_sizes_.end()) {
+    if (!MapSegment(align_size)) {
+      MS_LOG(EXCEPTION) << "Malloc host memory of offload failed, size: " << mem_size;
+    }
+    size_iter = free_block_sizes_.lower_bound(std::make_pair(align_size, static_cast<uint8_t *>(nullptr)));
+    if (size_iter == free_block_sizes_.end()) {
+      MS_LOG(EXCEPTION) << "The mapped host segment is smaller than the size: " << align_size;
+    }
+  }
+  auto ptr = size_iter->second;
+  auto block_iter = free_blocks_.find(ptr);
+  if (block_iter == free_blocks_.end()) {
+    MS_LOG(EXCEPTION) << "The free host block " << static_cast<void *>(ptr) << " is lost.";
+  }
+  const auto block = block_iter->second;
+  EraseFreeBlock(block_iter);
+  if (block.size > align_size) {
+    InsertFreeBlock(ptr + align_size, {block.size - align_size, block.segment_index});
+  }
+  host_blocks_[ptr] = {align_size, block.segment_index};
+  return ptr;
+}
+
+void CPUMemHandler::FreeHost(void *ptr) {
+  const auto &iter = host_blocks_.find(ptr);
+  if (iter == host_blocks_.end()) {
+    MS_LOG(ERROR) << "The host memory " << ptr << " is not malloced by the offload handler.";
+    return;
+  }
+  auto block_ptr = static_cast<uint8_t *>(ptr);
+  auto block = iter->second;
+  (void)host_blocks_.erase(iter);
+
+  // Merge the next and the previous free blocks, the mappings of segments may be adjacent, so the blocks of different
+  // segments are never merged.
+  auto next_iter = free_blocks_.find(block_ptr + block.size);
+  if (next_iter != free_blocks_.end() && next_iter->second.segment_index == block.segment_index) {
+    block.size += next_iter->second.size;
+    EraseFreeBlock(next_iter);
+  }
+  auto prev_iter = free_blocks_.lower_bound(block_ptr);
+  if (prev_iter != free_blocks_.begin()) {
+    --prev_iter;
+    if (prev_iter->first + prev_iter->second.size == block_ptr &&
+        prev_iter->second.segment_index == block.segment_index) {
+      block_ptr = prev_iter->first;
+      block.size += prev_iter->second.size;
+      EraseFreeBlock(prev_iter);
+    }
+  }
+  InsertFreeBlock(block_ptr, block);
+}
+
+void CPUMemHandler::InsertFreeBlock(uint8_t *ptr, const HostBlock &block) {
+  free_blocks_[ptr] = block;
+  (void)free_block_sizes_.emplace(block.size, ptr);
+}
+
+void CPUMemHandler::EraseFreeBlock(const std::map<uint8_t *, HostBlock>::iterator &iter) {
+  (void)free_block_sizes_.erase(std::make_pair(iter->second.size, iter->first));
+  (void)free_blocks_.erase(iter);
+}
+
+void CPUMemHandler::SwapIn(const void *host_ptr, void *device_ptr, size_t mem_size, void *) {
+  CopyMemory(device_ptr, host_ptr, mem_size);
+}
+
+void CPUMemHandler::SwapOut(const void *device_ptr, void *host_ptr, size_t mem_size, void *) {
+  CopyMemory(host_ptr, device_ptr, mem_size);
+  int fd = -1;
+  size_t offset = 0;
+  if (!GetFileRange(host_ptr, &fd, &offset)) {
+    return;
+  }
+  // Start the write back asynchronously, so the pages are clean and can be reclaimed when the memory is insufficient.
+  if (sync_file_range(fd, static_cast<off64_t>(offset), static_cast<off64_t>(mem_size), SYNC_FILE_RANGE_WRITE) != 0) {
+    MS_LOG(DEBUG) << "Write back the offload file failed, offset: " << offset << ", size: " << mem_size;
+  }
+}
+
+void CPUMemHandler::Prefetch(const void *host_ptr, size_t mem_size) {
+  MS_EXCEPTION_IF_NULL(host_ptr);
+  // The madvise requires the page aligned address, and the host memory is page aligned.
+  if (madvise(const_cast<void *>(host_ptr), mem_size, MADV_WILLNEED) != 0) {
+    MS_LOG(DEBUG) << "Read ahead the host memory " << host_ptr << " failed, size: " << mem_size;
+  }
+}
+
+bool CPUMemHandler::MapSegment(size_t mem_size) {
+  HostSegment segment;
+  segment.size = std::max(mem_size, kHostSegmentSize);
+  void *base = nullptr;
+  if (offload_path_.empty()) {
+    base = mmap(nullptr, segment.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  } else {
+    std::string file_name = offload_path_ + kOffloadFileTemplate;
+    segment.fd = mkstemp(&file_name[0]);
+    if (segment.fd < 0) {
+      MS_LOG(ERROR) << "Create the offload file " << file_name << " failed.";
+      return false;
+    }
+    // The file is removed after closed, since it's only accessed by the mapping.
+    (void)unlink(file_name.c_str());
+    if (ftruncate(segment.fd, static_cast<off_t>(segment.size)) != 0) {
+      MS_LOG(ERROR) << "Resize the offload file " << file_name << " to " << segment.size << " failed.";
+      (void)close(segment.fd);
+      return false;
+    }
+    base = mmap(nullptr, segment.size, PROT_READ | PROT_WRITE, MAP_SHARED, segment.fd, 0);
+  }
+  if (base == MAP_FAILED) {
+    MS_LOG(ERROR) << "Map the host memory of offload failed, size: " << segment.size;
+    if (segment.fd >= 0) {
+      (void)close(segment.fd);
+    }
+    return false;
+  }
+  segment.base = static_cast<uint8_t *>(base);
+  (void)segments_.emplace_back(segment);
+  InsertFreeBlock(segment.base, {segment.size, segments_.size() - 1});
+  MS_LOG(INFO) << "Map the host memory segment of offload, size: " << segment.size
+               << ", total segment number: " << segments_.size();
+  return true;
+}
+
+void CPUMemHandler::UnmapSegments() {
+  for (auto &segment : segments_) {
+    if (segment.base != nullptr) {
+      (void)munmap(segment.base, segment.size);
+    }
+    if (segment.fd >= 0) {
+      (void)close(segment.fd);
+    }
+  }
+  segments_.clear();
+  free_blocks_.clear();
+  free_block_sizes_.clear();
+  host_blocks_.clear();
+}
+
+bool CPUMemHandler::GetFileRange(const void *host_ptr, int *fd, size_t *offset) const {
+  MS_EXCEPTION_IF_NULL(fd);
+  MS_EXCEPTION_IF_NULL(offset);
+  auto ptr = static_cast<const uint8_t *>(host_ptr);
+  for (const auto &segment : segments_) {
+    if (segment.fd >= 0 && ptr >= segment.base && ptr < segment.base + segment.size) {
+      *fd = segment.fd;
+      *offset = static_cast<size_t>(ptr - segment.base);
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
@@ -0,0 +1,86 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_DEVICE_CPU_CPU_MEM_HANDLER_H_
+#define MINDSPORE_CCSRC_RUNTIME_DEVICE_CPU_CPU_MEM_HANDLER_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "runtime/device/memory_manager.h"
+#include "runtime/device/memory_scheduler.h"
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+// The memory handler of MemScheduler on CPU. The device memory is the DRAM of the CPU memory pool, which is limited by
+// the memory budget. The host memory is the file backed mapping in the offload directory, such as the NVMe disk, so
+// the swapped out memory is written back to the file and reclaimed by the page cache. The swap in of the next step is
+// read ahead asynchronously by the kernel, which overlaps the disk IO with the computation.
+class CPUMemHandler : public MemHandler {
+ public:
+  // The anonymous mapping is used as the host memory if the offload path is empty, and the available memory of system
+  // is used as the device memory budget if the mem_size is zero.
+  CPUMemHandler(const std::shared_ptr<MemoryManager> &mem_manager, const std::string &offload_path, size_t mem_size);
+  ~CPUMemHandler();
+
+  size_t GetAvailableMemSize() override;
+  void *MallocDevice(size_t mem_size) override;
+  void FreeDevice(void *ptr) override;
+  void *MallocHost(size_t mem_size) override;
+  void FreeHost(void *ptr) override;
+  void SwapIn(const void *host_ptr, void *device_ptr, size_t mem_size, void *stream) override;
+  void SwapOut(const void *device_ptr, void *host_ptr, size_t mem_size, void *stream) override;
+  void Prefetch(const void *host_ptr, size_t mem_size) override;
+
+ private:
+  // The host memory is allocated from the free blocks of the mapped segments by the best fit, and the rest of the block
+  // is returned to the free blocks. The freed memory is merged with the adjacent free blocks of the same segment, so
+  // the swap sizes which change between the steps don't leak the segments.
+  struct HostSegment {
+    int fd{-1};
+    uint8_t *base{nullptr};
+    size_t size{0};
+  };
+  struct HostBlock {
+    size_t size{0};
+    size_t segment_index{0};
+  };
+  bool MapSegment(size_t mem_size);
+  void UnmapSegments();
+  void InsertFreeBlock(uint8_t *ptr, const HostBlock &block);
+  void EraseFreeBlock(const std::map<uint8_t *, HostBlock>::iterator &iter);
+  // Get the file descriptor and offset of the host memory for the file IO hints, return false if not file backed.
+  bool GetFileRange(const void *host_ptr, int *fd, size_t *offset) const;
+
+  std::shared_ptr<MemoryManager> mem_manager_;
+  std::string offload_path_;
+  size_t mem_size_;
+  size_t device_mem_used_{0};
+  std::map<void *, size_t> device_mem_size_;
+  std::vector<HostSegment> segments_;
+  // The free blocks by the address for the merge, and by the size for the best fit.
+  std::map<uint8_t *, HostBlock> free_blocks_;
+  std::set<std::pair<size_t, uint8_t *>> free_block_sizes_;
+  std::map<void *, HostBlock> host_blocks_;
+};
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_RUNTIME_DEVICE_CPU_CPU_MEM_HANDLER_H_
@@ -364,6 +364,23 @@ KernelAttr FillNoneInKernelAttr(const CNodePtr &kernel_node, const std::vector<T
   }
   return result;
 }
+
+// Get the kernel attrs registered for the op, the ones registered by the op info are updated to the factory first.
+std::vector<KernelAttr> GetKernelAttrs(const std::string &op_name) {
+  auto kernel_attrs = kernel::CPUKernelFactory::GetInstance().GetSupportedKernelAttrList(op_name);
+  if (kernel_attrs.empty() || (kernel_attrs[0].GetInputSize() == 0 && kernel_attrs[0].GetOutputSize() == 0)) {
+    MS_LOG(DEBUG) << "Operator[" << op_name << "] will get ops attr info.";
+    auto op_info_ptr = mindspore::kernel::OpLib::FindOp(op_name, kernel::OpImplyType::kCPU);
+    if (op_info_ptr == nullptr) {
+      MS_LOG(EXCEPTION) << "Not find op[" << op_name << "] in cpu. For more details, "
+                        << "please refer to the list of supported cpu operations at https://www.mindspore.cn.";
+    }
+    kernel_attrs.clear();
+    kernel::CPUKernelFactory::GetInstance().SetKernelAttrs(op_info_ptr, &kernel_attrs);
+    kernel::CPUKernelFactory::GetInstance().UpdateKernelAttrs(op_name, kernel_attrs);
+  }
+  return kernel_attrs;
+}
 }  // namespace
 
 bool IsDynamicParamKernel(const std::string &op_name) {
@@ -454,19 +471,7 @@ void SetKernelInfo(const CNodePtr &kernel_node) {
   std::vector<TypeId> output_types;
   std::vector<TypeId> selected_output_types;
   MS_LOG(INFO) << "SetKernelInfo, CNode Name: " << op_name;
-  auto kernel_attrs =
-    kernel::CPUKernelFactory::GetInstance().GetSupportedKernelAttrList(AnfAlgo::GetCNodeName(kernel_node));
-  if (kernel_attrs.empty() || (kernel_attrs[0].GetInputSize() == 0 && kernel_attrs[0].GetOutputSize() == 0)) {
-    MS_LOG(DEBUG) << "Operator[" << op_name << "] will get ops attr info.";
-    auto op_info_ptr = mindspore::kernel::OpLib::FindOp(op_name, kernel::OpImplyType::kCPU);
-    if (op_info_ptr == nullptr) {
-      MS_LOG(EXCEPTION) << "Not find op[" << op_name << "] in cpu. For more details, "
-                        << "please refer to the list of supported cpu operations at https://www.mindspore.cn.";
-    }
-    kernel_attrs.clear();
-    kernel::CPUKernelFactory::GetInstance().SetKernelAttrs(op_info_ptr, &kernel_attrs);
-    kernel::CPUKernelFactory::GetInstance().UpdateKernelAttrs(op_name, kernel_attrs);
-  }
+  auto kernel_attrs = GetKernelAttrs(op_name);
   GetInputDtypes(kernel_node, &input_types, &input_not_cnode_indexes);
   GetOutputDtypes(kernel_node, &output_types);
   KernelAttr selected_kernel_attr;
@@ -495,6 +500,33 @@ void SetKernelInfo(const CNodePtr &kernel_node) {
   }
   SetKernelBuildInfo(input_formats, input_types, selected_output_formats, selected_output_types, kernel_node.get());
 }
+
+bool IsKernelInfoCacheable(const CNodePtr &kernel_node) {
+  MS_EXCEPTION_IF_NULL(kernel_node);
+  // Custom and dynamic kernels register the kernel attrs of their own while being selected.
+  return !IsPrimitiveCNode(kernel_node, prim::kPrimCustom) && !IsDynamicParamKernel(AnfAlgo::GetCNodeName(kernel_node));
+}
+
+void SetKernelInfoFromCache(const CNodePtr &kernel_node, const kernel::KernelBuildInfoPtr &build_info) {
+  MS_EXCEPTION_IF_NULL(kernel_node);
+  MS_EXCEPTION_IF_NULL(build_info);
+  // The kernel attrs are needed to create the kernel later.
+  (void)GetKernelAttrs(AnfAlgo::GetCNodeName(kernel_node));
+  AnfAlgo::SetSelectKernelBuildInfo(build_info, kernel_node.get());
+  // Same as UpdatePrevNotCNodeFormatDtype, the weights follow the input types of the selected kernel.
+  size_t input_num = std::min(AnfAlgo::GetInputTensorNum(kernel_node), build_info->GetInputNum());
+  for (size_t input_index = 0; input_index < input_num; ++input_index) {
+    auto input_node = AnfAlgo::VisitKernel(kernel_node->input(input_index + 1), 0).first;
+    MS_EXCEPTION_IF_NULL(input_node);
+    if (input_node->isa<Parameter>() && AnfAlgo::IsParameterWeight(input_node->cast<ParameterPtr>())) {
+      auto builder = std::make_shared<kernel::KernelBuildInfo::KernelBuildInfoBuilder>();
+      MS_EXCEPTION_IF_NULL(builder);
+      builder->SetOutputsFormat({kOpFormat_DEFAULT});
+      builder->SetOutputsDeviceType({build_info->GetInputDeviceType(input_index)});
+      AnfAlgo::SetSelectKernelBuildInfo(builder->Build(), input_node.get());
+    }
+  }
+}
 }  // namespace cpu
 }  // namespace device
 }  // namespace mindspore
@@ -23,6 +23,7 @@
 
 #include "ir/anf.h"
 #include "ir/dtype/type.h"
+#include "backend/kernel_compiler/kernel_build_info.h"
 #include "utils/utils.h"
 
 namespace mindspore {
@@ -31,6 +32,10 @@ namespace cpu {
 using DataType = std::pair<TypeId, std::string>;
 
 void SetKernelInfo(const CNodePtr &apply_kernel_ptr);
+// Whether the kernel build info only depends on the kernel itself, so it can be restored from the kernel select cache.
+bool IsKernelInfoCacheable(const CNodePtr &kernel_node);
+// Restore the kernel build info from the kernel select cache.
+void SetKernelInfoFromCache(const CNodePtr &kernel_node, const kernel::KernelBuildInfoPtr &build_info);
 // Indicate whether the kernel input/output number are variable.
 bool IsDynamicParamKernel(const std::string &op_name);
 
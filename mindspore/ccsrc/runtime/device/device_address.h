@@ -126,12 +126,13 @@ class DeviceAddress : public mindspore::DeviceSync {
       MS_LOG(DEBUG) << op_object << " increases dynamic ref count to:" << dynamic_ref_count_ << " for ptr:" << ptr_;
     }
   }
-  void DecreaseDynamicRefCount(const std::string &op_object) {
+  int32_t DecreaseDynamicRefCount(const std::string &op_object) {
     if (dynamic_ref_count_ <= 0) {
       MS_LOG(EXCEPTION) << "The dynamic reference count is invalid value:" << dynamic_ref_count_;
     }
-    dynamic_ref_count_--;
-    MS_LOG(DEBUG) << op_object << " decreases dynamic ref count to:" << dynamic_ref_count_ << " for ptr:" << ptr_;
+    auto dynamic_ref_count = --dynamic_ref_count_;
+    MS_LOG(DEBUG) << op_object << " decreases dynamic ref count to:" << dynamic_ref_count << " for ptr:" << ptr_;
+    return dynamic_ref_count;
   }
 
   virtual bool DumpMemToFile(const std::string &filepath, const std::string &host_fmt, const ShapeVector &host_shape,
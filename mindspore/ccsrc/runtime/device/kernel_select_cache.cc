@@ -0,0 +1,259 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/device/kernel_select_cache.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+#include "backend/session/anf_runtime_algorithm.h"
+#include "debug/common.h"
+#include "utils/context/graph_kernel_flags.h"
+#include "utils/ms_context.h"
+#include "utils/system/sha256.h"
+
+namespace mindspore {
+namespace device {
+namespace {
+// Bump it when the format of the cache file or the kernel selection changes.
+constexpr int kKernelSelectCacheVersion = 1;
+constexpr char kKernelSelectCacheFilePrefix[] = "/kernel_select/graph_";
+constexpr char kVersion[] = "version";
+constexpr char kKey[] = "key";
+constexpr char kKernels[] = "kernels";
+constexpr char kOpName[] = "op_name";
+constexpr char kKernelType[] = "kernel_type";
+constexpr char kProcessor[] = "processor";
+constexpr char kFusionType[] = "fusion_type";
+constexpr char kOpPattern[] = "op_pattern";
+constexpr char kInputFormats[] = "input_formats";
+constexpr char kInputTypes[] = "input_types";
+constexpr char kOutputFormats[] = "output_formats";
+constexpr char kOutputTypes[] = "output_types";
+
+template <typename T>
+void ShapeToStream(const std::vector<T> &shape, std::ostringstream *ss) {
+  *ss << "[";
+  for (const auto &dim : shape) {
+    *ss << dim << ",";
+  }
+  *ss << "]";
+}
+
+void KernelToStream(const CNodePtr &node, const std::unordered_map<AnfNodePtr, size_t> &node_index,
+                    std::ostringstream *ss) {
+  MS_EXCEPTION_IF_NULL(node);
+  *ss << AnfAlgo::GetCNodeName(node) << "{";
+  // The attributes are kept in a hash map, sort them to make the key stable.
+  auto prim = AnfAlgo::GetCNodePrimitive(node);
+  if (prim != nullptr) {
+    std::vector<std::pair<std::string, std::string>> attrs;
+    for (const auto &attr : prim->attrs()) {
+      (void)attrs.emplace_back(attr.first, attr.second == nullptr ? "" : attr.second->ToString());
+    }
+    std::sort(attrs.begin(), attrs.end());
+    for (const auto &attr : attrs) {
+      *ss << attr.first << "=" << attr.second << ";";
+    }
+  }
+  *ss << "}(";
+  size_t input_num = AnfAlgo::GetInputTensorNum(node);
+  for (size_t i = 0; i < input_num; ++i) {
+    auto real_input = AnfAlgo::VisitKernel(node->input(i + 1), 0);
+    const auto &input_node = real_input.first;
+    MS_EXCEPTION_IF_NULL(input_node);
+    auto iter = node_index.find(input_node);
+    if (iter != node_index.end()) {
+      *ss << "%" << iter->second << "." << real_input.second;
+    } else if (input_node->isa<Parameter>()) {
+      *ss << (AnfAlgo::IsParameterWeight(input_node->cast<ParameterPtr>()) ? "w" : "p");
+    } else if (input_node->isa<ValueNode>()) {
+      *ss << "v";
+    } else {
+      *ss << "c";
+    }
+    *ss << ":" << AnfAlgo::GetPrevNodeOutputInferDataType(node, i);
+    ShapeToStream(AnfAlgo::GetPrevNodeOutputInferShape(node, i), ss);
+    *ss << ",";
+  }
+  *ss << ")->(";
+  size_t output_num = AnfAlgo::GetOutputTensorNum(node);
+  for (size_t i = 0; i < output_num; ++i) {
+    *ss << AnfAlgo::GetOutputInferDataType(node, i);
+    ShapeToStream(AnfAlgo::GetOutputInferShape(node, i), ss);
+    *ss << ",";
+  }
+  *ss << ")\n";
+}
+
+nlohmann::json BuildInfoToJson(const CNodePtr &node) {
+  auto build_info = AnfAlgo::GetSelectKernelBuildInfo(node);
+  MS_EXCEPTION_IF_NULL(build_info);
+  nlohmann::json kernel_json;
+  kernel_json[kOpName] = AnfAlgo::GetCNodeName(node);
+  kernel_json[kKernelType] = static_cast<int>(build_info->kernel_type());
+  kernel_json[kProcessor] = static_cast<int>(build_info->processor());
+  kernel_json[kFusionType] = static_cast<int>(build_info->fusion_type());
+  kernel_json[kOpPattern] = static_cast<int>(build_info->op_pattern());
+  kernel_json[kInputFormats] = build_info->GetAllInputFormats();
+  kernel_json[kOutputFormats] = build_info->GetAllOutputFormats();
+  std::vector<int> input_types;
+  (void)std::transform(build_info->GetAllInputDeviceTypes().begin(), build_info->GetAllInputDeviceTypes().end(),
+                       std::back_inserter(input_types), [](TypeId type) { return static_cast<int>(type); });
+  kernel_json[kInputTypes] = input_types;
+  std::vector<int> output_types;
+  (void)std::transform(build_info->GetAllOutputDeviceTypes().begin(), build_info->GetAllOutputDeviceTypes().end(),
+                       std::back_inserter(output_types), [](TypeId type) { return static_cast<int>(type); });
+  kernel_json[kOutputTypes] = output_types;
+  return kernel_json;
+}
+
+kernel::KernelBuildInfoPtr JsonToBuildInfo(const nlohmann::json &kernel_json) {
+  auto builder = std::make_shared<kernel::KernelBuildInfo::KernelBuildInfoBuilder>();
+  MS_EXCEPTION_IF_NULL(builder);
+  builder->SetKernelType(static_cast<KernelType>(kernel_json.at(kKernelType).get<int>()));
+  builder->SetProcessor(static_cast<kernel::Processor>(kernel_json.at(kProcessor).get<int>()));
+  builder->SetFusionType(static_cast<kernel::FusionType>(kernel_json.at(kFusionType).get<int>()));
+  builder->SetOpPattern(static_cast<kernel::OpPattern>(kernel_json.at(kOpPattern).get<int>()));
+  builder->SetInputsFormat(kernel_json.at(kInputFormats).get<std::vector<std::string>>());
+  builder->SetOutputsFormat(kernel_json.at(kOutputFormats).get<std::vector<std::string>>());
+  std::vector<TypeId> input_types;
+  for (auto type : kernel_json.at(kInputTypes).get<std::vector<int>>()) {
+    (void)input_types.emplace_back(static_cast<TypeId>(type));
+  }
+  builder->SetInputsDeviceType(input_types);
+  std::vector<TypeId> output_types;
+  for (auto type : kernel_json.at(kOutputTypes).get<std::vector<int>>()) {
+    (void)output_types.emplace_back(static_cast<TypeId>(type));
+  }
+  builder->SetOutputsDeviceType(output_types);
+  return builder->Build();
+}
+}  // namespace
+
+void KernelSelectCache::Enable(const std::string &cache_dir) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_dir_ = cache_dir;
+  enabled_.store(true);
+  MS_LOG(INFO) << "Enable the kernel select cache in " << cache_dir;
+}
+
+std::string KernelSelectCache::GraphKey(const std::string &device_name, const std::vector<CNodePtr> &nodes) const {
+  auto ms_context = MsContext::GetInstance();
+  MS_EXCEPTION_IF_NULL(ms_context);
+  std::ostringstream ss;
+  // The fingerprint of the device and the context which change the result of the kernel selection.
+  ss << kKernelSelectCacheVersion << ":" << device_name << ":"
+     << graphkernel::GraphKernelFlags::GetInstance().IsEnableGraphKernel() << ":"
+     << ms_context->get_param<bool>(MS_CTX_ENABLE_REDUCE_PRECISION) << "\n";
+  std::unordered_map<AnfNodePtr, size_t> node_index;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    KernelToStream(nodes[i], node_index, &ss);
+    node_index[nodes[i]] = i;
+  }
+  return ss.str();
+}
+
+std::string KernelSelectCache::CacheFilePath(const std::string &key) const {
+  // The file is named by the digest of the key, and the key itself is saved in the file to be checked when loaded.
+  return cache_dir_ + kKernelSelectCacheFilePrefix + system::sha256::GetHashFromString(key) + ".json";
+}
+
+bool KernelSelectCache::Load(const std::string &key, nlohmann::json *graph_json) const {
+  MS_EXCEPTION_IF_NULL(graph_json);
+  auto filename = CacheFilePath(key);
+  std::ifstream json_fs(filename);
+  if (!json_fs.is_open()) {
+    MS_LOG(INFO) << "Open json file: " << filename << " error, kernel select cache missed.";
+    return false;
+  }
+  try {
+    json_fs >> *graph_json;
+  } catch (std::exception &e) {
+    MS_LOG(WARNING) << "Parse json file error: " << filename << ", " << e.what();
+    return false;
+  }
+  return true;
+}
+
+bool KernelSelectCache::Fetch(const std::string &key, const std::vector<CNodePtr> &nodes,
+                              std::vector<kernel::KernelBuildInfoPtr> *build_infos) {
+  MS_EXCEPTION_IF_NULL(build_infos);
+  nlohmann::json graph_json;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = pending_.find(key);
+    if (iter != pending_.end()) {
+      graph_json = iter->second;
+    } else if (!Load(key, &graph_json)) {
+      return false;
+    }
+  }
+
+  try {
+    if (graph_json.at(kVersion) != kKernelSelectCacheVersion || graph_json.at(kKey) != key) {
+      MS_LOG(WARNING) << "Mismatch kernel select cache, the graph is compiled again.";
+      return false;
+    }
+    const auto &kernels_json = graph_json.at(kKernels);
+    if (kernels_json.size() != nodes.size()) {
+      MS_LOG(WARNING) << "Mismatch kernel size " << kernels_json.size() << " vs " << nodes.size();
+      return false;
+    }
+    std::vector<kernel::KernelBuildInfoPtr> restored;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      if (kernels_json[i].at(kOpName) != AnfAlgo::GetCNodeName(nodes[i])) {
+        MS_LOG(WARNING) << "Mismatch kernel " << kernels_json[i].at(kOpName) << " vs " << nodes[i]->DebugString();
+        return false;
+      }
+      (void)restored.emplace_back(JsonToBuildInfo(kernels_json[i]));
+    }
+    *build_infos = std::move(restored);
+  } catch (std::exception &e) {
+    MS_LOG(WARNING) << "Invalid kernel select cache, the graph is compiled again. " << e.what();
+    return false;
+  }
+  MS_LOG(INFO) << "Kernel select cache hit, kernel size: " << nodes.size();
+  return true;
+}
+
+void KernelSelectCache::Insert(const std::string &key, const std::vector<CNodePtr> &nodes) {
+  nlohmann::json graph_json;
+  graph_json[kVersion] = kKernelSelectCacheVersion;
+  graph_json[kKey] = key;
+  std::vector<nlohmann::json> kernels_json;
+  for (const auto &node : nodes) {
+    (void)kernels_json.emplace_back(BuildInfoToJson(node));
+  }
+  graph_json[kKernels] = kernels_json;
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_[key] = std::move(graph_json);
+}
+
+void KernelSelectCache::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &item : pending_) {
+    auto filename = CacheFilePath(item.first);
+    if (!Common::SaveStringToFile(filename, item.second.dump())) {
+      MS_LOG(WARNING) << "Save the kernel select cache to " << filename << " failed.";
+    }
+  }
+  pending_.clear();
+}
+}  // namespace device
+}  // namespace mindspore
@@ -0,0 +1,81 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_DEVICE_KERNEL_SELECT_CACHE_H_
+#define MINDSPORE_CCSRC_RUNTIME_DEVICE_KERNEL_SELECT_CACHE_H_
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "ir/anf.h"
+#include "backend/kernel_compiler/kernel_build_info.h"
+#include "utils/ms_utils.h"
+
+namespace mindspore {
+namespace device {
+// The persistent cache of the kernel selection results. The kernels of a graph are hashed together with everything the
+// selection depends on (op name, attributes, input/output types and shapes, where the inputs come from), and the
+// selected build infos are saved under the compile cache path. A restarted process compiling the same graph on the same
+// device restores the build infos instead of selecting the kernels again.
+// Only the kernel selection of the CPU device context is cached. The kernel mods, the device addresses with their
+// reference counts and the actor arrows are objects of the current process which point to each other, so they are
+// rebuilt by CreateKernel and GraphScheduler::Transform. The reference counts are set while linking the arrows, which
+// is a linear walk of the graph, and the AKG kernels are compiled once into the kernel meta directory anyway.
+class KernelSelectCache {
+ public:
+  static KernelSelectCache &GetInstance() {
+    static KernelSelectCache instance;
+    return instance;
+  }
+
+  // Turn on the cache, the cache files are saved in the directory.
+  void Enable(const std::string &cache_dir);
+  bool enabled() const { return enabled_.load(); }
+
+  // Get the key of the kernels which are about to be selected on the device, which is the canonical text of the kernels
+  // rather than a hash of it, so that two graphs never share the build infos.
+  std::string GraphKey(const std::string &device_name, const std::vector<CNodePtr> &nodes) const;
+
+  // Look up the build infos of the kernels, in the order of the kernels. Return false if missed.
+  bool Fetch(const std::string &key, const std::vector<CNodePtr> &nodes,
+             std::vector<kernel::KernelBuildInfoPtr> *build_infos);
+
+  // Record the build infos of the kernels which have been selected.
+  void Insert(const std::string &key, const std::vector<CNodePtr> &nodes);
+
+  // Save the new records to disk.
+  void Flush();
+
+ private:
+  KernelSelectCache() = default;
+  ~KernelSelectCache() = default;
+  DISABLE_COPY_AND_ASSIGN(KernelSelectCache);
+
+  std::string CacheFilePath(const std::string &key) const;
+  bool Load(const std::string &key, nlohmann::json *graph_json) const;
+
+  std::atomic<bool> enabled_{false};
+  std::string cache_dir_;
+  std::mutex mutex_;
+  // The key -> the records not saved yet.
+  std::map<std::string, nlohmann::json> pending_;
+};
+}  // namespace device
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_RUNTIME_DEVICE_KERNEL_SELECT_CACHE_H_
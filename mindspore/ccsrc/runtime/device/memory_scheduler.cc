@@ -206,10 +206,34 @@ bool MemScheduler::PostCompute(void *stream) {
       (void)mem_result_.erase(event->key);
     }
   }
+  PrefetchNextStep();
   ++current_step_;
   return true;
 }
 
+void MemScheduler::PrefetchNextStep() {
+  const size_t next_step = current_step_ + 1;
+  if (next_step >= total_step_) {
+    return;
+  }
+  auto &events = strategy_->GetPreComputeEvents(next_step);
+  for (auto &event : events) {
+    MS_EXCEPTION_IF_NULL(event);
+    if (event->type != kSwapIn) {
+      continue;
+    }
+    const auto &init_iter = init_host_ptr_.find(event->key);
+    if (init_iter != init_host_ptr_.end() && init_iter->second != nullptr) {
+      mem_handler_->Prefetch(init_iter->second, event->mem_size);
+      continue;
+    }
+    const auto &swap_iter = swap_host_ptr_.find(event->key);
+    if (swap_iter != swap_host_ptr_.end() && swap_iter->second != nullptr) {
+      mem_handler_->Prefetch(swap_iter->second, event->mem_size);
+    }
+  }
+}
+
 void MemScheduler::OptMemUsage(float mem_used_factor) {
   mem_used_factor_ = mem_used_factor;
   MS_EXCEPTION_IF_NULL(mem_handler_);
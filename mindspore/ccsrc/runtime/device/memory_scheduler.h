@@ -34,6 +34,8 @@ class MemHandler {
   virtual void FreeHost(void *ptr) = 0;
   virtual void SwapIn(const void *host_ptr, void *device_ptr, size_t mem_size, void *stream) = 0;
   virtual void SwapOut(const void *device_ptr, void *host_ptr, size_t mem_size, void *stream) = 0;
+  // Hint that the host memory will be swapped in soon, so the handler can start reading it ahead asynchronously.
+  virtual void Prefetch(const void *host_ptr, size_t mem_size) {}
 };
 
 class MemScheduler {
@@ -91,6 +93,8 @@ class MemScheduler {
 
   void AdjustFirstEventIndex();
 
+  void PrefetchNextStep();
+
   std::map<const void *, MemPriority> mem_priority_;
   std::map<const void *, std::vector<std::shared_ptr<MemEvent>>> mem_events_;
   std::set<const void *> manual_offload_keys_;
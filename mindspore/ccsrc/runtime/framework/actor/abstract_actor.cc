@@ -16,6 +16,7 @@
 
 #include "runtime/framework/actor/abstract_actor.h"
 #include "runtime/framework/actor/output_actor.h"
+#include "mindrt/include/actor/actor_trace.h"
 #include "utils/log_adapter.h"
 
 namespace mindspore {
@@ -28,6 +29,7 @@ void AbstractActor::RunOpData(OpData<DeviceTensor> *const input_data, OpContext<
   auto is_run = CheckRunningCondition(context);
   MS_LOG(DEBUG) << "Actor(" << GetAID().Name() << ") receive the input op data and check running condition:" << is_run;
   if (is_run) {
+    RecordRunLatency();
     Run(context);
   }
 }
@@ -41,10 +43,22 @@ void AbstractActor::RunOpControl(AID *const input_control, OpContext<DeviceTenso
   MS_LOG(DEBUG) << "Actor(" << GetAID().Name()
                 << ") receive the input op control and check running condition:" << is_run;
   if (is_run) {
+    RecordRunLatency();
     Run(context);
   }
 }
 
+void AbstractActor::RecordRunLatency() const {
+  auto &actor_trace = ActorTrace::GetInstance();
+  // The message time is the time when the last input triggering the actor running starts being processed, the wait in
+  // the mailbox before it is recorded as the mailbox wait already.
+  auto run_begin_time = ActorTrace::current_message_time();
+  if ((run_begin_time == 0) || (!actor_trace.enabled())) {
+    return;
+  }
+  actor_trace.Record(ActorTraceEventType::kRunLatency, GetAID().Name(), run_begin_time, ActorTrace::NowNs());
+}
+
 bool AbstractActor::CheckRunningCondition(const OpContext<DeviceTensor> *context) const {
   MS_EXCEPTION_IF_NULL(context);
   if (input_datas_num_ != 0) {
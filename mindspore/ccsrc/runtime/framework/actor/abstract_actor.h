@@ -72,6 +72,8 @@ class AbstractActor : public OpActor<DeviceTensor> {
   virtual bool CheckRunningCondition(const OpContext<DeviceTensor> *context) const;
   // The actor run really when satisfy the actor running condition.
   virtual void Run(OpContext<DeviceTensor> *const context) {}
+  // Record the latency from the last input starting being processed to the actor running in the actor trace.
+  void RecordRunLatency() const;
 
   // Erase input data and input controls when finish actor running.
   virtual void EraseInput(const OpContext<DeviceTensor> *context);
@@ -148,6 +148,11 @@ class ActorDispatcher {
     is_multi_thread_execution_ = is_multi_thread_execution;
   }
 
+  static void is_memory_allocation_sync(bool is_memory_allocation_sync) {
+    is_memory_allocation_sync_ = is_memory_allocation_sync;
+  }
+  static bool is_memory_allocation_sync() { return is_memory_allocation_sync_; }
+
   // The first five executions are for warm-up, the next five executions are statistics of multi thread execution time,
   // and the next next five executions are statistics of single thread execution time.
   static constexpr size_t kMultiThreadExecutionCountBegin{31};
@@ -166,6 +171,12 @@ class ActorDispatcher {
   // There are scenarios with small network and data, and the performance of multi thread execution is not as good as
   // that of single thread, so single thread execution is required at this time.
   static bool is_multi_thread_execution_;
+
+  // Decide whether the actors allocate and free memory by themselves in the running.
+  // The MemoryManagerActor binds single thread and every memory request of actors costs two messages, the actors of
+  // static shape kernels use the thread safe memory pool of device directly, so the MemoryManagerActor is only required
+  // by the dynamic shape kernels and the other actors.
+  static bool is_memory_allocation_sync_;
 };
 
 void ComputeThreadNums(size_t *actor_thread_num, size_t *actor_and_kernel_thread_num);
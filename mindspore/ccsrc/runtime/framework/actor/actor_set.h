@@ -32,6 +32,7 @@
 #include "runtime/framework/actor/super_kernel_actor.h"
 #include "runtime/framework/actor/output_actor.h"
 #include "runtime/framework/actor/copy_actor.h"
+#include "runtime/framework/actor/linear_executor.h"
 #include "runtime/framework/actor/control_flow/switch_actor.h"
 #include "runtime/framework/actor/control_flow/gather_actor.h"
 #include "runtime/framework/actor/control_flow/entrance_actor.h"
@@ -72,6 +73,8 @@ using ControlActorSetPtr = std::shared_ptr<ControlActorSet>;
 // The loop count actor is used to receive the control of tail kernel actor to represent the end of one step
 // and decide whether to loop execution by loop count.
 // The output actor is used to receive the output result of actor which represents the graph output.
+// The linear executor runs the kernel actors in the topological order without message passing, which is used instead
+// of the actors when it is faster.
 struct ActorSet {
   explicit ActorSet(const ActorInfo &name) : name_(name) {}
   DataPrepareActorPtr data_prepare_actor_{nullptr};
@@ -90,6 +93,13 @@ struct ActorSet {
   size_t execution_count_{0};
   double multi_thread_execution_time_{0};
   double single_thread_execution_time_{0};
+  // The linear executor is null when the actor set doesn't support the linear execution.
+  LinearExecutorPtr linear_executor_{nullptr};
+  bool is_linear_execution_{false};
+  double linear_execution_time_{0};
+  // The hit and miss counts of the infer cache of dynamic shape kernel actors until the last execution.
+  size_t infer_cache_hit_count_{0};
+  size_t infer_cache_miss_count_{0};
 };
 using ActorSetPtr = std::shared_ptr<ActorSet>;
 
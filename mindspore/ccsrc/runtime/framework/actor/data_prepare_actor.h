@@ -67,6 +67,7 @@ class DataPrepareActor : public DebugAwareActor {
 
  private:
   friend class GraphScheduler;
+  friend class LinearExecutor;
 
   void UpdateDynamicShape(const AnfNodePtr &input_node, const TensorPtr &input_tensor);
 
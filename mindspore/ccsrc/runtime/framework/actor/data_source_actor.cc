@@ -213,6 +213,16 @@ void HostQueueDataSourceActor::SendMemoryFreeReq(OpContext<DeviceTensor> *const
 }
 
 void HostQueueDataSourceActor::OnMemoryAllocFinish(OpContext<DeviceTensor> *const context) {
+  MS_EXCEPTION_IF_NULL(context);
+  CopyHostTensorsToDevice(context);
+  if (!context->error_info_.empty()) {
+    return;
+  }
+
+  PostRun(context);
+}
+
+void HostQueueDataSourceActor::CopyHostTensorsToDevice(OpContext<DeviceTensor> *const context) {
   MS_EXCEPTION_IF_NULL(context);
   if (buffers_.size() == 0) {
     SET_OPCONTEXT_FAIL_RET_WITH_ERROR((*context), "The data queue is empty.");
@@ -256,8 +266,6 @@ void HostQueueDataSourceActor::OnMemoryAllocFinish(OpContext<DeviceTensor> *cons
     }
   }
   host_queue_->Pop();
-
-  PostRun(context);
 }
 
 size_t HostQueueDataSourceActor::FetchNodePosition(const AnfNodePtr &data_node) const {
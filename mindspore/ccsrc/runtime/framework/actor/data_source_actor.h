@@ -133,10 +133,14 @@ class HostQueueDataSourceActor : public DataSourceActor {
  private:
   friend class GraphScheduler;
   friend class ControlNodeScheduler;
+  friend class LinearExecutor;
 
   // Judge all the data_nodes_ is from the same device.
   bool IsSameDeviceType() const;
 
+  // Pull the host tensors from host queue and copy them to the device tensors of buffers.
+  void CopyHostTensorsToDevice(OpContext<DeviceTensor> *const context);
+
   HostTensorQueuePtr host_queue_;
   // Input data nodes fetch data from host queue.
   std::vector<AnfNodePtr> data_nodes_;
@@ -15,15 +15,46 @@
  */
 
 #include "runtime/framework/actor/kernel_actor.h"
+#include <utility>
 #include "runtime/framework/actor/memory_manager_actor.h"
 #include "runtime/framework/actor/output_actor.h"
 #include "runtime/framework/actor/recorder_actor.h"
 #include "runtime/framework/actor/debug_actor.h"
 #include "mindrt/include/async/async.h"
+#include "mindrt/include/actor/actor_trace.h"
+#include "abstract/primitive_infer_map.h"
+#include "backend/optimizer/common/helper.h"
 #include "utils/log_adapter.h"
 
 namespace mindspore {
 namespace runtime {
+namespace {
+// The maximum number of the input shapes cached by one kernel.
+constexpr size_t kInferCacheMaxSize = 32;
+
+// The infer result can be cached by the input shapes only when the device context infers the shape and resizes the
+// kernel before launch, the output shapes don't depend on the input values and the inputs aren't nop nodes which are
+// inferred together with the kernel.
+bool IsInferCacheable(const CNodePtr &kernel, const DeviceContext *device_context) {
+  MS_EXCEPTION_IF_NULL(kernel);
+  MS_EXCEPTION_IF_NULL(device_context);
+  auto device_type = device_context->GetDeviceAddressType();
+  if ((device_type != device::DeviceAddressType::kCPU) && (device_type != device::DeviceAddressType::kGPU)) {
+    return false;
+  }
+  if (!abstract::GetDependsFormMap(kernel).empty()) {
+    return false;
+  }
+  size_t input_num = AnfAlgo::GetInputTensorNum(kernel);
+  for (size_t i = 0; i < input_num; ++i) {
+    if (opt::IsNopNode(AnfAlgo::GetPrevNodeOutput(kernel, i).first)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
 void KernelActor::Init() {
   // Check device contexts number.
   if (device_contexts_.size() != device::kDeviceContextsNumOne) {
@@ -37,6 +68,9 @@ void KernelActor::Init() {
   real_input_num_ = AnfAlgo::GetInputTensorNum(kernel_);
   kernel_info_ = dynamic_cast<KernelInfo *>(kernel_->kernel_info());
   is_dynamic_shape_ = AnfAlgo::IsDynamicShape(kernel_);
+  is_infer_cacheable_ = is_dynamic_shape_ && IsInferCacheable(kernel_, device_contexts_[0]);
+  is_memory_allocation_sync_ = ActorDispatcher::is_memory_allocation_sync() && (!is_dynamic_shape_) &&
+                               (strategy_ == GraphExecutionStrategy::kPipeline);
 
   // Init the device tensors and kernel launch info.
   copy_input_device_tensors_.resize(real_input_num_);
@@ -86,7 +120,7 @@ void KernelActor::Run(OpContext<DeviceTensor> *const context) {
   // Infer kernel shape and update abstract info for dynamic shape kernel.
   if (is_dynamic_shape_) {
     try {
-      device_contexts_[0]->UpdateDynamicShape(kernel_);
+      InferShapeAndResize();
     } catch (const std::exception &e) {
       if (strategy_ == GraphExecutionStrategy::kPipeline) {
         MsException::Instance().SetException();
@@ -116,7 +150,7 @@ void KernelActor::RunOpControlWithInputTensor(AID *const input_control, OpContex
   // When all the inputs are collected, then allocate memory and callback launch.
   if (CheckRunningCondition(context)) {
     if (is_dynamic_shape_) {
-      device_contexts_[0]->UpdateDynamicShape(kernel_);
+      InferShapeAndResize();
     }
 
     FetchOutputDeviceTensor();
@@ -146,6 +180,25 @@ void AllocateMemory(const std::vector<DeviceTensor *> &alloc_list, const DeviceC
   }
 }
 
+// Allocate memory through the device context in the pipeline actor running, the memory pool of device is thread safe.
+bool AllocateMemoryInPipeline(const std::vector<DeviceTensor *> &alloc_list, const DeviceContext *device_context,
+                              OpContext<DeviceTensor> *const context, const std::string &actor_name) {
+  MS_EXCEPTION_IF_NULL(device_context);
+  MS_EXCEPTION_IF_NULL(context);
+
+  for (auto &device_tensor : alloc_list) {
+    MS_EXCEPTION_IF_NULL(device_tensor);
+    if (device_tensor->GetPtr() != nullptr) {
+      continue;
+    }
+    if (!device_context->AllocateMemory(device_tensor, device_tensor->GetSize())) {
+      SetOpContextMemoryAllocFail(actor_name, device_context, device_tensor->GetSize(), context);
+      return false;
+    }
+  }
+  return true;
+}
+
 void FreeMemory(const std::vector<DeviceTensor *> &free_list, const DeviceContext *device_context) {
   MS_EXCEPTION_IF_NULL(device_context);
   for (auto &device_tensor : free_list) {
@@ -168,7 +221,13 @@ void FreeMemory(const std::vector<DeviceTensor *> &free_list, const DeviceContex
 
 void KernelActor::SendMemoryAllocReq(OpContext<DeviceTensor> *const context) {
   running_dependent_msg_num_ = 1;
-  if (strategy_ == GraphExecutionStrategy::kPipeline) {
+  if (is_memory_allocation_sync_) {
+    // Launch kernel directly after the memory allocation, no callback message from the memory manager actor.
+    if (AllocateMemoryInPipeline(memory_alloc_list_, device_contexts_[0], context, GetAID().Name())) {
+      OnMemoryAllocFinish(context);
+    }
+  } else if (strategy_ == GraphExecutionStrategy::kPipeline) {
+    memory_alloc_req_time_ = ActorTrace::GetInstance().enabled() ? ActorTrace::NowNs() : 0;
     ActorDispatcher::Send(memory_manager_aid_, &MemoryManagerActor::AllocateMemory, &memory_alloc_list_,
                           device_contexts_[0], context, GetAID());
   } else {
@@ -177,7 +236,12 @@ void KernelActor::SendMemoryAllocReq(OpContext<DeviceTensor> *const context) {
 }
 
 void KernelActor::SendMemoryFreeReq(OpContext<DeviceTensor> *const context) {
-  if (strategy_ == GraphExecutionStrategy::kPipeline) {
+  if (is_memory_allocation_sync_) {
+    // The reference count is decreased atomically, so the device tensors shared with the other actors are freed once.
+    for (auto &device_tensor : memory_free_list_) {
+      FreeMemoryByRefCount(device_tensor, device_contexts_[0], GetAID().Name());
+    }
+  } else if (strategy_ == GraphExecutionStrategy::kPipeline) {
     ActorDispatcher::Send(memory_manager_aid_, &MemoryManagerActor::FreeMemory, &memory_free_list_, device_contexts_[0],
                           context, GetAID());
   } else {
@@ -189,11 +253,22 @@ void KernelActor::OnMemoryAllocFinish(OpContext<DeviceTensor> *const context) {
   MS_EXCEPTION_IF_NULL(context);
   MS_EXCEPTION_IF_NULL(kernel_);
   MS_EXCEPTION_IF_NULL(device_contexts_[0]);
+  if (memory_alloc_req_time_ != 0) {
+    ActorTrace::GetInstance().Record(ActorTraceEventType::kMemoryWait, GetAID().Name(), memory_alloc_req_time_,
+                                     ActorTrace::NowNs());
+    memory_alloc_req_time_ = 0;
+  }
   PreLaunchKernel(context);
 
   try {
+    ActorTraceScope trace_scope(ActorTraceEventType::kKernelLaunch, GetAID().Name());
+    uint64_t launch_begin_ns = is_launch_cost_recorded_ ? ActorTrace::NowNs() : 0;
     auto ret = device_contexts_[0]->LaunchKernel(kernel_, launch_info_.inputs_, launch_info_.workspaces_,
                                                  launch_info_.outputs_, is_dynamic_shape_);
+    if (is_launch_cost_recorded_) {
+      launch_cost_ns_ += ActorTrace::NowNs() - launch_begin_ns;
+      ++launch_num_;
+    }
     if (!ret) {
       std::string error_info = "Launch kernel failed: " + kernel_->fullname_with_scope();
       SET_OPCONTEXT_FAIL_RET_WITH_ERROR_BY_STRATEGY(strategy_, (*context), error_info);
@@ -385,9 +460,11 @@ void KernelActor::PreLaunchKernel(OpContext<DeviceTensor> *) {
 }
 
 void KernelActor::PostLaunchKernel(OpContext<DeviceTensor> *const context) {
-  // The size of output address may be changed in dynamic shape scenario.
-  if (is_dynamic_shape_) {
+  // The size of output address may be changed in dynamic shape scenario. The output shapes of the cached infer result
+  // aren't changed by the launch, so the size of output address is the same as the kernel mod output size.
+  if (is_dynamic_shape_ && (!is_infer_cache_hit_)) {
     UpdateOutputAddrSize();
+    InsertInferCache();
   }
 
   running_dependent_msg_num_ = SizeToInt(input_datas_num_ + input_controls_num_);
@@ -420,6 +497,53 @@ void KernelActor::UpdateOutputAddrSize() {
   }
 }
 
+void KernelActor::InferShapeAndResize() {
+  is_infer_cache_hit_ = false;
+  if (!is_infer_cacheable_) {
+    device_contexts_[0]->UpdateDynamicShape(kernel_);
+    return;
+  }
+
+  InferCacheKey key;
+  for (size_t i = 0; i < real_input_num_; ++i) {
+    (void)key.emplace_back(AnfAlgo::GetPrevNodeOutputInferShape(kernel_, i));
+  }
+  auto iter = infer_cache_.find(key);
+  if (iter != infer_cache_.end()) {
+    ++infer_cache_hit_count_;
+    is_infer_cache_hit_ = true;
+    kernel_->set_abstract(iter->second);
+    // The kernel mod is resized in place, which is skipped when the input shapes are the same as the last launch.
+    if (key != infer_cache_key_) {
+      infer_cache_key_.clear();
+      device_contexts_[0]->ResizeKernel(kernel_);
+      infer_cache_key_ = std::move(key);
+    }
+    return;
+  }
+
+  ++infer_cache_miss_count_;
+  infer_cache_key_.clear();
+  device_contexts_[0]->UpdateDynamicShape(kernel_);
+  infer_cache_key_ = std::move(key);
+  inferred_abstract_ = kernel_->abstract();
+}
+
+void KernelActor::InsertInferCache() {
+  if ((!is_infer_cacheable_) || (infer_cache_.size() >= kInferCacheMaxSize)) {
+    return;
+  }
+  // The output shapes are updated by the launch, which depend on the input values, such as the operator 'Unique'.
+  if (kernel_->abstract() != inferred_abstract_) {
+    MS_LOG(INFO) << "The output shapes of kernel " << kernel_->fullname_with_scope()
+                 << " are changed by the launch, disable the infer cache.";
+    is_infer_cacheable_ = false;
+    infer_cache_.clear();
+    return;
+  }
+  (void)infer_cache_.emplace(infer_cache_key_, inferred_abstract_);
+}
+
 void KernelActor::SendRecorderInfo(OpContext<DeviceTensor> *const context) const {
   if (recorder_aid_ != nullptr) {
     MS_EXCEPTION_IF_NULL(kernel_);
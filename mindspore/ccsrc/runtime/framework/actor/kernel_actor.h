@@ -20,6 +20,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <map>
 #include <utility>
 #include "utils/hash_map.h"
 #include "runtime/framework/actor/actor_common.h"
@@ -82,6 +83,7 @@ class KernelActor : public DebugAwareActor {
  private:
   friend class GraphScheduler;
   friend class ControlNodeScheduler;
+  friend class LinearExecutor;
 
   // Fetch the device tensor for launch.
   void FetchInputDeviceTensor(OpContext<DeviceTensor> *const context);
@@ -99,10 +101,17 @@ class KernelActor : public DebugAwareActor {
   // 'Unique' will change after PostExecute, the output address size should update.
   void UpdateOutputAddrSize();
 
+  // Infer the shape and resize the kernel in dynamic shape scenario, skipped when the input shapes hit the infer cache.
+  void InferShapeAndResize();
+  // Cache the infer result after kernel launch, which makes sure the output shapes aren't changed by the launch.
+  void InsertInferCache();
+
   // The info of kernel.
   CNodePtr kernel_;
   KernelInfo *kernel_info_;
   bool is_dynamic_shape_;
+  // Allocate and free memory in the running of kernel actor instead of sending requests to the memory manager actor.
+  bool is_memory_allocation_sync_{false};
 
   // The real input number of kernel launch.
   size_t real_input_num_;
@@ -130,9 +139,30 @@ class KernelActor : public DebugAwareActor {
 
   // The kernel launch info is fetched by the device tensors.
   KernelLaunchInfo launch_info_;
+  // The time of sending the memory allocation request to the memory manager actor, which is only recorded when the
+  // actor trace is enabled.
+  uint64_t memory_alloc_req_time_{0};
+  // The launch time cost of kernel in the profiling steps, which the graph scheduler uses to find the critical path.
+  bool is_launch_cost_recorded_{false};
+  uint64_t launch_cost_ns_{0};
+  size_t launch_num_{0};
 
   // Cache output data by output index to modify the output data effectively.
   std::vector<std::vector<OpData<DeviceTensor> *>> output_data_by_output_index_;
+
+  // The infer result of dynamic shape kernel: the output abstract by the input shapes. The kernel mod is resized in
+  // place, so a hit skips the infer only.
+  // The key is the input shapes, the input shapes of NLP networks are usually bucketed into a few lengths.
+  using InferCacheKey = std::vector<std::vector<size_t>>;
+  bool is_infer_cacheable_{false};
+  bool is_infer_cache_hit_{false};
+  std::map<InferCacheKey, AbstractBasePtr> infer_cache_;
+  // The input shapes which the kernel mod is resized by, and the output abstract of the current launch, which are
+  // inserted into the cache after the launch.
+  InferCacheKey infer_cache_key_;
+  AbstractBasePtr inferred_abstract_{nullptr};
+  size_t infer_cache_hit_count_{0};
+  size_t infer_cache_miss_count_{0};
 };
 
 using KernelActorPtr = std::shared_ptr<KernelActor>;
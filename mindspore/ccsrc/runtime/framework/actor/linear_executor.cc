@@ -0,0 +1,459 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/framework/actor/linear_executor.h"
+#include <algorithm>
+#include <set>
+#include <string>
+#include "runtime/framework/actor/memory_manager_actor.h"
+#include "runtime/device/memory_manager.h"
+#include "utils/hash_map.h"
+#include "utils/utils.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace runtime {
+namespace {
+// The liveness of device tensor in the instruction stream.
+struct DeviceTensorLife : public LinearExecutor::MemoryBlock {
+  // The alloc index in the birth instruction and the free index in the death instruction.
+  size_t alloc_index_{0};
+  size_t free_index_{0};
+  size_t ref_count_{0};
+  bool is_plannable_{false};
+  bool is_alive_{false};
+};
+
+size_t AlignMemorySize(size_t size) {
+  return (size + device::kMemAlignSize - 1) / device::kMemAlignSize * device::kMemAlignSize;
+}
+}  // namespace
+
+size_t LinearExecutor::AssignOffsets(std::vector<MemoryBlock *> *blocks) {
+  MS_EXCEPTION_IF_NULL(blocks);
+  std::sort(blocks->begin(), blocks->end(), [](const MemoryBlock *a, const MemoryBlock *b) {
+    return (a->size_ > b->size_) || ((a->size_ == b->size_) && (a->birth_ < b->birth_));
+  });
+  size_t arena_size = 0;
+  std::vector<const MemoryBlock *> placed;
+  for (auto &block : *blocks) {
+    MS_EXCEPTION_IF_NULL(block);
+    std::vector<const MemoryBlock *> overlapped;
+    for (const auto &other : placed) {
+      if ((block->birth_ <= other->death_) && (other->birth_ <= block->death_)) {
+        (void)overlapped.emplace_back(other);
+      }
+    }
+    std::sort(overlapped.begin(), overlapped.end(),
+              [](const MemoryBlock *a, const MemoryBlock *b) { return a->offset_ < b->offset_; });
+    size_t offset = 0;
+    for (const auto &other : overlapped) {
+      if (offset + block->size_ <= other->offset_) {
+        break;
+      }
+      offset = std::max(offset, other->offset_ + other->size_);
+    }
+    block->offset_ = offset;
+    arena_size = std::max(arena_size, offset + block->size_);
+    (void)placed.emplace_back(block);
+  }
+  return arena_size;
+}
+
+void LinearExecutor::Run(const std::vector<std::vector<TensorPtr>> &input_tensors,
+                         OpContext<DeviceTensor> *const context) {
+  MS_EXCEPTION_IF_NULL(context);
+  MS_EXCEPTION_IF_NULL(output_actor_);
+  if (!is_compiled_) {
+    Compile();
+  }
+
+  PrepareData(input_tensors, context);
+  if (!context->error_info_.empty()) {
+    MS_LOG(EXCEPTION) << context->error_info_;
+  }
+  if ((!is_memory_planned_) || (!IsMemoryPlanValid())) {
+    PlanMemory();
+  }
+
+  try {
+    for (const auto &instruction : instructions_) {
+      Launch(instruction, context);
+      // The failure is recorded in the context, and the step stops at the failed kernel.
+      if (!context->error_info_.empty()) {
+        MS_LOG(EXCEPTION) << context->error_info_;
+      }
+    }
+  } catch (...) {
+    ReleasePlannedMemory();
+    throw;
+  }
+
+  // Finish the step as the loop count actor does.
+  output_actor_->RunOpControl(nullptr, context);
+  if (!context->error_info_.empty()) {
+    MS_LOG(EXCEPTION) << context->error_info_;
+  }
+}
+
+void LinearExecutor::Compile() {
+  MS_EXCEPTION_IF_NULL(output_actor_);
+  const auto &output_actor_name = output_actor_->GetAID().Name();
+  // The output data of the upstream actors by the name of receiving actor.
+  mindspore::HashMap<std::string, std::vector<OpData<DeviceTensor> *>> actor_name_to_input_data;
+  if (host_data_source_actor_ != nullptr) {
+    for (const auto &output_data : host_data_source_actor_->output_data_) {
+      MS_EXCEPTION_IF_NULL(output_data);
+      if (output_data->op_id_.Name() == output_actor_name) {
+        (void)host_graph_outputs_.emplace_back(output_data.get());
+      } else {
+        (void)actor_name_to_input_data[output_data->op_id_.Name()].emplace_back(output_data.get());
+      }
+    }
+  }
+  for (const auto &kernel_actor : kernel_actors_) {
+    MS_EXCEPTION_IF_NULL(kernel_actor);
+    for (const auto &output_data : kernel_actor->output_data_) {
+      MS_EXCEPTION_IF_NULL(output_data);
+      (void)actor_name_to_input_data[output_data->op_id_.Name()].emplace_back(output_data.get());
+    }
+  }
+
+  instructions_.resize(kernel_actors_.size());
+  for (size_t i = 0; i < kernel_actors_.size(); ++i) {
+    const auto &kernel_actor = kernel_actors_[i];
+    auto &instruction = instructions_[i];
+    instruction.kernel_actor_ = kernel_actor.get();
+    instruction.inputs_ = actor_name_to_input_data[kernel_actor->GetAID().Name()];
+    for (const auto &output_data : kernel_actor->output_data_) {
+      if (output_data->op_id_.Name() == output_actor_name) {
+        (void)instruction.graph_outputs_.emplace_back(output_data.get());
+      }
+    }
+
+    // Each input of kernel comes from either the upstream actor or the device tensor store.
+    for (const auto &input_data : instruction.inputs_) {
+      if (IntToSize(input_data->index_) >= kernel_actor->real_input_num_) {
+        MS_LOG(EXCEPTION) << "The input index is out of range: " << kernel_actor->GetAID().Name();
+      }
+    }
+    if ((instruction.inputs_.size() != kernel_actor->input_datas_num_) ||
+        (instruction.inputs_.size() + kernel_actor->device_tensor_store_keys_.size() !=
+         kernel_actor->real_input_num_)) {
+      MS_LOG(EXCEPTION) << "The inputs of " << kernel_actor->GetAID().Name()
+                        << " can't be bound in the linear execution, input data num: " << instruction.inputs_.size()
+                        << ", device tensor store num: " << kernel_actor->device_tensor_store_keys_.size()
+                        << ", real input num: " << kernel_actor->real_input_num_;
+    }
+  }
+  is_compiled_ = true;
+  MS_LOG(INFO) << "Linear executor compiles " << instructions_.size() << " instructions.";
+}
+
+void LinearExecutor::PrepareData(const std::vector<std::vector<TensorPtr>> &input_tensors,
+                                 OpContext<DeviceTensor> *const context) {
+  MS_EXCEPTION_IF_NULL(data_prepare_actor_);
+  MS_EXCEPTION_IF_NULL(device_context_);
+  if (input_tensors.size() > 0) {
+    data_prepare_actor_->PrepareDataForDeviceTensorStore(input_tensors, context);
+    data_prepare_actor_->PrepareDataForHostTensorQueue(input_tensors, context);
+  }
+  if (!context->error_info_.empty()) {
+    MS_LOG(EXCEPTION) << context->error_info_;
+  }
+  if (host_data_source_actor_ == nullptr) {
+    return;
+  }
+
+  // Fetch the host data as the host data source actor does, but allocate the memory inline.
+  auto &buffers = host_data_source_actor_->buffers_;
+  if (!buffers.empty()) {
+    buffers.pop();
+  }
+  host_data_source_actor_->FillDataBuffer();
+  for (auto &device_tensor : buffers.back()) {
+    MS_EXCEPTION_IF_NULL(device_tensor);
+    if (device_tensor->GetPtr() != nullptr) {
+      continue;
+    }
+    if (!device_context_->AllocateMemory(device_tensor, device_tensor->GetSize())) {
+      SET_OPCONTEXT_MEMORY_ALLOC_FAIL_BY_STRATEGY(GraphExecutionStrategy::kPipeline, *context, *device_context_,
+                                                  host_data_source_actor_->GetAID().Name(), device_tensor->GetSize());
+    }
+  }
+  host_data_source_actor_->CopyHostTensorsToDevice(context);
+  if (!context->error_info_.empty()) {
+    return;
+  }
+
+  const auto &output_data_arrows = host_data_source_actor_->output_data_arrows_;
+  const auto &output_data_nodes = host_data_source_actor_->output_data_nodes_;
+  for (size_t i = 0; i < host_data_source_actor_->output_data_.size(); ++i) {
+    host_data_source_actor_->UpdateOutputData(host_data_source_actor_->output_data_[i].get(), output_data_arrows[i],
+                                              output_data_nodes[i], context);
+  }
+  for (const auto &output_data : host_graph_outputs_) {
+    output_actor_->RunOpData(output_data, context);
+  }
+}
+
+void LinearExecutor::PlanMemory() {
+  MS_EXCEPTION_IF_NULL(device_context_);
+  // The device tensors of graph output are moved to the output tensors in the end of step and can't be planned.
+  std::set<const DeviceTensor *> graph_output_device_tensors;
+  for (const auto &output_data : host_graph_outputs_) {
+    (void)graph_output_device_tensors.insert(output_data->data_);
+  }
+  for (auto &instruction : instructions_) {
+    MS_EXCEPTION_IF_NULL(instruction.kernel_actor_);
+    // Fetch the output device tensors of this step in advance, which also updates the output data.
+    instruction.kernel_actor_->FetchOutputDeviceTensor();
+    for (const auto &output_data : instruction.graph_outputs_) {
+      (void)graph_output_device_tensors.insert(output_data->data_);
+    }
+  }
+
+  // Simulate the memory alloc and free of the instruction stream to get the liveness of device tensors. The device
+  // tensor can be planned if it is born in the stream and its reference count is decreased to zero in the stream.
+  mindspore::HashMap<const DeviceTensor *, DeviceTensorLife> lives;
+  std::vector<std::vector<DeviceTensor *>> free_lists(instructions_.size());
+  for (size_t i = 0; i < instructions_.size(); ++i) {
+    auto kernel_actor = instructions_[i].kernel_actor_;
+    auto &free_list = free_lists[i];
+    free_list = kernel_actor->memory_free_list_;
+    for (const auto &input_data : instructions_[i].inputs_) {
+      free_list[IntToSize(input_data->index_)] = input_data->data_;
+    }
+    for (const auto &device_tensor_store_key : kernel_actor->device_tensor_store_keys_) {
+      free_list[device_tensor_store_key.first] = nullptr;
+    }
+
+    for (size_t j = 0; j < kernel_actor->real_input_num_; ++j) {
+      if (free_list[j] == nullptr) {
+        continue;
+      }
+      auto iter = lives.find(free_list[j]);
+      if (iter == lives.end()) {
+        lives[free_list[j]] = DeviceTensorLife();
+      } else if (!iter->second.is_alive_) {
+        iter->second.is_plannable_ = false;
+      }
+    }
+
+    const auto &alloc_list = kernel_actor->memory_alloc_list_;
+    for (size_t j = 0; j < alloc_list.size(); ++j) {
+      auto device_tensor = alloc_list[j];
+      MS_EXCEPTION_IF_NULL(device_tensor);
+      auto iter = lives.find(device_tensor);
+      if (iter != lives.end()) {
+        if (!iter->second.is_alive_) {
+          iter->second.is_plannable_ = false;
+        }
+        continue;
+      }
+      auto &life = lives[device_tensor];
+      life.birth_ = i;
+      life.alloc_index_ = j;
+      life.ref_count_ = device_tensor->original_ref_count();
+      life.is_alive_ = true;
+      life.is_plannable_ = (device_tensor->original_ref_count() != SIZE_MAX) &&
+                           (device_tensor->dynamic_ref_count() == INT32_MAX) && (!device_tensor->is_ptr_persisted()) &&
+                           (device_tensor->GetPtr() == nullptr) && (device_tensor->GetSize() > 0) &&
+                           (graph_output_device_tensors.count(device_tensor) == 0);
+    }
+
+    for (size_t j = 0; j < free_list.size(); ++j) {
+      if (free_list[j] == nullptr) {
+        continue;
+      }
+      auto &life = lives[free_list[j]];
+      if ((!life.is_plannable_) || (!life.is_alive_)) {
+        continue;
+      }
+      if (life.ref_count_ == 0) {
+        life.is_plannable_ = false;
+        continue;
+      }
+      if (--life.ref_count_ == 0) {
+        life.death_ = i;
+        life.free_index_ = j;
+        life.is_alive_ = false;
+      }
+    }
+  }
+
+  // Place the planned device tensors in the arena.
+  std::vector<DeviceTensorLife *> planned_lives;
+  size_t planned_size = 0;
+  for (auto &item : lives) {
+    auto &life = item.second;
+    if ((!life.is_plannable_) || life.is_alive_) {
+      life.is_plannable_ = false;
+      continue;
+    }
+    life.size_ = AlignMemorySize(item.first->GetSize());
+    planned_size += life.size_;
+    (void)planned_lives.emplace_back(&life);
+  }
+  std::vector<MemoryBlock *> planned_blocks(planned_lives.begin(), planned_lives.end());
+  auto arena_size = AssignOffsets(&planned_blocks);
+
+  arena_ = nullptr;
+  if (arena_size > 0) {
+    arena_ = device_context_->CreateDeviceAddress(nullptr, arena_size, kOpFormat_DEFAULT, kNumberTypeUInt8);
+    MS_EXCEPTION_IF_NULL(arena_);
+    if (!device_context_->AllocateMemory(arena_.get(), arena_size)) {
+      MS_LOG(WARNING) << "Allocate the arena of linear execution failed, size: " << arena_size
+                      << ", the memory is allocated dynamically.";
+      arena_ = nullptr;
+      for (auto &life : planned_lives) {
+        life->is_plannable_ = false;
+      }
+    }
+  }
+
+  // Split the alloc and free list of each instruction into the planned part and the dynamic part.
+  planned_tensors_.clear();
+  for (size_t i = 0; i < instructions_.size(); ++i) {
+    auto &instruction = instructions_[i];
+    auto kernel_actor = instruction.kernel_actor_;
+    instruction.planned_allocs_.clear();
+    instruction.dynamic_allocs_.clear();
+    instruction.planned_frees_.clear();
+    instruction.dynamic_frees_.clear();
+    const auto &alloc_list = kernel_actor->memory_alloc_list_;
+    for (size_t j = 0; j < alloc_list.size(); ++j) {
+      const auto &life = lives[alloc_list[j]];
+      if (life.is_plannable_ && (life.birth_ == i) && (life.alloc_index_ == j)) {
+        (void)instruction.planned_allocs_.emplace_back(j, life.offset_);
+        (void)planned_tensors_.emplace_back(PlannedTensor{alloc_list[j], i, j});
+      } else {
+        (void)instruction.dynamic_allocs_.emplace_back(j);
+      }
+    }
+
+    const auto &free_list = free_lists[i];
+    for (size_t j = 0; j < free_list.size(); ++j) {
+      if (free_list[j] == nullptr) {
+        (void)instruction.dynamic_frees_.emplace_back(j);
+        continue;
+      }
+      const auto &life = lives[free_list[j]];
+      if (!life.is_plannable_) {
+        (void)instruction.dynamic_frees_.emplace_back(j);
+      } else if ((life.death_ == i) && (life.free_index_ == j)) {
+        (void)instruction.planned_frees_.emplace_back(j);
+      }
+    }
+  }
+  is_memory_planned_ = true;
+  MS_LOG(INFO) << "Linear executor plans " << planned_tensors_.size() << " device tensors of size " << planned_size
+               << " in the arena of size " << arena_size << ".";
+}
+
+bool LinearExecutor::IsMemoryPlanValid() const {
+  for (const auto &planned_tensor : planned_tensors_) {
+    const auto &kernel_actor = instructions_[planned_tensor.instruction_index_].kernel_actor_;
+    const auto &kernel_info = kernel_actor->kernel_info_;
+    MS_EXCEPTION_IF_NULL(kernel_info);
+    const auto &output_addresses = kernel_info->output_address_list();
+    const auto &workspace_addresses = kernel_info->workspace_address_list();
+    auto alloc_index = planned_tensor.alloc_index_;
+    auto device_tensor = (alloc_index < output_addresses.size())
+                           ? output_addresses[alloc_index].get()
+                           : workspace_addresses.at(alloc_index - output_addresses.size()).get();
+    if (device_tensor != planned_tensor.device_tensor_) {
+      MS_LOG(INFO) << "The device tensor of " << kernel_actor->GetAID().Name()
+                   << " is replaced, plan the memory again.";
+      return false;
+    }
+  }
+  return true;
+}
+
+void LinearExecutor::ReleasePlannedMemory() {
+  if (arena_ == nullptr) {
+    return;
+  }
+  auto arena_begin = static_cast<uint8_t *>(arena_->GetMutablePtr());
+  auto arena_end = arena_begin + arena_->GetSize();
+  for (auto &planned_tensor : planned_tensors_) {
+    auto ptr = static_cast<uint8_t *>(planned_tensor.device_tensor_->GetMutablePtr());
+    if ((ptr >= arena_begin) && (ptr < arena_end)) {
+      planned_tensor.device_tensor_->set_ptr(nullptr);
+    }
+  }
+}
+
+void LinearExecutor::Launch(const LinearInstruction &instruction, OpContext<DeviceTensor> *const context) {
+  auto kernel_actor = instruction.kernel_actor_;
+  MS_EXCEPTION_IF_NULL(kernel_actor);
+  const auto &kernel = kernel_actor->kernel_;
+  MS_EXCEPTION_IF_NULL(kernel);
+
+  // Bind the inputs as the input data of actor does.
+  for (const auto &input_data : instruction.inputs_) {
+    auto index = IntToSize(input_data->index_);
+    kernel_actor->input_device_tensors_[index] = input_data->data_;
+    kernel_actor->memory_free_list_[index] = input_data->data_;
+  }
+  kernel_actor->FetchInputDeviceTensor(context);
+  if (!context->error_info_.empty()) {
+    return;
+  }
+  kernel_actor->FetchOutputDeviceTensor();
+
+  const auto &alloc_list = kernel_actor->memory_alloc_list_;
+  auto arena_ptr = (arena_ != nullptr) ? static_cast<uint8_t *>(arena_->GetMutablePtr()) : nullptr;
+  for (const auto &planned_alloc : instruction.planned_allocs_) {
+    auto device_tensor = alloc_list[planned_alloc.first];
+    device_tensor->set_ptr(arena_ptr + planned_alloc.second);
+    device_tensor->set_from_mem_pool(false);
+  }
+  for (const auto &index : instruction.dynamic_allocs_) {
+    auto device_tensor = alloc_list[index];
+    if (device_tensor->GetPtr() != nullptr) {
+      continue;
+    }
+    if (!device_context_->AllocateMemory(device_tensor, device_tensor->GetSize())) {
+      SET_OPCONTEXT_MEMORY_ALLOC_FAIL_BY_STRATEGY(GraphExecutionStrategy::kPipeline, *context, *device_context_,
+                                                  kernel_actor->GetAID().Name(), device_tensor->GetSize());
+    }
+  }
+
+  kernel_actor->PreLaunchKernel(context);
+  if (!context->error_info_.empty()) {
+    return;
+  }
+  const auto &launch_info = kernel_actor->launch_info_;
+  if (!device_context_->LaunchKernel(kernel, launch_info.inputs_, launch_info.workspaces_, launch_info.outputs_)) {
+    MS_LOG(EXCEPTION) << "Launch kernel failed: " << kernel->fullname_with_scope();
+  }
+
+  // Free the memory before sending the graph outputs as the kernel actor does.
+  const auto &free_list = kernel_actor->memory_free_list_;
+  for (const auto &index : instruction.planned_frees_) {
+    free_list[index]->set_ptr(nullptr);
+  }
+  for (const auto &index : instruction.dynamic_frees_) {
+    FreeMemoryByRefCount(free_list[index], device_context_, kernel_actor->GetAID().Name());
+  }
+  for (const auto &output_data : instruction.graph_outputs_) {
+    output_actor_->RunOpData(output_data, context);
+  }
+}
+}  // namespace runtime
+}  // namespace mindspore
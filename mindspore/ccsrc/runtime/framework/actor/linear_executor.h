@@ -0,0 +1,131 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_ACTOR_LINEAR_EXECUTOR_H_
+#define MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_ACTOR_LINEAR_EXECUTOR_H_
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include "runtime/framework/actor/actor_common.h"
+#include "runtime/framework/actor/data_prepare_actor.h"
+#include "runtime/framework/actor/data_source_actor.h"
+#include "runtime/framework/actor/kernel_actor.h"
+#include "runtime/framework/actor/output_actor.h"
+#include "runtime/hardware/device_context.h"
+#include "ir/tensor.h"
+
+namespace mindspore {
+namespace runtime {
+using mindspore::device::DeviceContext;
+using mindspore::tensor::TensorPtr;
+
+// The linear executor is the alternative of the actor pipeline for the small graphs whose running time is dominated by
+// the actor scheduling. It runs the kernels of actor set one by one in the topological order on the calling thread, as
+// a flat instruction stream built from the actors: the inputs of instruction are bound to the output data of upstream
+// actors, the memory is allocated and freed inline without the memory manager actor, and the outputs and workspaces
+// whose lifetime ends in the step are placed in a static arena planned by the liveness of device tensors.
+class LinearExecutor {
+ public:
+  // The kernel actors must be in the topological order.
+  LinearExecutor(const DataPrepareActorPtr &data_prepare_actor, const HostQueueDSActorPtr &host_data_source_actor,
+                 const std::vector<KernelActorPtr> &kernel_actors, const OutputActorPtr &output_actor,
+                 const DeviceContext *device_context)
+      : data_prepare_actor_(data_prepare_actor),
+        host_data_source_actor_(host_data_source_actor),
+        kernel_actors_(kernel_actors),
+        output_actor_(output_actor),
+        device_context_(device_context) {}
+  ~LinearExecutor() = default;
+
+  // Run one step, throw exception when failed.
+  void Run(const std::vector<std::vector<TensorPtr>> &input_tensors, OpContext<DeviceTensor> *const context);
+
+  // The memory block alive from the birth instruction to the death instruction, and its aligned size and offset in the
+  // arena.
+  struct MemoryBlock {
+    size_t birth_{0};
+    size_t death_{0};
+    size_t size_{0};
+    size_t offset_{0};
+  };
+  // Place the blocks in the arena by the first fit in the decreasing order of size, the blocks whose lifetimes overlap
+  // can't overlap in the arena. Return the size of arena.
+  static size_t AssignOffsets(std::vector<MemoryBlock *> *blocks);
+
+  // The executions following the single thread execution statistics are statistics of linear execution time.
+  static constexpr size_t kLinearExecutionCountBegin{51};
+  static constexpr size_t kLinearExecutionCountEnd{60};
+
+ private:
+  // The instruction of launching one kernel.
+  struct LinearInstruction {
+    KernelActor *kernel_actor_{nullptr};
+    // The input data of kernel from the upstream actors.
+    std::vector<OpData<DeviceTensor> *> inputs_;
+    // The output data of kernel to the output actor.
+    std::vector<OpData<DeviceTensor> *> graph_outputs_;
+    // The index of memory alloc list which is allocated from the arena and the offset in the arena.
+    std::vector<std::pair<size_t, size_t>> planned_allocs_;
+    // The index of memory alloc list which is allocated by the device context.
+    std::vector<size_t> dynamic_allocs_;
+    // The index of memory free list whose planned memory is released after the kernel launch.
+    std::vector<size_t> planned_frees_;
+    // The index of memory free list which is freed by the reference count.
+    std::vector<size_t> dynamic_frees_;
+  };
+
+  // The device tensor allocated from the arena, which is the alloc index of the instruction.
+  struct PlannedTensor {
+    DeviceTensor *device_tensor_{nullptr};
+    size_t instruction_index_{0};
+    size_t alloc_index_{0};
+  };
+
+  // Build the instructions from the actors, which need the output data created by the actor init.
+  void Compile();
+  // Plan the memory of instructions by the device tensors fetched in the current step.
+  void PlanMemory();
+  // The device tensors of kernel may be replaced between steps, then the memory needs to be planned again.
+  bool IsMemoryPlanValid() const;
+  // Detach the planned device tensors from the arena when the step is interrupted.
+  void ReleasePlannedMemory();
+
+  void PrepareData(const std::vector<std::vector<TensorPtr>> &input_tensors, OpContext<DeviceTensor> *const context);
+  void Launch(const LinearInstruction &instruction, OpContext<DeviceTensor> *const context);
+
+  DataPrepareActorPtr data_prepare_actor_;
+  HostQueueDSActorPtr host_data_source_actor_;
+  std::vector<KernelActorPtr> kernel_actors_;
+  OutputActorPtr output_actor_;
+  const DeviceContext *device_context_;
+
+  bool is_compiled_{false};
+  std::vector<LinearInstruction> instructions_;
+  // The output data of host data source actor to the output actor.
+  std::vector<OpData<DeviceTensor> *> host_graph_outputs_;
+
+  // The static arena of the planned memory.
+  bool is_memory_planned_{false};
+  DeviceTensorPtr arena_{nullptr};
+  std::vector<PlannedTensor> planned_tensors_;
+};
+
+using LinearExecutorPtr = std::shared_ptr<LinearExecutor>;
+}  // namespace runtime
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_ACTOR_LINEAR_EXECUTOR_H_
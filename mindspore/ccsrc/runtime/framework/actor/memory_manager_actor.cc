@@ -15,10 +15,13 @@
  */
 
 #include "runtime/framework/actor/memory_manager_actor.h"
+#include <atomic>
+#include <climits>
 #include "runtime/framework/actor/data_source_actor.h"
 #include "runtime/framework/actor/kernel_actor.h"
 #include "runtime/hardware/device_context_manager.h"
 #include "mindrt/include/async/async.h"
+#include "mindrt/include/actor/actor_trace.h"
 #include "utils/log_adapter.h"
 
 namespace mindspore {
@@ -36,14 +39,15 @@ void FreeMemoryInner(DeviceTensor *const device_tensor, const DeviceContext *dev
     device_context->FreeMemory(device_tensor);
   }
 }
+}  // namespace
 
 // Only one of the static and dynamic reference counts will take effect.
-void FreeMemoryByRefCount(DeviceTensor *const device_tensor, const DeviceContext *device_context, const AID &from_aid) {
+void FreeMemoryByRefCount(DeviceTensor *const device_tensor, const DeviceContext *device_context,
+                          const std::string &op_name) {
   MS_EXCEPTION_IF_NULL(device_tensor);
   if (device_tensor->original_ref_count() != SIZE_MAX) {
     // The static reference count is decremented to zero to free memory, and reset to the original count.
-    device_tensor->DecreaseRefCount();
-    if (device_tensor->ref_count() == 0) {
+    if (device_tensor->DecreaseRefCount() == 0) {
       if (device_tensor->GetPtr() != nullptr) {
         FreeMemoryInner(device_tensor, device_context);
       }
@@ -51,14 +55,12 @@ void FreeMemoryByRefCount(DeviceTensor *const device_tensor, const DeviceContext
     }
   } else if (device_tensor->dynamic_ref_count() != INT32_MAX) {
     // The dynamic reference count is decremented to zero to free memory.
-    device_tensor->DecreaseDynamicRefCount(from_aid.Name());
-    if ((device_tensor->dynamic_ref_count() == 0) && (device_tensor->GetPtr() != nullptr)) {
+    if ((device_tensor->DecreaseDynamicRefCount(op_name) == 0) && (device_tensor->GetPtr() != nullptr)) {
       MS_LOG(DEBUG) << "Free memory by the dynamic reference count, device address" << device_tensor->GetPtr();
       FreeMemoryInner(device_tensor, device_context);
     }
   }
 }
-}  // namespace
 
 void MemoryManagerActor::AllocateMemory(const std::vector<DeviceTensor *> *alloc_list,
                                         const DeviceContext *device_context, OpContext<DeviceTensor> *const op_context,
@@ -66,6 +68,7 @@ void MemoryManagerActor::AllocateMemory(const std::vector<DeviceTensor *> *alloc
   MS_EXCEPTION_IF_NULL(alloc_list);
   MS_EXCEPTION_IF_NULL(device_context);
   MS_EXCEPTION_IF_NULL(op_context);
+  ActorTraceScope trace_scope(ActorTraceEventType::kMemoryAlloc, from_aid.Name());
 
   for (auto &device_tensor : *alloc_list) {
     MS_EXCEPTION_IF_NULL(device_tensor);
@@ -97,6 +100,7 @@ void MemoryManagerActor::AllocateContinuousMemory(const std::vector<std::vector<
   MS_EXCEPTION_IF_NULL(total_size_list);
   MS_EXCEPTION_IF_NULL(device_contexts);
   MS_EXCEPTION_IF_NULL(op_context);
+  ActorTraceScope trace_scope(ActorTraceEventType::kMemoryAlloc, from_aid.Name());
   if (((*alloc_list_list).size() != (*size_list_list).size()) ||
       ((*size_list_list).size() != (*total_size_list).size()) ||
       ((*total_size_list).size() != (*device_contexts).size())) {
@@ -127,6 +131,7 @@ void MemoryManagerActor::AllocateBatchMemory(const std::vector<DeviceTensor *> *
   MS_EXCEPTION_IF_NULL(alloc_list);
   MS_EXCEPTION_IF_NULL(device_contexts);
   MS_EXCEPTION_IF_NULL(op_context);
+  ActorTraceScope trace_scope(ActorTraceEventType::kMemoryAlloc, from_aid.Name());
   if ((*alloc_list).size() != (*device_contexts).size()) {
     SET_OPCONTEXT_FAIL_RET_WITH_ERROR((*op_context),
                                       "The size of alloc list is not equal to the size of device contexts.");
@@ -159,8 +164,9 @@ void MemoryManagerActor::AllocateBatchMemory(const std::vector<DeviceTensor *> *
 void MemoryManagerActor::FreeMemory(const std::vector<DeviceTensor *> *free_list, const DeviceContext *device_context,
                                     OpContext<DeviceTensor> *, const AID &from_aid) {
   MS_EXCEPTION_IF_NULL(free_list);
+  ActorTraceScope trace_scope(ActorTraceEventType::kMemoryFree, from_aid.Name());
   for (auto &device_tensor : *free_list) {
-    FreeMemoryByRefCount(device_tensor, device_context, from_aid);
+    FreeMemoryByRefCount(device_tensor, device_context, from_aid.Name());
   }
 }
 
@@ -170,6 +176,7 @@ void MemoryManagerActor::FreeBatchMemory(const std::vector<DeviceTensor *> *free
   MS_EXCEPTION_IF_NULL(free_list);
   MS_EXCEPTION_IF_NULL(device_contexts);
   MS_EXCEPTION_IF_NULL(op_context);
+  ActorTraceScope trace_scope(ActorTraceEventType::kMemoryFree, from_aid.Name());
   if ((*free_list).size() != (*device_contexts).size()) {
     SET_OPCONTEXT_FAIL_RET_WITH_ERROR((*op_context),
                                       "The size of free list is not equal to the size of device contexts.");
@@ -178,7 +185,7 @@ void MemoryManagerActor::FreeBatchMemory(const std::vector<DeviceTensor *> *free
   for (size_t i = 0; i < (*free_list).size(); ++i) {
     auto &device_tensor = (*free_list)[i];
     auto &device_context = (*device_contexts)[i];
-    FreeMemoryByRefCount(device_tensor, device_context, from_aid);
+    FreeMemoryByRefCount(device_tensor, device_context, from_aid.Name());
   }
 }
 
@@ -187,19 +194,21 @@ void MemoryManagerActor::Wait(OpContext<DeviceTensor> *const op_context, const A
   ActorDispatcher::Send(from_aid, &MemoryAwareActor::OnMemoryAllocFinish, op_context);
 }
 
-void MemoryManagerActor::SetOpContextMemoryAllocFail(const std::string &kernel_name,
-                                                     const DeviceContext *device_context, size_t alloc_size,
-                                                     OpContext<DeviceTensor> *const op_context) {
+void SetOpContextMemoryAllocFail(const std::string &kernel_name, const DeviceContext *device_context, size_t alloc_size,
+                                 OpContext<DeviceTensor> *const op_context) {
   MS_EXCEPTION_IF_NULL(device_context);
   MS_EXCEPTION_IF_NULL(op_context);
 
-  int step_id = op_context->sequential_num_;
+  // The uuid of the last batch which has failed, the actors which allocate memory by themselves may fail concurrently.
+  static std::atomic<int64_t> mem_alloc_failed_step_id{INT64_MIN};
+  int64_t step_id = op_context->sequential_num_;
+  auto failed_step_id = mem_alloc_failed_step_id.load();
   // First occur allocating memory failed.
-  if (mem_alloc_failed_step_ids_.find(step_id) == mem_alloc_failed_step_ids_.end()) {
-    mem_alloc_failed_step_ids_.clear();
-    (void)mem_alloc_failed_step_ids_.insert(step_id);
-    SET_OPCONTEXT_MEMORY_ALLOC_FAIL_BY_STRATEGY(GraphExecutionStrategy::kPipeline, *op_context, *device_context,
-                                                kernel_name, alloc_size);
+  while (failed_step_id != step_id) {
+    if (mem_alloc_failed_step_id.compare_exchange_weak(failed_step_id, step_id)) {
+      SET_OPCONTEXT_MEMORY_ALLOC_FAIL_BY_STRATEGY(GraphExecutionStrategy::kPipeline, *op_context, *device_context,
+                                                  kernel_name, alloc_size);
+    }
   }
 }
 }  // namespace runtime
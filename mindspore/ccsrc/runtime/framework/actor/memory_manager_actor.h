@@ -20,7 +20,6 @@
 #include <vector>
 #include <memory>
 #include <string>
-#include <set>
 #include "utils/hash_map.h"
 #include "runtime/framework/actor/actor_common.h"
 #include "runtime/framework/device_tensor_store.h"
@@ -61,17 +60,19 @@ class MemoryManagerActor : public ActorBase {
 
   // Wait the MemoryManagerActor to finish running all current messages.
   void Wait(OpContext<DeviceTensor> *const op_context, const AID &from_aid);
+};
 
- private:
-  // When allocate device memory fail, print error log and set op context failed status.
-  void SetOpContextMemoryAllocFail(const std::string &kernel_name, const DeviceContext *device_context,
-                                   size_t alloc_size, OpContext<DeviceTensor> *const op_context);
+// Decrease the reference count of device tensor and free the memory when the count is decreased to zero, the op name is
+// used by the dynamic reference count.
+void FreeMemoryByRefCount(DeviceTensor *const device_tensor, const DeviceContext *device_context,
+                          const std::string &op_name);
 
-  // MemoryManagerActor object is used like a single instance, if one actor allocates memory failed in one batch, which
-  // will set fail message info OpContext, major thread will destroy the OpContext object, subsequent actor can not set
-  // fail message again, so we record allocating memory fail event by the uuid of the batch, which is key of the set.
-  std::set<int> mem_alloc_failed_step_ids_;
-};
+// When allocate device memory fail, print error log and set op context failed status. The memory is allocated by the
+// MemoryManagerActor and the actors which allocate memory by themselves, if one actor allocates memory failed in one
+// batch, which will set fail message info OpContext, major thread will destroy the OpContext object, subsequent actor
+// can not set fail message again, so we record allocating memory fail event by the uuid of the batch.
+void SetOpContextMemoryAllocFail(const std::string &kernel_name, const DeviceContext *device_context, size_t alloc_size,
+                                 OpContext<DeviceTensor> *const op_context);
 }  // namespace runtime
 }  // namespace mindspore
 
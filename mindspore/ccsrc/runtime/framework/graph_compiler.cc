@@ -538,6 +538,28 @@ GraphId GraphCompiler::CompileGraph(const session::OpRunInfo &op_run_info, bool
   return graph->graph_id();
 }
 
+KernelGraphPtr GraphCompiler::CompileOpSequenceGraph(
+  const std::vector<session::OpRunInfo> &op_run_infos,
+  const std::vector<std::vector<session::OpSequenceInput>> &op_inputs, const DeviceContext *device_context) const {
+  MS_EXCEPTION_IF_NULL(session_);
+  MS_EXCEPTION_IF_NULL(device_context);
+  auto graph = session_->ConstructOpSequenceGraph(op_run_infos, op_inputs);
+  MS_EXCEPTION_IF_NULL(graph);
+
+  device_context->UnifyMindIR(graph);
+  device_context->OptimizeSingleOpGraph(graph);
+
+  CreateDeviceAddressWithoutWorkspace(graph, device_context, false);
+  graph->set_is_all_nop_node(opt::IsAllNopNode(graph.get()));
+
+  // Every output of the ops is returned to python, so the outputs can't be freed in the graph running.
+  UpdateRefCountForGraphOutput(AnfAlgo::GetAllOutputWithIndex(graph->output()));
+  AnfAlgo::UpdateGraphValidRefPair(graph);
+
+  BuildSingleOpGraphs({graph}, device_context);
+  return graph;
+}
+
 void GraphCompiler::BuildSingleOpGraphs(const std::vector<KernelGraphPtr> &graphs,
                                         const DeviceContext *device_context) const {
   MS_EXCEPTION_IF_NULL(device_context);
@@ -108,6 +108,12 @@ class GraphCompiler {
   GraphId CompileGraph(const session::OpRunInfo &op_run_info, bool *single_op_cache_hit,
                        const DeviceContext *device_context);
 
+  // Construct the kernel graph of the op sequence which repeats in PyNative mode and build it, the graph isn't cached
+  // by the graph id or graph info and is owned by the caller.
+  KernelGraphPtr CompileOpSequenceGraph(const std::vector<session::OpRunInfo> &op_run_infos,
+                                        const std::vector<std::vector<session::OpSequenceInput>> &op_inputs,
+                                        const DeviceContext *device_context) const;
+
   // Create kernel and Create workspace for graphs in PyNative mode.
   void BuildSingleOpGraphs(const std::vector<KernelGraphPtr> &graphs, const DeviceContext *device_context) const;
 
@@ -21,6 +21,7 @@
 #include "runtime/hardware/device_context_manager.h"
 #include "mindrt/src/actor/actormgr.h"
 #include "mindrt/include/async/async.h"
+#include "mindrt/include/actor/actor_trace.h"
 #include "backend/session/anf_runtime_algorithm.h"
 #include "backend/optimizer/common/helper.h"
 #include "utils/config_manager.h"
@@ -47,6 +48,11 @@
 namespace mindspore {
 namespace runtime {
 namespace {
+// The kernel actors record the launch costs in these executions to set the actor priority, the first execution is for
+// warm-up.
+constexpr size_t kActorPriorityProfileCountBegin = 2;
+constexpr size_t kActorPriorityProfileCountEnd = 4;
+
 bool IsNeedInsertCopyActor(const DeviceContext *from_device_context, const DeviceContext *to_device_context) {
   MS_EXCEPTION_IF_NULL(from_device_context);
   MS_EXCEPTION_IF_NULL(to_device_context);
@@ -184,6 +190,7 @@ void GraphScheduler::Clear(const ActorInfo &actor_info, const std::vector<Kernel
       return;
     }
     auto actor_set = actors_[actor_info];
+    ReportInferCacheStatistics(actor_set.get());
     auto base_actors = CollectActors(actor_set.get());
     for (auto &base_actor : base_actors) {
       MS_EXCEPTION_IF_NULL(base_actor);
@@ -207,6 +214,13 @@ void GraphScheduler::Clear() {
   MS_EXCEPTION_IF_NULL(actor_manager);
   actor_manager->Finalize();
 
+  // Export the actor trace after the actor threads finish, so the trace buffers aren't written any more.
+  auto &actor_trace = ActorTrace::GetInstance();
+  if (actor_trace.HasEvents()) {
+    auto trace_path = common::GetEnv("MS_DEV_ACTOR_TRACE_PATH");
+    (void)actor_trace.ExportChromeTrace(trace_path.empty() ? "./actor_trace.json" : trace_path);
+  }
+
   // Clear the member of DeviceTensorStore.
   DeviceTensorStore::GetInstance().Clear();
 
@@ -264,6 +278,9 @@ void GraphScheduler::Initialize() {
                << ", the kernel thread number: " << (actor_and_kernel_thread_num - actor_thread_num)
                << ", the used OMP thread number: " << OMP_thread_num_used;
 
+  // The memory allocation in the kernel actors can be turned off to allocate all the memory by the MemoryManagerActor.
+  ActorDispatcher::is_memory_allocation_sync(common::GetEnv("MS_DEV_DISABLE_SYNC_MEMORY_ALLOC") != "1");
+
   BuildAndScheduleGlobalActor();
 }
 
@@ -324,6 +341,8 @@ ActorSet *GraphScheduler::Transform(const GraphCompilerInfo &graph_compiler_info
   DumpActor(actor_set.get(), graph_compiler_info);
   if (graph_compiler_info.strategy_ == GraphExecutionStrategy::kPipeline) {
     CheckActorValid(actor_set.get());
+    SetActorPriority(actor_set.get());
+    actor_set->linear_executor_ = BuildLinearExecutor(actor_set.get());
   }
   MS_LOG(INFO) << "Graph(" << graph_compiler_info.name_ << ") transforms actor end.";
 
@@ -367,6 +386,16 @@ void GraphScheduler::Run(ActorSet *const actor_set, const std::vector<DeviceCont
     return;
   }
 
+  const size_t kSecondsToMilliseconds = 1000;
+  if ((strategy == GraphExecutionStrategy::kPipeline) && actor_set->is_linear_execution_) {
+    MS_EXCEPTION_IF_NULL(actor_set->linear_executor_);
+    double start_time = GetTime();
+    actor_set->linear_executor_->Run(input_tensors, &op_context);
+    double end_time = GetTime();
+    SetActorExecutionStrategy(actor_set, strategy, (end_time - start_time) * kSecondsToMilliseconds);
+    return;
+  }
+
   // Trigger data prepare actor running.
   MS_EXCEPTION_IF_NULL(ActorMgr::GetActorMgrRef());
   auto thread_pool = ActorMgr::GetActorMgrRef()->GetActorThreadPool();
@@ -412,8 +441,15 @@ void GraphScheduler::Run(ActorSet *const actor_set, const std::vector<DeviceCont
   }
 
   double end_time = GetTime();
-  const size_t kSecondsToMilliseconds = 1000;
+  if (ActorTrace::GetInstance().enabled()) {
+    MS_LOG(INFO) << "The actor trace summary of actor set " << actor_set->name_ << " in step "
+                 << actor_set->execution_count_ << ": " << ActorTrace::GetInstance().StepSummary();
+  }
+  ReportStepInferCacheStatistics(actor_set);
   SetActorExecutionStrategy(actor_set, strategy, (end_time - start_time) * kSecondsToMilliseconds);
+  if (strategy == GraphExecutionStrategy::kPipeline) {
+    UpdateActorPriority(actor_set);
+  }
 }
 
 void GraphScheduler::SetActorExecutionStrategy(ActorSet *const actor_set, GraphExecutionStrategy strategy,
@@ -422,7 +458,8 @@ void GraphScheduler::SetActorExecutionStrategy(ActorSet *const actor_set, GraphE
   MS_EXCEPTION_IF_NULL(actor_set->loop_count_actor_);
   ++actor_set->execution_count_;
   MS_LOG(DEBUG) << "Execution count: " << actor_set->execution_count_ << ", execution time cost: " << execution_time
-                << " ms in multi thread or not: " << actor_set->is_multi_thread_execution_ << ".";
+                << " ms in multi thread or not: " << actor_set->is_multi_thread_execution_
+                << ", in linear or not: " << actor_set->is_linear_execution_ << ".";
 #if defined(_WIN32) || defined(_WIN64)
   return;
 #endif
@@ -451,7 +488,7 @@ void GraphScheduler::SetActorExecutionStrategy(ActorSet *const actor_set, GraphE
     return;
   }
 
-  if ((!actor_set->is_multi_thread_execution_) &&
+  if ((!actor_set->is_multi_thread_execution_) && (!actor_set->is_linear_execution_) &&
       (actor_set->execution_count_ >= ActorDispatcher::kSingleThreadExecutionCountBegin) &&
       (actor_set->execution_count_ <= ActorDispatcher::kSingleThreadExecutionCountEnd)) {
     actor_set->single_thread_execution_time_ += execution_time;
@@ -464,6 +501,25 @@ void GraphScheduler::SetActorExecutionStrategy(ActorSet *const actor_set, GraphE
                    << " ms, single thread execution time cost: " << actor_set->single_thread_execution_time_
                    << " ms, decide to use multi thread execution or not: " << actor_set->is_multi_thread_execution_
                    << ".";
+      // Go on collecting the statistics of linear execution time.
+      actor_set->is_linear_execution_ = (actor_set->linear_executor_ != nullptr);
+    }
+    return;
+  }
+
+  if ((actor_set->is_linear_execution_) &&
+      (actor_set->execution_count_ >= LinearExecutor::kLinearExecutionCountBegin) &&
+      (actor_set->execution_count_ <= LinearExecutor::kLinearExecutionCountEnd)) {
+    actor_set->linear_execution_time_ += execution_time;
+    if (actor_set->execution_count_ == LinearExecutor::kLinearExecutionCountEnd) {
+      actor_set->linear_execution_time_ /=
+        (LinearExecutor::kLinearExecutionCountEnd - LinearExecutor::kLinearExecutionCountBegin + 1);
+      auto actor_execution_time =
+        std::min(actor_set->multi_thread_execution_time_, actor_set->single_thread_execution_time_);
+      actor_set->is_linear_execution_ = (actor_set->linear_execution_time_ < actor_execution_time) ? true : false;
+      MS_LOG(INFO) << "Linear execution time cost: " << actor_set->linear_execution_time_
+                   << " ms, actor execution time cost: " << actor_execution_time
+                   << " ms, decide to use linear execution or not: " << actor_set->is_linear_execution_ << ".";
     }
     return;
   }
@@ -1746,6 +1802,223 @@ void GraphScheduler::CheckActorValid(const ActorSet *actor_set) const {
   }
 }
 
+void GraphScheduler::SetActorPriority(const ActorSet *actor_set) const {
+  MS_EXCEPTION_IF_NULL(actor_set);
+  auto actors = CollectActors(actor_set);
+  mindspore::HashMap<std::string, AbstractActor *> name_to_actor;
+  for (const auto &actor : actors) {
+    MS_EXCEPTION_IF_NULL(actor);
+    name_to_actor[actor->GetAID().Name()] = actor.get();
+  }
+  auto get_successors = [&name_to_actor](const AbstractActor *actor) {
+    std::vector<AbstractActor *> successors;
+    for (const auto &data_arrow : actor->output_data_arrows()) {
+      MS_EXCEPTION_IF_NULL(data_arrow);
+      auto iter = name_to_actor.find(data_arrow->to_op_id_.Name());
+      if (iter != name_to_actor.end()) {
+        (void)successors.emplace_back(iter->second);
+      }
+    }
+    for (const auto &control_arrow : actor->output_control_arrows()) {
+      auto iter = name_to_actor.find(control_arrow.Name());
+      if (iter != name_to_actor.end()) {
+        (void)successors.emplace_back(iter->second);
+      }
+    }
+    return successors;
+  };
+
+  // The cost of actor is one plus the average launch time of kernel in microseconds, the other actors take one.
+  mindspore::HashMap<AbstractActor *, int64_t> costs;
+  for (const auto &actor : actors) {
+    costs[actor.get()] = 1;
+  }
+  const uint64_t kNanosecondsToMicroseconds = 1000;
+  for (const auto &kernel_actor : actor_set->kernel_actors_) {
+    MS_EXCEPTION_IF_NULL(kernel_actor);
+    if (kernel_actor->launch_num_ > 0) {
+      costs[kernel_actor.get()] +=
+        static_cast<int64_t>(kernel_actor->launch_cost_ns_ / kernel_actor->launch_num_ / kNanosecondsToMicroseconds);
+    }
+  }
+
+  // The upward rank of actor is the cost of the longest path from it to the end of the DAG. The arrows back to an actor
+  // being visited (the loop count actor triggers the next step) are ignored. The actors are collected in the post
+  // order, which is the reverse topological order without the back arrows.
+  constexpr int64_t kVisiting = -1;
+  mindspore::HashMap<AbstractActor *, int64_t> ranks;
+  std::vector<AbstractActor *> post_order;
+  for (const auto &root : actors) {
+    if (ranks.count(root.get()) > 0) {
+      continue;
+    }
+    std::vector<std::pair<AbstractActor *, std::vector<AbstractActor *>>> stack;
+    ranks[root.get()] = kVisiting;
+    (void)stack.emplace_back(root.get(), get_successors(root.get()));
+    while (!stack.empty()) {
+      auto &top = stack.back();
+      if (!top.second.empty()) {
+        auto successor = top.second.back();
+        top.second.pop_back();
+        if (ranks.count(successor) == 0) {
+          ranks[successor] = kVisiting;
+          (void)stack.emplace_back(successor, get_successors(successor));
+        }
+        continue;
+      }
+      int64_t max_successor_rank = 0;
+      for (const auto &successor : get_successors(top.first)) {
+        max_successor_rank = std::max(max_successor_rank, ranks[successor]);
+      }
+      ranks[top.first] = max_successor_rank + costs[top.first];
+      (void)post_order.emplace_back(top.first);
+      stack.pop_back();
+    }
+  }
+
+  // The downward rank of actor is the cost of the longest path from the start of the DAG to it, excluding itself. The
+  // actor is on the critical path when the two ranks add up to the critical path length.
+  mindspore::HashMap<AbstractActor *, size_t> topo_index;
+  for (size_t i = 0; i < post_order.size(); ++i) {
+    topo_index[post_order[i]] = post_order.size() - 1 - i;
+  }
+  mindspore::HashMap<AbstractActor *, int64_t> downward_ranks;
+  int64_t critical_path_len = 0;
+  for (auto iter = post_order.rbegin(); iter != post_order.rend(); ++iter) {
+    auto actor = *iter;
+    auto finish = downward_ranks[actor] + costs[actor];
+    critical_path_len = std::max(critical_path_len, finish);
+    for (const auto &successor : get_successors(actor)) {
+      if (topo_index[successor] > topo_index[actor]) {
+        downward_ranks[successor] = std::max(downward_ranks[successor], finish);
+      }
+    }
+  }
+
+  // The actors off the critical path keep the default priority, so they go through the lock-free queue in FIFO order.
+  size_t critical_actor_num = 0;
+  for (const auto &actor : actors) {
+    bool is_critical = (downward_ranks[actor.get()] + ranks[actor.get()] == critical_path_len);
+    actor->set_priority(is_critical ? ranks[actor.get()] : 0);
+    critical_actor_num += is_critical ? 1 : 0;
+    MS_LOG(DEBUG) << "Actor: " << actor->GetAID().Name() << " priority: " << actor->priority();
+  }
+  MS_LOG(INFO) << "Actor set: " << actor_set->name_ << " critical path length: " << critical_path_len
+               << ", critical actor number: " << critical_actor_num << ", total actor number: " << actors.size();
+}
+
+void GraphScheduler::UpdateActorPriority(const ActorSet *actor_set) const {
+  MS_EXCEPTION_IF_NULL(actor_set);
+  // The actors are idle between the executions, so the recording switch and the priorities can be changed.
+  if (actor_set->execution_count_ + 1 == kActorPriorityProfileCountBegin) {
+    for (const auto &kernel_actor : actor_set->kernel_actors_) {
+      MS_EXCEPTION_IF_NULL(kernel_actor);
+      kernel_actor->is_launch_cost_recorded_ = true;
+      kernel_actor->launch_cost_ns_ = 0;
+      kernel_actor->launch_num_ = 0;
+    }
+  } else if (actor_set->execution_count_ == kActorPriorityProfileCountEnd) {
+    for (const auto &kernel_actor : actor_set->kernel_actors_) {
+      MS_EXCEPTION_IF_NULL(kernel_actor);
+      kernel_actor->is_launch_cost_recorded_ = false;
+    }
+    SetActorPriority(actor_set);
+  }
+}
+
+LinearExecutorPtr GraphScheduler::BuildLinearExecutor(const ActorSet *actor_set) const {
+  MS_EXCEPTION_IF_NULL(actor_set);
+  // The linear execution supports the kernel actors running one loop on the CPU device.
+  if ((actor_set->control_actors_ != nullptr) || (actor_set->copy_actors_.size() > 0) ||
+      (actor_set->super_kernel_actors_.size() > 0) || (actor_set->kernel_actors_.size() == 0) ||
+      (actor_set->kernel_actors_.size() > ActorDispatcher::kSingleThreadExecutionActorMaxNum) ||
+      (actor_set->loop_count_actor_ == nullptr) || (actor_set->loop_count_actor_->loop_count() > 1) ||
+      (actor_set->output_actor_ == nullptr) || (actor_set->data_prepare_actor_ == nullptr) ||
+      (actor_set->data_prepare_actor_->continuous_memory_nodes().size() > 0) || (recorder_aid_ != nullptr) ||
+      (debug_aid_ != nullptr)) {
+    return nullptr;
+  }
+  MS_EXCEPTION_IF_NULL(actor_set->kernel_actors_[0]);
+  const auto device_context = actor_set->kernel_actors_[0]->device_contexts_[0];
+  MS_EXCEPTION_IF_NULL(device_context);
+  if (device_context->GetDeviceAddressType() != device::DeviceAddressType::kCPU) {
+    return nullptr;
+  }
+
+  HostQueueDSActorPtr host_data_source_actor = nullptr;
+  for (const auto &data_source_actor : actor_set->data_source_actors_) {
+    MS_EXCEPTION_IF_NULL(data_source_actor);
+    if (data_source_actor->type_ != KernelTransformType::kHostDataSourceActor) {
+      return nullptr;
+    }
+    host_data_source_actor = std::dynamic_pointer_cast<HostQueueDataSourceActor>(data_source_actor);
+    MS_EXCEPTION_IF_NULL(host_data_source_actor);
+    if (std::any_of(host_data_source_actor->device_contexts_.begin(), host_data_source_actor->device_contexts_.end(),
+                    [&device_context](const DeviceContext *context) { return context != device_context; })) {
+      return nullptr;
+    }
+  }
+
+  mindspore::HashMap<std::string, size_t> actor_name_to_index;
+  for (size_t i = 0; i < actor_set->kernel_actors_.size(); ++i) {
+    const auto &kernel_actor = actor_set->kernel_actors_[i];
+    MS_EXCEPTION_IF_NULL(kernel_actor);
+    if ((kernel_actor->device_contexts_[0] != device_context) || AnfAlgo::IsDynamicShape(kernel_actor->kernel_)) {
+      return nullptr;
+    }
+    actor_name_to_index[kernel_actor->GetAID().Name()] = i;
+  }
+
+  // Sort the kernel actors in the topological order by the arrows between them, and the kernel actors without
+  // dependency keep the order of kernel actors which follows the execution order of graph.
+  std::vector<size_t> in_degrees(actor_set->kernel_actors_.size(), 0);
+  std::vector<std::vector<size_t>> successors(actor_set->kernel_actors_.size());
+  for (size_t i = 0; i < actor_set->kernel_actors_.size(); ++i) {
+    const auto &kernel_actor = actor_set->kernel_actors_[i];
+    std::vector<std::string> successor_names;
+    for (const auto &data_arrow : kernel_actor->output_data_arrows_) {
+      MS_EXCEPTION_IF_NULL(data_arrow);
+      (void)successor_names.emplace_back(data_arrow->to_op_id_.Name());
+    }
+    for (const auto &control_arrow : kernel_actor->output_control_arrows_) {
+      (void)successor_names.emplace_back(control_arrow.Name());
+    }
+    for (const auto &successor_name : successor_names) {
+      auto iter = actor_name_to_index.find(successor_name);
+      if (iter != actor_name_to_index.end()) {
+        (void)successors[i].emplace_back(iter->second);
+        ++in_degrees[iter->second];
+      }
+    }
+  }
+  std::set<size_t> ready_indexes;
+  for (size_t i = 0; i < in_degrees.size(); ++i) {
+    if (in_degrees[i] == 0) {
+      (void)ready_indexes.insert(i);
+    }
+  }
+  std::vector<KernelActorPtr> ordered_kernel_actors;
+  while (!ready_indexes.empty()) {
+    auto index = *ready_indexes.begin();
+    (void)ready_indexes.erase(ready_indexes.begin());
+    (void)ordered_kernel_actors.emplace_back(actor_set->kernel_actors_[index]);
+    for (const auto &successor : successors[index]) {
+      if (--in_degrees[successor] == 0) {
+        (void)ready_indexes.insert(successor);
+      }
+    }
+  }
+  if (ordered_kernel_actors.size() != actor_set->kernel_actors_.size()) {
+    MS_LOG(INFO) << "The kernel actors of " << actor_set->name_ << " can't be sorted in the topological order.";
+    return nullptr;
+  }
+
+  MS_LOG(INFO) << "Build the linear executor of " << actor_set->name_
+               << ", kernel actor num: " << ordered_kernel_actors.size();
+  return std::make_shared<LinearExecutor>(actor_set->data_prepare_actor_, host_data_source_actor,
+                                          ordered_kernel_actors, actor_set->output_actor_, device_context);
+}
+
 void GraphScheduler::PersistDeviceTensor(const GraphCompilerInfo &graph_compiler_info) {
   for (size_t i = 0; i < graph_compiler_info.graphs_.size(); ++i) {
     const auto &graph = graph_compiler_info.graphs_[i];
@@ -1826,6 +2099,51 @@ void GraphScheduler::PersistDeviceTensor(const GraphCompilerInfo &graph_compiler
   }
 }
 
+void GraphScheduler::ReportInferCacheStatistics(const ActorSet *actor_set) const {
+  MS_EXCEPTION_IF_NULL(actor_set);
+  size_t total_hit_count = 0;
+  size_t total_miss_count = 0;
+  for (const auto &kernel_actor : actor_set->kernel_actors_) {
+    MS_EXCEPTION_IF_NULL(kernel_actor);
+    auto hit_count = kernel_actor->infer_cache_hit_count_;
+    auto miss_count = kernel_actor->infer_cache_miss_count_;
+    if (hit_count + miss_count == 0) {
+      continue;
+    }
+    MS_LOG(DEBUG) << "The infer cache of actor " << kernel_actor->GetAID().Name() << ", hit count: " << hit_count
+                  << ", miss count: " << miss_count << ", cache size: " << kernel_actor->infer_cache_.size();
+    total_hit_count += hit_count;
+    total_miss_count += miss_count;
+  }
+  if (total_hit_count + total_miss_count == 0) {
+    return;
+  }
+  MS_LOG(INFO) << "The infer cache of actor set " << actor_set->name_ << ", hit count: " << total_hit_count
+               << ", miss count: " << total_miss_count << ", hit rate: "
+               << static_cast<double>(total_hit_count) / (total_hit_count + total_miss_count);
+}
+
+void GraphScheduler::ReportStepInferCacheStatistics(ActorSet *const actor_set) const {
+  MS_EXCEPTION_IF_NULL(actor_set);
+  size_t total_hit_count = 0;
+  size_t total_miss_count = 0;
+  for (const auto &kernel_actor : actor_set->kernel_actors_) {
+    MS_EXCEPTION_IF_NULL(kernel_actor);
+    total_hit_count += kernel_actor->infer_cache_hit_count_;
+    total_miss_count += kernel_actor->infer_cache_miss_count_;
+  }
+  auto hit_count = total_hit_count - actor_set->infer_cache_hit_count_;
+  auto miss_count = total_miss_count - actor_set->infer_cache_miss_count_;
+  actor_set->infer_cache_hit_count_ = total_hit_count;
+  actor_set->infer_cache_miss_count_ = total_miss_count;
+  if (hit_count + miss_count == 0) {
+    return;
+  }
+  MS_LOG(INFO) << "The infer cache of actor set " << actor_set->name_ << " in step " << actor_set->execution_count_
+               << ", hit count: " << hit_count << ", miss count: " << miss_count
+               << ", hit rate: " << static_cast<double>(hit_count) / (hit_count + miss_count);
+}
+
 void GraphScheduler::DumpActor(const ActorSet *actor_set, const GraphCompilerInfo &graph_compiler_info) const {
   MS_EXCEPTION_IF_NULL(actor_set);
   const auto &context_ptr = MsContext::GetInstance();
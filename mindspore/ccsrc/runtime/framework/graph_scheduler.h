@@ -81,7 +81,8 @@ class GraphScheduler {
   ~GraphScheduler() = default;
   DISABLE_COPY_AND_ASSIGN(GraphScheduler);
 
-  // Set using the multi thread or single thread to execute the actor set by the execution time compared.
+  // Set using the multi thread, single thread or linear execution to execute the actor set by the execution time
+  // compared.
   void SetActorExecutionStrategy(ActorSet *const actor_set, GraphExecutionStrategy strategy, double execution_time);
 
   // The Global actors contain memory manager actor, recorder actor and debug actor.
@@ -175,9 +176,24 @@ class GraphScheduler {
   // Check whether the actor set is valid.
   void CheckActorValid(const ActorSet *actor_set) const;
 
+  // Set the priority of the actors on the critical path, the actor thread pool runs them ahead of the other ready
+  // actors. The cost of kernel actor is its recorded launch time, so the critical path is counted in hops until the
+  // launch costs are recorded.
+  void SetActorPriority(const ActorSet *actor_set) const;
+  // Record the launch costs of the kernel actors in the profiling executions, then set the priority by them.
+  void UpdateActorPriority(const ActorSet *actor_set) const;
+
+  // Build the linear executor when the actors of actor set can be replaced by launching the kernels in order.
+  LinearExecutorPtr BuildLinearExecutor(const ActorSet *actor_set) const;
+
   // Persist device tensors of graph's some nodes(such as weights and value nodes).
   void PersistDeviceTensor(const GraphCompilerInfo &graph_compiler_info);
 
+  // Display the hit rate of the infer cache of dynamic shape kernel actors.
+  void ReportInferCacheStatistics(const ActorSet *actor_set) const;
+  // Display the hit rate of the infer cache in the execution just finished.
+  void ReportStepInferCacheStatistics(ActorSet *const actor_set) const;
+
   // Display the actor information of corresponding kernel graph.
   void DumpActor(const ActorSet *actor_set, const GraphCompilerInfo &graph_compiler_info) const;
   void DumpDeviceTensorStore(const GraphCompilerInfo &graph_compiler_info, std::ofstream &ofs) const;
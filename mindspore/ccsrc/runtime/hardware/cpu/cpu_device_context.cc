@@ -16,18 +16,22 @@
 
 #include "runtime/hardware/cpu/cpu_device_context.h"
 #include <string>
+#include <algorithm>
 #include "runtime/device/cpu/cpu_device_address.h"
 #include "runtime/device/cpu/cpu_memory_manager.h"
 #include "backend/kernel_compiler/akg/cpu/akg_cpu_kernel_build.h"
 #include "backend/kernel_compiler/cpu/cpu_kernel_factory.h"
+#include "backend/kernel_compiler/cpu/cpu_parallel_tuning_db.h"
 #include "backend/kernel_compiler/kernel_build_info.h"
 #include "runtime/device/cpu/kernel_select_cpu.h"
+#include "runtime/device/kernel_select_cache.h"
 #include "utils/trace_base.h"
 #include "utils/context/graph_kernel_flags.h"
 #include "backend/optimizer/common/optimizer.h"
 #include "backend/optimizer/common/pass_manager.h"
 #include "backend/optimizer/common/common_backend_optimization.h"
 #include "backend/optimizer/cpu/insert_cast_cpu.h"
+#include "backend/optimizer/cpu/elemwise_op_fusion_cpu.h"
 #include "backend/optimizer/cpu/insert_format_transform_op.h"
 #include "backend/optimizer/pass/replace_node_by_proxy.h"
 #include "backend/optimizer/pass/erase_visit_attr.h"
@@ -36,6 +40,7 @@
 #include "profiler/device/cpu/cpu_profiling.h"
 #if ((defined ENABLE_CPU) && (!defined _WIN32))
 #include "runtime/hardware/cpu/ms_collective_comm_lib.h"
+#include "runtime/device/cpu/cpu_mem_handler.h"
 #endif
 #ifndef ENABLE_SECURITY
 #include "debug/data_dump/dump_json_parser.h"
@@ -54,6 +59,30 @@ using mindspore::kernel::KernelBuildInfo;
 static bool flush_zero_mode_enable{false};
 #endif
 
+namespace {
+constexpr size_t kMBToByte = 1024 * 1024;
+
+bool IsGraphMode() {
+  auto context = MsContext::GetInstance();
+  MS_EXCEPTION_IF_NULL(context);
+  return context->get_param<int>(MS_CTX_EXECUTION_MODE) == kGraphMode;
+}
+
+// Get the memory budget of offload in MB from the env, zero means the available memory of system.
+size_t GetMemOffloadSize() {
+  const auto &mem_size_env = common::GetEnv("MS_DEV_CPU_MEM_OFFLOAD_SIZE");
+  if (mem_size_env.empty()) {
+    return 0;
+  }
+  try {
+    return static_cast<size_t>(std::stoull(mem_size_env)) * kMBToByte;
+  } catch (const std::exception &e) {
+    MS_LOG(EXCEPTION) << "Invalid env MS_DEV_CPU_MEM_OFFLOAD_SIZE: " << mem_size_env
+                      << ", it should be an integer in MB.";
+  }
+}
+}  // namespace
+
 void CPUDeviceContext::Initialize() {
   if (initialized_) {
     return;
@@ -62,6 +91,17 @@ void CPUDeviceContext::Initialize() {
   mem_manager_ = std::make_shared<CPUMemoryManager>();
   MS_EXCEPTION_IF_NULL(mem_manager_);
 
+  if (common::GetEnv("MS_DEV_CPU_MEM_OFFLOAD") == "1") {
+#if ((defined ENABLE_CPU) && (!defined _WIN32))
+    // The host memory of offload is mapped in the file of path, which is usually on the NVMe disk.
+    mem_handler_ =
+      std::make_shared<CPUMemHandler>(mem_manager_, common::GetEnv("MS_DEV_CPU_MEM_OFFLOAD_PATH"), GetMemOffloadSize());
+    mem_offload_enable_ = true;
+#else
+    MS_LOG(WARNING) << "The memory offload of CPU is not supported on windows.";
+#endif
+  }
+
 #ifndef ENABLE_SECURITY
   // Dump json config file if dump is enabled.
   auto rank_id = GetRankID();
@@ -71,10 +111,16 @@ void CPUDeviceContext::Initialize() {
   json_parser.CopyMSCfgJsonToDir(rank_id);
 #endif
 
+  // Load the parallel tuning database before the kernels are built.
+  (void)kernel::ParallelTuningDB::GetInstance();
+
   initialized_ = true;
 }
 
 void CPUDeviceContext::Destroy() {
+  // Save the parallel tuning records searched in this process.
+  kernel::ParallelTuningDB::GetInstance().Flush();
+
   // Release memory.
   if (mem_manager_ != nullptr) {
     mem_manager_->FreeDeviceMemory();
@@ -124,7 +170,7 @@ void CPUDeviceContext::OptimizeGraph(const KernelGraphPtr &graph) const {
   // Update Graph Dynamic Shape Attr.
   opt::AddDynamicShapeAttrPass(graph);
 
-  SetOperatorInfo(graph->execution_order());
+  SetOperatorInfoWithCache(graph->execution_order());
   OptimizeGraphImpl(graph);
 
   // Run final optimization.
@@ -151,6 +197,7 @@ void CPUDeviceContext::OptimizeGraphImpl(const KernelGraphPtr &graph) const {
   auto pm = std::make_shared<opt::PassManager>();
   pm->AddPass(std::make_shared<opt::InsertFormatTransformOpCPU>("insert_format_transform_op_cpu"));
   pm->AddPass(std::make_shared<opt::InsertCastCPU>("insert_cast"));
+  pm->AddPass(std::make_shared<opt::ElemwiseOpFusionCPU>("elemwise_op_fusion_cpu"));
   pm->AddPass(std::make_shared<opt::EraseVisitAttr>());
   optimizer->AddPassManager(pm);
   (void)optimizer->Optimize(graph);
@@ -196,6 +243,32 @@ void CPUDeviceContext::SetOperatorInfo(const std::vector<CNodePtr> &nodes) const
   }
 }
 
+void CPUDeviceContext::SetOperatorInfoWithCache(const std::vector<CNodePtr> &nodes) const {
+  auto &cache = KernelSelectCache::GetInstance();
+  bool cacheable = cache.enabled() && std::all_of(nodes.begin(), nodes.end(), [](const CNodePtr &node) {
+                     return AnfAlgo::IsControlOpExecInBackend(node) || IsKernelInfoCacheable(node);
+                   });
+  if (!cacheable) {
+    SetOperatorInfo(nodes);
+    return;
+  }
+
+  const auto &key = cache.GraphKey(device_context_key_.device_name_, nodes);
+  std::vector<kernel::KernelBuildInfoPtr> build_infos;
+  if (!cache.Fetch(key, nodes, &build_infos)) {
+    SetOperatorInfo(nodes);
+    cache.Insert(key, nodes);
+    return;
+  }
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (AnfAlgo::IsControlOpExecInBackend(nodes[i])) {
+      AnfAlgo::SetSelectKernelBuildInfo(build_infos[i], nodes[i].get());
+    } else {
+      SetKernelInfoFromCache(nodes[i], build_infos[i]);
+    }
+  }
+}
+
 void CPUDeviceContext::CreateKernel(const std::vector<CNodePtr> &nodes) const {
   kernel::KernelMeta *bin_map = kernel::KernelMeta::GetInstance();
   MS_EXCEPTION_IF_NULL(bin_map);
@@ -258,6 +331,16 @@ void CPUDeviceContext::UpdateDynamicShape(const CNodePtr &kernel) const {
   dynamic_kernel->UpdateArgs();
 }
 
+void CPUDeviceContext::ResizeKernel(const CNodePtr &kernel) const {
+  auto kernel_mod = AnfAlgo::GetKernelMod(kernel);
+  MS_EXCEPTION_IF_NULL(kernel_mod);
+  kernel::CPUKernel *cpu_kernel = dynamic_cast<kernel::CPUKernel *>(kernel_mod);
+  MS_EXCEPTION_IF_NULL(cpu_kernel);
+  device::DynamicKernelPtr dynamic_kernel = cpu_kernel->DynamicKernel();
+  MS_EXCEPTION_IF_NULL(dynamic_kernel);
+  dynamic_kernel->UpdateArgs();
+}
+
 void CPUDeviceContext::PreprocessBeforeRunGraph(const KernelGraphPtr &graph) const {
   MS_EXCEPTION_IF_NULL(graph);
   // Remove reorder after PS feature finish adapting push/pull in auto_monad.
@@ -325,6 +408,228 @@ bool CPUDeviceContext::LoadCollectiveCommLib() {
   return true;
 }
 
+bool CPUDeviceContext::IsExecutingSink(const KernelGraphPtr &graph) const {
+  MS_EXCEPTION_IF_NULL(graph);
+  if (!mem_offload_enable_ || !IsGraphMode() || graph->is_dynamic_shape()) {
+    return false;
+  }
+  // The control ops have no kernel mod and are executed by the actors.
+  const auto &kernels = graph->execution_order();
+  return std::none_of(kernels.begin(), kernels.end(),
+                      [](const CNodePtr &kernel) { return AnfAlgo::IsControlOpExecInBackend(kernel); });
+}
+
+bool CPUDeviceContext::LaunchGraph(const KernelGraphPtr &graph) const {
+  MS_EXCEPTION_IF_NULL(graph);
+  MS_LOG(INFO) << "Launch graph " << graph->graph_id() << " with memory offload.";
+  if (!AllocateGraphOutputMemory(graph)) {
+    return false;
+  }
+
+  auto mem_scheduler = mem_scheduler_manager_.GetOrCreateMemScheduler(graph->graph_id());
+  MS_EXCEPTION_IF_NULL(mem_scheduler);
+  if (mem_scheduler->need_record_event()) {
+    mem_scheduler->SetMemHandler(mem_handler_);
+    mem_scheduler->SetTotalStep(graph->execution_order().size());
+    InitParameterMemory(graph, mem_scheduler);
+    (void)LaunchKernelsWithMemScheduler(graph, mem_scheduler, true);
+    mem_scheduler->set_need_record_event(false);
+    if (!mem_scheduler->Optimize()) {
+      MS_LOG(ERROR) << "Can't run graph " << graph->graph_id() << " for memory limit.";
+      return false;
+    }
+  }
+  mem_scheduler->Reset();
+  mem_scheduler->Update();
+  InitParameterMemory(graph, mem_scheduler);
+  auto ret = LaunchKernelsWithMemScheduler(graph, mem_scheduler, false);
+  SyncParameterMemory(graph, mem_scheduler);
+  return ret;
+}
+
+void CPUDeviceContext::InitParameterMemory(const KernelGraphPtr &graph,
+                                           const std::shared_ptr<MemScheduler> &mem_scheduler) const {
+  MS_EXCEPTION_IF_NULL(graph);
+  MS_EXCEPTION_IF_NULL(mem_scheduler);
+  MS_EXCEPTION_IF_NULL(mem_handler_);
+  mem_scheduler->ClearMemNeedInit();
+  for (const auto &input_node : graph->input_nodes()) {
+    MS_EXCEPTION_IF_NULL(input_node);
+    if (!input_node->isa<Parameter>() || !AnfAlgo::OutputAddrExist(input_node, 0)) {
+      continue;
+    }
+    auto parameter = input_node->cast<ParameterPtr>();
+    if (!AnfAlgo::IsParameterWeight(parameter) && !graph->IsUpdatedParameter(parameter)) {
+      continue;
+    }
+    auto device_address = AnfAlgo::GetMutableOutputAddr(input_node, 0, false);
+    MS_EXCEPTION_IF_NULL(device_address);
+    const auto size = device_address->GetSize();
+    auto device_ptr = device_address->GetMutablePtr();
+    auto iter = parameter_host_ptr_.find(device_address.get());
+    if (iter == parameter_host_ptr_.end()) {
+      if (device_ptr == nullptr) {
+        continue;
+      }
+      iter = parameter_host_ptr_.emplace(device_address.get(), mem_handler_->MallocHost(size)).first;
+    }
+    auto host_ptr = iter->second;
+
+    // The parameter points to the memory of the last launch, or to the memory which the data is prepared in again.
+    const bool in_last_memory =
+      (device_ptr == host_ptr) ||
+      (mem_scheduler->HasDeviceMem(device_address.get()) &&
+       device_ptr == mem_scheduler->GetOrMalloc(device_address.get(), size, kMemPriorityHigh));
+    if (device_ptr != nullptr && !in_last_memory) {
+      mem_handler_->SwapOut(device_ptr, host_ptr, size, nullptr);
+      mem_scheduler->AddMemNeedInit(device_address.get());
+      FreeMemory(device_address.get());
+    }
+    device_address->set_ptr(nullptr);
+    device_address->set_from_mem_pool(false);
+    mem_scheduler->Init(device_address.get(), host_ptr, size, kMemPriorityHigh);
+  }
+}
+
+void CPUDeviceContext::SyncParameterMemory(const KernelGraphPtr &graph,
+                                           const std::shared_ptr<MemScheduler> &mem_scheduler) const {
+  MS_EXCEPTION_IF_NULL(graph);
+  MS_EXCEPTION_IF_NULL(mem_scheduler);
+  for (const auto &input_node : graph->input_nodes()) {
+    MS_EXCEPTION_IF_NULL(input_node);
+    if (!input_node->isa<Parameter>() || !AnfAlgo::OutputAddrExist(input_node, 0)) {
+      continue;
+    }
+    auto device_address = AnfAlgo::GetMutableOutputAddr(input_node, 0, false);
+    MS_EXCEPTION_IF_NULL(device_address);
+    const auto &iter = parameter_host_ptr_.find(device_address.get());
+    if (iter == parameter_host_ptr_.end()) {
+      continue;
+    }
+    // The host memory is addressable on CPU, so the parameter which is swapped out is read in the host memory.
+    if (mem_scheduler->HasDeviceMem(device_address.get())) {
+      device_address->set_ptr(
+        mem_scheduler->GetOrMalloc(device_address.get(), device_address->GetSize(), kMemPriorityHigh));
+    } else {
+      device_address->set_ptr(iter->second);
+    }
+  }
+}
+
+namespace {
+AddressPtr GetOrMallocAddress(const std::shared_ptr<MemScheduler> &mem_scheduler, const DeviceAddress *device_address) {
+  MS_EXCEPTION_IF_NULL(mem_scheduler);
+  MS_EXCEPTION_IF_NULL(device_address);
+  auto address = std::make_shared<kernel::Address>();
+  // The memory of weights, graph inputs and graph outputs is persistent during the launch.
+  if (device_address->GetPtr() != nullptr) {
+    address->addr = device_address->GetMutablePtr();
+  } else {
+    address->addr = mem_scheduler->GetOrMalloc(device_address, device_address->GetSize());
+  }
+  address->size = device_address->GetSize();
+  return address;
+}
+}  // namespace
+
+bool CPUDeviceContext::LaunchKernelsWithMemScheduler(const KernelGraphPtr &graph,
+                                                     const std::shared_ptr<MemScheduler> &mem_scheduler,
+                                                     bool mock) const {
+  MS_EXCEPTION_IF_NULL(graph);
+  MS_EXCEPTION_IF_NULL(mem_scheduler);
+  for (const auto &kernel : graph->execution_order()) {
+    MS_EXCEPTION_IF_NULL(kernel);
+    if (!mem_scheduler->PreCompute(nullptr)) {
+      MS_LOG(ERROR) << "Prepare the memory of kernel " << kernel->fullname_with_scope() << " failed.";
+      return false;
+    }
+    auto kernel_mod = AnfAlgo::GetKernelMod(kernel);
+    MS_EXCEPTION_IF_NULL(kernel_mod);
+    std::vector<AddressPtr> inputs;
+    std::vector<AddressPtr> workspaces;
+    std::vector<AddressPtr> outputs;
+    size_t input_num = AnfAlgo::GetInputTensorNum(kernel);
+    const bool update_parameter = mock && AnfAlgo::IsUpdateParameterKernel(kernel);
+    for (size_t i = 0; i < input_num; ++i) {
+      const auto input_address = AnfAlgo::GetPrevNodeOutputAddr(kernel, i, false);
+      (void)inputs.emplace_back(GetOrMallocAddress(mem_scheduler, input_address));
+      // The updated parameter is swapped out to the host memory instead of being freed.
+      const auto &input_node = AnfAlgo::GetPrevNodeOutput(kernel, i, false).first;
+      if (update_parameter && input_node->isa<Parameter>()) {
+        const auto &abstract = input_node->abstract();
+        MS_EXCEPTION_IF_NULL(abstract);
+        if (abstract->isa<abstract::AbstractRef>()) {
+          mem_scheduler->UpdateHighPriorityMem(input_address);
+        }
+      }
+    }
+    // The ref output shares the memory with the corresponding input, and the separate memory of ref output which is
+    // the graph output is synchronized after the launch.
+    std::vector<std::pair<AddressPtr, AddressPtr>> ref_outputs;
+    for (size_t i = 0; i < kernel_mod->GetOutputSizeList().size(); ++i) {
+      const auto output_address = AnfAlgo::GetOutputAddr(kernel, i, false);
+      MS_EXCEPTION_IF_NULL(output_address);
+      session::AnfWithOutIndex output_pair(kernel, i);
+      if (!graph->IsInRefOutputMap(output_pair)) {
+        (void)outputs.emplace_back(GetOrMallocAddress(mem_scheduler, output_address));
+        continue;
+      }
+      const auto &origin_pair = graph->GetRefCorrespondOutput(output_pair);
+      auto origin =
+        GetOrMallocAddress(mem_scheduler, AnfAlgo::GetOutputAddr(origin_pair.first, origin_pair.second, false));
+      if (output_address->GetPtr() != nullptr && output_address->GetPtr() != origin->addr) {
+        (void)ref_outputs.emplace_back(origin, GetOrMallocAddress(mem_scheduler, output_address));
+      }
+      (void)outputs.emplace_back(origin);
+    }
+    for (size_t i = 0; i < kernel_mod->GetWorkspaceSizeList().size(); ++i) {
+      (void)workspaces.emplace_back(GetOrMallocAddress(mem_scheduler, AnfAlgo::GetWorkspaceAddr(kernel, i)));
+    }
+
+    if (!mock) {
+      if (!LaunchKernel(kernel, inputs, workspaces, outputs)) {
+        MS_LOG(ERROR) << "Launch kernel " << kernel->fullname_with_scope() << " failed.";
+        return false;
+      }
+      for (const auto &ref_output : ref_outputs) {
+        auto ret = memcpy_s(ref_output.second->addr, ref_output.second->size, ref_output.first->addr,
+                            std::min(ref_output.first->size, ref_output.second->size));
+        if (ret != EOK) {
+          MS_LOG(ERROR) << "Copy the ref output of kernel " << kernel->fullname_with_scope() << " failed.";
+          return false;
+        }
+      }
+    }
+    if (!mem_scheduler->PostCompute(nullptr)) {
+      MS_LOG(ERROR) << "Release the memory of kernel " << kernel->fullname_with_scope() << " failed.";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CPUDeviceContext::AllocateGraphOutputMemory(const KernelGraphPtr &graph) const {
+  MS_EXCEPTION_IF_NULL(graph);
+  for (const auto &output : AnfAlgo::GetAllOutputWithIndex(graph->output())) {
+    const auto &output_node = output.first;
+    MS_EXCEPTION_IF_NULL(output_node);
+    if (!output_node->isa<CNode>() || !AnfUtils::IsRealKernel(output_node)) {
+      continue;
+    }
+    auto device_address = AnfAlgo::GetMutableOutputAddr(output_node, output.second, false);
+    MS_EXCEPTION_IF_NULL(device_address);
+    if (device_address->GetPtr() != nullptr) {
+      continue;
+    }
+    if (!AllocateMemory(device_address.get(), device_address->GetSize())) {
+      MS_LOG(ERROR) << "Allocate memory failed for the output of " << output_node->fullname_with_scope()
+                    << ", alloc size: " << device_address->GetSize() << "B.";
+      return false;
+    }
+  }
+  return true;
+}
+
 bool CPUDeviceContext::LaunchKernelWithProfiling(const CNodePtr &kernel, const std::vector<AddressPtr> &inputs,
                                                  const std::vector<AddressPtr> &workspace,
                                                  const std::vector<AddressPtr> &outputs) const {
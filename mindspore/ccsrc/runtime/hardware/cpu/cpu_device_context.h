@@ -19,10 +19,12 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <map>
 #include <mutex>
 #include "runtime/hardware/device_context.h"
 #include "runtime/hardware/device_context_manager.h"
 #include "runtime/device/memory_manager.h"
+#include "runtime/device/memory_scheduler.h"
 
 namespace mindspore {
 namespace device {
@@ -50,6 +52,7 @@ class CPUDeviceContext : public DeviceContext {
   void SetOperatorInfo(const std::vector<CNodePtr> &nodes) const override;
   void CreateKernel(const std::vector<CNodePtr> &nodes) const override;
   void UpdateDynamicShape(const CNodePtr &kernel) const override;
+  void ResizeKernel(const CNodePtr &kernel) const override;
 
   void PreprocessBeforeRunGraph(const KernelGraphPtr &graph) const override;
 
@@ -59,10 +62,18 @@ class CPUDeviceContext : public DeviceContext {
 
   bool LoadCollectiveCommLib() override;
 
+  // The graph is executed in the device context when the memory offload is enabled by the env MS_DEV_CPU_MEM_OFFLOAD,
+  // and the memory of kernels is allocated and swapped by the MemScheduler.
+  bool IsExecutingSink(const KernelGraphPtr &graph) const override;
+  bool LaunchGraph(const KernelGraphPtr &graph) const override;
+
  private:
   DISABLE_COPY_AND_ASSIGN(CPUDeviceContext);
 
   void OptimizeGraphImpl(const KernelGraphPtr &graph) const;
+  // Restore the operator info from the kernel select cache if the graph has been compiled before. The kernels are still
+  // created and linked to the actors in this process.
+  void SetOperatorInfoWithCache(const std::vector<CNodePtr> &nodes) const;
 #ifndef ENABLE_SECURITY
   // Launch a kernel and record the elapsed time end to end.
   bool LaunchKernelWithProfiling(const CNodePtr &kernel, const std::vector<AddressPtr> &inputs,
@@ -73,9 +84,25 @@ class CPUDeviceContext : public DeviceContext {
   bool DoLaunchKernel(KernelMod *const kernel_mod, const std::vector<AddressPtr> &inputs,
                       const std::vector<AddressPtr> &workspace, const std::vector<AddressPtr> &outputs) const;
 
+  // Launch the kernels of graph with the memory of MemScheduler, only the memory events are recorded in the mock.
+  bool LaunchKernelsWithMemScheduler(const KernelGraphPtr &graph, const std::shared_ptr<MemScheduler> &mem_scheduler,
+                                     bool mock) const;
+  // The memory of graph outputs isn't managed by the MemScheduler, since it's taken by the output tensors.
+  bool AllocateGraphOutputMemory(const KernelGraphPtr &graph) const;
+  // The weights and the updated parameters are moved to the host memory of offload, and initialized in the
+  // MemScheduler as the high priority memory, so they are swapped in within the memory limit like the others.
+  void InitParameterMemory(const KernelGraphPtr &graph, const std::shared_ptr<MemScheduler> &mem_scheduler) const;
+  // Point the parameters to their latest memory after the launch, so they can be read and written out of the graph.
+  void SyncParameterMemory(const KernelGraphPtr &graph, const std::shared_ptr<MemScheduler> &mem_scheduler) const;
+
   mutable std::mutex launch_mutex_;
   std::shared_ptr<MemoryManager> mem_manager_;
   bool initialized_;
+  bool mem_offload_enable_{false};
+  std::shared_ptr<MemHandler> mem_handler_{nullptr};
+  mutable MemSchedulerManager mem_scheduler_manager_;
+  // The host memory of offload which the parameters are moved to.
+  mutable std::map<const DeviceAddress *, void *> parameter_host_ptr_;
 };
 }  // namespace cpu
 }  // namespace device
@@ -37,6 +37,11 @@ bool MsCollectiveCommLib::Initialize(uint32_t global_rank, uint32_t global_rank_
   return true;
 }
 
+bool MsCollectiveCommLib::Finalize() {
+  CollectiveOpsImpl::GetInstance().ReleaseHierarchicalGroups();
+  return CollectiveCommunicationLib::Finalize();
+}
+
 bool MsCollectiveCommLib::CreateCommunicationGroup(const std::string &group_name,
                                                    const std::vector<uint32_t> &group_ranks) {
   if (groups_.count(group_name) != 0) {
@@ -50,6 +55,11 @@ bool MsCollectiveCommLib::CreateCommunicationGroup(const std::string &group_name
   return true;
 }
 
+bool MsCollectiveCommLib::DestroyCommunicationGroup(const std::string &group_name) {
+  CollectiveOpsImpl::GetInstance().ReleaseHierarchicalGroup(group_name);
+  return CollectiveCommunicationLib::DestroyCommunicationGroup(group_name);
+}
+
 bool MsCollectiveCommLib::AllGather(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
                                     const std::string &group_name, void *stream) {
   CHECK_IF_NULL(send_buff);
@@ -73,24 +83,49 @@ bool MsCollectiveCommLib::AllGather(const void *send_buff, void *recv_buff, size
   return true;
 }
 
-bool MsCollectiveCommLib::Broadcast(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
-                                    uint32_t root_rank, const std::string &group_name, void *stream) {
+bool MsCollectiveCommLib::AllReduce(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
+                                    CollectiveOpReduceType reduce_op, const std::string &group_name, void *stream) {
   CHECK_IF_NULL(send_buff);
   CHECK_IF_NULL(recv_buff);
   CHECK_IF_NULL(node_);
 
-  if (groups_.count(group_name) == 0) {
-    MS_LOG(ERROR) << "The group " << group_name << " does not exist.";
+  if (reduce_op != CollectiveOpReduceType::Reduce_Sum) {
+    MS_LOG(ERROR) << "The reduce type " << reduce_op << " of AllReduce is not supported.";
+    return false;
+  }
+  CommunicationGroupInfo group_info = {};
+  if (!GetGroupInfo(group_name, &group_info)) {
     return false;
   }
 
-  auto group = groups_[group_name];
+  switch (data_type) {
+    case TypeId::kNumberTypeInt32:
+    case TypeId::kNumberTypeInt:
+      return CollectiveOpsImpl::GetInstance().AllReduce<int32_t>(group_name, send_buff, recv_buff, send_count, node_,
+                                                                 group_info);
+    case TypeId::kNumberTypeUInt64:
+      return CollectiveOpsImpl::GetInstance().AllReduce<uint64_t>(group_name, send_buff, recv_buff, send_count, node_,
+                                                                  group_info);
+    case TypeId::kNumberTypeFloat32:
+    case TypeId::kNumberTypeFloat:
+      return CollectiveOpsImpl::GetInstance().AllReduce<float>(group_name, send_buff, recv_buff, send_count, node_,
+                                                               group_info);
+    default:
+      return false;
+  }
+  return true;
+}
+
+bool MsCollectiveCommLib::Broadcast(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
+                                    uint32_t root_rank, const std::string &group_name, void *stream) {
+  CHECK_IF_NULL(send_buff);
+  CHECK_IF_NULL(recv_buff);
+  CHECK_IF_NULL(node_);
+
   CommunicationGroupInfo group_info = {};
-  group_info.size = group->group_size();
-  group_info.global_rank = global_rank_id_;
-  group_info.group_ranks = group->group_ranks();
-  group_info.global_to_group_ranks = group->global_to_group_ranks();
-  group_info.group_to_global_ranks = group->group_to_global_ranks();
+  if (!GetGroupInfo(group_name, &group_info)) {
+    return false;
+  }
 
   switch (data_type) {
     case TypeId::kNumberTypeInt8:
@@ -112,6 +147,22 @@ bool MsCollectiveCommLib::Broadcast(const void *send_buff, void *recv_buff, size
   }
   return true;
 }
+
+bool MsCollectiveCommLib::GetGroupInfo(const std::string &group_name, CommunicationGroupInfo *group_info) {
+  CHECK_IF_NULL(group_info);
+  if (groups_.count(group_name) == 0) {
+    MS_LOG(ERROR) << "The group " << group_name << " does not exist.";
+    return false;
+  }
+
+  auto group = groups_[group_name];
+  group_info->size = group->group_size();
+  group_info->global_rank = global_rank_id_;
+  group_info->group_ranks = group->group_ranks();
+  group_info->global_to_group_ranks = group->global_to_group_ranks();
+  group_info->group_to_global_ranks = group->group_to_global_ranks();
+  return true;
+}
 }  // namespace cpu
 }  // namespace device
 }  // namespace mindspore
@@ -43,15 +43,19 @@ class MsCollectiveCommLib : public CollectiveCommunicationLib {
 
   bool Initialize(uint32_t global_rank = UINT32_MAX, uint32_t global_rank_size = UINT32_MAX) override;
 
+  // The shared memory of the groups for AllReduce is released as well.
+  bool Finalize() override;
+
   bool CreateCommunicationGroup(const std::string &group_name, const std::vector<uint32_t> &group_ranks) override;
 
+  bool DestroyCommunicationGroup(const std::string &group_name) override;
+
   bool AllGather(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
                  const std::string &group_name, void *stream = nullptr) override;
 
+  // Only the sum is supported for now. The processes on the same host reduce the data by the shared memory.
   bool AllReduce(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
-                 CollectiveOpReduceType reduce_op, const std::string &group_name, void *stream = nullptr) override {
-    return true;
-  }
+                 CollectiveOpReduceType reduce_op, const std::string &group_name, void *stream = nullptr) override;
 
   bool Broadcast(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type, uint32_t root_rank,
                  const std::string &group_name, void *stream = nullptr) override;
@@ -65,6 +69,9 @@ class MsCollectiveCommLib : public CollectiveCommunicationLib {
   MsCollectiveCommLib();
   ~MsCollectiveCommLib() override = default;
 
+  // Get the ranks of the group for the collective operations.
+  bool GetGroupInfo(const std::string &group_name, CommunicationGroupInfo *group_info);
+
   std::shared_ptr<ps::core::AbstractNode> node_;
 };
 }  // namespace cpu
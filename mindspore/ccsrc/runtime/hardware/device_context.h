@@ -113,6 +113,8 @@ class DeviceContext {
 
   // Infer kernel shape and update abstract info for dynamic shape kernel.
   virtual void UpdateDynamicShape(const CNodePtr &kernel) const { AnfAlgo::InferShape(kernel); }
+  // Resize the kernel mod of dynamic shape kernel by the shapes which have been inferred, without inferring again.
+  virtual void ResizeKernel(const CNodePtr &kernel) const {}
 
   // Whether the graph sink executing through the device capability, the default behavior is not sink and return false.
   virtual bool IsExecutingSink(const KernelGraphPtr &graph) const { return false; }
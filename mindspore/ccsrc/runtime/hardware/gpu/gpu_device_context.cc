@@ -391,6 +391,26 @@ void GPUDeviceContext::UpdateDynamicShape(const CNodePtr &kernel) const {
   dynamic_kernel->UpdateArgs();
 }
 
+void GPUDeviceContext::ResizeKernel(const CNodePtr &kernel) const {
+  MS_EXCEPTION_IF_NULL(kernel);
+  auto ms_context = MsContext::GetInstance();
+  MS_EXCEPTION_IF_NULL(ms_context);
+  // The same as UpdateDynamicShape, the kernel isn't resized in PyNative mode.
+  bool is_pynative_infer = ms_context->get_param<bool>(MS_CTX_ENABLE_PYNATIVE_INFER);
+  bool is_pynative_mode = ms_context->get_param<int>(MS_CTX_EXECUTION_MODE) == kPynativeMode;
+  if (is_pynative_infer || is_pynative_mode) {
+    return;
+  }
+
+  auto kernel_mod = AnfAlgo::GetKernelMod(kernel);
+  MS_EXCEPTION_IF_NULL(kernel_mod);
+  kernel::GpuKernel *gpu_kernel = dynamic_cast<kernel::GpuKernel *>(kernel_mod);
+  MS_EXCEPTION_IF_NULL(gpu_kernel);
+  device::DynamicKernelPtr dynamic_kernel = gpu_kernel->DynamicKernel();
+  MS_EXCEPTION_IF_NULL(dynamic_kernel);
+  dynamic_kernel->UpdateArgs();
+}
+
 bool GPUDeviceContext::LaunchKernel(const CNodePtr &kernel, const std::vector<AddressPtr> &inputs,
                                     const std::vector<AddressPtr> &workspace, const std::vector<AddressPtr> &outputs,
                                     bool is_dynamic_shape) const {
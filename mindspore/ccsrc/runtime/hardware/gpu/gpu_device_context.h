@@ -60,6 +60,7 @@ class GPUDeviceContext : public DeviceContext {
 
   // Infer kernel shape and update abstract info for dynamic shape kernel.
   void UpdateDynamicShape(const CNodePtr &kernel) const override;
+  void ResizeKernel(const CNodePtr &kernel) const override;
 
   bool LaunchKernel(const CNodePtr &kernel, const std::vector<AddressPtr> &inputs,
                     const std::vector<AddressPtr> &workspace, const std::vector<AddressPtr> &outputs,
@@ -0,0 +1,121 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/op_builder/op_trace.h"
+#include <map>
+#include <set>
+#include <sstream>
+#include <utility>
+#include "utils/utils.h"
+
+namespace mindspore::runtime {
+namespace {
+// The sequence of one op has nothing to merge.
+constexpr size_t kMinOpTraceSize = 2;
+}  // namespace
+
+OpTraceGraph *OpTraceCache::Capture(const std::string &key) {
+  auto iter = trace_graphs_.find(key);
+  if (iter == trace_graphs_.end()) {
+    if (trace_graphs_.size() >= max_trace_num_) {
+      return nullptr;
+    }
+    iter = trace_graphs_.emplace(key, OpTraceGraph()).first;
+  }
+  auto &trace_graph = iter->second;
+  ++trace_graph.capture_count_;
+  if ((!trace_graph.is_replayable_) || (trace_graph.capture_count_ < replay_threshold_)) {
+    return nullptr;
+  }
+  return &trace_graph;
+}
+
+bool CaptureOpTrace(std::queue<std::shared_ptr<OpTask>> op_run_tasks, OpTrace *trace) {
+  MS_EXCEPTION_IF_NULL(trace);
+  if (op_run_tasks.size() < kMinOpTraceSize) {
+    return false;
+  }
+
+  // The ops of the same single op graph in the op cache share the output device tensors until the graph runs, so the
+  // trace in which a single op graph repeats can't bind the outputs of the merged graph to the ops.
+  std::set<KernelGraphPtr> captured_graphs;
+
+  std::ostringstream key;
+  // The output device tensor of op in the trace to the op index and the output index.
+  std::map<const DeviceTensor *, std::pair<size_t, size_t>> op_outputs;
+  std::map<const tensor::Tensor *, size_t> input_tensor_indexes;
+  MS_EXCEPTION_IF_NULL(op_run_tasks.front());
+  MS_EXCEPTION_IF_NULL(op_run_tasks.front()->context());
+  bool is_pynative_infer = op_run_tasks.front()->context()->is_pynative_infer();
+  key << is_pynative_infer;
+  while (!op_run_tasks.empty()) {
+    MS_EXCEPTION_IF_NULL(op_run_tasks.front());
+    const auto context = op_run_tasks.front()->context();
+    op_run_tasks.pop();
+    MS_EXCEPTION_IF_NULL(context);
+    const auto &graph = context->graph();
+    MS_EXCEPTION_IF_NULL(graph);
+    const auto &op_run_info = context->op_run_info();
+    if ((!captured_graphs.insert(graph).second) || (graph->execution_order().size() != 1) ||
+        op_run_info.is_gradient_out || (context->is_pynative_infer() != is_pynative_infer) ||
+        (kOpCacheBlackList.find(op_run_info.op_name) != kOpCacheBlackList.end())) {
+      return false;
+    }
+    const auto &kernel = graph->execution_order().front();
+    auto op_index = trace->contexts_.size();
+    (void)trace->contexts_.emplace_back(context);
+
+    key << op_run_info.graph_info << "(";
+    auto &op_inputs = trace->op_inputs_.emplace_back();
+    for (size_t i = 0; i < op_run_info.input_tensors.size(); ++i) {
+      const auto &input_tensor = op_run_info.input_tensors[i];
+      MS_EXCEPTION_IF_NULL(input_tensor);
+      if (op_run_info.tensor_mask[i] == kValueNodeTensorMask) {
+        (void)op_inputs.emplace_back(session::OpSequenceInput{session::kOpSequenceExternalInput, 0});
+        key << "v,";
+        continue;
+      }
+      // The input is the output of the former op in the trace.
+      auto device_tensor = dynamic_cast<const DeviceTensor *>(input_tensor->device_address().get());
+      auto iter = op_outputs.find(device_tensor);
+      if ((device_tensor != nullptr) && (iter != op_outputs.end())) {
+        (void)op_inputs.emplace_back(session::OpSequenceInput{iter->second.first, iter->second.second});
+        key << "o" << iter->second.first << "_" << iter->second.second << ",";
+        continue;
+      }
+      // The input is from outside of the trace, the same tensor is the same input.
+      auto ret = input_tensor_indexes.emplace(input_tensor.get(), trace->input_tensors_.size());
+      if (ret.second) {
+        (void)trace->input_tensors_.emplace_back(input_tensor);
+      }
+      (void)op_inputs.emplace_back(session::OpSequenceInput{session::kOpSequenceExternalInput, ret.first->second});
+      key << "e" << ret.first->second << ",";
+    }
+    key << ")";
+
+    for (const auto &output_node : context->output_nodes()) {
+      if (output_node.first != kernel) {
+        return false;
+      }
+      const auto &device_tensor = AnfAlgo::GetMutableOutputAddr(kernel, output_node.second, false);
+      MS_EXCEPTION_IF_NULL(device_tensor);
+      op_outputs[device_tensor.get()] = std::make_pair(op_index, output_node.second);
+    }
+  }
+  trace->key_ = key.str();
+  return true;
+}
+}  // namespace mindspore::runtime
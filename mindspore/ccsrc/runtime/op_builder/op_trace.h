@@ -0,0 +1,76 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_MINDSPORE_CCSRC_RUNTIME_OP_BUILDER_OP_TRACE_H_
+#define MINDSPORE_MINDSPORE_CCSRC_RUNTIME_OP_BUILDER_OP_TRACE_H_
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include "runtime/op_builder/op_lazy_builder.h"
+
+namespace mindspore::runtime {
+// The op sequence in the queue of OpLazyBuilder. The training loop in PyNative mode runs the same op sequence every
+// step, so the queue flushed in every step is the same trace, which can be replayed by one merged graph instead of
+// building and running the single op graphs one by one.
+struct OpTrace {
+  // The key is built by the single op graph info of ops and the data flow between the ops.
+  std::string key_;
+  std::vector<std::shared_ptr<OpLazyBuilderContext>> contexts_;
+  // The source of every input of ops, the value node inputs are ignored.
+  std::vector<std::vector<session::OpSequenceInput>> op_inputs_;
+  // The distinct input tensors from outside of the op sequence.
+  std::vector<tensor::TensorPtr> input_tensors_;
+};
+
+// The merged graph of the trace.
+struct OpTraceGraph {
+  // The number of times that the trace is captured, the trace is replayed when it repeats.
+  size_t capture_count_{0};
+  // False if the merged graph failed to build or its kernels don't match the ops, such as the ops fused by the graph
+  // optimization, then the trace always runs the ops one by one.
+  bool is_replayable_{true};
+  KernelGraphPtr graph_{nullptr};
+  std::unique_ptr<GraphCompilerInfo> graph_compiler_info_{nullptr};
+};
+
+// The merged graphs of the captured traces by the key. A trace is replayed from its second capture, and the number of
+// distinct traces is limited, so the op sequences which diverge every step don't keep building merged graphs.
+class OpTraceCache {
+ public:
+  OpTraceCache(size_t max_trace_num, size_t replay_threshold)
+      : max_trace_num_(max_trace_num), replay_threshold_(replay_threshold) {}
+  ~OpTraceCache() = default;
+
+  // Count the capture of the trace. Return the merged graph of the trace if it is to be replayed, otherwise nullptr.
+  OpTraceGraph *Capture(const std::string &key);
+  size_t size() const { return trace_graphs_.size(); }
+  void Clear() { trace_graphs_.clear(); }
+
+ private:
+  size_t max_trace_num_;
+  size_t replay_threshold_;
+  std::map<std::string, OpTraceGraph> trace_graphs_;
+};
+
+// Capture the trace from the op run tasks, no matter whether the single op graphs are built in this flush or fetched
+// from the single op cache. Return false if the tasks can't be replayed by the merged graph, in which case the op run
+// tasks must run one by one.
+bool CaptureOpTrace(std::queue<std::shared_ptr<OpTask>> op_run_tasks, OpTrace *trace);
+}  // namespace mindspore::runtime
+#endif  // MINDSPORE_MINDSPORE_CCSRC_RUNTIME_OP_BUILDER_OP_TRACE_H_
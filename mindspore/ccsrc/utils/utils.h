@@ -355,6 +355,7 @@ constexpr auto kIsBackendCast = "is_backed_cast";
 constexpr auto kAttrOutputNames = "output_names";
 constexpr auto kAttrAsync = "async";
 constexpr auto kAttrOffload = "offload";
+constexpr auto kAttrOpSequenceGraph = "op_sequence_graph";
 constexpr auto kAttrVisited = "visited";
 constexpr auto kAttrShape = "shape";
 constexpr auto kAttrMomentum = "momentum";
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <vector>
 #include <map>
+#include <set>
 
 #include "vm/transform.h"
 #include "backend/session/session_factory.h"
@@ -34,6 +35,7 @@
 #include "utils/ms_utils.h"
 #include "runtime/hardware/device_context_manager.h"
 #include "runtime/framework/graph_compiler.h"
+#include "runtime/device/kernel_select_cache.h"
 #include "utils/scoped_long_running.h"
 #ifdef ENABLE_GE
 #include "utils/callbacks_ge.h"
@@ -133,6 +135,17 @@ VectorRef MsBackend::MsSimuRunGraph(const GraphId &g) {
 }
 
 namespace {
+// The maximum number of the op sequences captured in PyNative mode.
+constexpr size_t kMaxOpTraceNum = 16;
+// The op sequence is replayed by the merged graph from the second time it is captured.
+constexpr size_t kOpTraceReplayThreshold = 2;
+
+// The op trace is opt-in, since it defers the non-first iterations to the lazy build queue.
+bool IsOpTraceEnabled() {
+  static const bool is_op_trace_enabled = (common::GetEnv("MS_DEV_ENABLE_PYNATIVE_OP_TRACE") == "1");
+  return is_op_trace_enabled;
+}
+
 void PushInputTensor(const BaseRef &arg, std::vector<tensor::TensorPtr> *inputs) {
   MS_EXCEPTION_IF_NULL(inputs);
   if (utils::isa<tensor::TensorPtr>(arg)) {
@@ -393,7 +406,7 @@ void MsBackend::SetDebugger() {
 #endif
 
 MindRTBackend::MindRTBackend(const std::string &backend_name, const std::string &device_name, uint32_t device_id)
-    : Backend(backend_name), device_name_(device_name) {
+    : Backend(backend_name), op_trace_cache_(kMaxOpTraceNum, kOpTraceReplayThreshold), device_name_(device_name) {
   root_graph_ = nullptr;
   auto ms_context = MsContext::GetInstance();
   const bool pynative_mode = (ms_context->get_param<int>(MS_CTX_EXECUTION_MODE) == kPynativeMode);
@@ -444,6 +457,9 @@ const ActorInfo &MindRTBackend::CompileGraphs(const FuncGraphPtr &func_graph) {
     }
   }
 
+  // Save the kernel selection results of the graphs compiled for the first time.
+  device::KernelSelectCache::GetInstance().Flush();
+
   // Construct the graph compiler info.
   auto graph_compiler_info = ConstructGraphCompilerInfo(root_graph);
 
@@ -1281,6 +1297,14 @@ void MindRTBackend::LazyExecuteTaskCallback() {
     MS_EXCEPTION_IF_NULL(ms_context);
     auto infer_flag = ms_context->get_param<bool>(MS_CTX_ENABLE_PYNATIVE_INFER);
 
+    // Replay the whole op sequence by the merged graph when it repeats, otherwise build and run the ops one by one.
+    if (RunOpTrace(op_lazy_builder.GetOpBuildTasks(), op_lazy_builder.GetOpRunTasks())) {
+      op_lazy_builder.ClearAllResources();
+      ms_context->set_param<bool>(MS_CTX_ENABLE_PYNATIVE_INFER, infer_flag);
+      MS_LOG(DEBUG) << "End";
+      return;
+    }
+
     CompileSingleOpGraphs(op_lazy_builder.GetOpBuildTasks());
     op_lazy_builder.ClearOpBuildTasks();
 
@@ -1323,6 +1347,170 @@ void MindRTBackend::LazyExecuteTaskCallback() {
   }
 }
 
+void MindRTBackend::CompileOpTraceGraph(const runtime::OpTrace &trace, runtime::OpTraceGraph *trace_graph) {
+  MS_EXCEPTION_IF_NULL(trace_graph);
+  MS_EXCEPTION_IF_NULL(graph_compiler_);
+  std::vector<OpRunInfo> op_run_infos;
+  for (const auto &context : trace.contexts_) {
+    MS_EXCEPTION_IF_NULL(context);
+    (void)op_run_infos.emplace_back(context->op_run_info());
+  }
+  auto device_context = trace.contexts_.front()->device_context();
+  MS_EXCEPTION_IF_NULL(device_context);
+
+  KernelGraphPtr graph;
+  try {
+    graph = graph_compiler_->CompileOpSequenceGraph(op_run_infos, trace.op_inputs_, device_context);
+  } catch (const std::exception &e) {
+    MS_LOG(INFO) << "Build the merged graph of op sequence failed, run the ops one by one. " << e.what();
+    trace_graph->is_replayable_ = false;
+    return;
+  }
+  MS_EXCEPTION_IF_NULL(graph);
+
+  // The outputs of merged graph are bound to the output tensors of ops in order. The elementwise ops may be fused into
+  // one kernel, so every output of the graph must be a kernel output instead of every op being a kernel.
+  const auto &graph_outputs = AnfAlgo::GetAllOutputWithIndex(graph->output());
+  size_t op_output_num = 0;
+  for (const auto &context : trace.contexts_) {
+    op_output_num += context->output_nodes().size();
+  }
+  if ((graph_outputs.size() != op_output_num) || (graph->input_nodes().size() != trace.input_tensors_.size())) {
+    MS_LOG(INFO) << "The merged graph of op sequence is changed by the optimization, run the ops one by one.";
+    trace_graph->is_replayable_ = false;
+    return;
+  }
+  for (const auto &output : graph_outputs) {
+    MS_EXCEPTION_IF_NULL(output.first);
+    if ((!output.first->isa<CNode>()) || (!AnfUtils::IsRealKernel(output.first))) {
+      MS_LOG(INFO) << "The output " << output.first->DebugString()
+                   << " of merged graph isn't a kernel output, run the ops one by one.";
+      trace_graph->is_replayable_ = false;
+      return;
+    }
+  }
+
+  runtime::KernelMapPosition outputs_order;
+  size_t position = 0;
+  for (const auto &output : graph_outputs) {
+    (void)outputs_order[output].emplace_back(position++);
+  }
+  auto name = "op_trace_" + std::to_string(graph->graph_id());
+  auto graph_compiler_info = std::make_unique<GraphCompilerInfo>(
+    std::vector<KernelGraphPtr>{graph}, std::vector<DeviceContext *>{device_context},
+    std::vector<std::vector<int64_t> *>(), std::vector<std::vector<TensorPtr> *>(), std::vector<AnfNodePtr>(),
+    std::vector<AnfNodePtr>(), std::make_shared<ControlNodeParser>(), outputs_order, 0, name, false,
+    runtime::GraphExecutionStrategy::kStep);
+  auto actor_set = runtime::GraphScheduler::GetInstance().Transform(*graph_compiler_info);
+  runtime::GraphScheduler::GetInstance().Schedule(actor_set);
+
+  trace_graph->graph_ = graph;
+  trace_graph->graph_compiler_info_ = std::move(graph_compiler_info);
+  MS_LOG(INFO) << "Build the merged graph " << name << " of the op sequence with " << op_run_infos.size() << " ops and "
+               << graph->execution_order().size() << " kernels.";
+}
+
+bool MindRTBackend::RunOpTrace(const std::vector<std::shared_ptr<runtime::OpTask>> &op_build_tasks,
+                               const std::queue<std::shared_ptr<runtime::OpTask>> &op_run_tasks) {
+  if (!IsOpTraceEnabled()) {
+    return false;
+  }
+  runtime::OpTrace trace;
+  if (!runtime::CaptureOpTrace(op_run_tasks, &trace)) {
+    return false;
+  }
+
+  // The op sequence which diverges from the captured traces runs the ops one by one.
+  auto trace_graph_ptr = op_trace_cache_.Capture(trace.key_);
+  if (trace_graph_ptr == nullptr) {
+    return false;
+  }
+  auto &trace_graph = *trace_graph_ptr;
+
+  auto ms_context = MsContext::GetInstance();
+  MS_EXCEPTION_IF_NULL(ms_context);
+  const auto &front_context = trace.contexts_.front();
+  MS_EXCEPTION_IF_NULL(front_context);
+  ms_context->set_param<bool>(MS_CTX_ENABLE_PYNATIVE_INFER, front_context->is_pynative_infer());
+  if (trace_graph.graph_ == nullptr) {
+    CompileOpTraceGraph(trace, &trace_graph);
+    if (!trace_graph.is_replayable_) {
+      return false;
+    }
+  }
+  const auto &graph = trace_graph.graph_;
+  MS_EXCEPTION_IF_NULL(graph);
+  MS_EXCEPTION_IF_NULL(trace_graph.graph_compiler_info_);
+
+  // The output tensors of ops have been returned to python, so the outputs of kernels are written to their device
+  // tensors directly, which requires the same device format and type.
+  // The graph outputs are the outputs of ops in order.
+  const auto &graph_outputs = AnfAlgo::GetAllOutputWithIndex(graph->output());
+  std::vector<std::pair<device::DeviceAddressPtr, KernelWithIndex>> output_device_tensors;
+  size_t op_output_offset = 0;
+  for (const auto &context : trace.contexts_) {
+    for (const auto &output_node : context->output_nodes()) {
+      const auto &device_tensor = AnfAlgo::GetMutableOutputAddr(output_node.first, output_node.second, false);
+      MS_EXCEPTION_IF_NULL(device_tensor);
+      const auto &graph_output = graph_outputs.at(op_output_offset + output_node.second);
+      if ((device_tensor->format() != AnfAlgo::GetOutputFormat(graph_output.first, graph_output.second)) ||
+          (device_tensor->type_id() != AnfAlgo::GetOutputDeviceDataType(graph_output.first, graph_output.second))) {
+        MS_LOG(INFO) << "The output " << graph_output.second << " of kernel "
+                     << graph_output.first->fullname_with_scope()
+                     << " in the merged graph mismatches the op output, run the ops one by one.";
+        trace_graph.is_replayable_ = false;
+        return false;
+      }
+      (void)output_device_tensors.emplace_back(device_tensor, graph_output);
+    }
+    op_output_offset += context->output_nodes().size();
+  }
+  for (const auto &item : output_device_tensors) {
+    AnfAlgo::SetOutputAddr(item.first, item.second.second, item.second.first.get());
+  }
+
+  for (auto &tensor : trace.input_tensors_) {
+    MS_EXCEPTION_IF_NULL(tensor);
+    if (tensor->NeedWaitDevice()) {
+      tensor->WaitDevice();
+    }
+  }
+  const auto &actor_set = runtime::GraphScheduler::GetInstance().Fetch(trace_graph.graph_compiler_info_->name_);
+  MS_EXCEPTION_IF_NULL(actor_set);
+  runtime::GraphScheduler::GetInstance().Run(actor_set, {}, {trace.input_tensors_}, {},
+                                             runtime::GraphExecutionStrategy::kStep);
+  ClearGraphDeviceAddress(graph, front_context->device_context(), false);
+  UpdateInputDeviceAddress(graph);
+
+  // The single op graphs built in this flush are replaced by the merged graph, which are never built, so erase them
+  // from the single op cache. The single op graphs fetched from the cache stay in it for the next step, and their
+  // outputs are renewed since the output device tensors are returned to python.
+  std::set<KernelGraphPtr> unbuilt_graphs;
+  for (const auto &op_build_task : op_build_tasks) {
+    MS_EXCEPTION_IF_NULL(op_build_task);
+    MS_EXCEPTION_IF_NULL(op_build_task->context());
+    (void)unbuilt_graphs.insert(op_build_task->context()->graph());
+  }
+  for (const auto &context : trace.contexts_) {
+    const auto &op_run_info = context->op_run_info();
+    if (!ms_context->get_param<bool>(MS_CTX_ENABLE_PYNATIVE_INFER)) {
+      graph_compiler_->UpdateForwardOpOutputRefCount(op_run_info.input_tensors, &forward_op_output_tensor_id_);
+    }
+    MS_EXCEPTION_IF_NULL(context->graph());
+    MS_EXCEPTION_IF_NULL(context->graph_compiler_info());
+    if (unbuilt_graphs.count(context->graph()) == 0) {
+      ClearGraphDeviceAddress(context->graph(), context->device_context(), false);
+      UpdateInputDeviceAddress(context->graph());
+      continue;
+    }
+    graph_compiler_->EraseSingleOpCache(op_run_info.graph_info, context->graph()->graph_id());
+    auto actor_info = context->graph_compiler_info()->name_;
+    (void)actor_to_graph_compiler_info_.erase(actor_info);
+  }
+  MS_LOG(DEBUG) << "Replay the merged graph " << trace_graph.graph_compiler_info_->name_;
+  return true;
+}
+
 void MindRTBackend::RunOpInternal(bool single_op_cache_hit, GraphCompilerInfo *graph_compiler_info,
                                   OpRunInfo *op_run_info, VectorRef *outputs) {
   MS_EXCEPTION_IF_NULL(op_run_info);
@@ -1338,10 +1526,12 @@ void MindRTBackend::RunOpInternal(bool single_op_cache_hit, GraphCompilerInfo *g
   auto &op_lazy_builder = runtime::OpLazyBuilder::GetInstance();
   // Disable lazy build when:
   // 1. Execute Dynamic shape operator. The output shape depends on the calculation result of the operator.
-  // 2. Cache hit and there are no tasks in Queue. For example Non-first iteration.
+  // 2. Cache hit and there are no tasks in Queue. For example Non-first iteration. Unless the op trace is enabled, in
+  // which case the ops of non-first iteration are queued to be captured and replayed by the merged graph.
   // 3. Not in nn.Cell construct.
   bool lazy_build_disabled = graph_compiler_info->need_erase_ ||
-                             (single_op_cache_hit && op_lazy_builder.QueueEmpty()) || !op_run_info->lazy_build;
+                             (single_op_cache_hit && op_lazy_builder.QueueEmpty() && !IsOpTraceEnabled()) ||
+                             !op_run_info->lazy_build;
   if (lazy_build_disabled) {
     if (!op_lazy_builder.QueueEmpty()) {
       op_lazy_builder.ExecuteRemainingTasks();
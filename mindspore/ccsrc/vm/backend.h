@@ -34,6 +34,7 @@
 #include "runtime/hardware/device_context.h"
 #include "runtime/framework/graph_scheduler.h"
 #include "runtime/op_builder/op_lazy_builder.h"
+#include "runtime/op_builder/op_trace.h"
 
 namespace mindspore {
 namespace compile {
@@ -170,6 +171,14 @@ class MindRTBackend : public Backend {
   // Execute OpBuildTask and OpRunTask when the OpLazyBuilder queue is full in PyNative mode.
   void LazyExecuteTaskCallback();
 
+  // Replay the op run tasks in the OpLazyBuilder queue by the merged graph when the op sequence repeats in PyNative
+  // mode. Return false if the op run tasks need to be built and run one by one.
+  bool RunOpTrace(const std::vector<std::shared_ptr<runtime::OpTask>> &op_build_tasks,
+                  const std::queue<std::shared_ptr<runtime::OpTask>> &op_run_tasks);
+
+  // Build the merged graph of the trace and transform it to the actor set.
+  void CompileOpTraceGraph(const runtime::OpTrace &trace, runtime::OpTraceGraph *trace_graph);
+
   // Run op immediately or save OpBuildTask and OpRunTask in OpLazyBuilder.
   void RunOpInternal(bool single_op_cache_hit, GraphCompilerInfo *graph_compiler_info, OpRunInfo *op_run_info,
                      VectorRef *outputs);
@@ -191,6 +200,9 @@ class MindRTBackend : public Backend {
 
   mindspore::HashMap<ActorInfo, std::unique_ptr<GraphCompilerInfo>> actor_to_graph_compiler_info_;
 
+  // The merged graphs of the op sequences captured in PyNative mode.
+  runtime::OpTraceCache op_trace_cache_;
+
   // Cache output tensor ref count of kernels for back propagation graph in PyNative mode.
   std::map<GraphId, std::map<KernelWithIndex, size_t>> cnode_ref_counts_;
 
@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_CORE_IR_DEVICE_SYNC_H_
 #define MINDSPORE_CORE_IR_DEVICE_SYNC_H_
 
+#include <atomic>
 #include <vector>
 #include <memory>
 #include <string>
@@ -63,13 +64,14 @@ class DeviceSync {
       original_ref_count_--;
     }
   }
-  void DecreaseRefCount() { ref_count_--; }
+  // Return the decreased count, which tells the only one of the concurrent decreasers who decreases it to zero.
+  size_t DecreaseRefCount() { return --ref_count_; }
   void ResetRefCount() { ref_count_ = original_ref_count_; }
 
  protected:
   mutable size_t original_ref_count_{1};
   // It will be decreased in the running, and reset by original_ref_count_ when it is zero.
-  mutable size_t ref_count_{1};
+  mutable std::atomic<size_t> ref_count_{1};
 };
 using DeviceSyncPtr = std::shared_ptr<DeviceSync>;
 }  // namespace mindspore
@@ -83,6 +83,11 @@ class ActorBase {
   // Judge if actor running by the received message number, the default is true.
   virtual bool IsActive(int msg_num) { return true; }
 
+  // The actor with larger priority runs first when several actors are ready in the thread pool. The actors with the
+  // default priority 0 are run in FIFO order after the prioritized ones.
+  void set_priority(int64_t priority) { priority_ = priority; }
+  int64_t priority() const { return priority_; }
+
  protected:
   using ActorFunction = std::function<void(const std::unique_ptr<MessageBase> &msg)>;
 
@@ -210,6 +215,7 @@ class ActorBase {
   uint32_t recordNextPoint = 0;
 
   ActorThreadPool *pool_{nullptr};
+  int64_t priority_{0};
 };
 using ActorReference = std::shared_ptr<ActorBase>;
 };  // namespace mindspore
@@ -0,0 +1,163 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CORE_MINDRT_INCLUDE_ACTOR_ACTOR_TRACE_H
+#define MINDSPORE_CORE_MINDRT_INCLUDE_ACTOR_ACTOR_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mindspore {
+enum class ActorTraceEventType : uint8_t {
+  // From the message enqueued into the mailbox to the message dequeued by the actor thread.
+  kMailboxWait = 0,
+  // The message processing of actor.
+  kMessageRun,
+  // From the last input of actor starting being processed to the actor running.
+  kRunLatency,
+  // The kernel launch of kernel actor.
+  kKernelLaunch,
+  // From the memory allocation request sent to the memory manager actor to the allocation finished callback.
+  kMemoryWait,
+  // The memory allocation and free in the memory manager actor.
+  kMemoryAlloc,
+  kMemoryFree,
+  kEventTypeEnd,
+};
+
+struct ActorTraceEvent {
+  static constexpr size_t kMaxNameLength = 64;
+  uint64_t begin_ns{0};
+  uint64_t end_ns{0};
+  ActorTraceEventType type{ActorTraceEventType::kEventTypeEnd};
+  char name[kMaxNameLength]{0};
+};
+
+// The ring buffer of trace events written by one thread only, so the recording is lock free. The oldest events are
+// overwritten when the buffer is full. Every slot has a sequence number which is the index of the event in it plus one,
+// or zero while the event is being written, so the reader running with the writer skips the slots being overwritten.
+class ActorTraceBuffer {
+ public:
+  ActorTraceBuffer(size_t thread_index, size_t capacity);
+  ~ActorTraceBuffer() = default;
+
+  void Push(ActorTraceEventType type, const std::string &name, uint64_t begin_ns, uint64_t end_ns);
+  // Copy the event of the index, return false if it has been overwritten or is being overwritten.
+  bool Read(uint64_t index, ActorTraceEvent *event) const;
+  size_t thread_index() const { return thread_index_; }
+
+ private:
+  friend class ActorTrace;
+  size_t thread_index_;
+  std::vector<ActorTraceEvent> events_;
+  std::vector<std::atomic<uint64_t>> sequences_;
+  size_t mask_;
+  // The total number of events written, the event i is in the position (i & mask_).
+  std::atomic<uint64_t> write_count_{0};
+  // The number of events already summarised, which is only accessed by the reader.
+  uint64_t summary_count_{0};
+};
+
+// The lightweight trace of the actor scheduling, which records the mailbox wait, run latency, kernel launch and memory
+// manager wait into the per thread ring buffers. The capture can be toggled at runtime by set_enabled and is initially
+// enabled by the env MS_DEV_ACTOR_TRACE=1, the recording is skipped by one relaxed atomic load when disabled. The
+// events are exported as the chrome trace json which can be loaded by chrome://tracing or perfetto.
+class ActorTrace {
+ public:
+  static ActorTrace &GetInstance();
+  static uint64_t NowNs();
+
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+  void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+  void Record(ActorTraceEventType type, const std::string &name, uint64_t begin_ns, uint64_t end_ns);
+
+  // The time when the current thread starts processing the message, which is zero if not traced.
+  static uint64_t current_message_time();
+  static void set_current_message_time(uint64_t time_ns);
+
+  // Summarise the events recorded since the last summary by the event type, which is called at the end of step. The
+  // events being overwritten by the writers meanwhile are skipped.
+  std::string StepSummary();
+
+  // Whether any event is recorded.
+  bool HasEvents();
+
+  // Export the events as chrome trace json. The events being overwritten by the writers meanwhile are skipped.
+  bool ExportChromeTrace(const std::string &path);
+
+ private:
+  ActorTrace();
+  ~ActorTrace() = default;
+  ActorTrace(const ActorTrace &) = delete;
+  ActorTrace &operator=(const ActorTrace &) = delete;
+
+  ActorTraceBuffer *ThreadBuffer();
+
+  std::atomic<bool> enabled_{false};
+  uint64_t start_ns_{0};
+  size_t buffer_capacity_;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<ActorTraceBuffer>> buffers_;
+};
+
+// Record the duration of the scope if the trace is enabled when entering the scope.
+class ActorTraceScope {
+ public:
+  ActorTraceScope(ActorTraceEventType type, const std::string &name)
+      : type_(type), name_(name), begin_ns_(ActorTrace::GetInstance().enabled() ? ActorTrace::NowNs() : 0) {}
+  ~ActorTraceScope() {
+    if (begin_ns_ != 0) {
+      ActorTrace::GetInstance().Record(type_, name_, begin_ns_, ActorTrace::NowNs());
+    }
+  }
+
+ private:
+  ActorTraceEventType type_;
+  const std::string &name_;
+  uint64_t begin_ns_;
+};
+
+// Record the mailbox wait and the processing of the message, the enqueue time of message is zero if not traced. The
+// processing begin time is kept in the thread for the run latency of the actor triggered by the message.
+class ActorTraceMessageScope {
+ public:
+  ActorTraceMessageScope(const std::string &name, uint64_t enqueue_time_ns) : name_(name), begin_ns_(0) {
+    if ((enqueue_time_ns == 0) || (!ActorTrace::GetInstance().enabled())) {
+      return;
+    }
+    begin_ns_ = ActorTrace::NowNs();
+    ActorTrace::GetInstance().Record(ActorTraceEventType::kMailboxWait, name_, enqueue_time_ns, begin_ns_);
+    ActorTrace::set_current_message_time(begin_ns_);
+  }
+  ~ActorTraceMessageScope() {
+    if (begin_ns_ != 0) {
+      ActorTrace::GetInstance().Record(ActorTraceEventType::kMessageRun, name_, begin_ns_, ActorTrace::NowNs());
+      ActorTrace::set_current_message_time(0);
+    }
+  }
+
+ private:
+  const std::string &name_;
+  uint64_t begin_ns_;
+};
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CORE_MINDRT_INCLUDE_ACTOR_ACTOR_TRACE_H
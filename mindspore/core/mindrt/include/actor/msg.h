@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_CORE_MINDRT_INCLUDE_ACTOR_MSG_H
 #define MINDSPORE_CORE_MINDRT_INCLUDE_ACTOR_MSG_H
 
+#include <cstdint>
 #include <utility>
 #include <string>
 
@@ -79,6 +80,8 @@ class MessageBase {
   std::string name;
   std::string body;
   Type type;
+  // The time of the message enqueued into the mailbox, which is only recorded when the actor trace is enabled.
+  uint64_t enqueue_time_ns{0};
 };
 }  // namespace mindspore
 
@@ -16,6 +16,7 @@
 
 #include "actor/actor.h"
 #include "actor/actormgr.h"
+#include "actor/actor_trace.h"
 #include "actor/iomgr.h"
 
 namespace mindspore {
@@ -80,6 +81,9 @@ void ActorBase::HandlekMsg(const std::unique_ptr<MessageBase> &msg) {
   }
 }
 int ActorBase::EnqueMessage(std::unique_ptr<MessageBase> msg) const {
+  if (ActorTrace::GetInstance().enabled()) {
+    msg->enqueue_time_ns = ActorTrace::NowNs();
+  }
   int ret = mailbox->EnqueueMessage(std::move(msg));
   return ret;
 }
@@ -93,6 +97,7 @@ void ActorBase::Quit() {
 void ActorBase::Run() {
   auto msgHandler = [this](const std::unique_ptr<MessageBase> &msg) {
     AddMsgRecord(msg->Name());
+    ActorTraceMessageScope trace_scope(id.Name(), msg->enqueue_time_ns);
     switch (msg->GetType()) {
       case MessageBase::Type::KMSG:
       case MessageBase::Type::KUDP: {
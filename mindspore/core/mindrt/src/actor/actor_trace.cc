@@ -0,0 +1,212 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "actor/actor_trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "actor/log.h"
+
+namespace mindspore {
+namespace {
+// The event number of the ring buffer in every thread, which must be the power of 2.
+constexpr size_t kDefaultTraceBufferCapacity = 1 << 15;
+constexpr double kNsToUs = 1000.0;
+
+const char *EventTypeName(ActorTraceEventType type) {
+  static const char *kEventTypeNames[] = {"MailboxWait", "MessageRun", "RunLatency", "KernelLaunch",
+                                          "MemoryWait",  "MemoryAlloc", "MemoryFree"};
+  auto index = static_cast<size_t>(type);
+  if (index >= static_cast<size_t>(ActorTraceEventType::kEventTypeEnd)) {
+    return "Unknown";
+  }
+  return kEventTypeNames[index];
+}
+
+void WriteJsonString(const char *str, std::ofstream *ofs) {
+  *ofs << '"';
+  for (const char *c = str; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      *ofs << '\\' << *c;
+    } else if (static_cast<unsigned char>(*c) >= 0x20) {
+      *ofs << *c;
+    }
+  }
+  *ofs << '"';
+}
+
+thread_local ActorTraceBuffer *thread_trace_buffer = nullptr;
+thread_local uint64_t thread_current_message_time = 0;
+}  // namespace
+
+ActorTraceBuffer::ActorTraceBuffer(size_t thread_index, size_t capacity)
+    : thread_index_(thread_index), events_(capacity), sequences_(capacity), mask_(capacity - 1) {}
+
+void ActorTraceBuffer::Push(ActorTraceEventType type, const std::string &name, uint64_t begin_ns, uint64_t end_ns) {
+  auto count = write_count_.load(std::memory_order_relaxed);
+  auto &sequence = sequences_[count & mask_];
+  // Invalidate the slot before overwriting the event in it.
+  sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  auto &event = events_[count & mask_];
+  event.type = type;
+  event.begin_ns = begin_ns;
+  event.end_ns = end_ns;
+  auto name_length = std::min(name.size(), ActorTraceEvent::kMaxNameLength - 1);
+  (void)memcpy(event.name, name.data(), name_length);
+  event.name[name_length] = '\0';
+  // Publish the event to the reader.
+  sequence.store(count + 1, std::memory_order_release);
+  write_count_.store(count + 1, std::memory_order_release);
+}
+
+bool ActorTraceBuffer::Read(uint64_t index, ActorTraceEvent *event) const {
+  const auto &sequence = sequences_[index & mask_];
+  if (sequence.load(std::memory_order_acquire) != index + 1) {
+    return false;
+  }
+  *event = events_[index & mask_];
+  // The event is torn if the slot is overwritten during the copy.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return sequence.load(std::memory_order_relaxed) == index + 1;
+}
+
+ActorTrace &ActorTrace::GetInstance() {
+  static ActorTrace instance;
+  return instance;
+}
+
+ActorTrace::ActorTrace() : start_ns_(NowNs()), buffer_capacity_(kDefaultTraceBufferCapacity) {
+  const char *trace_env = std::getenv("MS_DEV_ACTOR_TRACE");
+  if (trace_env != nullptr && std::string(trace_env) == "1") {
+    enabled_ = true;
+    MS_LOG(INFO) << "Enable the actor trace.";
+  }
+}
+
+uint64_t ActorTrace::NowNs() {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t ActorTrace::current_message_time() { return thread_current_message_time; }
+
+void ActorTrace::set_current_message_time(uint64_t time_ns) { thread_current_message_time = time_ns; }
+
+ActorTraceBuffer *ActorTrace::ThreadBuffer() {
+  if (thread_trace_buffer == nullptr) {
+    // The buffers are owned by the trace and kept after the thread exits, so the events can still be exported.
+    std::lock_guard<std::mutex> lock(mutex_);
+    (void)buffers_.emplace_back(std::make_unique<ActorTraceBuffer>(buffers_.size(), buffer_capacity_));
+    thread_trace_buffer = buffers_.back().get();
+  }
+  return thread_trace_buffer;
+}
+
+void ActorTrace::Record(ActorTraceEventType type, const std::string &name, uint64_t begin_ns, uint64_t end_ns) {
+  if (!enabled()) {
+    return;
+  }
+  ThreadBuffer()->Push(type, name, begin_ns, end_ns);
+}
+
+std::string ActorTrace::StepSummary() {
+  constexpr size_t kTypeNum = static_cast<size_t>(ActorTraceEventType::kEventTypeEnd);
+  std::vector<uint64_t> counts(kTypeNum, 0);
+  std::vector<uint64_t> total_ns(kTypeNum, 0);
+  std::vector<uint64_t> max_ns(kTypeNum, 0);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &buffer : buffers_) {
+      auto write_count = buffer->write_count_.load(std::memory_order_acquire);
+      auto capacity = buffer->events_.size();
+      auto begin = std::max(buffer->summary_count_, write_count > capacity ? write_count - capacity : 0);
+      ActorTraceEvent event;
+      for (auto i = begin; i < write_count; ++i) {
+        if (!buffer->Read(i, &event)) {
+          continue;
+        }
+        auto type_index = static_cast<size_t>(event.type);
+        if (type_index >= kTypeNum) {
+          continue;
+        }
+        auto duration = event.end_ns > event.begin_ns ? event.end_ns - event.begin_ns : 0;
+        ++counts[type_index];
+        total_ns[type_index] += duration;
+        max_ns[type_index] = std::max(max_ns[type_index], duration);
+      }
+      buffer->summary_count_ = write_count;
+    }
+  }
+
+  std::ostringstream ss;
+  for (size_t i = 0; i < kTypeNum; ++i) {
+    if (counts[i] == 0) {
+      continue;
+    }
+    ss << EventTypeName(static_cast<ActorTraceEventType>(i)) << "[count: " << counts[i]
+       << ", total: " << total_ns[i] / kNsToUs << "us, avg: " << total_ns[i] / counts[i] / kNsToUs
+       << "us, max: " << max_ns[i] / kNsToUs << "us] ";
+  }
+  return ss.str();
+}
+
+bool ActorTrace::HasEvents() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::any_of(buffers_.begin(), buffers_.end(), [](const std::unique_ptr<ActorTraceBuffer> &buffer) {
+    return buffer->write_count_.load(std::memory_order_acquire) > 0;
+  });
+}
+
+bool ActorTrace::ExportChromeTrace(const std::string &path) {
+  std::ofstream ofs(path);
+  if (!ofs.is_open()) {
+    MS_LOG(WARNING) << "Open the actor trace file " << path << " failed.";
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  ofs << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool is_first = true;
+  size_t event_num = 0;
+  ActorTraceEvent event;
+  for (auto &buffer : buffers_) {
+    auto write_count = buffer->write_count_.load(std::memory_order_acquire);
+    auto capacity = buffer->events_.size();
+    for (auto i = write_count > capacity ? write_count - capacity : 0; i < write_count; ++i) {
+      if (!buffer->Read(i, &event)) {
+        continue;
+      }
+      if (!is_first) {
+        ofs << ",";
+      }
+      is_first = false;
+      ofs << "{\"name\":";
+      WriteJsonString(event.name, &ofs);
+      ofs << ",\"cat\":\"" << EventTypeName(event.type) << "\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+          << buffer->thread_index() << ",\"ts\":" << (event.begin_ns - std::min(event.begin_ns, start_ns_)) / kNsToUs
+          << ",\"dur\":" << (event.end_ns > event.begin_ns ? event.end_ns - event.begin_ns : 0) / kNsToUs << "}";
+      ++event_num;
+    }
+  }
+  ofs << "]}";
+  ofs.close();
+  MS_LOG(INFO) << "Export " << event_num << " actor trace events to " << path;
+  return true;
+}
+}  // namespace mindspore
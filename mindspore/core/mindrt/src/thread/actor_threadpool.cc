@@ -76,14 +76,7 @@ ActorThreadPool::~ActorThreadPool() {
   bool terminate = false;
   int count = 0;
   do {
-    {
-#ifdef USE_HQUEUE
-      terminate = actor_queue_.Empty();
-#else
-      std::lock_guard<std::mutex> _l(actor_mutex_);
-      terminate = actor_queue_.empty();
-#endif
-    }
+    terminate = ActorQueueEmpty();
     if (!terminate) {
       for (auto &worker : workers_) {
         worker->Active();
@@ -101,7 +94,40 @@ ActorThreadPool::~ActorThreadPool() {
 #endif
 }
 
+bool ActorThreadPool::ActorQueueEmpty() {
+  if (priority_actor_num_ > 0) {
+    return false;
+  }
+#ifdef USE_HQUEUE
+  return actor_queue_.Empty();
+#else
+  std::lock_guard<std::mutex> _l(actor_mutex_);
+  return actor_queue_.empty();
+#endif
+}
+
+ActorBase *ActorThreadPool::PopPriorityActor() {
+  // Avoid the lock in the common case that no actor has a priority.
+  if (priority_actor_num_ == 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> _l(priority_mutex_);
+  if (priority_queue_.empty()) {
+    return nullptr;
+  }
+  auto actor = priority_queue_.top().actor;
+  priority_queue_.pop();
+  --priority_actor_num_;
+  return actor;
+}
+
 ActorBase *ActorThreadPool::PopActorFromQueue() {
+  // Only the actors on the critical path have the priority, they go ahead of the other ready actors so the long
+  // dependency chain isn't delayed by the short side branches.
+  auto actor = PopPriorityActor();
+  if (actor != nullptr) {
+    return actor;
+  }
 #ifdef USE_HQUEUE
   return actor_queue_.Dequeue();
 #else
@@ -109,7 +135,7 @@ ActorBase *ActorThreadPool::PopActorFromQueue() {
   if (actor_queue_.empty()) {
     return nullptr;
   }
-  auto actor = actor_queue_.front();
+  actor = actor_queue_.front();
   actor_queue_.pop();
   return actor;
 #endif
@@ -119,7 +145,11 @@ void ActorThreadPool::PushActorToQueue(ActorBase *actor) {
   if (!actor) {
     return;
   }
-  {
+  if (actor->priority() > 0) {
+    std::lock_guard<std::mutex> _l(priority_mutex_);
+    priority_queue_.push({actor->priority(), priority_seq_++, actor});
+    ++priority_actor_num_;
+  } else {
 #ifdef USE_HQUEUE
     while (!actor_queue_.Enqueue(actor)) {
     }
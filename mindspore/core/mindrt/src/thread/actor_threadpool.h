@@ -56,8 +56,22 @@ class ActorThreadPool : public ThreadPool {
   ActorBase *PopActorFromQueue();
 
  private:
+  // The ready actor with priority, the earlier one goes first among the same priority.
+  struct PriorityActor {
+    int64_t priority;
+    uint64_t seq;
+    ActorBase *actor;
+  };
+  struct PriorityActorCompare {
+    bool operator()(const PriorityActor &lhs, const PriorityActor &rhs) const {
+      return lhs.priority < rhs.priority || (lhs.priority == rhs.priority && lhs.seq > rhs.seq);
+    }
+  };
+
   ActorThreadPool() {}
   int CreateThreads(size_t actor_thread_num, size_t all_thread_num, const std::vector<int> &core_list);
+  ActorBase *PopPriorityActor();
+  bool ActorQueueEmpty();
   size_t actor_thread_num_{0};
 
   std::mutex actor_mutex_;
@@ -67,6 +81,10 @@ class ActorThreadPool : public ThreadPool {
 #else
   std::queue<ActorBase *> actor_queue_;
 #endif
+  std::mutex priority_mutex_;
+  std::priority_queue<PriorityActor, std::vector<PriorityActor>, PriorityActorCompare> priority_queue_;
+  std::atomic<size_t> priority_actor_num_{0};
+  uint64_t priority_seq_{0};
 };
 }  // namespace mindspore
 #endif  // MINDSPORE_CORE_MINDRT_RUNTIME_ACTOR_THREADPOOL_H_
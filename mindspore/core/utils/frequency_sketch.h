@@ -0,0 +1,119 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CORE_UTILS_FREQUENCY_SKETCH_H_
+#define MINDSPORE_CORE_UTILS_FREQUENCY_SKETCH_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mindspore {
+// The count-min sketch of TinyLFU, which estimates the access frequency of the keys in a recent window, such as the
+// embedding ids of the ps cache and the keys of the dataset cache tiers. Each key is counted by a 4-bit saturating
+// counter in every row, and the frequency is never underestimated, and it is overestimated only when the keys collide
+// in all the rows.
+class FrequencySketch {
+ public:
+  // The number of the rows of the sketch.
+  static constexpr size_t kDepth = 4;
+  static constexpr uint8_t kMaxCount = 15;
+  static constexpr size_t kMinWidth = 16;
+  static constexpr size_t kMaxWidth = 1 << 22;
+  // The counters are halved after the sketch counts sample factor * width keys, so the old frequency is forgotten.
+  static constexpr size_t kSampleFactor = 10;
+
+  // The width is the number of the counters of each row, which is rounded up to a power of 2.
+  explicit FrequencySketch(size_t width) : width_(kMinWidth) {
+    while (width_ < width && width_ < kMaxWidth) {
+      width_ <<= 1;
+    }
+    sample_size_ = kSampleFactor * width_;
+    counters_.resize(kDepth * width_, 0);
+  }
+  ~FrequencySketch() = default;
+
+  void Increment(uint64_t key) {
+    uint64_t hash = Hash(key);
+    size_t indices[kDepth];
+    uint8_t min_count = kMaxCount;
+    for (size_t row = 0; row < kDepth; ++row) {
+      indices[row] = CounterIndex(hash, row);
+      min_count = std::min(min_count, counters_[indices[row]]);
+    }
+    if (min_count == kMaxCount) {
+      return;
+    }
+    // Conservative update: only the minimal counters are increased, which reduces the overestimation of the collision.
+    for (size_t row = 0; row < kDepth; ++row) {
+      if (counters_[indices[row]] == min_count) {
+        ++counters_[indices[row]];
+      }
+    }
+    if (++additions_ >= sample_size_) {
+      Age();
+    }
+  }
+
+  uint8_t Estimate(uint64_t key) const {
+    uint64_t hash = Hash(key);
+    uint8_t min_count = kMaxCount;
+    for (size_t row = 0; row < kDepth; ++row) {
+      min_count = std::min(min_count, counters_[CounterIndex(hash, row)]);
+    }
+    return min_count;
+  }
+
+  void Clear() {
+    std::fill(counters_.begin(), counters_.end(), 0);
+    additions_ = 0;
+  }
+
+  size_t width() const { return width_; }
+
+ private:
+  static uint64_t Hash(uint64_t key) {
+    // The finalizer of splitmix64, which spreads the adjacent keys to the different counters.
+    uint64_t hash = key + 0x9E3779B97F4A7C15ULL;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+    return hash ^ (hash >> 31);
+  }
+
+  size_t CounterIndex(uint64_t hash, size_t row) const {
+    // Double hashing: the rows use the different combinations of the low and the high halves of the hash.
+    constexpr uint64_t kHalfBits = 32;
+    uint64_t low = hash & 0xFFFFFFFFULL;
+    uint64_t high = (hash >> kHalfBits) | 1;
+    return row * width_ + static_cast<size_t>((low + row * high) & (width_ - 1));
+  }
+
+  // Halve all the counters.
+  void Age() {
+    for (auto &counter : counters_) {
+      counter >>= 1;
+    }
+    additions_ /= 2;
+  }
+
+  size_t width_;
+  size_t sample_size_;
+  size_t additions_{0};
+  std::vector<uint8_t> counters_;
+};
+}  // namespace mindspore
+#endif  // MINDSPORE_CORE_UTILS_FREQUENCY_SKETCH_H_
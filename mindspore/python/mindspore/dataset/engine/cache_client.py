@@ -19,7 +19,12 @@ import copy
 from mindspore._c_dataengine import CacheClient
 
 from ..core.validator_helpers import type_check, check_pos_int32, check_pos_uint32, check_uint64, check_positive, \
-    check_value
+    check_value, check_valid_str
+
+# Must match the CacheTierPolicyType of the cache server.
+TIER_POLICIES = {"lru": 1, "lfu": 2, "tinylfu": 3}
+# Must match the CacheCompressionType of the cache server.
+COMPRESSIONS = {"deflate": 1}
 
 
 class DatasetCache:
@@ -39,6 +44,10 @@ class DatasetCache:
         num_connections (int, optional): Number of tcp/ip connections (default=None, use default value 12).
         prefetch_size (int, optional): The size of the cache queue between operations
             (default=None, use default value 20).
+        tier_policy (str, optional): The policy to decide which rows stay in memory when spilling is True, can be
+            'lru', 'lfu' or 'tinylfu' (default=None, the rows stay where they are first written to).
+        compression (str, optional): The compression of the rows stored by the server, can be 'deflate'
+            (default=None, the rows are stored as is).
 
     Examples:
             >>> import mindspore.dataset as ds
@@ -51,7 +60,8 @@ class DatasetCache:
     """
 
     def __init__(self, session_id, size=0, spilling=False, hostname=None, port=None, num_connections=None,
-                 prefetch_size=None):
+                 prefetch_size=None, tier_policy=None,
+                 compression=None):
         check_pos_uint32(session_id, "session_id")
         type_check(size, (int,), "size")
         if size != 0:
@@ -67,6 +77,10 @@ class DatasetCache:
             check_pos_int32(num_connections, "num_connections")
         if prefetch_size is not None:
             check_pos_int32(prefetch_size, "prefetch_size")
+        if tier_policy is not None:
+            check_valid_str(tier_policy, TIER_POLICIES, "tier_policy")
+        if compression is not None:
+            check_valid_str(compression, COMPRESSIONS, "compression")
 
         self.session_id = session_id
         self.size = size
@@ -75,7 +89,10 @@ class DatasetCache:
         self.port = port
         self.prefetch_size = prefetch_size
         self.num_connections = num_connections
-        self.cache_client = CacheClient(session_id, size, spilling, hostname, port, num_connections, prefetch_size)
+        self.tier_policy = tier_policy
+        self.compression = compression
+        self.cache_client = CacheClient(session_id, size, spilling, hostname, port, num_connections, prefetch_size,
+                                        TIER_POLICIES.get(tier_policy), COMPRESSIONS.get(compression))
 
     def get_stat(self):
         """Get the statistics from a cache."""
@@ -94,5 +111,7 @@ class DatasetCache:
         new_cache.port = copy.deepcopy(self.port, memodict)
         new_cache.prefetch_size = copy.deepcopy(self.prefetch_size, memodict)
         new_cache.num_connections = copy.deepcopy(self.num_connections, memodict)
+        new_cache.tier_policy = copy.deepcopy(self.tier_policy, memodict)
+        new_cache.compression = copy.deepcopy(self.compression, memodict)
         new_cache.cache_client = self.cache_client
         return new_cache
@@ -0,0 +1,194 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "common/common.h"
+#include "minddata/dataset/engine/cache/cache_fetch_ring.h"
+
+using namespace mindspore::dataset;
+using mindspore::Status;
+using mindspore::StatusCode;
+
+class MindDataTestCacheFetchRing : public UT::Common {
+ public:
+  MindDataTestCacheFetchRing() : mem_(CacheFetchRing::MemorySize() / sizeof(CacheLine) + 1) {}
+
+  void SetUp() override {
+    ring_ = std::make_unique<CacheFetchRing>(mem_.data());
+    ring_->Init();
+  }
+
+ protected:
+  struct alignas(64) CacheLine {
+    char data[64];
+  };
+  // The ring is in the heap instead of the shared memory, the protocol is the same.
+  std::vector<CacheLine> mem_;
+  std::unique_ptr<CacheFetchRing> ring_;
+};
+
+namespace {
+using FetchFunc = std::function<Status(const std::vector<row_id_type> &row_id, int64_t *addr, uint32_t *flag)>;
+
+// The server replies the sum of the row ids as the address, and the number of rows as the flag.
+Status SumRows(const std::vector<row_id_type> &row_id, int64_t *addr, uint32_t *flag) {
+  *addr = std::accumulate(row_id.begin(), row_id.end(), static_cast<int64_t>(0));
+  *flag = static_cast<uint32_t>(row_id.size());
+  return Status::OK();
+}
+
+// Claim, fetch and complete all the posted slots in the calling thread, like the cache server does in its threads.
+int32_t Serve(CacheFetchRing *ring, const FetchFunc &fetch) {
+  int32_t num_served = 0;
+  std::vector<row_id_type> row_id;
+  for (int32_t slot = 0; slot < CacheFetchRing::kNumSlots; ++slot) {
+    if (!ring->Claim(slot, &row_id)) {
+      continue;
+    }
+    int64_t addr = -1;
+    uint32_t flag = 0;
+    Status rc = fetch(row_id, &addr, &flag);
+    (void)ring->Complete(slot, rc, addr, flag);
+    ++num_served;
+  }
+  return num_served;
+}
+}  // namespace
+
+/// Feature: Fetch ring of the cache client.
+/// Description: Several client threads post the rows to the ring, while a server thread polls it.
+/// Expectation: Every client gets the reply of its own rows.
+TEST_F(MindDataTestCacheFetchRing, TestRoundTrip) {
+  std::atomic<bool> stop(false);
+  std::thread server([this, &stop]() {
+    while (!stop) {
+      (void)Serve(ring_.get(), SumRows);
+    }
+  });
+  constexpr int32_t kNumClients = 4;
+  constexpr int32_t kNumFetches = 200;
+  std::atomic<int32_t> num_ok(0);
+  std::vector<std::thread> clients;
+  for (int32_t c = 0; c < kNumClients; ++c) {
+    clients.emplace_back([this, c, &num_ok]() {
+      for (int32_t k = 0; k < kNumFetches; ++k) {
+        std::vector<row_id_type> row_id(1 + (c + k) % 8);
+        std::iota(row_id.begin(), row_id.end(), c * kNumFetches + k);
+        int32_t slot = -1;
+        // There are fewer clients than slots, so the ring is never full.
+        if (!ring_->Submit(row_id, &slot)) {
+          return;
+        }
+        int64_t addr = -1;
+        uint32_t flag = 0;
+        if (ring_->Wait(slot, &addr, &flag).IsError() || flag != row_id.size() ||
+            addr != std::accumulate(row_id.begin(), row_id.end(), static_cast<int64_t>(0))) {
+          return;
+        }
+        ++num_ok;
+      }
+    });
+  }
+  for (auto &t : clients) {
+    t.join();
+  }
+  stop = true;
+  server.join();
+  EXPECT_EQ(num_ok, kNumClients * kNumFetches);
+}
+
+/// Feature: Fetch ring of the cache client.
+/// Description: Post more requests than the slots, and a request with too many rows.
+/// Expectation: The requests which don't fit are refused so that they go through gRPC.
+TEST_F(MindDataTestCacheFetchRing, TestFull) {
+  std::vector<row_id_type> row_id = {1, 2, 3};
+  std::vector<int32_t> slots;
+  int32_t slot = -1;
+  for (int32_t i = 0; i < CacheFetchRing::kNumSlots; ++i) {
+    ASSERT_TRUE(ring_->Submit(row_id, &slot));
+    slots.push_back(slot);
+  }
+  EXPECT_FALSE(ring_->Submit(row_id, &slot));
+  std::vector<row_id_type> too_many(CacheFetchRing::kMaxRows + 1);
+  EXPECT_FALSE(ring_->Submit(too_many, &slot));
+  EXPECT_FALSE(ring_->Submit({}, &slot));
+  EXPECT_EQ(Serve(ring_.get(), SumRows), CacheFetchRing::kNumSlots);
+  for (auto i : slots) {
+    int64_t addr = -1;
+    uint32_t flag = 0;
+    ASSERT_TRUE(ring_->Wait(i, &addr, &flag).IsOk());
+    EXPECT_EQ(addr, 6);
+  }
+  // All the slots are free again.
+  EXPECT_TRUE(ring_->Submit(row_id, &slot));
+}
+
+/// Feature: Fetch ring of the cache client.
+/// Description: The server fails to fetch the rows of a slot, then the client closes the ring.
+/// Expectation: The client gets an error and the slot is reused. The server sees the ring closed.
+TEST_F(MindDataTestCacheFetchRing, TestErrorAndClose) {
+  int32_t slot = -1;
+  auto out_of_memory = [](const std::vector<row_id_type> &, int64_t *, uint32_t *) {
+    return Status(StatusCode::kMDOutOfMemory);
+  };
+  ASSERT_TRUE(ring_->Submit({7}, &slot));
+  EXPECT_EQ(Serve(ring_.get(), out_of_memory), 1);
+  int64_t addr = -1;
+  uint32_t flag = 0;
+  EXPECT_TRUE(ring_->Wait(slot, &addr, &flag).IsError());
+  // Nothing is posted, so nothing is served.
+  EXPECT_EQ(Serve(ring_.get(), SumRows), 0);
+  ASSERT_TRUE(ring_->Submit({7}, &slot));
+  EXPECT_EQ(Serve(ring_.get(), SumRows), 1);
+  EXPECT_TRUE(ring_->Wait(slot, &addr, &flag).IsOk());
+  EXPECT_EQ(addr, 7);
+  EXPECT_FALSE(ring_->IsClosed());
+  ring_->Close();
+  EXPECT_TRUE(CacheFetchRing(mem_.data()).IsClosed());
+}
+
+/// Feature: Fetch ring of the cache client.
+/// Description: The client times out while the server is still fetching the rows of its slot.
+/// Expectation: The client gets an error, the server is told to free the reply, and the slot is reused afterwards.
+TEST_F(MindDataTestCacheFetchRing, TestAbandon) {
+  int32_t slot = -1;
+  ASSERT_TRUE(ring_->Submit({3, 4}, &slot));
+  std::vector<row_id_type> row_id;
+  ASSERT_TRUE(ring_->Claim(slot, &row_id));
+  EXPECT_EQ(row_id, std::vector<row_id_type>({3, 4}));
+  EXPECT_FALSE(ring_->Claim(slot, &row_id));
+  EXPECT_TRUE(ring_->IsServing());
+  int64_t addr = -1;
+  uint32_t flag = 0;
+  EXPECT_TRUE(ring_->Wait(slot, &addr, &flag, std::chrono::milliseconds(1)).IsError());
+  // The server still owns the slot until it completes it, and then it frees the reply.
+  EXPECT_TRUE(ring_->IsServing());
+  EXPECT_FALSE(ring_->Complete(slot, Status::OK(), 7, 0));
+  EXPECT_FALSE(ring_->IsServing());
+  // A slot which is not picked up yet is taken back by the client right away.
+  ASSERT_TRUE(ring_->Submit({5}, &slot));
+  EXPECT_TRUE(ring_->Wait(slot, &addr, &flag, std::chrono::milliseconds(1)).IsError());
+  EXPECT_FALSE(ring_->Claim(slot, &row_id));
+  // All the slots are free again.
+  for (int32_t i = 0; i < CacheFetchRing::kNumSlots; ++i) {
+    ASSERT_TRUE(ring_->Submit({1}, &slot));
+  }
+  EXPECT_EQ(Serve(ring_.get(), SumRows), CacheFetchRing::kNumSlots);
+}
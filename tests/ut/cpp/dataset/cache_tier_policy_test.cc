@@ -0,0 +1,160 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <memory>
+#include "common/common.h"
+#include "minddata/dataset/engine/cache/cache_tier_policy.h"
+#include "utils/frequency_sketch.h"
+
+using namespace mindspore::dataset;
+using mindspore::FrequencySketch;
+
+class MindDataTestCacheTierPolicy : public UT::Common {
+ public:
+  MindDataTestCacheTierPolicy() {}
+};
+
+/// Feature: Tier policy of the cache server.
+/// Description: Insert keys to the LRU policy, access some of them and erase the victim.
+/// Expectation: The victims are picked from the least recently used key.
+TEST_F(MindDataTestCacheTierPolicy, TestLru) {
+  auto policy = CacheTierPolicy::Create(CacheTierPolicyType::kLru);
+  ASSERT_NE(policy, nullptr);
+  CacheTierPolicy::key_type victim = -1;
+  EXPECT_FALSE(policy->PickVictim(&victim));
+  for (CacheTierPolicy::key_type key = 0; key < 4; ++key) {
+    policy->OnInsert(key);
+  }
+  EXPECT_TRUE(policy->PickVictim(&victim));
+  EXPECT_EQ(victim, 0);
+  // Accessing a key makes it the most recently used one, and picking a victim does not remove it.
+  policy->OnAccess(0);
+  EXPECT_TRUE(policy->PickVictim(&victim));
+  EXPECT_EQ(victim, 1);
+  EXPECT_TRUE(policy->PickVictim(&victim));
+  EXPECT_EQ(victim, 1);
+  policy->OnErase(1);
+  EXPECT_TRUE(policy->PickVictim(&victim));
+  EXPECT_EQ(victim, 2);
+  // The keys which are not resident in memory are ignored.
+  policy->OnAccess(100);
+  policy->OnErase(100);
+  EXPECT_TRUE(policy->Admit(100, victim));
+  EXPECT_TRUE(policy->PickVictim(&victim));
+  EXPECT_EQ(victim, 2);
+  EXPECT_EQ(CacheTierPolicy::Create(CacheTierPolicyType::kNone), nullptr);
+}
+
+/// Feature: Tier policy of the cache server.
+/// Description: Access the keys of the LFU policy with different frequencies, then evict and insert a hot key again.
+/// Expectation: The least frequently used key is the victim, and the evicted key keeps its frequency.
+TEST_F(MindDataTestCacheTierPolicy, TestLfu) {
+  auto policy = CacheTierPolicy::Create(CacheTierPolicyType::kLfu);
+  ASSERT_NE(policy, nullptr);
+  for (CacheTierPolicy::key_type key = 0; key < 3; ++key) {
+    policy->OnInsert(key);
+    for (CacheTierPolicy::key_type i = 0; i < 3 - key; ++i) {
+      policy->OnAccess(key);
+    }
+  }
+  CacheTierPolicy::key_type victim = -1;
+  EXPECT_TRUE(policy->PickVictim(&victim));
+  EXPECT_EQ(victim, 2);
+  policy->OnErase(0);
+  policy->OnErase(2);
+  EXPECT_TRUE(policy->PickVictim(&victim));
+  EXPECT_EQ(victim, 1);
+  // Key 0 was accessed most before it was evicted, so it is not the victim after it comes back.
+  policy->OnInsert(0);
+  EXPECT_TRUE(policy->PickVictim(&victim));
+  EXPECT_EQ(victim, 1);
+  // The key accessed on disk starts with its history when it is inserted.
+  for (int i = 0; i < 10; ++i) {
+    policy->OnAccess(3);
+  }
+  policy->OnInsert(3);
+  policy->OnErase(1);
+  EXPECT_TRUE(policy->PickVictim(&victim));
+  EXPECT_EQ(victim, 0);
+}
+
+/// Feature: Tier policy of the cache server.
+/// Description: Access a key of the LFU policy on disk, then access many other keys on disk before it is inserted.
+/// Expectation: The history of the key is aged out, so it is the victim instead of a key accessed recently.
+TEST_F(MindDataTestCacheTierPolicy, TestLfuHistoryAging) {
+  // A narrow sketch, so it is aged after a few thousand keys.
+  constexpr uint64_t kWidth = 64;
+  LfuTierPolicy policy(kWidth);
+  constexpr CacheTierPolicy::key_type kOld = 0;
+  constexpr CacheTierPolicy::key_type kRecent = 1;
+  for (int i = 0; i < 12; ++i) {
+    policy.OnAccess(kOld);
+  }
+  // The sketch is halved every 10 times as many additions as its width.
+  constexpr CacheTierPolicy::key_type kOtherKeys = kWidth * 10 * 3;
+  for (CacheTierPolicy::key_type key = 100; key < 100 + kOtherKeys; ++key) {
+    policy.OnAccess(key);
+  }
+  policy.OnInsert(kRecent);
+  for (int i = 0; i < 5; ++i) {
+    policy.OnAccess(kRecent);
+  }
+  policy.OnInsert(kOld);
+  CacheTierPolicy::key_type victim = -1;
+  EXPECT_TRUE(policy.PickVictim(&victim));
+  EXPECT_EQ(victim, kOld);
+}
+
+/// Feature: Tier policy of the cache server.
+/// Description: Access the hot and cold keys of the TinyLFU policy, and age the frequency sketch with many keys.
+/// Expectation: Only the candidate hotter than the victim is admitted, and the victims are picked in LRU order.
+TEST_F(MindDataTestCacheTierPolicy, TestTinyLfu) {
+  auto policy = CacheTierPolicy::Create(CacheTierPolicyType::kTinyLfu);
+  ASSERT_NE(policy, nullptr);
+  constexpr CacheTierPolicy::key_type kHot = 1;
+  constexpr CacheTierPolicy::key_type kCold = 2;
+  constexpr CacheTierPolicy::key_type kResident = 3;
+  policy->OnInsert(kResident);
+  policy->OnInsert(kCold);
+  for (int i = 0; i < 5; ++i) {
+    policy->OnAccess(kHot);
+  }
+  policy->OnAccess(kResident);
+  CacheTierPolicy::key_type victim = -1;
+  EXPECT_TRUE(policy->PickVictim(&victim));
+  EXPECT_EQ(victim, kCold);
+  EXPECT_TRUE(policy->Admit(kHot, kResident));
+  EXPECT_FALSE(policy->Admit(kCold, kResident));
+  EXPECT_FALSE(policy->Admit(kResident, kHot));
+}
+
+/// Feature: Frequency sketch of the TinyLFU policy.
+/// Description: Count a key many times, then count many other keys to age the sketch.
+/// Expectation: The counter saturates at 15 and is halved when the sketch is aged.
+TEST_F(MindDataTestCacheTierPolicy, TestFrequencySketch) {
+  constexpr uint64_t kWidth = 64;
+  FrequencySketch sketch(kWidth);
+  constexpr uint64_t kKey = 7;
+  for (int i = 0; i < 20; ++i) {
+    sketch.Increment(kKey);
+  }
+  EXPECT_EQ(sketch.Estimate(kKey), 15);
+  EXPECT_EQ(sketch.Estimate(kKey + 1), 0);
+  // The sketch is aged after 10 times as many additions as the width.
+  for (uint64_t i = 0; i < kWidth * 10; ++i) {
+    sketch.Increment(1000 + i);
+  }
+  EXPECT_LE(sketch.Estimate(kKey), 8);
+}
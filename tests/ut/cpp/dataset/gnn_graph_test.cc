@@ -408,3 +408,35 @@ TEST_F(MindDataTestGNNGraph, TestRandomWalkDefaults) {
   EXPECT_TRUE(s.IsOk());
   EXPECT_TRUE(walk_path->shape().ToString() == "<33,60>");
 }
+
+TEST_F(MindDataTestGNNGraph, TestRandomWalkMultiWorkers) {
+  std::string path = "data/mindrecord/testGraphData/sns";
+  GraphDataImpl graph(path, 4);
+  Status s = graph.Init();
+  EXPECT_TRUE(s.IsOk());
+
+  MetaInfo meta_info;
+  s = graph.GetMetaInfo(&meta_info);
+  EXPECT_TRUE(s.IsOk());
+
+  std::shared_ptr<Tensor> nodes;
+  s = graph.GetAllNodes(meta_info.node_type[0], &nodes);
+  EXPECT_TRUE(s.IsOk());
+  std::vector<NodeIdType> node_list;
+  for (auto itr = nodes->begin<NodeIdType>(); itr != nodes->end<NodeIdType>(); ++itr) {
+    node_list.push_back(*itr);
+  }
+
+  std::vector<NodeType> meta_path(59, 1);
+  std::shared_ptr<Tensor> walk_path;
+  s = graph.RandomWalk(node_list, meta_path, 2.0, 0.5, -1, &walk_path);
+  EXPECT_TRUE(s.IsOk());
+  EXPECT_TRUE(walk_path->shape().ToString() == "<33,60>");
+  // Walks are written back in input order regardless of which worker produced them
+  for (size_t i = 0; i < node_list.size(); ++i) {
+    NodeIdType start_node;
+    s = walk_path->GetItemAt<NodeIdType>(&start_node, {static_cast<dsize_t>(i), 0});
+    EXPECT_TRUE(s.IsOk());
+    EXPECT_EQ(start_node, node_list[i]);
+  }
+}
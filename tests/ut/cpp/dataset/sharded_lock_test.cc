@@ -0,0 +1,87 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "common/common.h"
+#include "minddata/dataset/util/lock.h"
+
+using namespace mindspore::dataset;
+
+class MindDataTestShardedLock : public UT::Common {
+ public:
+  MindDataTestShardedLock() {}
+};
+
+/// Feature: Sharded reader-writer lock of the cache service.
+/// Description: Several readers check a pair of values while a writer keeps updating both of them.
+/// Expectation: No reader sees the pair half updated, and all the writes are done.
+TEST_F(MindDataTestShardedLock, TestReadersAndWriter) {
+  constexpr int32_t kNumShards = 4;
+  constexpr int32_t kNumReaders = 8;
+  constexpr int64_t kNumWrites = 200;
+  ShardedRWLock rw(kNumShards);
+  int64_t first = 0;
+  int64_t second = 0;
+  std::atomic<bool> done(false);
+  std::atomic<int64_t> num_torn(0);
+  std::atomic<int64_t> num_reads(0);
+  std::vector<std::thread> readers;
+  for (int32_t i = 0; i < kNumReaders; ++i) {
+    readers.emplace_back([&]() {
+      while (!done) {
+        ShardedSharedLock lck(&rw);
+        if (first != second) {
+          ++num_torn;
+        }
+        ++num_reads;
+      }
+    });
+  }
+  for (int64_t i = 0; i < kNumWrites; ++i) {
+    // Let the readers in between the writes.
+    int64_t last = num_reads;
+    while (num_reads == last) {
+      std::this_thread::yield();
+    }
+    ShardedUniqueLock lck(&rw);
+    ++first;
+    ++second;
+  }
+  done = true;
+  for (auto &t : readers) {
+    t.join();
+  }
+  EXPECT_EQ(num_torn, 0);
+  EXPECT_GT(num_reads, 0);
+  EXPECT_EQ(first, kNumWrites);
+  EXPECT_EQ(second, kNumWrites);
+}
+
+/// Feature: Sharded reader-writer lock of the cache service.
+/// Description: Lock and unlock the shared lock again and again, then lock it exclusively.
+/// Expectation: The readers leave no count behind, so the writer gets in.
+TEST_F(MindDataTestShardedLock, TestRelock) {
+  ShardedRWLock rw(2);
+  {
+    ShardedSharedLock lck(&rw);
+    lck.Unlock();
+    lck.Lock();
+  }
+  ShardedUniqueLock lck(&rw);
+  lck.Unlock();
+  lck.Lock();
+}
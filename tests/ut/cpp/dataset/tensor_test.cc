@@ -537,3 +537,46 @@ TEST_F(MindDataTestTensorDE, TensorEmpty) {
   t2->Invalidate();
   ASSERT_TRUE(!t2->HasData());
 }
+
+namespace {
+// A pool which owns a buffer and counts the memory given back to it.
+class CountingPool : public MemoryPool {
+ public:
+  explicit CountingPool(int *num_freed) : num_freed_(num_freed) {}
+  ~CountingPool() override = default;
+  Status Allocate(size_t, void **) override { return Status(StatusCode::kMDOutOfMemory); }
+  Status Reallocate(void **, size_t, size_t) override { return Status(StatusCode::kMDOutOfMemory); }
+  void Deallocate(void *) override { ++(*num_freed_); }
+  uint64_t get_max_size() const override { return 0; }
+  int PercentFree() const override { return 0; }
+
+ private:
+  int *num_freed_;
+};
+}  // namespace
+
+/// Feature: Tensor.
+/// Description: Create a tensor which refers to the memory of a pool, then destroy it.
+/// Expectation: The tensor shares the memory without copying it, and gives it back to the pool when destroyed.
+TEST_F(MindDataTestTensorDE, CreateFromMemoryPool) {
+  int num_freed = 0;
+  auto pool = std::make_shared<CountingPool>(&num_freed);
+  std::vector<float> buffer = {1.0, 2.0, 3.0, 4.0};
+  auto *src = reinterpret_cast<uchar *>(buffer.data());
+  std::shared_ptr<Tensor> t;
+  ASSERT_TRUE(Tensor::CreateFromMemoryPool(TensorShape({2, 2}), DataType(DataType::DE_FLOAT32), src,
+                                           buffer.size() * sizeof(float), pool, &t)
+                .IsOk());
+  ASSERT_EQ(t->GetBuffer(), src);
+  float value = 0;
+  ASSERT_TRUE(t->GetItemAt<float>(&value, {1, 0}).IsOk());
+  ASSERT_EQ(value, 3.0);
+  // The length must match the shape.
+  std::shared_ptr<Tensor> bad;
+  ASSERT_FALSE(Tensor::CreateFromMemoryPool(TensorShape({3}), DataType(DataType::DE_FLOAT32), src,
+                                            buffer.size() * sizeof(float), pool, &bad)
+                 .IsOk());
+  ASSERT_EQ(num_freed, 0);
+  t.reset();
+  ASSERT_EQ(num_freed, 1);
+}
@@ -0,0 +1,205 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "runtime/device/cpu/cpu_mem_handler.h"
+#include "runtime/device/cpu/cpu_memory_manager.h"
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+namespace {
+constexpr size_t kElementNum = 64;
+constexpr size_t kBlockSize = kElementNum * sizeof(float);
+constexpr size_t kBlockNum = 3;
+constexpr size_t kIterationNum = 2;
+
+// The memory handler which records the peak of the device memory in use.
+class PeakMemHandler : public CPUMemHandler {
+ public:
+  PeakMemHandler(const std::shared_ptr<MemoryManager> &mem_manager, const std::string &offload_path, size_t mem_size)
+      : CPUMemHandler(mem_manager, offload_path, mem_size) {}
+  ~PeakMemHandler() = default;
+
+  void *MallocDevice(size_t mem_size) override {
+    auto ptr = CPUMemHandler::MallocDevice(mem_size);
+    if (ptr != nullptr) {
+      device_used_ += mem_size;
+      peak_used_ = std::max(peak_used_, device_used_);
+      device_size_[ptr] = mem_size;
+    }
+    return ptr;
+  }
+
+  void FreeDevice(void *ptr) override {
+    device_used_ -= device_size_[ptr];
+    (void)device_size_.erase(ptr);
+    CPUMemHandler::FreeDevice(ptr);
+  }
+
+  size_t peak_used() const { return peak_used_; }
+
+ private:
+  size_t device_used_{0};
+  size_t peak_used_{0};
+  std::map<void *, size_t> device_size_;
+};
+
+float *GetData(const std::shared_ptr<MemScheduler> &scheduler, const void *key) {
+  return static_cast<float *>(scheduler->GetOrMalloc(key, kBlockSize));
+}
+}  // namespace
+
+class CPUMemHandlerTest : public UT::Common {
+ public:
+  CPUMemHandlerTest() = default;
+
+  void SetUp() override {
+    char dir_template[] = "/tmp/cpu_mem_offload_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    offload_dir_ = dir_template;
+  }
+
+  // The offload files are unlinked once they are created, so the directory is empty.
+  void TearDown() override { (void)rmdir(offload_dir_.c_str()); }
+
+ protected:
+  std::string offload_dir_;
+};
+
+/// Feature: Host memory of the CPU memory offload.
+/// Description: Malloc a smaller block in the freed block, then a block in the rest of it, and free them all.
+/// Expectation: The best fit block is split and its tail is reused, and the freed blocks are merged to the whole one.
+TEST_F(CPUMemHandlerTest, TestHostBestFit) {
+  const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  CPUMemHandler handler(std::make_shared<CPUMemoryManager>(), offload_dir_, 0);
+  auto base = static_cast<uint8_t *>(handler.MallocHost(3 * page_size));
+  ASSERT_NE(base, nullptr);
+  auto guard = handler.MallocHost(page_size);
+  EXPECT_EQ(guard, base + 3 * page_size);
+  handler.FreeHost(base);
+
+  auto first = handler.MallocHost(page_size - 1);
+  EXPECT_EQ(first, base);
+  auto second = handler.MallocHost(2 * page_size);
+  EXPECT_EQ(second, base + page_size);
+  handler.FreeHost(second);
+  handler.FreeHost(first);
+  EXPECT_EQ(handler.MallocHost(3 * page_size), base);
+  EXPECT_EQ(handler.MallocHost(page_size), base + 4 * page_size);
+}
+
+/// Feature: CPU memory offload of the MemScheduler.
+/// Description: Run the steps A = W + X + 1, B = A + 1, C = B + 1, D = C + A + 1, W = W + D twice, in which the weight
+/// W and the parameter X are initialized from the host memory of offload, within the memory of three blocks.
+/// Expectation: The memory in use never exceeds the limit, and the results and the updated weight are the same as the
+/// computation without the limit.
+TEST_F(CPUMemHandlerTest, TestOffloadRoundTrip) {
+  auto handler = std::make_shared<PeakMemHandler>(std::make_shared<CPUMemoryManager>(), offload_dir_,
+                                                  kBlockNum * kBlockSize);
+  MemSchedulerManager manager;
+  auto scheduler = manager.GetOrCreateMemScheduler(0);
+  ASSERT_NE(scheduler, nullptr);
+  scheduler->SetMemHandler(handler);
+  std::vector<uint8_t> keys(6);
+  const void *w = &keys[0];
+  const void *x = &keys[1];
+  const void *a = &keys[2];
+  const void *b = &keys[3];
+  const void *c = &keys[4];
+  const void *d = &keys[5];
+  const std::vector<std::vector<const void *>> step_keys = {{w, x, a}, {a, b}, {b, c}, {c, a, d}, {w, d}};
+  scheduler->SetTotalStep(step_keys.size());
+
+  auto w_host = static_cast<float *>(handler->MallocHost(kBlockSize));
+  auto x_host = static_cast<float *>(handler->MallocHost(kBlockSize));
+  std::vector<float> expect_w(kElementNum);
+  std::vector<float> expect_x(kElementNum);
+  for (size_t i = 0; i < kElementNum; ++i) {
+    w_host[i] = expect_w[i] = static_cast<float>(i);
+    x_host[i] = expect_x[i] = static_cast<float>(i) * 2;
+  }
+
+  // Record the memory events, the weight is updated in the last step.
+  scheduler->Init(w, w_host, kBlockSize, kMemPriorityHigh);
+  scheduler->Init(x, x_host, kBlockSize, kMemPriorityHigh);
+  for (size_t step = 0; step < step_keys.size(); ++step) {
+    ASSERT_TRUE(scheduler->PreCompute(nullptr));
+    for (auto key : step_keys[step]) {
+      (void)scheduler->GetOrMalloc(key, kBlockSize);
+    }
+    if (step == step_keys.size() - 1) {
+      scheduler->UpdateHighPriorityMem(w);
+    }
+    ASSERT_TRUE(scheduler->PostCompute(nullptr));
+  }
+  scheduler->set_need_record_event(false);
+  ASSERT_TRUE(scheduler->Optimize());
+
+  std::vector<float> expect_d(kElementNum);
+  for (size_t iter = 0; iter < kIterationNum; ++iter) {
+    scheduler->Reset();
+    scheduler->Update();
+    scheduler->Init(w, w_host, kBlockSize, kMemPriorityHigh);
+    scheduler->Init(x, x_host, kBlockSize, kMemPriorityHigh);
+    for (size_t step = 0; step < step_keys.size(); ++step) {
+      ASSERT_TRUE(scheduler->PreCompute(nullptr));
+      std::vector<float *> data;
+      for (auto key : step_keys[step]) {
+        auto ptr = GetData(scheduler, key);
+        ASSERT_NE(ptr, nullptr);
+        data.push_back(ptr);
+      }
+      for (size_t i = 0; i < kElementNum; ++i) {
+        if (step == 0) {
+          data[2][i] = data[0][i] + data[1][i] + 1;
+        } else if (step == 1 || step == 2) {
+          data[1][i] = data[0][i] + 1;
+        } else if (step == 3) {
+          data[2][i] = data[0][i] + data[1][i] + 1;
+        } else {
+          data[0][i] += data[1][i];
+        }
+      }
+      if (step == step_keys.size() - 1) {
+        std::copy(data[1], data[1] + kElementNum, expect_d.begin());
+      }
+      ASSERT_TRUE(scheduler->PostCompute(nullptr));
+    }
+
+    for (size_t i = 0; i < kElementNum; ++i) {
+      auto expect_a = expect_w[i] + expect_x[i] + 1;
+      auto expect_c = expect_a + 2;
+      EXPECT_FLOAT_EQ(expect_d[i], expect_c + expect_a + 1);
+      expect_w[i] += expect_d[i];
+    }
+    const float *w_data = scheduler->HasDeviceMem(w) ? GetData(scheduler, w) : w_host;
+    for (size_t i = 0; i < kElementNum; ++i) {
+      EXPECT_FLOAT_EQ(w_data[i], expect_w[i]);
+    }
+  }
+  EXPECT_LE(handler->peak_used(), kBlockNum * kBlockSize);
+  scheduler->ClearAllocatedMem();
+}
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
@@ -0,0 +1,161 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <dirent.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "frontend/operator/ops.h"
+#include "backend/session/kernel_graph.h"
+#include "backend/session/anf_runtime_algorithm.h"
+#include "runtime/device/kernel_select_cache.h"
+#include "utils/ms_context.h"
+#include "utils/system/sha256.h"
+#include "utils/utils.h"
+
+namespace mindspore {
+namespace device {
+using KernelBuildInfoBuilder = kernel::KernelBuildInfo::KernelBuildInfoBuilder;
+namespace {
+constexpr char kCacheSubDir[] = "/kernel_select";
+
+// Build the kernels Add(x, y) -> Mul(add, w), where the inputs are of the given shape.
+std::vector<CNodePtr> BuildKernels(const KernelGraphPtr &graph, const std::vector<int64_t> &shape) {
+  auto abstract = std::make_shared<abstract::AbstractTensor>(kFloat32, shape);
+  std::vector<AnfNodePtr> params;
+  for (size_t i = 0; i < 3; ++i) {
+    auto param = graph->add_parameter();
+    param->set_abstract(abstract);
+    params.push_back(param);
+  }
+  auto add = graph->NewCNode({NewValueNode(prim::kPrimAdd), params[0], params[1]});
+  add->set_abstract(abstract);
+  auto mul = graph->NewCNode({NewValueNode(prim::kPrimMul), add, params[2]});
+  mul->set_abstract(abstract);
+  return {add, mul};
+}
+
+void SelectKernels(const std::vector<CNodePtr> &nodes, TypeId type) {
+  for (const auto &node : nodes) {
+    auto builder = std::make_shared<KernelBuildInfoBuilder>();
+    builder->SetKernelType(KernelType::CPU_KERNEL);
+    builder->SetProcessor(kernel::Processor::CPU);
+    builder->SetInputsFormat({kOpFormat_DEFAULT, kOpFormat_DEFAULT});
+    builder->SetInputsDeviceType({type, type});
+    builder->SetOutputsFormat({kOpFormat_DEFAULT});
+    builder->SetOutputsDeviceType({type});
+    AnfAlgo::SetSelectKernelBuildInfo(builder->Build(), node.get());
+  }
+}
+}  // namespace
+
+class KernelSelectCacheTest : public UT::Common {
+ public:
+  KernelSelectCacheTest() = default;
+
+  void SetUp() override {
+    char dir_template[] = "/tmp/kernel_select_cache_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    cache_dir_ = dir_template;
+    KernelSelectCache::GetInstance().Enable(cache_dir_);
+  }
+
+  void TearDown() override {
+    auto sub_dir = cache_dir_ + kCacheSubDir;
+    DIR *dir = opendir(sub_dir.c_str());
+    if (dir != nullptr) {
+      struct dirent *entry = nullptr;
+      while ((entry = readdir(dir)) != nullptr) {
+        std::string file_name = entry->d_name;
+        if (file_name != "." && file_name != "..") {
+          (void)std::remove((sub_dir + "/" + file_name).c_str());
+        }
+      }
+      (void)closedir(dir);
+    }
+    (void)rmdir(sub_dir.c_str());
+    (void)rmdir(cache_dir_.c_str());
+  }
+
+ protected:
+  std::string CacheFilePath(const std::string &key) const {
+    return cache_dir_ + kCacheSubDir + "/graph_" + system::sha256::GetHashFromString(key) + ".json";
+  }
+
+  std::string cache_dir_;
+};
+
+/// Feature: Kernel select cache.
+/// Description: Insert the build infos of a graph, then fetch them before and after they are saved to disk.
+/// Expectation: The build infos are restored in the order of the kernels, and the cache file is named by the digest.
+TEST_F(KernelSelectCacheTest, TestSaveAndLoad) {
+  auto &cache = KernelSelectCache::GetInstance();
+  EXPECT_TRUE(cache.enabled());
+  auto graph = std::make_shared<session::KernelGraph>();
+  auto nodes = BuildKernels(graph, {2, 3});
+  auto key = cache.GraphKey(kCPUDevice, nodes);
+  std::vector<kernel::KernelBuildInfoPtr> build_infos;
+  EXPECT_FALSE(cache.Fetch(key, nodes, &build_infos));
+
+  SelectKernels(nodes, kNumberTypeFloat16);
+  cache.Insert(key, nodes);
+  EXPECT_TRUE(cache.Fetch(key, nodes, &build_infos));
+  cache.Flush();
+  EXPECT_TRUE(std::ifstream(CacheFilePath(key)).good());
+
+  build_infos.clear();
+  EXPECT_TRUE(cache.Fetch(key, nodes, &build_infos));
+  ASSERT_EQ(build_infos.size(), nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    EXPECT_TRUE(*build_infos[i] == *AnfAlgo::GetSelectKernelBuildInfo(nodes[i]));
+    EXPECT_EQ(build_infos[i]->GetInputDeviceType(0), kNumberTypeFloat16);
+  }
+}
+
+/// Feature: Kernel select cache.
+/// Description: Build two graphs which only differ in the shapes, and put the cache file of the first one in the place
+/// of the second one, as if their file names collided.
+/// Expectation: The keys differ, and the second graph misses the cache since the key saved in the file is checked.
+TEST_F(KernelSelectCacheTest, TestKeyCollision) {
+  auto &cache = KernelSelectCache::GetInstance();
+  auto graph = std::make_shared<session::KernelGraph>();
+  auto nodes = BuildKernels(graph, {2, 3});
+  auto other_nodes = BuildKernels(graph, {3, 2});
+  auto key = cache.GraphKey(kCPUDevice, nodes);
+  auto other_key = cache.GraphKey(kCPUDevice, other_nodes);
+  ASSERT_NE(key, other_key);
+  EXPECT_EQ(key, cache.GraphKey(kCPUDevice, nodes));
+
+  SelectKernels(nodes, kNumberTypeFloat32);
+  cache.Insert(key, nodes);
+  cache.Flush();
+  std::ifstream src(CacheFilePath(key));
+  ASSERT_TRUE(src.good());
+  {
+    std::ofstream dst(CacheFilePath(other_key));
+    dst << src.rdbuf();
+  }
+  std::vector<kernel::KernelBuildInfoPtr> build_infos;
+  EXPECT_FALSE(cache.Fetch(other_key, other_nodes, &build_infos));
+  EXPECT_TRUE(build_infos.empty());
+  EXPECT_TRUE(cache.Fetch(key, nodes, &build_infos));
+}
+}  // namespace device
+}  // namespace mindspore
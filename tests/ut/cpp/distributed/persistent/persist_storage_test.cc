@@ -16,8 +16,13 @@
 
 #include "common/common_test.h"
 
+#include <dirent.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
 #include <memory>
 #include <map>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -27,13 +32,53 @@
 namespace mindspore {
 namespace distributed {
 namespace persistent {
+namespace {
+// Remove the files persisted in the directory of the storage, and the directory.
+void RemoveStorageDir(const std::string &storage_file_path) {
+  DIR *dir = opendir(storage_file_path.c_str());
+  if (dir == nullptr) {
+    return;
+  }
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    std::string file_name = entry->d_name;
+    if (file_name != "." && file_name != "..") {
+      (void)std::remove((storage_file_path + "/" + file_name).c_str());
+    }
+  }
+  (void)closedir(dir);
+  (void)rmdir(storage_file_path.c_str());
+}
+
+size_t FileLength(const std::string &file_name) {
+  std::ifstream fs(file_name, std::ios::in | std::ios::binary | std::ios::ate);
+  return fs.is_open() ? static_cast<size_t>(fs.tellg()) : 0;
+}
+
+// Restore the embedding table from the storage by a new persistent data, like the server restarted.
+std::vector<float> RestoreEmbedding(const std::map<std::string, std::string> &config_map,
+                                    const std::shared_ptr<std::vector<int>> &shape, size_t total_dim) {
+  PersistentData<float> embedding_table(std::make_shared<std::vector<float>>(total_dim, 0), shape);
+  embedding_table.Initialize(config_map);
+  embedding_table.Restore();
+  return *embedding_table.MutableData();
+}
+}  // namespace
+
 class TestPersistStorage : public UT::Common {
  public:
   TestPersistStorage() = default;
   virtual ~TestPersistStorage() = default;
 
-  void SetUp() override {}
-  void TearDown() override {}
+  void SetUp() override {
+    char dir_template[] = "/tmp/persist_storage_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    storage_dir_ = dir_template;
+  }
+  void TearDown() override { RemoveStorageDir(storage_dir_); }
+
+ protected:
+  std::string storage_dir_;
 };
 
 /// Feature: test parameter persistent storage and resotre.
@@ -98,6 +143,82 @@ TEST_F(TestPersistStorage, test_embedding_storage) {
     EXPECT_EQ(data[i], embdding_table_data->at(i));
   }
 }
+
+/// Feature: incremental persistence of the embedding table.
+/// Description: Persist the dirty rows of the embedding table as the delta of the block files for several rounds, with
+/// the delta log compacted, with a corrupted record header and with an incomplete record at the end of the delta log,
+/// and restore the table each time. The table is persisted the first time block by block under a mutex.
+/// Expectation: The restored table is the same as the table in memory, only the delta is written, and the corrupted
+/// and the incomplete records are dropped.
+TEST_F(TestPersistStorage, test_embedding_delta_storage) {
+  constexpr int kVocab = 100000;
+  constexpr int kEmbDim = 16;
+  constexpr size_t kDirtyRowNum = 1000;
+  constexpr size_t kRoundNum = 8;
+  size_t total_dim = IntToSize(kVocab * kEmbDim);
+  auto embedding_shape = std::make_shared<std::vector<int>>(std::vector<int>{kVocab, kEmbDim});
+  PersistentData<float> embedding_table(std::make_shared<std::vector<float>>(total_dim, 1), embedding_shape);
+
+  std::map<std::string, std::string> config_map;
+  config_map[distributed::storage::kFileStoragePath] = storage_dir_;
+  // There are more than 10 blocks, and the delta log is compacted every 4 rounds.
+  config_map[distributed::storage::kMaxBlockLength] = std::to_string(total_dim * sizeof(float) / 16);
+  size_t delta_length = kDirtyRowNum * (kEmbDim * sizeof(float) + sizeof(uint64_t));
+  config_map[distributed::storage::kMaxDeltaLogLength] = std::to_string(delta_length * 4);
+  embedding_table.Initialize(config_map);
+
+  std::mutex data_mutex;
+  embedding_table.Snapshot(distributed::storage::DirtyInfo());
+  embedding_table.PersistSnapshot(&data_mutex);
+  EXPECT_EQ(RestoreEmbedding(config_map, embedding_shape, total_dim), *embedding_table.MutableData());
+
+  std::string delta_log_file_name = storage_dir_ + "/" + distributed::storage::kDeltaLogFileName;
+  for (size_t round = 0; round < kRoundNum; round++) {
+    distributed::storage::DirtyInfo dirty_info;
+    for (size_t i = 0; i < kDirtyRowNum; i++) {
+      // The rows of one round are different, since the stride is coprime with the vocab.
+      int row = SizeToInt((round * kDirtyRowNum + i * 97) % kVocab);
+      dirty_info.push_back(row);
+      for (int j = 0; j < kEmbDim; j++) {
+        embedding_table.data()[row * kEmbDim + j] = static_cast<float>(round * kDirtyRowNum + i);
+      }
+    }
+
+    embedding_table.Snapshot(dirty_info);
+    embedding_table.PersistSnapshot(&data_mutex);
+    EXPECT_EQ(distributed::storage::FileIOUtils::IsFileOrDirExist(delta_log_file_name), round % 4 != 3);
+    EXPECT_EQ(RestoreEmbedding(config_map, embedding_shape, total_dim), *embedding_table.MutableData());
+  }
+
+  // The record whose generation is corrupted is dropped by the checksum of its header.
+  auto expect_table = *embedding_table.MutableData();
+  size_t valid_length = FileLength(delta_log_file_name);
+  embedding_table.data()[0] = -1;
+  embedding_table.Snapshot({0});
+  embedding_table.PersistSnapshot();
+  std::fstream corrupted_log(delta_log_file_name, std::ios::in | std::ios::out | std::ios::binary);
+  (void)corrupted_log.seekp(static_cast<std::streamoff>(valid_length));
+  (void)corrupted_log.put(static_cast<char>(0x7f));
+  corrupted_log.close();
+  EXPECT_EQ(RestoreEmbedding(config_map, embedding_shape, total_dim), expect_table);
+  EXPECT_EQ(FileLength(delta_log_file_name), valid_length);
+
+  // The incomplete record written by the crash is dropped, and the records appended after it are replayed.
+  embedding_table.Snapshot({0});
+  embedding_table.PersistSnapshot();
+  std::ofstream delta_log(delta_log_file_name, std::ios::out | std::ios::app | std::ios::binary);
+  delta_log << "torn record";
+  delta_log.close();
+  PersistentData<float> restored_table(std::make_shared<std::vector<float>>(total_dim, 0), embedding_shape);
+  restored_table.Initialize(config_map);
+  restored_table.Restore();
+  EXPECT_EQ(*restored_table.MutableData(), *embedding_table.MutableData());
+
+  restored_table.data()[kEmbDim] = -2;
+  restored_table.Snapshot({1});
+  restored_table.PersistSnapshot();
+  EXPECT_EQ(RestoreEmbedding(config_map, embedding_shape, total_dim), *restored_table.MutableData());
+}
 }  // namespace persistent
 }  // namespace distributed
 }  // namespace mindspore
@@ -0,0 +1,276 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common_test.h"
+#include "ps/core/server_node.h"
+#include "ps/ps_context.h"
+#include "fl/server/common.h"
+#include "securec/include/securec.h"
+#include "utils/log_adapter.h"
+#define private public
+#include "fl/server/shared_memory_group.h"
+#include "fl/server/collective_ops_impl.h"
+#undef private
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace {
+constexpr char kGroupName[] = "test_group";
+
+// The server node whose collective messages are delivered to the nodes in this process directly.
+class FakeServerNode : public ps::core::ServerNode {
+ public:
+  FakeServerNode(uint32_t rank_id, const std::vector<std::string> &node_ips,
+                 std::vector<std::shared_ptr<FakeServerNode>> *nodes)
+      : node_ips_(node_ips), nodes_(nodes) {
+    node_info_.rank_id_ = rank_id;
+    node_info_.node_role_ = ps::core::NodeRole::SERVER;
+    server_num_ = SizeToInt(node_ips.size());
+  }
+  ~FakeServerNode() override = default;
+
+  uint64_t CollectiveSendAsync(const ps::core::NodeRole &, const uint32_t &rank_id, const void *data,
+                               size_t size) override {
+    auto message_meta = std::make_shared<ps::core::MessageMeta>();
+    message_meta->set_cmd(ps::core::NodeCommand::COLLECTIVE_SEND_DATA);
+    message_meta->set_rank_id(node_info_.rank_id_);
+    message_meta->set_role(node_info_.node_role_);
+    std::vector<int32_t> shm_info;
+    // The shared memory info of the leader is the only message of two int32.
+    if (fake_pid_ != 0 && size == sizeof(int32_t) * 2) {
+      shm_info.assign(static_cast<const int32_t *>(data), static_cast<const int32_t *>(data) + 2);
+      shm_info[1] = fake_pid_;
+      data = shm_info.data();
+    }
+    nodes_->at(rank_id)->RunReceiveCallback(message_meta, ps::core::Protos::RAW, data, size);
+
+    // The message is delivered already, so the send is done.
+    uint64_t request_id = AddMessageTrack(1);
+    std::lock_guard<std::mutex> lock(message_tracker_mutex_);
+    message_tracker_[request_id].second = 1;
+    return request_id;
+  }
+
+  std::string GetNodeIp(const ps::core::NodeRole &, const uint32_t &rank_id) override { return node_ips_[rank_id]; }
+
+  // The process id in the shared memory info sent by this node, as if the processes were in different pid namespaces.
+  void set_fake_pid(int32_t fake_pid) { fake_pid_ = fake_pid; }
+
+ private:
+  std::vector<std::string> node_ips_;
+  std::vector<std::shared_ptr<FakeServerNode>> *nodes_;
+  int32_t fake_pid_{0};
+};
+
+// The ranks in this process, each of which has its own node and collective communication.
+class FakeCluster {
+ public:
+  explicit FakeCluster(const std::vector<std::string> &node_ips) {
+    for (uint32_t rank = 0; rank < node_ips.size(); ++rank) {
+      nodes_.push_back(std::make_shared<FakeServerNode>(rank, node_ips, &nodes_));
+      auto ops = std::make_unique<CollectiveOpsImpl>();
+      ops->server_node_ = nodes_.back();
+      ops->rank_id_ = rank;
+      ops->server_num_ = SizeToUint(node_ips.size());
+      ops_.push_back(std::move(ops));
+      group_info_.group_ranks.push_back(rank);
+      group_info_.global_to_group_ranks[rank] = rank;
+      group_info_.group_to_global_ranks[rank] = rank;
+    }
+    group_info_.size = SizeToUint(node_ips.size());
+  }
+
+  // Run the function of all the ranks at the same time, and return whether all of them succeed.
+  bool Run(const std::function<bool(uint32_t rank, CollectiveOpsImpl *ops)> &func) {
+    std::vector<std::future<bool>> results;
+    for (uint32_t rank = 0; rank < ops_.size(); ++rank) {
+      results.push_back(std::async(std::launch::async, func, rank, ops_[rank].get()));
+    }
+    bool succeeded = true;
+    for (auto &result : results) {
+      succeeded = result.get() && succeeded;
+    }
+    return succeeded;
+  }
+
+  // AllReduce the data of the ranks within the group, and check the results.
+  bool AllReduce(size_t count) {
+    return Run([this, count](uint32_t rank, CollectiveOpsImpl *ops) {
+      std::vector<float> send = RankData<float>(rank, count);
+      std::vector<float> recv(count, -1);
+      return ops->AllReduce<float>(kGroupName, send.data(), recv.data(), count, nodes_[rank], group_info_) &&
+             recv == ExpectSum<float>(count);
+    });
+  }
+
+  template <typename T>
+  std::vector<T> RankData(uint32_t rank, size_t count) const {
+    std::vector<T> data(count);
+    for (size_t i = 0; i < count; ++i) {
+      data[i] = static_cast<T>((rank + 1) * (i % 13));
+    }
+    return data;
+  }
+
+  template <typename T>
+  std::vector<T> ExpectSum(size_t count) const {
+    std::vector<T> sum(count, 0);
+    for (uint32_t rank = 0; rank < ops_.size(); ++rank) {
+      std::vector<T> data = RankData<T>(rank, count);
+      for (size_t i = 0; i < count; ++i) {
+        sum[i] += data[i];
+      }
+    }
+    return sum;
+  }
+
+  std::shared_ptr<HierarchicalGroup> group(uint32_t rank) const {
+    auto iter = ops_[rank]->hierarchical_groups_.find(kGroupName);
+    return iter == ops_[rank]->hierarchical_groups_.end() ? nullptr : iter->second;
+  }
+
+  const std::shared_ptr<FakeServerNode> &node(uint32_t rank) const { return nodes_[rank]; }
+  CollectiveOpsImpl *ops(uint32_t rank) const { return ops_[rank].get(); }
+
+ private:
+  std::vector<std::shared_ptr<FakeServerNode>> nodes_;
+  std::vector<std::unique_ptr<CollectiveOpsImpl>> ops_;
+  CommunicationGroupInfo group_info_;
+};
+}  // namespace
+
+class TestCollectiveOpsImpl : public UT::Common {
+ public:
+  TestCollectiveOpsImpl() = default;
+  virtual ~TestCollectiveOpsImpl() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+/// Feature: Hierarchical AllReduce of the cpu collective communication.
+/// Description: AllReduce the data of five ranks by the tcp RingAllReduce, then by the PipelinedRingAllReduce whose
+/// ring is in another order. The data is split by more pipeline chunks than the ranks, and the last ones are partial.
+/// Expectation: The results of both rings are the sums of the ranks.
+TEST_F(TestCollectiveOpsImpl, PipelinedRingAllReduce) {
+  const std::vector<uint32_t> ring_ranks = {3, 0, 4, 1, 2};
+  FakeCluster cluster(std::vector<std::string>(ring_ranks.size(), ""));
+  constexpr size_t kCount = kCollectivePipelineBytes / sizeof(int) * 3 + 7;
+  std::vector<std::vector<int>> ring_results(ring_ranks.size());
+  std::vector<std::vector<int>> pipelined_results(ring_ranks.size());
+  EXPECT_TRUE(cluster.Run([&](uint32_t rank, CollectiveOpsImpl *ops) {
+    ops->node_ = cluster.node(rank);
+    ops->node_role_ = ps::core::NodeRole::SERVER;
+    std::vector<int> send = cluster.RankData<int>(rank, kCount);
+    ring_results[rank].resize(kCount);
+    if (!ops->RingAllReduce<int>(send.data(), ring_results[rank].data(), kCount)) {
+      return false;
+    }
+    pipelined_results[rank] = send;
+    return ops->PipelinedRingAllReduce<int>(pipelined_results[rank].data(), kCount, ring_ranks);
+  }));
+  auto expect = cluster.ExpectSum<int>(kCount);
+  for (uint32_t rank = 0; rank < ring_ranks.size(); ++rank) {
+    EXPECT_EQ(ring_results[rank], expect);
+    EXPECT_EQ(pipelined_results[rank], expect);
+  }
+}
+
+/// Feature: Hierarchical AllReduce of the cpu collective communication.
+/// Description: AllReduce within the group of three hosts, whose ranks are interleaved. Two hosts have several ranks
+/// and the third has only one.
+/// Expectation: The ranks are divided by the ips in the order of the group ranks, the local ranks share the shared
+/// memory, and all the ranks get the sums.
+TEST_F(TestCollectiveOpsImpl, HierarchicalAllReduce) {
+  FakeCluster cluster({"10.0.0.1", "10.0.0.2", "10.0.0.1", "10.0.0.3", "10.0.0.2", "10.0.0.1"});
+  constexpr size_t kCount = kSharedMemoryChunkBytes / sizeof(float) * 2 + 1001;
+  EXPECT_TRUE(cluster.AllReduce(kCount));
+
+  const std::vector<std::vector<uint32_t>> local_ranks = {{0, 2, 5}, {1, 4}, {0, 2, 5}, {3}, {1, 4}, {0, 2, 5}};
+  for (uint32_t rank = 0; rank < local_ranks.size(); ++rank) {
+    auto group = cluster.group(rank);
+    ASSERT_NE(group, nullptr);
+    EXPECT_EQ(group->leader_ranks, std::vector<uint32_t>({0, 1, 3}));
+    EXPECT_EQ(group->local_ranks, local_ranks[rank]);
+    EXPECT_EQ(group->shm_group != nullptr, local_ranks[rank].size() > 1);
+  }
+  EXPECT_EQ(cluster.group(0)->shm_group->shm_id(), cluster.group(5)->shm_group->shm_id());
+  EXPECT_NE(cluster.group(0)->shm_group->shm_id(), cluster.group(1)->shm_group->shm_id());
+
+  // The cached groups are used by the next AllReduce.
+  EXPECT_TRUE(cluster.AllReduce(kCount));
+  EXPECT_EQ(cluster.group(0)->shm_group->shm_id(), cluster.group(2)->shm_group->shm_id());
+}
+
+/// Feature: Hierarchical AllReduce of the cpu collective communication.
+/// Description: The local ranks of a host can't attach the shared memory of their leader, as if they were in different
+/// pid namespaces, while the other host uses the shared memory.
+/// Expectation: The ranks of the host fall back to the tcp ring, and all the ranks get the sums.
+TEST_F(TestCollectiveOpsImpl, FallbackToTcp) {
+  FakeCluster cluster({"10.0.0.1", "10.0.0.1", "10.0.0.1", "10.0.0.2", "10.0.0.2"});
+  cluster.node(0)->set_fake_pid(-1);
+  constexpr size_t kCount = kSharedMemoryChunkBytes / sizeof(float) + 1001;
+  EXPECT_TRUE(cluster.AllReduce(kCount));
+  for (uint32_t rank = 0; rank < 3; ++rank) {
+    ASSERT_NE(cluster.group(rank), nullptr);
+    EXPECT_EQ(cluster.group(rank)->shm_group, nullptr);
+  }
+  ASSERT_NE(cluster.group(3), nullptr);
+  EXPECT_NE(cluster.group(3)->shm_group, nullptr);
+  EXPECT_TRUE(cluster.AllReduce(kCount));
+}
+
+/// Feature: Hierarchical AllReduce of the cpu collective communication.
+/// Description: A local rank marks the shared memory failed after an AllReduce, then the group AllReduces again and is
+/// released at last.
+/// Expectation: The local ranks replace the failed shared memory together and get the sums, and no group is cached
+/// after the release.
+TEST_F(TestCollectiveOpsImpl, ReplaceFailedSharedMemory) {
+  FakeCluster cluster({"10.0.0.1", "10.0.0.1", "10.0.0.1"});
+  constexpr size_t kCount = 1001;
+  EXPECT_TRUE(cluster.AllReduce(kCount));
+  std::vector<std::shared_ptr<HierarchicalGroup>> failed_groups;
+  for (uint32_t rank = 0; rank < 3; ++rank) {
+    failed_groups.push_back(cluster.group(rank));
+    ASSERT_NE(failed_groups.back(), nullptr);
+    ASSERT_NE(failed_groups.back()->shm_group, nullptr);
+  }
+  failed_groups[1]->shm_group->Fail();
+
+  EXPECT_TRUE(cluster.AllReduce(kCount));
+  for (uint32_t rank = 0; rank < 3; ++rank) {
+    auto group = cluster.group(rank);
+    ASSERT_NE(group, nullptr);
+    EXPECT_NE(group, failed_groups[rank]);
+    ASSERT_NE(group->shm_group, nullptr);
+    EXPECT_FALSE(group->shm_group->failed());
+  }
+
+  for (uint32_t rank = 0; rank < 3; ++rank) {
+    cluster.ops(rank)->ReleaseHierarchicalGroups();
+    EXPECT_EQ(cluster.group(rank), nullptr);
+  }
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,172 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "common/common_test.h"
+#include "fl/armour/secure_protocol/masking.h"
+#include "fl/armour/secure_protocol/secret_sharing.h"
+
+namespace mindspore {
+namespace armour {
+namespace {
+constexpr size_t kFeatureMapSize = 10007;
+constexpr size_t kPeerNum = 32;
+constexpr size_t kShareNum = 8;
+constexpr size_t kShareMaxSize = 64;
+
+// Generate the mask by encrypting the zeros of the whole mask at one time, which is how the mask was generated.
+std::vector<float> ReferenceMasking(size_t noise_len, const uint8_t *secret, const uint8_t *ivec) {
+  int size = static_cast<int>(noise_len * sizeof(int32_t));
+  std::vector<uint8_t> data(size, 0);
+  std::vector<uint8_t> encrypt_data(size, 0);
+  int encrypt_len = 0;
+  AESEncrypt encrypt(secret, SECRET_MAX_LEN, ivec, AES_IV_SIZE, AES_CTR);
+  EXPECT_EQ(encrypt.EncryptData(data.data(), size, encrypt_data.data(), &encrypt_len), 0);
+  std::vector<float> noise;
+  for (size_t i = 0; i < noise_len; i++) {
+    auto value = *(reinterpret_cast<int32_t *>(encrypt_data.data()) + i);
+    noise.push_back(static_cast<float>(value) / INT32_MAX);
+  }
+  return noise;
+}
+
+std::vector<uint8_t> TestBytes(size_t size, uint8_t seed) {
+  std::vector<uint8_t> bytes(size);
+  for (size_t i = 0; i < size; i++) {
+    bytes[i] = static_cast<uint8_t>(seed * 31 + i * 7 + 1);
+  }
+  return bytes;
+}
+
+// Split the secret into the shares at the indices by a random polynomial whose constant term is the secret.
+void SplitSecret(const BIGNUM *prime, const std::vector<uint8_t> &secret, const std::vector<unsigned int> &indices,
+                 std::vector<Share *> *shares) {
+  BN_CTX *ctx = BN_CTX_new();
+  std::vector<BIGNUM *> coefficients(indices.size());
+  coefficients[0] = BN_bin2bn(secret.data(), static_cast<int>(secret.size()), nullptr);
+  for (size_t i = 1; i < coefficients.size(); i++) {
+    coefficients[i] = BN_new();
+    (void)BN_rand_range(coefficients[i], prime);
+  }
+  BIGNUM *x = BN_new();
+  BIGNUM *y = BN_new();
+  for (size_t i = 0; i < indices.size(); i++) {
+    // Horner's method from the highest term.
+    (void)BN_set_word(x, indices[i]);
+    (void)BN_copy(y, coefficients.back());
+    for (size_t j = coefficients.size() - 1; j > 0; j--) {
+      (void)BN_mod_mul(y, y, x, prime, ctx);
+      (void)BN_mod_add(y, y, coefficients[j - 1], prime, ctx);
+    }
+    Share *share = new Share();
+    share->index = indices[i];
+    share->data = static_cast<unsigned char *>(malloc(kShareMaxSize));
+    share->len = static_cast<size_t>(BN_bn2bin(y, share->data));
+    shares->push_back(share);
+  }
+  BN_free(x);
+  BN_free(y);
+  for (auto coefficient : coefficients) {
+    BN_free(coefficient);
+  }
+  BN_CTX_free(ctx);
+}
+}  // namespace
+
+class TestSecureAggregation : public UT::Common {
+ public:
+  TestSecureAggregation() = default;
+  virtual ~TestSecureAggregation() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+/// Feature: Masking of the secure aggregation.
+/// Description: Accumulate the pairwise masks of the peers block by block, and generate them as whole vectors.
+/// Expectation: The accumulated masks are exactly the same as the sums of the whole masks.
+TEST_F(TestSecureAggregation, AccumulateMasking) {
+  std::vector<float> expect(kFeatureMapSize, 0);
+  std::vector<float> sum(kFeatureMapSize, 0);
+  for (size_t peer = 0; peer < kPeerNum; peer++) {
+    std::vector<uint8_t> secret = TestBytes(SECRET_MAX_LEN, peer);
+    std::vector<uint8_t> ivec = TestBytes(AES_IV_SIZE, peer + 1);
+    bool negative = peer % 2 == 0;
+    std::vector<float> noise = ReferenceMasking(kFeatureMapSize, secret.data(), ivec.data());
+    for (size_t i = 0; i < kFeatureMapSize; i++) {
+      expect[i] += negative ? noise[i] * -1 : noise[i];
+    }
+    ASSERT_EQ(Masking::AccumulateMasking(sum.data(), kFeatureMapSize, negative, secret.data(), SECRET_MAX_LEN,
+                                         ivec.data(), AES_IV_SIZE),
+              0);
+  }
+  EXPECT_EQ(sum, expect);
+
+  std::vector<uint8_t> secret = TestBytes(SECRET_MAX_LEN, 0);
+  std::vector<uint8_t> ivec = TestBytes(AES_IV_SIZE, 1);
+  std::vector<float> noise = {1.0};
+  ASSERT_EQ(Masking::GetMasking(&noise, kFeatureMapSize, secret.data(), SECRET_MAX_LEN, ivec.data(), AES_IV_SIZE), 0);
+  ASSERT_EQ(noise.size(), kFeatureMapSize + 1);
+  EXPECT_EQ(std::vector<float>(noise.begin() + 1, noise.end()),
+            ReferenceMasking(kFeatureMapSize, secret.data(), ivec.data()));
+  EXPECT_EQ(Masking::AccumulateMasking(sum.data(), kFeatureMapSize, false, secret.data(), SECRET_MAX_LEN - 1,
+                                       ivec.data(), AES_IV_SIZE),
+            -1);
+}
+
+/// Feature: Secret sharing of the secure aggregation.
+/// Description: Combine the secrets of the clients from the shares of the same indices, with and without the
+/// precomputed lagrange coefficients.
+/// Expectation: Both ways reconstruct the secrets.
+TEST_F(TestSecureAggregation, CombineWithLagrangeCoefficients) {
+  BIGNUM *prime = BN_new();
+  ASSERT_EQ(GetPrime(prime), 0);
+  SecretSharing secret_sharing(prime);
+  std::vector<unsigned int> indices;
+  for (size_t i = 0; i < kShareNum; i++) {
+    indices.push_back(static_cast<unsigned int>(i * 3 + 1));
+  }
+  std::vector<BIGNUM *> coefficients;
+  ASSERT_EQ(secret_sharing.GetLagrangeCoefficients(indices, &coefficients), 0);
+  ASSERT_EQ(coefficients.size(), kShareNum);
+
+  for (size_t client = 0; client < kPeerNum; client++) {
+    std::vector<uint8_t> secret = TestBytes(SECRET_MAX_LEN, client);
+    std::vector<Share *> shares;
+    SplitSecret(prime, secret, indices, &shares);
+    uint8_t combined[SECRET_MAX_LEN] = {0};
+    uint8_t precomputed[SECRET_MAX_LEN] = {0};
+    size_t combined_len = 0;
+    size_t precomputed_len = 0;
+    EXPECT_EQ(secret_sharing.Combine(kShareNum, shares, combined, &combined_len), 0);
+    EXPECT_EQ(secret_sharing.Combine(kShareNum, shares, coefficients, precomputed, &precomputed_len), 0);
+    EXPECT_EQ(std::vector<uint8_t>(precomputed, precomputed + precomputed_len), secret);
+    EXPECT_EQ(std::vector<uint8_t>(combined, combined + combined_len), secret);
+    for (auto share : shares) {
+      delete share;
+    }
+  }
+
+  std::vector<unsigned int> duplicated_indices = {1, 1};
+  std::vector<BIGNUM *> invalid_coefficients;
+  EXPECT_EQ(secret_sharing.GetLagrangeCoefficients(duplicated_indices, &invalid_coefficients), -1);
+  EXPECT_TRUE(invalid_coefficients.empty());
+  secret_sharing.FreeBNVector(coefficients);
+  BN_clear_free(prime);
+}
+}  // namespace armour
+}  // namespace mindspore
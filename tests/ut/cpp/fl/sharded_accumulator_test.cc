@@ -0,0 +1,147 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "common/common_test.h"
+#include "fl/server/kernel/sharded_accumulator.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace kernel {
+namespace {
+constexpr size_t kClientNum = 64;
+constexpr size_t kThreadNum = 8;
+
+// The weight uploaded by the client, which is multiplied by its data size already.
+std::vector<float> ClientWeight(size_t element_num, size_t client) {
+  std::vector<float> weight(element_num);
+  for (size_t i = 0; i < element_num; ++i) {
+    weight[i] = static_cast<float>((client + i) % 7);
+  }
+  return weight;
+}
+
+// Upload the weights of the clients by the threads concurrently, and return the clients aggregated per second.
+template <typename Func>
+double RunClients(const std::vector<std::vector<float>> &weights, const Func &aggregate) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([&weights, &aggregate, t]() {
+      for (size_t client = t; client < weights.size(); client += kThreadNum) {
+        aggregate(weights[client], client);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start;
+  return weights.size() / cost.count();
+}
+}  // namespace
+
+class TestShardedAccumulator : public UT::Common {
+ public:
+  TestShardedAccumulator() = default;
+  virtual ~TestShardedAccumulator() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+/// Feature: Sharded accumulation of the federated average.
+/// Description: Accumulate the weights of the clients concurrently, reduce them, then accumulate the next round.
+/// Expectation: The reduced weight and data size are the sums of the clients, and the sum is cleared after reduced.
+TEST_F(TestShardedAccumulator, ReduceSum) {
+  // Not a multiple of the chunk size, so the last shard is shorter than the others.
+  constexpr size_t kElementNum = 100003;
+  ShardedAccumulator<float, size_t> accumulator(kElementNum, kThreadNum);
+  EXPECT_GT(accumulator.shard_num(), 1);
+  EXPECT_LE(accumulator.shard_num(), kThreadNum);
+  std::vector<std::vector<float>> weights;
+  std::vector<float> expect(kElementNum, 0);
+  for (size_t client = 0; client < kClientNum; ++client) {
+    weights.push_back(ClientWeight(kElementNum, client));
+    for (size_t i = 0; i < kElementNum; ++i) {
+      expect[i] += weights.back()[i];
+    }
+  }
+  (void)RunClients(weights, [&accumulator](const std::vector<float> &weight, size_t client) {
+    EXPECT_TRUE(accumulator.Accumulate(weight.data(), weight.size(), client + 1));
+  });
+  std::vector<float> output(kElementNum, -1);
+  EXPECT_EQ(accumulator.Reduce(output.data()), kClientNum * (kClientNum + 1) / 2);
+  EXPECT_EQ(output, expect);
+
+  EXPECT_EQ(accumulator.Reduce(output.data()), 0);
+  EXPECT_EQ(output, std::vector<float>(kElementNum, 0));
+  EXPECT_FALSE(accumulator.Accumulate(weights[0].data(), kElementNum - 1, 1));
+
+  // The sum of the round which is not done is dropped.
+  EXPECT_TRUE(accumulator.Accumulate(weights[0].data(), kElementNum, 1));
+  accumulator.Clear();
+  EXPECT_TRUE(accumulator.Accumulate(weights[1].data(), kElementNum, 1));
+  EXPECT_EQ(accumulator.Reduce(output.data()), 1);
+  EXPECT_EQ(output, weights[1]);
+}
+
+/// Feature: Sharded accumulation of the federated average.
+/// Description: Aggregate the weights of the clients concurrently into the sum of one element range, which is the same
+/// as one mutex, and into the sharded sum. Take the best throughput in clients per second of several rounds.
+/// Expectation: The sums are the same, and the sharded sum is not slower than the single range one. The sharded sum is
+/// expected to be faster with several cores, a tolerance is left for the timing noise of the machine with one core.
+TEST_F(TestShardedAccumulator, Throughput) {
+  constexpr size_t kElementNum = 1 << 16;
+  constexpr size_t kRoundNum = 3;
+  constexpr double kThroughputTolerance = 0.5;
+  std::vector<std::vector<float>> weights;
+  for (size_t client = 0; client < kClientNum; ++client) {
+    weights.push_back(ClientWeight(kElementNum, client));
+  }
+
+  ShardedAccumulator<float, size_t> single(kElementNum, 1);
+  ShardedAccumulator<float, size_t> sharded(kElementNum, ShardedAccumulator<float, size_t>::DefaultShardNum());
+  EXPECT_EQ(single.shard_num(), 1);
+  auto single_aggregate = [&single](const std::vector<float> &weight, size_t) {
+    EXPECT_TRUE(single.Accumulate(weight.data(), weight.size(), 1));
+  };
+  auto sharded_aggregate = [&sharded](const std::vector<float> &weight, size_t) {
+    EXPECT_TRUE(sharded.Accumulate(weight.data(), weight.size(), 1));
+  };
+  double single_throughput = 0;
+  double sharded_throughput = 0;
+  for (size_t round = 0; round < kRoundNum; ++round) {
+    single_throughput = std::max(single_throughput, RunClients(weights, single_aggregate));
+    sharded_throughput = std::max(sharded_throughput, RunClients(weights, sharded_aggregate));
+    std::vector<float> single_sum(kElementNum, -1);
+    std::vector<float> sharded_sum(kElementNum, -1);
+    EXPECT_EQ(single.Reduce(single_sum.data()), kClientNum);
+    EXPECT_EQ(sharded.Reduce(sharded_sum.data()), kClientNum);
+    EXPECT_EQ(sharded_sum, single_sum);
+  }
+  EXPECT_GT(single_throughput, 0);
+  EXPECT_GT(sharded_throughput, single_throughput * kThroughputTolerance);
+}
+}  // namespace kernel
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
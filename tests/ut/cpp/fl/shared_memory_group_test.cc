@@ -0,0 +1,126 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "common/common_test.h"
+#include "securec/include/securec.h"
+#include "utils/log_adapter.h"
+#define private public
+#include "fl/server/shared_memory_group.h"
+#undef private
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace {
+constexpr uint32_t kLocalSize = 4;
+// Neither multiple of the chunk size, nor of the local size.
+constexpr size_t kElementNum = kSharedMemoryChunkBytes / sizeof(float) * 3 + 1001;
+constexpr size_t kRoundNum = 3;
+
+std::vector<float> LocalData(uint32_t local_rank, size_t round) {
+  std::vector<float> data(kElementNum);
+  for (size_t i = 0; i < kElementNum; ++i) {
+    data[i] = static_cast<float>((local_rank + 1) * ((i + round) % 13));
+  }
+  return data;
+}
+
+// AllReduce several rounds, so the buffers of the chunks are reused by the next rounds.
+bool RunLocalRank(SharedMemoryGroup *group) {
+  for (size_t round = 0; round < kRoundNum; ++round) {
+    std::vector<float> expect(kElementNum, 0);
+    for (uint32_t rank = 0; rank < kLocalSize; ++rank) {
+      std::vector<float> data = LocalData(rank, round);
+      for (size_t i = 0; i < kElementNum; ++i) {
+        expect[i] += data[i];
+      }
+    }
+    std::vector<float> send = LocalData(group->local_rank(), round);
+    std::vector<float> recv(kElementNum, -1);
+    if (!group->AllReduce<float>(send.data(), recv.data(), kElementNum, nullptr) || recv != expect) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+class TestSharedMemoryGroup : public UT::Common {
+ public:
+  TestSharedMemoryGroup() = default;
+  virtual ~TestSharedMemoryGroup() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+/// Feature: Hierarchical AllReduce of the cpu collective communication.
+/// Description: The local ranks run in threads and attach the shared memory created by the leader, then AllReduce the
+/// data of several rounds. The shared memory of another process or another local size is attached as well.
+/// Expectation: All the local ranks get the sums, and the invalid shared memory is not attached.
+TEST_F(TestSharedMemoryGroup, AllReduce) {
+  SharedMemoryGroup leader(0, kLocalSize);
+  ASSERT_TRUE(leader.Create());
+  int shm_id = leader.shm_id();
+  int leader_pid = static_cast<int>(getpid());
+  // The shared memory is removed after all the groups detach it.
+  leader.Destroy();
+
+  SharedMemoryGroup invalid_size(1, kLocalSize + 1);
+  EXPECT_FALSE(invalid_size.Attach(shm_id, leader_pid));
+  SharedMemoryGroup invalid_pid(1, kLocalSize);
+  EXPECT_FALSE(invalid_pid.Attach(shm_id, leader_pid + 1));
+
+  std::vector<std::unique_ptr<SharedMemoryGroup>> groups;
+  for (uint32_t local_rank = 1; local_rank < kLocalSize; ++local_rank) {
+    groups.push_back(std::make_unique<SharedMemoryGroup>(local_rank, kLocalSize));
+    ASSERT_TRUE(groups.back()->Attach(shm_id, leader_pid));
+  }
+  std::vector<std::future<bool>> results;
+  for (auto &group : groups) {
+    results.push_back(std::async(std::launch::async, [&group]() { return RunLocalRank(group.get()); }));
+  }
+  EXPECT_TRUE(RunLocalRank(&leader));
+  for (auto &result : results) {
+    EXPECT_TRUE(result.get());
+  }
+  EXPECT_FALSE(leader.failed());
+}
+
+/// Feature: Hierarchical AllReduce of the cpu collective communication.
+/// Description: A local rank fails before the others AllReduce.
+/// Expectation: The others stop waiting for it and return false, and the failure is seen by all the local ranks.
+TEST_F(TestSharedMemoryGroup, Failure) {
+  SharedMemoryGroup leader(0, 2);
+  ASSERT_TRUE(leader.Create());
+  leader.Destroy();
+  SharedMemoryGroup follower(1, 2);
+  ASSERT_TRUE(follower.Attach(leader.shm_id(), static_cast<int>(getpid())));
+
+  follower.Fail();
+  std::vector<float> data(kElementNum, 1);
+  EXPECT_FALSE(leader.AllReduce<float>(data.data(), data.data(), kElementNum, nullptr));
+  EXPECT_TRUE(leader.failed());
+  EXPECT_TRUE(follower.failed());
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
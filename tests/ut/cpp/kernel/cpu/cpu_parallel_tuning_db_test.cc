@@ -0,0 +1,125 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "common/common_test.h"
+#include "backend/kernel_compiler/cpu/cpu_parallel_tuning_db.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+constexpr char kKernelKey[] = "MatMul{transpose_a=false;transpose_b=false;}(43[32,64,],43[64,16,],)->(43[32,16,],)";
+constexpr char kOtherKernelKey[] = "MatMul{transpose_a=false;transpose_b=true;}(43[32,64,],43[16,64,],)->(43[32,16,],)";
+constexpr size_t kCount = 32;
+constexpr size_t kThreadNum = 8;
+}  // namespace
+
+class ParallelTuningDBTest : public UT::Common {
+ public:
+  ParallelTuningDBTest() = default;
+
+  void SetUp() override {
+    char dir_template[] = "/tmp/parallel_tuning_db_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    db_dir_ = dir_template;
+    db_path_ = db_dir_ + "/tuning_db.json";
+  }
+
+  void TearDown() override {
+    (void)std::remove(db_path_.c_str());
+    (void)rmdir(db_dir_.c_str());
+  }
+
+ protected:
+  std::string db_dir_;
+  std::string db_path_;
+};
+
+/// Feature: Parallel tuning database of cpu kernels.
+/// Description: Insert the records of two kernels, save them, and load them in another database of the same file.
+/// Expectation: The records are restored by the full kernel keys, and the other launch counts miss.
+TEST_F(ParallelTuningDBTest, TestSaveAndLoad) {
+  ParallelTuningRecord record;
+  record.best_pow = 3;
+  record.task_split = 4;
+  record.thread_num = kThreadNum;
+  record.cost_time = 0.5;
+  {
+    ParallelTuningDB db(db_path_);
+    ASSERT_TRUE(db.enabled());
+    ParallelTuningRecord fetched;
+    EXPECT_FALSE(db.Fetch(kKernelKey, kCount, kThreadNum, &fetched));
+    db.Insert(kKernelKey, kCount, kThreadNum, record);
+    ParallelTuningRecord other = record;
+    other.best_pow = 1;
+    db.Insert(kOtherKernelKey, kCount, kThreadNum, other);
+    db.Flush();
+  }
+
+  ParallelTuningDB db(db_path_);
+  ParallelTuningRecord fetched;
+  ASSERT_TRUE(db.Fetch(kKernelKey, kCount, kThreadNum, &fetched));
+  EXPECT_EQ(fetched.best_pow, record.best_pow);
+  EXPECT_EQ(fetched.task_split, record.task_split);
+  EXPECT_EQ(fetched.thread_num, record.thread_num);
+  EXPECT_DOUBLE_EQ(fetched.cost_time, record.cost_time);
+  ASSERT_TRUE(db.Fetch(kOtherKernelKey, kCount, kThreadNum, &fetched));
+  EXPECT_EQ(fetched.best_pow, 1);
+  EXPECT_FALSE(db.Fetch(kKernelKey, kCount * 2, kThreadNum, &fetched));
+  EXPECT_FALSE(db.Fetch(kKernelKey, kCount, kThreadNum / 2, &fetched));
+}
+
+/// Feature: Parallel tuning database of cpu kernels.
+/// Description: Insert a record and destroy the database without flushing it.
+/// Expectation: The database file is not written on destruction, so the record is not loaded.
+TEST_F(ParallelTuningDBTest, TestNoFlushOnDestruction) {
+  ParallelTuningRecord record;
+  {
+    ParallelTuningDB db(db_path_);
+    db.Insert(kKernelKey, kCount, kThreadNum, record);
+  }
+  ParallelTuningDB db(db_path_);
+  ParallelTuningRecord fetched;
+  EXPECT_FALSE(db.Fetch(kKernelKey, kCount, kThreadNum, &fetched));
+}
+
+/// Feature: Parallel tuning database of cpu kernels.
+/// Description: Insert a record in the offline tuning mode, then load the file in the online mode.
+/// Expectation: The offline mode saves the record at once but never fetches, and the online mode fetches it.
+TEST_F(ParallelTuningDBTest, TestOfflineTuning) {
+  ParallelTuningRecord record;
+  record.best_pow = 2;
+  {
+    ParallelTuningDB db(db_path_, true);
+    EXPECT_TRUE(db.is_offline_tuning());
+    db.Insert(kKernelKey, kCount, kThreadNum, record);
+    ParallelTuningRecord fetched;
+    EXPECT_FALSE(db.Fetch(kKernelKey, kCount, kThreadNum, &fetched));
+    ParallelTuningDB loaded(db_path_);
+    ASSERT_TRUE(loaded.Fetch(kKernelKey, kCount, kThreadNum, &fetched));
+    EXPECT_EQ(fetched.best_pow, record.best_pow);
+  }
+  ParallelTuningDB disabled("");
+  EXPECT_FALSE(disabled.enabled());
+  disabled.Insert(kKernelKey, kCount, kThreadNum, record);
+  ParallelTuningRecord fetched;
+  EXPECT_FALSE(disabled.Fetch(kKernelKey, kCount, kThreadNum, &fetched));
+}
+}  // namespace kernel
+}  // namespace mindspore
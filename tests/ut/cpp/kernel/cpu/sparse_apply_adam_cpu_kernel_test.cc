@@ -14,6 +14,10 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <future>
+#include <shared_mutex>
+#include <thread>
 #include <vector>
 #include "common/common_test.h"
 #define private public
@@ -175,5 +179,57 @@ TEST_F(SparseApplyAdamCpuKernelTest, sparse_test2) {
     EXPECT_TRUE(std::fabs(var_[i] - 0.999653) < 1e-6);
   }
 }
+
+/// Feature: Row striped locks of the sparse optimizers on the parameter server.
+/// Description: Hold the lock of a row exclusively while the kernel updates all the rows in another thread, and read
+/// another row meanwhile.
+/// Expectation: Only the stripe of the locked row blocks the launch, so the other row can be read, and all the rows
+/// are updated after the lock is released.
+TEST_F(SparseApplyAdamCpuKernelTest, row_lock_test) {
+  for (size_t i = 0; i < 3 * 3 * 3; ++i) {
+    var_.push_back(1.0);
+    m_.push_back(1.0);
+    v_.push_back(1.0);
+    grad_.push_back(1.0);
+  }
+  sparse_adam_->indices_size_ = 3;
+  sparse_adam_->var_first_dim_size_ = 3;
+  sparse_adam_->var_outer_dim_size_ = 9;
+  sparse_adam_->indices_data_type_ = kNumberTypeInt64;
+  auto row_lock = std::make_shared<RowStripedLock>();
+  sparse_adam_->set_row_lock(row_lock);
+
+  std::vector<int64_t> indices{0, 1, 2};
+  CreateInputAddress(indices);
+  std::vector<float> new_grad(3 * 3 * 3);
+  std::vector<int64_t> new_indices(3);
+  std::vector<float> tmp_grad(3 * 3 * 3);
+  std::vector<int64_t> tmp_indices(3);
+  std::vector<float> m_t(3 * 3 * 3);
+  CreateWorkspaceAddress(new_grad, new_indices, tmp_grad, tmp_indices, m_t);
+
+  std::unique_lock<std::shared_mutex> row_guard(row_lock->GetLock(1));
+  std::promise<void> launched;
+  std::future<void> launch_done = launched.get_future();
+  std::thread launch_thread([this, &launched]() {
+    sparse_adam_->Launch(inputs_, workspace_, outputs_);
+    launched.set_value();
+  });
+  // The launch holds one stripe at most, which is released before the next, so the other row is read while the
+  // launch waits for the locked row.
+  {
+    std::shared_lock<std::shared_mutex> read_guard(row_lock->GetLock(0));
+    EXPECT_EQ(launch_done.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+  }
+  for (size_t i = 3 * 3; i < 2 * 3 * 3; ++i) {
+    EXPECT_EQ(var_[i], 1.0);
+  }
+  row_guard.unlock();
+  launch_done.wait();
+  launch_thread.join();
+  for (size_t i = 0; i < 3 * 3 * 3; ++i) {
+    EXPECT_TRUE(std::fabs(var_[i] - 0.999684) < 1e-6);
+  }
+}
 }  // namespace kernel
 }  // namespace mindspore
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "thread/actor_threadpool.h"
+
+namespace mindspore {
+class ActorThreadPoolTest : public UT::Common {
+ public:
+  ActorThreadPoolTest() = default;
+  void SetUp() override {
+    // No actor thread, so the test pops the ready actors itself in a deterministic order.
+    pool_.reset(ActorThreadPool::CreateThreadPool(0));
+    ASSERT_NE(pool_, nullptr);
+  }
+  void TearDown() override {
+    while (pool_->PopActorFromQueue() != nullptr) {
+    }
+    pool_.reset();
+  }
+
+ protected:
+  // Run the DAG on the given number of workers in unit time steps, using the pool as the ready queue, and return the
+  // number of steps. The edges are from the actor to its successors, and every actor takes one step.
+  size_t Schedule(const std::vector<std::unique_ptr<ActorBase>> &actors,
+                  const std::map<ActorBase *, std::vector<ActorBase *>> &edges, size_t worker_num) {
+    std::map<ActorBase *, size_t> input_num;
+    for (const auto &edge : edges) {
+      for (auto successor : edge.second) {
+        ++input_num[successor];
+      }
+    }
+    for (const auto &actor : actors) {
+      if (input_num[actor.get()] == 0) {
+        pool_->PushActorToQueue(actor.get());
+      }
+    }
+    size_t steps = 0;
+    size_t done = 0;
+    while (done < actors.size()) {
+      std::vector<ActorBase *> running;
+      for (size_t i = 0; i < worker_num; ++i) {
+        auto actor = pool_->PopActorFromQueue();
+        if (actor != nullptr) {
+          running.push_back(actor);
+        }
+      }
+      if (running.empty()) {
+        break;
+      }
+      ++steps;
+      done += running.size();
+      for (auto actor : running) {
+        auto iter = edges.find(actor);
+        if (iter == edges.end()) {
+          continue;
+        }
+        for (auto successor : iter->second) {
+          if (--input_num[successor] == 0) {
+            pool_->PushActorToQueue(successor);
+          }
+        }
+      }
+    }
+    return done == actors.size() ? steps : 0;
+  }
+
+  std::unique_ptr<ActorThreadPool> pool_;
+};
+
+namespace {
+// A chain of 'chain_len' actors and 'branch_num' single actor branches. The branches are ahead of the chain in the
+// ready queue. The chain is the critical path, which GraphScheduler gives the upward rank as priority. Or no actor has
+// the priority, as in FIFO scheduling.
+void BuildMultiBranch(size_t chain_len, size_t branch_num, bool by_rank,
+                      std::vector<std::unique_ptr<ActorBase>> *actors,
+                      std::map<ActorBase *, std::vector<ActorBase *>> *edges) {
+  for (size_t i = 0; i < branch_num; ++i) {
+    auto actor = std::make_unique<ActorBase>("branch_" + std::to_string(i));
+    actors->push_back(std::move(actor));
+  }
+  ActorBase *prev = nullptr;
+  for (size_t i = 0; i < chain_len; ++i) {
+    auto actor = std::make_unique<ActorBase>("chain_" + std::to_string(i));
+    actor->set_priority(by_rank ? static_cast<int64_t>(chain_len - i) : 0);
+    if (prev != nullptr) {
+      (*edges)[prev].push_back(actor.get());
+    }
+    prev = actor.get();
+    actors->push_back(std::move(actor));
+  }
+}
+}  // namespace
+
+/// Feature: Priority scheduling of the actor thread pool.
+/// Description: Push the actors of different priorities, and the actors without priority.
+/// Expectation: The higher priority goes first and FIFO among the same priority, then the actors without priority.
+TEST_F(ActorThreadPoolTest, TestPopOrder) {
+  std::vector<std::unique_ptr<ActorBase>> actors;
+  std::vector<int64_t> priorities = {1, 3, 0, 2, 3, 0, 1};
+  for (size_t i = 0; i < priorities.size(); ++i) {
+    auto actor = std::make_unique<ActorBase>("actor_" + std::to_string(i));
+    actor->set_priority(priorities[i]);
+    pool_->PushActorToQueue(actor.get());
+    actors.push_back(std::move(actor));
+  }
+  std::vector<size_t> expect_order = {1, 4, 3, 0, 6, 2, 5};
+  for (auto index : expect_order) {
+    EXPECT_EQ(pool_->PopActorFromQueue(), actors[index].get());
+  }
+  EXPECT_EQ(pool_->PopActorFromQueue(), nullptr);
+}
+
+/// Feature: Priority scheduling of the actor thread pool.
+/// Description: Run a DAG of a long chain and several short branches on 2 workers, with the rank as the priority of
+/// the critical path and with no priority.
+/// Expectation: The chain is not starved by the branches with the rank, so the DAG finishes at the lower bound of the
+/// work and the critical path, while the FIFO order runs the chain after all the branches.
+TEST_F(ActorThreadPoolTest, TestCriticalPathMultiBranch) {
+  constexpr size_t kChainLen = 4;
+  constexpr size_t kBranchNum = 6;
+  constexpr size_t kWorkerNum = 2;
+  std::vector<std::unique_ptr<ActorBase>> actors;
+  std::map<ActorBase *, std::vector<ActorBase *>> edges;
+  BuildMultiBranch(kChainLen, kBranchNum, true, &actors, &edges);
+  auto rank_steps = Schedule(actors, edges, kWorkerNum);
+  EXPECT_EQ(rank_steps, (kChainLen + kBranchNum + kWorkerNum - 1) / kWorkerNum);
+
+  std::vector<std::unique_ptr<ActorBase>> fifo_actors;
+  std::map<ActorBase *, std::vector<ActorBase *>> fifo_edges;
+  BuildMultiBranch(kChainLen, kBranchNum, false, &fifo_actors, &fifo_edges);
+  auto fifo_steps = Schedule(fifo_actors, fifo_edges, kWorkerNum);
+  EXPECT_EQ(fifo_steps, (kBranchNum + kWorkerNum - 1) / kWorkerNum + kChainLen);
+  EXPECT_LT(rank_steps, fifo_steps);
+}
+}  // namespace mindspore
@@ -0,0 +1,116 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "actor/actor_trace.h"
+
+namespace mindspore {
+namespace {
+constexpr size_t kCapacity = 8;
+}  // namespace
+
+class ActorTraceTest : public UT::Common {
+ public:
+  ActorTraceTest() = default;
+  void SetUp() override {
+    ActorTrace::GetInstance().set_enabled(true);
+    // Drop the events recorded by the other tests.
+    (void)ActorTrace::GetInstance().StepSummary();
+  }
+  void TearDown() override { ActorTrace::GetInstance().set_enabled(false); }
+};
+
+/// Feature: Actor trace.
+/// Description: Push more events than the capacity into the ring buffer.
+/// Expectation: The oldest events are overwritten, and the latest ones are read as they are pushed.
+TEST_F(ActorTraceTest, TestBufferWrapAround) {
+  ActorTraceBuffer buffer(0, kCapacity);
+  constexpr uint64_t kEventNum = kCapacity + 3;
+  for (uint64_t i = 0; i < kEventNum; ++i) {
+    buffer.Push(ActorTraceEventType::kKernelLaunch, "actor" + std::to_string(i), i, i * 2);
+  }
+  ActorTraceEvent event;
+  for (uint64_t i = 0; i < kEventNum - kCapacity; ++i) {
+    EXPECT_FALSE(buffer.Read(i, &event));
+  }
+  for (uint64_t i = kEventNum - kCapacity; i < kEventNum; ++i) {
+    ASSERT_TRUE(buffer.Read(i, &event));
+    EXPECT_EQ(event.type, ActorTraceEventType::kKernelLaunch);
+    EXPECT_EQ(event.begin_ns, i);
+    EXPECT_EQ(event.end_ns, i * 2);
+    EXPECT_EQ(std::string(event.name), "actor" + std::to_string(i));
+  }
+  EXPECT_FALSE(buffer.Read(kEventNum, &event));
+}
+
+/// Feature: Actor trace.
+/// Description: Read the latest events of the ring buffer while a thread keeps pushing and overwriting them.
+/// Expectation: Every event read is consistent, the events being overwritten are skipped.
+TEST_F(ActorTraceTest, TestBufferReadWhileWriting) {
+  ActorTraceBuffer buffer(0, kCapacity);
+  constexpr uint64_t kEventNum = 1 << 16;
+  std::atomic<uint64_t> write_count(0);
+  std::thread writer([&]() {
+    for (uint64_t i = 0; i < kEventNum; ++i) {
+      buffer.Push(ActorTraceEventType::kMessageRun, std::to_string(i), i, i * 2);
+      write_count.store(i + 1, std::memory_order_release);
+    }
+  });
+  ActorTraceEvent event;
+  for (auto count = write_count.load(std::memory_order_acquire); count < kEventNum;
+       count = write_count.load(std::memory_order_acquire)) {
+    for (auto i = count > kCapacity ? count - kCapacity : 0; i < count; ++i) {
+      if (!buffer.Read(i, &event)) {
+        continue;
+      }
+      ASSERT_EQ(event.begin_ns, i);
+      ASSERT_EQ(event.end_ns, i * 2);
+      ASSERT_EQ(std::string(event.name), std::to_string(i));
+    }
+  }
+  writer.join();
+}
+
+/// Feature: Actor trace.
+/// Description: Record the events of several types in several threads, and summarise them twice.
+/// Expectation: The first summary counts the events by the type, and the second one is empty since no new event.
+TEST_F(ActorTraceTest, TestStepSummary) {
+  auto &actor_trace = ActorTrace::GetInstance();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 2; ++i) {
+    threads.emplace_back([&actor_trace]() {
+      actor_trace.Record(ActorTraceEventType::kKernelLaunch, "kernel", 1000, 3000);
+      actor_trace.Record(ActorTraceEventType::kMemoryWait, "kernel", 1000, 2000);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  actor_trace.Record(ActorTraceEventType::kKernelLaunch, "kernel", 1000, 6000);
+  actor_trace.set_enabled(false);
+  actor_trace.Record(ActorTraceEventType::kKernelLaunch, "kernel", 1000, 5000);
+
+  auto summary = actor_trace.StepSummary();
+  EXPECT_NE(summary.find("KernelLaunch[count: 3, total: 9us, avg: 3us, max: 5us]"), std::string::npos);
+  EXPECT_NE(summary.find("MemoryWait[count: 2, total: 2us, avg: 1us, max: 1us]"), std::string::npos);
+  EXPECT_EQ(summary.find("MailboxWait"), std::string::npos);
+  EXPECT_TRUE(actor_trace.StepSummary().empty());
+}
+}  // namespace mindspore
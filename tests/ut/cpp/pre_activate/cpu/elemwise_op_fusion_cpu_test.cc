@@ -0,0 +1,124 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "frontend/operator/ops.h"
+#include "backend/session/kernel_graph.h"
+#include "backend/session/anf_runtime_algorithm.h"
+#include "backend/kernel_compiler/cpu/fused_elemwise_cpu_kernel.h"
+#include "backend/optimizer/cpu/elemwise_op_fusion_cpu.h"
+#include "utils/utils.h"
+
+namespace mindspore {
+namespace opt {
+using KernelBuildInfoBuilder = kernel::KernelBuildInfo::KernelBuildInfoBuilder;
+namespace {
+// Build the graph of op sequence Add(x, y) -> Mul(add, y) -> MatMul(mul, w) -> Exp(matmul) -> Neg(exp), whose op
+// outputs are all returned.
+KernelGraphPtr BuildOpSequenceGraph() {
+  auto graph = std::make_shared<session::KernelGraph>();
+  auto abstract = std::make_shared<abstract::AbstractTensor>(kFloat32, std::vector<int64_t>{3, 3});
+  auto x = graph->NewParameter(abstract);
+  auto y = graph->NewParameter(abstract);
+  auto w = graph->NewParameter(abstract);
+  std::vector<CNodePtr> kernels;
+  auto add_kernel = [&graph, &abstract, &kernels](const PrimitivePtr &prim, const std::vector<AnfNodePtr> &inputs) {
+    std::vector<AnfNodePtr> node_inputs = {NewValueNode(prim)};
+    (void)node_inputs.insert(node_inputs.end(), inputs.begin(), inputs.end());
+    auto kernel = graph->NewCNode(node_inputs);
+    kernel->set_abstract(abstract);
+    auto builder = std::make_shared<KernelBuildInfoBuilder>();
+    builder->SetKernelType(KernelType::CPU_KERNEL);
+    builder->SetProcessor(kernel::Processor::CPU);
+    builder->SetInputsFormat(std::vector<std::string>(inputs.size(), kOpFormat_DEFAULT));
+    builder->SetInputsDeviceType(std::vector<TypeId>(inputs.size(), kNumberTypeFloat32));
+    builder->SetOutputsFormat({kOpFormat_DEFAULT});
+    builder->SetOutputsDeviceType({kNumberTypeFloat32});
+    AnfAlgo::SetSelectKernelBuildInfo(builder->Build(), kernel.get());
+    kernels.push_back(kernel);
+    return kernel;
+  };
+  auto add = add_kernel(prim::kPrimAdd, {x, y});
+  auto mul = add_kernel(prim::kPrimMul, {add, y});
+  auto matmul = add_kernel(prim::kPrimMatMul, {mul, w});
+  auto exp = add_kernel(prim::kPrimExp, {matmul});
+  (void)add_kernel(prim::kPrimNeg, {exp});
+
+  std::vector<AnfNodePtr> make_tuple_inputs = {NewValueNode(prim::kPrimMakeTuple)};
+  (void)make_tuple_inputs.insert(make_tuple_inputs.end(), kernels.begin(), kernels.end());
+  graph->set_output(graph->NewCNode(make_tuple_inputs));
+  graph->set_execution_order(kernels);
+  return graph;
+}
+
+size_t FusedKernelNum(const KernelGraphPtr &graph) {
+  size_t num = 0;
+  for (const auto &kernel : graph->execution_order()) {
+    if (AnfAlgo::GetCNodeName(kernel) == kernel::kFusedElemwiseOpName) {
+      ++num;
+    }
+  }
+  return num;
+}
+}  // namespace
+
+class ElemwiseOpFusionCPUTest : public UT::Common {
+ public:
+  ElemwiseOpFusionCPUTest() = default;
+};
+
+/// Feature: Elementwise op fusion of the op sequence graph on CPU.
+/// Description: Fuse the graph of op sequence in which a MatMul is between two pairs of elementwise ops.
+/// Expectation: Each pair is fused into one kernel, the MatMul stays, and every op output is still a graph output.
+TEST_F(ElemwiseOpFusionCPUTest, TestFusedKernelNum) {
+  auto graph = BuildOpSequenceGraph();
+  graph->set_flag(kAttrOpSequenceGraph, true);
+  ElemwiseOpFusionCPU pass("elemwise_op_fusion_cpu");
+  EXPECT_TRUE(pass.Run(graph));
+
+  const auto &kernels = graph->execution_order();
+  ASSERT_EQ(kernels.size(), 3);
+  EXPECT_EQ(FusedKernelNum(graph), 2);
+  EXPECT_EQ(AnfAlgo::GetCNodeName(kernels[1]), prim::kPrimMatMul->name());
+  for (const auto &kernel : {kernels[0], kernels[2]}) {
+    EXPECT_EQ(AnfAlgo::GetOutputTensorNum(kernel), 2);
+    auto fused_ops = AnfAlgo::GetNodeAttr<std::vector<std::string>>(kernel, kernel::kAttrFusedOps);
+    EXPECT_EQ(fused_ops.size(), 2);
+  }
+  auto graph_outputs = AnfAlgo::GetAllOutputWithIndex(graph->output());
+  ASSERT_EQ(graph_outputs.size(), 5);
+  EXPECT_EQ(graph_outputs[0].first, kernels[0]);
+  EXPECT_EQ(graph_outputs[1].first, kernels[0]);
+  EXPECT_EQ(graph_outputs[1].second, 1);
+  EXPECT_EQ(graph_outputs[2].first, kernels[1]);
+  EXPECT_EQ(graph_outputs[4].first, kernels[2]);
+}
+
+/// Feature: Elementwise op fusion of the op sequence graph on CPU.
+/// Description: Run the fusion on a graph which is not the graph of op sequence.
+/// Expectation: Nothing is fused, since the kernel outputs of the other graphs are mapped to the front nodes.
+TEST_F(ElemwiseOpFusionCPUTest, TestSkipOtherGraph) {
+  auto graph = BuildOpSequenceGraph();
+  ElemwiseOpFusionCPU pass("elemwise_op_fusion_cpu");
+  EXPECT_FALSE(pass.Run(graph));
+  EXPECT_EQ(graph->execution_order().size(), 5);
+  EXPECT_EQ(FusedKernelNum(graph), 0);
+}
+}  // namespace opt
+}  // namespace mindspore
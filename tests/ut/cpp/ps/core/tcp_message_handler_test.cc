@@ -17,8 +17,11 @@
 #include "ps/core/communicator/tcp_message_handler.h"
 #include "common/common_test.h"
 
+#include <event2/event.h>
 #include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace mindspore {
 namespace ps {
@@ -172,6 +175,71 @@ TEST_F(TestTcpMessageHandler, 16Header_2meta_4062Data_16Header_2meta_4062_data)
 
   handler.ReceiveMessage(result, 4064);
 }
+TEST_F(TestTcpMessageHandler, WriteSegments_ReceiveIntoRegisteredBuffer) {
+  struct event_base *base = event_base_new();
+  ASSERT_NE(base, nullptr);
+  struct bufferevent *pair[2];
+  ASSERT_EQ(bufferevent_pair_new(base, 0, pair), 0);
+  ASSERT_EQ(bufferevent_enable(pair[0], EV_READ | EV_WRITE), 0);
+  ASSERT_EQ(bufferevent_enable(pair[1], EV_READ | EV_WRITE), 0);
+
+  auto small_data = std::make_shared<std::vector<unsigned char>>(100, 'a');
+  auto large_data = std::make_shared<std::vector<unsigned char>>(kMessageReferenceMinSize, 'b');
+  std::weak_ptr<std::vector<unsigned char>> large_data_ref = large_data;
+  auto meta = std::make_shared<MessageMeta>();
+  meta->set_request_id(1);
+  std::vector<MessageSegment> segments = {{small_data->data(), small_data->size(), small_data},
+                                          {large_data->data(), large_data->size(), large_data}};
+  EXPECT_TRUE(WriteMessage(pair[0], meta, Protos::RAW, segments));
+  segments.clear();
+  large_data.reset();
+  // The large segment is referenced by the event buffer until it's received.
+  EXPECT_FALSE(large_data_ref.expired());
+
+  size_t data_size = small_data->size() + kMessageReferenceMinSize;
+  auto registered_buffer = std::make_shared<std::vector<unsigned char>>(data_size);
+  bool received = false;
+  TcpMessageHandler handler;
+  handler.SetBufferAllocator([&](const std::shared_ptr<MessageMeta> &meta, size_t size) {
+    EXPECT_EQ(meta->request_id(), 1);
+    EXPECT_EQ(size, data_size);
+    return std::shared_ptr<void>(registered_buffer, registered_buffer->data());
+  });
+  handler.SetCallback([&](std::shared_ptr<MessageMeta> meta, const Protos &, const void *data, size_t size) {
+    EXPECT_EQ(data, registered_buffer->data());
+    EXPECT_EQ(size, data_size);
+    received = true;
+  });
+  handler.ReceiveMessage(bufferevent_get_input(pair[1]));
+  EXPECT_TRUE(received);
+  EXPECT_TRUE(large_data_ref.expired());
+  EXPECT_EQ(registered_buffer->at(0), 'a');
+  EXPECT_EQ(registered_buffer->at(data_size - 1), 'b');
+
+  bufferevent_free(pair[0]);
+  bufferevent_free(pair[1]);
+  event_base_free(base);
+}
+
+TEST_F(TestTcpMessageHandler, IllegalHeader_Drained) {
+  struct evbuffer *buffer = evbuffer_new();
+  ASSERT_NE(buffer, nullptr);
+  TcpMessageHandler handler;
+  handler.SetCallback([this](std::shared_ptr<MessageMeta> meta, const Protos &, const void *data, size_t size) {
+    ADD_FAILURE() << "The illegal message should not be received.";
+  });
+
+  constexpr uint32_t kIllegalProto = 7;
+  char header[kHeaderLen] = {0};
+  memcpy_s(header, sizeof(kIllegalProto), &kIllegalProto, sizeof(kIllegalProto));
+  ASSERT_EQ(evbuffer_add(buffer, header, kHeaderLen), 0);
+  std::string data(100, 'a');
+  ASSERT_EQ(evbuffer_add(buffer, data.data(), data.length()), 0);
+
+  handler.ReceiveMessage(buffer);
+  EXPECT_EQ(evbuffer_get_length(buffer), 0);
+  evbuffer_free(buffer);
+}
 }  // namespace core
 }  // namespace ps
 }  // namespace mindspore
\ No newline at end of file
@@ -0,0 +1,207 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/common_test.h"
+#include "ps/core/communicator/tcp_client.h"
+#include "ps/core/communicator/tcp_server.h"
+
+namespace mindspore {
+namespace ps {
+namespace core {
+namespace {
+constexpr size_t kBaselineReactorNum = 1;
+constexpr size_t kMultiReactorNum = 4;
+// The numbers of the connections swept by the test.
+const std::vector<size_t> kClientNums = {1, 4, 16, 64};
+constexpr size_t kMessageSize = 64 * 1024;
+constexpr size_t kMessageNumPerConnection = 16;
+constexpr uint32_t kConnectTimeoutInSecond = 10;
+constexpr int64_t kReceiveTimeoutInSecond = 60;
+}  // namespace
+
+class TestTcpReactor : public UT::Common {
+ public:
+  TestTcpReactor() = default;
+  virtual ~TestTcpReactor() = default;
+
+  void SetUp() override {
+    char dir_template[] = "/tmp/tcp_reactor_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    config_dir_ = dir_template;
+    config_path_ = config_dir_ + "/config.json";
+  }
+
+  void TearDown() override {
+    StopAll();
+    (void)std::remove(config_path_.c_str());
+    (void)rmdir(config_dir_.c_str());
+  }
+
+  // Start the echo server and the clients with the reactor number, in which the server echoes the pushed data as the
+  // pull response.
+  void StartAll(size_t reactor_num, size_t client_num) {
+    std::ofstream config_file(config_path_);
+    config_file << "{\"" << kReactorNum << "\": " << reactor_num << "}";
+    config_file.close();
+    config_ = std::make_unique<FileConfiguration>(config_path_);
+    ASSERT_TRUE(config_->Initialize());
+
+    server_ = std::make_unique<TcpServer>("127.0.0.1", 0, config_.get(), reactor_num);
+    server_->SetMessageCallback([this](const std::shared_ptr<TcpConnection> &conn,
+                                       const std::shared_ptr<MessageMeta> &meta, const Protos &protos,
+                                       const void *data, size_t size) {
+      (void)server_->SendMessage(conn, meta, protos, data, size);
+    });
+    server_->Init();
+    server_thread_ = std::make_unique<std::thread>([this]() { server_->Start(); });
+
+    clients_.reserve(client_num);
+    for (size_t i = 0; i < client_num; ++i) {
+      auto client = std::make_unique<TcpClient>("127.0.0.1", server_->BoundPort(), config_.get());
+      client->SetMessageCallback([this](const std::shared_ptr<MessageMeta> &, const Protos &, const void *,
+                                        size_t size) {
+        received_bytes_ += size;
+        if (++received_num_ >= expected_num_) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          cond_.notify_all();
+        }
+      });
+      client->Init();
+      auto client_ptr = client.get();
+      clients_.emplace_back(std::move(client));
+      // The event loops of all the clients are run by the Start of any client.
+      if (client_thread_ == nullptr) {
+        client_thread_ = std::make_unique<std::thread>([client_ptr]() { client_ptr->Start(); });
+      }
+      ASSERT_TRUE(client_ptr->WaitConnected(kConnectTimeoutInSecond));
+    }
+  }
+
+  // Stop and destroy the clients and the server, and the event loops of the clients are freed with the last client.
+  void StopAll() {
+    if (!clients_.empty()) {
+      clients_[0]->Stop();
+    }
+    if (client_thread_ != nullptr && client_thread_->joinable()) {
+      client_thread_->join();
+    }
+    client_thread_ = nullptr;
+    if (server_ != nullptr) {
+      server_->Stop();
+    }
+    if (server_thread_ != nullptr && server_thread_->joinable()) {
+      server_thread_->join();
+    }
+    server_thread_ = nullptr;
+    clients_.clear();
+    server_ = nullptr;
+  }
+
+  // Push the messages from every client and wait for the echoed pull responses, return the throughput in MB/s.
+  double PushPull() {
+    received_num_ = 0;
+    received_bytes_ = 0;
+    expected_num_ = clients_.size() * kMessageNumPerConnection;
+    std::vector<unsigned char> data(kMessageSize, 1);
+    auto start_time = std::chrono::steady_clock::now();
+    std::vector<std::thread> send_threads;
+    for (auto &client : clients_) {
+      auto client_ptr = client.get();
+      send_threads.emplace_back([client_ptr, &data]() {
+        for (size_t j = 0; j < kMessageNumPerConnection; ++j) {
+          auto meta = std::make_shared<MessageMeta>();
+          meta->set_cmd(NodeCommand::SEND_DATA);
+          meta->set_request_id(j);
+          EXPECT_TRUE(client_ptr->SendMessage(meta, Protos::RAW, data.data(), data.size()));
+        }
+      });
+    }
+    for (auto &send_thread : send_threads) {
+      send_thread.join();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool received = cond_.wait_for(lock, std::chrono::seconds(kReceiveTimeoutInSecond),
+                                   [this]() { return received_num_.load() >= expected_num_; });
+    EXPECT_TRUE(received);
+    std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start_time;
+    // Both the pushed and pulled bytes are counted.
+    constexpr double kBytesToMB = 1024.0 * 1024.0;
+    return 2.0 * received_bytes_.load() / kBytesToMB / cost.count();
+  }
+
+  size_t ClientEventBaseNum() const {
+    std::set<const event_base *> bases;
+    for (const auto &client : clients_) {
+      (void)bases.insert(&client->eventbase());
+    }
+    return bases.size();
+  }
+
+  std::string config_dir_;
+  std::string config_path_;
+  std::unique_ptr<Configuration> config_;
+  std::unique_ptr<TcpServer> server_;
+  std::unique_ptr<std::thread> server_thread_;
+  std::vector<std::unique_ptr<TcpClient>> clients_;
+  std::unique_ptr<std::thread> client_thread_;
+  std::atomic<size_t> received_num_{0};
+  std::atomic<size_t> received_bytes_{0};
+  std::atomic<size_t> expected_num_{0};
+  std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
+/// Feature: Multi-reactor tcp client and server.
+/// Description: For 1, 4, 16 and 64 connections, push the data to the echo server and pull it back with the same
+/// connections on one reactor as the baseline, then on multiple reactors after the reactors of the baseline are
+/// stopped and freed.
+/// Expectation: All the responses are received in both runs, and the clients are spread over the reactors.
+TEST_F(TestTcpReactor, PushPullWithReactors) {
+  for (auto client_num : kClientNums) {
+    StartAll(kBaselineReactorNum, client_num);
+    EXPECT_EQ(ClientEventBaseNum(), kBaselineReactorNum);
+    double baseline_throughput = PushPull();
+    EXPECT_EQ(received_num_.load(), client_num * kMessageNumPerConnection);
+    StopAll();
+
+    StartAll(kMultiReactorNum, client_num);
+    EXPECT_EQ(ClientEventBaseNum(), std::min(client_num, kMultiReactorNum));
+    double throughput = PushPull();
+    EXPECT_EQ(received_num_.load(), client_num * kMessageNumPerConnection);
+    StopAll();
+    MS_LOG(INFO) << "Connections: " << client_num << ", message size: " << kMessageSize
+                 << "B, push and pull throughput of " << kBaselineReactorNum << " reactor: " << baseline_throughput
+                 << "MB/s, of " << kMultiReactorNum << " reactors: " << throughput << "MB/s";
+  }
+}
+}  // namespace core
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,186 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common/common_test.h"
+#include "ps/ps_cache/embedding_hash_map.h"
+#include "utils/frequency_sketch.h"
+
+namespace mindspore {
+namespace ps {
+namespace {
+constexpr size_t kVocabSize = 10000;
+constexpr size_t kCacheCapacity = 1000;
+constexpr size_t kBatchSize = 100;
+constexpr size_t kStepNum = 500;
+
+// Generate the ids of the batches whose frequency follows the zipf distribution, like the features of the CTR datasets.
+std::vector<int> ZipfIds(size_t size, uint32_t seed) {
+  std::vector<double> weights(kVocabSize);
+  for (size_t i = 0; i < kVocabSize; ++i) {
+    weights[i] = 1.0 / (i + 1);
+  }
+  std::mt19937 generator(seed);
+  std::discrete_distribution<int> distribution(weights.begin(), weights.end());
+  std::vector<int> ids(size);
+  for (auto &id : ids) {
+    id = distribution(generator);
+  }
+  return ids;
+}
+
+// Parse the batches like the PsCacheManager, and return the number of the ids swapped out.
+size_t RunBatches(const std::vector<int> &ids, const std::shared_ptr<FrequencySketch> &frequency_sketch) {
+  EmbeddingHashMap hash_map(0, kCacheCapacity);
+  hash_map.set_frequency_sketch(frequency_sketch);
+  std::vector<int> swap_out_index(kBatchSize);
+  std::vector<int> swap_out_ids(kBatchSize);
+  size_t total_swap_out_size = 0;
+  for (size_t step = 1; step <= kStepNum; ++step) {
+    // The graph of the last step is completed, so the ids which are not used by this step can be swapped out.
+    size_t graph_running_step = step;
+    hash_map.Reset();
+    const int *batch_ids = ids.data() + (step - 1) * kBatchSize;
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      if (frequency_sketch != nullptr) {
+        frequency_sketch->Increment(static_cast<uint64_t>(batch_ids[i]));
+      }
+      const auto &iter = hash_map.hash_id_to_index().find(batch_ids[i]);
+      if (iter != hash_map.hash_id_to_index().end()) {
+        hash_map.set_hash_step(iter->second, step);
+      }
+    }
+    size_t swap_out_size = 0;
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      if (hash_map.hash_id_to_index().count(batch_ids[i]) != 0) {
+        continue;
+      }
+      bool need_wait_graph = false;
+      int index = hash_map.ParseData(batch_ids[i], swap_out_index.data(), swap_out_ids.data(), step,
+                                     graph_running_step, &swap_out_size, &need_wait_graph);
+      EXPECT_NE(index, INVALID_INDEX_VALUE);
+      EXPECT_FALSE(need_wait_graph);
+    }
+    total_swap_out_size += swap_out_size;
+  }
+  return total_swap_out_size;
+}
+}  // namespace
+
+class TestEmbeddingHashMap : public UT::Common {
+ public:
+  TestEmbeddingHashMap() = default;
+  virtual ~TestEmbeddingHashMap() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+/// Feature: TinyLFU policy of the ps embedding cache.
+/// Description: Count the ids with the frequency sketch, and count many more ids to age the sketch.
+/// Expectation: The frequency is estimated without underestimation, and it is halved when the sketch is aged.
+TEST_F(TestEmbeddingHashMap, FrequencySketch) {
+  FrequencySketch sketch(kCacheCapacity);
+  constexpr int kHotId = 7;
+  constexpr uint8_t kHotCount = 12;
+  for (uint8_t i = 0; i < kHotCount; ++i) {
+    sketch.Increment(kHotId);
+  }
+  sketch.Increment(kHotId + 1);
+  EXPECT_EQ(sketch.Estimate(kHotId), kHotCount);
+  EXPECT_EQ(sketch.Estimate(kHotId + 1), 1);
+  EXPECT_EQ(sketch.Estimate(kHotId + 2), 0);
+
+  // Age the sketch by the cold ids.
+  size_t sample_size = FrequencySketch::kSampleFactor * sketch.width();
+  for (size_t i = 0; i < sample_size; ++i) {
+    sketch.Increment(kVocabSize + i);
+  }
+  EXPECT_LE(sketch.Estimate(kHotId), kHotCount / 2 + 1);
+  EXPECT_GE(sketch.Estimate(kHotId), kHotCount / 2 - 1);
+
+  sketch.Clear();
+  EXPECT_EQ(sketch.Estimate(kHotId), 0);
+}
+
+/// Feature: TinyLFU policy of the ps embedding cache.
+/// Description: Parse the skewed batches by the hash maps with the step and the TinyLFU eviction policies.
+/// Expectation: The hot ids are kept in the cache by the TinyLFU policy, so less ids are swapped out.
+TEST_F(TestEmbeddingHashMap, LfuEviction) {
+  std::vector<int> ids = ZipfIds(kBatchSize * kStepNum, 0);
+  size_t step_swap_out_size = RunBatches(ids, nullptr);
+  size_t lfu_swap_out_size = RunBatches(ids, std::make_shared<FrequencySketch>(kCacheCapacity));
+  EXPECT_GT(lfu_swap_out_size, 0);
+  EXPECT_LT(lfu_swap_out_size, step_swap_out_size);
+}
+
+/// Feature: TinyLFU policy of the ps embedding cache.
+/// Description: Fill the hash map in a step, and in the next step hit some sampled eviction candidates after the first
+/// id is parsed, then parse more ids.
+/// Expectation: The candidates which are hit are dropped, so only the ids which are not used by the step are swapped
+/// out, and no id waits for the graph.
+TEST_F(TestEmbeddingHashMap, HitEvictionCandidates) {
+  // The first and the last positions are reserved.
+  constexpr size_t kCapacity = 20;
+  constexpr int kFilledNum = 18;
+  constexpr int kHitBegin = 1;
+  constexpr int kHitEnd = 10;
+  constexpr int kNewIdBegin = 100;
+  EmbeddingHashMap hash_map(0, kCapacity);
+  hash_map.set_frequency_sketch(std::make_shared<FrequencySketch>(kCapacity));
+  std::vector<int> swap_out_index(kCapacity);
+  std::vector<int> swap_out_ids(kCapacity);
+  size_t swap_out_size = 0;
+  bool need_wait_graph = false;
+  hash_map.Reset();
+  for (int id = 0; id < kFilledNum; ++id) {
+    ASSERT_NE(hash_map.ParseData(id, swap_out_index.data(), swap_out_ids.data(), 1, 1, &swap_out_size,
+                                 &need_wait_graph),
+              INVALID_INDEX_VALUE);
+  }
+  ASSERT_EQ(swap_out_size, 0);
+
+  // The first new id samples the eviction candidates, some of which are hit by the step afterwards.
+  constexpr size_t kStep = 2;
+  hash_map.Reset();
+  ASSERT_NE(hash_map.ParseData(kNewIdBegin, swap_out_index.data(), swap_out_ids.data(), kStep, kStep, &swap_out_size,
+                               &need_wait_graph),
+            INVALID_INDEX_VALUE);
+  for (int id = kHitBegin; id < kHitEnd; ++id) {
+    hash_map.set_hash_step(hash_map.hash_id_to_index().at(id), kStep);
+  }
+  int new_id_num = kFilledNum - (kHitEnd - kHitBegin) - 1;
+  for (int id = kNewIdBegin + 1; id <= kNewIdBegin + new_id_num; ++id) {
+    ASSERT_NE(hash_map.ParseData(id, swap_out_index.data(), swap_out_ids.data(), kStep, kStep, &swap_out_size,
+                                 &need_wait_graph),
+              INVALID_INDEX_VALUE);
+    EXPECT_FALSE(need_wait_graph);
+  }
+  ASSERT_EQ(swap_out_size, IntToSize(new_id_num + 1));
+  for (size_t i = 0; i < swap_out_size; ++i) {
+    EXPECT_TRUE(swap_out_ids[i] < kHitBegin || swap_out_ids[i] >= kHitEnd) << "The hit id " << swap_out_ids[i]
+                                                                             << " is swapped out.";
+  }
+  for (int id = kHitBegin; id < kHitEnd; ++id) {
+    EXPECT_EQ(hash_map.hash_id_to_index().count(id), 1);
+  }
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,141 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <vector>
+
+#include "common/common_test.h"
+#include "ps/ps_cache/embedding_swap_plan.h"
+
+namespace mindspore {
+namespace ps {
+namespace {
+constexpr size_t kPlanNum = 4;
+constexpr size_t kBatchElements = 8;
+constexpr size_t kEmbeddingKey = 0;
+constexpr auto kBlockTimeout = std::chrono::milliseconds(100);
+
+// Submit the plan of the data step, which swaps the ids to the server and from the server.
+EmbeddingSwapPlanPtr SubmitPlan(EmbeddingSwapPlanQueue *queue, size_t data_step, const std::vector<int> &to_server_ids,
+                                const std::vector<int> &to_host_ids) {
+  auto swap_plan = queue->Acquire();
+  if (swap_plan == nullptr) {
+    return nullptr;
+  }
+  swap_plan->data_step_ = data_step;
+  std::copy(to_server_ids.begin(), to_server_ids.end(), swap_plan->host_.host_to_server_ids.get());
+  swap_plan->statistics_info_.host_to_server_size_ = to_server_ids.size();
+  std::copy(to_host_ids.begin(), to_host_ids.end(), swap_plan->host_.server_to_host_ids.get());
+  swap_plan->statistics_info_.server_to_host_size_ = to_host_ids.size();
+  queue->Submit(swap_plan);
+  return swap_plan;
+}
+
+// Prefetch the embeddings of the plan as the process data thread does.
+void Prefetch(const EmbeddingSwapPlanPtr &swap_plan) {
+  swap_plan->prefetched_embeddings_[kEmbeddingKey].assign(swap_plan->statistics_info_.server_to_host_size_, 1.0);
+  swap_plan->prefetched_ = true;
+}
+}  // namespace
+
+class TestEmbeddingSwapPlan : public UT::Common {
+ public:
+  TestEmbeddingSwapPlan() = default;
+};
+
+/// Feature: Swap plans of the ps embedding cache.
+/// Description: Submit the plans of all the free plans, acquire one more while they are swapped one by one, and wait
+/// for the graph steps.
+/// Expectation: The plans are swapped in the order of the data steps, the extra plan waits for a finished one, and the
+/// graph step waits until its data step is swapped.
+TEST_F(TestEmbeddingSwapPlan, Ordering) {
+  EmbeddingSwapPlanQueue queue(kPlanNum, kBatchElements);
+  for (size_t step = 1; step <= kPlanNum; ++step) {
+    ASSERT_NE(SubmitPlan(&queue, step, {}, {}), nullptr);
+  }
+  auto acquired = std::async(std::launch::async, [&queue] { return queue.Acquire(); });
+  EXPECT_EQ(acquired.wait_for(kBlockTimeout), std::future_status::timeout);
+  auto swapped = std::async(std::launch::async, [&queue] { return queue.WaitSwapped(2); });
+
+  auto swap_plan = queue.Front();
+  ASSERT_NE(swap_plan, nullptr);
+  EXPECT_EQ(swap_plan->data_step_, 1);
+  queue.Finish();
+  auto free_plan = acquired.get();
+  EXPECT_EQ(free_plan, swap_plan);
+  EXPECT_EQ(free_plan->data_step_, 0);
+  EXPECT_EQ(swapped.wait_for(kBlockTimeout), std::future_status::timeout);
+
+  ASSERT_NE(queue.Front(), nullptr);
+  EXPECT_EQ(queue.Front()->data_step_, 2);
+  queue.Finish();
+  EXPECT_TRUE(swapped.get());
+  EXPECT_EQ(queue.swapped_step(), 2);
+  EXPECT_EQ(queue.Front()->data_step_, 3);
+}
+
+/// Feature: Swap plans of the ps embedding cache.
+/// Description: Select the prefetch plans of the first plan, in which the prefetched plan of step 2 reads an id that
+/// the first plan swaps to the server, and the plan of step 3 reads an id that step 4 swaps to the server.
+/// Expectation: The stale prefetched embeddings of step 2 are invalidated so they are looked up again, the plans after
+/// it are not prefetched yet, and the plan of step 3 is prefetched once step 2 is being swapped.
+TEST_F(TestEmbeddingSwapPlan, Staleness) {
+  EmbeddingSwapPlanQueue queue(kPlanNum, kBatchElements);
+  auto first_plan = SubmitPlan(&queue, 1, {5}, {1});
+  auto stale_plan = SubmitPlan(&queue, 2, {}, {5, 6});
+  auto next_plan = SubmitPlan(&queue, 3, {}, {7});
+  ASSERT_NE(first_plan, nullptr);
+  ASSERT_NE(stale_plan, nullptr);
+  ASSERT_NE(next_plan, nullptr);
+  Prefetch(stale_plan);
+
+  EXPECT_TRUE(queue.SelectPrefetchPlans(*first_plan).empty());
+  EXPECT_FALSE(stale_plan->prefetched_);
+  EXPECT_TRUE(stale_plan->prefetched_embeddings_.empty());
+  queue.Finish();
+
+  // The id 7 of step 3 is swapped to the server by step 4 after step 3 reads it, so step 3 is prefetched.
+  auto last_plan = SubmitPlan(&queue, 4, {7}, {});
+  ASSERT_NE(last_plan, nullptr);
+  auto prefetch_plans = queue.SelectPrefetchPlans(*stale_plan);
+  ASSERT_EQ(prefetch_plans.size(), 1);
+  EXPECT_EQ(prefetch_plans[0], next_plan);
+}
+
+/// Feature: Swap plans of the ps embedding cache.
+/// Description: Stop the queue while a plan is acquired, the graph step is waited for and the next plan is waited
+/// for.
+/// Expectation: All the waits return without a plan or a swapped step, and no plan is acquired after the stop.
+TEST_F(TestEmbeddingSwapPlan, Shutdown) {
+  EmbeddingSwapPlanQueue queue(1, kBatchElements);
+  ASSERT_NE(SubmitPlan(&queue, 1, {}, {}), nullptr);
+  auto acquired = std::async(std::launch::async, [&queue] { return queue.Acquire(); });
+  auto swapped = std::async(std::launch::async, [&queue] { return queue.WaitSwapped(1); });
+  auto drained = std::async(std::launch::async, [&queue] { queue.WaitEmpty(); });
+  EXPECT_EQ(swapped.wait_for(kBlockTimeout), std::future_status::timeout);
+
+  queue.Stop();
+  EXPECT_EQ(acquired.get(), nullptr);
+  EXPECT_FALSE(swapped.get());
+  drained.get();
+  EXPECT_TRUE(queue.stopped());
+  EXPECT_EQ(queue.Front(), nullptr);
+  EXPECT_EQ(queue.Acquire(), nullptr);
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,271 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "common/common_test.h"
+#include "ps/gradient_compressor.h"
+
+namespace mindspore {
+namespace ps {
+namespace {
+constexpr size_t kGradSize = 4096;
+constexpr float kPushLearningRate = 0.1;
+constexpr float kMomentumValue = 0.9;
+constexpr size_t kTrainSteps = 200;
+
+std::vector<float> RandomVector(size_t size, uint32_t seed) {
+  std::mt19937 generator(seed);
+  std::normal_distribution<float> distribution(0, 1);
+  std::vector<float> values(size);
+  for (auto &value : values) {
+    value = distribution(generator);
+  }
+  return values;
+}
+
+float SquaredNorm(const std::vector<float> &values) {
+  float sum = 0;
+  for (auto value : values) {
+    sum += value * value;
+  }
+  return sum;
+}
+
+// Build the push message of the momentum optimizer, whose inputs are the lr, gradient and momentum.
+KVMessage BuildMomentumMessage(const std::vector<float> &grad) {
+  KVMessage message;
+  constexpr size_t kInputNum = 3;
+  for (size_t i = 0; i < kInputNum; ++i) {
+    message.add_keys(0);
+  }
+  message.add_values(kPushLearningRate);
+  for (auto value : grad) {
+    message.add_values(value);
+  }
+  message.add_values(kMomentumValue);
+  message.add_len(1);
+  message.add_len(grad.size());
+  message.add_len(1);
+  return message;
+}
+}  // namespace
+
+class TestGradientCompressor : public UT::Common {
+ public:
+  TestGradientCompressor() = default;
+  virtual ~TestGradientCompressor() = default;
+
+  void SetUp() override {}
+  void TearDown() override { (void)unsetenv(kEnvGradCompress); }
+};
+
+/// Feature: Gradient compression of the parameter server.
+/// Description: Compress the gradient of the push message with every compressor and decompress it.
+/// Expectation: The message is smaller on the wire, and the other inputs are kept after decompressed.
+TEST_F(TestGradientCompressor, CompressMessage) {
+  std::vector<float> grad = RandomVector(kGradSize, 0);
+  KVMessage raw_message = BuildMomentumMessage(grad);
+  for (auto type : {GradCompressType::kTopK, GradCompressType::kFp16, GradCompressType::kInt8,
+                    GradCompressType::kOneBit}) {
+    GradientCompressor compressor({type, kDefaultTopKRatio}, 0);
+    KVMessage message = raw_message;
+    ASSERT_TRUE(compressor.CompressMessage(1, true, &message));
+    EXPECT_EQ(message.values_size(), 2);
+    EXPECT_LT(message.ByteSizeLong(), raw_message.ByteSizeLong());
+
+    Values values;
+    ASSERT_TRUE(GradientCompressor::DecompressMessage(message, &values));
+    ASSERT_EQ(values.size(), kGradSize + 2);
+    EXPECT_EQ(values.front(), kPushLearningRate);
+    EXPECT_EQ(values.back(), kMomentumValue);
+  }
+
+  GradientCompressor compressor({GradCompressType::kNone, kDefaultTopKRatio}, 0);
+  KVMessage message = raw_message;
+  EXPECT_FALSE(compressor.CompressMessage(1, true, &message));
+  EXPECT_FALSE(message.has_compressed_grad());
+}
+
+/// Feature: Gradient compression of the parameter server.
+/// Description: Quantize the same gradient with the stochastic fp16 and int8 rounding many times.
+/// Expectation: The error of each element is bounded and the mean of the quantized values is unbiased.
+TEST_F(TestGradientCompressor, StochasticQuantization) {
+  constexpr size_t kSize = 256;
+  constexpr size_t kRepeatNum = 2000;
+  std::vector<float> grad = RandomVector(kSize, 1);
+  for (auto type : {GradCompressType::kFp16, GradCompressType::kInt8}) {
+    GradientCompressor compressor({type, kDefaultTopKRatio}, 1);
+    std::vector<double> sum(kSize, 0);
+    std::vector<float> output(kSize);
+    float max_error = 0;
+    for (size_t i = 0; i < kRepeatNum; ++i) {
+      CompressedGrad compressed;
+      compressor.Compress(grad.data(), kSize, false, &compressed);
+      ASSERT_TRUE(GradientCompressor::Decompress(compressed, output.data(), kSize));
+      for (size_t j = 0; j < kSize; ++j) {
+        sum[j] += output[j];
+        max_error = std::max(max_error, std::fabs(output[j] - grad[j]));
+      }
+    }
+    float max_bias = 0;
+    for (size_t j = 0; j < kSize; ++j) {
+      max_bias = std::max(max_bias, static_cast<float>(std::fabs(sum[j] / kRepeatNum - grad[j])));
+    }
+    // The error is less than one quantization step, and the bias is much less than it.
+    float step = type == GradCompressType::kFp16 ? 0.004 : 0.04;
+    EXPECT_LT(max_error, step);
+    EXPECT_LT(max_bias, step / 10);
+  }
+}
+
+/// Feature: Gradient compression of the parameter server.
+/// Description: Quantize the gradient in the subnormal range of the float16 with the stochastic fp16 rounding many
+/// times, whose values are below, between and above the subnormal steps.
+/// Expectation: The quantized values are on the subnormal grid, and the mean of them is unbiased.
+TEST_F(TestGradientCompressor, StochasticFp16Subnormal) {
+  constexpr size_t kRepeatNum = 20000;
+  constexpr float kSubnormalStep = 5.9604644775390625e-08;
+  const std::vector<float> grad = {1e-8, -2e-8, 3e-8, 5e-8, -7e-8, 1.3e-7, 2.5e-6, -4e-5, 6e-5};
+  GradientCompressor compressor({GradCompressType::kFp16, kDefaultTopKRatio}, 4);
+  std::vector<double> sum(grad.size(), 0);
+  std::vector<float> output(grad.size());
+  for (size_t i = 0; i < kRepeatNum; ++i) {
+    CompressedGrad compressed;
+    compressor.Compress(grad.data(), grad.size(), false, &compressed);
+    ASSERT_TRUE(GradientCompressor::Decompress(compressed, output.data(), grad.size()));
+    for (size_t j = 0; j < grad.size(); ++j) {
+      float steps = output[j] / kSubnormalStep;
+      ASSERT_EQ(steps, std::round(steps));
+      ASSERT_LT(std::fabs(output[j] - grad[j]), kSubnormalStep);
+      sum[j] += output[j];
+    }
+  }
+  // The standard error of the mean is less than the step / (2 * sqrt(kRepeatNum)), about 2e-10.
+  for (size_t j = 0; j < grad.size(); ++j) {
+    EXPECT_NEAR(sum[j] / kRepeatNum, grad[j], kSubnormalStep / 20) << "The mean of " << grad[j] << " is biased.";
+  }
+}
+
+/// Feature: Gradient compression of the parameter server.
+/// Description: Push the same gradient with the top-k and one-bit compressors many times.
+/// Expectation: The error is fed back, so the sum of the decompressed gradients follows the sum of the gradients.
+TEST_F(TestGradientCompressor, ErrorFeedback) {
+  constexpr size_t kPushNum = 500;
+  std::vector<float> grad = RandomVector(kGradSize, 2);
+  for (auto type : {GradCompressType::kTopK, GradCompressType::kOneBit}) {
+    for (bool error_feedback : {true, false}) {
+      GradientCompressor compressor({type, 0.1}, 2);
+      std::vector<float> sum(kGradSize, 0);
+      std::vector<float> output(kGradSize);
+      for (size_t i = 0; i < kPushNum; ++i) {
+        CompressedGrad compressed;
+        compressor.Compress(grad.data(), kGradSize, error_feedback, &compressed);
+        ASSERT_TRUE(GradientCompressor::Decompress(compressed, output.data(), kGradSize));
+        for (size_t j = 0; j < kGradSize; ++j) {
+          sum[j] += output[j];
+        }
+      }
+      std::vector<float> error(kGradSize);
+      for (size_t j = 0; j < kGradSize; ++j) {
+        error[j] = sum[j] - grad[j] * kPushNum;
+      }
+      float relative_error = std::sqrt(SquaredNorm(error) / SquaredNorm(grad)) / kPushNum;
+      if (error_feedback) {
+        EXPECT_LT(relative_error, 0.1);
+      } else {
+        EXPECT_GT(relative_error, 0.1);
+      }
+    }
+  }
+}
+
+/// Feature: Gradient compression of the parameter server.
+/// Description: Train a least squares model with SGD, whose gradients are compressed by every compressor.
+/// Expectation: The losses converge, and fewer bytes are sent than the raw gradients.
+TEST_F(TestGradientCompressor, Convergence) {
+  constexpr size_t kSize = 1024;
+  std::vector<float> target = RandomVector(kSize, 3);
+  float initial_loss = SquaredNorm(target) / 2;
+  for (auto type : {GradCompressType::kNone, GradCompressType::kTopK, GradCompressType::kFp16,
+                    GradCompressType::kInt8, GradCompressType::kOneBit}) {
+    GradientCompressor compressor({type, 0.1}, 3);
+    std::vector<float> weight(kSize, 0);
+    std::vector<float> grad(kSize);
+    std::vector<float> diff(kSize);
+    for (size_t step = 0; step < kTrainSteps; ++step) {
+      for (size_t i = 0; i < kSize; ++i) {
+        grad[i] = weight[i] - target[i];
+      }
+      if (type != GradCompressType::kNone) {
+        CompressedGrad compressed;
+        compressor.Compress(grad.data(), kSize, true, &compressed);
+        ASSERT_TRUE(GradientCompressor::Decompress(compressed, grad.data(), kSize));
+      }
+      for (size_t i = 0; i < kSize; ++i) {
+        weight[i] -= kPushLearningRate * grad[i];
+      }
+    }
+    for (size_t i = 0; i < kSize; ++i) {
+      diff[i] = weight[i] - target[i];
+    }
+    float loss = SquaredNorm(diff) / 2;
+    EXPECT_LT(loss, initial_loss / 100);
+    if (type != GradCompressType::kNone) {
+      EXPECT_LT(compressor.compressed_bytes(), compressor.raw_bytes());
+    }
+  }
+}
+
+/// Feature: Gradient compression of the parameter server.
+/// Description: Get the compression config of the parameters from the env.
+/// Expectation: The config of the parameter overrides the default one, and the invalid config is ignored.
+TEST_F(TestGradientCompressor, GetGradCompressConfig) {
+  (void)setenv(kEnvGradCompress, "int8;fc1.weight=topk:0.05;embedding=none;fc2.weight=topk:2", 1);
+  EXPECT_EQ(GetGradCompressConfig("fc0.weight").type, GradCompressType::kInt8);
+  EXPECT_EQ(GetGradCompressConfig("fc1.weight").type, GradCompressType::kTopK);
+  EXPECT_FLOAT_EQ(GetGradCompressConfig("fc1.weight").topk_ratio, 0.05);
+  EXPECT_EQ(GetGradCompressConfig("embedding").type, GradCompressType::kNone);
+  EXPECT_EQ(GetGradCompressConfig("fc2.weight").type, GradCompressType::kInt8);
+
+  (void)unsetenv(kEnvGradCompress);
+  EXPECT_EQ(GetGradCompressConfig("fc0.weight").type, GradCompressType::kNone);
+}
+
+/// Feature: Gradient compression of the parameter server.
+/// Description: Decompress the gradients whose data is truncated or whose indices are out of range.
+/// Expectation: The decompression fails.
+TEST_F(TestGradientCompressor, DecompressInvalidData) {
+  std::vector<float> grad = RandomVector(kGradSize, 4);
+  std::vector<float> output(kGradSize);
+  GradientCompressor compressor({GradCompressType::kInt8, kDefaultTopKRatio}, 4);
+  CompressedGrad compressed;
+  compressor.Compress(grad.data(), kGradSize, false, &compressed);
+  EXPECT_FALSE(GradientCompressor::Decompress(compressed, output.data(), kGradSize - 1));
+  compressed.mutable_data()->pop_back();
+  EXPECT_FALSE(GradientCompressor::Decompress(compressed, output.data(), kGradSize));
+
+  GradientCompressor topk_compressor({GradCompressType::kTopK, kDefaultTopKRatio}, 4);
+  topk_compressor.Compress(grad.data(), kGradSize, false, &compressed);
+  compressed.add_indices(kGradSize);
+  compressed.mutable_data()->append(sizeof(float), 0);
+  EXPECT_FALSE(GradientCompressor::Decompress(compressed, output.data(), kGradSize));
+}
+}  // namespace ps
+}  // namespace mindspore
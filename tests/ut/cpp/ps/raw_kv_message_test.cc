@@ -0,0 +1,115 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/common_test.h"
+#include "ps/raw_kv_message.h"
+
+namespace mindspore {
+namespace ps {
+namespace {
+constexpr size_t kValueNum = 1024;
+
+KVMessage BuildPushMessage() {
+  KVMessage message;
+  message.add_keys(0);
+  message.add_keys(1);
+  message.add_len(1);
+  message.add_len(kValueNum - 1);
+  for (size_t i = 0; i < kValueNum; ++i) {
+    message.add_values(static_cast<float>(i) / 2);
+  }
+  return message;
+}
+}  // namespace
+
+class TestRawKVMessage : public UT::Common {
+ public:
+  TestRawKVMessage() = default;
+  virtual ~TestRawKVMessage() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+/// Feature: Raw kv message of the parameter server.
+/// Description: Serialize the push message in the raw layout and parse it.
+/// Expectation: The parsed message refers to the keys, lengths and values in the buffer, which equal the sent ones.
+TEST_F(TestRawKVMessage, RoundTrip) {
+  KVMessage message = BuildPushMessage();
+  size_t size = RawKVSize(message.keys_size(), message.len_size(), message.values_size());
+  std::vector<uint64_t> buffer((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+  ASSERT_TRUE(SerializeRawKV(message, buffer.data(), size));
+  ASSERT_TRUE(IsRawKV(buffer.data(), size));
+
+  RawKVMessage raw_message;
+  ASSERT_TRUE(ParseRawKV(buffer.data(), size, &raw_message));
+  ASSERT_EQ(raw_message.key_num, 2);
+  ASSERT_EQ(raw_message.len_num, 2);
+  ASSERT_EQ(raw_message.value_num, kValueNum);
+  auto begin = reinterpret_cast<const uint8_t *>(buffer.data());
+  auto values = reinterpret_cast<const uint8_t *>(raw_message.values);
+  EXPECT_TRUE(values > begin && values < begin + size);
+  for (int i = 0; i < message.keys_size(); ++i) {
+    EXPECT_EQ(raw_message.keys[i], message.keys(i));
+    EXPECT_EQ(raw_message.lens[i], message.len(i));
+  }
+  ValuesView view(raw_message.values, raw_message.value_num);
+  ASSERT_EQ(view.size(), kValueNum);
+  for (size_t i = 0; i < kValueNum; ++i) {
+    EXPECT_EQ(view[i], message.values(i));
+  }
+
+  // The response of the pull refers to the weight, and has no lengths.
+  RawKVMessage pull_message;
+  pull_message.keys = raw_message.keys;
+  pull_message.key_num = 1;
+  pull_message.values = raw_message.values;
+  pull_message.value_num = raw_message.value_num;
+  size_t pull_size = RawKVSize(1, 0, kValueNum);
+  std::vector<uint64_t> pull_buffer((pull_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+  ASSERT_TRUE(SerializeRawKV(pull_message, pull_buffer.data(), pull_size));
+  RawKVMessage parsed_pull;
+  ASSERT_TRUE(ParseRawKV(pull_buffer.data(), pull_size, &parsed_pull));
+  EXPECT_EQ(parsed_pull.len_num, 0);
+  ASSERT_EQ(parsed_pull.value_num, kValueNum);
+  EXPECT_EQ(parsed_pull.values[kValueNum - 1], message.values(kValueNum - 1));
+}
+
+/// Feature: Raw kv message of the parameter server.
+/// Description: Parse the protobuf message, the truncated raw message, and serialize into the buffer of wrong size.
+/// Expectation: The protobuf message is not taken as the raw one, and the wrong sizes are rejected.
+TEST_F(TestRawKVMessage, RejectMismatch) {
+  KVMessage message = BuildPushMessage();
+  std::string proto_data = message.SerializeAsString();
+  std::vector<uint64_t> proto_buffer((proto_data.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+  (void)std::copy(proto_data.begin(), proto_data.end(), reinterpret_cast<char *>(proto_buffer.data()));
+  EXPECT_FALSE(IsRawKV(proto_buffer.data(), proto_data.size()));
+  RawKVMessage raw_message;
+  EXPECT_FALSE(ParseRawKV(proto_buffer.data(), proto_data.size(), &raw_message));
+
+  size_t size = RawKVSize(message.keys_size(), message.len_size(), message.values_size());
+  std::vector<uint64_t> buffer((size + sizeof(uint64_t) - 1) / sizeof(uint64_t) + 1);
+  EXPECT_FALSE(SerializeRawKV(message, buffer.data(), size + sizeof(float)));
+  ASSERT_TRUE(SerializeRawKV(message, buffer.data(), size));
+  EXPECT_FALSE(ParseRawKV(buffer.data(), size - sizeof(float), &raw_message));
+  EXPECT_FALSE(ParseRawKV(buffer.data(), sizeof(RawKVHeader) - 1, &raw_message));
+}
+}  // namespace ps
+}  // namespace mindspore
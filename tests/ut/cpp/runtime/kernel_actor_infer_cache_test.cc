@@ -0,0 +1,146 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "base/core_ops.h"
+#include "backend/session/kernel_graph.h"
+#include "backend/session/anf_runtime_algorithm.h"
+#define private public
+#include "runtime/framework/actor/kernel_actor.h"
+#undef private
+
+namespace mindspore {
+namespace runtime {
+namespace {
+// The device context infers the output shape as the input shape, and counts the infers, resizes and kernel creations.
+class TestDeviceContext : public DeviceContext {
+ public:
+  TestDeviceContext() : DeviceContext(device::DeviceContextKey{"CPU", 0}) {}
+  ~TestDeviceContext() override = default;
+
+  void Initialize() override {}
+  bool AllocateMemory(device::DeviceAddress *const &address, size_t size) const override { return true; }
+  void FreeMemory(device::DeviceAddress *const &address) const override {}
+  device::DeviceAddressPtr CreateDeviceAddress(void *const device_ptr, size_t device_size, const string &format,
+                                               TypeId type_id) const override {
+    return nullptr;
+  }
+  device::DeviceAddressType GetDeviceAddressType() const override { return device::DeviceAddressType::kCPU; }
+  void SetOperatorInfo(const std::vector<CNodePtr> &nodes) const override {}
+  void CreateKernel(const std::vector<CNodePtr> &nodes) const override { ++create_num_; }
+  void UpdateDynamicShape(const CNodePtr &kernel) const override {
+    ++infer_num_;
+    kernel->set_abstract(kernel->input(1)->abstract()->Clone());
+  }
+  void ResizeKernel(const CNodePtr &kernel) const override { ++resize_num_; }
+
+  mutable size_t create_num_{0};
+  mutable size_t infer_num_{0};
+  mutable size_t resize_num_{0};
+};
+}  // namespace
+
+class KernelActorInferCacheTest : public UT::Common {
+ public:
+  KernelActorInferCacheTest() = default;
+  void SetUp() override {
+    auto kernel_graph = std::make_shared<session::KernelGraph>();
+    parameter_ = kernel_graph->add_parameter();
+    kernel_ = kernel_graph->NewCNode({NewValueNode(prim::kPrimRelu), parameter_});
+    actor_ = std::make_unique<KernelActor>("kernel_actor", kernel_, &device_context_, AID(), nullptr, nullptr,
+                                           GraphExecutionStrategy::kPipeline);
+    actor_->is_dynamic_shape_ = true;
+    actor_->is_infer_cacheable_ = true;
+    actor_->real_input_num_ = 1;
+  }
+
+ protected:
+  // Infer and resize the kernel by the input shape as the kernel actor runs, then insert the infer result into the
+  // cache as it is after the launch.
+  void Run(int64_t input_len) {
+    parameter_->set_abstract(std::make_shared<abstract::AbstractTensor>(kFloat32, ShapeVector{input_len, 3}));
+    actor_->InferShapeAndResize();
+    EXPECT_EQ(AnfAlgo::GetOutputInferShape(kernel_, 0), std::vector<size_t>({static_cast<size_t>(input_len), 3}));
+    if (!actor_->is_infer_cache_hit_) {
+      actor_->InsertInferCache();
+    }
+  }
+
+  TestDeviceContext device_context_;
+  ParameterPtr parameter_;
+  CNodePtr kernel_;
+  std::unique_ptr<KernelActor> actor_;
+};
+
+/// Feature: Infer cache of the dynamic shape kernel actor.
+/// Description: Run the kernel with the input shapes which have been run before.
+/// Expectation: The cached output shapes are restored without infer, and the kernel is resized only when the input
+/// shapes are changed since the last run.
+TEST_F(KernelActorInferCacheTest, TestHit) {
+  Run(2);
+  Run(4);
+  EXPECT_EQ(device_context_.infer_num_, 2);
+  Run(2);
+  EXPECT_EQ(device_context_.resize_num_, 1);
+  Run(2);
+  EXPECT_EQ(device_context_.resize_num_, 1);
+  Run(4);
+  EXPECT_EQ(device_context_.resize_num_, 2);
+  EXPECT_EQ(device_context_.infer_num_, 2);
+  EXPECT_EQ(device_context_.create_num_, 0);
+  EXPECT_EQ(actor_->infer_cache_hit_count_, 3);
+  EXPECT_EQ(actor_->infer_cache_miss_count_, 2);
+  EXPECT_EQ(actor_->infer_cache_.size(), 2);
+}
+
+/// Feature: Infer cache of the dynamic shape kernel actor.
+/// Description: Run the kernel with the new input shapes.
+/// Expectation: Every new input shape is inferred and resized in place, no kernel is created.
+TEST_F(KernelActorInferCacheTest, TestMiss) {
+  constexpr int64_t kShapeNum = 5;
+  for (int64_t i = 1; i <= kShapeNum; ++i) {
+    Run(i);
+  }
+  EXPECT_EQ(device_context_.infer_num_, kShapeNum);
+  EXPECT_EQ(device_context_.resize_num_, 0);
+  EXPECT_EQ(device_context_.create_num_, 0);
+  EXPECT_EQ(actor_->infer_cache_hit_count_, 0);
+  EXPECT_EQ(actor_->infer_cache_miss_count_, kShapeNum);
+  EXPECT_EQ(actor_->infer_cache_.size(), kShapeNum);
+}
+
+/// Feature: Infer cache of the dynamic shape kernel actor.
+/// Description: The launch changes the output shapes, as the operator 'Unique' does.
+/// Expectation: The cache is disabled, and the kernel is inferred in every run.
+TEST_F(KernelActorInferCacheTest, TestDisabled) {
+  parameter_->set_abstract(std::make_shared<abstract::AbstractTensor>(kFloat32, ShapeVector{2, 3}));
+  actor_->InferShapeAndResize();
+  kernel_->set_abstract(std::make_shared<abstract::AbstractTensor>(kFloat32, ShapeVector{1, 3}));
+  actor_->InsertInferCache();
+  EXPECT_FALSE(actor_->is_infer_cacheable_);
+  EXPECT_TRUE(actor_->infer_cache_.empty());
+
+  Run(2);
+  Run(2);
+  EXPECT_EQ(device_context_.infer_num_, 3);
+  EXPECT_EQ(actor_->infer_cache_hit_count_, 0);
+  EXPECT_TRUE(actor_->infer_cache_.empty());
+}
+}  // namespace runtime
+}  // namespace mindspore
@@ -0,0 +1,121 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+#include <vector>
+#include "common/common_test.h"
+#include "runtime/framework/actor/linear_executor.h"
+
+namespace mindspore {
+namespace runtime {
+using MemoryBlock = LinearExecutor::MemoryBlock;
+
+class LinearExecutorTest : public UT::Common {
+ public:
+  LinearExecutorTest() = default;
+};
+
+namespace {
+std::vector<MemoryBlock *> ToPointers(std::vector<MemoryBlock> *blocks) {
+  std::vector<MemoryBlock *> pointers;
+  for (auto &block : *blocks) {
+    pointers.push_back(&block);
+  }
+  return pointers;
+}
+
+// The blocks alive at the same time must not overlap in the arena, and must be inside the arena.
+bool IsValidPlacement(const std::vector<MemoryBlock> &blocks, size_t arena_size) {
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    if (blocks[i].offset_ + blocks[i].size_ > arena_size) {
+      return false;
+    }
+    for (size_t j = i + 1; j < blocks.size(); ++j) {
+      bool live_overlapped = (blocks[i].birth_ <= blocks[j].death_) && (blocks[j].birth_ <= blocks[i].death_);
+      bool memory_overlapped = (blocks[i].offset_ < blocks[j].offset_ + blocks[j].size_) &&
+                               (blocks[j].offset_ < blocks[i].offset_ + blocks[i].size_);
+      if (live_overlapped && memory_overlapped) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}  // namespace
+
+/// Feature: Memory plan of the linear execution.
+/// Description: Place a chain of blocks in which each block dies when the next but one is born.
+/// Expectation: The blocks whose lifetimes don't overlap reuse the memory, so the arena holds two blocks only.
+TEST_F(LinearExecutorTest, TestAssignOffsetsReuse) {
+  // Instruction i produces block i and consumes block i - 1.
+  std::vector<MemoryBlock> blocks(4);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    blocks[i].birth_ = i;
+    blocks[i].death_ = i + 1;
+    blocks[i].size_ = 512;
+  }
+  auto pointers = ToPointers(&blocks);
+  auto arena_size = LinearExecutor::AssignOffsets(&pointers);
+  EXPECT_EQ(arena_size, 1024);
+  EXPECT_TRUE(IsValidPlacement(blocks, arena_size));
+  EXPECT_EQ(blocks[0].offset_, blocks[2].offset_);
+  EXPECT_EQ(blocks[1].offset_, blocks[3].offset_);
+  EXPECT_NE(blocks[0].offset_, blocks[1].offset_);
+}
+
+/// Feature: Memory plan of the linear execution.
+/// Description: Place a small block which is alive while two large blocks are alive one after another.
+/// Expectation: The large blocks share the memory, and the small one is placed after them.
+TEST_F(LinearExecutorTest, TestAssignOffsetsBySize) {
+  std::vector<MemoryBlock> blocks(3);
+  blocks[0] = {0, 1, 1024, 0};
+  blocks[1] = {2, 3, 1024, 0};
+  blocks[2] = {0, 3, 512, 0};
+  auto pointers = ToPointers(&blocks);
+  auto arena_size = LinearExecutor::AssignOffsets(&pointers);
+  EXPECT_EQ(arena_size, 1536);
+  EXPECT_EQ(blocks[0].offset_, 0);
+  EXPECT_EQ(blocks[1].offset_, 0);
+  EXPECT_EQ(blocks[2].offset_, 1024);
+  std::vector<MemoryBlock *> empty;
+  EXPECT_EQ(LinearExecutor::AssignOffsets(&empty), 0);
+}
+
+/// Feature: Memory plan of the linear execution.
+/// Description: Place many blocks of random lifetimes and sizes.
+/// Expectation: No blocks alive at the same time overlap, and the arena is no larger than the sum of the sizes.
+TEST_F(LinearExecutorTest, TestAssignOffsetsRandom) {
+  constexpr size_t kBlockNum = 200;
+  constexpr size_t kInstructionNum = 50;
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<size_t> birth_dist(0, kInstructionNum - 1);
+  std::uniform_int_distribution<size_t> life_dist(0, 5);
+  std::uniform_int_distribution<size_t> size_dist(1, 16);
+  std::vector<MemoryBlock> blocks(kBlockNum);
+  size_t total_size = 0;
+  for (auto &block : blocks) {
+    block.birth_ = birth_dist(rng);
+    block.death_ = block.birth_ + life_dist(rng);
+    block.size_ = size_dist(rng) * 512;
+    total_size += block.size_;
+  }
+  auto pointers = ToPointers(&blocks);
+  auto arena_size = LinearExecutor::AssignOffsets(&pointers);
+  EXPECT_TRUE(IsValidPlacement(blocks, arena_size));
+  EXPECT_LT(arena_size, total_size);
+}
+}  // namespace runtime
+}  // namespace mindspore
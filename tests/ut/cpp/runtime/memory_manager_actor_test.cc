@@ -0,0 +1,171 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "base/core_ops.h"
+#include "backend/session/kernel_graph.h"
+#include "runtime/device/cpu/cpu_device_address.h"
+#include "runtime/framework/actor/memory_manager_actor.h"
+#define private public
+#include "runtime/framework/actor/kernel_actor.h"
+#undef private
+
+namespace mindspore {
+namespace runtime {
+namespace {
+constexpr size_t kThreadNum = 4;
+constexpr size_t kRoundNum = 100;
+constexpr size_t kTensorSize = 16;
+
+// The device context fails all the memory allocations, and counts the memory frees.
+class TestDeviceContext : public DeviceContext {
+ public:
+  TestDeviceContext() : DeviceContext(device::DeviceContextKey{"CPU", 0}) {}
+  ~TestDeviceContext() override = default;
+
+  void Initialize() override {}
+  bool AllocateMemory(device::DeviceAddress *const &address, size_t size) const override { return false; }
+  void FreeMemory(device::DeviceAddress *const &address) const override { ++free_num_; }
+  device::DeviceAddressPtr CreateDeviceAddress(void *const device_ptr, size_t device_size, const string &format,
+                                               TypeId type_id) const override {
+    return nullptr;
+  }
+  device::DeviceAddressType GetDeviceAddressType() const override { return device::DeviceAddressType::kCPU; }
+  void SetOperatorInfo(const std::vector<CNodePtr> &nodes) const override {}
+  void CreateKernel(const std::vector<CNodePtr> &nodes) const override {}
+
+  mutable std::atomic<size_t> free_num_{0};
+};
+}  // namespace
+
+class MemoryManagerActorTest : public UT::Common {
+ public:
+  MemoryManagerActorTest() = default;
+  void SetUp() override {
+    results_.resize(1);
+    op_context_.results_ = &results_;
+  }
+
+ protected:
+  std::string AllocFailMessage(const std::string &kernel_name) {
+    return "Memory isn't enough and alloc failed, kernel name: " + kernel_name +
+           ", alloc size: " + std::to_string(kTensorSize) + "B.";
+  }
+
+  TestDeviceContext device_context_;
+  std::vector<Promise<int>> results_;
+  OpContext<DeviceTensor> op_context_;
+};
+
+/// Feature: Reference count of the device tensor shared by the concurrent actors.
+/// Description: The consumers of the device tensor decrease the reference count in threads for several rounds.
+/// Expectation: Exactly one consumer decreases the count to zero and frees the memory in every round, and the count is
+/// reset to the original count.
+TEST_F(MemoryManagerActorTest, TestConcurrentDecreaseRefCount) {
+  char data[kTensorSize];
+  device::cpu::CPUDeviceAddress device_tensor(data, kTensorSize);
+  device_tensor.set_original_ref_count(kThreadNum);
+  device_tensor.ResetRefCount();
+  for (size_t round = 0; round < kRoundNum; ++round) {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < kThreadNum; ++i) {
+      threads.emplace_back([this, &device_tensor]() { FreeMemoryByRefCount(&device_tensor, &device_context_, ""); });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    ASSERT_EQ(device_context_.free_num_.load(), round + 1);
+    ASSERT_EQ(device_tensor.ref_count(), kThreadNum);
+  }
+
+  // The decreased counts returned to the consumers are distinct, so only one of them sees zero.
+  std::atomic<size_t> zero_num(0);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadNum; ++i) {
+    threads.emplace_back([&device_tensor, &zero_num]() {
+      if (device_tensor.DecreaseRefCount() == 0) {
+        ++zero_num;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(zero_num.load(), 1);
+}
+
+/// Feature: Memory allocation failure of the actors which allocate memory by themselves.
+/// Description: Several actors fail to allocate memory in the same step concurrently, then another actor fails in the
+/// same step, and an actor fails in the next step.
+/// Expectation: Only the first failure of the step sets the op context failed, and the next step is set again.
+TEST_F(MemoryManagerActorTest, TestConcurrentAllocFail) {
+  constexpr int kStep = 1;
+  op_context_.sequential_num_ = kStep;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadNum; ++i) {
+    threads.emplace_back([this, i]() {
+      SetOpContextMemoryAllocFail("kernel" + std::to_string(i), &device_context_, kTensorSize, &op_context_);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(results_[0].GetFuture().IsError());
+  auto error_info = op_context_.error_info_;
+  size_t match_num = 0;
+  for (size_t i = 0; i < kThreadNum; ++i) {
+    match_num += (error_info == AllocFailMessage("kernel" + std::to_string(i))) ? 1 : 0;
+  }
+  EXPECT_EQ(match_num, 1);
+
+  SetOpContextMemoryAllocFail("other_kernel", &device_context_, kTensorSize, &op_context_);
+  EXPECT_EQ(op_context_.error_info_, error_info);
+
+  op_context_.sequential_num_ = kStep + 1;
+  SetOpContextMemoryAllocFail("next_step_kernel", &device_context_, kTensorSize, &op_context_);
+  EXPECT_EQ(op_context_.error_info_, AllocFailMessage("next_step_kernel"));
+}
+
+/// Feature: Memory allocation failure of the actors which allocate memory by themselves.
+/// Description: The kernel actor allocates memory in the actor running, and the memory manager actor allocates memory
+/// for another actor, both of them fail in the same step.
+/// Expectation: The kernel actor sets the op context failed, and the memory manager actor doesn't set it again.
+TEST_F(MemoryManagerActorTest, TestKernelActorAllocFail) {
+  constexpr int kStep = 10;
+  op_context_.sequential_num_ = kStep;
+  auto kernel_graph = std::make_shared<session::KernelGraph>();
+  auto kernel = kernel_graph->NewCNode({NewValueNode(prim::kPrimRelu), kernel_graph->add_parameter()});
+  KernelActor actor("kernel_actor", kernel, &device_context_, AID(), nullptr, nullptr,
+                    GraphExecutionStrategy::kPipeline);
+  device::cpu::CPUDeviceAddress device_tensor(nullptr, kTensorSize);
+  actor.is_memory_allocation_sync_ = true;
+  actor.memory_alloc_list_ = {&device_tensor};
+  actor.SendMemoryAllocReq(&op_context_);
+  EXPECT_TRUE(results_[0].GetFuture().IsError());
+  EXPECT_EQ(op_context_.error_info_, AllocFailMessage("kernel_actor"));
+
+  MemoryManagerActor memory_manager_actor;
+  std::vector<DeviceTensor *> alloc_list = {&device_tensor};
+  memory_manager_actor.AllocateMemory(&alloc_list, &device_context_, &op_context_, AID("other_actor"));
+  EXPECT_EQ(op_context_.error_info_, AllocFailMessage("kernel_actor"));
+}
+}  // namespace runtime
+}  // namespace mindspore
@@ -0,0 +1,155 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "frontend/operator/ops.h"
+#include "runtime/device/cpu/cpu_device_address.h"
+#include "runtime/op_builder/op_trace.h"
+#include "utils/utils.h"
+
+namespace mindspore {
+namespace runtime {
+namespace {
+constexpr size_t kMaxOpTraceNum = 2;
+constexpr size_t kOpTraceReplayThreshold = 2;
+const std::vector<int64_t> kShape = {2, 3};
+
+// The single op graph of the unary op, whose output device tensor is the one the op cache keeps until the graph runs.
+KernelGraphPtr BuildSingleOpGraph(const PrimitivePtr &prim) {
+  auto graph = std::make_shared<session::KernelGraph>();
+  auto abstract = std::make_shared<abstract::AbstractTensor>(kFloat32, kShape);
+  auto param = graph->add_parameter();
+  param->set_abstract(abstract);
+  auto kernel = graph->NewCNode({NewValueNode(prim), param});
+  kernel->set_abstract(abstract);
+  graph->set_execution_order({kernel});
+  auto device_tensor = std::make_shared<device::cpu::CPUDeviceAddress>(nullptr, 0, kOpFormat_DEFAULT,
+                                                                       kNumberTypeFloat32);
+  AnfAlgo::SetOutputAddr(device_tensor, 0, kernel.get());
+  return graph;
+}
+
+// The op of the graph runs on the input tensor, and its output tensor holds the output device tensor of the graph as
+// RunOpInternal returns it.
+std::shared_ptr<OpTask> BuildOpRunTask(const KernelGraphPtr &graph, const tensor::TensorPtr &input,
+                                       tensor::TensorPtr *output) {
+  const auto &kernel = graph->execution_order().front();
+  session::OpRunInfo op_run_info;
+  op_run_info.op_name = AnfAlgo::GetCNodeName(kernel);
+  op_run_info.graph_info = op_run_info.op_name + "_2_3_float32";
+  op_run_info.input_tensors = {input};
+  op_run_info.tensor_mask = {kParameterDataTensorMask};
+  std::vector<session::KernelWithIndex> output_nodes = {{kernel, 0}};
+  auto context = std::make_shared<OpLazyBuilderContext>(nullptr, graph, output_nodes, op_run_info, nullptr, false);
+  *output = std::make_shared<tensor::Tensor>(kNumberTypeFloat32, kShape);
+  (*output)->set_device_address(AnfAlgo::GetMutableOutputAddr(kernel, 0, false));
+  return std::make_shared<OpRunTask>(context);
+}
+
+// The queue of Relu(x) -> Sigmoid, as it is flushed at the end of the cell construct.
+std::queue<std::shared_ptr<OpTask>> BuildOpRunTasks(const KernelGraphPtr &relu_graph,
+                                                    const KernelGraphPtr &sigmoid_graph,
+                                                    const tensor::TensorPtr &input) {
+  std::queue<std::shared_ptr<OpTask>> op_run_tasks;
+  tensor::TensorPtr relu_output;
+  tensor::TensorPtr sigmoid_output;
+  op_run_tasks.push(BuildOpRunTask(relu_graph, input, &relu_output));
+  op_run_tasks.push(BuildOpRunTask(sigmoid_graph, relu_output, &sigmoid_output));
+  return op_run_tasks;
+}
+}  // namespace
+
+class OpTraceTest : public UT::Common {
+ public:
+  OpTraceTest() = default;
+};
+
+/// Feature: Op trace replay in PyNative mode.
+/// Description: Capture the same trace in two steps, in which the single op graphs are fetched from the op cache, as
+/// the ops of the non-first iteration are queued with the op trace enabled.
+/// Expectation: The traces of the two steps have the same key, and the trace is replayed from the second capture.
+TEST_F(OpTraceTest, TestReplayCachedGraphs) {
+  auto relu_graph = BuildSingleOpGraph(prim::kPrimRelu);
+  auto sigmoid_graph = BuildSingleOpGraph(prim::kPrimSigmoid);
+  OpTraceCache cache(kMaxOpTraceNum, kOpTraceReplayThreshold);
+
+  OpTrace first_trace;
+  auto input = std::make_shared<tensor::Tensor>(kNumberTypeFloat32, kShape);
+  ASSERT_TRUE(CaptureOpTrace(BuildOpRunTasks(relu_graph, sigmoid_graph, input), &first_trace));
+  EXPECT_EQ(first_trace.contexts_.size(), 2);
+  EXPECT_EQ(first_trace.input_tensors_.size(), 1);
+  ASSERT_EQ(first_trace.op_inputs_.size(), 2);
+  EXPECT_EQ(first_trace.op_inputs_[1].front().op_index, 0);
+  EXPECT_EQ(cache.Capture(first_trace.key_), nullptr);
+
+  // The ops of the next step run on another input, and the output device tensors of the graphs are renewed.
+  for (const auto &graph : {relu_graph, sigmoid_graph}) {
+    auto device_tensor = std::make_shared<device::cpu::CPUDeviceAddress>(nullptr, 0, kOpFormat_DEFAULT,
+                                                                         kNumberTypeFloat32);
+    AnfAlgo::SetOutputAddr(device_tensor, 0, graph->execution_order().front().get());
+  }
+  OpTrace second_trace;
+  input = std::make_shared<tensor::Tensor>(kNumberTypeFloat32, kShape);
+  ASSERT_TRUE(CaptureOpTrace(BuildOpRunTasks(relu_graph, sigmoid_graph, input), &second_trace));
+  EXPECT_EQ(second_trace.key_, first_trace.key_);
+  auto trace_graph = cache.Capture(second_trace.key_);
+  ASSERT_NE(trace_graph, nullptr);
+  EXPECT_EQ(trace_graph->capture_count_, 2);
+  EXPECT_EQ(cache.Capture(second_trace.key_), trace_graph);
+  EXPECT_EQ(cache.size(), 1);
+}
+
+/// Feature: Op trace replay in PyNative mode.
+/// Description: Capture a trace in which the same single op graph in the op cache runs twice.
+/// Expectation: The trace is not captured, since the ops share the output device tensors of the graph.
+TEST_F(OpTraceTest, TestRepeatedGraph) {
+  auto relu_graph = BuildSingleOpGraph(prim::kPrimRelu);
+  OpTrace trace;
+  auto input = std::make_shared<tensor::Tensor>(kNumberTypeFloat32, kShape);
+  EXPECT_FALSE(CaptureOpTrace(BuildOpRunTasks(relu_graph, relu_graph, input), &trace));
+
+  std::queue<std::shared_ptr<OpTask>> op_run_tasks;
+  tensor::TensorPtr output;
+  op_run_tasks.push(BuildOpRunTask(relu_graph, input, &output));
+  EXPECT_FALSE(CaptureOpTrace(op_run_tasks, &trace));
+}
+
+/// Feature: Op trace replay in PyNative mode.
+/// Description: Capture more distinct traces than the limit, and a trace whose merged graph is not replayable.
+/// Expectation: The traces beyond the limit are never replayed, nor is the trace which is not replayable.
+TEST_F(OpTraceTest, TestDivergedTraces) {
+  OpTraceCache cache(kMaxOpTraceNum, kOpTraceReplayThreshold);
+  EXPECT_EQ(cache.Capture("a"), nullptr);
+  EXPECT_EQ(cache.Capture("b"), nullptr);
+  EXPECT_EQ(cache.Capture("c"), nullptr);
+  EXPECT_EQ(cache.Capture("c"), nullptr);
+  EXPECT_EQ(cache.size(), kMaxOpTraceNum);
+
+  auto trace_graph = cache.Capture("a");
+  ASSERT_NE(trace_graph, nullptr);
+  trace_graph->is_replayable_ = false;
+  EXPECT_EQ(cache.Capture("a"), nullptr);
+  EXPECT_NE(cache.Capture("b"), nullptr);
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.Capture("c"), nullptr);
+}
+}  // namespace runtime
+}  // namespace mindspore
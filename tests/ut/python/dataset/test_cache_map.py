@@ -15,6 +15,7 @@
 """
 Testing cache operator with mappable datasets
 """
+import copy
 import os
 import pytest
 import numpy as np
@@ -769,6 +770,22 @@ def test_cache_map_parameter_check():
         ds.DatasetCache(session_id=1, size=0, port=65536)
     assert "Input port is not within the required interval of [1025, 65535]" in str(err.value)
 
+    with pytest.raises(TypeError) as info:
+        ds.DatasetCache(session_id=1, size=0, tier_policy=1)
+    assert "Argument tier_policy with value 1 is not of type" in str(info.value)
+
+    with pytest.raises(ValueError) as info:
+        ds.DatasetCache(session_id=1, size=0, tier_policy="fifo")
+    assert "Input tier_policy is not within the valid set" in str(info.value)
+
+    with pytest.raises(TypeError) as info:
+        ds.DatasetCache(session_id=1, size=0, compression=True)
+    assert "Argument compression with value True is not of type" in str(info.value)
+
+    with pytest.raises(ValueError) as info:
+        ds.DatasetCache(session_id=1, size=0, compression="zstd")
+    assert "Input compression is not within the valid set" in str(info.value)
+
     with pytest.raises(TypeError) as err:
         ds.ImageFolderDataset(dataset_dir=DATA_DIR, cache=True)
     assert "Argument cache with value True is not of type" in str(err.value)
@@ -893,6 +910,94 @@ def test_cache_map_extra_small_size1():
     logger.info("test_cache_map_extra_small_size1 Ended.\n")
 
 
+@pytest.mark.skipif(os.environ.get('RUN_CACHE_TEST') != 'TRUE', reason="Require to bring up cache server")
+def test_cache_map_tier_policy():
+    """
+    Test running pipeline with cache of extra small size, spilling true and each tier policy
+
+       Repeat
+         |
+     Map(decode)
+         |
+       Cache
+         |
+     ImageFolder
+    """
+
+    logger.info("Test cache map tier policy")
+    if "SESSION_ID" in os.environ:
+        session_id = int(os.environ['SESSION_ID'])
+    else:
+        raise RuntimeError("Testcase requires SESSION_ID environment variable")
+
+    for tier_policy in ["lru", "lfu", "tinylfu"]:
+        some_cache = ds.DatasetCache(session_id=session_id, size=1, spilling=True, tier_policy=tier_policy)
+        assert copy.deepcopy(some_cache).tier_policy == tier_policy
+
+        # This DATA_DIR only has 2 images in it
+        ds1 = ds.ImageFolderDataset(dataset_dir=DATA_DIR, cache=some_cache)
+        decode_op = c_vision.Decode()
+        ds1 = ds1.map(input_columns=["image"], operations=decode_op)
+        ds1 = ds1.repeat(4)
+
+        num_iter = 0
+        for _ in ds1.create_dict_iterator(num_epochs=1):
+            num_iter += 1
+
+        logger.info("Number of data in ds1: {} ".format(num_iter))
+        assert num_iter == 8
+        cache_stat = some_cache.get_stat()
+        assert cache_stat.num_mem_cached + cache_stat.num_disk_cached == 2
+    logger.info("test_cache_map_tier_policy Ended.\n")
+
+
+@pytest.mark.skipif(os.environ.get('RUN_CACHE_TEST') != 'TRUE', reason="Require to bring up cache server")
+def test_cache_map_compression():
+    """
+    Test running pipeline with the rows compressed by the cache server
+
+       Repeat
+         |
+       Cache
+         |
+     Map(decode)
+         |
+     ImageFolder
+    """
+
+    logger.info("Test cache map compression")
+    if "SESSION_ID" in os.environ:
+        session_id = int(os.environ['SESSION_ID'])
+    else:
+        raise RuntimeError("Testcase requires SESSION_ID environment variable")
+
+    some_cache = ds.DatasetCache(session_id=session_id, size=0, compression="deflate")
+    assert copy.deepcopy(some_cache).compression == "deflate"
+
+    # This DATA_DIR only has 2 images in it
+    ds1 = ds.ImageFolderDataset(dataset_dir=DATA_DIR)
+    decode_op = c_vision.Decode()
+    ds1 = ds1.map(input_columns=["image"], operations=decode_op, cache=some_cache)
+    ds1 = ds1.repeat(4)
+    # The decoded images are compressed, and decompressed by the client as is.
+    ds2 = ds.ImageFolderDataset(dataset_dir=DATA_DIR, shuffle=False)
+    ds2 = ds2.map(input_columns=["image"], operations=decode_op)
+    expected = sorted(item["image"].tobytes() for item in ds2.create_dict_iterator(num_epochs=1, output_numpy=True))
+
+    num_iter = 0
+    images = []
+    for item in ds1.create_dict_iterator(num_epochs=1, output_numpy=True):
+        images.append(item["image"].tobytes())
+        num_iter += 1
+
+    logger.info("Number of data in ds1: {} ".format(num_iter))
+    assert num_iter == 8
+    assert sorted(images) == sorted(expected * 4)
+    cache_stat = some_cache.get_stat()
+    assert cache_stat.num_stored_bytes < cache_stat.num_raw_bytes
+    logger.info("test_cache_map_compression Ended.\n")
+
+
 @pytest.mark.skipif(os.environ.get('RUN_CACHE_TEST') != 'TRUE', reason="Require to bring up cache server")
 def test_cache_map_extra_small_size2():
     """
@@ -2321,6 +2426,8 @@ if __name__ == '__main__':
     test_cache_map_running_twice1()
     test_cache_map_running_twice2()
     test_cache_map_extra_small_size1()
+    test_cache_map_tier_policy()
+    test_cache_map_compression()
     test_cache_map_extra_small_size2()
     test_cache_map_no_image()
     test_cache_map_parallel_pipeline1(shard=0)